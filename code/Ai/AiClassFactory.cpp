@@ -12,6 +12,9 @@
 #include "Ai/NavMesh.h"
 #include "Ai/NavMeshComponent.h"
 #include "Core/Class/AutoRuntimeClass.h"
+#include "Core/Class/Boxes/BoxedAabb3.h"
+#include "Core/Class/Boxes/BoxedAlignedVector.h"
+#include "Core/Class/Boxes/BoxedRefArray.h"
 #include "Core/Class/Boxes/BoxedVector4.h"
 #include "Core/Class/IRuntimeClassRegistrar.h"
 
@@ -77,9 +80,12 @@ void AiClassFactory::createClasses(IRuntimeClassRegistrar* registrar) const
 
 	auto classNavMesh = new AutoRuntimeClass< NavMesh >();
 	classNavMesh->addMethod("createMoveQuery", &NavMesh::createMoveQuery);
+	classNavMesh->addMethod("createMoveQueries", &NavMesh::createMoveQueries);
 	classNavMesh->addMethod("findClosestPoint", &NavMesh_findClosestPoint);
 	classNavMesh->addMethod("findRandomPoint", &NavMesh_findRandomPoint_1);
 	classNavMesh->addMethod("findRandomPoint", &NavMesh_findRandomPoint_2);
+	classNavMesh->addMethod("addObstacle", &NavMesh::addObstacle);
+	classNavMesh->addMethod("removeObstacle", &NavMesh::removeObstacle);
 	registrar->registerClass(classNavMesh);
 
 	auto classNavMeshComponent = new AutoRuntimeClass< NavMeshComponent >();
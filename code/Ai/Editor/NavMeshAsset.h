@@ -48,6 +48,7 @@ private:
 	float m_mergeRegionSize = 20.0f;
 	float m_detailSampleDistance = 6.0f;
 	float m_detailSampleMaxError = 1.0f;
+	int32_t m_tileSize = 128;
 };
 
 }
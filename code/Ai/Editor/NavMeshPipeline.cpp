@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <atomic>
 #include <cstring>
 #include <limits>
 #include <Recast.h>
@@ -17,12 +18,15 @@
 #include "Core/Io/IStream.h"
 #include "Core/Io/Writer.h"
 #include "Core/Log/Log.h"
+#include "Core/Math/Log2.h"
 #include "Core/Misc/AutoPtr.h"
 #include "Core/Misc/String.h"
 #include "Core/Misc/TString.h"
 #include "Core/Settings/PropertyBoolean.h"
 #include "Core/Settings/PropertyInteger.h"
 #include "Core/Settings/PropertyString.h"
+#include "Core/Thread/Job.h"
+#include "Core/Thread/JobManager.h"
 #include "Database/Instance.h"
 #include "Editor/IPipelineBuilder.h"
 #include "Editor/IPipelineDepends.h"
@@ -75,9 +79,299 @@ void copyUnaligned3(float out[3], const Vector4& source)
 	out[2] = source.z();
 }
 
+/*! Recast intermediate data used when building a single tile. */
+struct TileBuildData
+{
+	rcHeightfield* solid = nullptr;
+	rcCompactHeightfield* chf = nullptr;
+	rcContourSet* cset = nullptr;
+	rcPolyMesh* pmesh = nullptr;
+	rcPolyMeshDetail* dmesh = nullptr;
+
+	~TileBuildData()
+	{
+		rcFreePolyMeshDetail(dmesh);
+		rcFreePolyMesh(pmesh);
+		rcFreeContourSet(cset);
+		rcFreeCompactHeightfield(chf);
+		rcFreeHeightField(solid);
+	}
+};
+
+/*! Built navigation mesh tile. */
+struct NavMeshTile
+{
+	int32_t x = 0;
+	int32_t y = 0;
+	uint8_t* data = nullptr;
+	int32_t dataSize = 0;
+	AlignedVector< Vector4 > vertices;
+	AlignedVector< uint32_t > polygons;	//!< Vertex count followed by vertex indices, for each polygon.
+};
+
+/*! Build Detour navigation mesh data of a single tile.
+ *
+ * \param cfg Recast configuration, bounds including border of tile.
+ * \param vertices World space vertices of all source geometry.
+ * \param indices Triangle indices of all source geometry.
+ * \param triangles Triangles overlapping tile.
+ * \param agentHeight Height of agent.
+ * \param agentRadius Radius of agent.
+ * \param agentClimb Maximum climb of agent.
+ * \param outTile Output tile, data is null if tile is empty.
+ * 
+eturn True if successful.
+ */
+bool buildTile(
+	const rcConfig& cfg,
+	const AlignedVector< float >& vertices,
+	const AlignedVector< int32_t >& indices,
+	const AlignedVector< int32_t >& triangles,
+	float agentHeight,
+	float agentRadius,
+	float agentClimb,
+	NavMeshTile& outTile
+)
+{
+	BuildContext ctx;
+	TileBuildData bd;
+
+	if (triangles.empty())
+		return true;
+
+	//
+	// Step 1. Rasterize input geometry overlapping tile.
+	//
+
+	if ((bd.solid = rcAllocHeightfield()) == nullptr)
+	{
+		log::error << L"NavMesh pipeline failed; unable to allocate Recast heightfield." << Endl;
+		return false;
+	}
+
+	if (!rcCreateHeightfield(&ctx, *bd.solid, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch))
+	{
+		log::error << L"NavMesh pipeline failed; unable to create Recast heightfield." << Endl;
+		return false;
+	}
+
+	AlignedVector< int32_t > tileIndices;
+	tileIndices.reserve(triangles.size() * 3);
+	for (auto triangle : triangles)
+	{
+		tileIndices.push_back(indices[triangle * 3 + 0]);
+		tileIndices.push_back(indices[triangle * 3 + 1]);
+		tileIndices.push_back(indices[triangle * 3 + 2]);
+	}
+
+	AlignedVector< uint8_t > triAreas;
+	triAreas.resize(triangles.size(), 0);
+
+	const int32_t vertexCount = (int32_t)(vertices.size() / 3);
+	const int32_t triangleCount = (int32_t)triangles.size();
+
+	rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, vertices.c_ptr(), vertexCount, tileIndices.c_ptr(), triangleCount, triAreas.ptr());
+	if (!rcRasterizeTriangles(&ctx, vertices.c_ptr(), vertexCount, tileIndices.c_ptr(), triAreas.c_ptr(), triangleCount, *bd.solid, cfg.walkableClimb))
+	{
+		log::error << L"NavMesh pipeline failed; unable to rasterize triangles." << Endl;
+		return false;
+	}
+
+	//
+	// Step 2. Filter walkables surfaces.
+	//
+
+	rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *bd.solid);
+	rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *bd.solid);
+	rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *bd.solid);
+
+	//
+	// Step 3. Partition walkable surface to simple regions.
+	//
+
+	if ((bd.chf = rcAllocCompactHeightfield()) == nullptr)
+	{
+		log::error << L"NavMesh pipeline failed; unable to allocate Recast compact heightfield." << Endl;
+		return false;
 	}
 
-T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.ai.NavMeshPipeline", 13, NavMeshPipeline, editor::DefaultPipeline)
+	if (!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *bd.solid, *bd.chf))
+	{
+		log::error << L"NavMesh pipeline failed; unable to build Recast compact heightfield." << Endl;
+		return false;
+	}
+
+	rcFreeHeightField(bd.solid);
+	bd.solid = nullptr;
+
+	// Erode the walkable area by agent radius.
+	if (!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *bd.chf))
+	{
+		log::error << L"NavMesh pipeline failed; unable to erode Recast walkable area." << Endl;
+		return false;
+	}
+
+	const bool c_monotonePartitioning = false;
+	if (c_monotonePartitioning)
+	{
+		// Partition the walkable surface into simple regions without holes.
+		// Monotone partitioning does not need distance field.
+		if (!rcBuildRegionsMonotone(&ctx, *bd.chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
+		{
+			log::error << L"NavMesh pipeline failed; unable to build region monotones." << Endl;
+			return false;
+		}
+	}
+	else
+	{
+		// Prepare for region partitioning, by calculating distance field along the walkable surface.
+		if (!rcBuildDistanceField(&ctx, *bd.chf))
+		{
+			log::error << L"NavMesh pipeline failed; unable to build distance field." << Endl;
+			return false;
+		}
+
+		// Partition the walkable surface into simple regions without holes.
+		if (!rcBuildRegions(&ctx, *bd.chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
+		{
+			log::error << L"NavMesh pipeline failed; unable to build regions." << Endl;
+			return false;
+		}
+	}
+
+	//
+	// Step 4. Trace and simplify region contours.
+	//
+
+	if ((bd.cset = rcAllocContourSet()) == nullptr)
+	{
+		log::error << L"NavMesh pipeline failed; unable to allocate Recast contour set." << Endl;
+		return false;
+	}
+
+	if (!rcBuildContours(&ctx, *bd.chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *bd.cset))
+	{
+		log::error << L"NavMesh pipeline failed; unable to build Recast contours." << Endl;
+		return false;
+	}
+
+	if (bd.cset->nconts == 0)
+		return true;
+
+	//
+	// Step 5. Build polygons mesh from contours.
+	//
+
+	if ((bd.pmesh = rcAllocPolyMesh()) == nullptr)
+	{
+		log::error << L"NavMesh pipeline failed; unable to allocate Recast polygon mesh." << Endl;
+		return false;
+	}
+
+	if (!rcBuildPolyMesh(&ctx, *bd.cset, cfg.maxVertsPerPoly, *bd.pmesh))
+	{
+		log::error << L"NavMesh pipeline failed; unable to build Recast polygon mesh." << Endl;
+		return false;
+	}
+
+	//
+	// Step 6. Create detail mesh which allows to access approximate height on each polygon.
+	//
+
+	if ((bd.dmesh = rcAllocPolyMeshDetail()) == nullptr)
+	{
+		log::error << L"NavMesh pipeline failed; unable to allocate Recast polygon detail mesh." << Endl;
+		return false;
+	}
+
+	if (!rcBuildPolyMeshDetail(&ctx, *bd.pmesh, *bd.chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *bd.dmesh))
+	{
+		log::error << L"NavMesh pipeline failed; unable to build Recast polygon detail mesh." << Endl;
+		return false;
+	}
+
+	const rcPolyMesh* pmesh = bd.pmesh;
+	if (pmesh->nverts == 0 || pmesh->npolys == 0)
+		return true;
+
+	//
+	// Step 7. Create Detour navigation mesh tile data.
+	//
+
+	for (int32_t i = 0; i < pmesh->npolys; ++i)
+	{
+		if (pmesh->areas[i] == RC_WALKABLE_AREA)
+			pmesh->flags[i] = 0xffff;
+	}
+
+	dtNavMeshCreateParams params;
+	std::memset(&params, 0, sizeof(params));
+
+	params.verts = pmesh->verts;
+	params.vertCount = pmesh->nverts;
+	params.polys = pmesh->polys;
+	params.polyAreas = pmesh->areas;
+	params.polyFlags = pmesh->flags;
+	params.polyCount = pmesh->npolys;
+	params.nvp = pmesh->nvp;
+	params.detailMeshes = bd.dmesh->meshes;
+	params.detailVerts = bd.dmesh->verts;
+	params.detailVertsCount = bd.dmesh->nverts;
+	params.detailTris = bd.dmesh->tris;
+	params.detailTriCount = bd.dmesh->ntris;
+	params.walkableHeight = agentHeight;
+	params.walkableRadius = agentRadius;
+	params.walkableClimb = agentClimb;
+	params.tileX = outTile.x;
+	params.tileY = outTile.y;
+	params.tileLayer = 0;
+	rcVcopy(params.bmin, pmesh->bmin);
+	rcVcopy(params.bmax, pmesh->bmax);
+	params.cs = cfg.cs;
+	params.ch = cfg.ch;
+	params.buildBvTree = true;
+
+	if (!dtCreateNavMeshData(&params, &outTile.data, &outTile.dataSize))
+	{
+		log::error << L"NavMesh pipeline failed; unable to create Detour navigation mesh data." << Endl;
+		return false;
+	}
+
+	// Keep polygon geometry in world space; used by editor.
+	outTile.vertices.reserve(pmesh->nverts);
+	for (int32_t i = 0; i < pmesh->nverts; ++i)
+	{
+		outTile.vertices.push_back(Vector4(
+			pmesh->bmin[0] + pmesh->verts[i * 3 + 0] * pmesh->cs,
+			pmesh->bmin[1] + pmesh->verts[i * 3 + 1] * pmesh->ch,
+			pmesh->bmin[2] + pmesh->verts[i * 3 + 2] * pmesh->cs,
+			1.0f
+		));
+	}
+
+	outTile.polygons.reserve(pmesh->npolys * (pmesh->nvp + 1));
+	for (int32_t i = 0; i < pmesh->npolys; ++i)
+	{
+		const uint16_t* p = &pmesh->polys[i * pmesh->nvp * 2];
+
+		int32_t nvp = 0;
+		for (; nvp < pmesh->nvp; ++nvp)
+		{
+			if (p[nvp] == RC_MESH_NULL_IDX)
+				break;
+		}
+
+		outTile.polygons.push_back((uint32_t)nvp);
+		for (int32_t j = 0; j < nvp; ++j)
+			outTile.polygons.push_back(p[j]);
+	}
+
+	return true;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.ai.NavMeshPipeline", 14, NavMeshPipeline, editor::DefaultPipeline)
 
 bool NavMeshPipeline::create(const editor::IPipelineSettings* settings, db::Database* database)
 {
@@ -236,9 +530,53 @@ bool NavMeshPipeline::buildOutput(
 	}
 
 	log::info << L"\t" << navModelsTriangleCount << L" triangle(s) loaded." << Endl;
+
+	// Merge all models into a single world space triangle soup.
+	AlignedVector< float > vertices;
+	AlignedVector< int32_t > indices;
+
+	for (auto& navModel : navModels)
+	{
+		const int32_t vertexBase = (int32_t)(vertices.size() / 3);
+		const int32_t vertexCount = navModel.model->getVertexCount();
+		const int32_t triangleCount = navModel.model->getPolygonCount();
+
+		vertices.resize(vertices.size() + vertexCount * 3);
+		for (int32_t j = 0; j < vertexCount; ++j)
+		{
+			const Vector4& position = navModel.model->getVertexPosition(j);
+			copyUnaligned3(&vertices[(vertexBase + j) * 3], navModel.transform * position.xyz1());
+		}
+
+		for (int32_t j = 0; j < triangleCount; ++j)
+		{
+			const model::Polygon& triangle = navModel.model->getPolygon(j);
+			T_ASSERT(triangle.getVertexCount() == 3);
+
+			const int32_t i0 = vertexBase + triangle.getVertex(0);
+			const int32_t i1 = vertexBase + triangle.getVertex(1);
+			const int32_t i2 = vertexBase + triangle.getVertex(2);
+
+			if (oceanClip)
+			{
+				if (vertices[i0 * 3 + 1] < oceanHeight - c_oceanThreshold)
+					continue;
+				if (vertices[i1 * 3 + 1] < oceanHeight - c_oceanThreshold)
+					continue;
+				if (vertices[i2 * 3 + 1] < oceanHeight - c_oceanThreshold)
+					continue;
+			}
+
+			indices.push_back(i2);
+			indices.push_back(i1);
+			indices.push_back(i0);
+		}
+
+		navModel.model = nullptr;
+	}
+
 	log::info << L"Generating navigation mesh..." << Endl;
 
-	BuildContext ctx;
 	rcConfig cfg;
 
 	std::memset(&cfg, 0, sizeof(cfg));
@@ -261,259 +599,107 @@ bool NavMeshPipeline::buildOutput(
 
 	rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
 
-	log::info << L"NavMesh heightfield size " << cfg.width << L" * " << cfg.height << L"." << Endl;
+	// Split heightfield into tiles; a tile size of zero means a single tile.
+	const int32_t tileSize = (asset->m_tileSize > 0) ? asset->m_tileSize : max(cfg.width, cfg.height);
+	const int32_t tileCountX = (cfg.width + tileSize - 1) / tileSize;
+	const int32_t tileCountY = (cfg.height + tileSize - 1) / tileSize;
+	const float tileExtent = tileSize * cfg.cs;
 
-	rcHeightfield* solid = rcAllocHeightfield();
-	if (!solid)
-	{
-		log::error << L"NavMesh pipeline failed; unable to allocate Recast heightfield." << Endl;
-		return false;
-	}
+	log::info << L"NavMesh heightfield size " << cfg.width << L" * " << cfg.height << L", " << tileCountX << L" * " << tileCountY << L" tile(s)." << Endl;
 
-	if (!rcCreateHeightfield(&ctx, *solid, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch))
+	const int32_t tileBits = min< int32_t >(log2((int32_t)nearestLog2(tileCountX * tileCountY)), 14);
+	if (tileCountX * tileCountY > (1 << tileBits))
 	{
-		log::error << L"NavMesh pipeline failed; unable to create Recast heightfield." << Endl;
+		log::error << L"NavMesh pipeline failed; too many tiles, increase tile size." << Endl;
 		return false;
 	}
 
-	// Allocate array that can hold triangle area types.
-	// If you have multiple meshes you need to process, allocate
-	// and array which can hold the max number of triangles you need to process.
-	AutoArrayPtr< uint8_t > triAreas(new uint8_t [navModelsTriangleCount]);
-	if (!triAreas.c_ptr())
-	{
-		log::error << L"NavMesh pipeline failed; unable to allocate memory." << Endl;
-		return false;
-	}
+	rcConfig tileCfg = cfg;
+	tileCfg.tileSize = tileSize;
+	tileCfg.borderSize = cfg.walkableRadius + 3;
+	tileCfg.width = tileSize + tileCfg.borderSize * 2;
+	tileCfg.height = tileSize + tileCfg.borderSize * 2;
 
-	std::memset(triAreas.ptr(), 0, navModelsTriangleCount * sizeof(uint8_t));
+	const float borderExtent = tileCfg.borderSize * cfg.cs;
 
-	{
-		AlignedVector< int32_t > indices;
+	// Bin triangles into each tile they overlap, including tile border.
+	AlignedVector< AlignedVector< int32_t > > tileTriangles;
+	tileTriangles.resize(tileCountX * tileCountY);
 
-		uint8_t* triAreaPtr = triAreas.ptr();
-		for (auto& navModel : navModels)
+	for (int32_t i = 0; i < (int32_t)indices.size() / 3; ++i)
+	{
+		float mnx = std::numeric_limits< float >::max(), mnz = std::numeric_limits< float >::max();
+		float mxx = -std::numeric_limits< float >::max(), mxz = -std::numeric_limits< float >::max();
+		for (int32_t j = 0; j < 3; ++j)
 		{
-			int32_t vertexCount = navModel.model->getVertexCount();
-			int32_t triangleCount = navModel.model->getPolygonCount();
-
-			AutoArrayPtr< float > vertices(new float [3 * vertexCount]);
-			for (int32_t j = 0; j < vertexCount; ++j)
-			{
-				const Vector4& position = navModel.model->getVertexPosition(j);
-				copyUnaligned3(&vertices[j * 3], navModel.transform * position.xyz1());
-			}
-
-			indices.resize(0);
-			indices.reserve(3 * triangleCount);
-
-			for (int32_t j = 0; j < triangleCount; ++j)
-			{
-				const model::Polygon& triangle = navModel.model->getPolygon(j);
-				T_ASSERT(triangle.getVertexCount() == 3);
-
-				if (oceanClip)
-				{
-					if (vertices[triangle.getVertex(0) * 3 + 1] < oceanHeight - c_oceanThreshold)
-						continue;
-					if (vertices[triangle.getVertex(1) * 3 + 1] < oceanHeight - c_oceanThreshold)
-						continue;
-					if (vertices[triangle.getVertex(2) * 3 + 1] < oceanHeight - c_oceanThreshold)
-						continue;
-				}
-
-				indices.push_back(triangle.getVertex(2));
-				indices.push_back(triangle.getVertex(1));
-				indices.push_back(triangle.getVertex(0));
-			}
-
-			T_ASSERT(indices.size() / 3 <= triangleCount);
-
-			if (!indices.empty())
-			{
-				rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, vertices.c_ptr(), vertexCount, &indices[0], (int)(indices.size() / 3), triAreaPtr);
-				rcRasterizeTriangles(&ctx, vertices.c_ptr(), vertexCount, &indices[0], triAreaPtr, (int)(indices.size() / 3), *solid, cfg.walkableClimb);
-			}
-
-			navModel.model = nullptr;
-
-			triAreaPtr += triangleCount;
+			const float* v = &vertices[indices[i * 3 + j] * 3];
+			mnx = min(mnx, v[0]); mxx = max(mxx, v[0]);
+			mnz = min(mnz, v[2]); mxz = max(mxz, v[2]);
 		}
-	}
-
-	//
-	// Step 3. Filter walkables surfaces.
-	//
 
-	// Once all geometry is rasterized, we do initial pass of filtering to
-	// remove unwanted overhangs caused by the conservative rasterization
-	// as well as filter spans where the character cannot possibly stand.
-	rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *solid);
-	rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *solid);
-	rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *solid);
+		const int32_t tx0 = clamp< int32_t >((int32_t)std::floor((mnx - borderExtent - cfg.bmin[0]) / tileExtent), 0, tileCountX - 1);
+		const int32_t tx1 = clamp< int32_t >((int32_t)std::floor((mxx + borderExtent - cfg.bmin[0]) / tileExtent), 0, tileCountX - 1);
+		const int32_t tz0 = clamp< int32_t >((int32_t)std::floor((mnz - borderExtent - cfg.bmin[2]) / tileExtent), 0, tileCountY - 1);
+		const int32_t tz1 = clamp< int32_t >((int32_t)std::floor((mxz + borderExtent - cfg.bmin[2]) / tileExtent), 0, tileCountY - 1);
 
-	//
-	// Step 4. Partition walkable surface to simple regions.
-	//
-
-	// Compact the heightfield so that it is faster to handle from now on.
-	// This will result more cache coherent data as well as the neighbors
-	// between walkable cells will be calculated.
-	rcCompactHeightfield* chf = rcAllocCompactHeightfield();
-	if (!chf)
-	{
-		log::error << L"NavMesh pipeline failed; unable to allocate Recast compact heightfield." << Endl;
-		return false;
-	}
-
-	if (!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *solid, *chf))
-	{
-		log::error << L"NavMesh pipeline failed; unable to build Recast compact heightfield." << Endl;
-		return false;
-	}
-
-	rcFreeHeightField(solid);
-	solid = 0;
-
-	// Erode the walkable area by agent radius.
-	if (!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *chf))
-	{
-		log::error << L"NavMesh pipeline failed; unable to erode Recast walkable area." << Endl;
-		return false;
-	}
-
-	//// (Optional) Mark areas.
-	//const ConvexVolume* vols = m_geom->getConvexVolumes();
-	//for (int i  = 0; i < m_geom->getConvexVolumeCount(); ++i)
-	//	rcMarkConvexPolyArea(ctx, vols[i].verts, vols[i].nverts, vols[i].hmin, vols[i].hmax, (unsigned char)vols[i].area, *chf);
-
-	const bool c_monotonePartitioning = false;
-	if (c_monotonePartitioning)
-	{
-		// Partition the walkable surface into simple regions without holes.
-		// Monotone partitioning does not need distance field.
-		if (!rcBuildRegionsMonotone(&ctx, *chf, 0, cfg.minRegionArea, cfg.mergeRegionArea))
+		for (int32_t tz = tz0; tz <= tz1; ++tz)
 		{
-			log::error << L"NavMesh pipeline failed; unable to build region monotones." << Endl;
-			return false;
+			for (int32_t tx = tx0; tx <= tx1; ++tx)
+				tileTriangles[tx + tz * tileCountX].push_back(i);
 		}
 	}
-	else
-	{
-		// Prepare for region partitioning, by calculating distance field along the walkable surface.
-		if (!rcBuildDistanceField(&ctx, *chf))
-		{
-			log::error << L"NavMesh pipeline failed; unable to build distance field." << Endl;
-			return false;
-		}
 
-		// Partition the walkable surface into simple regions without holes.
-		if (!rcBuildRegions(&ctx, *chf, 0, cfg.minRegionArea, cfg.mergeRegionArea))
-		{
-			log::error << L"NavMesh pipeline failed; unable to build regions." << Endl;
-			return false;
-		}
-	}
+	// Build all tiles in parallel.
+	AlignedVector< NavMeshTile > tiles;
+	tiles.resize(tileCountX * tileCountY);
 
-	//
-	// Step 5. Trace and simplify region contours.
-	//
+	std::atomic< bool > failed(false);
+	AlignedVector< Job::task_t > jobs;
 
-	// Create contours.
-	rcContourSet* cset = rcAllocContourSet();
-	if (!cset)
+	for (int32_t tz = 0; tz < tileCountY; ++tz)
 	{
-		log::error << L"NavMesh pipeline failed; unable to allocate Recast contour set." << Endl;
-		return false;
-	}
-
-	if (!rcBuildContours(&ctx, *chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *cset))
-	{
-		log::error << L"NavMesh pipeline failed; unable to build Recast contours." << Endl;
-		return false;
+		for (int32_t tx = 0; tx < tileCountX; ++tx)
+		{
+			jobs.push_back([&, tx, tz]() {
+				NavMeshTile& tile = tiles[tx + tz * tileCountX];
+				tile.x = tx;
+				tile.y = tz;
+
+				rcConfig jobCfg = tileCfg;
+				jobCfg.bmin[0] = cfg.bmin[0] + tx * tileExtent - borderExtent;
+				jobCfg.bmin[2] = cfg.bmin[2] + tz * tileExtent - borderExtent;
+				jobCfg.bmax[0] = cfg.bmin[0] + (tx + 1) * tileExtent + borderExtent;
+				jobCfg.bmax[2] = cfg.bmin[2] + (tz + 1) * tileExtent + borderExtent;
+
+				if (!buildTile(
+					jobCfg,
+					vertices,
+					indices,
+					tileTriangles[tx + tz * tileCountX],
+					asset->m_agentHeight,
+					asset->m_agentRadius,
+					asset->m_agentClimb,
+					tile
+				))
+					failed = true;
+			});
+		}
 	}
 
-	//
-	// Step 6. Build polygons mesh from contours.
-	//
-
-	// Build polygon navmesh from the contours.
-	rcPolyMesh* pmesh = rcAllocPolyMesh();
-	if (!pmesh)
-	{
-		log::error << L"NavMesh pipeline failed; unable to allocate Recast polygon mesh." << Endl;
-		return false;
-	}
+	JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
 
-	if (!rcBuildPolyMesh(&ctx, *cset, cfg.maxVertsPerPoly, *pmesh))
+	if (failed)
 	{
-		log::error << L"NavMesh pipeline failed; unable to build Recast polygon mesh." << Endl;
+		for (auto& tile : tiles)
+			dtFree(tile.data);
 		return false;
 	}
 
-	//
-	// Step 7. Create detail mesh which allows to access approximate height on each polygon.
-	//
-
-	rcPolyMeshDetail* dmesh = rcAllocPolyMeshDetail();
-	if (!dmesh)
+	uint32_t builtTileCount = 0;
+	for (const auto& tile : tiles)
 	{
-		log::error << L"NavMesh pipeline failed; unable to allocate Recast polygon detail mesh." << Endl;
-		return false;
-	}
-
-	if (!rcBuildPolyMeshDetail(&ctx, *pmesh, *chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *dmesh))
-	{
-		log::error << L"NavMesh pipeline failed; unable to build Recast polygon detail mesh." << Endl;
-		return false;
-	}
-
-	rcFreeCompactHeightfield(chf);
-	chf = 0;
-
-	rcFreeContourSet(cset);
-	cset = 0;
-
-	//
-	// Step 8. Create Detour navigation mesh.
-	//
-
-	for (int i = 0; i < pmesh->npolys; ++i)
-	{
-		if (pmesh->areas[i] == RC_WALKABLE_AREA)
-			pmesh->flags[i] = 0xffff;
-	}
-
-	dtNavMeshCreateParams params;
-	std::memset(&params, 0, sizeof(params));
-
-	params.verts = pmesh->verts;
-	params.vertCount = pmesh->nverts;
-	params.polys = pmesh->polys;
-	params.polyAreas = pmesh->areas;
-	params.polyFlags = pmesh->flags;
-	params.polyCount = pmesh->npolys;
-	params.nvp = pmesh->nvp;
-	params.detailMeshes = dmesh->meshes;
-	params.detailVerts = dmesh->verts;
-	params.detailVertsCount = dmesh->nverts;
-	params.detailTris = dmesh->tris;
-	params.detailTriCount = dmesh->ntris;
-	params.walkableHeight = asset->m_agentHeight;
-	params.walkableRadius = asset->m_agentRadius;
-	params.walkableClimb = asset->m_agentClimb;
-	rcVcopy(params.bmin, pmesh->bmin);
-	rcVcopy(params.bmax, pmesh->bmax);
-	params.cs = cfg.cs;
-	params.ch = cfg.ch;
-	params.buildBvTree = false;
-
-	uint8_t* navData = nullptr;
-	int32_t navDataSize = 0;
-	if (!dtCreateNavMeshData(&params, &navData, &navDataSize))
-	{
-		log::error << L"NavMesh pipeline failed; unable to create Detour navigation mesh data." << Endl;
-		return false;
+		if (tile.data)
+			++builtTileCount;
 	}
 
 	// Save navigation data in resource.
@@ -541,14 +727,35 @@ bool NavMeshPipeline::buildOutput(
 
 	Writer w(stream);
 
-	w << uint8_t(2);
-	w << navDataSize;
+	w << uint8_t(3);
 
-	if (stream->write(navData, navDataSize) != navDataSize)
+	w << cfg.bmin[0];
+	w << cfg.bmin[1];
+	w << cfg.bmin[2];
+	w << tileExtent;
+	w << tileExtent;
+	w << int32_t(1 << tileBits);
+	w << int32_t(1 << (22 - tileBits));
+
+	w << builtTileCount;
+	for (auto& tile : tiles)
 	{
-		log::error << L"NavMesh pipeline failed; unable to write to data stream." << Endl;
-		outputInstance->revert();
-		return false;
+		if (!tile.data)
+			continue;
+
+		w << tile.x;
+		w << tile.y;
+		w << tile.dataSize;
+
+		if (stream->write(tile.data, tile.dataSize) != tile.dataSize)
+		{
+			log::error << L"NavMesh pipeline failed; unable to write to data stream." << Endl;
+			outputInstance->revert();
+			return false;
+		}
+
+		dtFree(tile.data);
+		tile.data = nullptr;
 	}
 
 	// Append geometry last in NavMesh resource; currently useful for editor
@@ -556,29 +763,39 @@ bool NavMeshPipeline::buildOutput(
 	w << m_editor;
 	if (m_editor)
 	{
-		w << uint32_t(pmesh->nverts);
-		for (int32_t i = 0; i < pmesh->nverts; ++i)
+		uint32_t vertexCount = 0;
+		uint32_t polygonCount = 0;
+		for (const auto& tile : tiles)
 		{
-			w << pmesh->bmin[0] + pmesh->verts[i * 3 + 0] * pmesh->cs;
-			w << pmesh->bmin[1] + pmesh->verts[i * 3 + 1] * pmesh->ch;
-			w << pmesh->bmin[2] + pmesh->verts[i * 3 + 2] * pmesh->cs;
+			vertexCount += (uint32_t)tile.vertices.size();
+			for (uint32_t i = 0; i < tile.polygons.size(); i += tile.polygons[i] + 1)
+				++polygonCount;
 		}
 
-		w << uint32_t(pmesh->npolys);
-		for (int32_t i = 0; i < pmesh->npolys; ++i)
+		w << vertexCount;
+		for (const auto& tile : tiles)
 		{
-			const uint16_t* p = &pmesh->polys[i * pmesh->nvp * 2];
-
-			int32_t nvp = 0;
-			for (; nvp < pmesh->nvp; ++nvp)
+			for (const auto& vertex : tile.vertices)
 			{
-				if (p[nvp] == RC_MESH_NULL_IDX)
-					break;
+				w << vertex.x();
+				w << vertex.y();
+				w << vertex.z();
 			}
+		}
+
+		uint32_t vertexBase = 0;
 
-			w << uint8_t(nvp);
-			for (uint32_t j = 0; j < (uint32_t)nvp; ++j)
-				w << uint16_t(p[j]);
+		w << polygonCount;
+		for (const auto& tile : tiles)
+		{
+			for (uint32_t i = 0; i < tile.polygons.size(); i += tile.polygons[i] + 1)
+			{
+				const uint32_t nvp = tile.polygons[i];
+				w << uint8_t(nvp);
+				for (uint32_t j = 0; j < nvp; ++j)
+					w << uint32_t(vertexBase + tile.polygons[i + 1 + j]);
+			}
+			vertexBase += (uint32_t)tile.vertices.size();
 		}
 	}
 
@@ -591,41 +808,33 @@ bool NavMeshPipeline::buildOutput(
 		return false;
 	}
 
-	dtFree(navData);
-	navData = nullptr;
-
-	// Save pmesh for debugging; only in editor.
+	// Save polygon mesh for debugging; only in editor.
 	if (m_editor)
 	{
 		Ref< model::Model > pmeshModel = new model::Model();
 
-		for (int32_t i = 0; i < pmesh->nverts; ++i)
+		AlignedVector< uint32_t > vertexIds;
+		for (const auto& tile : tiles)
 		{
-			pmeshModel->addPosition(Vector4(
-				pmesh->bmin[0] + pmesh->verts[i * 3 + 0] * pmesh->cs,
-				pmesh->bmin[1] + pmesh->verts[i * 3 + 1] * pmesh->ch,
-				pmesh->bmin[2] + pmesh->verts[i * 3 + 2] * pmesh->cs,
-				1.0f
-			));
-			pmeshModel->addVertex(model::Vertex(i));
-		}
-
-		for (int32_t i = 0; i < pmesh->npolys; ++i)
-		{
-			model::Polygon polygon;
+			vertexIds.resize(0);
+			for (const auto& vertex : tile.vertices)
+			{
+				const uint32_t positionId = pmeshModel->addPosition(vertex);
+				vertexIds.push_back(pmeshModel->addVertex(model::Vertex(positionId)));
+			}
 
-			const uint16_t* p = &pmesh->polys[i * pmesh->nvp * 2];
-			for (int32_t j = 0; j < pmesh->nvp; ++j)
+			for (uint32_t i = 0; i < tile.polygons.size(); i += tile.polygons[i] + 1)
 			{
-				if (p[j] == RC_MESH_NULL_IDX)
-					break;
+				model::Polygon polygon;
 
-				polygon.addVertex(p[j]);
-			}
+				const uint32_t nvp = tile.polygons[i];
+				for (uint32_t j = 0; j < nvp; ++j)
+					polygon.addVertex(vertexIds[tile.polygons[i + 1 + j]]);
 
-			polygon.flipWinding();
+				polygon.flipWinding();
 
-			pmeshModel->addPolygon(polygon);
+				pmeshModel->addPolygon(polygon);
+			}
 		}
 
 		pmeshModel->apply(model::Triangulate());
@@ -633,12 +842,6 @@ bool NavMeshPipeline::buildOutput(
 		model::ModelFormat::writeAny(L"data/Temp/NavMesh_nav.obj", pmeshModel);
 	}
 
-	rcFreePolyMeshDetail(dmesh);
-	dmesh = nullptr;
-
-	rcFreePolyMesh(pmesh);
-	pmesh = nullptr;
-
 	return true;
 }
 
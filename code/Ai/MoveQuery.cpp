@@ -20,7 +20,6 @@ MoveQuery::MoveQuery()
 :	m_startPosition(0.0f, 0.0f, 0.0f, 0.0f)
 ,	m_endPosition(0.0f, 0.0f, 0.0f, 0.0f)
 ,	m_filter(new dtQueryFilter())
-,	m_navQuery(nullptr)
 ,	m_pathCount(0)
 ,	m_steerIndex(0)
 {
@@ -28,7 +27,6 @@ MoveQuery::MoveQuery()
 
 MoveQuery::~MoveQuery()
 {
-	dtFreeNavMeshQuery(m_navQuery);
 	delete m_filter;
 }
 
@@ -20,7 +20,6 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
-class dtNavMeshQuery;
 class dtQueryFilter;
 
 namespace traktor::ai
@@ -58,7 +57,6 @@ private:
 	Vector4 m_startPosition;
 	Vector4 m_endPosition;
 	dtQueryFilter* m_filter;
-	dtNavMeshQuery* m_navQuery;
 	uint32_t m_path[MaxPathPolygons];
 	int32_t m_pathCount;
 	AlignedVector< Vector4 > m_steerPath;
@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <DetourNavMesh.h>
 #include <DetourNavMeshQuery.h>
 #include "Ai/MoveQuery.h"
 #include "Ai/MoveQueryResult.h"
@@ -13,6 +14,7 @@
 #include "Core/Log/Log.h"
 #include "Core/Math/Random.h"
 #include "Core/Misc/AutoPtr.h"
+#include "Core/Thread/Acquire.h"
 #include "Core/Thread/Job.h"
 #include "Core/Thread/JobManager.h"
 
@@ -22,6 +24,10 @@ namespace traktor::ai
 	{
 
 const float c_searchExtents[3] = { 32.0f, 32.0f, 32.0f };
+const int32_t c_maxQueryNodes = 2048;
+const uint32_t c_maxMoveQueryBatch = 32;
+const uint8_t c_walkableArea = 63;	//!< Same as RC_WALKABLE_AREA.
+const uint16_t c_walkableFlags = 0xffff;
 
 float random()
 {
@@ -29,138 +35,111 @@ float random()
 	return s_rnd.nextFloat();
 }
 
+/*! Scoped navigation query from navigation mesh query pool. */
+class ScopedQuery
+{
+public:
+	explicit ScopedQuery(const NavMesh* navMesh)
+	:	m_navMesh(navMesh)
+	,	m_navQuery(navMesh->acquireQuery())
+	{
+	}
+
+	~ScopedQuery()
+	{
+		if (m_navQuery)
+			m_navMesh->releaseQuery(m_navQuery);
+	}
+
+	dtNavMeshQuery* ptr() const { return m_navQuery; }
+
+	dtNavMeshQuery* operator -> () const { return m_navQuery; }
+
+	operator bool () const { return m_navQuery != nullptr; }
+
+private:
+	const NavMesh* m_navMesh;
+	dtNavMeshQuery* m_navQuery;
+};
+
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.ai.NavMesh", NavMesh, Object)
 
 NavMesh::~NavMesh()
 {
+	for (auto navQuery : m_queryPool)
+		dtFreeNavMeshQuery(navQuery);
+	m_queryPool.clear();
+
 	dtFreeNavMesh(m_navMesh);
 }
 
 Ref< MoveQueryResult > NavMesh::createMoveQuery(const Vector4& startPosition, const Vector4& endPosition)
 {
 	Ref< MoveQueryResult > result = new MoveQueryResult();
-	JobManager::getInstance().add([=](){
+	JobManager::getInstance().addDetached([=](){
 		T_ANONYMOUS_VAR(Ref< NavMesh >)(this);
 
-		dtNavMeshQuery* navQuery = dtAllocNavMeshQuery();
+		ScopedQuery navQuery(this);
 		if (!navQuery)
 		{
 			result->fail();
 			return;
 		}
 
-		dtStatus status = navQuery->init(m_navMesh, 2048);
-		if (dtStatusFailed(status))
-		{
+		Ref< MoveQuery > moveQuery = resolveMoveQuery(navQuery.ptr(), startPosition, endPosition);
+		if (moveQuery)
+			result->succeed(moveQuery);
+		else
 			result->fail();
-			return;
-		}
-
-		float T_MATH_ALIGN16 startPos[4];
-		float T_MATH_ALIGN16 endPos[4];
-		startPosition.storeAligned(startPos);
-		endPosition.storeAligned(endPos);
-
-		Ref< MoveQuery > outputQuery = new MoveQuery();
-		outputQuery->m_navQuery = navQuery;
-
-		dtPolyRef startRef, endRef;
-		float T_MATH_ALIGN16 startPosN[4];
-		float T_MATH_ALIGN16 endPosN[4];
-
-		status = outputQuery->m_navQuery->findNearestPoly(
-			startPos,
-			c_searchExtents,
-			outputQuery->m_filter,
-			&startRef,
-			startPosN
-		);
-		if (dtStatusFailed(status))
-		{
-			result->fail();
-			return;
-		}
-
-		status = outputQuery->m_navQuery->findNearestPoly(
-			endPos,
-			c_searchExtents,
-			outputQuery->m_filter,
-			&endRef,
-			endPosN
-		);
-		if (dtStatusFailed(status))
-		{
-			result->fail();
-			return;
-		}
+	});
+	return result;
+}
 
-		outputQuery->m_startPosition = Vector4::loadAligned(startPosN).xyz1();
-		outputQuery->m_endPosition = Vector4::loadAligned(endPosN).xyz1();
-
-		status = outputQuery->m_navQuery->findPath(
-			startRef,
-			endRef,
-			startPosN,
-			endPosN,
-			outputQuery->m_filter,
-			outputQuery->m_path,
-			&outputQuery->m_pathCount,
-			sizeof_array(outputQuery->m_path)
-		);
-		if (dtStatusFailed(status) || outputQuery->m_pathCount <= 0)
-		{
-			// Failed to create navmesh path; most probably no valid route exists.
-			// Create a short-cut path to move navigation entity back on track.
-			outputQuery->m_steerPath.push_back(outputQuery->m_endPosition);
-			result->succeed(outputQuery);
-			return;
-		}
+RefArray< MoveQueryResult > NavMesh::createMoveQueries(const AlignedVector< Vector4 >& startPositions, const AlignedVector< Vector4 >& endPositions)
+{
+	T_ASSERT(startPositions.size() == endPositions.size());
 
-		float steerPath[256 * 3 + 1];
-		int32_t steerPathCount = 0;
-
-		status = outputQuery->m_navQuery->findStraightPath(
-			startPosN,
-			endPosN,
-			outputQuery->m_path,
-			outputQuery->m_pathCount,
-			steerPath,
-			nullptr,
-			nullptr,
-			&steerPathCount,
-			256
-		);
-		if (dtStatusFailed(status) || steerPathCount <= 0)
-		{
-			// Failed to create navmesh path; most probably no valid route exists.
-			// Create a short-cut path to move navigation entity back on track.
-			outputQuery->m_steerPath.push_back(outputQuery->m_endPosition);
-			result->succeed(outputQuery);
-			return;
-		}
+	RefArray< MoveQueryResult > results;
+	results.resize(startPositions.size());
+	for (uint32_t i = 0; i < startPositions.size(); ++i)
+		results[i] = new MoveQueryResult();
 
-		outputQuery->m_steerPath.reserve(steerPathCount);
-		for (int32_t i = 0; i < steerPathCount; ++i)
-			outputQuery->m_steerPath.push_back(Vector4::loadUnaligned(&steerPath[i * 3]).xyz1());
+	for (uint32_t offset = 0; offset < startPositions.size(); offset += c_maxMoveQueryBatch)
+	{
+		const uint32_t count = std::min< uint32_t >(c_maxMoveQueryBatch, (uint32_t)startPositions.size() - offset);
+
+		AlignedVector< Vector4 > batchStartPositions(startPositions.begin() + offset, startPositions.begin() + offset + count);
+		AlignedVector< Vector4 > batchEndPositions(endPositions.begin() + offset, endPositions.begin() + offset + count);
+		RefArray< MoveQueryResult > batchResults;
+		for (uint32_t i = 0; i < count; ++i)
+			batchResults.push_back(results[offset + i]);
+
+		JobManager::getInstance().addDetached([=](){
+			T_ANONYMOUS_VAR(Ref< NavMesh >)(this);
+
+			ScopedQuery navQuery(this);
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				Ref< MoveQuery > moveQuery = navQuery ? resolveMoveQuery(navQuery.ptr(), batchStartPositions[i], batchEndPositions[i]) : nullptr;
+				if (moveQuery)
+					batchResults[i]->succeed(moveQuery);
+				else
+					batchResults[i]->fail();
+			}
+		});
+	}
 
-		result->succeed(outputQuery);
-		return;
-	});
-	return result;
+	return results;
 }
 
 bool NavMesh::findClosestPoint(const Vector4& searchFrom, Vector4& outPoint) const
 {
-	dtNavMeshQuery* navQuery = dtAllocNavMeshQuery();
+	ScopedQuery navQuery(this);
 	if (!navQuery)
 		return false;
 
-	dtStatus status = navQuery->init(m_navMesh, 2048);
-	if (dtStatusFailed(status))
-		return false;
-
 	AutoPtr< dtQueryFilter > filter(new dtQueryFilter());
 
 	float T_MATH_ALIGN16 startPos[4];
@@ -169,7 +148,7 @@ bool NavMesh::findClosestPoint(const Vector4& searchFrom, Vector4& outPoint) con
 	dtPolyRef startRef;
 	float T_MATH_ALIGN16 startPosN[4];
 
-	status = navQuery->findNearestPoly(
+	const dtStatus status = navQuery->findNearestPoly(
 		startPos,
 		c_searchExtents,
 		filter.ptr(),
@@ -177,60 +156,42 @@ bool NavMesh::findClosestPoint(const Vector4& searchFrom, Vector4& outPoint) con
 		startPosN
 	);
 	if (dtStatusFailed(status))
-	{
-		dtFreeNavMeshQuery(navQuery);
 		return false;
-	}
 
 	outPoint = Vector4::loadAligned(startPosN).xyz1();
-
-	dtFreeNavMeshQuery(navQuery);
 	return true;
 }
 
 bool NavMesh::findRandomPoint(Vector4& outPoint) const
 {
-	dtNavMeshQuery* navQuery = dtAllocNavMeshQuery();
+	ScopedQuery navQuery(this);
 	if (!navQuery)
 		return false;
 
-	dtStatus status = navQuery->init(m_navMesh, 2048);
-	if (dtStatusFailed(status))
-		return false;
-
 	AutoPtr< dtQueryFilter > filter(new dtQueryFilter());
 
 	dtPolyRef randomRef;
 	float T_MATH_ALIGN16 randomPosN[4];
 
-	status = navQuery->findRandomPoint(
+	const dtStatus status = navQuery->findRandomPoint(
 		filter.ptr(),
 		&random,
 		&randomRef,
 		randomPosN
 	);
 	if (dtStatusFailed(status))
-	{
-		dtFreeNavMeshQuery(navQuery);
 		return false;
-	}
 
 	outPoint = Vector4::loadAligned(randomPosN).xyz1();
-
-	dtFreeNavMeshQuery(navQuery);
 	return true;
 }
 
 bool NavMesh::findRandomPoint(const Vector4& center, float radius, Vector4& outPoint) const
 {
-	dtNavMeshQuery* navQuery = dtAllocNavMeshQuery();
+	ScopedQuery navQuery(this);
 	if (!navQuery)
 		return false;
 
-	dtStatus status = navQuery->init(m_navMesh, 2048);
-	if (dtStatusFailed(status))
-		return false;
-
 	AutoPtr< dtQueryFilter > filter(new dtQueryFilter());
 
 	float T_MATH_ALIGN16 centerPos[4];
@@ -239,7 +200,7 @@ bool NavMesh::findRandomPoint(const Vector4& center, float radius, Vector4& outP
 	dtPolyRef startRef;
 	float T_MATH_ALIGN16 startPosN[4];
 
-	status = navQuery->findNearestPoly(
+	dtStatus status = navQuery->findNearestPoly(
 		centerPos,
 		c_searchExtents,
 		filter.ptr(),
@@ -259,16 +220,203 @@ bool NavMesh::findRandomPoint(const Vector4& center, float radius, Vector4& outP
 		&randomRef,
 		randomPosN
 	);
+	if (dtStatusFailed(status))
+		return false;
+
+	outPoint = Vector4::loadAligned(randomPosN).xyz1();
+	return true;
+}
+
+uint32_t NavMesh::addObstacle(const Aabb3& bounds)
+{
+	const uint32_t handle = m_nextObstacleHandle++;
+	m_obstacles.push_back({ handle, bounds });
+	rebuildTiles(bounds);
+	return handle;
+}
+
+void NavMesh::removeObstacle(uint32_t obstacle)
+{
+	auto it = std::find_if(m_obstacles.begin(), m_obstacles.end(), [&](const Obstacle& o) {
+		return o.handle == obstacle;
+	});
+	if (it == m_obstacles.end())
+		return;
+
+	const Aabb3 bounds = it->bounds;
+	m_obstacles.erase(it);
+	rebuildTiles(bounds);
+}
+
+dtNavMeshQuery* NavMesh::acquireQuery() const
+{
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_queryPoolLock);
+		if (!m_queryPool.empty())
+		{
+			dtNavMeshQuery* navQuery = m_queryPool.back();
+			m_queryPool.pop_back();
+			return navQuery;
+		}
+	}
+
+	dtNavMeshQuery* navQuery = dtAllocNavMeshQuery();
+	if (!navQuery)
+		return nullptr;
+
+	const dtStatus status = navQuery->init(m_navMesh, c_maxQueryNodes);
 	if (dtStatusFailed(status))
 	{
 		dtFreeNavMeshQuery(navQuery);
-		return false;
+		return nullptr;
 	}
 
-	outPoint = Vector4::loadAligned(randomPosN).xyz1();
+	return navQuery;
+}
 
-	dtFreeNavMeshQuery(navQuery);
-	return true;
+void NavMesh::releaseQuery(dtNavMeshQuery* navQuery) const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_queryPoolLock);
+	m_queryPool.push_back(navQuery);
+}
+
+Ref< MoveQuery > NavMesh::resolveMoveQuery(dtNavMeshQuery* navQuery, const Vector4& startPosition, const Vector4& endPosition) const
+{
+	float T_MATH_ALIGN16 startPos[4];
+	float T_MATH_ALIGN16 endPos[4];
+	startPosition.storeAligned(startPos);
+	endPosition.storeAligned(endPos);
+
+	Ref< MoveQuery > outputQuery = new MoveQuery();
+
+	dtPolyRef startRef, endRef;
+	float T_MATH_ALIGN16 startPosN[4];
+	float T_MATH_ALIGN16 endPosN[4];
+
+	dtStatus status = navQuery->findNearestPoly(
+		startPos,
+		c_searchExtents,
+		outputQuery->m_filter,
+		&startRef,
+		startPosN
+	);
+	if (dtStatusFailed(status))
+		return nullptr;
+
+	status = navQuery->findNearestPoly(
+		endPos,
+		c_searchExtents,
+		outputQuery->m_filter,
+		&endRef,
+		endPosN
+	);
+	if (dtStatusFailed(status))
+		return nullptr;
+
+	outputQuery->m_startPosition = Vector4::loadAligned(startPosN).xyz1();
+	outputQuery->m_endPosition = Vector4::loadAligned(endPosN).xyz1();
+
+	status = navQuery->findPath(
+		startRef,
+		endRef,
+		startPosN,
+		endPosN,
+		outputQuery->m_filter,
+		outputQuery->m_path,
+		&outputQuery->m_pathCount,
+		sizeof_array(outputQuery->m_path)
+	);
+	if (dtStatusFailed(status) || outputQuery->m_pathCount <= 0)
+	{
+		// Failed to create navmesh path; most probably no valid route exists.
+		// Create a short-cut path to move navigation entity back on track.
+		outputQuery->m_steerPath.push_back(outputQuery->m_endPosition);
+		return outputQuery;
+	}
+
+	float steerPath[256 * 3 + 1];
+	int32_t steerPathCount = 0;
+
+	status = navQuery->findStraightPath(
+		startPosN,
+		endPosN,
+		outputQuery->m_path,
+		outputQuery->m_pathCount,
+		steerPath,
+		nullptr,
+		nullptr,
+		&steerPathCount,
+		256
+	);
+	if (dtStatusFailed(status) || steerPathCount <= 0)
+	{
+		// Failed to create navmesh path; most probably no valid route exists.
+		// Create a short-cut path to move navigation entity back on track.
+		outputQuery->m_steerPath.push_back(outputQuery->m_endPosition);
+		return outputQuery;
+	}
+
+	outputQuery->m_steerPath.reserve(steerPathCount);
+	for (int32_t i = 0; i < steerPathCount; ++i)
+		outputQuery->m_steerPath.push_back(Vector4::loadUnaligned(&steerPath[i * 3]).xyz1());
+
+	return outputQuery;
+}
+
+void NavMesh::rebuildTiles(const Aabb3& bounds)
+{
+	float T_MATH_ALIGN16 mn[4];
+	float T_MATH_ALIGN16 mx[4];
+	bounds.mn.storeAligned(mn);
+	bounds.mx.storeAligned(mx);
+
+	int32_t tx0, tz0, tx1, tz1;
+	m_navMesh->calcTileLoc(mn, &tx0, &tz0);
+	m_navMesh->calcTileLoc(mx, &tx1, &tz1);
+
+	// Update flags of every polygon in affected tiles; polygons
+	// overlapping any obstacle are excluded from queries.
+	const dtMeshTile* tiles[8];
+	for (int32_t tz = tz0; tz <= tz1; ++tz)
+	{
+		for (int32_t tx = tx0; tx <= tx1; ++tx)
+		{
+			const int32_t tileCount = m_navMesh->getTilesAt(tx, tz, tiles, sizeof_array(tiles));
+			for (int32_t i = 0; i < tileCount; ++i)
+			{
+				const dtMeshTile* tile = tiles[i];
+				if (!tile->header)
+					continue;
+
+				const dtPolyRef base = m_navMesh->getPolyRefBase(tile);
+				for (int32_t j = 0; j < tile->header->polyCount; ++j)
+				{
+					const dtPoly& poly = tile->polys[j];
+					if (poly.getType() != DT_POLYTYPE_GROUND)
+						continue;
+
+					Aabb3 polyBounds;
+					for (int32_t k = 0; k < poly.vertCount; ++k)
+					{
+						const float* v = &tile->verts[poly.verts[k] * 3];
+						polyBounds.contain(Vector4(v[0], v[1], v[2], 1.0f));
+					}
+
+					uint16_t flags = (poly.getArea() == c_walkableArea) ? c_walkableFlags : 0;
+					for (const auto& obstacle : m_obstacles)
+					{
+						if (obstacle.bounds.overlap(polyBounds))
+						{
+							flags = 0;
+							break;
+						}
+					}
+
+					m_navMesh->setPolyFlags(base | (dtPolyRef)j, flags);
+				}
+			}
+		}
+	}
 }
 
 }
@@ -10,8 +10,11 @@
 
 #include "Core/Object.h"
 #include "Core/Ref.h"
+#include "Core/RefArray.h"
 #include "Core/Containers/AlignedVector.h"
+#include "Core/Math/Aabb3.h"
 #include "Core/Math/Vector4.h"
+#include "Core/Thread/Semaphore.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -22,10 +25,12 @@
 #endif
 
 class dtNavMesh;
+class dtNavMeshQuery;
 
 namespace traktor::ai
 {
 
+class MoveQuery;
 class MoveQueryResult;
 
 /*! Navigation mesh.
@@ -51,6 +56,18 @@ public:
 	 */
 	Ref< MoveQueryResult > createMoveQuery(const Vector4& startPosition, const Vector4& endPosition);
 
+	/*! Create multiple movement queries.
+	 *
+	 * Queries are resolved in batches, each batch
+	 * is resolved by a single job using a single
+	 * navigation query object.
+	 *
+	 * \param startPositions Start of each movement.
+	 * \param endPositions End of each movement.
+	 * \return Movement query async results, one for each start and end pair.
+	 */
+	RefArray< MoveQueryResult > createMoveQueries(const AlignedVector< Vector4 >& startPositions, const AlignedVector< Vector4 >& endPositions);
+
 	/*! Find closest point on navigation mesh.
 	 *
 	 * \param searchFrom Search from point.
@@ -75,13 +92,53 @@ public:
 	 */
 	bool findRandomPoint(const Vector4& center, float radius, Vector4& outPoint) const;
 
+	/*! Add obstacle.
+	 *
+	 * Polygons in tiles overlapping obstacle are
+	 * updated to exclude polygons covered by obstacle.
+	 *
+	 * \param bounds Obstacle bounding box in world space.
+	 * \return Obstacle handle.
+	 */
+	uint32_t addObstacle(const Aabb3& bounds);
+
+	/*! Remove obstacle.
+	 *
+	 * \param obstacle Obstacle handle.
+	 */
+	void removeObstacle(uint32_t obstacle);
+
+	/*! Acquire navigation query from pool.
+	 *
+	 * Query objects are reused since they are expensive to create,
+	 * acquired query must be released when no longer in use.
+	 */
+	dtNavMeshQuery* acquireQuery() const;
+
+	/*! Release navigation query back into pool. */
+	void releaseQuery(dtNavMeshQuery* navQuery) const;
+
 private:
 	friend class NavMeshFactory;
 	friend class NavMeshComponentEditor;
 
-	dtNavMesh* m_navMesh;
+	struct Obstacle
+	{
+		uint32_t handle;
+		Aabb3 bounds;
+	};
+
+	dtNavMesh* m_navMesh = nullptr;
 	AlignedVector< Vector4 > m_navMeshVertices;
-	AlignedVector< uint16_t > m_navMeshPolygons;
+	AlignedVector< uint32_t > m_navMeshPolygons;
+	mutable Semaphore m_queryPoolLock;
+	mutable AlignedVector< dtNavMeshQuery* > m_queryPool;
+	AlignedVector< Obstacle > m_obstacles;
+	uint32_t m_nextObstacleHandle = 1;
+
+	Ref< MoveQuery > resolveMoveQuery(dtNavMeshQuery* navQuery, const Vector4& startPosition, const Vector4& endPosition) const;
+
+	void rebuildTiles(const Aabb3& bounds);
 };
 
 }
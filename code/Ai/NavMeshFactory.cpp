@@ -56,17 +56,79 @@ Ref< Object > NavMeshFactory::create(resource::IResourceManager* resourceManager
 
 	uint8_t version;
 	r >> version;
-	if (version != 2)
+	if (version != 2 && version != 3)
 		return nullptr;
 
-	int32_t navDataSize;
-	r >> navDataSize;
-	if (navDataSize <= 0)
+	dtNavMesh* navMesh = dtAllocNavMesh();
+	if (!navMesh)
 		return nullptr;
 
-	uint8_t* navData = (uint8_t*)dtAlloc(navDataSize, DT_ALLOC_PERM);
-	if (stream->read(navData, navDataSize) != navDataSize)
-		return nullptr;
+	outputNavMesh->m_navMesh = navMesh;
+
+	if (version >= 3)
+	{
+		// Tiled navigation mesh; each tile is added separately.
+		dtNavMeshParams params;
+		r >> params.orig[0];
+		r >> params.orig[1];
+		r >> params.orig[2];
+		r >> params.tileWidth;
+		r >> params.tileHeight;
+		r >> params.maxTiles;
+		r >> params.maxPolys;
+
+		dtStatus status = navMesh->init(&params);
+		if (dtStatusFailed(status))
+			return nullptr;
+
+		uint32_t tileCount;
+		r >> tileCount;
+
+		for (uint32_t i = 0; i < tileCount; ++i)
+		{
+			int32_t tileX, tileY, tileDataSize;
+			r >> tileX;
+			r >> tileY;
+			r >> tileDataSize;
+			if (tileDataSize <= 0)
+				return nullptr;
+
+			uint8_t* tileData = (uint8_t*)dtAlloc(tileDataSize, DT_ALLOC_PERM);
+			if (stream->read(tileData, tileDataSize) != tileDataSize)
+			{
+				dtFree(tileData);
+				return nullptr;
+			}
+
+			status = navMesh->addTile(tileData, tileDataSize, DT_TILE_FREE_DATA, 0, nullptr);
+			if (dtStatusFailed(status))
+			{
+				dtFree(tileData);
+				return nullptr;
+			}
+		}
+	}
+	else
+	{
+		int32_t navDataSize;
+		r >> navDataSize;
+		if (navDataSize <= 0)
+			return nullptr;
+
+		uint8_t* navData = (uint8_t*)dtAlloc(navDataSize, DT_ALLOC_PERM);
+		if (stream->read(navData, navDataSize) != navDataSize)
+		{
+			dtFree(navData);
+			return nullptr;
+		}
+
+		const dtStatus status = navMesh->init(navData, navDataSize, DT_TILE_FREE_DATA);
+		if (dtStatusFailed(status))
+		{
+			dtFree(navData);
+			return nullptr;
+		}
+	}
 
 	bool haveGeometry;
 	r >> haveGeometry;
@@ -99,8 +161,15 @@ Ref< Object > NavMeshFactory::create(resource::IResourceManager* resourceManager
 
 			for (uint32_t j = 0; j < numPolygonVertices; ++j)
 			{
-				uint16_t polygonIndex;
-				r >> polygonIndex;
+				uint32_t polygonIndex;
+				if (version >= 3)
+					r >> polygonIndex;
+				else
+				{
+					uint16_t polygonIndex16;
+					r >> polygonIndex16;
+					polygonIndex = polygonIndex16;
+				}
 
 				outputNavMesh->m_navMeshPolygons.push_back(polygonIndex);
 			}
@@ -110,16 +179,6 @@ Ref< Object > NavMeshFactory::create(resource::IResourceManager* resourceManager
 	stream->close();
 	stream = nullptr;
 
-	dtNavMesh* navMesh = dtAllocNavMesh();
-	if (!navMesh)
-		return nullptr;
-
-	dtStatus status = navMesh->init(navData, navDataSize, DT_TILE_FREE_DATA);
-	if (dtStatusFailed(status))
-		return nullptr;
-
-	outputNavMesh->m_navMesh = navMesh;
-
 	return outputNavMesh;
 }
 
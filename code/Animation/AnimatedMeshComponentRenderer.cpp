@@ -19,4 +19,10 @@ const TypeInfoSet AnimatedMeshComponentRenderer::getRenderableTypes() const
 	return makeTypeInfoSet< AnimatedMeshComponent >();
 }
 
+bool AnimatedMeshComponentRenderer::isBuildConcurrent() const
+{
+	// Joint buffers are locked when building first pass of frame; not safe on all render systems.
+	return false;
+}
+
 }
@@ -30,6 +30,8 @@ class T_DLLCLASS AnimatedMeshComponentRenderer : public mesh::MeshComponentRende
 
 public:
 	virtual const TypeInfoSet getRenderableTypes() const override final;
+
+	virtual bool isBuildConcurrent() const override final;
 };
 
 }
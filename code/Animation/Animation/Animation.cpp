@@ -6,6 +6,8 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
+#include <cmath>
 #include "Animation/Animation/Animation.h"
 #include "Animation/SkeletonUtils.h"
 #include "Core/Math/Hermite.h"
@@ -16,8 +18,72 @@
 
 namespace traktor::animation
 {
+	namespace
+	{
+
+const float c_rotationScale = 32767.0f;
+const float c_translationScale = 65535.0f;
+
+/*! Load four signed 16-bit integers as floats. */
+T_MATH_INLINE Vector4 loadInt16(const int16_t* p)
+{
+#if defined(T_MATH_USE_SSE2)
+	const __m128i v = _mm_loadl_epi64((const __m128i*)p);
+	return Vector4(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16)));
+#elif defined(T_MATH_USE_NEON)
+	return Vector4(vcvtq_f32_s32(vmovl_s16(vld1_s16(p))));
+#else
+	return Vector4(float(p[0]), float(p[1]), float(p[2]), float(p[3]));
+#endif
+}
+
+/*! Load four unsigned 16-bit integers as floats. */
+T_MATH_INLINE Vector4 loadUInt16(const uint16_t* p)
+{
+#if defined(T_MATH_USE_SSE2)
+	const __m128i v = _mm_loadl_epi64((const __m128i*)p);
+	return Vector4(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, _mm_setzero_si128())));
+#elif defined(T_MATH_USE_NEON)
+	return Vector4(vcvtq_f32_u32(vmovl_u16(vld1_u16(p))));
+#else
+	return Vector4(float(p[0]), float(p[1]), float(p[2]), float(p[3]));
+#endif
+}
 
-T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.animation.Animation", 0, Animation, ISerializable)
+T_MATH_INLINE Vector4 reciprocalSquareRoot4(const Vector4& v)
+{
+#if defined(T_MATH_USE_SSE2)
+	return Vector4(_mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(v.m_data)));
+#elif defined(T_MATH_USE_NEON)
+	float32x4_t e = vrsqrteq_f32(v.m_data);
+	e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(v.m_data, e), e));
+	e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(v.m_data, e), e));
+	return Vector4(e);
+#else
+	float T_MATH_ALIGN16 e[4];
+	v.storeAligned(e);
+	return Vector4(1.0f / std::sqrt(e[0]), 1.0f / std::sqrt(e[1]), 1.0f / std::sqrt(e[2]), 1.0f / std::sqrt(e[3]));
+#endif
+}
+
+/*! Rotation angle between two unit quaternions, measured from chord length as acos lacks precision near identity. */
+float rotationError(const Quaternion& a, const Quaternion& b)
+{
+	const Quaternion bn = (dot(a, b) < 0.0_simd) ? -b : b;
+	const float chord = (a.e - bn.e).length();
+	return 4.0f * std::asin(std::min(chord * 0.5f, 1.0f));
+}
+
+/*! Scratch joint rotations and translations used while sampling compressed clips. */
+struct SampleScratch
+{
+	AlignedVector< Vector4 > rotations;
+	AlignedVector< Vector4 > translations;
+};
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.animation.Animation", 1, Animation, ISerializable)
 
 uint32_t Animation::addKeyPose(const KeyPose& pose)
 {
@@ -41,9 +107,172 @@ void Animation::removeKeyPose(uint32_t poseIndex)
 	m_poses.erase(m_poses.begin() + size_t(poseIndex));
 }
 
+bool Animation::compress(float rotationTolerance, float translationTolerance)
+{
+	const uint32_t nkeys = (uint32_t)m_poses.size();
+	if (nkeys == 0)
+		return false;
+
+	releaseCompressed();
+
+	// Gather all joints used by any key pose.
+	BitSet indices;
+	for (const auto& keyPose : m_poses)
+		keyPose.pose.getIndexMask(indices);
+
+	int32_t minRange, maxRange;
+	indices.range(minRange, maxRange);
+
+	for (int32_t i = minRange; i < maxRange; ++i)
+	{
+		if (indices(i))
+			m_jointIndices.push_back((uint32_t)i);
+	}
+
+	const uint32_t njoints = (uint32_t)m_jointIndices.size();
+
+	// Extract per-joint tracks; rotations are kept in same hemisphere as previous key so they can be blended linearly.
+	AlignedVector< Quaternion > rotations(njoints * nkeys);
+	AlignedVector< Vector4 > translations(njoints * nkeys);
+	for (uint32_t j = 0; j < njoints; ++j)
+	{
+		for (uint32_t k = 0; k < nkeys; ++k)
+		{
+			const Transform transform = m_poses[k].pose.getJointTransform(m_jointIndices[j]);
+
+			Quaternion rotation = transform.rotation().normalized();
+			if (k > 0 && dot(rotation, rotations[j * nkeys + k - 1]) < 0.0_simd)
+				rotation = -rotation;
+
+			rotations[j * nkeys + k] = rotation;
+			translations[j * nkeys + k] = transform.translation().xyz0();
+		}
+
+		m_constantTransforms.push_back(Transform(
+			translations[j * nkeys],
+			rotations[j * nkeys]
+		));
+
+		bool constantRotation = true;
+		bool constantTranslation = true;
+		for (uint32_t k = 1; k < nkeys; ++k)
+		{
+			if (rotationError(rotations[j * nkeys + k], rotations[j * nkeys]) > rotationTolerance)
+				constantRotation = false;
+			if ((translations[j * nkeys + k] - translations[j * nkeys]).length() > Scalar(translationTolerance))
+				constantTranslation = false;
+		}
+
+		if (!constantRotation)
+			m_rotationTracks.push_back(j);
+		if (!constantTranslation)
+			m_translationTracks.push_back(j);
+	}
+
+	// Quantize animated rotation tracks, groups of four padded with identity.
+	const uint32_t nrotationGroups = ((uint32_t)m_rotationTracks.size() + 3) / 4;
+	m_rotationKeys.resize(nkeys * nrotationGroups * 16, 0);
+	for (uint32_t k = 0; k < nkeys; ++k)
+	{
+		for (uint32_t g = 0; g < nrotationGroups; ++g)
+		{
+			int16_t* group = &m_rotationKeys[(k * nrotationGroups + g) * 16];
+			for (uint32_t lane = 0; lane < 4; ++lane)
+			{
+				const uint32_t track = g * 4 + lane;
+				if (track >= m_rotationTracks.size())
+				{
+					group[3 * 4 + lane] = (int16_t)c_rotationScale;
+					continue;
+				}
+
+				float T_MATH_ALIGN16 e[4];
+				rotations[m_rotationTracks[track] * nkeys + k].e.storeAligned(e);
+				for (uint32_t c = 0; c < 4; ++c)
+					group[c * 4 + lane] = (int16_t)std::lround(clamp(e[c], -1.0f, 1.0f) * c_rotationScale);
+			}
+		}
+	}
+
+	// Quantize animated translation tracks relative to each track's range.
+	const uint32_t ntranslationGroups = ((uint32_t)m_translationTracks.size() + 3) / 4;
+	m_translationRanges.resize(ntranslationGroups * 24, 0.0f);
+	m_translationKeys.resize(nkeys * ntranslationGroups * 12, 0);
+	for (uint32_t g = 0; g < ntranslationGroups; ++g)
+	{
+		float* range = &m_translationRanges[g * 24];
+		for (uint32_t lane = 0; lane < 4; ++lane)
+		{
+			const uint32_t track = g * 4 + lane;
+			if (track >= m_translationTracks.size())
+				continue;
+
+			const uint32_t j = m_translationTracks[track];
+
+			float T_MATH_ALIGN16 mn[4], mx[4];
+			translations[j * nkeys].storeAligned(mn);
+			translations[j * nkeys].storeAligned(mx);
+			for (uint32_t k = 1; k < nkeys; ++k)
+			{
+				float T_MATH_ALIGN16 e[4];
+				translations[j * nkeys + k].storeAligned(e);
+				for (uint32_t c = 0; c < 3; ++c)
+				{
+					mn[c] = std::min(mn[c], e[c]);
+					mx[c] = std::max(mx[c], e[c]);
+				}
+			}
+
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				range[c * 4 + lane] = mn[c];
+				range[(3 + c) * 4 + lane] = (mx[c] - mn[c]) / c_translationScale;
+			}
+
+			for (uint32_t k = 0; k < nkeys; ++k)
+			{
+				uint16_t* group = &m_translationKeys[(k * ntranslationGroups + g) * 12];
+
+				float T_MATH_ALIGN16 e[4];
+				translations[j * nkeys + k].storeAligned(e);
+				for (uint32_t c = 0; c < 3; ++c)
+				{
+					const float scale = range[(3 + c) * 4 + lane];
+					group[c * 4 + lane] = scale > 0.0f ? (uint16_t)std::lround(clamp((e[c] - mn[c]) / scale, 0.0f, c_translationScale)) : 0;
+				}
+			}
+		}
+	}
+
+	for (const auto& keyPose : m_poses)
+		m_keyTimes.push_back(keyPose.at);
+
+	// Ensure compressed clip is within error bounds at each key.
+	Pose pose;
+	for (uint32_t k = 0; k < nkeys; ++k)
+	{
+		getCompressedPose(m_keyTimes[k], pose);
+		for (uint32_t j = 0; j < njoints; ++j)
+		{
+			const Transform transform = pose.getJointTransform(m_jointIndices[j]);
+			if (
+				rotationError(transform.rotation(), rotations[j * nkeys + k]) > rotationTolerance ||
+				(transform.translation() - translations[j * nkeys + k]).length() > Scalar(translationTolerance)
+			)
+			{
+				releaseCompressed();
+				return false;
+			}
+		}
+	}
+
+	m_poses.clear();
+	return true;
+}
+
 bool Animation::empty() const
 {
-	return m_poses.empty();
+	return m_poses.empty() && m_keyTimes.empty();
 }
 
 uint32_t Animation::getKeyPoseCount() const
@@ -69,29 +298,38 @@ const Animation::KeyPose& Animation::getLastKeyPose() const
 	return m_poses.back();
 }
 
+float Animation::getStartTime() const
+{
+	if (!m_keyTimes.empty())
+		return m_keyTimes.front();
+	else if (!m_poses.empty())
+		return m_poses.front().at;
+	else
+		return 0.0f;
+}
+
+float Animation::getEndTime() const
+{
+	if (!m_keyTimes.empty())
+		return m_keyTimes.back();
+	else if (!m_poses.empty())
+		return m_poses.back().at;
+	else
+		return 0.0f;
+}
+
 bool Animation::getPose(float at, Pose& outPose) const
 {
+	if (!m_keyTimes.empty())
+		return getCompressedPose(at, outPose);
+
 	const size_t nposes = m_poses.size();
 	if (nposes > 2)
 	{
-		int32_t index = -1;
-		int32_t index0 = 0;
-		int32_t index1 = int32_t(nposes - 2);
-
-		while (index0 < index1)
-		{
-			index = (index0 + index1) / 2;
-
-			const float Tkey0 = m_poses[index].at;
-			const float Tkey1 = m_poses[index + 1].at;
-
-			if (at < Tkey0)
-				index1 = index - 1;
-			else if (at > Tkey1)
-				index0 = index + 1;
-			else
-				break;
-		}
+		const auto it = std::upper_bound(m_poses.begin() + 1, m_poses.end() - 1, at, [](float at, const KeyPose& keyPose) {
+			return at < keyPose.at;
+		});
+		const size_t index = size_t(it - m_poses.begin()) - 1;
 
 		const Scalar k((at - m_poses[index].at) / (m_poses[index + 1].at - m_poses[index].at));
 
@@ -136,9 +374,127 @@ bool Animation::getPose(float at, Pose& outPose) const
 		return false;
 }
 
+bool Animation::getCompressedPose(float at, Pose& outPose) const
+{
+	static thread_local SampleScratch s_scratch;
+
+	const uint32_t nkeys = (uint32_t)m_keyTimes.size();
+	const uint32_t njoints = (uint32_t)m_jointIndices.size();
+
+	// Find keys surrounding time.
+	uint32_t key0 = 0, key1 = 0;
+	float k = 0.0f;
+	if (nkeys > 1)
+	{
+		if (at >= m_keyTimes.back())
+			key0 = key1 = nkeys - 1;
+		else if (at > m_keyTimes.front())
+		{
+			key1 = (uint32_t)(std::upper_bound(m_keyTimes.begin(), m_keyTimes.end(), at) - m_keyTimes.begin());
+			key0 = key1 - 1;
+			k = (at - m_keyTimes[key0]) / (m_keyTimes[key1] - m_keyTimes[key0]);
+		}
+	}
+
+	auto& rotations = s_scratch.rotations;
+	auto& translations = s_scratch.translations;
+	rotations.resize(njoints);
+	translations.resize(njoints);
+	for (uint32_t j = 0; j < njoints; ++j)
+	{
+		rotations[j] = m_constantTransforms[j].rotation().e;
+		translations[j] = m_constantTransforms[j].translation();
+	}
+
+	const Vector4 vk(k, k, k, k);
+
+	// Sample four rotation tracks at a time; keys are hemisphere aligned so normalized lerp is
+	// sufficient, quantization scale is also cancelled by normalization.
+	const uint32_t nrotationGroups = ((uint32_t)m_rotationTracks.size() + 3) / 4;
+	for (uint32_t g = 0; g < nrotationGroups; ++g)
+	{
+		const int16_t* q0 = &m_rotationKeys[(key0 * nrotationGroups + g) * 16];
+		const int16_t* q1 = &m_rotationKeys[(key1 * nrotationGroups + g) * 16];
+
+		Vector4 q[4];
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			const Vector4 a = loadInt16(q0 + c * 4);
+			const Vector4 b = loadInt16(q1 + c * 4);
+			q[c] = a + (b - a) * vk;
+		}
+
+		const Vector4 rl = reciprocalSquareRoot4(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+
+		float T_MATH_ALIGN16 e[4][4];
+		for (uint32_t c = 0; c < 4; ++c)
+			(q[c] * rl).storeAligned(e[c]);
+
+		const uint32_t nlanes = std::min< uint32_t >((uint32_t)m_rotationTracks.size() - g * 4, 4);
+		for (uint32_t lane = 0; lane < nlanes; ++lane)
+			rotations[m_rotationTracks[g * 4 + lane]] = Vector4(e[0][lane], e[1][lane], e[2][lane], e[3][lane]);
+	}
+
+	// Sample four translation tracks at a time.
+	const uint32_t ntranslationGroups = ((uint32_t)m_translationTracks.size() + 3) / 4;
+	for (uint32_t g = 0; g < ntranslationGroups; ++g)
+	{
+		const uint16_t* t0 = &m_translationKeys[(key0 * ntranslationGroups + g) * 12];
+		const uint16_t* t1 = &m_translationKeys[(key1 * ntranslationGroups + g) * 12];
+		const float* range = &m_translationRanges[g * 24];
+
+		float T_MATH_ALIGN16 e[3][4];
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			const Vector4 a = loadUInt16(t0 + c * 4);
+			const Vector4 b = loadUInt16(t1 + c * 4);
+			const Vector4 mn = Vector4::loadAligned(range + c * 4);
+			const Vector4 scale = Vector4::loadAligned(range + (3 + c) * 4);
+			(mn + (a + (b - a) * vk) * scale).storeAligned(e[c]);
+		}
+
+		const uint32_t nlanes = std::min< uint32_t >((uint32_t)m_translationTracks.size() - g * 4, 4);
+		for (uint32_t lane = 0; lane < nlanes; ++lane)
+			translations[m_translationTracks[g * 4 + lane]] = Vector4(e[0][lane], e[1][lane], e[2][lane], 0.0f);
+	}
+
+	// Joint indices are sorted thus joints are appended in order.
+	outPose.reset();
+	outPose.reserve(njoints);
+	for (uint32_t j = 0; j < njoints; ++j)
+		outPose.setJointTransform(m_jointIndices[j], Transform(translations[j], Quaternion(rotations[j])));
+
+	return true;
+}
+
+void Animation::releaseCompressed()
+{
+	m_keyTimes.clear();
+	m_jointIndices.clear();
+	m_constantTransforms.clear();
+	m_rotationTracks.clear();
+	m_rotationKeys.clear();
+	m_translationTracks.clear();
+	m_translationRanges.clear();
+	m_translationKeys.clear();
+}
+
 void Animation::serialize(ISerializer& s)
 {
 	s >> MemberAlignedVector< KeyPose, MemberComposite< KeyPose > >(L"poses", m_poses);
+
+	if (s.getVersion< Animation >() >= 1)
+	{
+		s >> MemberAlignedVector< float >(L"keyTimes", m_keyTimes);
+		s >> MemberAlignedVector< uint32_t >(L"jointIndices", m_jointIndices);
+		s >> MemberAlignedVector< Transform, MemberComposite< Transform > >(L"constantTransforms", m_constantTransforms);
+		s >> MemberAlignedVector< uint32_t >(L"rotationTracks", m_rotationTracks);
+		s >> MemberAlignedVector< int16_t >(L"rotationKeys", m_rotationKeys);
+		s >> MemberAlignedVector< uint32_t >(L"translationTracks", m_translationTracks);
+		s >> MemberAlignedVector< float >(L"translationRanges", m_translationRanges);
+		s >> MemberAlignedVector< uint16_t >(L"translationKeys", m_translationKeys);
+	}
+
 	s >> Member< float >(L"timePerDistance", m_timePerDistance);
 	s >> Member< Vector4 >(L"totalLocomotion", m_totalLocomotion);
 }
@@ -25,6 +25,11 @@ namespace traktor::animation
 
 /*! Key framed animation poses.
  * \ingroup Animation
+ *
+ * Animation is either stored as key poses, as produced
+ * by the importer, or as a compressed clip with per-joint
+ * tracks which is what the pipeline output at runtime.
+ * Key pose accessors are only valid on uncompressed animations.
  */
 class T_DLLCLASS Animation : public ISerializable
 {
@@ -52,6 +57,26 @@ public:
 	 */
 	void removeKeyPose(uint32_t poseIndex);
 
+	/*! Compress animation into per-joint tracks.
+	 *
+	 * Rotation and translation tracks which are constant within
+	 * tolerance are stripped, animated tracks are quantized into
+	 * 16 bits and stored in groups of four joints so they can be
+	 * sampled using SIMD. Key poses are released only if the
+	 * compressed clip is within given error bounds.
+	 *
+	 * \param rotationTolerance Max rotation error in radians.
+	 * \param translationTolerance Max translation error.
+	 * \return True if animation was compressed.
+	 */
+	bool compress(float rotationTolerance, float translationTolerance);
+
+	/*! Return true if animation has been compressed.
+	 *
+	 * \return True if compressed.
+	 */
+	bool isCompressed() const { return !m_keyTimes.empty(); }
+
 	/*! Return true if animation doesn't contain any poses.
 	 *
 	 * \return True if animation is empty.
@@ -84,6 +109,18 @@ public:
 	 */
 	const KeyPose& getLastKeyPose() const;
 
+	/*! Get time of first key.
+	 *
+	 * \return Start time.
+	 */
+	float getStartTime() const;
+
+	/*! Get time of last key.
+	 *
+	 * \return End time.
+	 */
+	float getEndTime() const;
+
 	/*! Get key pose from time.
 	 *
 	 * \param at Time
@@ -113,6 +150,20 @@ public:
 
 private:
 	AlignedVector< KeyPose > m_poses;
+
+	// Compressed clip; animated tracks are laid out as [key][group][component][lane].
+	AlignedVector< float > m_keyTimes;
+	AlignedVector< uint32_t > m_jointIndices;
+	AlignedVector< Transform > m_constantTransforms;
+	AlignedVector< uint32_t > m_rotationTracks;
+	AlignedVector< int16_t > m_rotationKeys;
+	AlignedVector< uint32_t > m_translationTracks;
+	AlignedVector< float > m_translationRanges;
+	AlignedVector< uint16_t > m_translationKeys;
+
+	bool getCompressedPose(float at, Pose& outPose) const;
+
+	void releaseCompressed();
 	float m_timePerDistance = 0.0f;
 	Vector4 m_totalLocomotion = Vector4::zero();
 };
@@ -31,7 +31,7 @@ void TimeFromLocomotion::calculateTime(const Animation* animation, const Transfo
 	m_time += outDeltaTime;
 
 	// Ensure time is always positive.
-	const float duration = animation->getLastKeyPose().at - animation->getKeyPose(0).at;
+	const float duration = animation->getEndTime() - animation->getStartTime();
 	while (m_time < 0.0f)
 		m_time += duration;
 
@@ -37,6 +37,8 @@ public:
 
 	virtual bool isCacheable(const TypeInfo& productType) const override final;
 
+	virtual bool isThreadSafe() const override final;
+
 	virtual Ref< Object > create(resource::IResourceManager* resourceManager, const db::Database* database, const db::Instance* instance, const TypeInfo& productType, const Object* current) const override final;
 };
 
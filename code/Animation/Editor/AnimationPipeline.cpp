@@ -20,6 +20,8 @@
 #include "Core/Math/Format.h"
 #include "Core/Misc/String.h"
 #include "Core/Serialization/DeepHash.h"
+#include "Core/Settings/PropertyBoolean.h"
+#include "Core/Settings/PropertyFloat.h"
 #include "Core/Settings/PropertyString.h"
 #include "Database/Instance.h"
 #include "Editor/IPipelineBuilder.h"
@@ -34,12 +36,15 @@
 namespace traktor::animation
 {
 
-T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.animation.AnimationPipeline", 16, AnimationPipeline, editor::IPipeline)
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.animation.AnimationPipeline", 17, AnimationPipeline, editor::IPipeline)
 
 bool AnimationPipeline::create(const editor::IPipelineSettings* settings, db::Database* database)
 {
 	m_assetPath = settings->getPropertyExcludeHash< std::wstring >(L"Pipeline.AssetPath", L"");
 	m_modelCachePath = settings->getPropertyExcludeHash< std::wstring >(L"Pipeline.ModelCache.Path");
+	m_compress = settings->getPropertyIncludeHash< bool >(L"AnimationPipeline.Compress", true);
+	m_rotationTolerance = settings->getPropertyIncludeHash< float >(L"AnimationPipeline.RotationTolerance", 0.001f);
+	m_translationTolerance = settings->getPropertyIncludeHash< float >(L"AnimationPipeline.TranslationTolerance", 0.001f);
 	return true;
 }
 
@@ -353,6 +358,14 @@ bool AnimationPipeline::buildOutput(
 		log::info << L"Removed " << (uncompressedCount - anim->getKeyPoseCount()) << L" redundant key poses in animation; was " << uncompressedCount << L", now " << anim->getKeyPoseCount() << Endl;
 	*/
 
+	// Compress into per-joint tracks; keep key poses if compressed clip isn't within tolerance.
+	if (m_compress && !anim->empty())
+	{
+		const uint32_t keyPoseCount = anim->getKeyPoseCount();
+		if (!anim->compress(m_rotationTolerance, m_translationTolerance))
+			log::warning << L"Unable to compress animation within tolerance; " << keyPoseCount << L" key pose(s) kept uncompressed." << Endl;
+	}
+
 	Ref< db::Instance > instance = pipelineBuilder->createOutputInstance(outputPath, outputGuid);
 	if (!instance)
 	{
@@ -69,6 +69,9 @@ public:
 private:
 	std::wstring m_assetPath;
 	std::wstring m_modelCachePath;
+	bool m_compress = true;
+	float m_rotationTolerance = 0.001f;
+	float m_translationTolerance = 0.001f;
 };
 
 }
@@ -12,14 +12,27 @@
 #include "Animation/SkeletonUtils.h"
 #include "Animation/IPoseController.h"
 #include "Animation/Joint.h"
+#include "Core/Containers/StaticVector.h"
 #include "Core/Misc/SafeDestroy.h"
+#include "Core/Thread/Acquire.h"
 #include "Core/Thread/JobManager.h"
+#include "Core/Thread/Semaphore.h"
 #include "World/Entity.h"
 
 #define T_USE_UPDATE_JOBS
 
 namespace traktor::animation
 {
+	namespace
+	{
+
+/*! Number of skeletons evaluated by each update job. */
+const uint32_t c_updateBatchSize = 8;
+
+Semaphore s_updateBatchLock;
+StaticVector< SkeletonComponent*, c_updateBatchSize > s_updateBatch;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.animation.SkeletonComponent", SkeletonComponent, world::IEntityComponent)
 
@@ -101,9 +114,17 @@ void SkeletonComponent::update(const world::UpdateParams& update)
 	}
 
 #if defined(T_USE_UPDATE_JOBS)
-	m_updatePoseControllerJob = JobManager::getInstance().add([=, this](){
-		updatePoseController(update.alternateTime, update.deltaTime);
-	});
+	// Queue skeleton into shared batch, batch is launched when full or
+	// when any skeleton in batch is synchronized.
+	m_updateTime = update.alternateTime;
+	m_updateDeltaTime = update.deltaTime;
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(s_updateBatchLock);
+		m_updatePending = true;
+		s_updateBatch.push_back(this);
+		if (s_updateBatch.full())
+			launchUpdateBatch();
+	}
 #else
 	updatePoseController(update.alternateTime, update.deltaTime);
 #endif
@@ -112,6 +133,12 @@ void SkeletonComponent::update(const world::UpdateParams& update)
 void SkeletonComponent::synchronize() const
 {
 #if defined(T_USE_UPDATE_JOBS)
+	if (m_updatePending)
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(s_updateBatchLock);
+		if (m_updatePending)
+			launchUpdateBatch();
+	}
 	if (m_updatePoseControllerJob)
 	{
 		m_updatePoseControllerJob->wait();
@@ -227,4 +254,25 @@ void SkeletonComponent::updatePoseController(double time, double deltaTime)
 		m_poseTransforms.push_back(m_jointTransforms[i]);
 }
 
+void SkeletonComponent::launchUpdateBatch()
+{
+	// Batch lock must be held by caller.
+	if (s_updateBatch.empty())
+		return;
+
+	const StaticVector< SkeletonComponent*, c_updateBatchSize > components = s_updateBatch;
+	s_updateBatch.clear();
+
+	Ref< Job > job = JobManager::getInstance().add([=](){
+		for (auto component : components)
+			component->updatePoseController(component->m_updateTime, component->m_updateDeltaTime);
+	});
+
+	for (auto component : components)
+	{
+		component->m_updatePoseControllerJob = job;
+		component->m_updatePending = false;
+	}
+}
+
 }
@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include "Animation/Pose.h"
 #include "Core/Containers/AlignedVector.h"
 #include "Core/Thread/Job.h"
@@ -92,8 +93,13 @@ private:
 	AlignedVector< Transform > m_jointTransforms;
 	AlignedVector< Transform > m_poseTransforms;
 	mutable Ref< Job > m_updatePoseControllerJob;
+	mutable std::atomic< bool > m_updatePending = false;
+	double m_updateTime = 0.0;
+	double m_updateDeltaTime = 0.0;
 
 	void updatePoseController(double time, double deltaTime);
+
+	static void launchUpdateBatch();
 };
 
 }
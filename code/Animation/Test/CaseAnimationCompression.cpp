@@ -0,0 +1,168 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cmath>
+#include "Animation/Pose.h"
+#include "Animation/Animation/Animation.h"
+#include "Animation/Test/CaseAnimationCompression.h"
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/Const.h"
+#include "Core/Serialization/BinarySerializer.h"
+#include "Core/Timer/Timer.h"
+
+namespace traktor::animation::test
+{
+	namespace
+	{
+
+const uint32_t c_jointCount = 64;
+const uint32_t c_keyCount = 60;
+const float c_keyRate = 30.0f;
+const int32_t c_characterCount = 1000;
+const float c_rotationTolerance = 0.001f;
+const float c_translationTolerance = 0.001f;
+
+/*! Synthetic clip, first half of joints are animated and the rest are static. */
+Ref< Animation > createAnimation()
+{
+	Ref< Animation > animation = new Animation();
+	for (uint32_t i = 0; i < c_keyCount; ++i)
+	{
+		const float at = i / c_keyRate;
+
+		Animation::KeyPose kp;
+		kp.at = at;
+		for (uint32_t j = 0; j < c_jointCount; ++j)
+		{
+			const float phase = j * 0.37f;
+			if (j < c_jointCount / 2)
+			{
+				const Quaternion rotation = Quaternion::fromAxisAngle(
+					Vector4(std::sin(phase), std::cos(phase), 0.5f, 0.0f).normalized(),
+					std::sin(at * TWO_PI + phase) * 1.2f
+				);
+				const Vector4 translation = (j % 4 == 0) ?
+					Vector4(std::sin(at * 3.0f + phase) * 0.8f, 0.1f * j, std::cos(at * 2.0f) * 0.4f) :
+					Vector4(0.0f, 0.1f * j, 0.0f);
+				kp.pose.setJointTransform(j, Transform(translation, rotation));
+			}
+			else
+				kp.pose.setJointTransform(j, Transform(Vector4(0.0f, 0.1f * j, 0.0f), Quaternion::fromAxisAngle(Vector4(0.0f, 1.0f, 0.0f), phase)));
+		}
+		animation->addKeyPose(kp);
+	}
+	return animation;
+}
+
+int64_t serializedSize(const Animation* animation)
+{
+	DynamicMemoryStream ms(false, true);
+	if (!BinarySerializer(&ms).writeObject(animation))
+		return 0;
+	return (int64_t)ms.getBuffer().size();
+}
+
+void measureError(const Pose& expected, const Pose& actual, float& inoutRotationError, float& inoutTranslationError)
+{
+	for (uint32_t j = 0; j < c_jointCount; ++j)
+	{
+		const Transform te = expected.getJointTransform(j);
+		const Transform ta = actual.getJointTransform(j);
+
+		const Quaternion qe = te.rotation().normalized();
+		const Quaternion qa = (dot(qe, ta.rotation()) < 0.0_simd) ? -ta.rotation() : ta.rotation();
+		inoutRotationError = std::max(inoutRotationError, 4.0f * std::asin(std::min((float)(qe.e - qa.e).length() * 0.5f, 1.0f)));
+		inoutTranslationError = std::max(inoutTranslationError, (float)(te.translation() - ta.translation()).length());
+	}
+}
+
+double measureSampling(const Animation* animation)
+{
+	Pose pose;
+	Timer timer;
+	for (int32_t i = 0; i < c_characterCount; ++i)
+		animation->getPose(std::fmod(i * 0.0173f, animation->getEndTime()), pose);
+	return timer.getElapsedTime();
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.animation.test.CaseAnimationCompression", 0, CaseAnimationCompression, traktor::test::Case)
+
+void CaseAnimationCompression::run()
+{
+	Ref< Animation > uncompressed = createAnimation();
+	Ref< Animation > compressed = createAnimation();
+
+	CASE_ASSERT(compressed->compress(c_rotationTolerance, c_translationTolerance));
+	CASE_ASSERT(compressed->isCompressed());
+	CASE_ASSERT(!compressed->empty());
+	CASE_ASSERT_EQUAL(compressed->getKeyPoseCount(), 0);
+	CASE_ASSERT_EQUAL(compressed->getStartTime(), uncompressed->getStartTime());
+	CASE_ASSERT_EQUAL(compressed->getEndTime(), uncompressed->getEndTime());
+
+	// Compressed clip must be within error bounds, both at and in between keys.
+	{
+		Pose expected, actual;
+		float rotationError = 0.0f;
+		float translationError = 0.0f;
+		for (float at = -0.1f; at <= uncompressed->getEndTime() + 0.1f; at += 0.25f / c_keyRate)
+		{
+			CASE_ASSERT(uncompressed->getPose(at, expected));
+			CASE_ASSERT(compressed->getPose(at, actual));
+			measureError(expected, actual, rotationError, translationError);
+		}
+		CASE_ASSERT(rotationError <= c_rotationTolerance * 2.0f);
+		CASE_ASSERT(translationError <= c_translationTolerance * 2.0f);
+	}
+
+	// Compressed clip survive serialization.
+	{
+		DynamicMemoryStream wms(false, true);
+		CASE_ASSERT(BinarySerializer(&wms).writeObject(compressed));
+
+		DynamicMemoryStream rms(wms.getBuffer(), true, false);
+		Ref< Animation > read = BinarySerializer(&rms).readObject< Animation >();
+		CASE_ASSERT(read != nullptr);
+		if (read)
+		{
+			Pose expected, actual;
+			float rotationError = 0.0f;
+			float translationError = 0.0f;
+			for (float at = 0.0f; at <= compressed->getEndTime(); at += 0.5f / c_keyRate)
+			{
+				compressed->getPose(at, expected);
+				read->getPose(at, actual);
+				measureError(expected, actual, rotationError, translationError);
+			}
+			CASE_ASSERT(rotationError <= FUZZY_EPSILON);
+			CASE_ASSERT(translationError <= FUZZY_EPSILON);
+		}
+	}
+
+	// Unable to compress within zero tolerance; key poses are kept.
+	{
+		Ref< Animation > animation = createAnimation();
+		CASE_ASSERT(!animation->compress(0.0f, 0.0f));
+		CASE_ASSERT(!animation->isCompressed());
+		CASE_ASSERT_EQUAL(animation->getKeyPoseCount(), c_keyCount);
+	}
+
+	const int64_t uncompressedSize = serializedSize(uncompressed);
+	const int64_t compressedSize = serializedSize(compressed);
+	CASE_ASSERT(compressedSize * 4 < uncompressedSize);
+
+	const double uncompressedTime = measureSampling(uncompressed);
+	const double compressedTime = measureSampling(compressed);
+
+	log::info << L"Animation, " << c_jointCount << L" joint(s), " << c_keyCount << L" key(s); " << uncompressedSize << L" byte(s) uncompressed, " << compressedSize << L" byte(s) compressed" << Endl;
+	log::info << L"Animation, sampling " << c_characterCount << L" character(s); " << int32_t(uncompressedTime * 1000000.0) << L" us uncompressed, " << int32_t(compressedTime * 1000000.0) << L" us compressed" << Endl;
+}
+
+}
@@ -45,6 +45,9 @@ public:
 
 	virtual DateTime lastAccessed() const override final;
 
+	/*! Get path to blob file, used by server to send blob straight from file. */
+	const Path& getPath() const { return m_path; }
+
 private:
     Path m_path;
 	int64_t m_size;
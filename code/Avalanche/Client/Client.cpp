@@ -6,6 +6,8 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Io/StreamCopy.h"
 #include "Core/Log/Log.h"
 #include "Core/Thread/Acquire.h"
 #include "Avalanche/Protocol.h"
@@ -89,6 +91,58 @@ bool Client::have(const Key& key)
 	return reply == c_replyOk;
 }
 
+bool Client::have(const AlignedVector< Key >& keys, AlignedVector< bool >& outHave)
+{
+	outHave.resize(0);
+	if (keys.empty())
+		return true;
+
+	Ref< net::SocketStream > stream = establish(c_commandStatMany);
+	if (!stream)
+		return false;
+
+	// Send entire batch in one write.
+	DynamicMemoryStream requestStream(false, true);
+	const uint32_t nkeys = (uint32_t)keys.size();
+	requestStream.write(&nkeys, sizeof(uint32_t));
+	for (const auto& key : keys)
+		key.write(&requestStream);
+
+	const auto& request = requestStream.getBuffer();
+	if (stream->write(request.c_ptr(), (int64_t)request.size()) != (int64_t)request.size())
+	{
+		log::error << L"Unable to write keys to server (have)." << Endl;
+		return false;
+	}
+
+	outHave.resize(nkeys, false);
+	for (uint32_t i = 0; i < nkeys; ++i)
+	{
+		uint8_t reply = 0;
+		if (stream->read(&reply, sizeof(uint8_t)) != sizeof(uint8_t))
+		{
+			log::error << L"Unable to read reply from server (have)." << Endl;
+			return false;
+		}
+
+		if (reply == c_replyOk)
+		{
+			int64_t blobSize = 0;
+			if (stream->read(&blobSize, sizeof(int64_t)) != sizeof(int64_t))
+			{
+				log::error << L"Unable to read blob size from server (have)." << Endl;
+				return false;
+			}
+			outHave[i] = true;
+		}
+		else if (reply != c_replyFailure)
+			return false;
+	}
+
+	release(stream);
+	return true;
+}
+
 bool Client::touch(const AlignedVector< Key >& keys)
 {
 	Ref< net::SocketStream > stream  = establish(c_commandTouch);
@@ -206,6 +260,64 @@ Ref< IStream > Client::get(const Key& key)
 	return new ClientGetStream(this, stream, blobSize);
 }
 
+bool Client::get(const AlignedVector< Key >& keys, RefArray< IStream >& outStreams)
+{
+	outStreams.resize(0);
+	if (keys.empty())
+		return true;
+
+	Ref< net::SocketStream > stream = establish(c_commandGetMany);
+	if (!stream)
+		return false;
+
+	DynamicMemoryStream requestStream(false, true);
+	const uint32_t nkeys = (uint32_t)keys.size();
+	requestStream.write(&nkeys, sizeof(uint32_t));
+	for (const auto& key : keys)
+		key.write(&requestStream);
+
+	const auto& request = requestStream.getBuffer();
+	if (stream->write(request.c_ptr(), (int64_t)request.size()) != (int64_t)request.size())
+	{
+		log::error << L"Unable to write keys to server (get)." << Endl;
+		return false;
+	}
+
+	outStreams.resize(nkeys);
+	for (uint32_t i = 0; i < nkeys; ++i)
+	{
+		uint8_t reply = 0;
+		if (stream->read(&reply, sizeof(uint8_t)) != sizeof(uint8_t))
+		{
+			log::error << L"Unable to read reply from server (get)." << Endl;
+			return false;
+		}
+
+		if (reply == c_replyFailure)
+			continue;
+		else if (reply != c_replyOk)
+			return false;
+
+		int64_t blobSize = 0;
+		if (stream->read(&blobSize, sizeof(int64_t)) != sizeof(int64_t))
+		{
+			log::error << L"Unable to read blob size from server (get)." << Endl;
+			return false;
+		}
+
+		Ref< DynamicMemoryStream > blobStream = new DynamicMemoryStream(true, true);
+		if (!StreamCopy(blobStream, stream).execute(blobSize))
+		{
+			log::error << L"Unable to read blob from server (get)." << Endl;
+			return false;
+		}
+		outStreams[i] = blobStream;
+	}
+
+	release(stream);
+	return true;
+}
+
 Ref< IStream > Client::put(const Key& key)
 {
 	Ref< net::SocketStream > stream = establish(c_commandPut);
@@ -238,6 +350,51 @@ Ref< IStream > Client::put(const Key& key)
 	return new ClientPutStream(this, stream);
 }
 
+bool Client::put(const AlignedVector< Key >& keys, const RefArray< IStream >& streams, AlignedVector< bool >& outCommitted)
+{
+	T_ASSERT(keys.size() == streams.size());
+
+	outCommitted.resize(0);
+	if (keys.empty())
+		return true;
+
+	Ref< net::SocketStream > stream = establish(c_commandPutMany);
+	if (!stream)
+		return false;
+
+	const uint32_t nblobs = (uint32_t)keys.size();
+	if (stream->write(&nblobs, sizeof(uint32_t)) != sizeof(uint32_t))
+		return false;
+
+	for (uint32_t i = 0; i < nblobs; ++i)
+	{
+		const int64_t blobSize = streams[i]->available();
+		if (
+			!keys[i].write(stream) ||
+			stream->write(&blobSize, sizeof(int64_t)) != sizeof(int64_t) ||
+			!StreamCopy(stream, streams[i]).execute(blobSize)
+		)
+		{
+			log::error << L"Unable to write blob to server (put)." << Endl;
+			return false;
+		}
+	}
+
+	AlignedVector< uint8_t > replies(nblobs);
+	if (stream->read(replies.ptr(), nblobs) != nblobs)
+	{
+		log::error << L"Unable to read reply from server (put)." << Endl;
+		return false;
+	}
+
+	outCommitted.resize(nblobs);
+	for (uint32_t i = 0; i < nblobs; ++i)
+		outCommitted[i] = (replies[i] == c_replyOk);
+
+	release(stream);
+	return true;
+}
+
 bool Client::stats(Dictionary::Stats& outStats)
 {
 	Ref< net::SocketStream > stream = establish(c_commandStats);
@@ -306,6 +463,9 @@ Ref< net::SocketStream > Client::establish(uint8_t command)
 		return nullptr;
 	}
 
+	// Requests are small and latency bound; don't let Nagle hold them back.
+	socket->setNoDelay(true);
+
 	Ref< net::SocketStream > stream = new net::SocketStream(socket, true, true, 5000);
 	if (stream->write(&command, sizeof(uint8_t)) != sizeof(uint8_t))
 	{
@@ -316,4 +476,10 @@ Ref< net::SocketStream > Client::establish(uint8_t command)
 	return stream;
 }
 
+void Client::release(net::SocketStream* stream)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	m_streams.push_back(stream);
+}
+
 }
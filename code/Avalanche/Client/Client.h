@@ -46,14 +46,42 @@ public:
 
 	bool have(const Key& key);
 
+	/*! Query existence of multiple blobs in a single round-trip.
+	 *
+	 * \param keys Keys of blobs.
+	 * \param outHave Existence of each blob, same order as keys.
+	 * \return True if query succeeded.
+	 */
+	bool have(const AlignedVector< Key >& keys, AlignedVector< bool >& outHave);
+
 	bool touch(const AlignedVector< Key >& keys);
 
 	bool evict(const AlignedVector< Key >& keys);
 
 	Ref< IStream > get(const Key& key);
 
+	/*! Get multiple blobs in a single round-trip.
+	 *
+	 * Blobs are read completely into memory, use single get
+	 * to stream large blobs.
+	 *
+	 * \param keys Keys of blobs.
+	 * \param outStreams Memory stream of each blob, null if blob doesn't exist.
+	 * \return True if request succeeded.
+	 */
+	bool get(const AlignedVector< Key >& keys, RefArray< IStream >& outStreams);
+
 	Ref< IStream > put(const Key& key);
 
+	/*! Put multiple blobs in a single round-trip.
+	 *
+	 * \param keys Keys of blobs.
+	 * \param streams Stream of each blob, all available data is sent.
+	 * \param outCommitted Commit status of each blob, false if already exist or failed.
+	 * \return True if request succeeded.
+	 */
+	bool put(const AlignedVector< Key >& keys, const RefArray< IStream >& streams, AlignedVector< bool >& outCommitted);
+
 	bool stats(Dictionary::Stats& outStats);
 
 	bool getKeys(AlignedVector< Key >& outKeys);
@@ -69,6 +97,8 @@ private:
 	Semaphore m_lock;
 
 	Ref< net::SocketStream > establish(uint8_t command);
+
+	void release(net::SocketStream* stream);
 };
 
 }
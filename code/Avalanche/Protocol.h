@@ -25,6 +25,9 @@ constexpr static uint8_t c_commandStats			= 0x05;
 constexpr static uint8_t c_commandKeys			= 0x06;
 constexpr static uint8_t c_commandTouch			= 0x07;
 constexpr static uint8_t c_commandEvict			= 0x08;
+constexpr static uint8_t c_commandStatMany		= 0x09;	//!< Batched STAT; uint32 count, keys; reply and size per key.
+constexpr static uint8_t c_commandGetMany		= 0x0a;	//!< Batched GET; uint32 count, keys; reply, size and data per key.
+constexpr static uint8_t c_commandPutMany		= 0x0b;	//!< Batched PUT; uint32 count, key, size and data per blob; reply per blob.
 
 constexpr static uint8_t c_subCommandPutAppend	= 0x41;
 constexpr static uint8_t c_subCommandPutCommit	= 0x42;
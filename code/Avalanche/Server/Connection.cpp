@@ -6,12 +6,22 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#if defined(__LINUX__) || defined(__ANDROID__)
+#	include <cerrno>
+#	include <fcntl.h>
+#	include <sys/sendfile.h>
+#	include <unistd.h>
+#endif
+#include "Avalanche/BlobFile.h"
 #include "Avalanche/Dictionary.h"
 #include "Avalanche/IBlob.h"
 #include "Avalanche/Protocol.h"
 #include "Avalanche/Server/Connection.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Io/DynamicMemoryStream.h"
 #include "Core/Io/StreamCopy.h"
 #include "Core/Log/Log.h"
+#include "Core/Misc/TString.h"
 #include "Core/Thread/ThreadPool.h"
 #include "Net/SocketAddressIPv4.h"
 #include "Net/SocketStream.h"
@@ -37,28 +47,39 @@ Connection::~Connection()
 	}
 }
 
-bool Connection::create(net::TcpSocket* clientSocket)
+bool Connection::create(net::TcpSocket* clientSocket, bool threaded)
 {
 	m_clientSocket = clientSocket;
 	m_clientStream = new net::SocketStream(clientSocket, true, true, 5000);
 
-	std::wstring name = L"<unknown>";
+	m_name = L"<unknown>";
 
 	auto remoteAddress = dynamic_type_cast< const net::SocketAddressIPv4* >(clientSocket->getRemoteAddress());
 	if (remoteAddress)
-		name = remoteAddress->getHostName();
+		m_name = remoteAddress->getHostName();
 
+	clientSocket->setNoDelay(true);
 	clientSocket->setQuickAck(true);
 
-	auto fn = [=]()
+	// Multiplexed connections are processed by server's workers.
+	if (!threaded)
 	{
-		log::info << L"Connection with " << name << L" established, ready to process requests." << Endl;
+		log::info << L"Connection with " << m_name << L" established, ready to process requests." << Endl;
+		return true;
+	}
+
+	auto fn = [=, this]()
+	{
+		log::info << L"Connection with " << m_name << L" established, ready to process requests." << Endl;
 		while (!m_thread->stopped())
 		{
-			if (!process())
+			const int32_t result = m_clientSocket->select(true, false, false, 500);
+			if (result == 0)
+				continue;
+			else if (result < 0 || !processCommand())
 				break;
 		}
-		log::info << L"Connection with " << name << L" terminated." << Endl;
+		log::info << L"Connection with " << m_name << L" terminated." << Endl;
 		m_finished = true;
 	};
 
@@ -75,12 +96,27 @@ bool Connection::update()
 
 bool Connection::process()
 {
-	const int32_t result = m_clientSocket->select(true, false, false, 500);
-	if (result == 0)
-		return true;
-	else if (result < 0)
+	if (m_finished)
 		return false;
 
+	// Drain all requests already received from client, pipelined requests
+	// are thus served without returning to the multiplexer in between.
+	do
+	{
+		if (!processCommand())
+		{
+			log::info << L"Connection with " << m_name << L" terminated." << Endl;
+			m_finished = true;
+			return false;
+		}
+	}
+	while (m_clientSocket->select(true, false, false, 0) > 0);
+
+	return true;
+}
+
+bool Connection::processCommand()
+{
 	uint8_t cmd = 0;
 	if (m_clientStream->read(&cmd, sizeof(uint8_t)) != sizeof(uint8_t))
 		return false;
@@ -130,33 +166,11 @@ bool Connection::process()
 				return false;
 			}
 
-			Ref< const IBlob > blob = m_dictionary->get(key, false);
+			Ref< IBlob > blob = m_dictionary->get(key, false);
 			if (blob)
 			{
-				auto readStream = blob->read();
-				if (readStream)
-				{
-					if (m_clientStream->write(&c_replyOk, sizeof(uint8_t)) != sizeof(uint8_t))
-						return false;
-
-					const int64_t blobSize = blob->size();
-					if (m_clientStream->write(&blobSize, sizeof(int64_t)) != sizeof(int64_t))
-						return false;
-
-					if (!StreamCopy(m_clientStream, readStream).execute(blob->size()))
-					{
-						log::error << L"[GET " << key.format() << L"] Unable to send " << blob->size() << L" byte(s) to client; terminating connection." << Endl;
-						return false;
-					}
-					else
-						log::info << L"[GET " << key.format() << L"] Sent " << blob->size() << L" bytes." << Endl;
-				}
-				else
-				{
-					log::error <<  L"[GET " << key.format() << L"] Unable to acquire read stream from blob." << Endl;
-					if (m_clientStream->write(&c_replyFailure, sizeof(uint8_t)) != sizeof(uint8_t))
-						return false;
-				}
+				if (!sendBlob(key, blob))
+					return false;
 			}
 			else
 			{
@@ -363,6 +377,104 @@ bool Connection::process()
 		}
 		break;
 
+	case c_commandStatMany:
+		{
+			uint32_t nkeys;
+			if (m_clientStream->read(&nkeys, sizeof(uint32_t)) != sizeof(uint32_t))
+				return false;
+
+			// Gather all replies and send them at once.
+			DynamicMemoryStream replyStream(false, true);
+			for (uint32_t i = 0; i < nkeys; ++i)
+			{
+				const Key key = Key::read(m_clientStream);
+				if (!key.valid())
+				{
+					log::warning << L"Failed to read key; terminating connection." << Endl;
+					return false;
+				}
+
+				Ref< const IBlob > blob = m_dictionary->get(key, true);
+				if (blob)
+				{
+					const int64_t blobSize = blob->size();
+					replyStream.write(&c_replyOk, sizeof(uint8_t));
+					replyStream.write(&blobSize, sizeof(int64_t));
+				}
+				else
+					replyStream.write(&c_replyFailure, sizeof(uint8_t));
+			}
+
+			const auto& reply = replyStream.getBuffer();
+			if (!reply.empty() && m_clientStream->write(reply.c_ptr(), (int64_t)reply.size()) != (int64_t)reply.size())
+				return false;
+		}
+		break;
+
+	case c_commandGetMany:
+		{
+			uint32_t nkeys;
+			if (m_clientStream->read(&nkeys, sizeof(uint32_t)) != sizeof(uint32_t))
+				return false;
+
+			// Read all keys before replying so client can send entire batch without waiting.
+			AlignedVector< Key > keys(nkeys);
+			for (uint32_t i = 0; i < nkeys; ++i)
+			{
+				keys[i] = Key::read(m_clientStream);
+				if (!keys[i].valid())
+				{
+					log::warning << L"Failed to read key; terminating connection." << Endl;
+					return false;
+				}
+			}
+
+			for (const auto& key : keys)
+			{
+				Ref< IBlob > blob = m_dictionary->get(key, false);
+				if (blob)
+				{
+					if (!sendBlob(key, blob))
+						return false;
+				}
+				else
+				{
+					if (m_clientStream->write(&c_replyFailure, sizeof(uint8_t)) != sizeof(uint8_t))
+						return false;
+				}
+			}
+		}
+		break;
+
+	case c_commandPutMany:
+		{
+			uint32_t nblobs;
+			if (m_clientStream->read(&nblobs, sizeof(uint32_t)) != sizeof(uint32_t))
+				return false;
+
+			AlignedVector< uint8_t > replies(nblobs, c_replyFailure);
+			for (uint32_t i = 0; i < nblobs; ++i)
+			{
+				const Key key = Key::read(m_clientStream);
+				if (!key.valid())
+				{
+					log::warning << L"Failed to read key; terminating connection." << Endl;
+					return false;
+				}
+
+				int64_t blobSize;
+				if (m_clientStream->read(&blobSize, sizeof(int64_t)) != sizeof(int64_t))
+					return false;
+
+				if (!receiveBlob(key, blobSize, replies[i]))
+					return false;
+			}
+
+			if (nblobs > 0 && m_clientStream->write(replies.c_ptr(), nblobs) != nblobs)
+				return false;
+		}
+		break;
+
 	default:
 		log::error << L"Invalid command from client; terminating connection." << Endl;
 		return false;
@@ -371,4 +483,119 @@ bool Connection::process()
 	return true;
 }
 
+bool Connection::sendBlob(const Key& key, IBlob* blob)
+{
+	const int64_t blobSize = blob->size();
+
+#if defined(__LINUX__) || defined(__ANDROID__)
+	// Send file blobs directly from page cache, avoiding copying through user space.
+	if (auto blobFile = dynamic_type_cast< const BlobFile* >(blob))
+	{
+		const int fd = ::open(wstombs(blobFile->getPath().getPathNameOS()).c_str(), O_RDONLY);
+		if (fd >= 0)
+		{
+			blob->touch();
+
+			if (
+				m_clientStream->write(&c_replyOk, sizeof(uint8_t)) != sizeof(uint8_t) ||
+				m_clientStream->write(&blobSize, sizeof(int64_t)) != sizeof(int64_t)
+			)
+			{
+				::close(fd);
+				return false;
+			}
+
+			off_t offset = 0;
+			while (offset < blobSize)
+			{
+				if (m_clientSocket->select(false, true, false, 5000) <= 0)
+					break;
+
+				const ssize_t nsent = ::sendfile((int)m_clientSocket->handle(), fd, &offset, (size_t)(blobSize - offset));
+				if (nsent < 0 && (errno == EAGAIN || errno == EINTR))
+					continue;
+				else if (nsent <= 0)
+					break;
+			}
+
+			::close(fd);
+
+			if (offset < blobSize)
+			{
+				log::error << L"[GET " << key.format() << L"] Unable to send " << blobSize << L" byte(s) to client; terminating connection." << Endl;
+				return false;
+			}
+
+			log::info << L"[GET " << key.format() << L"] Sent " << blobSize << L" bytes." << Endl;
+			return true;
+		}
+	}
+#endif
+
+	Ref< IStream > readStream = blob->read();
+	if (!readStream)
+	{
+		log::error <<  L"[GET " << key.format() << L"] Unable to acquire read stream from blob." << Endl;
+		return m_clientStream->write(&c_replyFailure, sizeof(uint8_t)) == sizeof(uint8_t);
+	}
+
+	if (m_clientStream->write(&c_replyOk, sizeof(uint8_t)) != sizeof(uint8_t))
+		return false;
+
+	if (m_clientStream->write(&blobSize, sizeof(int64_t)) != sizeof(int64_t))
+		return false;
+
+	if (!StreamCopy(m_clientStream, readStream).execute(blobSize))
+	{
+		log::error << L"[GET " << key.format() << L"] Unable to send " << blobSize << L" byte(s) to client; terminating connection." << Endl;
+		return false;
+	}
+
+	log::info << L"[GET " << key.format() << L"] Sent " << blobSize << L" bytes." << Endl;
+	return true;
+}
+
+bool Connection::receiveBlob(const Key& key, int64_t blobSize, uint8_t& outReply)
+{
+	outReply = c_replyFailure;
+
+	// Blob data must always be consumed from socket, even if rejected, to keep stream in sync.
+	Ref< IBlob > blob;
+	if (m_dictionary->get(key, true) == nullptr)
+		blob = m_dictionary->create();
+	else
+		log::error << L"[PUT " << key.format() << L"] Cannot replace existing blob." << Endl;
+
+	Ref< IStream > appendStream = blob ? blob->append() : nullptr;
+	if (appendStream)
+	{
+		if (!StreamCopy(appendStream, m_clientStream).execute(blobSize))
+		{
+			log::error << L"[PUT " << key.format() << L"] Unable to receive " << blobSize << L" byte(s) from client; terminating connection." << Endl;
+			return false;
+		}
+		appendStream->close();
+		appendStream = nullptr;
+
+		if (m_dictionary->put(key, blob, false))
+		{
+			log::info << L"[PUT " << key.format() << L"] Committed " << blob->size() << L" byte(s)." << Endl;
+			outReply = c_replyOk;
+		}
+	}
+	else
+	{
+		uint8_t dummy[4096];
+		for (int64_t remaining = blobSize; remaining > 0; )
+		{
+			const int64_t nread = m_clientStream->read(dummy, std::min< int64_t >(remaining, sizeof(dummy)));
+			if (nread <= 0)
+				return false;
+			remaining -= nread;
+		}
+	}
+
+	return true;
 }
+
+}
\ No newline at end of file
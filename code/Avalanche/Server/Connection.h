@@ -8,8 +8,10 @@
  */
 #pragma once
 
+#include <string>
 #include "Core/Object.h"
 #include "Core/Ref.h"
+#include "Core/Misc/Key.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -38,7 +40,14 @@ namespace traktor::avalanche
 {
 
 class Dictionary;
+class IBlob;
 
+/*! Server side client connection.
+ *
+ * A connection either run on it's own thread or,
+ * when multiplexed, is processed by server's worker
+ * threads when socket becomes readable.
+ */
 class T_DLLCLASS Connection : public Object
 {
 	T_RTTI_CLASS;
@@ -48,18 +57,31 @@ public:
 
 	virtual ~Connection();
 
-	bool create(net::TcpSocket* clientSocket);
+	bool create(net::TcpSocket* clientSocket, bool threaded);
 
 	bool update();
 
+	/*! Process all requests pending on socket.
+	 *
+	 * \return False if connection has been terminated.
+	 */
+	bool process();
+
+	net::TcpSocket* getSocket() const { return m_clientSocket; }
+
 private:
 	Dictionary* m_dictionary = nullptr;
 	Ref< net::TcpSocket > m_clientSocket;
 	Ref< net::SocketStream > m_clientStream;
 	Thread* m_thread = nullptr;
+	std::wstring m_name;
 	std::atomic< bool > m_finished;
 
-	bool process();
+	bool processCommand();
+
+	bool sendBlob(const Key& key, IBlob* blob);
+
+	bool receiveBlob(const Key& key, int64_t blobSize, uint8_t& outReply);
 };
 
 }
@@ -6,6 +6,10 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#if defined(__LINUX__) || defined(__ANDROID__)
+#	include <sys/epoll.h>
+#	include <unistd.h>
+#endif
 #include "Avalanche/Dictionary.h"
 #include "Avalanche/IBlob.h"
 #include "Avalanche/Server/Connection.h"
@@ -20,6 +24,9 @@
 #include "Core/Settings/PropertyInteger.h"
 #include "Core/Settings/PropertyString.h"
 #include "Core/System/OS.h"
+#include "Core/Thread/Acquire.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
 #include "Net/SocketAddressIPv4.h"
 #include "Net/TcpSocket.h"
 #include "Net/Discovery/DiscoveryManager.h"
@@ -27,6 +34,12 @@
 
 namespace traktor::avalanche
 {
+	namespace
+	{
+
+const int32_t c_maxEvents = 64;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.avalanche.Server", Server, Object)
 
@@ -72,6 +85,43 @@ bool Server::create(const PropertyGroup* settings)
 	m_master = settings->getProperty< bool >(L"Avalanche.Master", false);
 	m_memoryBudget = settings->getProperty< int32_t >(L"Avalanche.MemoryBudget", 8);
 
+	// Multiplex connections onto a bounded set of worker threads.
+#if defined(__LINUX__) || defined(__ANDROID__)
+	if (settings->getProperty< bool >(L"Avalanche.Multiplexed", true))
+	{
+		m_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+		if (m_epoll < 0)
+		{
+			log::error << L"Unable to create epoll instance." << Endl;
+			return false;
+		}
+
+		epoll_event ev = {};
+		ev.events = EPOLLIN;
+		ev.data.ptr = nullptr;
+		if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, (int)m_serverSocket->handle(), &ev) != 0)
+		{
+			log::error << L"Unable to register server socket with epoll." << Endl;
+			return false;
+		}
+
+		const int32_t workerCount = std::max< int32_t >(settings->getProperty< int32_t >(L"Avalanche.Workers", (int32_t)OS::getInstance().getCPUCoreCount()), 1);
+		for (int32_t i = 0; i < workerCount; ++i)
+		{
+			Thread* worker = ThreadManager::getInstance().create(
+				[this]() { threadWorker(); },
+				L"Avalanche worker"
+			);
+			if (!worker)
+				return false;
+			worker->start();
+			m_workers.push_back(worker);
+		}
+
+		log::info << L"Multiplexing connections onto " << workerCount << L" worker thread(s)." << Endl;
+	}
+#endif
+
 	// Broadcast our self on the network.
 	Ref< PropertyGroup > publishSettings = DeepClone(settings).create< PropertyGroup >();
 	publishSettings->setProperty< PropertyInteger >(L"Avalanche.Version.Major", c_majorVersion);
@@ -95,6 +145,24 @@ bool Server::create(const PropertyGroup* settings)
 
 void Server::destroy()
 {
+	for (auto worker : m_workers)
+		worker->stop(0);
+	for (auto worker : m_workers)
+	{
+		worker->stop();
+		ThreadManager::getInstance().destroy(worker);
+	}
+	m_workers.clear();
+	m_ready.clear();
+
+#if defined(__LINUX__) || defined(__ANDROID__)
+	if (m_epoll >= 0)
+	{
+		::close(m_epoll);
+		m_epoll = -1;
+	}
+#endif
+
 	m_connections.clear();
 	m_peers.clear();
 	safeClose(m_serverSocket);
@@ -104,17 +172,11 @@ void Server::destroy()
 
 bool Server::update()
 {
-	// Accept new connections.
-	if (m_serverSocket->select(true, false, false, 500) > 0)
-	{
-		Ref< net::TcpSocket > clientSocket = m_serverSocket->accept();
-		if (clientSocket)
-		{
-			Ref< Connection > connection = new Connection(m_dictionary);
-			if (connection->create(clientSocket))
-				m_connections.push_back(connection);
-		}
-	}
+	// Accept new connections, dispatch readable connections to workers if multiplexed.
+	if (m_epoll >= 0)
+		multiplex(500);
+	else if (m_serverSocket->select(true, false, false, 500) > 0)
+		accept();
 
 	// Cleanup terminated connections.
 	{
@@ -252,4 +314,95 @@ bool Server::update()
 	return true;
 }
 
+void Server::accept()
+{
+	Ref< net::TcpSocket > clientSocket = m_serverSocket->accept();
+	if (!clientSocket)
+		return;
+
+	Ref< Connection > connection = new Connection(m_dictionary);
+	if (!connection->create(clientSocket, m_epoll < 0))
+		return;
+
+#if defined(__LINUX__) || defined(__ANDROID__)
+	if (m_epoll >= 0)
+	{
+		// One-shot so only a single worker process connection at any time;
+		// worker re-arm connection when it's done.
+		epoll_event ev = {};
+		ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+		ev.data.ptr = connection.ptr();
+		if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, (int)clientSocket->handle(), &ev) != 0)
+		{
+			log::error << L"Unable to register connection with epoll." << Endl;
+			return;
+		}
+	}
+#endif
+
+	m_connections.push_back(connection);
+}
+
+void Server::multiplex(int32_t timeout)
+{
+#if defined(__LINUX__) || defined(__ANDROID__)
+	epoll_event events[c_maxEvents];
+	const int32_t nevents = ::epoll_wait(m_epoll, events, c_maxEvents, timeout);
+	if (nevents <= 0)
+		return;
+
+	int32_t nready = 0;
+	for (int32_t i = 0; i < nevents; ++i)
+	{
+		if (events[i].data.ptr == nullptr)
+			accept();
+		else
+		{
+			// Connection is kept alive by m_connections until it has finished,
+			// and finished connections are never re-armed.
+			Connection* connection = static_cast< Connection* >(events[i].data.ptr);
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_readyLock);
+			m_ready.push_back(connection);
+			++nready;
+		}
+	}
+
+	if (nready > 0)
+		m_readyEvent.pulse(nready);
+#endif
+}
+
+void Server::threadWorker()
+{
+	Thread* thread = ThreadManager::getInstance().getCurrentThread();
+	while (!thread->stopped())
+	{
+		Ref< Connection > connection;
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_readyLock);
+			if (!m_ready.empty())
+			{
+				connection = m_ready.front();
+				m_ready.pop_front();
+			}
+		}
+		if (!connection)
+		{
+			m_readyEvent.wait(100);
+			continue;
+		}
+
+		if (!connection->process())
+			continue;
+
+#if defined(__LINUX__) || defined(__ANDROID__)
+		// Re-arm connection so we get notified when next request arrives.
+		epoll_event ev = {};
+		ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+		ev.data.ptr = connection.ptr();
+		::epoll_ctl(m_epoll, EPOLL_CTL_MOD, (int)connection->getSocket()->handle(), &ev);
+#endif
+	}
+}
+
 }
@@ -12,6 +12,9 @@
 #include "Core/Guid.h"
 #include "Core/Ref.h"
 #include "Core/RefArray.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Thread/Event.h"
+#include "Core/Thread/Semaphore.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -25,6 +28,7 @@ namespace traktor
 {
 
 class PropertyGroup;
+class Thread;
 
 }
 
@@ -43,13 +47,19 @@ class Connection;
 class Dictionary;
 class Peer;
 
+/*! Avalanche cache server.
+ *
+ * Connections are by default multiplexed onto a bounded
+ * pool of worker threads (epoll on Linux); set "Avalanche.Multiplexed"
+ * to false, or run on other platforms, to get one thread per connection.
+ */
 class T_DLLCLASS Server : public Object
 {
 	T_RTTI_CLASS;
 
 public:
 	constexpr static int32_t c_majorVersion = 7;
-	constexpr static int32_t c_minorVersion = 0;
+	constexpr static int32_t c_minorVersion = 1;
 
 	bool create(const PropertyGroup* settings);
 
@@ -68,6 +78,17 @@ private:
 	Guid m_instanceId;
 	bool m_master = false;
 	int32_t m_memoryBudget = 8;
+	int32_t m_epoll = -1;
+	AlignedVector< Thread* > m_workers;
+	RefArray< Connection > m_ready;
+	Semaphore m_readyLock;
+	Event m_readyEvent;
+
+	void accept();
+
+	void multiplex(int32_t timeout);
+
+	void threadWorker();
 };
 
 }
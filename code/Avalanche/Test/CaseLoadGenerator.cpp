@@ -0,0 +1,203 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include "Avalanche/Client/Client.h"
+#include "Avalanche/Server/Server.h"
+#include "Avalanche/Test/CaseLoadGenerator.h"
+#include "Core/Io/MemoryStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Settings/PropertyBoolean.h"
+#include "Core/Settings/PropertyGroup.h"
+#include "Core/Settings/PropertyInteger.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Core/Timer/Timer.h"
+#include "Net/SocketAddressIPv4.h"
+
+namespace traktor::avalanche::test
+{
+	namespace
+	{
+
+const int32_t c_blobCount = 64;
+const int32_t c_blobSize = 4096;
+const int32_t c_clientCount = 16;
+const int32_t c_requestCount = 64;
+const int32_t c_batchSize = 16;
+
+struct Result
+{
+	double throughput = 0.0;
+	double p99 = 0.0;
+	int32_t failed = 0;
+};
+
+Key blobKey(int32_t index)
+{
+	return Key(0x1234, 0x5678, 0x9abc, (uint32_t)index);
+}
+
+/*! Hammer server from multiple clients; each request either a single GET or a batch of GETs. */
+Result generateLoad(const net::SocketAddressIPv4& address, bool batched)
+{
+	AlignedVector< double > latencies[c_clientCount];
+	std::atomic< int32_t > failed = 0;
+
+	AlignedVector< Thread* > threads;
+	Timer timer;
+
+	for (int32_t i = 0; i < c_clientCount; ++i)
+	{
+		Thread* thread = ThreadManager::getInstance().create([&, i]() {
+			Ref< Client > client = new Client(address);
+			for (int32_t j = 0; j < c_requestCount; ++j)
+			{
+				const double start = timer.getElapsedTime();
+				if (batched)
+				{
+					AlignedVector< Key > keys;
+					for (int32_t k = 0; k < c_batchSize; ++k)
+						keys.push_back(blobKey((i + j * c_batchSize + k) % c_blobCount));
+
+					RefArray< IStream > streams;
+					if (!client->get(keys, streams) || streams.size() != c_batchSize)
+						failed++;
+					else
+					{
+						for (auto stream : streams)
+						{
+							if (!stream || stream->available() != c_blobSize)
+								failed++;
+						}
+					}
+				}
+				else
+				{
+					for (int32_t k = 0; k < c_batchSize; ++k)
+					{
+						Ref< IStream > stream = client->get(blobKey((i + j * c_batchSize + k) % c_blobCount));
+						if (stream)
+						{
+							uint8_t buffer[c_blobSize];
+							if (stream->read(buffer, c_blobSize) != c_blobSize)
+								failed++;
+							stream->close();
+						}
+						else
+							failed++;
+					}
+				}
+				latencies[i].push_back(timer.getElapsedTime() - start);
+			}
+			client->destroy();
+		}, L"Avalanche load generator");
+		if (!thread)
+			break;
+		thread->start();
+		threads.push_back(thread);
+	}
+
+	for (auto thread : threads)
+	{
+		thread->wait();
+		ThreadManager::getInstance().destroy(thread);
+	}
+
+	const double elapsed = timer.getElapsedTime();
+
+	AlignedVector< double > all;
+	for (int32_t i = 0; i < c_clientCount; ++i)
+		all.insert(all.end(), latencies[i].begin(), latencies[i].end());
+	std::sort(all.begin(), all.end());
+
+	Result result;
+	result.throughput = elapsed > 0.0 ? (c_clientCount * c_requestCount * c_batchSize) / elapsed : 0.0;
+	result.p99 = !all.empty() ? all[(all.size() * 99) / 100] : 0.0;
+	result.failed = failed;
+	return result;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.avalanche.test.CaseLoadGenerator", 0, CaseLoadGenerator, traktor::test::Case)
+
+void CaseLoadGenerator::run()
+{
+	for (int32_t mode = 0; mode < 2; ++mode)
+	{
+		const bool multiplexed = (mode != 0);
+		const int32_t port = 20011 + mode;
+
+		Ref< PropertyGroup > settings = new PropertyGroup();
+		settings->setProperty< PropertyInteger >(L"Avalanche.Port", port);
+		settings->setProperty< PropertyBoolean >(L"Avalanche.Multiplexed", multiplexed);
+
+		Ref< Server > server = new Server();
+		if (!server->create(settings))
+		{
+			CASE_ASSERT(false);
+			return;
+		}
+
+		Thread* serverThread = ThreadManager::getInstance().create([&](){
+			while (!serverThread->stopped())
+				server->update();
+		});
+		CASE_ASSERT(serverThread != nullptr);
+		if (serverThread == nullptr)
+			return;
+
+		serverThread->start();
+
+		const net::SocketAddressIPv4 address(L"localhost", port);
+
+		// Populate server using a single batched put.
+		{
+			Ref< Client > client = new Client(address);
+
+			uint8_t blob[c_blobSize];
+			for (int32_t i = 0; i < c_blobSize; ++i)
+				blob[i] = (uint8_t)i;
+
+			AlignedVector< Key > keys;
+			RefArray< IStream > streams;
+			for (int32_t i = 0; i < c_blobCount; ++i)
+			{
+				keys.push_back(blobKey(i));
+				streams.push_back(new MemoryStream(blob, c_blobSize, true, false));
+			}
+
+			AlignedVector< bool > committed;
+			CASE_ASSERT(client->put(keys, streams, committed));
+			CASE_ASSERT(std::count(committed.begin(), committed.end(), true) == c_blobCount);
+
+			AlignedVector< bool > have;
+			CASE_ASSERT(client->have(keys, have));
+			CASE_ASSERT(std::count(have.begin(), have.end(), true) == c_blobCount);
+
+			client->destroy();
+		}
+
+		for (int32_t batched = 0; batched < 2; ++batched)
+		{
+			const Result result = generateLoad(address, batched != 0);
+			CASE_ASSERT_EQUAL(result.failed, 0);
+
+			log::info << L"Avalanche load, " << (multiplexed ? L"multiplexed" : L"thread per connection") << L", " << (batched ? L"batched" : L"single") << L" GET; " << int32_t(result.throughput) << L" blobs/s, p99 " << int32_t(result.p99 * 1000000.0) << L" us" << Endl;
+		}
+
+		serverThread->stop();
+		ThreadManager::getInstance().destroy(serverThread);
+
+		server->destroy();
+		server = nullptr;
+	}
+}
+
+}
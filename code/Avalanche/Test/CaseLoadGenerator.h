@@ -0,0 +1,33 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Test/Case.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_AVALANCHE_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::avalanche::test
+{
+
+class T_DLLCLASS CaseLoadGenerator : public traktor::test::Case
+{
+	T_RTTI_CLASS;
+
+public:
+	virtual void run() override final;
+};
+
+}
+
@@ -29,7 +29,7 @@ T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.avalanche.test.CaseServer", 0, CaseServ
 void CaseServer::run()
 {
 	Ref< PropertyGroup > settings = new PropertyGroup();
-	settings->setProperty< PropertyInteger >(L"Avalanche.ListenPort", 20001);
+	settings->setProperty< PropertyInteger >(L"Avalanche.Port", 20001);
 
 	Ref< Server > server = new Server();
 	server->create(settings);
@@ -0,0 +1,73 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Config.h"
+
+namespace traktor::compress
+{
+
+/*! Archive file layout.
+ * \ingroup Compress
+ *
+ * [Entry data; stored entries of at least a page are page aligned]
+ * [ArchiveEntry * entryCount]
+ * [uint32_t * tableSize; hash table of entry indices]
+ * [UTF-8 path names]
+ * [ArchiveTrailer]
+ *
+ * Trailer is last so archive can be written sequentially.
+ *
+ * Entry 0 is the root directory. Children of a directory are
+ * stored consecutively, sorted by name, thus listing a directory
+ * doesn't require any searching.
+ */
+
+const uint32_t c_archiveMagic = 0x43524154;	// "TARC"
+const uint32_t c_archiveVersion = 1;
+const uint64_t c_archivePageSize = 4096;
+const uint32_t c_archiveInvalidEntry = ~0U;
+
+enum ArchiveEntryFlags
+{
+	AefDirectory = 1,
+	AefExecutable = 2
+};
+
+#pragma pack(1)
+
+struct ArchiveTrailer
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entryCount;
+	uint32_t tableSize;
+	uint64_t entriesOffset;
+	uint64_t tableOffset;
+	uint64_t namesOffset;
+	uint64_t namesSize;
+};
+
+struct ArchiveEntry
+{
+	uint32_t hash;
+	uint32_t nameOffset;
+	uint32_t nameLength;
+	uint16_t compression;
+	uint16_t flags;
+	uint32_t firstChild;
+	uint32_t childCount;
+	uint64_t offset;
+	uint64_t compressedSize;
+	uint64_t size;
+};
+
+#pragma pack()
+
+}
@@ -0,0 +1,357 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include "Compress/Archive/ArchiveFormat.h"
+#include "Compress/Archive/ArchiveVolume.h"
+#include "Compress/Archive/ArchiveWriter.h"
+#include "Compress/Lzf/InflateStreamLzf.h"
+#include "Compress/Zip/InflateStreamZip.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Io/File.h"
+#include "Core/Io/IMappedFile.h"
+#include "Core/Io/MemoryStream.h"
+#include "Core/Io/StreamStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Misc/String.h"
+#include "Core/Misc/TString.h"
+#include "Core/Misc/WildCompare.h"
+
+namespace traktor::compress
+{
+	namespace
+	{
+
+/*! Read only stream of an entry, keeps archive mapped while open. */
+class ArchiveEntryStream : public MemoryStream
+{
+public:
+	explicit ArchiveEntryStream(IMappedFile* archiveFile, const uint8_t* ptr, int64_t size)
+	:	MemoryStream(ptr, size)
+	,	m_archiveFile(archiveFile)
+	{
+	}
+
+	virtual void close() override final
+	{
+		MemoryStream::close();
+		m_archiveFile = nullptr;
+	}
+
+private:
+	Ref< IMappedFile > m_archiveFile;
+};
+
+/*! Mapped view of a stored entry. */
+class ArchiveMappedFile : public IMappedFile
+{
+public:
+	explicit ArchiveMappedFile(IMappedFile* archiveFile, const uint8_t* ptr, int64_t size)
+	:	m_archiveFile(archiveFile)
+	,	m_ptr(ptr)
+	,	m_size(size)
+	{
+	}
+
+	virtual void* getBase() const override final { return (void*)m_ptr; }
+
+	virtual int64_t getSize() const override final { return m_size; }
+
+private:
+	Ref< IMappedFile > m_archiveFile;
+	const uint8_t* m_ptr;
+	int64_t m_size;
+};
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.compress.ArchiveVolume", ArchiveVolume, IVolume)
+
+ArchiveVolume::ArchiveVolume(IMappedFile* archiveFile)
+:	m_archiveFile(archiveFile)
+{
+	const uint8_t* base = (const uint8_t*)m_archiveFile->getBase();
+	const uint64_t size = (uint64_t)m_archiveFile->getSize();
+
+	if (size < sizeof(ArchiveTrailer))
+	{
+		log::error << L"Corrupt archive; no data." << Endl;
+		return;
+	}
+
+	const ArchiveTrailer* trailer = (const ArchiveTrailer*)(base + size - sizeof(ArchiveTrailer));
+	if (trailer->magic != c_archiveMagic || trailer->version != c_archiveVersion)
+	{
+		log::error << L"Corrupt archive; incorrect signature or version." << Endl;
+		return;
+	}
+
+	if (
+		trailer->entryCount == 0 ||
+		trailer->tableSize == 0 ||
+		(trailer->tableSize & (trailer->tableSize - 1)) != 0 ||
+		trailer->tableSize < trailer->entryCount ||
+		trailer->entriesOffset + trailer->entryCount * sizeof(ArchiveEntry) > trailer->tableOffset ||
+		trailer->tableOffset + trailer->tableSize * sizeof(uint32_t) > trailer->namesOffset ||
+		trailer->namesOffset + trailer->namesSize > size - sizeof(ArchiveTrailer)
+	)
+	{
+		log::error << L"Corrupt archive; invalid directory." << Endl;
+		return;
+	}
+
+	const ArchiveEntry* entries = (const ArchiveEntry*)(base + trailer->entriesOffset);
+	for (uint32_t i = 0; i < trailer->entryCount; ++i)
+	{
+		const ArchiveEntry& entry = entries[i];
+		if (
+			entry.nameOffset + (uint64_t)entry.nameLength > trailer->namesSize ||
+			entry.firstChild + (uint64_t)entry.childCount > trailer->entryCount ||
+			entry.offset + entry.compressedSize > size
+		)
+		{
+			log::error << L"Corrupt archive; invalid entry " << i << L"." << Endl;
+			return;
+		}
+	}
+
+	m_base = base;
+	m_trailer = trailer;
+	m_entries = entries;
+	m_table = (const uint32_t*)(base + trailer->tableOffset);
+	m_names = (const char*)(base + trailer->namesOffset);
+}
+
+std::wstring ArchiveVolume::getDescription() const
+{
+	return L"archive";
+}
+
+Ref< File > ArchiveVolume::get(const Path& path)
+{
+	const ArchiveEntry* entry = findEntry(path);
+	if (!entry)
+		return nullptr;
+
+	if ((entry->flags & AefDirectory) == 0)
+	{
+		return new File(
+			L"archive:" + getPathName(*entry),
+			entry->size,
+			File::FfNormal | File::FfReadOnly | ((entry->flags & AefExecutable) != 0 ? File::FfExecutable : 0)
+		);
+	}
+	else
+	{
+		return new File(
+			L"archive:" + getPathName(*entry),
+			0,
+			File::FfDirectory | File::FfReadOnly
+		);
+	}
+}
+
+RefArray< File > ArchiveVolume::find(const Path& mask)
+{
+	const ArchiveEntry* directory = findEntry(mask.getPathOnlyNoVolume());
+	if (!directory || (directory->flags & AefDirectory) == 0)
+		return RefArray< File >();
+
+	std::wstring fileMask = mask.getFileName();
+	if (fileMask == L"*.*")
+		fileMask = L"*";
+
+	RefArray< File > files;
+
+	WildCompare maskCompare(fileMask);
+	for (uint32_t i = 0; i < directory->childCount; ++i)
+	{
+		const ArchiveEntry& entry = m_entries[directory->firstChild + i];
+		const std::wstring pathName = getPathName(entry);
+		const size_t separator = pathName.find_last_of(L'/');
+		const std::wstring name = (separator != pathName.npos) ? pathName.substr(separator + 1) : pathName;
+
+		if (!maskCompare.match(name))
+			continue;
+
+		if ((entry.flags & AefDirectory) == 0)
+		{
+			files.push_back(new File(
+				L"archive:" + pathName,
+				entry.size,
+				File::FfNormal | File::FfReadOnly | ((entry.flags & AefExecutable) != 0 ? File::FfExecutable : 0)
+			));
+		}
+		else
+		{
+			files.push_back(new File(
+				L"archive:" + pathName,
+				0,
+				File::FfDirectory | File::FfReadOnly
+			));
+		}
+	}
+
+	return files;
+}
+
+bool ArchiveVolume::modify(const Path& fileName, uint32_t flags)
+{
+	return false;
+}
+
+bool ArchiveVolume::modify(const Path& fileName, const DateTime* creationTime, const DateTime* lastAccessTime, const DateTime* lastWriteTime)
+{
+	return false;
+}
+
+Ref< IStream > ArchiveVolume::open(const Path& fileName, uint32_t mode)
+{
+	if ((mode & (File::FmWrite | File::FmAppend)) != 0)
+		return nullptr;
+
+	const ArchiveEntry* entry = findEntry(fileName);
+	if (!entry || (entry->flags & AefDirectory) != 0)
+		return nullptr;
+
+	Ref< IStream > stream = new ArchiveEntryStream(m_archiveFile, m_base + entry->offset, entry->compressedSize);
+	switch (entry->compression)
+	{
+	case ArchiveWriter::CmStored:
+		return stream;
+
+	case ArchiveWriter::CmLzf:
+		return new StreamStream(new InflateStreamLzf(stream), entry->size);
+
+	case ArchiveWriter::CmZip:
+		return new StreamStream(new InflateStreamZip(stream), entry->size);
+
+	default:
+		log::error << L"Unable to open \"" << fileName.getPathName() << L"\"; unknown compression." << Endl;
+		return nullptr;
+	}
+}
+
+Ref< IMappedFile > ArchiveVolume::map(const Path& fileName)
+{
+	const ArchiveEntry* entry = findEntry(fileName);
+	if (!entry || (entry->flags & AefDirectory) != 0 || entry->compression != ArchiveWriter::CmStored)
+		return nullptr;
+
+	return new ArchiveMappedFile(m_archiveFile, m_base + entry->offset, entry->size);
+}
+
+bool ArchiveVolume::exist(const Path& fileName)
+{
+	return findEntry(fileName) != nullptr;
+}
+
+bool ArchiveVolume::remove(const Path& fileName)
+{
+	return false;
+}
+
+bool ArchiveVolume::move(const Path& fileName, const std::wstring& newName, bool overwrite)
+{
+	return false;
+}
+
+bool ArchiveVolume::copy(const Path& fileName, const std::wstring& newName, bool overwrite)
+{
+	return false;
+}
+
+bool ArchiveVolume::makeDirectory(const Path& directory)
+{
+	return false;
+}
+
+bool ArchiveVolume::removeDirectory(const Path& directory)
+{
+	return false;
+}
+
+bool ArchiveVolume::renameDirectory(const Path& directory, const std::wstring& newName)
+{
+	return false;
+}
+
+bool ArchiveVolume::setCurrentDirectory(const Path& directory)
+{
+	if (directory.isRelative())
+		m_currentDirectory = m_currentDirectory + directory;
+	else
+		m_currentDirectory = directory;
+	return true;
+}
+
+Path ArchiveVolume::getCurrentDirectory() const
+{
+	return m_currentDirectory;
+}
+
+std::string ArchiveVolume::getSystemPath(const Path& path) const
+{
+	std::wstring txt;
+	if (path.isRelative())
+	{
+		txt = m_currentDirectory.getPathNameNoVolume();
+		if (!txt.empty())
+			txt += L'/';
+		txt += path.getPathNameNoVolume();
+	}
+	else
+		txt = path.getPathNameNoVolume();
+
+	std::string sp = wstombs(txt);
+
+	// Archive paths have no leading nor trailing separators.
+	size_t start = 0;
+	while (start < sp.size() && sp[start] == '/')
+		++start;
+	size_t end = sp.size();
+	while (end > start && sp[end - 1] == '/')
+		--end;
+
+	return sp.substr(start, end - start);
+}
+
+std::wstring ArchiveVolume::getPathName(const ArchiveEntry& entry) const
+{
+	return mbstows(std::string_view(m_names + entry.nameOffset, entry.nameLength));
+}
+
+const ArchiveEntry* ArchiveVolume::findEntry(const Path& path) const
+{
+	if (!m_trailer)
+		return nullptr;
+
+	const std::string sp = getSystemPath(path);
+	const uint32_t hash = hashMapBytes(sp.data(), sp.size());
+	const uint32_t mask = m_trailer->tableSize - 1;
+
+	uint32_t slot = hash & mask;
+	for (uint32_t i = 0; i < m_trailer->tableSize; ++i, slot = (slot + 1) & mask)
+	{
+		const uint32_t index = m_table[slot];
+		if (index >= m_trailer->entryCount)
+			break;
+
+		const ArchiveEntry& entry = m_entries[index];
+		if (
+			entry.hash == hash &&
+			entry.nameLength == sp.size() &&
+			std::memcmp(m_names + entry.nameOffset, sp.data(), sp.size()) == 0
+		)
+			return &entry;
+	}
+
+	return nullptr;
+}
+
+}
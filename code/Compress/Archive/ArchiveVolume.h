@@ -0,0 +1,99 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Ref.h"
+#include "Core/Io/IVolume.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_COMPRESS_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor
+{
+
+class IMappedFile;
+
+}
+
+namespace traktor::compress
+{
+
+struct ArchiveEntry;
+struct ArchiveTrailer;
+
+/*! Read only volume of an archive created by ArchiveWriter.
+ * \ingroup Compress
+ *
+ * Directory is read directly from the mapped archive, files are
+ * found through the archive's precomputed hash table. Each opened
+ * stream reads from the mapping independently thus multiple threads
+ * can read from the volume concurrently without locking.
+ * Stored files are read, or mapped, without copying.
+ */
+class T_DLLCLASS ArchiveVolume : public IVolume
+{
+	T_RTTI_CLASS;
+
+public:
+	explicit ArchiveVolume(IMappedFile* archiveFile);
+
+	virtual std::wstring getDescription() const override final;
+
+	virtual Ref< File > get(const Path& path) override final;
+
+	virtual RefArray< File > find(const Path& mask) override final;
+
+	virtual bool modify(const Path& fileName, uint32_t flags) override final;
+
+	virtual bool modify(const Path& fileName, const DateTime* creationTime, const DateTime* lastAccessTime, const DateTime* lastWriteTime) override final;
+
+	virtual Ref< IStream > open(const Path& fileName, uint32_t mode) override final;
+
+	virtual Ref< IMappedFile > map(const Path& fileName) override final;
+
+	virtual bool exist(const Path& fileName) override final;
+
+	virtual bool remove(const Path& fileName) override final;
+
+	virtual bool move(const Path& fileName, const std::wstring& newName, bool overwrite) override final;
+
+	virtual bool copy(const Path& fileName, const std::wstring& newName, bool overwrite) override final;
+
+	virtual bool makeDirectory(const Path& directory) override final;
+
+	virtual bool removeDirectory(const Path& directory) override final;
+
+	virtual bool renameDirectory(const Path& directory, const std::wstring& newName) override final;
+
+	virtual bool setCurrentDirectory(const Path& directory) override final;
+
+	virtual Path getCurrentDirectory() const override final;
+
+private:
+	Ref< IMappedFile > m_archiveFile;
+	const uint8_t* m_base = nullptr;
+	const ArchiveTrailer* m_trailer = nullptr;
+	const ArchiveEntry* m_entries = nullptr;
+	const uint32_t* m_table = nullptr;
+	const char* m_names = nullptr;
+	Path m_currentDirectory;
+
+	std::string getSystemPath(const Path& path) const;
+
+	std::wstring getPathName(const ArchiveEntry& entry) const;
+
+	const ArchiveEntry* findEntry(const Path& path) const;
+};
+
+}
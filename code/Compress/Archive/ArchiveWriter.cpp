@@ -0,0 +1,317 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include <map>
+#include "Compress/Archive/ArchiveFormat.h"
+#include "Compress/Archive/ArchiveWriter.h"
+#include "Compress/Lzf/DeflateStreamLzf.h"
+#include "Compress/Zip/DeflateStreamZip.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Io/IStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Misc/Align.h"
+#include "Core/Misc/TString.h"
+
+namespace traktor::compress
+{
+	namespace
+	{
+
+struct Node
+{
+	std::string path;
+	int32_t entry = -1;
+	std::map< std::string, int32_t > children;
+};
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.compress.ArchiveWriter", ArchiveWriter, Object)
+
+ArchiveWriter::ArchiveWriter(IStream* stream)
+:	m_stream(stream)
+,	m_position(0)
+{
+}
+
+bool ArchiveWriter::add(const std::wstring& fileName, IStream* source, Compression compression, bool executable)
+{
+	// Read entire source.
+	AlignedVector< uint8_t > data;
+	for (;;)
+	{
+		const size_t offset = data.size();
+		data.resize(offset + 64 * 1024);
+
+		const int64_t nread = source->read(data.ptr() + offset, 64 * 1024);
+		if (nread < 0)
+		{
+			log::error << L"Unable to add \"" << fileName << L"\" to archive; failed to read source." << Endl;
+			return false;
+		}
+
+		data.resize(offset + (size_t)nread);
+		if (nread == 0)
+			break;
+	}
+
+	// Compress data; only keep compressed data if it saves at least an eighth.
+	AlignedVector< uint8_t > compressed;
+	Compression usedCompression = CmStored;
+
+	if (compression != CmStored && !data.empty())
+	{
+		DynamicMemoryStream compressedStream(compressed, false, true);
+
+		Ref< IStream > deflateStream;
+		if (compression == CmLzf)
+			deflateStream = new DeflateStreamLzf(&compressedStream);
+		else
+			deflateStream = new DeflateStreamZip(&compressedStream);
+
+		if (deflateStream->write(data.c_ptr(), (int64_t)data.size()) != (int64_t)data.size())
+		{
+			log::error << L"Unable to add \"" << fileName << L"\" to archive; failed to compress data." << Endl;
+			return false;
+		}
+
+		deflateStream->close();
+		deflateStream = nullptr;
+
+		if (compressed.size() < data.size() - data.size() / 8)
+			usedCompression = compression;
+	}
+
+	const AlignedVector< uint8_t >& payload = (usedCompression != CmStored) ? compressed : data;
+
+	// Stored entries are page aligned so they can be mapped directly, small entries
+	// are not worth wasting a page.
+	const bool pageAligned = (usedCompression == CmStored && payload.size() >= c_archivePageSize);
+	if (!pad(pageAligned ? c_archivePageSize : 16))
+		return false;
+
+	Entry& entry = m_entries.push_back();
+	entry.name = wstombs(fileName);
+	entry.compression = (uint16_t)usedCompression;
+	entry.flags = executable ? AefExecutable : 0;
+	entry.offset = m_position;
+	entry.compressedSize = payload.size();
+	entry.size = data.size();
+
+	// Normalize name into "directory/file".
+	for (auto& ch : entry.name)
+	{
+		if (ch == '\\')
+			ch = '/';
+	}
+	while (!entry.name.empty() && entry.name.front() == '/')
+		entry.name.erase(0, 1);
+
+	if (!write(payload.c_ptr(), payload.size()))
+	{
+		log::error << L"Unable to add \"" << fileName << L"\" to archive; failed to write data." << Endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool ArchiveWriter::addDirectory(const Path& directory, Compression compression)
+{
+	return addDirectoryRecursive(directory, L"", compression);
+}
+
+bool ArchiveWriter::commit()
+{
+	// Build directory tree from entry names.
+	AlignedVector< Node > nodes;
+	nodes.push_back();
+
+	for (int32_t i = 0; i < (int32_t)m_entries.size(); ++i)
+	{
+		const std::string& name = m_entries[i].name;
+
+		int32_t current = 0;
+		size_t start = 0;
+		for (;;)
+		{
+			const size_t end = name.find('/', start);
+			const std::string part = name.substr(start, end != std::string::npos ? end - start : std::string::npos);
+
+			auto it = nodes[current].children.find(part);
+			int32_t child;
+			if (it == nodes[current].children.end())
+			{
+				child = (int32_t)nodes.size();
+				nodes[current].children[part] = child;
+
+				Node& node = nodes.push_back();
+				node.path = name.substr(0, end);
+			}
+			else
+				child = it->second;
+
+			if (end == std::string::npos)
+			{
+				if (!nodes[child].children.empty())
+				{
+					log::error << L"Unable to commit archive; \"" << mbstows(name) << L"\" is both a file and a directory." << Endl;
+					return false;
+				}
+				if (nodes[child].entry >= 0)
+					log::warning << L"Duplicate file \"" << mbstows(name) << L"\" in archive; last added is used." << Endl;
+				nodes[child].entry = i;
+				break;
+			}
+
+			if (nodes[child].entry >= 0)
+			{
+				log::error << L"Unable to commit archive; \"" << mbstows(nodes[child].path) << L"\" is both a file and a directory." << Endl;
+				return false;
+			}
+
+			current = child;
+			start = end + 1;
+		}
+	}
+
+	// Flatten tree breadth first so children of each directory are consecutive.
+	AlignedVector< int32_t > order;
+	order.push_back(0);
+
+	AlignedVector< ArchiveEntry > entries;
+	std::string names;
+
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		const Node& node = nodes[order[i]];
+
+		ArchiveEntry& ae = entries.push_back();
+		std::memset(&ae, 0, sizeof(ae));
+		ae.hash = hashMapBytes(node.path.data(), node.path.size());
+		ae.nameOffset = (uint32_t)names.size();
+		ae.nameLength = (uint32_t)node.path.size();
+
+		if (node.entry >= 0)
+		{
+			const Entry& entry = m_entries[node.entry];
+			ae.compression = entry.compression;
+			ae.flags = entry.flags;
+			ae.offset = entry.offset;
+			ae.compressedSize = entry.compressedSize;
+			ae.size = entry.size;
+		}
+		else
+		{
+			ae.flags = AefDirectory;
+			ae.firstChild = (uint32_t)order.size();
+			ae.childCount = (uint32_t)node.children.size();
+			for (const auto& child : node.children)
+				order.push_back(child.second);
+		}
+
+		names += node.path;
+	}
+
+	// Build hash table of entries, keep load factor at most one half.
+	uint32_t tableSize = 16;
+	while (tableSize < entries.size() * 2)
+		tableSize <<= 1;
+
+	AlignedVector< uint32_t > table((size_t)tableSize, c_archiveInvalidEntry);
+	for (uint32_t i = 0; i < (uint32_t)entries.size(); ++i)
+	{
+		uint32_t slot = entries[i].hash & (tableSize - 1);
+		while (table[slot] != c_archiveInvalidEntry)
+			slot = (slot + 1) & (tableSize - 1);
+		table[slot] = i;
+	}
+
+	// Write directory.
+	if (!pad(16))
+		return false;
+
+	ArchiveTrailer trailer;
+	trailer.magic = c_archiveMagic;
+	trailer.version = c_archiveVersion;
+	trailer.entryCount = (uint32_t)entries.size();
+	trailer.tableSize = tableSize;
+	trailer.entriesOffset = m_position;
+	trailer.tableOffset = trailer.entriesOffset + entries.size() * sizeof(ArchiveEntry);
+	trailer.namesOffset = trailer.tableOffset + table.size() * sizeof(uint32_t);
+	trailer.namesSize = names.size();
+
+	if (
+		!write(entries.c_ptr(), entries.size() * sizeof(ArchiveEntry)) ||
+		!write(table.c_ptr(), table.size() * sizeof(uint32_t)) ||
+		!write(names.data(), names.size()) ||
+		!write(&trailer, sizeof(trailer))
+	)
+	{
+		log::error << L"Unable to commit archive; failed to write directory." << Endl;
+		return false;
+	}
+
+	m_stream->flush();
+
+	m_entries.clear();
+	return true;
+}
+
+bool ArchiveWriter::write(const void* data, uint64_t size)
+{
+	if (size > 0 && m_stream->write(data, (int64_t)size) != (int64_t)size)
+		return false;
+	m_position += size;
+	return true;
+}
+
+bool ArchiveWriter::pad(uint64_t alignment)
+{
+	static const uint8_t c_zero[c_archivePageSize] = { 0 };
+	return write(c_zero, alignUp(m_position, alignment) - m_position);
+}
+
+bool ArchiveWriter::addDirectoryRecursive(const Path& directory, const std::wstring& prefix, Compression compression)
+{
+	RefArray< File > files = FileSystem::getInstance().find(directory.getPathName() + L"/*.*");
+	for (auto file : files)
+	{
+		const Path& path = file->getPath();
+		const std::wstring fileName = path.getFileName();
+
+		if (file->isDirectory())
+		{
+			if (fileName == L"." || fileName == L"..")
+				continue;
+			if (!addDirectoryRecursive(path, prefix + fileName + L"/", compression))
+				return false;
+		}
+		else
+		{
+			Ref< IStream > source = FileSystem::getInstance().open(path, File::FmRead);
+			if (!source)
+			{
+				log::error << L"Unable to add \"" << path.getPathName() << L"\" to archive; failed to open file." << Endl;
+				return false;
+			}
+
+			const bool result = add(prefix + fileName, source, compression, file->isExecutable());
+			source->close();
+
+			if (!result)
+				return false;
+		}
+	}
+	return true;
+}
+
+}
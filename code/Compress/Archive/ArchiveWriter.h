@@ -0,0 +1,108 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <string>
+#include "Core/Object.h"
+#include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_COMPRESS_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor
+{
+
+class IStream;
+class Path;
+
+}
+
+namespace traktor::compress
+{
+
+/*! Archive writer.
+ * \ingroup Compress
+ *
+ * Create an archive readable by ArchiveVolume.
+ * Each entry is compressed individually; if compression
+ * doesn't pay off the entry is stored uncompressed,
+ * page aligned, so it can be memory mapped directly
+ * from the archive.
+ */
+class T_DLLCLASS ArchiveWriter : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	enum Compression
+	{
+		CmStored = 0,
+		CmLzf = 1,
+		CmZip = 2
+	};
+
+	/*! Create writer.
+	 *
+	 * \param stream Output stream.
+	 */
+	explicit ArchiveWriter(IStream* stream);
+
+	/*! Add file to archive.
+	 *
+	 * \param fileName Path of file in archive.
+	 * \param source Stream with file content.
+	 * \param compression Preferred compression.
+	 * \param executable Mark file as executable.
+	 * \return True if file was added.
+	 */
+	bool add(const std::wstring& fileName, IStream* source, Compression compression, bool executable = false);
+
+	/*! Recursively add all files in a directory.
+	 *
+	 * \param directory Directory in file system.
+	 * \param compression Preferred compression.
+	 * \return True if all files was added.
+	 */
+	bool addDirectory(const Path& directory, Compression compression);
+
+	/*! Write directory, archive is complete after commit.
+	 *
+	 * \return True if archive was successfully written.
+	 */
+	bool commit();
+
+private:
+	struct Entry
+	{
+		std::string name;
+		uint16_t compression;
+		uint16_t flags;
+		uint64_t offset;
+		uint64_t compressedSize;
+		uint64_t size;
+	};
+
+	Ref< IStream > m_stream;
+	AlignedVector< Entry > m_entries;
+	uint64_t m_position;
+
+	bool write(const void* data, uint64_t size);
+
+	bool pad(uint64_t alignment);
+
+	bool addDirectoryRecursive(const Path& directory, const std::wstring& prefix, Compression compression);
+};
+
+}
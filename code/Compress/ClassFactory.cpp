@@ -7,14 +7,38 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include "Compress/ClassFactory.h"
+#include "Compress/Archive/ArchiveVolume.h"
+#include "Compress/Archive/ArchiveWriter.h"
 #include "Compress/Zip/ZipVolume.h"
 #include "Core/Class/AutoRuntimeClass.h"
 #include "Core/Class/IRuntimeClassRegistrar.h"
 #include "Core/Class/IRuntimeDelegate.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Io/IMappedFile.h"
 #include "Core/Io/IStream.h"
 
 namespace traktor::compress
 {
+	namespace
+	{
+
+Ref< ArchiveVolume > ArchiveVolume_constructor(const Path& archiveFile)
+{
+	Ref< IMappedFile > mappedFile = FileSystem::getInstance().map(archiveFile);
+	return mappedFile ? new ArchiveVolume(mappedFile) : nullptr;
+}
+
+bool ArchiveWriter_add(ArchiveWriter* self, const std::wstring& fileName, IStream* source, int32_t compression)
+{
+	return self->add(fileName, source, (ArchiveWriter::Compression)compression);
+}
+
+bool ArchiveWriter_addDirectory(ArchiveWriter* self, const Path& directory, int32_t compression)
+{
+	return self->addDirectory(directory, (ArchiveWriter::Compression)compression);
+}
+
+	}
 
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.compress.ClassFactory", 0, ClassFactory, IRuntimeClassFactory)
 
@@ -23,6 +47,20 @@ void ClassFactory::createClasses(IRuntimeClassRegistrar* registrar) const
 	auto classZipVolume = new AutoRuntimeClass< ZipVolume >();
 	classZipVolume->addConstructor< IStream* >();
 	registrar->registerClass(classZipVolume);
+
+	auto classArchiveVolume = new AutoRuntimeClass< ArchiveVolume >();
+	classArchiveVolume->addConstructor< const Path& >(&ArchiveVolume_constructor);
+	registrar->registerClass(classArchiveVolume);
+
+	auto classArchiveWriter = new AutoRuntimeClass< ArchiveWriter >();
+	classArchiveWriter->addConstant("CmStored", Any::fromInt32(ArchiveWriter::CmStored));
+	classArchiveWriter->addConstant("CmLzf", Any::fromInt32(ArchiveWriter::CmLzf));
+	classArchiveWriter->addConstant("CmZip", Any::fromInt32(ArchiveWriter::CmZip));
+	classArchiveWriter->addConstructor< IStream* >();
+	classArchiveWriter->addMethod("add", &ArchiveWriter_add);
+	classArchiveWriter->addMethod("addDirectory", &ArchiveWriter_addDirectory);
+	classArchiveWriter->addMethod("commit", &ArchiveWriter::commit);
+	registrar->registerClass(classArchiveWriter);
 }
 
 }
@@ -0,0 +1,194 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include "Compress/Archive/ArchiveFormat.h"
+#include "Compress/Archive/ArchiveVolume.h"
+#include "Compress/Archive/ArchiveWriter.h"
+#include "Compress/Test/CaseArchive.h"
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Io/File.h"
+#include "Core/Io/IMappedFile.h"
+#include "Core/Io/MemoryStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Misc/String.h"
+#include "Core/Timer/Timer.h"
+
+namespace traktor::compress::test
+{
+	namespace
+	{
+
+const int32_t c_lookupFileCount = 20000;
+
+class MemoryMappedFile : public IMappedFile
+{
+public:
+	explicit MemoryMappedFile(const AlignedVector< uint8_t >& buffer)
+	:	m_buffer(buffer)
+	{
+	}
+
+	virtual void* getBase() const override final { return (void*)m_buffer.c_ptr(); }
+
+	virtual int64_t getSize() const override final { return (int64_t)m_buffer.size(); }
+
+private:
+	AlignedVector< uint8_t > m_buffer;
+};
+
+bool readAll(IStream* stream, AlignedVector< uint8_t >& outData)
+{
+	outData.resize(0);
+	for (;;)
+	{
+		uint8_t buf[1000];
+		const int64_t nread = stream->read(buf, sizeof(buf));
+		if (nread < 0)
+			return false;
+		if (nread == 0)
+			break;
+		outData.insert(outData.end(), buf, buf + nread);
+	}
+	return true;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.compress.test.CaseArchive", 0, CaseArchive, traktor::test::Case)
+
+void CaseArchive::run()
+{
+	AlignedVector< uint8_t > text(100000);
+	for (size_t i = 0; i < text.size(); ++i)
+		text[i] = uint8_t('a' + (i / 7) % 13);
+
+	AlignedVector< uint8_t > noise(50000);
+	for (size_t i = 0; i < noise.size(); ++i)
+		noise[i] = uint8_t(std::rand());
+
+	// Create archive in memory.
+	DynamicMemoryStream archiveStream(false, true);
+	{
+		ArchiveWriter writer(&archiveStream);
+
+		MemoryStream s0(text.c_ptr(), 100);
+		CASE_ASSERT(writer.add(L"root.txt", &s0, ArchiveWriter::CmStored));
+
+		MemoryStream s1(text.c_ptr(), text.size());
+		CASE_ASSERT(writer.add(L"data/text.lzf", &s1, ArchiveWriter::CmLzf));
+
+		MemoryStream s2(text.c_ptr(), text.size());
+		CASE_ASSERT(writer.add(L"data/sub/text.zip", &s2, ArchiveWriter::CmZip));
+
+		MemoryStream s3(noise.c_ptr(), noise.size());
+		CASE_ASSERT(writer.add(L"data/noise.bin", &s3, ArchiveWriter::CmLzf));
+
+		MemoryStream s4(text.c_ptr(), 0);
+		CASE_ASSERT(writer.add(L"data/empty.txt", &s4, ArchiveWriter::CmZip));
+
+		CASE_ASSERT(writer.commit());
+	}
+
+	Ref< MemoryMappedFile > mappedFile = new MemoryMappedFile(archiveStream.getBuffer());
+	Ref< ArchiveVolume > volume = new ArchiveVolume(mappedFile);
+
+	// Lookup.
+	CASE_ASSERT(volume->exist(L"/root.txt"));
+	CASE_ASSERT(volume->exist(L"/data/sub/text.zip"));
+	CASE_ASSERT(volume->exist(L"/data/sub"));
+	CASE_ASSERT(!volume->exist(L"/data/missing.txt"));
+	CASE_ASSERT(!volume->exist(L"/data/sub/text"));
+
+	Ref< File > file = volume->get(L"/data/text.lzf");
+	CASE_ASSERT(file != nullptr && file->getSize() == text.size() && !file->isDirectory());
+
+	RefArray< File > files = volume->find(L"/data/*.*");
+	CASE_ASSERT_EQUAL(files.size(), 4);
+
+	files = volume->find(L"/data/*.lzf");
+	CASE_ASSERT_EQUAL(files.size(), 1);
+
+	// Read content.
+	struct { const wchar_t* fileName; const uint8_t* data; size_t size; } expected[] =
+	{
+		{ L"/root.txt", text.c_ptr(), 100 },
+		{ L"/data/text.lzf", text.c_ptr(), text.size() },
+		{ L"/data/sub/text.zip", text.c_ptr(), text.size() },
+		{ L"/data/noise.bin", noise.c_ptr(), noise.size() },
+		{ L"/data/empty.txt", text.c_ptr(), 0 }
+	};
+	for (const auto& e : expected)
+	{
+		Ref< IStream > stream = volume->open(e.fileName, File::FmRead);
+		CASE_ASSERT(stream != nullptr);
+		if (!stream)
+			continue;
+
+		AlignedVector< uint8_t > data;
+		CASE_ASSERT(readAll(stream, data));
+		CASE_ASSERT_EQUAL(data.size(), e.size);
+		CASE_ASSERT(data.size() == e.size && std::memcmp(data.c_ptr(), e.data, e.size) == 0);
+		stream->close();
+	}
+
+	// Writing isn't supported.
+	CASE_ASSERT(volume->open(L"/root.txt", File::FmWrite) == nullptr);
+
+	// Stored entries are page aligned and mappable; compressed are not mappable.
+	Ref< IMappedFile > mapped = volume->map(L"/data/noise.bin");
+	CASE_ASSERT(mapped != nullptr);
+	if (mapped)
+	{
+		const uint8_t* base = (const uint8_t*)mappedFile->getBase();
+		CASE_ASSERT((((const uint8_t*)mapped->getBase() - base) % 4096) == 0);
+		CASE_ASSERT(mapped->getSize() == noise.size());
+		CASE_ASSERT(std::memcmp(mapped->getBase(), noise.c_ptr(), noise.size()) == 0);
+	}
+	CASE_ASSERT(volume->map(L"/data/text.lzf") == nullptr);
+
+	// Corrupt archive must not be accepted.
+	{
+		AlignedVector< uint8_t > corrupt = archiveStream.getBuffer();
+		corrupt[corrupt.size() - sizeof(ArchiveTrailer)] ^= 0xff;
+		Ref< ArchiveVolume > corruptVolume = new ArchiveVolume(new MemoryMappedFile(corrupt));
+		CASE_ASSERT(!corruptVolume->exist(L"/root.txt"));
+	}
+
+	// Measure lookup in a large archive.
+	{
+		DynamicMemoryStream largeStream(false, true);
+		ArchiveWriter writer(&largeStream);
+		for (int32_t i = 0; i < c_lookupFileCount; ++i)
+		{
+			MemoryStream s(text.c_ptr(), 16);
+			writer.add(L"group" + toString(i % 100) + L"/file" + toString(i) + L".dat", &s, ArchiveWriter::CmStored);
+		}
+		CASE_ASSERT(writer.commit());
+
+		Ref< ArchiveVolume > largeVolume = new ArchiveVolume(new MemoryMappedFile(largeStream.getBuffer()));
+
+		Timer timer;
+		const double start = timer.getElapsedTime();
+
+		int32_t found = 0;
+		for (int32_t i = 0; i < c_lookupFileCount; ++i)
+		{
+			Ref< IStream > stream = largeVolume->open(L"/group" + toString(i % 100) + L"/file" + toString(i) + L".dat", File::FmRead);
+			if (stream)
+				++found;
+		}
+
+		const double lookupTime = timer.getElapsedTime() - start;
+		CASE_ASSERT_EQUAL(found, c_lookupFileCount);
+
+		log::info << L"Archive open, " << c_lookupFileCount << L" file(s); " << lookupTime * 1000.0 << L" ms" << Endl;
+	}
+}
+
+}
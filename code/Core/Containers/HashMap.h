@@ -0,0 +1,280 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <string>
+#include <utility>
+#include "Core/Containers/AlignedVector.h"
+
+namespace traktor
+{
+
+/*! FNV-1a hash of raw bytes.
+ * \ingroup Core
+ */
+inline uint32_t hashMapBytes(const void* data, size_t size)
+{
+	const uint8_t* p = static_cast< const uint8_t* >(data);
+	uint64_t h = 0xcbf29ce484222325ULL;
+	for (size_t i = 0; i < size; ++i)
+	{
+		h ^= p[i];
+		h *= 0x100000001b3ULL;
+	}
+	return (uint32_t)(h ^ (h >> 32));
+}
+
+/*! Default hash function of HashMap.
+ * \ingroup Core
+ *
+ * Hash raw bytes of key thus key type must
+ * be trivial and not contain any padding.
+ */
+template < typename Key >
+struct HashMapHash
+{
+	static uint32_t get(const Key& key)
+	{
+		return hashMapBytes(&key, sizeof(Key));
+	}
+};
+
+/*! \ingroup Core */
+template < >
+struct HashMapHash < std::string >
+{
+	static uint32_t get(const std::string& key)
+	{
+		return hashMapBytes(key.data(), key.size() * sizeof(char));
+	}
+};
+
+/*! \ingroup Core */
+template < >
+struct HashMapHash < std::wstring >
+{
+	static uint32_t get(const std::wstring& key)
+	{
+		return hashMapBytes(key.data(), key.size() * sizeof(wchar_t));
+	}
+};
+
+/*! Hash map
+ * \ingroup Core
+ *
+ * Open addressing hash map with linear probing,
+ * intended for large sets of items where SmallMap's
+ * sorted insertion becomes too expensive.
+ * Removal use backward shift deletion thus
+ * no tombstones are left in the table.
+ */
+template < typename Key, typename Item, typename HashFunction = HashMapHash< Key > >
+class HashMap
+{
+public:
+	typedef std::pair< Key, Item > pair_t;
+
+	class const_iterator
+	{
+	public:
+		const pair_t& operator * () const { return m_map->m_slots[m_index]; }
+
+		const pair_t* operator -> () const { return &m_map->m_slots[m_index]; }
+
+		const_iterator& operator ++ ()
+		{
+			m_index = m_map->next(m_index + 1);
+			return *this;
+		}
+
+		bool operator == (const const_iterator& rh) const { return m_index == rh.m_index; }
+
+		bool operator != (const const_iterator& rh) const { return m_index != rh.m_index; }
+
+	private:
+		friend class HashMap;
+
+		const HashMap* m_map;
+		uint32_t m_index;
+
+		explicit const_iterator(const HashMap* map, uint32_t index)
+		:	m_map(map)
+		,	m_index(index)
+		{
+		}
+	};
+
+	void reserve(size_t capacity)
+	{
+		size_t slotCount = 16;
+		while (slotCount * 3 < capacity * 4)
+			slotCount <<= 1;
+		if (slotCount > m_slots.size())
+			rehash(slotCount);
+	}
+
+	void clear()
+	{
+		m_slots.clear();
+		m_used.clear();
+		m_size = 0;
+	}
+
+	size_t size() const
+	{
+		return m_size;
+	}
+
+	bool empty() const
+	{
+		return m_size == 0;
+	}
+
+	Item* find(const Key& key)
+	{
+		const uint32_t index = lookup(key);
+		return index != c_invalid ? &m_slots[index].second : nullptr;
+	}
+
+	const Item* find(const Key& key) const
+	{
+		const uint32_t index = lookup(key);
+		return index != c_invalid ? &m_slots[index].second : nullptr;
+	}
+
+	/*! Insert item, existing item is kept.
+	 *
+	 * \return True if item was inserted.
+	 */
+	bool insert(const Key& key, const Item& item)
+	{
+		bool inserted;
+		const uint32_t index = acquire(key, inserted);
+		if (inserted)
+			m_slots[index].second = item;
+		return inserted;
+	}
+
+	bool remove(const Key& key)
+	{
+		uint32_t hole = lookup(key);
+		if (hole == c_invalid)
+			return false;
+
+		// Shift following entries of the probe sequence back into the hole.
+		const uint32_t mask = (uint32_t)m_slots.size() - 1;
+		for (uint32_t i = (hole + 1) & mask; m_used[i]; i = (i + 1) & mask)
+		{
+			const uint32_t home = HashFunction::get(m_slots[i].first) & mask;
+			if (((i - home) & mask) >= ((i - hole) & mask))
+			{
+				m_slots[hole] = std::move(m_slots[i]);
+				hole = i;
+			}
+		}
+
+		m_slots[hole] = pair_t();
+		m_used[hole] = 0;
+		m_size--;
+		return true;
+	}
+
+	Item& operator [] (const Key& key)
+	{
+		bool inserted;
+		return m_slots[acquire(key, inserted)].second;
+	}
+
+	const_iterator begin() const
+	{
+		return const_iterator(this, next(0));
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator(this, (uint32_t)m_slots.size());
+	}
+
+private:
+	constexpr static uint32_t c_invalid = ~0U;
+
+	AlignedVector< pair_t > m_slots;
+	AlignedVector< uint8_t > m_used;
+	size_t m_size = 0;
+
+	uint32_t next(uint32_t index) const
+	{
+		while (index < (uint32_t)m_slots.size() && !m_used[index])
+			++index;
+		return index;
+	}
+
+	uint32_t lookup(const Key& key) const
+	{
+		if (m_size == 0)
+			return c_invalid;
+
+		const uint32_t mask = (uint32_t)m_slots.size() - 1;
+		for (uint32_t i = HashFunction::get(key) & mask; m_used[i]; i = (i + 1) & mask)
+		{
+			if (m_slots[i].first == key)
+				return i;
+		}
+		return c_invalid;
+	}
+
+	uint32_t acquire(const Key& key, bool& outInserted)
+	{
+		// Keep load factor below 3/4.
+		if ((m_size + 1) * 4 > m_slots.size() * 3)
+			rehash(m_slots.empty() ? 16 : m_slots.size() * 2);
+
+		const uint32_t mask = (uint32_t)m_slots.size() - 1;
+		uint32_t i = HashFunction::get(key) & mask;
+		for (; m_used[i]; i = (i + 1) & mask)
+		{
+			if (m_slots[i].first == key)
+			{
+				outInserted = false;
+				return i;
+			}
+		}
+
+		m_slots[i].first = key;
+		m_used[i] = 1;
+		m_size++;
+
+		outInserted = true;
+		return i;
+	}
+
+	void rehash(size_t slotCount)
+	{
+		AlignedVector< pair_t > slots(slotCount);
+		AlignedVector< uint8_t > used(slotCount, 0);
+		m_slots.swap(slots);
+		m_used.swap(used);
+
+		const uint32_t mask = (uint32_t)slotCount - 1;
+		for (size_t i = 0; i < slots.size(); ++i)
+		{
+			if (!used[i])
+				continue;
+
+			uint32_t j = HashFunction::get(slots[i].first) & mask;
+			while (m_used[j])
+				j = (j + 1) & mask;
+
+			m_slots[j] = std::move(slots[i]);
+			m_used[j] = 1;
+		}
+	}
+};
+
+}
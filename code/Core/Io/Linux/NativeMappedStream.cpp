@@ -0,0 +1,45 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <sys/mman.h>
+#include <unistd.h>
+#include "Core/Io/Linux/NativeMappedStream.h"
+
+namespace traktor
+{
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.NativeMappedStream", NativeMappedStream, MemoryStream)
+
+NativeMappedStream::NativeMappedStream(int fd, void* ptr, int64_t size)
+:	MemoryStream(ptr, size)
+,	m_fd(fd)
+{
+}
+
+NativeMappedStream::~NativeMappedStream()
+{
+	close();
+}
+
+void NativeMappedStream::close()
+{
+	if (m_buffer)
+	{
+		munmap(m_buffer, m_bufferSize);
+		m_buffer = nullptr;
+		m_bufferPtr = nullptr;
+		m_bufferSize = 0;
+	}
+	if (m_fd >= 0)
+	{
+		::close(m_fd);
+		m_fd = -1;
+	}
+}
+
+}
@@ -18,6 +18,7 @@
 #include <utime.h>
 #include "Core/Io/FileSystem.h"
 #include "Core/Io/Linux/NativeMappedFile.h"
+#include "Core/Io/Linux/NativeMappedStream.h"
 #include "Core/Io/Linux/NativeStream.h"
 #include "Core/Io/Linux/NativeVolume.h"
 #include "Core/Log/Log.h"
@@ -191,6 +192,24 @@ Ref< IStream > NativeVolume::open(const Path& fileName, uint32_t mode)
 	if (!m)
 		return nullptr;
 
+	// Try to map file if open for reading only.
+	if (mode == (File::FmRead | File::FmMapped))
+	{
+		const int fd = ::open(wstombs(getSystemPath(fileName)).c_str(), O_RDONLY);
+		if (fd < 0)
+			return nullptr;
+
+		struct stat st = {};
+		if (fstat(fd, &st) == 0 && st.st_size > 0)
+		{
+			void* ptr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (ptr != MAP_FAILED)
+				return new NativeMappedStream(fd, ptr, st.st_size);
+		}
+
+		close(fd);
+	}
+
 	FILE* fp = fopen(
 		wstombs(getSystemPath(fileName)).c_str(),
 		m
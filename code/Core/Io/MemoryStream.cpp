@@ -90,8 +90,8 @@ int64_t MemoryStream::seek(SeekOriginType origin, int64_t offset)
 	}
 	if (m_bufferPtr < m_buffer)
 		m_bufferPtr = m_buffer;
-	else if (m_bufferPtr >= m_buffer + m_bufferSize)
-		m_bufferPtr = m_buffer + m_bufferSize - 1;
+	else if (m_bufferPtr > m_buffer + m_bufferSize)
+		m_bufferPtr = m_buffer + m_bufferSize;
 	return tell();
 }
 
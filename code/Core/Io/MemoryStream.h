@@ -55,6 +55,12 @@ public:
 
 	virtual void flush() override;
 
+	/*! Get pointer to beginning of buffer. */
+	const uint8_t* getBuffer() const { return m_buffer; }
+
+	/*! Get size of buffer in bytes. */
+	int64_t getBufferSize() const { return m_bufferSize; }
+
 protected:
 	uint8_t* m_buffer;
 	uint8_t* m_bufferPtr;
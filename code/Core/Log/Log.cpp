@@ -115,6 +115,7 @@ class LogStreamLocalBuffer : public IOutputStreamBuffer
 public:
 	explicit LogStreamLocalBuffer(int32_t level, const Ref< ILogTarget >& globalTarget)
 	:	m_level(level)
+	,	m_threadId(ThreadManager::getInstance().getCurrentThread()->id())
 	,	m_localTarget(new LogTargetGlobalSink(globalTarget))
 	{
 	}
@@ -161,14 +162,13 @@ public:
 
 	virtual int32_t overflow(const wchar_t* buffer, int32_t count) override final
 	{
-		const uint32_t threadId = m_localTarget ? ThreadManager::getInstance().getCurrentThread()->id() : 0;
 		for (int32_t i = 0; i < count; ++i)
 		{
 			wchar_t c = buffer[i];
 			if (c == L'\n')
 			{
 				if (m_localTarget)
-					m_localTarget->log(threadId, m_level, m_buffer.c_str());
+					m_localTarget->log(m_threadId, m_level, m_buffer.c_str());
 				m_buffer.reset();
 			}
 			else if (c != L'\r')
@@ -179,6 +179,7 @@ public:
 
 private:
 	int32_t m_level;
+	uint32_t m_threadId;	//!< Buffer is thread local so id is resolved once, avoid locking thread manager for each line.
 	StringOutputStreamBuffer m_buffer;
 	Ref< ILogTarget > m_localTarget;
 };
@@ -0,0 +1,370 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#if defined(_WIN32)
+#	include <io.h>
+#else
+#	include <unistd.h>
+#endif
+#include "Core/Io/IStream.h"
+#include "Core/Log/LogAsyncTarget.h"
+#include "Core/Math/Log2.h"
+#include "Core/Memory/Alloc.h"
+#include "Core/Misc/AutoPtr.h"
+#include "Core/Thread/Acquire.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+
+namespace traktor
+{
+	namespace
+	{
+
+const uint16_t c_levelPadding = 0xffff;
+const int32_t c_writeInterval = 20;
+const int32_t c_flushAllTimeout = 500;
+
+/*! Binary record header, followed by UTF-8 text; records are 16 byte aligned in ring. */
+struct Record
+{
+	uint64_t time;
+	uint32_t threadId;
+	uint16_t level;
+	uint16_t length;
+};
+
+static_assert(sizeof(Record) == 16);
+
+uint32_t recordSize(uint32_t length)
+{
+	return (sizeof(Record) + length + 15) & ~15;
+}
+
+/*! Encode string as UTF-8, truncated to max length; only measure if output is null. */
+uint32_t encodeUtf8(const wchar_t* str, uint8_t* out, uint32_t maxLength)
+{
+	uint32_t length = 0;
+	for (const wchar_t* s = str; *s; ++s)
+	{
+		uint32_t ch = uint32_t(*s);
+#if defined(_WIN32)
+		// Combine UTF-16 surrogate pair.
+		if (ch >= 0xd800 && ch <= 0xdbff && uint32_t(s[1]) >= 0xdc00 && uint32_t(s[1]) <= 0xdfff)
+		{
+			ch = 0x10000 + ((ch - 0xd800) << 10) + (uint32_t(s[1]) - 0xdc00);
+			++s;
+		}
+#endif
+		if (ch > 0x10ffff || (ch >= 0xd800 && ch <= 0xdfff))
+			ch = 0xfffd;
+
+		uint8_t e[4];
+		uint32_t n;
+		if (ch < 0x80)
+		{
+			e[0] = uint8_t(ch);
+			n = 1;
+		}
+		else if (ch < 0x800)
+		{
+			e[0] = uint8_t(0xc0 | (ch >> 6));
+			e[1] = uint8_t(0x80 | (ch & 0x3f));
+			n = 2;
+		}
+		else if (ch < 0x10000)
+		{
+			e[0] = uint8_t(0xe0 | (ch >> 12));
+			e[1] = uint8_t(0x80 | ((ch >> 6) & 0x3f));
+			e[2] = uint8_t(0x80 | (ch & 0x3f));
+			n = 3;
+		}
+		else
+		{
+			e[0] = uint8_t(0xf0 | (ch >> 18));
+			e[1] = uint8_t(0x80 | ((ch >> 12) & 0x3f));
+			e[2] = uint8_t(0x80 | ((ch >> 6) & 0x3f));
+			e[3] = uint8_t(0x80 | (ch & 0x3f));
+			n = 4;
+		}
+
+		if (length + n > maxLength)
+			break;
+
+		if (out)
+			std::memcpy(out + length, e, n);
+
+		length += n;
+	}
+	return length;
+}
+
+void writeConsole(const uint8_t* data, size_t size)
+{
+	// Flush anything written through stdio before writing directly to descriptor.
+	fflush(stdout);
+	while (size > 0)
+	{
+#if defined(_WIN32)
+		const int written = _write(1, data, (unsigned int)size);
+#else
+		const ssize_t written = ::write(1, data, size);
+#endif
+		if (written <= 0)
+			break;
+		data += written;
+		size -= written;
+	}
+}
+
+Semaphore s_targetsLock;
+LogAsyncTarget* s_targets = nullptr;
+
+	}
+
+/*! Single producer, single consumer, ring of records. */
+struct LogAsyncTarget::Ring
+{
+	AutoArrayPtr< uint8_t, AllocFreeAlign > data;
+	std::atomic< uint32_t > head = 0;	//!< Written by logging thread.
+	std::atomic< uint32_t > tail = 0;	//!< Written by writer.
+	uint32_t drained = 0;				//!< Head when records was collected by writer.
+};
+
+LogAsyncTarget::LogAsyncTarget(bool console, IStream* stream, Overflow overflow, uint32_t ringSize)
+:	m_console(console)
+,	m_stream(stream)
+,	m_overflow(overflow)
+,	m_ringSize(nearestLog2(std::max< uint32_t >(ringSize, 1024)))
+{
+	m_thread = ThreadManager::getInstance().create([=, this](){ threadWriter(); }, L"Log writer");
+	if (m_thread)
+		m_thread->start();
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(s_targetsLock);
+	m_next = s_targets;
+	s_targets = this;
+}
+
+LogAsyncTarget::~LogAsyncTarget()
+{
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(s_targetsLock);
+		for (LogAsyncTarget** target = &s_targets; *target; target = &(*target)->m_next)
+		{
+			if (*target == this)
+			{
+				*target = m_next;
+				break;
+			}
+		}
+	}
+
+	if (m_thread)
+	{
+		m_thread->stop(0);
+		m_wake.set();
+		m_thread->stop();
+		ThreadManager::getInstance().destroy(m_thread);
+		m_thread = nullptr;
+	}
+
+	// Write remaining lines; logging threads must not use target any longer.
+	write(-1);
+
+	for (auto ring : m_rings)
+		delete ring;
+	m_rings.clear();
+}
+
+void LogAsyncTarget::flush()
+{
+	write(-1);
+}
+
+void LogAsyncTarget::flushAll()
+{
+	if (!s_targetsLock.wait(c_flushAllTimeout))
+		return;
+
+	for (LogAsyncTarget* target = s_targets; target; target = target->m_next)
+		target->write(c_flushAllTimeout);
+
+	s_targetsLock.release();
+}
+
+void LogAsyncTarget::log(uint32_t threadId, int32_t level, const wchar_t* str)
+{
+	Ring* ring = getThreadRing();
+	const uint32_t mask = m_ringSize - 1;
+
+	// Ensure a record always fit in ring, even after padding.
+	const uint32_t maxLength = std::min< uint32_t >(m_ringSize / 2 - sizeof(Record), 0xffff);
+	const uint32_t length = encodeUtf8(str, nullptr, maxLength);
+	const uint32_t size = recordSize(length);
+
+	const uint32_t head = ring->head.load(std::memory_order_relaxed);
+	const uint32_t offset = head & mask;
+	const uint32_t contiguous = m_ringSize - offset;
+	const uint32_t padding = (contiguous < size) ? contiguous : 0;
+
+	// Wait until writer has made room, or drop line.
+	if (m_ringSize - (head - ring->tail.load(std::memory_order_acquire)) < padding + size)
+	{
+		m_wake.set();
+		if (m_overflow == Overflow::Drop)
+		{
+			m_dropped++;
+			return;
+		}
+		Thread* currentThread = ThreadManager::getInstance().getCurrentThread();
+		while (m_ringSize - (head - ring->tail.load(std::memory_order_acquire)) < padding + size)
+		{
+			m_wake.set();
+			currentThread->yield();
+		}
+	}
+
+	// Pad to end of ring so record is contiguous.
+	if (padding > 0)
+	{
+		Record* pad = (Record*)&ring->data[offset];
+		pad->time = 0;
+		pad->threadId = 0;
+		pad->level = c_levelPadding;
+		pad->length = 0;
+	}
+
+	const uint32_t recordHead = head + padding;
+	Record* record = (Record*)&ring->data[recordHead & mask];
+	record->time = uint64_t(m_timer.getElapsedTime() * 1000000.0);
+	record->threadId = threadId;
+	record->level = uint16_t(level);
+	record->length = uint16_t(length);
+	encodeUtf8(str, (uint8_t*)(record + 1), length);
+
+	const uint32_t newHead = recordHead + size;
+	ring->head.store(newHead, std::memory_order_release);
+
+	// Wake writer for warnings and errors, or when ring is getting full.
+	if (level >= 1 || newHead - ring->tail.load(std::memory_order_relaxed) >= m_ringSize / 2)
+		m_wake.set();
+}
+
+LogAsyncTarget::Ring* LogAsyncTarget::getThreadRing()
+{
+	Ring* ring = (Ring*)m_threadRing.get();
+	if (ring)
+		return ring;
+
+	ring = new Ring();
+	ring->data.reset((uint8_t*)Alloc::acquireAlign(m_ringSize, 16, T_FILE_LINE));
+
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_ringsLock);
+		m_rings.push_back(ring);
+	}
+
+	m_threadRing.set(ring);
+	return ring;
+}
+
+bool LogAsyncTarget::write(int32_t timeout)
+{
+	if (!m_writeLock.wait(timeout))
+		return false;
+
+	const uint32_t mask = m_ringSize - 1;
+
+	// Collect records from all rings.
+	m_pending.resize(0);
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_ringsLock);
+		for (auto ring : m_rings)
+		{
+			const uint32_t head = ring->head.load(std::memory_order_acquire);
+			for (uint32_t position = ring->tail.load(std::memory_order_relaxed); position != head; )
+			{
+				const Record* record = (const Record*)&ring->data[position & mask];
+				if (record->level != c_levelPadding)
+				{
+					m_pending.push_back({ record->time, (const uint8_t*)record });
+					position += recordSize(record->length);
+				}
+				else
+					position += m_ringSize - (position & mask);
+			}
+			ring->drained = head;
+		}
+	}
+
+	if (!m_pending.empty())
+	{
+		// Merge threads; stable sort keep order of lines with same time.
+		std::stable_sort(m_pending.ptr(), m_pending.ptr() + m_pending.size(), [](const Pending& lh, const Pending& rh) {
+			return lh.time < rh.time;
+		});
+
+		m_consoleBatch.resize(0);
+		m_streamBatch.resize(0);
+
+		for (const auto& pending : m_pending)
+		{
+			const Record* record = (const Record*)pending.record;
+			const uint8_t* text = (const uint8_t*)(record + 1);
+
+			if (m_console)
+			{
+				m_consoleBatch.insert(m_consoleBatch.end(), text, text + record->length);
+				m_consoleBatch.push_back('\n');
+			}
+
+			if (m_stream)
+			{
+				char prefix[16];
+				const int32_t prefixLength = snprintf(prefix, sizeof(prefix), "[%5u] ", record->threadId);
+				m_streamBatch.insert(m_streamBatch.end(), (const uint8_t*)prefix, (const uint8_t*)prefix + prefixLength);
+				m_streamBatch.insert(m_streamBatch.end(), text, text + record->length);
+				m_streamBatch.push_back('\n');
+			}
+		}
+
+		if (!m_consoleBatch.empty())
+			writeConsole(m_consoleBatch.c_ptr(), m_consoleBatch.size());
+
+		if (!m_streamBatch.empty())
+		{
+			m_stream->write(m_streamBatch.c_ptr(), m_streamBatch.size());
+			m_stream->flush();
+		}
+	}
+
+	// Release written records back to logging threads.
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_ringsLock);
+		for (auto ring : m_rings)
+			ring->tail.store(ring->drained, std::memory_order_release);
+	}
+
+	m_writeLock.release();
+	return true;
+}
+
+void LogAsyncTarget::threadWriter()
+{
+	while (!m_thread->stopped())
+	{
+		m_wake.wait(c_writeInterval);
+		m_wake.reset();
+		write(-1);
+	}
+}
+
+}
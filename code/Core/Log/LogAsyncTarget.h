@@ -0,0 +1,115 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Log/Log.h"
+#include "Core/Thread/Semaphore.h"
+#include "Core/Thread/Signal.h"
+#include "Core/Thread/ThreadLocal.h"
+#include "Core/Timer/Timer.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_CORE_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor
+{
+
+class IStream;
+class Thread;
+
+/*! Asynchronous log target.
+ * \ingroup Core
+ *
+ * Each logging thread encode lines into compact binary
+ * records, time, level, thread and UTF-8 text, in its own
+ * ring without any locking. A writer thread drain all rings
+ * and write lines, in time order, in batches to console
+ * and stream.
+ *
+ * Warnings and errors wake the writer immediately, other
+ * lines are written when a ring is half full or periodically.
+ */
+class T_DLLCLASS LogAsyncTarget : public ILogTarget
+{
+public:
+	enum class Overflow
+	{
+		Block,	//!< Block logging thread until there is room in its ring.
+		Drop	//!< Drop line if there is no room in ring.
+	};
+
+	/*! Create asynchronous log target.
+	 *
+	 * \param console Write lines to standard output.
+	 * \param stream Optional stream, such as a log file, which receive UTF-8 encoded lines prefixed with thread id.
+	 * \param overflow Policy when a thread's ring is full.
+	 * \param ringSize Size in bytes of each thread's ring.
+	 */
+	explicit LogAsyncTarget(bool console, IStream* stream, Overflow overflow = Overflow::Block, uint32_t ringSize = 64 * 1024);
+
+	virtual ~LogAsyncTarget();
+
+	/*! Write all lines, logged prior to this call, from calling thread. */
+	void flush();
+
+	/*! Get number of dropped lines. */
+	uint32_t getDropped() const { return m_dropped; }
+
+	/*! Write pending lines of all asynchronous targets.
+	 *
+	 * Intended to be called from crash handlers thus
+	 * never wait indefinitely for a writer.
+	 */
+	static void flushAll();
+
+	virtual void log(uint32_t threadId, int32_t level, const wchar_t* str) override final;
+
+private:
+	struct Ring;
+
+	struct Pending
+	{
+		uint64_t time;
+		const uint8_t* record;
+	};
+
+	bool m_console;
+	Ref< IStream > m_stream;
+	Overflow m_overflow;
+	uint32_t m_ringSize;
+	Timer m_timer;
+	ThreadLocal m_threadRing;
+	Semaphore m_ringsLock;
+	AlignedVector< Ring* > m_rings;
+	Semaphore m_writeLock;
+	AlignedVector< Pending > m_pending;
+	AlignedVector< uint8_t > m_consoleBatch;
+	AlignedVector< uint8_t > m_streamBatch;
+	Signal m_wake;
+	Thread* m_thread = nullptr;
+	std::atomic< uint32_t > m_dropped = 0;
+	LogAsyncTarget* m_next = nullptr;
+
+	Ring* getThreadRing();
+
+	/*! Write all records in rings; return false if unable to acquire write lock within timeout. */
+	bool write(int32_t timeout);
+
+	void threadWriter();
+};
+
+}
@@ -6,10 +6,13 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include "Core/Math/Log2.h"
 #include "Core/Memory/BlockAllocator.h"
 #include "Core/Memory/FastAllocator.h"
+#include "Core/Memory/MemoryConfig.h"
 #include "Core/Memory/SystemConstruct.h"
+#include "Core/Misc/Align.h"
 #include "Core/Thread/Atomic.h"
 #include "Core/Thread/Thread.h"
 #include "Core/Thread/ThreadManager.h"
@@ -38,31 +41,81 @@ const uint32_t c_blockCounts[] =
 #endif
 };
 
+const uint32_t c_cacheSize = 32;		//!< Max number of cached blocks per class and thread.
+const uint32_t c_cacheRefill = 16;		//!< Number of blocks cached when refilling from shared allocator.
+
+std::atomic< uint32_t > s_generationCounter(0);
+std::atomic< uint32_t > s_generation(0);
+
+	}
+
+/*! Per thread cache of free blocks. */
+struct FastAllocator::ThreadCache
+{
+	FastAllocator* owner = nullptr;
+	uint32_t generation = 0;
+	bool destroyed = false;
+	uint32_t count[6] = { 0 };
+	uint32_t hits[6] = { 0 };
+	void* blocks[6][c_cacheSize];
+
+	~ThreadCache()
+	{
+		// Return cached blocks if owning allocator is still alive.
+		if (owner != nullptr && generation == s_generation)
+			owner->flushThreadCache(this);
+		destroyed = true;
 	}
+};
 
 FastAllocator::FastAllocator(IAllocator* systemAllocator)
 :	m_systemAllocator(systemAllocator)
+,	m_arena(nullptr)
+,	m_arenaSize(0)
+,	m_spanShift(0)
+,	m_generation(0)
 {
+	// Reserve a single range with each class in an equally sized
+	// power-of-two span, class is resolved from the offset.
+	uint32_t maxSpanSize = 0;
+	for (size_t i = 0; i < sizeof_array(c_blockCounts); ++i)
+		maxSpanSize = std::max< uint32_t >(maxSpanSize, (1U << (i + 4)) * c_blockCounts[i]);
+
+	m_spanShift = log2(nearestLog2(maxSpanSize));
+	m_arenaSize = sizeof_array(c_blockCounts) << m_spanShift;
+	m_arena = (uint8_t*)m_systemAllocator->alloc(m_arenaSize, 4096, T_FILE_LINE);
+
 	for (size_t i = 0; i < sizeof_array(c_blockCounts); ++i)
 	{
 		const uint32_t qsize = 1U << (i + 4);
 		m_blockAlloc[i] = allocConstruct< BlockAllocator >(
-			m_systemAllocator->alloc(qsize * c_blockCounts[i], 16, T_FILE_LINE),
+			m_arena + (i << m_spanShift),
 			c_blockCounts[i],
 			qsize
 		);
 		m_blockAllocLock[i] = 0;
-		m_blockAllocFull[i] = 0;
+		m_hits[i] = 0;
+		m_misses[i] = 0;
+		m_fallbacks[i] = 0;
 	}
+
+	// Only a single allocator can use thread caches at any time.
+	uint32_t expected = 0;
+	const uint32_t generation = ++s_generationCounter;
+	if (s_generation.compare_exchange_strong(expected, generation))
+		m_generation = generation;
 }
 
 FastAllocator::~FastAllocator()
 {
+	// Orphan all thread caches; blocks are released with the arena.
+	if (m_generation != 0)
+		s_generation = 0;
+
 	for (size_t i = 0; i < sizeof_array(m_blockAlloc); ++i)
-	{
-		m_systemAllocator->free(m_blockAlloc[i]->top());
 		freeDestruct(m_blockAlloc[i]);
-	}
+
+	m_systemAllocator->free(m_arena);
 }
 
 void* FastAllocator::alloc(size_t size, size_t align, const char* const tag)
@@ -78,25 +131,42 @@ void* FastAllocator::alloc(size_t size, size_t align, const char* const tag)
 
 		const uint32_t qid = log2(uint32_t(size)) - 4;
 
-		BlockAllocator* blockAlloc = m_blockAlloc[qid];
-		T_ASSERT(blockAlloc)
-
+		ThreadCache* cache = getThreadCache();
+		if (cache != nullptr && cache->count[qid] > 0)
+		{
+			p = cache->blocks[qid][--cache->count[qid]];
+			cache->hits[qid]++;
+		}
+		else
 		{
-			while (Atomic::exchange(m_blockAllocLock[qid], 1) != 0)
-				ThreadManager::getInstance().getCurrentThread()->yield();
+			BlockAllocator* blockAlloc = m_blockAlloc[qid];
+			T_ASSERT(blockAlloc)
 
+			// Refill thread cache in a batch to amortize cost of locking.
+			lock(qid);
 			p = blockAlloc->alloc();
+			if (p != nullptr && cache != nullptr)
+			{
+				while (cache->count[qid] < c_cacheRefill)
+				{
+					void* block = blockAlloc->alloc();
+					if (!block)
+						break;
+					cache->blocks[qid][cache->count[qid]++] = block;
+				}
+			}
+			unlock(qid);
 
-			Atomic::exchange(m_blockAllocLock[qid], 0);
-		}
+			if (p)
+				m_misses[qid]++;
+			else
+				m_fallbacks[qid]++;
 
-		if (!p)
-		{
-#if 0
-			if (!m_blockAllocFull[qid])
-				log::debug << L"Out of " << size << L" blocks in fast allocator" << Endl;
-#endif
-			m_blockAllocFull[qid] = 1;
+			if (cache != nullptr && cache->hits[qid] > 0)
+			{
+				m_hits[qid] += cache->hits[qid];
+				cache->hits[qid] = 0;
+			}
 		}
 
 		T_ASSERT(alignUp((uint8_t*)p, 16) == p);
@@ -111,23 +181,97 @@ void* FastAllocator::alloc(size_t size, size_t align, const char* const tag)
 
 void FastAllocator::free(void* ptr)
 {
-	for (size_t i = 0; i < sizeof_array(m_blockAlloc); ++i)
+	const uintptr_t offset = (uintptr_t)ptr - (uintptr_t)m_arena;
+	if (offset < m_arenaSize)
 	{
-		if (m_blockAlloc[i]->belong(ptr))
+		const uint32_t qid = uint32_t(offset >> m_spanShift);
+
+		ThreadCache* cache = getThreadCache();
+		if (cache != nullptr)
 		{
+			// Return half of cached blocks to shared allocator if cache is full.
+			if (cache->count[qid] >= c_cacheSize)
 			{
-				while (Atomic::exchange(m_blockAllocLock[i], 1) != 0)
-					ThreadManager::getInstance().getCurrentThread()->yield();
-
-				m_blockAlloc[i]->free(ptr);
-
-				Atomic::exchange(m_blockAllocLock[i], 0);
+				lock(qid);
+				while (cache->count[qid] > c_cacheSize / 2)
+					m_blockAlloc[qid]->free(cache->blocks[qid][--cache->count[qid]]);
+				unlock(qid);
 			}
-			m_blockAllocFull[i] = 0;
-			return;
+			cache->blocks[qid][cache->count[qid]++] = ptr;
 		}
+		else
+		{
+			lock(qid);
+			m_blockAlloc[qid]->free(ptr);
+			unlock(qid);
+		}
+		return;
 	}
 	m_systemAllocator->free(ptr);
 }
 
+void FastAllocator::getStatistics(FastAllocatorStatistics& outStatistics) const
+{
+	for (size_t i = 0; i < sizeof_array(c_blockCounts); ++i)
+	{
+		auto& sc = outStatistics.sizeClasses[i];
+		sc.blockSize = 1U << (i + 4);
+		sc.blockCount = c_blockCounts[i];
+		sc.hits = m_hits[i];
+		sc.misses = m_misses[i];
+		sc.fallbacks = m_fallbacks[i];
+	}
+}
+
+FastAllocator::ThreadCache* FastAllocator::getThreadCache() const
+{
+	if (m_generation == 0)
+		return nullptr;
+
+	static thread_local ThreadCache s_cache;
+	if (s_cache.destroyed)
+		return nullptr;
+
+	// Discard cache if it belongs to an allocator which has been destroyed.
+	if (s_cache.generation != m_generation)
+	{
+		s_cache.owner = const_cast< FastAllocator* >(this);
+		s_cache.generation = m_generation;
+		for (size_t i = 0; i < sizeof_array(s_cache.count); ++i)
+		{
+			s_cache.count[i] = 0;
+			s_cache.hits[i] = 0;
+		}
+	}
+
+	return &s_cache;
+}
+
+void FastAllocator::flushThreadCache(ThreadCache* cache)
+{
+	for (uint32_t i = 0; i < sizeof_array(m_blockAlloc); ++i)
+	{
+		if (cache->count[i] > 0)
+		{
+			lock(i);
+			while (cache->count[i] > 0)
+				m_blockAlloc[i]->free(cache->blocks[i][--cache->count[i]]);
+			unlock(i);
+		}
+		m_hits[i] += cache->hits[i];
+		cache->hits[i] = 0;
+	}
+}
+
+void FastAllocator::lock(uint32_t qid)
+{
+	while (Atomic::exchange(m_blockAllocLock[qid], 1) != 0)
+		ThreadManager::getInstance().getCurrentThread()->yield();
+}
+
+void FastAllocator::unlock(uint32_t qid)
+{
+	Atomic::exchange(m_blockAllocLock[qid], 0);
+}
+
 }
@@ -8,12 +8,14 @@
  */
 #pragma once
 
+#include <atomic>
 #include "Core/Memory/IAllocator.h"
 
 namespace traktor
 {
 
 class BlockAllocator;
+struct FastAllocatorStatistics;
 
 /*! Fast allocator.
  * \ingroup Core
@@ -21,6 +23,13 @@ class BlockAllocator;
  * The fast allocator is optimized for allocated
  * fixed size chunks for small objects. It uses
  * a greedy O(1) allocation scheme for such allocations.
+ *
+ * All size classes are reserved from a single contiguous
+ * range, each class in a power-of-two span, so the class
+ * of a pointer is resolved without probing each class.
+ * Each thread keep a small cache of free blocks per class
+ * thus the shared lock is only taken when the cache
+ * need to be refilled or flushed.
  */
 class FastAllocator : public IAllocator
 {
@@ -33,11 +42,30 @@ public:
 
 	virtual void free(void* ptr) override final;
 
+	/*! Get allocation statistics per size class. */
+	void getStatistics(FastAllocatorStatistics& outStatistics) const;
+
 private:
+	struct ThreadCache;
+
 	IAllocator* m_systemAllocator;
+	uint8_t* m_arena;
+	size_t m_arenaSize;
+	uint32_t m_spanShift;
+	uint32_t m_generation;
 	BlockAllocator* m_blockAlloc[6];
 	int32_t m_blockAllocLock[6];
-	int8_t m_blockAllocFull[6];
+	std::atomic< uint64_t > m_hits[6];
+	std::atomic< uint64_t > m_misses[6];
+	std::atomic< uint64_t > m_fallbacks[6];
+
+	ThreadCache* getThreadCache() const;
+
+	void flushThreadCache(ThreadCache* cache);
+
+	void lock(uint32_t qid);
+
+	void unlock(uint32_t qid);
 };
 
 }
@@ -22,6 +22,7 @@ namespace traktor
 
 IAllocator* s_stdAllocator = nullptr;
 IAllocator* s_allocator = nullptr;
+FastAllocator* s_fastAllocator = nullptr;
 
 #if !defined(__MAC__) && !defined(__IOS__)
 void destroyAllocator()
@@ -33,6 +34,7 @@ void destroyAllocator()
 
 	s_stdAllocator = nullptr;
 	s_allocator = nullptr;
+	s_fastAllocator = nullptr;
 }
 #endif
 
@@ -49,14 +51,14 @@ IAllocator* getAllocator()
 
 #elif defined(__LINUX__)
 #	if !defined(_DEBUG)
-		s_allocator = allocConstruct< FastAllocator >(s_stdAllocator);
+		s_allocator = s_fastAllocator = allocConstruct< FastAllocator >(s_stdAllocator);
 #	else
 		s_allocator = allocConstruct< TrackAllocator >(s_stdAllocator);
 #	endif
 
 #elif defined(_WIN32)
 #	if !defined(_DEBUG)
-		s_allocator = allocConstruct< FastAllocator >(s_stdAllocator);
+		s_allocator = s_fastAllocator = allocConstruct< FastAllocator >(s_stdAllocator);
 #	else
 		s_allocator = allocConstruct< TrackAllocator >(s_stdAllocator);
 #	endif
@@ -70,4 +72,13 @@ IAllocator* getAllocator()
 	return s_allocator;
 }
 
+bool getFastAllocatorStatistics(FastAllocatorStatistics& outStatistics)
+{
+	if (!s_fastAllocator)
+		return false;
+
+	s_fastAllocator->getStatistics(outStatistics);
+	return true;
+}
+
 }
@@ -23,7 +23,34 @@ namespace traktor
 
 class IAllocator;
 
+/*! Fast allocator statistics.
+ * \ingroup Core
+ *
+ * Per size class counters, useful for tuning
+ * number of blocks reserved for each class.
+ */
+struct FastAllocatorStatistics
+{
+	struct SizeClass
+	{
+		uint32_t blockSize = 0;		//!< Size of each block in bytes.
+		uint32_t blockCount = 0;	//!< Number of blocks reserved.
+		uint64_t hits = 0;			//!< Allocations served from thread local cache.
+		uint64_t misses = 0;		//!< Allocations served from shared block allocator.
+		uint64_t fallbacks = 0;		//!< Allocations passed to system allocator since class was exhausted.
+	};
+
+	SizeClass sizeClasses[6];
+};
+
 T_DLLCLASS IAllocator* getAllocator();
 
+/*! Get fast allocator statistics.
+ *
+ * \param outStatistics Statistics of fast allocator.
+ * \return True if fast allocator is in use.
+ */
+T_DLLCLASS bool getFastAllocatorStatistics(FastAllocatorStatistics& outStatistics);
+
 }
 
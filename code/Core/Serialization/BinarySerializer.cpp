@@ -11,8 +11,11 @@
 #include <cstring>
 #include <limits>
 #include <sstream>
+#include <type_traits>
 #include "Core/Guid.h"
+#include "Core/Io/DynamicMemoryStream.h"
 #include "Core/Io/IStream.h"
+#include "Core/Io/MemoryStream.h"
 #include "Core/Io/Path.h"
 #include "Core/Io/Utf8Encoding.h"
 #include "Core/Log/Log.h"
@@ -37,10 +40,20 @@ namespace traktor
 
 #if defined(T_LITTLE_ENDIAN)
 
-template < typename T >
-bool read_primitive(const Ref< IStream >& stream, T& value)
+template < typename T, typename ReaderType >
+bool read_primitive(ReaderType& reader, T& value)
 {
-	return stream->read(&value, sizeof(T)) == sizeof(T);
+	if constexpr (std::is_same_v< T, bool >)
+	{
+		uint8_t tmp;
+		if (reader.read(&tmp, 1) != 1)
+			return false;
+
+		value = bool(tmp != 0);
+		return true;
+	}
+	else
+		return reader.read(&value, sizeof(T)) == sizeof(T);
 }
 
 template < typename T >
@@ -49,10 +62,10 @@ bool write_primitive(const Ref< IStream >& stream, T v)
 	return stream->write(&v, sizeof(T)) == sizeof(T);
 }
 
-template < typename T >
-bool read_primitives(const Ref< IStream >& stream, T* value, int count)
+template < typename T, typename ReaderType >
+bool read_primitives(ReaderType& reader, T* value, int count)
 {
-	return stream->read(value, sizeof(T) * count) == sizeof(T) * count;
+	return reader.read(value, sizeof(T) * count) == sizeof(T) * count;
 }
 
 template < typename T >
@@ -61,12 +74,13 @@ bool write_primitives(const Ref< IStream >& stream, const T* value, int count)
 	return stream->write(value, sizeof(T) * count) == sizeof(T) * count;
 }
 
-inline bool read_block(const Ref< IStream >& stream, void* block, int count, int size)
+template < typename ReaderType >
+bool read_block(ReaderType& reader, void* block, int64_t count, int size)
 {
-	return stream->read(block, count * size) == count * size;
+	return reader.read(block, count * size) == count * size;
 }
 
-inline bool write_block(const Ref< IStream >& stream, const void* block, int count, int size)
+inline bool write_block(const Ref< IStream >& stream, const void* block, int64_t count, int size)
 {
 	return stream->write(block, count * size) == count * size;
 }
@@ -76,9 +90,10 @@ inline bool write_block(const Ref< IStream >& stream, const void* block, int cou
 template < typename T, int Size >
 struct ReadPrimitive
 {
-	static bool read(IStream* stream, T& t)
+	template < typename ReaderType >
+	static bool read(ReaderType& reader, T& t)
 	{
-		if (stream->read(&t, sizeof(t)) == sizeof(t))
+		if (reader.read(&t, sizeof(t)) == sizeof(t))
 		{
 			swap8in64(t);
 			return true;
@@ -91,16 +106,27 @@ struct ReadPrimitive
 template < typename T >
 struct ReadPrimitive < T, 1 >
 {
-	static bool read(IStream* stream, T& t)
+	template < typename ReaderType >
+	static bool read(ReaderType& reader, T& t)
 	{
-		return bool(stream->read(&t, 1) == 1);
+		return bool(reader.read(&t, 1) == 1);
 	}
 };
 
-template < typename T >
-bool read_primitive(const Ref< IStream >& stream, T& value)
+template < typename T, typename ReaderType >
+bool read_primitive(ReaderType& reader, T& value)
 {
-	return ReadPrimitive< T, sizeof(T) >::read(stream, value);
+	if constexpr (std::is_same_v< T, bool >)
+	{
+		uint8_t tmp;
+		if (reader.read(&tmp, 1) != 1)
+			return false;
+
+		value = bool(tmp != 0);
+		return true;
+	}
+	else
+		return ReadPrimitive< T, sizeof(T) >::read(reader, value);
 }
 
 template < typename T >
@@ -121,12 +147,12 @@ bool write_primitive(const Ref< IStream >& stream, T v)
 	return false;
 }
 
-template < typename T >
-bool read_primitives(const Ref< IStream >& stream, T* value, int count)
+template < typename T, typename ReaderType >
+bool read_primitives(ReaderType& reader, T* value, int count)
 {
 	for (int i = 0; i < count; ++i)
 	{
-		if (!read_primitive< T >(stream, value[i]))
+		if (!read_primitive< T >(reader, value[i]))
 			return false;
 	}
 	return true;
@@ -143,13 +169,14 @@ bool write_primitives(const Ref< IStream >& stream, const T* value, int count)
 	return true;
 }
 
-bool read_block(const Ref< IStream >& stream, void* block, int count, int size)
+template < typename ReaderType >
+bool read_block(ReaderType& reader, void* block, int64_t count, int size)
 {
-	int result = stream->read(block, count * size);
+	const int64_t result = reader.read(block, count * size);
 	if (result > 0 && size > 1)
 	{
 		uint8_t* p = static_cast< uint8_t* >(block);
-		for (int i = 0; i < result; i += size)
+		for (int64_t i = 0; i < result; i += size)
 		{
 			for (int j = 0; j < size >> 1; ++j)
 				std::swap(p[j], p[size - j - 1]);
@@ -159,14 +186,14 @@ bool read_block(const Ref< IStream >& stream, void* block, int count, int size)
 	return result == count * size;
 }
 
-bool write_block(const Ref< IStream >& stream, const void* block, int count, int size)
+bool write_block(const Ref< IStream >& stream, const void* block, int64_t count, int size)
 {
 	if (size > 1)
 	{
 		const uint8_t* p = static_cast< const uint8_t* >(block);
 		std::vector< uint8_t > tmp(size);
 
-		for (int i = 0; i < count; ++i, p += size)
+		for (int64_t i = 0; i < count; ++i, p += size)
 		{
 			std::memcpy(&tmp.front(), p, size);
 			std::reverse(tmp.begin(), tmp.end());
@@ -184,17 +211,6 @@ bool write_block(const Ref< IStream >& stream, const void* block, int count, int
 
 #endif
 
-template < >
-bool read_primitive(const Ref< IStream >& stream, bool& value)
-{
-	uint8_t tmp;
-	if (stream->read(&tmp, 1) != 1)
-		return false;
-
-	value = bool(tmp != 0);
-	return true;
-}
-
 template < >
 bool write_primitive(const Ref< IStream >& stream, bool v)
 {
@@ -204,46 +220,63 @@ bool write_primitive(const Ref< IStream >& stream, bool v)
 	return false;
 }
 
-bool read_string(const Ref< IStream >& stream, uint32_t u8len, std::wstring& outString)
+template < typename ReaderType >
+bool read_string(ReaderType& reader, uint32_t u8len, std::wstring& outString)
 {
-	if (u8len > 0)
-	{
-		outString.clear();
-		outString.reserve(u8len);
+	outString.clear();
+	if (u8len == 0)
+		return true;
 
-		AutoArrayPtr< uint8_t > buf(new uint8_t [u8len * sizeof(uint8_t)]);
-		if (!buf.ptr())
+	// Decode directly from memory if possible, else read into temporary buffer.
+	AutoArrayPtr< uint8_t > buf;
+	const uint8_t* u8str = reader.acquire(u8len);
+	if (!u8str)
+	{
+		if (!reader.stream)
 			return false;
 
-		uint8_t* u8str = buf.ptr();
-		if (!read_block(stream, u8str, u8len, sizeof(uint8_t)))
+		buf.reset(new uint8_t [u8len * sizeof(uint8_t)]);
+		if (!read_block(reader, buf.ptr(), u8len, sizeof(uint8_t)))
 			return false;
 
-		const Utf8Encoding utf8enc;
-		for (uint32_t i = 0; i < u8len; )
+		u8str = buf.c_ptr();
+	}
+
+	// Decoded string never contain more characters than encoded bytes.
+	outString.resize(u8len);
+	wchar_t* out = outString.data();
+	uint32_t length = 0;
+
+	const Utf8Encoding utf8enc;
+	for (uint32_t i = 0; i < u8len; )
+	{
+		if (u8str[i] < 0x80)
 		{
-			wchar_t ch;
-			int n = utf8enc.translate(u8str + i, u8len - i, ch);
-			if (n <= 0)
-				return false;
-			outString += ch;
-			i += n;
+			out[length++] = (wchar_t)u8str[i++];
+			continue;
 		}
+
+		wchar_t ch;
+		const int n = utf8enc.translate(u8str + i, u8len - i, ch);
+		if (n <= 0)
+			return false;
+		out[length++] = ch;
+		i += n;
 	}
-	else
-		outString.clear();
 
+	outString.resize(length);
 	return true;
 }
 
-bool read_string(const Ref< IStream >& stream, std::wstring& outString)
+template < typename ReaderType >
+bool read_string(ReaderType& reader, std::wstring& outString)
 {
-    uint32_t u8len = 0;
+	uint32_t u8len = 0;
 
-	if (!read_primitive< uint32_t >(stream, u8len))
+	if (!read_primitive< uint32_t >(reader, u8len))
 		return false;
 
-	return read_string(stream, u8len, outString);
+	return read_string(reader, u8len, outString);
 }
 
 bool write_string(const Ref< IStream >& stream, const std::wstring& str)
@@ -280,31 +313,28 @@ bool write_string(const Ref< IStream >& stream, const std::wstring& str)
 	}
 }
 
-bool read_string(const Ref< IStream >& stream, uint32_t u8len, std::string& outString)
+template < typename ReaderType >
+bool read_string(ReaderType& reader, uint32_t u8len, std::string& outString)
 {
-	outString.clear();
+	outString.resize(u8len);
 	if (u8len > 0)
 	{
-		outString.reserve(u8len);
-		for (uint32_t i = 0; i < u8len; ++i)
+		if (!read_block(reader, outString.data(), u8len, sizeof(uint8_t)))
 		{
-			uint8_t ch;
-			if (!read_primitive< uint8_t >(stream, ch))
-				return false;
-			outString += ch;
+			outString.clear();
+			return false;
 		}
 	}
-	else
-		outString.clear();
 	return true;
 }
 
-bool read_string(const Ref< IStream >& stream, std::string& outString)
+template < typename ReaderType >
+bool read_string(ReaderType& reader, std::string& outString)
 {
 	uint32_t u8len;
-	if (!read_primitive< uint32_t >(stream, u8len))
+	if (!read_primitive< uint32_t >(reader, u8len))
 		return false;
-	return read_string(stream, u8len, outString);
+	return read_string(reader, u8len, outString);
 }
 
 bool write_string(const Ref< IStream >& stream, const std::string& str)
@@ -336,12 +366,84 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.BinarySerializer", BinarySerializer, Serializer
 #define T_CHECK_STATUS \
 	if (failed()) return;
 
+inline int64_t BinarySerializer::Reader::read(void* block, int64_t nbytes)
+{
+	if (stream)
+		return stream->read(block, nbytes);
+
+	const int64_t nread = std::min< int64_t >(nbytes, end - ptr);
+	if (nread > 0)
+	{
+		std::memcpy(block, ptr, nread);
+		ptr += nread;
+	}
+	return nread;
+}
+
+inline const uint8_t* BinarySerializer::Reader::acquire(int64_t nbytes)
+{
+	if (stream || nbytes > end - ptr)
+		return nullptr;
+
+	const uint8_t* block = ptr;
+	ptr += nbytes;
+	return block;
+}
+
 BinarySerializer::BinarySerializer(IStream* stream)
 :	m_stream(stream)
 ,	m_direction(m_stream->canRead() ? Direction::Read : Direction::Write)
 ,	m_nextCacheId(1)
 ,	m_nextTypeCacheId(0)
 {
+	m_reader.stream = m_stream;
+
+	// Read directly from memory if stream is memory backed.
+	if (m_direction == Direction::Read)
+	{
+		const uint8_t* buffer = nullptr;
+		int64_t bufferSize = 0;
+
+		if (auto memoryStream = dynamic_type_cast< MemoryStream* >(m_stream))
+		{
+			buffer = memoryStream->getBuffer();
+			bufferSize = memoryStream->getBufferSize();
+		}
+		else if (auto dynamicMemoryStream = dynamic_type_cast< DynamicMemoryStream* >(m_stream))
+		{
+			if (!dynamicMemoryStream->canWrite())
+			{
+				buffer = dynamicMemoryStream->getBuffer().c_ptr();
+				bufferSize = (int64_t)dynamicMemoryStream->getBuffer().size();
+			}
+		}
+
+		if (buffer)
+		{
+			const int64_t position = m_stream->tell();
+			if (position >= 0 && position <= bufferSize)
+			{
+				m_reader.stream = nullptr;
+				m_reader.ptr = buffer + position;
+				m_reader.end = buffer + bufferSize;
+				m_readBase = buffer;
+			}
+		}
+	}
+}
+
+BinarySerializer::BinarySerializer(const void* buffer, int64_t bufferSize)
+:	m_direction(Direction::Read)
+,	m_nextCacheId(1)
+,	m_nextTypeCacheId(0)
+{
+	m_reader.ptr = static_cast< const uint8_t* >(buffer);
+	m_reader.end = m_reader.ptr + (buffer ? bufferSize : 0);
+}
+
+BinarySerializer::~BinarySerializer()
+{
+	syncStream();
 }
 
 Serializer::Direction BinarySerializer::getDirection() const
@@ -353,7 +455,7 @@ void BinarySerializer::operator >> (const Member< bool >& m)
 {
 	T_CHECK_STATUS;
 	if (m_direction == Direction::Read)
-		read_primitive< bool >(m_stream, m);
+		read_primitive< bool >(m_reader, m);
 	else
 		write_primitive< bool >(m_stream, m);
 }
@@ -362,7 +464,7 @@ void BinarySerializer::operator >> (const Member< int8_t >& m)
 {
 	T_CHECK_STATUS;
 	if (m_direction == Direction::Read)
-		read_primitive< int8_t >(m_stream, m);
+		read_primitive< int8_t >(m_reader, m);
 	else
 		write_primitive< int8_t >(m_stream, m);
 }
@@ -371,7 +473,7 @@ void BinarySerializer::operator >> (const Member< uint8_t >& m)
 {
 	T_CHECK_STATUS;
 	if (m_direction == Direction::Read)
-		read_primitive< uint8_t >(m_stream, m);
+		read_primitive< uint8_t >(m_reader, m);
 	else
 		write_primitive< uint8_t >(m_stream, m);
 }
@@ -380,7 +482,7 @@ void BinarySerializer::operator >> (const Member< int16_t >& m)
 {
 	T_CHECK_STATUS;
 	if (m_direction == Direction::Read)
-		read_primitive< int16_t >(m_stream, m);
+		read_primitive< int16_t >(m_reader, m);
 	else
 		write_primitive< int16_t >(m_stream, m);
 }
@@ -389,7 +491,7 @@ void BinarySerializer::operator >> (const Member< uint16_t >& m)
 {
 	T_CHECK_STATUS;
 	if (m_direction == Direction::Read)
-		read_primitive< uint16_t >(m_stream, m);
+		read_primitive< uint16_t >(m_reader, m);
 	else
 		write_primitive< uint16_t >(m_stream, m);
 }
@@ -398,7 +500,7 @@ void BinarySerializer::operator >> (const Member< int32_t >& m)
 {
 	T_CHECK_STATUS;
 	if (m_direction == Direction::Read)
-		read_primitive< int32_t >(m_stream, m);
+		read_primitive< int32_t >(m_reader, m);
 	else
 		write_primitive< int32_t >(m_stream, m);
 }
@@ -407,7 +509,7 @@ void BinarySerializer::operator >> (const Member< uint32_t >& m)
 {
 	T_CHECK_STATUS;
 	if (m_direction == Direction::Read)
-		read_primitive< uint32_t >(m_stream, m);
+		read_primitive< uint32_t >(m_reader, m);
 	else
 		write_primitive< uint32_t >(m_stream, m);
 }
@@ -416,7 +518,7 @@ void BinarySerializer::operator >> (const Member< int64_t >& m)
 {
 	T_CHECK_STATUS;
 	if (m_direction == Direction::Read)
-		read_primitive< int64_t >(m_stream, m);
+		read_primitive< int64_t >(m_reader, m);
 	else
 		write_primitive< int64_t >(m_stream, m);
 }
@@ -425,7 +527,7 @@ void BinarySerializer::operator >> (const Member< uint64_t >& m)
 {
 	T_CHECK_STATUS;
 	if (m_direction == Direction::Read)
-		read_primitive< uint64_t >(m_stream, m);
+		read_primitive< uint64_t >(m_reader, m);
 	else
 		write_primitive< uint64_t >(m_stream, m);
 }
@@ -434,7 +536,7 @@ void BinarySerializer::operator >> (const Member< float >& m)
 {
 	T_CHECK_STATUS;
 	if (m_direction == Direction::Read)
-		read_primitive< float >(m_stream, m);
+		read_primitive< float >(m_reader, m);
 	else
 		write_primitive< float >(m_stream, m);
 }
@@ -443,7 +545,7 @@ void BinarySerializer::operator >> (const Member< double >& m)
 {
 	T_CHECK_STATUS;
 	if (m_direction == Direction::Read)
-		read_primitive< double >(m_stream, m);
+		read_primitive< double >(m_reader, m);
 	else
 		write_primitive< double >(m_stream, m);
 }
@@ -452,7 +554,7 @@ void BinarySerializer::operator >> (const Member< std::string >& m)
 {
 	T_CHECK_STATUS;
 	if (m_direction == Direction::Read)
-		read_string(m_stream, m);
+		read_string(m_reader, m);
 	else
 		write_string(m_stream, m);
 }
@@ -461,7 +563,7 @@ void BinarySerializer::operator >> (const Member< std::wstring >& m)
 {
 	T_CHECK_STATUS;
 	if (m_direction == Direction::Read)
-		read_string(m_stream, m);
+		read_string(m_reader, m);
 	else
 		write_string(m_stream, m);
 }
@@ -475,13 +577,13 @@ void BinarySerializer::operator >> (const Member< Guid >& m)
 	{
 		bool validGuid = false;
 
-		if (!read_primitive< bool >(m_stream, validGuid))
+		if (!read_primitive< bool >(m_reader, validGuid))
 			return;
 
 		if (validGuid)
 		{
 			uint8_t data[16];
-			read_block(m_stream, data, 16, 1);
+			read_block(m_reader, data, 16, 1);
 			guid = Guid(data);
 		}
 		else
@@ -504,7 +606,7 @@ void BinarySerializer::operator >> (const Member< Path >& m)
 	if (m_direction == Direction::Read)
 	{
 		std::wstring path;
-		read_string(m_stream, path);
+		read_string(m_reader, path);
 		*m = Path(path);
 	}
 	else
@@ -519,10 +621,10 @@ void BinarySerializer::operator >> (const Member< Color4ub >& m)
 	T_CHECK_STATUS;
 	if (m_direction == Direction::Read)
 	{
-		read_primitive< uint8_t >(m_stream, m->r);
-		read_primitive< uint8_t >(m_stream, m->g);
-		read_primitive< uint8_t >(m_stream, m->b);
-		read_primitive< uint8_t >(m_stream, m->a);
+		read_primitive< uint8_t >(m_reader, m->r);
+		read_primitive< uint8_t >(m_reader, m->g);
+		read_primitive< uint8_t >(m_reader, m->b);
+		read_primitive< uint8_t >(m_reader, m->a);
 	}
 	else
 	{
@@ -540,7 +642,7 @@ void BinarySerializer::operator >> (const Member< Color4f >& m)
 	float T_MATH_ALIGN16 e[4];
 	if (m_direction == Direction::Read)
 	{
-		read_primitives< float >(m_stream, e, 4);
+		read_primitives< float >(m_reader, e, 4);
 		(*m) = Color4f::loadUnaligned(e);
 	}
 	else
@@ -558,7 +660,7 @@ void BinarySerializer::operator >> (const Member< Scalar >& m)
 	if (m_direction == Direction::Read)
 	{
 		float tmp;
-		read_primitive< float >(m_stream, tmp);
+		read_primitive< float >(m_reader, tmp);
 		v = Scalar(tmp);
 	}
 	else
@@ -570,8 +672,8 @@ void BinarySerializer::operator >> (const Member< Vector2 >& m)
 	T_CHECK_STATUS;
 	if (m_direction == Direction::Read)
 	{
-		read_primitive< float >(m_stream, m->x);
-		read_primitive< float >(m_stream, m->y);
+		read_primitive< float >(m_reader, m->x);
+		read_primitive< float >(m_reader, m->y);
 	}
 	else
 	{
@@ -587,7 +689,7 @@ void BinarySerializer::operator >> (const Member< Vector4 >& m)
 	float T_MATH_ALIGN16 e[4];
 	if (m_direction == Direction::Read)
 	{
-		read_primitives< float >(m_stream, e, 4);
+		read_primitives< float >(m_reader, e, 4);
 		(*m) = Vector4::loadAligned(e);
 	}
 	else
@@ -601,7 +703,7 @@ void BinarySerializer::operator >> (const Member< Matrix33 >& m)
 {
 	T_CHECK_STATUS;
 	if (m_direction == Direction::Read)
-		read_primitives< float >(m_stream, m->m, 3 * 3);
+		read_primitives< float >(m_reader, m->m, 3 * 3);
 	else
 		write_primitives< float >(m_stream, m->m, 3 * 3);
 }
@@ -613,7 +715,7 @@ void BinarySerializer::operator >> (const Member< Matrix44 >& m)
 	float T_MATH_ALIGN16 values[16];
 	if (m_direction == Direction::Read)
 	{
-		read_primitives< float >(m_stream, values, 16);
+		read_primitives< float >(m_reader, values, 16);
 		(*m) = Matrix44::loadAligned(values);
 	}
 	else
@@ -630,7 +732,7 @@ void BinarySerializer::operator >> (const Member< Quaternion >& m)
 	float T_MATH_ALIGN16 e[4];
 	if (m_direction == Direction::Read)
 	{
-		read_primitives< float >(m_stream, e, 4);
+		read_primitives< float >(m_reader, e, 4);
 		m->e = Vector4::loadAligned(e);
 	}
 	else
@@ -646,134 +748,12 @@ void BinarySerializer::operator >> (const Member< ISerializable* >& m)
 
 	if (m_direction == Direction::Read)
 	{
-		bool reference = false;
-		uint64_t hash = 0;
-
-		if (!ensure(read_primitive< bool >(m_stream, reference)))
-			return;
-		if (!ensure(read_primitive< uint64_t >(m_stream, hash)))
-			return;
-
-		Ref< ISerializable > object;
-
-		if (hash)
-		{
-			if (!reference)
-			{
-				uint32_t typeHashOrLen;
-				const TypeInfo* type;
-				int16_t version;
-
-				if (!ensure(read_primitive< uint32_t >(m_stream, typeHashOrLen)))
-				{
-					log::error << L"Unable to read \"" << m.getName() << L"\"; unable to read type hash." << Endl;
-					return;
-				}
-
-				if ((typeHashOrLen & 0x80000000) == 0x80000000)
-					type = m_typeReadCache[typeHashOrLen & 0x7fffffff];
-				else
-				{
-					std::wstring typeName;
-					if (!ensure(read_string(m_stream, typeHashOrLen, typeName)))
-					{
-						log::error << L"Unable to read \"" << m.getName() << L"\"; unable to read type." << Endl;
-						return;
-					}
-
-					type = TypeInfo::find(typeName.c_str());
-					if (!ensure(type != 0))
-					{
-						log::error << L"Unable to read \"" << m.getName() << L"\"; no such type \"" << typeName << L"\"." << Endl;
-						return;
-					}
-
-					m_typeReadCache.push_back(type);
-				}
-
-				T_ASSERT(type);
-
-				object = checked_type_cast< ISerializable* >(type->createInstance());
-				if (!ensure(object != 0))
-				{
-					log::error << L"Unable to read \"" << m.getName() << L"\"; unable to create type \"" << type->getName() << L"\"." << Endl;
-					return;
-				}
-
-				Serializer::dataVersionMap_t dataVersions;
-
-				// Outer most version, mandatory and no type needed.
-				if (!ensure(read_primitive< int16_t >(m_stream, version)))
-				{
-					log::error << L"Unable to read \"" << m.getName() << L"\"; unable to read version." << Endl;
-					return;
-				}
-				dataVersions.insert(std::make_pair(type, version));
-
-				// Read base versions.
-				uint16_t baseVersionCount = 0;
-				if (!ensure(read_primitive< uint16_t >(m_stream, baseVersionCount)))
-				{
-					log::error << L"Unable to read \"" << m.getName() << L"\"; unable to read # of base versions." << Endl;
-					return;
-				}
-
-				for (uint16_t i = 0; i < baseVersionCount; ++i)
-				{
-					if (!ensure(read_primitive< uint32_t >(m_stream, typeHashOrLen)))
-					{
-						log::error << L"Unable to read \"" << m.getName() << L"\"; unable to read base type hash." << Endl;
-						return;
-					}
-
-					const TypeInfo* baseType;
-					if ((typeHashOrLen & 0x80000000) == 0x80000000)
-						baseType = m_typeReadCache[typeHashOrLen & 0x7fffffff];
-					else
-					{
-						std::wstring typeName;
-						if (!ensure(read_string(m_stream, typeHashOrLen, typeName)))
-						{
-							log::error << L"Unable to read \"" << m.getName() << L"\"; unable to read base type." << Endl;
-							return;
-						}
-
-						baseType = TypeInfo::find(typeName.c_str());
-						if (!ensure(baseType != nullptr))
-						{
-							log::error << L"Unable to read \"" << m.getName() << L"\"; no such base type \"" << typeName << L"\"." << Endl;
-							return;
-						}
+		m_readDepth++;
+		readSerializable(m);
 
-						m_typeReadCache.push_back(baseType);
-					}
-					T_ASSERT(baseType);
-
-					if (!ensure(read_primitive< int16_t >(m_stream, version)))
-					{
-						log::error << L"Unable to read \"" << m.getName() << L"\"; unable to read version of base type \"" << baseType->getName() << L"\"." << Endl;
-						return;
-					}
-
-					dataVersions.insert(std::make_pair(baseType, version));
-				}
-
-				serialize(object, dataVersions);
-
-				m_readCache[hash] = object;
-			}
-			else
-			{
-				object = static_cast< ISerializable* >(m_readCache[hash]);
-				if (!ensure(object != nullptr))
-				{
-					log::error << L"Unable to read \"" << m.getName() << L"\"; no such reference." << Endl;
-					return;
-				}
-			}
-		}
-
-		m = object;
+		// Update position of memory backed stream after each top level object.
+		if (--m_readDepth == 0)
+			syncStream();
 	}
 	else
 	{
@@ -782,12 +762,12 @@ void BinarySerializer::operator >> (const Member< ISerializable* >& m)
 		{
 			T_ASSERT(type_of(object).isInstantiable());
 
-			auto it = m_writeCache.find(object);
-			if (it != m_writeCache.end())
+			const uint64_t* cachedHash = m_writeCache.find(object);
+			if (cachedHash)
 			{
 				if (!write_primitive< bool >(m_stream, true))
 					return;
-				if (!write_primitive< uint64_t >(m_stream, it->second))
+				if (!write_primitive< uint64_t >(m_stream, *cachedHash))
 					return;
 			}
 			else
@@ -857,6 +837,146 @@ void BinarySerializer::operator >> (const Member< ISerializable* >& m)
 	}
 }
 
+void BinarySerializer::readSerializable(const Member< ISerializable* >& m)
+{
+	bool reference = false;
+	uint64_t hash = 0;
+
+	if (!ensure(read_primitive< bool >(m_reader, reference)))
+		return;
+	if (!ensure(read_primitive< uint64_t >(m_reader, hash)))
+		return;
+
+	Ref< ISerializable > object;
+
+	if (hash)
+	{
+		if (!reference)
+		{
+			uint32_t typeHashOrLen;
+			const TypeInfo* type;
+			int16_t version;
+
+			if (!ensure(read_primitive< uint32_t >(m_reader, typeHashOrLen)))
+			{
+				log::error << L"Unable to read \"" << m.getName() << L"\"; unable to read type hash." << Endl;
+				return;
+			}
+
+			if ((typeHashOrLen & 0x80000000) == 0x80000000)
+				type = m_typeReadCache[typeHashOrLen & 0x7fffffff];
+			else
+			{
+				std::wstring typeName;
+				if (!ensure(read_string(m_reader, typeHashOrLen, typeName)))
+				{
+					log::error << L"Unable to read \"" << m.getName() << L"\"; unable to read type." << Endl;
+					return;
+				}
+
+				type = TypeInfo::find(typeName.c_str());
+				if (!ensure(type != 0))
+				{
+					log::error << L"Unable to read \"" << m.getName() << L"\"; no such type \"" << typeName << L"\"." << Endl;
+					return;
+				}
+
+				m_typeReadCache.push_back(type);
+			}
+
+			T_ASSERT(type);
+
+			object = checked_type_cast< ISerializable* >(type->createInstance());
+			if (!ensure(object != 0))
+			{
+				log::error << L"Unable to read \"" << m.getName() << L"\"; unable to create type \"" << type->getName() << L"\"." << Endl;
+				return;
+			}
+
+			Serializer::dataVersionMap_t dataVersions;
+
+			// Outer most version, mandatory and no type needed.
+			if (!ensure(read_primitive< int16_t >(m_reader, version)))
+			{
+				log::error << L"Unable to read \"" << m.getName() << L"\"; unable to read version." << Endl;
+				return;
+			}
+			dataVersions.insert(std::make_pair(type, version));
+
+			// Read base versions.
+			uint16_t baseVersionCount = 0;
+			if (!ensure(read_primitive< uint16_t >(m_reader, baseVersionCount)))
+			{
+				log::error << L"Unable to read \"" << m.getName() << L"\"; unable to read # of base versions." << Endl;
+				return;
+			}
+
+			for (uint16_t i = 0; i < baseVersionCount; ++i)
+			{
+				if (!ensure(read_primitive< uint32_t >(m_reader, typeHashOrLen)))
+				{
+					log::error << L"Unable to read \"" << m.getName() << L"\"; unable to read base type hash." << Endl;
+					return;
+				}
+
+				const TypeInfo* baseType;
+				if ((typeHashOrLen & 0x80000000) == 0x80000000)
+					baseType = m_typeReadCache[typeHashOrLen & 0x7fffffff];
+				else
+				{
+					std::wstring typeName;
+					if (!ensure(read_string(m_reader, typeHashOrLen, typeName)))
+					{
+						log::error << L"Unable to read \"" << m.getName() << L"\"; unable to read base type." << Endl;
+						return;
+					}
+
+					baseType = TypeInfo::find(typeName.c_str());
+					if (!ensure(baseType != nullptr))
+					{
+						log::error << L"Unable to read \"" << m.getName() << L"\"; no such base type \"" << typeName << L"\"." << Endl;
+						return;
+					}
+
+					m_typeReadCache.push_back(baseType);
+				}
+				T_ASSERT(baseType);
+
+				if (!ensure(read_primitive< int16_t >(m_reader, version)))
+				{
+					log::error << L"Unable to read \"" << m.getName() << L"\"; unable to read version of base type \"" << baseType->getName() << L"\"." << Endl;
+					return;
+				}
+
+				dataVersions.insert(std::make_pair(baseType, version));
+			}
+
+			serialize(object, dataVersions);
+
+			m_readCache[hash] = object;
+		}
+		else
+		{
+			const Ref< ISerializable >* cached = m_readCache.find(hash);
+			if (cached)
+				object = *cached;
+			if (!ensure(object != nullptr))
+			{
+				log::error << L"Unable to read \"" << m.getName() << L"\"; no such reference." << Endl;
+				return;
+			}
+		}
+	}
+
+	m = object;
+}
+
+void BinarySerializer::syncStream()
+{
+	if (m_stream && m_readBase)
+		m_stream->seek(IStream::SeekSet, (int64_t)(m_reader.ptr - m_readBase));
+}
+
 void BinarySerializer::operator >> (const Member< void* >& m)
 {
 	T_CHECK_STATUS;
@@ -865,14 +985,14 @@ void BinarySerializer::operator >> (const Member< void* >& m)
 	{
 		uint32_t size;
 
-		if (!ensure(read_primitive< uint32_t >(m_stream, size)))
+		if (!ensure(read_primitive< uint32_t >(m_reader, size)))
 			return;
 
 		if (!ensure(m.setBlobSize(size)))
 			return;
 
 		if (size > 0)
-			read_block(m_stream, m.getBlob(), size, 1);
+			read_block(m_reader, m.getBlob(), size, 1);
 	}
 	else
 	{
@@ -894,10 +1014,21 @@ void BinarySerializer::operator >> (const MemberArray& m)
 	{
 		uint32_t size;
 
-		if (!ensure(read_primitive< uint32_t >(m_stream, size)))
+		if (!ensure(read_primitive< uint32_t >(m_reader, size)))
 			return;
 
 		m.reserve(size, size);
+
+		// Read plain data elements as a single block.
+		size_t elementSize = 0, primitiveSize = 0;
+		void* data = (size > 0) ? m.getPlainData(elementSize, primitiveSize) : nullptr;
+		if (data)
+		{
+			const int64_t count = (int64_t)(size * (elementSize / primitiveSize));
+			ensure(read_block(m_reader, data, count, (int)primitiveSize));
+			return;
+		}
+
 		for (uint32_t i = 0; i < size; ++i)
 		{
 			T_CHECK_STATUS;
@@ -911,6 +1042,16 @@ void BinarySerializer::operator >> (const MemberArray& m)
 		if (!ensure(write_primitive< uint32_t >(m_stream, size)))
 			return;
 
+		// Write plain data elements as a single block.
+		size_t elementSize = 0, primitiveSize = 0;
+		const void* data = (size > 0) ? m.getPlainData(elementSize, primitiveSize) : nullptr;
+		if (data)
+		{
+			const int64_t count = (int64_t)(size * (elementSize / primitiveSize));
+			ensure(write_block(m_stream, data, count, (int)primitiveSize));
+			return;
+		}
+
 		for (uint32_t i = 0; i < size; ++i)
 		{
 			T_CHECK_STATUS;
@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include "Core/Containers/HashMap.h"
 #include "Core/Containers/SmallMap.h"
 #include "Core/Ref.h"
 #include "Core/Serialization/Serializer.h"
@@ -27,6 +28,12 @@ class IStream;
 
 /*! Binary serializer.
  * \ingroup Core
+ *
+ * When reading from a MemoryStream, or a read-only
+ * DynamicMemoryStream, data is read directly from the
+ * stream's buffer; the stream's position is then updated
+ * after each top level object and when the serializer
+ * is destroyed.
  */
 class T_DLLCLASS BinarySerializer : public Serializer
 {
@@ -35,6 +42,15 @@ class T_DLLCLASS BinarySerializer : public Serializer
 public:
 	explicit BinarySerializer(IStream* stream);
 
+	/*! Read directly from memory, such as a mapped file.
+	 *
+	 * \param buffer Pointer to serialized data, must be kept alive while serializer is used.
+	 * \param bufferSize Size of serialized data in bytes.
+	 */
+	explicit BinarySerializer(const void* buffer, int64_t bufferSize);
+
+	virtual ~BinarySerializer();
+
 	virtual Direction getDirection() const override final;
 
 	virtual void operator>>(const Member< bool >& m) override final;
@@ -94,14 +110,33 @@ public:
 	virtual void operator>>(const MemberEnumBase& m) override final;
 
 private:
+	/*! Read either from memory or through stream. */
+	struct Reader
+	{
+		IStream* stream = nullptr;
+		const uint8_t* ptr = nullptr;
+		const uint8_t* end = nullptr;
+
+		int64_t read(void* block, int64_t nbytes);
+
+		const uint8_t* acquire(int64_t nbytes);
+	};
+
 	Ref< IStream > m_stream;
 	Direction m_direction;
-	SmallMap< uint64_t, Ref< ISerializable > > m_readCache;
-	SmallMap< ISerializable*, uint64_t > m_writeCache;
+	Reader m_reader;
+	const uint8_t* m_readBase = nullptr;
+	int32_t m_readDepth = 0;
+	HashMap< uint64_t, Ref< ISerializable > > m_readCache;
+	HashMap< ISerializable*, uint64_t > m_writeCache;
 	uint64_t m_nextCacheId;
 	AlignedVector< const TypeInfo* > m_typeReadCache;
 	SmallMap< const TypeInfo*, uint32_t > m_typeWriteCache;
 	uint32_t m_nextTypeCacheId;
+
+	void readSerializable(const Member< ISerializable* >& m);
+
+	void syncStream();
 };
 
 }
@@ -16,9 +16,49 @@
 namespace traktor
 {
 
+class Color4ub;
+class Vector2;
+class Vector4;
+
 /*! \ingroup Core */
 //@{
 
+/*! Plain data layout of value member.
+ *
+ * Specialized for value members which are serialized
+ * as a sequence of primitives of equal size.
+ */
+template < typename ValueMember >
+struct PlainMember
+{
+	constexpr static size_t serializedSize = 0;
+	constexpr static size_t primitiveSize = 0;
+};
+
+#define T_PLAIN_MEMBER(ValueType, PrimitiveType, PrimitiveCount) \
+	template < > \
+	struct PlainMember< Member< ValueType > > \
+	{ \
+		constexpr static size_t serializedSize = sizeof(PrimitiveType) * PrimitiveCount; \
+		constexpr static size_t primitiveSize = sizeof(PrimitiveType); \
+	};
+
+T_PLAIN_MEMBER(int8_t, int8_t, 1)
+T_PLAIN_MEMBER(uint8_t, uint8_t, 1)
+T_PLAIN_MEMBER(int16_t, int16_t, 1)
+T_PLAIN_MEMBER(uint16_t, uint16_t, 1)
+T_PLAIN_MEMBER(int32_t, int32_t, 1)
+T_PLAIN_MEMBER(uint32_t, uint32_t, 1)
+T_PLAIN_MEMBER(int64_t, int64_t, 1)
+T_PLAIN_MEMBER(uint64_t, uint64_t, 1)
+T_PLAIN_MEMBER(float, float, 1)
+T_PLAIN_MEMBER(double, double, 1)
+T_PLAIN_MEMBER(Color4ub, uint8_t, 4)
+T_PLAIN_MEMBER(Vector2, float, 2)
+T_PLAIN_MEMBER(Vector4, float, 4)
+
+#undef T_PLAIN_MEMBER
+
 /*! Aligned vector member. */
 template < typename ValueType, typename ValueMember = Member< ValueType > >
 class MemberAlignedVector : public MemberArray
@@ -74,6 +114,18 @@ public:
 		return true;
 	}
 
+	virtual void* getPlainData(size_t& outElementSize, size_t& outPrimitiveSize) const override final
+	{
+		if constexpr (PlainMember< ValueMember >::serializedSize == sizeof(ValueType))
+		{
+			outElementSize = sizeof(ValueType);
+			outPrimitiveSize = PlainMember< ValueMember >::primitiveSize;
+			return m_ref.ptr();
+		}
+		else
+			return nullptr;
+	}
+
 private:
 	value_type& m_ref;
 	mutable size_t m_index;
@@ -69,6 +69,19 @@ public:
 	/*! Insert default element, used by property list to add new elements. */
 	virtual bool insert() const = 0;
 
+	/*! Get elements as a contiguous block of plain data.
+	 *
+	 * Binary serializers use this to read or write all
+	 * elements at once instead of one at a time; only
+	 * applicable when memory layout of each element is
+	 * identical to its serialized form.
+	 *
+	 * \param outElementSize Size of each element in bytes.
+	 * \param outPrimitiveSize Size of primitives which each element is composed of, used for endian swapping.
+	 * \return Pointer to first element, null if elements must be serialized individually.
+	 */
+	virtual void* getPlainData(size_t& outElementSize, size_t& outPrimitiveSize) const { return nullptr; }
+
 protected:
 	/*! Set attributes member. */
 	void setAttributes(const Attribute* attributes);
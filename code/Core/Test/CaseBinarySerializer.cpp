@@ -0,0 +1,262 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/RefArray.h"
+#include "Core/Guid.h"
+#include "Core/Io/BufferedStream.h"
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Io/MemoryStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/Vector2.h"
+#include "Core/Math/Vector4.h"
+#include "Core/Misc/String.h"
+#include "Core/Serialization/BinarySerializer.h"
+#include "Core/Serialization/ISerializable.h"
+#include "Core/Serialization/Member.h"
+#include "Core/Serialization/MemberAlignedVector.h"
+#include "Core/Serialization/MemberRef.h"
+#include "Core/Serialization/MemberRefArray.h"
+#include "Core/Test/CaseBinarySerializer.h"
+#include "Core/Timer/Timer.h"
+
+namespace traktor::test
+{
+
+class BinarySerializer_Mesh : public ISerializable
+{
+	T_RTTI_CLASS;
+
+public:
+	AlignedVector< Vector4 > positions;
+	AlignedVector< Vector2 > texCoords;
+	AlignedVector< uint32_t > indices;
+	AlignedVector< float > weights;
+
+	virtual void serialize(ISerializer& s) override
+	{
+		s >> MemberAlignedVector< Vector4 >(L"positions", positions);
+		s >> MemberAlignedVector< Vector2 >(L"texCoords", texCoords);
+		s >> MemberAlignedVector< uint32_t >(L"indices", indices);
+		s >> MemberAlignedVector< float >(L"weights", weights);
+	}
+};
+
+class BinarySerializer_Entity : public ISerializable
+{
+	T_RTTI_CLASS;
+
+public:
+	Guid id;
+	std::wstring name;
+	Vector4 translation = Vector4::zero();
+	Vector4 rotation = Vector4::zero();
+	bool visible = false;
+	Ref< BinarySerializer_Mesh > mesh;
+	RefArray< BinarySerializer_Entity > children;
+
+	virtual void serialize(ISerializer& s) override
+	{
+		s >> Member< Guid >(L"id", id);
+		s >> Member< std::wstring >(L"name", name);
+		s >> Member< Vector4 >(L"translation", translation);
+		s >> Member< Vector4 >(L"rotation", rotation);
+		s >> Member< bool >(L"visible", visible);
+		s >> MemberRef< BinarySerializer_Mesh >(L"mesh", mesh);
+		s >> MemberRefArray< BinarySerializer_Entity >(L"children", children);
+	}
+};
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseBinarySerializer.BinarySerializer_Mesh", 0, BinarySerializer_Mesh, ISerializable)
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseBinarySerializer.BinarySerializer_Entity", 0, BinarySerializer_Entity, ISerializable)
+
+	namespace
+	{
+
+const int32_t c_entityCount = 50000;
+const int32_t c_vertexCount = 200000;
+
+Ref< BinarySerializer_Mesh > createMesh(int32_t vertexCount)
+{
+	Ref< BinarySerializer_Mesh > mesh = new BinarySerializer_Mesh();
+	for (int32_t i = 0; i < vertexCount; ++i)
+	{
+		mesh->positions.push_back(Vector4(float(i), float(i + 1), float(i + 2), 1.0f));
+		mesh->texCoords.push_back(Vector2(float(i) * 0.5f, float(i) * 0.25f));
+		mesh->indices.push_back(uint32_t(vertexCount - i - 1));
+		mesh->weights.push_back(float(i) / vertexCount);
+	}
+	return mesh;
+}
+
+/*! Create a flat hierarchy of entities, all sharing same mesh. */
+Ref< BinarySerializer_Entity > createScene(int32_t entityCount, BinarySerializer_Mesh* mesh)
+{
+	Ref< BinarySerializer_Entity > root = new BinarySerializer_Entity();
+	root->id = Guid::create();
+	root->name = L"Root åäö";
+
+	BinarySerializer_Entity* parent = root;
+	for (int32_t i = 0; i < entityCount; ++i)
+	{
+		Ref< BinarySerializer_Entity > entity = new BinarySerializer_Entity();
+		entity->id = Guid::create();
+		entity->name = L"Entity_" + toString(i);
+		entity->translation = Vector4(float(i), 0.0f, 0.0f, 1.0f);
+		entity->rotation = Vector4(0.0f, 0.0f, 0.0f, 1.0f);
+		entity->visible = (i & 1) != 0;
+		entity->mesh = mesh;
+		parent->children.push_back(entity);
+
+		// Nest a few levels to exercise recursion.
+		if ((i % 1000) == 999)
+			parent = entity;
+	}
+	return root;
+}
+
+int32_t countEntities(const BinarySerializer_Entity* entity)
+{
+	int32_t count = 1;
+	for (auto child : entity->children)
+		count += countEntities(child);
+	return count;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseBinarySerializer", 0, CaseBinarySerializer, Case)
+
+void CaseBinarySerializer::run()
+{
+	// Array of plain data and strings; compare read from memory and through stream.
+	{
+		Ref< BinarySerializer_Mesh > mesh = createMesh(1003);
+		Ref< BinarySerializer_Entity > entity = new BinarySerializer_Entity();
+		entity->name = L"Entity åäö €";
+		entity->mesh = mesh;
+
+		Ref< BinarySerializer_Entity > child = new BinarySerializer_Entity();
+		child->mesh = mesh;
+		entity->children.push_back(child);
+
+		DynamicMemoryStream wms(false, true);
+		CASE_ASSERT(BinarySerializer(&wms).writeObject(entity));
+
+		const AlignedVector< uint8_t >& buffer = wms.getBuffer();
+
+		MemoryStream rms(buffer.c_ptr(), buffer.size());
+		Ref< BinarySerializer_Entity > memoryEntity = BinarySerializer(&rms).readObject< BinarySerializer_Entity >();
+		CASE_ASSERT_EQUAL(rms.tell(), (int64_t)buffer.size());
+
+		MemoryStream sms(buffer.c_ptr(), buffer.size());
+		BufferedStream bs(&sms);
+		Ref< BinarySerializer_Entity > streamEntity = BinarySerializer(&bs).readObject< BinarySerializer_Entity >();
+
+		for (auto readEntity : { memoryEntity, streamEntity })
+		{
+			CASE_ASSERT_NOT_EQUAL(readEntity, nullptr);
+			if (!readEntity)
+				continue;
+
+			CASE_ASSERT_EQUAL(readEntity->name, entity->name);
+			CASE_ASSERT_EQUAL(readEntity->children.size(), 1);
+			CASE_ASSERT_NOT_EQUAL(readEntity->mesh, nullptr);
+			if (readEntity->children.size() != 1 || !readEntity->mesh)
+				continue;
+
+			// Shared mesh must be read as a reference.
+			CASE_ASSERT(readEntity->children[0]->mesh == readEntity->mesh);
+
+			const BinarySerializer_Mesh* readMesh = readEntity->mesh;
+			CASE_ASSERT_EQUAL(readMesh->positions.size(), mesh->positions.size());
+			CASE_ASSERT_EQUAL(readMesh->weights.size(), mesh->weights.size());
+			if (readMesh->positions.size() != mesh->positions.size() || readMesh->weights.size() != mesh->weights.size())
+				continue;
+
+			uint32_t errors = 0;
+			for (uint32_t i = 0; i < mesh->positions.size(); ++i)
+			{
+				if (
+					readMesh->positions[i] != mesh->positions[i] ||
+					readMesh->texCoords[i].x != mesh->texCoords[i].x ||
+					readMesh->texCoords[i].y != mesh->texCoords[i].y ||
+					readMesh->indices[i] != mesh->indices[i] ||
+					readMesh->weights[i] != mesh->weights[i]
+				)
+					errors++;
+			}
+			CASE_ASSERT_EQUAL(errors, 0);
+		}
+	}
+
+	// Consecutive objects in same memory stream.
+	{
+		Ref< BinarySerializer_Entity > first = new BinarySerializer_Entity();
+		first->name = L"First";
+		Ref< BinarySerializer_Entity > second = new BinarySerializer_Entity();
+		second->name = L"Second";
+
+		DynamicMemoryStream wms(false, true);
+		CASE_ASSERT(BinarySerializer(&wms).writeObject(first));
+		CASE_ASSERT(BinarySerializer(&wms).writeObject(second));
+
+		DynamicMemoryStream rms(wms.getBuffer(), true, false);
+		Ref< BinarySerializer_Entity > readFirst = BinarySerializer(&rms).readObject< BinarySerializer_Entity >();
+		Ref< BinarySerializer_Entity > readSecond = BinarySerializer(&rms).readObject< BinarySerializer_Entity >();
+		CASE_ASSERT(readFirst && readFirst->name == L"First");
+		CASE_ASSERT(readSecond && readSecond->name == L"Second");
+	}
+
+	// Truncated data must fail gracefully.
+	{
+		Ref< BinarySerializer_Entity > entity = new BinarySerializer_Entity();
+		entity->name = L"Truncated";
+		entity->mesh = createMesh(100);
+
+		DynamicMemoryStream wms(false, true);
+		CASE_ASSERT(BinarySerializer(&wms).writeObject(entity));
+
+		const AlignedVector< uint8_t >& buffer = wms.getBuffer();
+		Ref< ISerializable > object = BinarySerializer(buffer.c_ptr(), buffer.size() / 2).readObject();
+		CASE_ASSERT(object == nullptr);
+	}
+
+	// Measure read of large mesh and large scene.
+	{
+		Ref< BinarySerializer_Mesh > mesh = createMesh(c_vertexCount);
+		Ref< BinarySerializer_Entity > scene = createScene(c_entityCount, mesh);
+
+		DynamicMemoryStream wms(false, true);
+		CASE_ASSERT(BinarySerializer(&wms).writeObject(scene));
+
+		const AlignedVector< uint8_t >& buffer = wms.getBuffer();
+		const int32_t objectCount = countEntities(scene) + 1;
+
+		Timer timer;
+
+		double start = timer.getElapsedTime();
+		MemoryStream sms(buffer.c_ptr(), buffer.size());
+		BufferedStream bs(&sms);
+		Ref< BinarySerializer_Entity > streamScene = BinarySerializer(&bs).readObject< BinarySerializer_Entity >();
+		const double streamTime = timer.getElapsedTime() - start;
+
+		start = timer.getElapsedTime();
+		Ref< BinarySerializer_Entity > memoryScene = BinarySerializer(buffer.c_ptr(), buffer.size()).readObject< BinarySerializer_Entity >();
+		const double memoryTime = timer.getElapsedTime() - start;
+
+		CASE_ASSERT(streamScene && countEntities(streamScene) == objectCount - 1);
+		CASE_ASSERT(memoryScene && countEntities(memoryScene) == objectCount - 1);
+
+		log::info << L"Binary read, " << objectCount << L" object(s), " << (int32_t)(buffer.size() / 1024) << L" KiB;" << Endl;
+		log::info << L"  stream " << streamTime * 1000.0 << L" ms, " << (int32_t)(objectCount / streamTime) << L" objects/s" << Endl;
+		log::info << L"  memory " << memoryTime * 1000.0 << L" ms, " << (int32_t)(objectCount / memoryTime) << L" objects/s" << Endl;
+	}
+}
+
+}
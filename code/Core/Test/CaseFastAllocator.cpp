@@ -0,0 +1,123 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include "Core/Memory/FastAllocator.h"
+#include "Core/Memory/MemoryConfig.h"
+#include "Core/Memory/StdAllocator.h"
+#include "Core/Test/CaseFastAllocator.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+
+namespace traktor::test
+{
+	namespace
+	{
+
+const int32_t c_threadCount = 8;
+const int32_t c_allocCount = 4096;
+
+std::atomic< int32_t > g_errors;
+void* g_blocks[c_threadCount][c_allocCount];
+
+void threadAlloc(FastAllocator* allocator, int32_t index)
+{
+	for (int32_t i = 0; i < c_allocCount; ++i)
+	{
+		const size_t size = 1 + (i * 7) % 600;
+		uint8_t* p = (uint8_t*)allocator->alloc(size, 16, T_FILE_LINE);
+		std::memset(p, uint8_t(index), size);
+		g_blocks[index][i] = p;
+	}
+	for (int32_t i = 0; i < c_allocCount; ++i)
+	{
+		const size_t size = 1 + (i * 7) % 600;
+		const uint8_t* p = (const uint8_t*)g_blocks[index][i];
+		for (size_t j = 0; j < size; ++j)
+		{
+			if (p[j] != uint8_t(index))
+			{
+				g_errors++;
+				break;
+			}
+		}
+	}
+}
+
+void threadFree(FastAllocator* allocator, int32_t index)
+{
+	// Free blocks allocated by another thread.
+	const int32_t other = (index + 1) % c_threadCount;
+	for (int32_t i = 0; i < c_allocCount; ++i)
+		allocator->free(g_blocks[other][i]);
+}
+
+void runThreads(FastAllocator* allocator, void (*fn)(FastAllocator*, int32_t))
+{
+	Thread* threads[c_threadCount] = { nullptr };
+	for (int32_t i = 0; i < c_threadCount; ++i)
+	{
+		threads[i] = ThreadManager::getInstance().create([=](){ fn(allocator, i); }, L"Fast allocator test");
+		threads[i]->start();
+	}
+	for (int32_t i = 0; i < c_threadCount; ++i)
+	{
+		threads[i]->wait();
+		ThreadManager::getInstance().destroy(threads[i]);
+	}
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseFastAllocator", 0, CaseFastAllocator, Case)
+
+void CaseFastAllocator::run()
+{
+	StdAllocator systemAllocator;
+	FastAllocator* allocator = new FastAllocator(&systemAllocator);
+
+	g_errors = 0;
+
+	// Allocate and verify blocks doesn't overlap.
+	runThreads(allocator, &threadAlloc);
+	CASE_ASSERT_EQUAL((int32_t)g_errors, 0);
+
+	// Free blocks from other threads than they where allocated.
+	runThreads(allocator, &threadFree);
+
+	// Allocate again, blocks must have been returned.
+	runThreads(allocator, &threadAlloc);
+	CASE_ASSERT_EQUAL((int32_t)g_errors, 0);
+	runThreads(allocator, &threadFree);
+
+	// Every small allocation must be accounted for in one of the counters.
+	FastAllocatorStatistics statistics;
+	allocator->getStatistics(statistics);
+
+	uint64_t total = 0;
+	for (const auto& sc : statistics.sizeClasses)
+	{
+		CASE_ASSERT(sc.blockSize > 0);
+		CASE_ASSERT(sc.blockCount > 0);
+		total += sc.hits + sc.misses + sc.fallbacks;
+	}
+
+	uint64_t expected = 0;
+	for (int32_t i = 0; i < c_allocCount; ++i)
+	{
+		if (1 + (i * 7) % 600 <= 512)
+			expected++;
+	}
+	expected *= 2 * c_threadCount;
+
+	CASE_ASSERT_EQUAL(total, expected);
+
+	delete allocator;
+}
+
+}
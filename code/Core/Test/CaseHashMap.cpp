@@ -0,0 +1,140 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <map>
+#include "Core/Guid.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Containers/SmallMap.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/Random.h"
+#include "Core/Test/CaseHashMap.h"
+#include "Core/Timer/Timer.h"
+
+namespace traktor::test
+{
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseHashMap", 0, CaseHashMap, Case)
+
+void CaseHashMap::run()
+{
+	// Random inserts and removes compared to std::map.
+	{
+		std::map< uint32_t, uint32_t > m0;
+		HashMap< uint32_t, uint32_t > m1;
+
+		Random rnd;
+		uint32_t mismatches = 0;
+		for (uint32_t i = 0; i < 200000; ++i)
+		{
+			const uint32_t key = uint32_t(rnd.nextFloat() * 8191);
+			if (rnd.nextFloat() < 0.6f)
+			{
+				const bool inserted0 = m0.insert(std::make_pair(key, i)).second;
+				const bool inserted1 = m1.insert(key, i);
+				if (inserted0 != inserted1)
+					++mismatches;
+			}
+			else
+			{
+				const bool removed0 = (m0.erase(key) != 0);
+				const bool removed1 = m1.remove(key);
+				if (removed0 != removed1)
+					++mismatches;
+			}
+		}
+		CASE_ASSERT_EQUAL(mismatches, 0);
+		CASE_ASSERT_EQUAL(m0.size(), m1.size());
+
+		for (uint32_t key = 0; key < 8192; ++key)
+		{
+			const auto it = m0.find(key);
+			const uint32_t* item = m1.find(key);
+			if ((it != m0.end()) != (item != nullptr))
+				++mismatches;
+			else if (item != nullptr && it->second != *item)
+				++mismatches;
+		}
+		CASE_ASSERT_EQUAL(mismatches, 0);
+
+		size_t iterated = 0;
+		for (const auto& it : m1)
+		{
+			if (m0.find(it.first) == m0.end())
+				++mismatches;
+			++iterated;
+		}
+		CASE_ASSERT_EQUAL(mismatches, 0);
+		CASE_ASSERT_EQUAL(iterated, m0.size());
+	}
+
+	// Insert and lookup of large guid set, as used by database instance map.
+	{
+		const uint32_t count = 500000;
+
+		AlignedVector< Guid > guids(count);
+		for (uint32_t i = 0; i < count; ++i)
+			guids[i] = Guid::create();
+
+		Timer timer;
+
+		HashMap< Guid, uint32_t > m0;
+		const double insertStart = timer.getElapsedTime();
+		for (uint32_t i = 0; i < count; ++i)
+			m0[guids[i]] = i;
+		const double insertTime = timer.getElapsedTime() - insertStart;
+		CASE_ASSERT_EQUAL(m0.size(), (size_t)count);
+
+		// Small map built from sorted keys since random insertion is quadratic.
+		AlignedVector< Guid > sorted = guids;
+		std::sort(sorted.begin(), sorted.end());
+		SmallMap< Guid, uint32_t > m1;
+		m1.reserve(count);
+		for (uint32_t i = 0; i < count; ++i)
+			m1.insert(sorted[i], i);
+
+		uint32_t hit0 = 0;
+		const double lookupStart0 = timer.getElapsedTime();
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const uint32_t* item = m0.find(guids[i]);
+			if (item && *item == i)
+				++hit0;
+		}
+		const double lookupTime0 = timer.getElapsedTime() - lookupStart0;
+		CASE_ASSERT_EQUAL(hit0, count);
+
+		uint32_t hit1 = 0;
+		const double lookupStart1 = timer.getElapsedTime();
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (m1.find(guids[i]) != m1.end())
+				++hit1;
+		}
+		const double lookupTime1 = timer.getElapsedTime() - lookupStart1;
+		CASE_ASSERT_EQUAL(hit1, count);
+
+		uint32_t mismatches = 0;
+		for (uint32_t i = 0; i < count; i += 2)
+		{
+			if (!m0.remove(guids[i]))
+				++mismatches;
+		}
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if ((m0.find(guids[i]) != nullptr) != ((i & 1) != 0))
+				++mismatches;
+		}
+		CASE_ASSERT_EQUAL(mismatches, 0);
+		CASE_ASSERT_EQUAL(m0.size(), (size_t)count / 2);
+
+		log::info << L"Hash map, " << count << L" guids; insert " << int32_t(insertTime * 1000.0) << L" ms, lookup " << int32_t(lookupTime0 * 1e9 / count) << L" ns (small map " << int32_t(lookupTime1 * 1e9 / count) << L" ns)" << Endl;
+	}
+}
+
+}
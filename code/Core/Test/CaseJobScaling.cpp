@@ -0,0 +1,106 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cmath>
+#include "Core/RefArray.h"
+#include "Core/Log/Log.h"
+#include "Core/System/OS.h"
+#include "Core/Test/CaseJobScaling.h"
+#include "Core/Thread/JobQueue.h"
+#include "Core/Timer/Timer.h"
+
+namespace traktor::test
+{
+	namespace
+	{
+
+const int32_t c_taskCount = 1024;
+const int32_t c_forkIterations = 100;
+const int32_t c_detachedCount = 20000;
+
+std::atomic< int32_t > g_executed;
+
+void work(int32_t index)
+{
+	float acc = 0.0f;
+	for (int32_t i = 0; i < 200; ++i)
+		acc += std::sqrt(float(index + i));
+	if (acc >= 0.0f)
+		g_executed++;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseJobScaling", 0, CaseJobScaling, Case)
+
+void CaseJobScaling::run()
+{
+	const uint32_t coreCount = std::max< uint32_t >(OS::getInstance().getCPUCoreCount(), 4);
+
+	Job::task_t tasks[c_taskCount];
+	for (int32_t i = 0; i < c_taskCount; ++i)
+		tasks[i] = [=](){ work(i); };
+
+	for (uint32_t workerCount = 1; workerCount <= coreCount; workerCount *= 2)
+	{
+		JobQueue queue;
+		if (!queue.create(workerCount, Thread::Normal))
+		{
+			CASE_ASSERT(false);
+			return;
+		}
+
+		Timer timer;
+
+		// Fork many small tasks from caller thread.
+		g_executed = 0;
+		const double forkStart = timer.getElapsedTime();
+		for (int32_t i = 0; i < c_forkIterations; ++i)
+			queue.fork(tasks, c_taskCount);
+		const double forkTime = timer.getElapsedTime() - forkStart;
+		CASE_ASSERT_EQUAL((int32_t)g_executed, c_forkIterations * c_taskCount);
+
+		// Add fire-and-forget tasks one by one and then wait.
+		g_executed = 0;
+		const double detachedStart = timer.getElapsedTime();
+		for (int32_t i = 0; i < c_detachedCount; ++i)
+			queue.addDetached([=](){ work(i); });
+		CASE_ASSERT(queue.wait());
+		const double detachedTime = timer.getElapsedTime() - detachedStart;
+		CASE_ASSERT_EQUAL((int32_t)g_executed, c_detachedCount);
+
+		// Nested forks from within jobs, workers must help while waiting.
+		g_executed = 0;
+		const double nestedStart = timer.getElapsedTime();
+		{
+			Job::task_t outer[16];
+			for (int32_t i = 0; i < 16; ++i)
+				outer[i] = [&](){ queue.fork(tasks, 64); };
+			queue.fork(outer, 16);
+		}
+		const double nestedTime = timer.getElapsedTime() - nestedStart;
+		CASE_ASSERT_EQUAL((int32_t)g_executed, 16 * 64);
+
+		// Wait on job handles, unclaimed jobs are executed by the waiter.
+		RefArray< Job > jobs;
+		g_executed = 0;
+		for (int32_t i = 0; i < 256; ++i)
+			jobs.push_back(queue.add([=](){ work(i); }));
+		for (auto job : jobs)
+			CASE_ASSERT(job->wait());
+		CASE_ASSERT_EQUAL((int32_t)g_executed, 256);
+		jobs.clear();
+
+		log::info << L"Job scaling, " << workerCount << L" worker(s); fork " << int32_t(forkTime * 1000.0) << L" ms, detached " << int32_t(detachedTime * 1000.0) << L" ms, nested " << int32_t(nestedTime * 1000.0) << L" ms" << Endl;
+
+		queue.destroy();
+	}
+}
+
+}
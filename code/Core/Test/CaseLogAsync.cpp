@@ -0,0 +1,184 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Io/FileOutputStream.h"
+#include "Core/Io/Utf8Encoding.h"
+#include "Core/Log/Log.h"
+#include "Core/Log/LogAsyncTarget.h"
+#include "Core/Log/LogStreamTarget.h"
+#include "Core/Test/CaseLogAsync.h"
+#include "Core/Thread/Acquire.h"
+#include "Core/Thread/Semaphore.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Core/Timer/Timer.h"
+
+namespace traktor::test
+{
+	namespace
+	{
+
+const int32_t c_threadCount = 8;
+const int32_t c_lineCount = 20000;
+
+/*! Synchronous target, same as current console target, serialize each line. */
+class SyncTarget : public ILogTarget
+{
+public:
+	explicit SyncTarget(ILogTarget* target)
+	:	m_target(target)
+	{
+	}
+
+	virtual void log(uint32_t threadId, int32_t level, const wchar_t* str) override final
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		m_target->log(threadId, level, str);
+	}
+
+private:
+	Ref< ILogTarget > m_target;
+	Semaphore m_lock;
+};
+
+/*! Log lines from many threads concurrently, return elapsed time. */
+double logContended(ILogTarget* target, int32_t lineCount)
+{
+	LogStream stream(0, target);
+	Thread* threads[c_threadCount];
+
+	for (int32_t i = 0; i < c_threadCount; ++i)
+	{
+		threads[i] = ThreadManager::getInstance().create([&stream, lineCount, i](){
+			for (int32_t j = 0; j < lineCount; ++j)
+				stream << L"Thread " << i << L" line " << j << L" of some typical length" << Endl;
+		}, L"Log test");
+	}
+
+	Timer timer;
+	for (int32_t i = 0; i < c_threadCount; ++i)
+		threads[i]->start();
+	for (int32_t i = 0; i < c_threadCount; ++i)
+	{
+		threads[i]->wait();
+		ThreadManager::getInstance().destroy(threads[i]);
+	}
+	return timer.getElapsedTime();
+}
+
+/*! Verify every line has been written once, in order, for each thread. */
+bool verifyLines(const AlignedVector< uint8_t >& buffer, int32_t lineCount)
+{
+	int32_t next[c_threadCount] = { 0 };
+
+	const char* text = (const char*)buffer.c_ptr();
+	const char* end = text + buffer.size();
+	while (text < end)
+	{
+		const char* eol = (const char*)std::memchr(text, '\n', end - text);
+		if (!eol)
+			return false;
+
+		// Copy line as sscanf measure entire string.
+		char line[128] = { 0 };
+		std::memcpy(line, text, std::min< size_t >(eol - text, sizeof(line) - 1));
+
+		int32_t threadId, thread, index;
+		if (std::sscanf(line, "[%d] Thread %d line %d", &threadId, &thread, &index) != 3)
+			return false;
+		if (thread < 0 || thread >= c_threadCount || next[thread] != index)
+			return false;
+
+		next[thread]++;
+		text = eol + 1;
+	}
+
+	for (int32_t i = 0; i < c_threadCount; ++i)
+	{
+		if (next[i] != lineCount)
+			return false;
+	}
+	return true;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseLogAsync", 0, CaseLogAsync, Case)
+
+void CaseLogAsync::run()
+{
+	// Small rings to force wrapping and blocking; all lines must be written in order.
+	{
+		AlignedVector< uint8_t > buffer;
+		{
+			Ref< LogAsyncTarget > target = new LogAsyncTarget(false, new DynamicMemoryStream(buffer, false, true), LogAsyncTarget::Overflow::Block, 4096);
+			logContended(target, 5000);
+			CASE_ASSERT_EQUAL(target->getDropped(), 0);
+		}
+		CASE_ASSERT(verifyLines(buffer, 5000));
+	}
+
+	// Text should be encoded as UTF-8.
+	{
+		AlignedVector< uint8_t > buffer;
+		Ref< LogAsyncTarget > target = new LogAsyncTarget(false, new DynamicMemoryStream(buffer, false, true));
+		target->log(1, 0, L"å€");
+		target->flush();
+
+		const uint8_t expected[] = { '[', ' ', ' ', ' ', ' ', '1', ']', ' ', 0xc3, 0xa5, 0xe2, 0x82, 0xac, '\n' };
+		CASE_ASSERT_EQUAL(buffer.size(), sizeof(expected));
+		CASE_ASSERT(buffer.size() == sizeof(expected) && std::memcmp(buffer.c_ptr(), expected, sizeof(expected)) == 0);
+	}
+
+	// Lines are either written or dropped when ring is full.
+	{
+		AlignedVector< uint8_t > buffer;
+		uint32_t dropped = 0;
+		{
+			Ref< LogAsyncTarget > target = new LogAsyncTarget(false, new DynamicMemoryStream(buffer, false, true), LogAsyncTarget::Overflow::Drop, 1024);
+			for (int32_t i = 0; i < c_lineCount; ++i)
+				target->log(1, 0, L"Line which will probably be dropped");
+			dropped = target->getDropped();
+		}
+
+		uint32_t written = 0;
+		for (auto ch : buffer)
+			written += (ch == '\n') ? 1 : 0;
+
+		CASE_ASSERT(dropped > 0);
+		CASE_ASSERT_EQUAL(written + dropped, (uint32_t)c_lineCount);
+	}
+
+	// Benchmark contended logging, current synchronous file path against asynchronous.
+	{
+		AlignedVector< uint8_t > syncBuffer;
+		Ref< SyncTarget > syncTarget = new SyncTarget(new LogStreamTarget(new FileOutputStream(new DynamicMemoryStream(syncBuffer, false, true), new Utf8Encoding())));
+		const double syncTime = logContended(syncTarget, c_lineCount);
+
+		AlignedVector< uint8_t > asyncBuffer;
+		double asyncTime = 0.0, asyncFlushTime = 0.0;
+		{
+			Ref< LogAsyncTarget > asyncTarget = new LogAsyncTarget(false, new DynamicMemoryStream(asyncBuffer, false, true));
+			asyncTime = logContended(asyncTarget, c_lineCount);
+
+			Timer timer;
+			asyncTarget->flush();
+			asyncFlushTime = asyncTime + timer.getElapsedTime();
+		}
+		CASE_ASSERT(verifyLines(asyncBuffer, c_lineCount));
+
+		const int32_t lines = c_threadCount * c_lineCount;
+		log::info << L"Log, " << c_threadCount << L" threads, " << lines << L" lines; synchronous " << int32_t(syncTime * 1000.0) << L" ms, asynchronous " << int32_t(asyncTime * 1000.0) << L" ms (" << int32_t(asyncFlushTime * 1000.0) << L" ms until written)" << Endl;
+	}
+}
+
+}
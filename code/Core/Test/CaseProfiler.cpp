@@ -0,0 +1,85 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <string>
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Test/CaseProfiler.h"
+#include "Core/Thread/JobManager.h"
+#include "Core/Timer/Profiler.h"
+
+namespace traktor::test
+{
+	namespace
+	{
+
+int32_t countOf(const std::string& str, const std::string& pattern)
+{
+	int32_t count = 0;
+	for (size_t i = str.find(pattern); i != str.npos; i = str.find(pattern, i + 1))
+		++count;
+	return count;
+}
+
+void work(int32_t depth)
+{
+	T_PROFILER_SCOPE(L"CaseProfiler work");
+	if (depth > 0)
+		work(depth - 1);
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseProfiler", 0, CaseProfiler, Case)
+
+void CaseProfiler::run()
+{
+#if defined(T_PROFILER_ENABLE)
+	AlignedVector< uint8_t > buffer;
+	Ref< DynamicMemoryStream > stream = new DynamicMemoryStream(buffer, false, true);
+
+	CASE_ASSERT(Profiler::getInstance().beginCapture(stream));
+	CASE_ASSERT(Profiler::getInstance().isEnabled());
+
+	const uint32_t droppedBefore = Profiler::getInstance().getDroppedCount();
+
+	// Record nested scopes from several threads.
+	Job::task_t tasks[16];
+	for (int32_t i = 0; i < 16; ++i)
+		tasks[i] = [=](){ work(3); };
+	JobManager::getInstance().fork(tasks, sizeof_array(tasks));
+
+	// Scope deeper than max depth must still be balanced.
+	work(Profiler::MaxDepth + 4);
+
+	// Counters and dynamic names.
+	for (int32_t i = 0; i < 10; ++i)
+		T_PROFILER_COUNTER(L"CaseProfiler counter", i);
+
+	T_PROFILER_BEGIN(std::wstring(L"CaseProfiler dynamic ") + L"name");
+	T_PROFILER_END();
+
+	Profiler::getInstance().endCapture();
+	CASE_ASSERT(!Profiler::getInstance().isEnabled());
+
+	const std::string json((const char*)buffer.c_ptr(), buffer.size());
+	CASE_ASSERT(json.find("{\"traceEvents\":[") == 0);
+	CASE_ASSERT(json.find("]") != json.npos);
+
+	if (Profiler::getInstance().getDroppedCount() == droppedBefore)
+	{
+		CASE_ASSERT_EQUAL(countOf(json, "\"name\":\"CaseProfiler work\""), 16 * 4 + Profiler::MaxDepth);
+		CASE_ASSERT_EQUAL(countOf(json, "\"name\":\"CaseProfiler counter\""), 10);
+		CASE_ASSERT_EQUAL(countOf(json, "\"name\":\"CaseProfiler dynamic name\""), 1);
+	}
+
+	// Flows begun in capture might end after capture has ended, but never the opposite.
+	CASE_ASSERT(countOf(json, "\"ph\":\"f\"") <= countOf(json, "\"ph\":\"s\""));
+#endif
+}
+
+}
@@ -10,8 +10,8 @@
 #include "Core/Memory/BlockAllocator.h"
 #include "Core/Singleton/SingletonManager.h"
 #include "Core/Thread/Acquire.h"
-#include "Core/Thread/Event.h"
 #include "Core/Thread/Job.h"
+#include "Core/Thread/JobQueue.h"
 #include "Core/Thread/SpinLock.h"
 #include "Core/Thread/Thread.h"
 #include "Core/Thread/ThreadManager.h"
@@ -87,15 +87,7 @@ private:
 
 bool Job::wait(int32_t timeout)
 {
-	Thread* current = ThreadManager::getInstance().getCurrentThread();
-	while (!current->stopped())
-	{
-		if (m_finished)
-			break;
-		if (!m_jobFinishedEvent.wait(timeout))
-			return false;
-	}
-	return m_finished;
+	return m_queue.waitJob(this, timeout);
 }
 
 void Job::cancel()
@@ -123,11 +115,18 @@ void Job::operator delete (void* ptr)
 	JobHeap::getInstance().free(ptr);
 }
 
-Job::Job(Event& jobFinishedEvent, const std::function< void() >& task)
-:	m_jobFinishedEvent(jobFinishedEvent)
+Job::Job(JobQueue& queue, const std::function< void() >& task)
+:	m_queue(queue)
 ,	m_task(task)
+,	m_claimed(false)
 ,	m_finished(false)
 {
 }
 
+bool Job::claim()
+{
+	bool expected = false;
+	return m_claimed.compare_exchange_strong(expected, true);
+}
+
 }
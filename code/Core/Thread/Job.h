@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include "Core/Ref.h"
 #include "Core/Thread/IWaitable.h"
@@ -23,7 +24,7 @@
 namespace traktor
 {
 
-class Event;
+class JobQueue;
 
 /*! Job handle object.
  * \ingroup Core
@@ -50,11 +51,15 @@ public:
 private:
 	friend class JobQueue;
 
-	Event& m_jobFinishedEvent;
+	JobQueue& m_queue;
 	task_t m_task;
+	std::atomic< bool > m_claimed;
 	std::atomic< bool > m_finished;
 
-	explicit Job(Event& jobFinishedEvent, const task_t& task);
+	explicit Job(JobQueue& queue, const task_t& task);
+
+	/*! Claim job for execution, only one thread can claim a job. */
+	bool claim();
 
 	Job() = delete;
 
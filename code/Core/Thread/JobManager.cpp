@@ -10,6 +10,7 @@
 #include "Core/Thread/ThreadManager.h"
 #include "Core/System/OS.h"
 #include "Core/Singleton/SingletonManager.h"
+#include "Core/Timer/Profiler.h"
 
 namespace traktor
 {
@@ -20,7 +21,8 @@ JobManager& JobManager::getInstance()
 	if (!s_instance)
 	{
 		s_instance = new JobManager();
-		SingletonManager::getInstance().addBefore(s_instance, &ThreadManager::getInstance());
+		// Ensure workers are stopped before profiler is destroyed.
+		SingletonManager::getInstance().addBefore(s_instance, &Profiler::getInstance());
 
 		int32_t coreCount = OS::getInstance().getCPUCoreCount();
 		if (coreCount >= 2)
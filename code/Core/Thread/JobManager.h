@@ -44,11 +44,20 @@ public:
 	 */
 	Ref< Job > add(const Job::task_t& functor) { return m_queue.add(functor); }
 
+	/*! Enqueue fire-and-forget job.
+	 *
+	 * Same as add but no job handle is created,
+	 * thus no way to wait for this particular job.
+	 */
+	void addDetached(const Job::task_t& functor) { m_queue.addDetached(functor); }
+
 	/*! Enqueue jobs and wait for all to finish.
 	 *
 	 * Add jobs to internal worker queue, one job
 	 * is always run on the caller thread to reduce
-	 * work for kernel scheduler.
+	 * work for kernel scheduler. The caller thread
+	 * also help executing remaining jobs while
+	 * waiting for them to finish.
 	 */
 	void fork(const Job::task_t* tasks, size_t ntasks) { return m_queue.fork(tasks, ntasks); }
 
@@ -6,17 +6,75 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
-#include "Core/RefArray.h"
+#include <algorithm>
+#include "Core/Thread/Acquire.h"
 #include "Core/Thread/JobQueue.h"
+#include "Core/Thread/SpinLock.h"
 #include "Core/Thread/ThreadManager.h"
+#include "Core/Timer/Profiler.h"
 
 namespace traktor
 {
+	namespace
+	{
+
+thread_local void* s_currentWorker = nullptr;
+
+#if defined(T_PROFILER_ENABLE)
+uint16_t getJobProfilerId()
+{
+	static const uint16_t s_id = Profiler::getInstance().intern(L"Job");
+	return s_id;
+}
+#endif
+
+	}
+
+/*! Queued entry, either a job handle, a detached task or a fork batch runner. */
+struct JobQueue::Entry
+{
+	Job* job = nullptr;
+	ForkBatch* batch = nullptr;
+	Job::task_t task;
+	uint64_t flow = 0;
+};
+
+/*! Per worker thread deque; owner pops from back, thieves steal from front. */
+struct JobQueue::Worker
+{
+	JobQueue* queue = nullptr;
+	Thread* thread = nullptr;
+	uint32_t index = 0;
+	SpinLock lock;
+	AlignedVector< Entry > entries;
+	uint32_t head = 0;
+	std::atomic< int32_t > count = 0;
+};
+
+/*! Tasks of a single fork, shared between caller and runners. */
+struct JobQueue::ForkBatch
+{
+	const Job::task_t* tasks = nullptr;
+	size_t ntasks = 0;
+	std::atomic< size_t > next = 0;
+	std::atomic< size_t > remaining = 0;
+	std::atomic< int32_t > refCount = 0;
+
+	void release()
+	{
+		if (--refCount == 0)
+			delete this;
+	}
+};
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.JobQueue", JobQueue, Object)
 
 JobQueue::JobQueue()
 :	m_pending(0)
+,	m_queued(0)
+,	m_sleeping(0)
+,	m_waiting(0)
+,	m_next(0)
 {
 }
 
@@ -27,20 +85,26 @@ JobQueue::~JobQueue()
 
 bool JobQueue::create(uint32_t workerThreads, Thread::Priority priority)
 {
-	m_workerThreads.resize(workerThreads);
-	for (uint32_t i = 0; i < uint32_t(m_workerThreads.size()); ++i)
+	// Create all deques first since workers steal from each other.
+	m_workers.resize(workerThreads);
+	for (uint32_t i = 0; i < workerThreads; ++i)
 	{
-		m_workerThreads[i] = ThreadManager::getInstance().create(
-			[=, this]() { threadWorker(); },
+		m_workers[i] = new Worker();
+		m_workers[i]->queue = this;
+		m_workers[i]->index = i;
+	}
+
+	for (uint32_t i = 0; i < workerThreads; ++i)
+	{
+		Worker* worker = m_workers[i];
+		worker->thread = ThreadManager::getInstance().create(
+			[=, this]() { threadWorker(worker); },
 			L"Job queue, worker thread"
 		);
-		if (m_workerThreads[i])
-			m_workerThreads[i]->start(priority);
+		if (worker->thread)
+			worker->thread->start(priority);
 		else
-		{
-			m_workerThreads[i] = nullptr;
 			return false;
-		}
 	}
 	return true;
 }
@@ -49,61 +113,112 @@ void JobQueue::destroy()
 {
 	stop();
 
-	for (uint32_t i = 0; i < uint32_t(m_workerThreads.size()); ++i)
-		ThreadManager::getInstance().destroy(m_workerThreads[i]);
+	for (auto worker : m_workers)
+	{
+		if (worker->thread)
+			ThreadManager::getInstance().destroy(worker->thread);
+
+		// Release jobs which never got executed.
+		for (uint32_t i = worker->head; i < worker->entries.size(); ++i)
+		{
+			T_SAFE_RELEASE(worker->entries[i].job);
+			if (worker->entries[i].batch)
+				worker->entries[i].batch->release();
+		}
+
+		delete worker;
+	}
 
-	m_workerThreads.clear();
+	m_workers.clear();
 }
 
 Ref< Job > JobQueue::add(const Job::task_t& task)
 {
-	Ref< Job > job = new Job(m_jobFinishedEvent, task);
+	Ref< Job > job = new Job(*this, task);
 	T_SAFE_ADDREF(job);
-	m_jobQueue.put(job);
-	m_pending++;
-	m_jobQueuedEvent.pulse();
+
+	Entry entry;
+	entry.job = job;
+	enqueue(std::move(entry));
+
 	return job;
 }
 
-void JobQueue::fork(const Job::task_t* tasks, size_t ntasks)
+void JobQueue::addDetached(const Job::task_t& task)
 {
-	RefArray< Job > jobs;
+	Entry entry;
+	entry.task = task;
+	enqueue(std::move(entry));
+}
 
+void JobQueue::fork(const Job::task_t* tasks, size_t ntasks)
+{
 	if (ntasks == 0)
 		return;
 
-	// Create jobs for given functors.
-	if (ntasks > 1)
+	// No point of involving workers if only a single task.
+	if (ntasks == 1 || m_workers.empty())
 	{
-		jobs.resize(ntasks);
-		{
-			for (size_t i = 1; i < ntasks; ++i)
-			{
-				jobs[i] = new Job(m_jobFinishedEvent, tasks[i]);
-				T_SAFE_ADDREF(jobs[i]);
-				m_jobQueue.put(jobs[i]);
-			}
-		}
-		m_pending += (int32_t)(ntasks - 1);
-		m_jobQueuedEvent.pulse((int32_t)(ntasks - 1));
+		for (size_t i = 0; i < ntasks; ++i)
+			tasks[i]();
+		return;
+	}
+
+	// Enqueue one runner per available worker; each runner
+	// claim tasks from the batch until all have been claimed.
+	const uint32_t runners = (uint32_t)std::min< size_t >(ntasks - 1, m_workers.size());
+
+	ForkBatch* batch = new ForkBatch();
+	batch->tasks = tasks;
+	batch->ntasks = ntasks;
+	batch->next = 1;
+	batch->remaining = ntasks - 1;
+	batch->refCount = runners + 1;
+
+	for (uint32_t i = 0; i < runners; ++i)
+	{
+		Entry entry;
+		entry.batch = batch;
+		enqueue(std::move(entry));
 	}
 
-	// Execute first functor on caller thread.
+	// Execute first functor on caller thread, then help
+	// executing remaining tasks.
 	tasks[0]();
+	runBatch(batch);
 
-	// Wait until all jobs has finished.
-	for (uint32_t i = 1; i < jobs.size(); )
+	// Wait until all jobs has finished; worker threads keep
+	// executing other jobs in the meantime.
+	Worker* worker = getCurrentWorker();
+	while (batch->remaining > 0)
 	{
-		if (jobs[i]->wait())
-			++i;
+		if (worker)
+		{
+			Entry entry;
+			if (dequeue(worker, entry))
+			{
+				execute(entry);
+				continue;
+			}
+		}
+
+		m_waiting++;
+		if (batch->remaining > 0)
+			m_jobFinishedEvent.wait(worker ? 1 : -1);
+		m_waiting--;
 	}
+
+	batch->release();
 }
 
 bool JobQueue::wait(int32_t timeout)
 {
 	while (m_pending > 0)
 	{
-		if (!m_jobFinishedEvent.wait(timeout))
+		m_waiting++;
+		const bool result = (m_pending > 0) ? m_jobFinishedEvent.wait(timeout) : true;
+		m_waiting--;
+		if (!result)
 			return false;
 	}
 	return true;
@@ -111,42 +226,246 @@ bool JobQueue::wait(int32_t timeout)
 
 bool JobQueue::waitCurrent(int32_t timeout)
 {
-	return m_pending > 0 ? m_jobFinishedEvent.wait(timeout) : true;
+	if (m_pending <= 0)
+		return true;
+
+	m_waiting++;
+	const bool result = (m_pending > 0) ? m_jobFinishedEvent.wait(timeout) : true;
+	m_waiting--;
+	return result;
 }
 
 void JobQueue::stop()
 {
-	for (uint32_t i = 0; i < (uint32_t)m_workerThreads.size(); ++i)
-		m_workerThreads[i]->stop(0);
-	for (uint32_t i = 0; i < (uint32_t)m_workerThreads.size(); ++i)
-		m_workerThreads[i]->stop();
+	for (auto worker : m_workers)
+	{
+		if (worker->thread)
+			worker->thread->stop(0);
+	}
+	for (auto worker : m_workers)
+	{
+		if (worker->thread)
+			worker->thread->stop();
+	}
 }
 
-void JobQueue::threadWorker()
+JobQueue::Worker* JobQueue::getCurrentWorker() const
 {
-	Thread* thread = ThreadManager::getInstance().getCurrentThread();
-	Job* job;
+	Worker* worker = static_cast< Worker* >(s_currentWorker);
+	return (worker != nullptr && worker->queue == this) ? worker : nullptr;
+}
 
-	while (!thread->stopped())
+void JobQueue::enqueue(Entry&& entry)
+{
+	// No workers; execute directly on caller thread.
+	if (m_workers.empty())
 	{
-		// Try to get a job from the queue.
-		if (!m_jobQueue.get(job))
+		m_pending++;
+		execute(entry);
+		return;
+	}
+
+#if defined(T_PROFILER_ENABLE)
+	entry.flow = Profiler::getInstance().beginFlow(getJobProfilerId());
+#endif
+
+	// Push onto own deque if called from a worker, else distribute evenly.
+	Worker* worker = getCurrentWorker();
+	if (!worker)
+		worker = m_workers[m_next++ % m_workers.size()];
+
+	m_pending++;
+	{
+		T_ANONYMOUS_VAR(Acquire< SpinLock >)(worker->lock);
+		worker->entries.push_back() = std::move(entry);
+		worker->count++;
+	}
+	m_queued++;
+
+	// Only need to wake up a worker if any is sleeping.
+	if (m_sleeping > 0)
+		m_jobQueuedEvent.pulse();
+}
+
+bool JobQueue::dequeue(Worker* worker, Entry& outEntry)
+{
+	// Pop newest entry from own deque first.
+	if (worker && worker->count > 0)
+	{
+		T_ANONYMOUS_VAR(Acquire< SpinLock >)(worker->lock);
+		if (worker->entries.size() > worker->head)
 		{
-			m_jobQueuedEvent.wait(100);
-			continue;			
+			outEntry = std::move(worker->entries.back());
+			worker->entries.pop_back();
+			if (worker->entries.size() <= worker->head)
+			{
+				worker->entries.resize(0);
+				worker->head = 0;
+			}
+			worker->count--;
+			m_queued--;
+			return true;
+		}
+	}
+
+	// Steal oldest entry from other deques.
+	const uint32_t nworkers = (uint32_t)m_workers.size();
+	const uint32_t start = worker ? worker->index + 1 : m_next.load();
+	for (uint32_t i = 0; i < nworkers; ++i)
+	{
+		Worker* victim = m_workers[(start + i) % nworkers];
+		if (victim == worker || victim->count <= 0)
+			continue;
+
+		T_ANONYMOUS_VAR(Acquire< SpinLock >)(victim->lock);
+		if (victim->entries.size() > victim->head)
+		{
+			outEntry = std::move(victim->entries[victim->head]);
+			victim->head++;
+			if (victim->entries.size() <= victim->head)
+			{
+				victim->entries.resize(0);
+				victim->head = 0;
+			}
+			else if (victim->head >= 1024 && victim->head * 2 >= victim->entries.size())
+			{
+				// Compact deque to prevent unbounded growth while never being drained.
+				const uint32_t count = (uint32_t)victim->entries.size() - victim->head;
+				for (uint32_t j = 0; j < count; ++j)
+					victim->entries[j] = std::move(victim->entries[victim->head + j]);
+				victim->entries.resize(count);
+				victim->head = 0;
+			}
+			victim->count--;
+			m_queued--;
+			return true;
 		}
+	}
+
+	return false;
+}
+
+void JobQueue::execute(Entry& entry)
+{
+#if defined(T_PROFILER_ENABLE)
+	ProfilerScoped scope(getJobProfilerId());
+	Profiler::getInstance().endFlow(getJobProfilerId(), entry.flow);
+#endif
+
+	if (entry.job)
+	{
+		Job* job = entry.job;
+		if (job->claim())
+		{
+			auto task = job->m_task;
+			if (task)
+				task();
+			job->m_finished = true;
+		}
+		T_SAFE_RELEASE(job);
+		entry.job = nullptr;
+	}
+	else if (entry.batch)
+	{
+		runBatch(entry.batch);
+		entry.batch->release();
+		entry.batch = nullptr;
+	}
+	else if (entry.task)
+	{
+		entry.task();
+		entry.task = nullptr;
+	}
+
+	// Decrement number of pending jobs and signal anyone waiting for jobs to finish.
+	m_pending--;
+	notifyFinished();
+}
+
+void JobQueue::runBatch(ForkBatch* batch)
+{
+	for (;;)
+	{
+		const size_t index = batch->next++;
+		if (index >= batch->ntasks)
+			break;
 
-		// Execute job.
+		batch->tasks[index]();
+
+		if (--batch->remaining == 0)
+			notifyFinished();
+	}
+}
+
+void JobQueue::notifyFinished()
+{
+	if (m_waiting > 0)
+		m_jobFinishedEvent.broadcast();
+}
+
+bool JobQueue::waitJob(Job* job, int32_t timeout)
+{
+	// Execute job on caller thread if no worker has picked it up yet; only
+	// when waiting without timeout as polling should never block caller.
+	if (timeout < 0 && job->claim())
+	{
 		auto task = job->m_task;
 		if (task)
 			task();
 		job->m_finished = true;
-		T_SAFE_RELEASE(job);
+		notifyFinished();
+		return true;
+	}
 
-		// Decrement number of pending jobs and signal anyone waiting for jobs to finish.
-		m_pending--;
-		m_jobFinishedEvent.broadcast();
+	Thread* current = ThreadManager::getInstance().getCurrentThread();
+	Worker* worker = (timeout < 0) ? getCurrentWorker() : nullptr;
+	while (!current->stopped())
+	{
+		if (job->m_finished)
+			break;
+
+		// Worker threads help executing other jobs while waiting.
+		if (worker)
+		{
+			Entry entry;
+			if (dequeue(worker, entry))
+			{
+				execute(entry);
+				continue;
+			}
+		}
+
+		m_waiting++;
+		const bool result = job->m_finished ? true : m_jobFinishedEvent.wait(worker ? 1 : timeout);
+		m_waiting--;
+		if (!result && !worker)
+			return false;
 	}
+	return job->m_finished;
+}
+
+void JobQueue::threadWorker(Worker* worker)
+{
+	Thread* thread = ThreadManager::getInstance().getCurrentThread();
+	s_currentWorker = worker;
+
+	while (!thread->stopped())
+	{
+		Entry entry;
+		if (dequeue(worker, entry))
+		{
+			execute(entry);
+			continue;
+		}
+
+		// Nothing to execute nor steal; sleep until more jobs are queued.
+		m_sleeping++;
+		if (m_queued <= 0)
+			m_jobQueuedEvent.wait(100);
+		m_sleeping--;
+	}
+
+	s_currentWorker = nullptr;
 }
 
 }
@@ -8,10 +8,10 @@
  */
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include "Core/Object.h"
 #include "Core/Containers/AlignedVector.h"
-#include "Core/Containers/ThreadsafeFifo.h"
 #include "Core/Thread/Event.h"
 #include "Core/Thread/Job.h"
 #include "Core/Thread/Semaphore.h"
@@ -31,6 +31,13 @@ namespace traktor
 
 /*! Job queue.
  * \ingroup Core
+ *
+ * Work stealing scheduler; each worker thread owns a
+ * deque of pending jobs which it pops from the back
+ * while idle workers steal from the front of other
+ * workers' deques. Jobs added from threads which
+ * are not workers of this queue are distributed
+ * round-robin over the worker deques.
  */
 class T_DLLCLASS JobQueue : public Object
 {
@@ -59,11 +66,20 @@ public:
 	 */
 	Ref< Job > add(const Job::task_t& task);
 
+	/*! Enqueue fire-and-forget job.
+	 *
+	 * Same as add but no job handle is created,
+	 * thus no way to wait for this particular job.
+	 */
+	void addDetached(const Job::task_t& task);
+
 	/*! Enqueue jobs and wait for all to finish.
 	 *
 	 * Add jobs to internal worker queue, one job
 	 * is always run on the caller thread to reduce
-	 * work for kernel scheduler.
+	 * work for kernel scheduler. The caller thread
+	 * also help executing remaining jobs while
+	 * waiting for them to finish.
 	 */
 	void fork(const Job::task_t* tasks, size_t ntasks);
 
@@ -84,14 +100,40 @@ public:
 	/*! Stop all worker threads. */
 	void stop();
 
+	/*! Get number of worker threads. */
+	uint32_t getWorkerCount() const { return (uint32_t)m_workers.size(); }
+
 private:
-	AlignedVector< Thread* > m_workerThreads;
-	ThreadsafeFifo< Job* > m_jobQueue;
+	friend class Job;
+
+	struct Entry;
+	struct Worker;
+	struct ForkBatch;
+
+	AlignedVector< Worker* > m_workers;
 	Event m_jobQueuedEvent;
 	Event m_jobFinishedEvent;
 	std::atomic< int32_t > m_pending;
+	std::atomic< int32_t > m_queued;
+	std::atomic< int32_t > m_sleeping;
+	std::atomic< int32_t > m_waiting;
+	std::atomic< uint32_t > m_next;
+
+	Worker* getCurrentWorker() const;
+
+	void enqueue(Entry&& entry);
+
+	bool dequeue(Worker* worker, Entry& outEntry);
+
+	void execute(Entry& entry);
+
+	void runBatch(ForkBatch* batch);
+
+	void notifyFinished();
+
+	bool waitJob(Job* job, int32_t timeout);
 
-	void threadWorker();
+	void threadWorker(Worker* worker);
 };
 
 }
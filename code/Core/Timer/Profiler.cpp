@@ -6,7 +6,12 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <cstdio>
+#include <cstring>
+#include "Core/Io/IStream.h"
+#include "Core/Io/Utf8Encoding.h"
 #include "Core/Misc/String.h"
+#include "Core/Misc/TString.h"
 #include "Core/Singleton/SingletonManager.h"
 #include "Core/Thread/Acquire.h"
 #include "Core/Thread/Thread.h"
@@ -18,9 +23,29 @@ namespace traktor
 	namespace
 	{
 
-thread_local uint8_t s_threadIndex;
+const int32_t c_collectInterval = 10;
+
 uint8_t s_threadIndexNext = 0;
 
+void writeString(IStream* stream, const char* str)
+{
+	stream->write(str, (int64_t)strlen(str));
+}
+
+std::string escapeJson(const std::wstring& str)
+{
+	std::string out;
+	for (char ch : wstombs(Utf8Encoding(), str))
+	{
+		if (ch == '"' || ch == '\\')
+			out += '\\';
+		else if ((uint8_t)ch < 0x20)
+			continue;
+		out += ch;
+	}
+	return out;
+}
+
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.Profiler", Profiler, Object)
@@ -32,52 +57,88 @@ Profiler& Profiler::getInstance()
 	{
 		s_instance = new Profiler();
 		s_instance->addRef(nullptr);
-		SingletonManager::getInstance().add(s_instance);
+		SingletonManager::getInstance().addBefore(s_instance, &ThreadManager::getInstance());
 	}
 	return *s_instance;
 }
 
 void Profiler::setListener(IReportListener* listener)
 {
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 	m_listener = listener;
+	m_dictionaryDirty = true;
+	updateEnabled();
 }
 
-void Profiler::beginEvent(const std::wstring_view& name)
+bool Profiler::beginCapture(IStream* stream)
 {
-	if (!m_listener)
-		return;
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	if (!stream || m_captureStream)
+		return false;
+
+	m_captureStream = stream;
+	m_captureFirst = true;
+	writeString(m_captureStream, "{\"traceEvents\":[\n");
+
+	updateEnabled();
+	return true;
+}
 
-	// Get ID of immutable name.
-	uint16_t id = 0;
+void Profiler::endCapture()
+{
+	flush();
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	if (m_captureStream)
 	{
-		T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_nameIdsLock);
-		auto it = m_nameIds.find(name);
-		if (it != m_nameIds.end())
-			id = it->second;
-		else
-		{
-			id = (uint16_t)m_nameIds.size();
-			m_nameIds[name] = id;
-			m_dictionary[id] = name;
-			m_dictionaryDirty = true;
-		}
+		writeString(m_captureStream, "\n],\"displayTimeUnit\":\"ms\"}\n");
+		m_captureStream->close();
+		m_captureStream = nullptr;
 	}
+	updateEnabled();
+}
 
-	// Get event queue for calling thread.
-	ThreadEvents* te = static_cast< ThreadEvents* >(m_localThreadEvents.get());
-	if (!te)
+uint16_t Profiler::intern(const std::wstring_view& name)
+{
+	T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_nameIdsLock);
+	auto it = m_nameIds.find(name);
+	if (it != m_nameIds.end())
+		return it->second;
+
+	const uint16_t id = (uint16_t)m_nameIds.size();
+	m_nameIds[name] = id;
+	m_dictionary[id] = name;
+	m_dictionaryDirty = true;
+	return id;
+}
+
+void Profiler::beginEvent(const std::wstring_view& name)
+{
+	if (!m_enabled)
+		return;
+
+	beginEvent(intern(name));
+}
+
+void Profiler::beginEvent(uint16_t id)
+{
+	if (!m_enabled)
+		return;
+
+	ThreadEvents* te = getThreadEvents();
+
+	// Keep track of nesting beyond max depth so end events match.
+	if (te->events.full())
 	{
-		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
-		te = new ThreadEvents();
-		m_threadEvents.push_back(te);
-		m_localThreadEvents.set(te);
-		s_threadIndex = s_threadIndexNext++;
+		te->overflow++;
+		return;
 	}
 
 	// Begin event.
 	Event& e = te->events.push_back();
 	e.name = id;
-	e.threadId = s_threadIndex;
+	e.threadId = te->threadId;
 	e.depth = uint8_t(te->events.size() - 1);
 	e.start = m_timer.getElapsedTime();
 	e.end = 0.0;
@@ -85,78 +146,101 @@ void Profiler::beginEvent(const std::wstring_view& name)
 
 void Profiler::endEvent()
 {
-	if (!m_listener)
+	if (!m_enabled)
 		return;
 
-	// Get event queue for calling thread.
-	ThreadEvents* te = static_cast< ThreadEvents* >(m_localThreadEvents.get());
-	T_ASSERT(te);
-
-	// End event.
-	T_ASSERT(!te->events.empty());
-	Event& e = te->events.back();
-	e.end = m_timer.getElapsedTime();
+	ThreadEvents* te = getThreadEvents();
 
+	if (te->overflow > 0)
 	{
-		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		te->overflow--;
+		return;
+	}
 
-		// Merge finished event.
-		m_events.push_back(e);
-		te->events.pop_back();
+	// Events might have begun before profiler was enabled.
+	if (te->events.empty())
+		return;
 
-		// Report events if we've queued enough.
-		if (m_events.size() >= MaxQueuedEvents)
-		{
-			if (m_dictionaryDirty)
-			{
-				m_listener->reportProfilerDictionary(m_dictionary);
-				m_dictionaryDirty = false;
-			}
+	// End event.
+	const Event& e = te->events.back();
 
-			m_listener->reportProfilerEvents(m_timer.getElapsedTime(), m_events);
-			m_events.resize(0);
-		}
-	}
+	Record r;
+	r.name = e.name;
+	r.type = RtScope;
+	r.depth = e.depth;
+	r.start = e.start;
+	r.end = m_timer.getElapsedTime();
+	r.flow = 0;
+	push(te, r);
+
+	te->events.pop_back();
 }
 
 void Profiler::addEvent(const std::wstring_view& name, double start, double duration)
 {
-	if (!m_listener)
+	if (!m_enabled)
 		return;
 
-	// Get ID of immutable name.
-	uint16_t id = 0;
-	{
-		T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_nameIdsLock);
-		auto it = m_nameIds.find(name);
-		if (it != m_nameIds.end())
-			id = it->second;
-		else
-		{
-			id = (uint16_t)m_nameIds.size();
-			m_nameIds[name] = id;
-			m_dictionary[id] = name;
-			m_dictionaryDirty = true;
-		}
-	}
+	Record r;
+	r.name = intern(name);
+	r.type = RtManual;
+	r.depth = 0;
+	r.start = start;
+	r.end = start + duration;
+	r.flow = 0;
+	push(getThreadEvents(), r);
+}
 
-	{
-		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
-		
-		auto& e = m_events.push_back();
-		e.name = id;
-		e.threadId = -1;
-		e.depth = 0;
-		e.start = start;
-		e.end = start + duration;
-
-		// Report events if we've queued enough.
-		if (m_events.full())
-		{
-			m_listener->reportProfilerEvents(m_timer.getElapsedTime(), m_events);
-			m_events.resize(0);
-		}
-	}
+void Profiler::addCounter(uint16_t id, double value)
+{
+	if (!m_enabled)
+		return;
+
+	Record r;
+	r.name = id;
+	r.type = RtCounter;
+	r.depth = 0;
+	r.start = m_timer.getElapsedTime();
+	r.end = value;
+	r.flow = 0;
+	push(getThreadEvents(), r);
+}
+
+uint64_t Profiler::beginFlow(uint16_t id)
+{
+	if (!m_enabled)
+		return 0;
+
+	Record r;
+	r.name = id;
+	r.type = RtFlowBegin;
+	r.depth = 0;
+	r.start = m_timer.getElapsedTime();
+	r.end = r.start;
+	r.flow = ++m_nextFlow;
+	push(getThreadEvents(), r);
+	return r.flow;
+}
+
+void Profiler::endFlow(uint16_t id, uint64_t flow)
+{
+	if (!m_enabled || flow == 0)
+		return;
+
+	Record r;
+	r.name = id;
+	r.type = RtFlowEnd;
+	r.depth = 0;
+	r.start = m_timer.getElapsedTime();
+	r.end = r.start;
+	r.flow = flow;
+	push(getThreadEvents(), r);
+}
+
+void Profiler::flush()
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	collect();
 }
 
 double Profiler::getTime() const
@@ -166,15 +250,33 @@ double Profiler::getTime() const
 
 Profiler::Profiler()
 :	m_dictionaryDirty(false)
+,	m_captureFirst(false)
+,	m_collectorThread(nullptr)
+,	m_enabled(false)
+,	m_nextFlow(0)
+,	m_dropped(0)
 {
 	m_timer.reset();
 }
 
 void Profiler::destroy()
 {
+	m_enabled = false;
+
+	if (m_collectorThread)
+	{
+		m_collectorThread->stop();
+		ThreadManager::getInstance().destroy(m_collectorThread);
+		m_collectorThread = nullptr;
+	}
+
+	endCapture();
+
 	{
 		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 
+		collect();
+
 		if (!m_events.empty())
 		{
 			if (m_listener)
@@ -192,4 +294,143 @@ void Profiler::destroy()
 	T_SAFE_RELEASE(this);
 }
 
+Profiler::ThreadEvents* Profiler::getThreadEvents()
+{
+	// Get event queue for calling thread.
+	ThreadEvents* te = static_cast< ThreadEvents* >(m_localThreadEvents.get());
+	if (!te)
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		te = new ThreadEvents();
+		te->threadId = s_threadIndexNext++;
+		m_threadEvents.push_back(te);
+		m_localThreadEvents.set(te);
+	}
+	return te;
+}
+
+void Profiler::push(ThreadEvents* te, const Record& record)
+{
+	// Single producer; only owning thread push records.
+	const uint32_t head = te->head.load(std::memory_order_relaxed);
+	if (head - te->tail.load(std::memory_order_acquire) >= MaxThreadEvents)
+	{
+		m_dropped++;
+		return;
+	}
+	te->ring[head % MaxThreadEvents] = record;
+	te->head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::collect()
+{
+	if (m_listener && m_dictionaryDirty)
+	{
+		SmallMap< uint16_t, std::wstring > dictionary;
+		{
+			T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_nameIdsLock);
+			dictionary = m_dictionary;
+			m_dictionaryDirty = false;
+		}
+		m_listener->reportProfilerDictionary(dictionary);
+	}
+
+	for (auto te : m_threadEvents)
+	{
+		// Single consumer; collection is serialized by m_lock.
+		const uint32_t head = te->head.load(std::memory_order_acquire);
+		uint32_t tail = te->tail.load(std::memory_order_relaxed);
+		for (; tail != head; ++tail)
+		{
+			const Record& r = te->ring[tail % MaxThreadEvents];
+
+			if (m_captureStream)
+				writeCapture(te, r);
+
+			if (m_listener && (r.type == RtScope || r.type == RtManual))
+			{
+				auto& e = m_events.push_back();
+				e.name = r.name;
+				e.threadId = (r.type == RtScope) ? te->threadId : -1;
+				e.depth = r.depth;
+				e.start = r.start;
+				e.end = r.end;
+
+				// Report events if we've queued enough.
+				if (m_events.full())
+				{
+					m_listener->reportProfilerEvents(m_timer.getElapsedTime(), m_events);
+					m_events.resize(0);
+				}
+			}
+		}
+		te->tail.store(tail, std::memory_order_release);
+	}
+}
+
+void Profiler::writeCapture(const ThreadEvents* te, const Record& record)
+{
+	std::wstring name;
+	{
+		T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_nameIdsLock);
+		auto it = m_dictionary.find(record.name);
+		if (it != m_dictionary.end())
+			name = it->second;
+	}
+
+	const std::string escaped = escapeJson(name);
+	const int32_t tid = (record.type != RtManual) ? te->threadId : 255;
+	char buf[512];
+
+	switch (record.type)
+	{
+	case RtScope:
+	case RtManual:
+		snprintf(buf, sizeof(buf), "{\"name\":\"%s\",\"cat\":\"scope\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}", escaped.c_str(), record.start * 1e6, (record.end - record.start) * 1e6, tid);
+		break;
+
+	case RtCounter:
+		snprintf(buf, sizeof(buf), "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"args\":{\"value\":%g}}", escaped.c_str(), record.start * 1e6, record.end);
+		break;
+
+	case RtFlowBegin:
+		snprintf(buf, sizeof(buf), "{\"name\":\"%s\",\"cat\":\"flow\",\"ph\":\"s\",\"id\":%llu,\"ts\":%.3f,\"pid\":1,\"tid\":%d}", escaped.c_str(), (unsigned long long)record.flow, record.start * 1e6, tid);
+		break;
+
+	case RtFlowEnd:
+		snprintf(buf, sizeof(buf), "{\"name\":\"%s\",\"cat\":\"flow\",\"ph\":\"f\",\"bp\":\"e\",\"id\":%llu,\"ts\":%.3f,\"pid\":1,\"tid\":%d}", escaped.c_str(), (unsigned long long)record.flow, record.start * 1e6, tid);
+		break;
+	}
+
+	if (!m_captureFirst)
+		writeString(m_captureStream, ",\n");
+	writeString(m_captureStream, buf);
+	m_captureFirst = false;
+}
+
+void Profiler::updateEnabled()
+{
+	const bool enabled = (m_listener != nullptr || m_captureStream != nullptr);
+	if (enabled && !m_collectorThread)
+	{
+		m_collectorThread = ThreadManager::getInstance().create(
+			[this]() { threadCollector(); },
+			L"Profiler collector"
+		);
+		if (m_collectorThread)
+			m_collectorThread->start();
+	}
+	m_enabled = enabled;
+}
+
+void Profiler::threadCollector()
+{
+	Thread* thread = ThreadManager::getInstance().getCurrentThread();
+	while (!thread->stopped())
+	{
+		thread->sleep(c_collectInterval);
+		flush();
+	}
+}
+
 }
@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <string>
 #include "Core/Ref.h"
 #include "Core/Containers/SmallMap.h"
@@ -37,6 +38,7 @@ namespace traktor
 /*! \ingroup Core */
 //@{
 
+class IStream;
 class Thread;
 class OutputStream;
 
@@ -45,6 +47,12 @@ class OutputStream;
  *
  * The runtime profiler measures time spent in
  * scopes.
+ *
+ * Each thread record events into it's own lock-free
+ * ring buffer which is drained by a collector thread,
+ * the collector report events to the listener and
+ * optionally write a Chrome trace JSON capture which
+ * can be opened in chrome://tracing or Perfetto.
  */
 class T_DLLCLASS Profiler
 :	public Object
@@ -56,7 +64,8 @@ public:
 	enum 
 	{
 		MaxQueuedEvents = 64,
-		MaxDepth = 16
+		MaxDepth = 64,
+		MaxThreadEvents = 8192
 	};
 
 	struct Event
@@ -89,10 +98,31 @@ public:
 	 */
 	void setListener(IReportListener* listener);
 
+	/*! Begin capture of events into Chrome trace JSON.
+	 *
+	 * \param stream Output stream, capture is written as events are collected.
+	 * \return True if capture started.
+	 */
+	bool beginCapture(IStream* stream);
+
+	/*! End capture, all pending events are written before stream is closed.
+	 */
+	void endCapture();
+
+	/*! Get ID of immutable name.
+	 *
+	 * Used to intern scope names once per call site, see T_PROFILER_SCOPE.
+	 */
+	uint16_t intern(const std::wstring_view& name);
+
 	/*! Begin recording event.
 	 */
 	void beginEvent(const std::wstring_view& name);
 
+	/*! Begin recording event with interned name.
+	 */
+	void beginEvent(uint16_t id);
+
 	/*! End recording event.
 	 */
 	void endEvent();
@@ -100,6 +130,27 @@ public:
 	/*! Add manual event. */
 	void addEvent(const std::wstring_view& name, double start, double duration);
 
+	/*! Record counter value. */
+	void addCounter(uint16_t id, double value);
+
+	/*! Begin flow, such as when a job is enqueued.
+	 *
+	 * \return Flow identifier, 0 if profiler isn't enabled.
+	 */
+	uint64_t beginFlow(uint16_t id);
+
+	/*! End flow, such as when a job is executed. */
+	void endFlow(uint16_t id, uint64_t flow);
+
+	/*! Synchronously collect all recorded events. */
+	void flush();
+
+	/*! Check if profiler is recording events. */
+	bool isEnabled() const { return m_enabled; }
+
+	/*! Get number of events dropped due to full thread buffers. */
+	uint32_t getDroppedCount() const { return m_dropped; }
+
 	/*! Get current time.
 	 */
 	double getTime() const;
@@ -110,26 +161,65 @@ protected:
 	virtual void destroy() override final;
 
 private:
+	enum RecordType : uint8_t
+	{
+		RtScope,
+		RtManual,
+		RtCounter,
+		RtFlowBegin,
+		RtFlowEnd
+	};
+
+	struct Record
+	{
+		uint16_t name;
+		RecordType type;
+		uint8_t depth;
+		double start;
+		double end;		//!< End time of scope, or value of counter.
+		uint64_t flow;
+	};
+
 	struct ThreadEvents
 	{
+		uint8_t threadId;
 		eventStack_t events;
+		uint32_t overflow = 0;
+		std::atomic< uint32_t > head = 0;
+		std::atomic< uint32_t > tail = 0;
+		Record ring[MaxThreadEvents];
 	};
 
 	Ref< IReportListener > m_listener;
+	Ref< IStream > m_captureStream;
 	Semaphore m_lock;
 	SpinLock m_nameIdsLock;
 	SmallMap< std::wstring, uint16_t > m_nameIds;
 	SmallMap< uint16_t, std::wstring > m_dictionary;
 	bool m_dictionaryDirty;
+	bool m_captureFirst;
 	eventQueue_t m_events;
 	AlignedVector< ThreadEvents* > m_threadEvents;
 	ThreadLocal m_localThreadEvents;
+	Thread* m_collectorThread;
+	std::atomic< bool > m_enabled;
+	std::atomic< uint64_t > m_nextFlow;
+	std::atomic< uint32_t > m_dropped;
 	Timer m_timer;
+
+	ThreadEvents* getThreadEvents();
+
+	void push(ThreadEvents* te, const Record& record);
+
+	void collect();
+
+	void writeCapture(const ThreadEvents* te, const Record& record);
+
+	void updateEnabled();
+
+	void threadCollector();
 };
 
-/*! Scoped profiling event.
- * \ingroup Core
- */
 class ProfilerScoped
 {
 public:
@@ -138,20 +228,30 @@ public:
 		Profiler::getInstance().beginEvent(name);
 	}
 
+	ProfilerScoped(uint16_t id)
+	{
+		Profiler::getInstance().beginEvent(id);
+	}
+
 	~ProfilerScoped()
 	{
 		Profiler::getInstance().endEvent();
 	}
 };
 
+// Scope and counter names must be immutable literals since they are interned once per call site.
 #if defined(T_PROFILER_ENABLE)
+#	define T_PROFILER_ID_1(x,y) x ## y
+#	define T_PROFILER_ID(x,y) T_PROFILER_ID_1(x,y)
 #	define T_PROFILER_BEGIN(name)	{ Profiler::getInstance().beginEvent(name); }
 #	define T_PROFILER_END()			{ Profiler::getInstance().endEvent(); }
-#	define T_PROFILER_SCOPE(name)	T_ANONYMOUS_VAR(ProfilerScoped)(name);
+#	define T_PROFILER_SCOPE(name)	static const uint16_t T_PROFILER_ID(_profilerId, __LINE__) = Profiler::getInstance().intern(name); ProfilerScoped T_PROFILER_ID(_profilerScope, __LINE__)(T_PROFILER_ID(_profilerId, __LINE__));
+#	define T_PROFILER_COUNTER(name, value)	{ static const uint16_t _profilerId = Profiler::getInstance().intern(name); Profiler::getInstance().addCounter(_profilerId, (double)(value)); }
 #else
 #	define T_PROFILER_BEGIN(name)	{}
 #	define T_PROFILER_END()			{}
 #	define T_PROFILER_SCOPE(name)
+#	define T_PROFILER_COUNTER(name, value)	{}
 #endif
 
 //@}
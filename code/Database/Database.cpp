@@ -6,10 +6,13 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include <limits>
+#include "Core/Containers/StaticVector.h"
 #include "Core/Log/Log.h"
 #include "Core/Misc/StringSplit.h"
 #include "Core/Thread/Acquire.h"
+#include "Core/Thread/JobManager.h"
 #include "Database/Database.h"
 #include "Database/Group.h"
 #include "Database/Instance.h"
@@ -28,22 +31,56 @@ namespace traktor::db
 	namespace
 	{
 
-void buildInstanceMap(Group* group, SmallMap< Guid, Ref< Instance > >& outInstanceMap)
+const size_t c_resolveChunkSize = 256;
+const size_t c_maxResolveTasks = 32;
+
+void collectInstances(Group* group, RefArray< Instance >& outInstances)
 {
 	RefArray< Instance > childInstances;
 	group->getChildInstances(childInstances);
-	for (const auto childInstance : childInstances)
-	{
-		outInstanceMap.insert(std::make_pair(
-			childInstance->getGuid(),
-			childInstance
-		));
-	}
+	outInstances.insert(outInstances.end(), childInstances.begin(), childInstances.end());
 
 	RefArray< Group > childGroups;
 	group->getChildGroups(childGroups);
 	for (const auto childGroup : childGroups)
-		buildInstanceMap(childGroup, outInstanceMap);
+		collectInstances(childGroup, outInstances);
+}
+
+void buildInstanceMap(Group* group, HashMap< Guid, Ref< Instance > >& outInstanceMap)
+{
+	RefArray< Instance > instances;
+	collectInstances(group, instances);
+
+	// Resolving guid might require provider to read instance's meta data
+	// thus resolve guids in parallel before populating the map.
+	const size_t ninstances = instances.size();
+	AlignedVector< Guid > guids(ninstances);
+
+	const size_t ntasks = std::min((ninstances + c_resolveChunkSize - 1) / c_resolveChunkSize, c_maxResolveTasks);
+	if (ntasks > 1)
+	{
+		const size_t chunkSize = (ninstances + ntasks - 1) / ntasks;
+		StaticVector< Job::task_t, c_maxResolveTasks > tasks;
+		for (size_t i = 0; i < ntasks; ++i)
+		{
+			tasks.push_back([&, i]() {
+				const size_t from = i * chunkSize;
+				const size_t to = std::min(from + chunkSize, ninstances);
+				for (size_t j = from; j < to; ++j)
+					guids[j] = instances[j]->getGuid();
+			});
+		}
+		JobManager::getInstance().fork(tasks.c_ptr(), tasks.size());
+	}
+	else
+	{
+		for (size_t i = 0; i < ninstances; ++i)
+			guids[i] = instances[i]->getGuid();
+	}
+
+	outInstanceMap.reserve(outInstanceMap.size() + ninstances);
+	for (size_t i = 0; i < ninstances; ++i)
+		outInstanceMap.insert(guids[i], instances[i]);
 }
 
 	}
@@ -215,8 +252,8 @@ Ref< Instance > Database::getInstance(const Guid& instanceGuid)
 	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 	T_ASSERT(m_providerDatabase);
 
-	const auto i = m_instanceMap.find(instanceGuid);
-	return i != m_instanceMap.end() ? i->second : nullptr;
+	const auto instance = m_instanceMap.find(instanceGuid);
+	return instance != nullptr ? *instance : nullptr;
 }
 
 Ref< Instance > Database::getInstance(const std::wstring& instancePath, const TypeInfo* primaryType)
@@ -279,11 +316,11 @@ Ref< ISerializable > Database::getObjectReadOnly(const Guid& guid) const
 	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 	T_ASSERT(m_providerDatabase);
 
-	const auto i = m_instanceMap.find(guid);
-	if (i == m_instanceMap.end() || !i->second)
+	const auto instance = m_instanceMap.find(guid);
+	if (instance == nullptr || !*instance)
 		return nullptr;
 
-	return i->second->getObject();
+	return (*instance)->getObject();
 }
 
 bool Database::getEvent(Ref< const IEvent >& outEvent, bool& outRemote)
@@ -335,16 +372,14 @@ bool Database::getEvent(Ref< const IEvent >& outEvent, bool& outRemote)
 
 		else if (const EvtInstanceRemoved* removed = dynamic_type_cast< const EvtInstanceRemoved* >(outEvent))
 		{
-			auto i = m_instanceMap.find(removed->getInstanceGuid());
-			if (i != m_instanceMap.end())
-				m_instanceMap.erase(i);
+			m_instanceMap.remove(removed->getInstanceGuid());
 		}
 
 		else if (const EvtInstanceGuidChanged* guidChanged = dynamic_type_cast< const EvtInstanceGuidChanged* >(outEvent))
 		{
-			auto i = m_instanceMap.find(guidChanged->getInstancePreviousGuid());
-			if (i != m_instanceMap.end())
-				i->second->internalFlush();
+			auto instance = m_instanceMap.find(guidChanged->getInstancePreviousGuid());
+			if (instance != nullptr)
+				(*instance)->internalFlush();
 
 			m_instanceMap.clear();
 			buildInstanceMap(m_rootGroup, m_instanceMap);
@@ -352,10 +387,10 @@ bool Database::getEvent(Ref< const IEvent >& outEvent, bool& outRemote)
 
 		else if (const EvtInstanceRenamed* renamed = dynamic_type_cast< const EvtInstanceRenamed* >(outEvent))
 		{
-			auto i = m_instanceMap.find(renamed->getInstanceGuid());
-			if (i != m_instanceMap.end())
+			auto instance = m_instanceMap.find(renamed->getInstanceGuid());
+			if (instance != nullptr)
 			{
-				Ref< Group > parent = i->second->getParent();
+				Ref< Group > parent = (*instance)->getParent();
 				if (parent)
 					parent->internalFlushChildInstances();
 			}
@@ -388,9 +423,7 @@ void Database::instanceEventRemoved(Instance* instance)
 	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 
 	// Remove previous cached entry.
-	const auto i = m_instanceMap.find(instance->getGuid());
-	if (i != m_instanceMap.end())
-		m_instanceMap.erase(i);
+	m_instanceMap.remove(instance->getGuid());
 
 	// Notify others about removed instance.
 	if (m_providerBus)
@@ -402,9 +435,7 @@ void Database::instanceEventGuidChanged(Instance* instance, const Guid& previous
 	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 
 	// Remove previous cached entry.
-	const auto i = m_instanceMap.find(previousGuid);
-	if (i != m_instanceMap.end())
-		m_instanceMap.erase(i);
+	m_instanceMap.remove(previousGuid);
 
 	// Insert new cache entry.
 	m_instanceMap[instance->getGuid()] = instance;
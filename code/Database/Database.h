@@ -11,7 +11,7 @@
 #include "Core/Guid.h"
 #include "Core/Object.h"
 #include "Core/Ref.h"
-#include "Core/Containers/SmallMap.h"
+#include "Core/Containers/HashMap.h"
 #include "Core/Thread/Semaphore.h"
 #include "Database/ConnectionString.h"
 #include "Database/IGroupEventListener.h"
@@ -149,7 +149,7 @@ private:
 	Ref< IProviderBus > m_providerBus;
 	Ref< Group > m_rootGroup;
 	mutable Semaphore m_lock;
-	SmallMap< Guid, Ref< Instance > > m_instanceMap;
+	HashMap< Guid, Ref< Instance > > m_instanceMap;
 	uint64_t m_lastEntrySqnr = 0;
 
 	// \name IInstanceEventListener
@@ -7,16 +7,18 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include "Database/Local/Context.h"
+#include "Database/Local/InstanceIndex.h"
 
 namespace traktor::db
 {
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.db.Context", Context, Object)
 
-Context::Context(bool preferBinary, IFileStore* fileStore)
+Context::Context(bool preferBinary, IFileStore* fileStore, InstanceIndex* instanceIndex)
 :	m_sessionGuid(Guid::create())
 ,	m_preferBinary(preferBinary)
 ,	m_fileStore(fileStore)
+,	m_instanceIndex(instanceIndex)
 {
 }
 
@@ -35,4 +37,9 @@ IFileStore* Context::getFileStore() const
 	return m_fileStore;
 }
 
+InstanceIndex* Context::getInstanceIndex() const
+{
+	return m_instanceIndex;
+}
+
 }
@@ -16,6 +16,7 @@ namespace traktor::db
 {
 
 class IFileStore;
+class InstanceIndex;
 
 /*! Local database context.
  * \ingroup Database
@@ -27,7 +28,7 @@ class Context : public Object
 public:
 	Context() = default;
 
-	explicit Context(bool preferBinary, IFileStore* fileStore);
+	explicit Context(bool preferBinary, IFileStore* fileStore, InstanceIndex* instanceIndex);
 
 	const Guid& getSessionGuid() const;
 
@@ -35,10 +36,13 @@ public:
 
 	IFileStore* getFileStore() const;
 
+	InstanceIndex* getInstanceIndex() const;
+
 private:
 	Guid m_sessionGuid;
 	bool m_preferBinary = false;
 	Ref< IFileStore > m_fileStore;
+	Ref< InstanceIndex > m_instanceIndex;
 };
 
 }
@@ -0,0 +1,171 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Io/BufferedStream.h"
+#include "Core/Io/File.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Io/Reader.h"
+#include "Core/Io/Writer.h"
+#include "Core/Log/Log.h"
+#include "Core/Thread/Acquire.h"
+#include "Database/Local/InstanceIndex.h"
+#include "Database/Local/LocalInstanceMeta.h"
+#include "Database/Local/PhysicalAccess.h"
+
+namespace traktor::db
+{
+	namespace
+	{
+
+const uint32_t c_indexVersion = 1;
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.db.InstanceIndex", InstanceIndex, Object)
+
+bool InstanceIndex::read(const Path& indexPath)
+{
+	Ref< IStream > file = FileSystem::getInstance().open(indexPath, File::FmRead);
+	if (!file)
+		return false;
+
+	Ref< IStream > stream = new BufferedStream(file);
+	Reader reader(stream);
+
+	uint32_t version = 0, count = 0;
+	reader >> version;
+	reader >> count;
+	if (version != c_indexVersion)
+	{
+		log::warning << L"Instance index \"" << indexPath.getPathName() << L"\" has incompatible version; ignored." << Endl;
+		return false;
+	}
+
+	T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_lock);
+
+	m_entries.clear();
+	m_entries.reserve(count);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		std::wstring path;
+		uint8_t guid[16];
+		Entry entry;
+
+		reader >> path;
+		if (reader.read(guid, sizeof(guid)) != sizeof(guid))
+		{
+			m_entries.clear();
+			stream->close();
+			return false;
+		}
+		reader >> entry.lastWriteTime;
+		reader >> entry.size;
+
+		entry.guid = Guid(guid);
+		m_entries.insert(path, entry);
+	}
+
+	stream->close();
+
+	m_dirty = false;
+	return true;
+}
+
+bool InstanceIndex::write(const Path& indexPath)
+{
+	T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_lock);
+
+	// Entries not accessed during session, such as of removed instances,
+	// are dropped when written thus index doesn't accumulate stale entries.
+	uint32_t count = 0;
+	for (const auto& it : m_entries)
+	{
+		if (it.second.accessed)
+			++count;
+	}
+
+	if (!m_dirty && count == (uint32_t)m_entries.size())
+		return true;
+
+	Ref< IStream > file = FileSystem::getInstance().open(indexPath, File::FmWrite);
+	if (!file)
+		return false;
+
+	Ref< IStream > stream = new BufferedStream(file);
+	Writer writer(stream);
+
+	writer << c_indexVersion;
+	writer << count;
+
+	for (const auto& it : m_entries)
+	{
+		if (!it.second.accessed)
+			continue;
+
+		writer << it.first;
+		writer.write((const uint8_t*)it.second.guid, 16);
+		writer << it.second.lastWriteTime;
+		writer << it.second.size;
+	}
+
+	stream->close();
+	m_dirty = false;
+	return true;
+}
+
+Guid InstanceIndex::get(const Path& instanceMetaPath)
+{
+	const std::wstring key = instanceMetaPath.getPathName();
+
+	// Stat meta file before reading so a concurrent modification
+	// cannot be recorded with a stale guid.
+	Ref< File > file = FileSystem::getInstance().get(instanceMetaPath);
+	if (!file)
+		return Guid();
+
+	const uint64_t lastWriteTime = file->getLastWriteTime().getSecondsSinceEpoch();
+	const uint64_t size = file->getSize();
+
+	{
+		T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_lock);
+		Entry* entry = m_entries.find(key);
+		if (entry && entry->lastWriteTime == lastWriteTime && entry->size == size)
+		{
+			entry->accessed = true;
+			return entry->guid;
+		}
+	}
+
+	Ref< LocalInstanceMeta > instanceMeta = readPhysicalObject< LocalInstanceMeta >(instanceMetaPath);
+	if (!instanceMeta)
+		return Guid();
+
+	Entry entry;
+	entry.guid = instanceMeta->getGuid();
+	entry.lastWriteTime = lastWriteTime;
+	entry.size = size;
+	entry.accessed = true;
+
+	{
+		T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_lock);
+		m_entries[key] = entry;
+		m_dirty = true;
+	}
+
+	return entry.guid;
+}
+
+void InstanceIndex::invalidate(const Path& instanceMetaPath)
+{
+	T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_lock);
+	if (m_entries.remove(instanceMetaPath.getPathName()))
+		m_dirty = true;
+}
+
+}
@@ -0,0 +1,59 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Guid.h"
+#include "Core/Object.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Io/Path.h"
+#include "Core/Thread/SpinLock.h"
+
+namespace traktor::db
+{
+
+/*! Persistent index of instance guids.
+ * \ingroup Database
+ *
+ * Resolving an instance's guid require reading and parsing it's
+ * meta file; the index keep resolved guids together with the meta
+ * file's size and time stamp so unmodified instances are resolved
+ * without reading the meta file when database is opened again.
+ */
+class InstanceIndex : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	/*! Read index from file, entries are validated when accessed. */
+	bool read(const Path& indexPath);
+
+	/*! Write index to file; only entries accessed during session are written. */
+	bool write(const Path& indexPath);
+
+	/*! Get guid of instance; read from meta file if not indexed or modified. */
+	Guid get(const Path& instanceMetaPath);
+
+	/*! Invalidate indexed guid of instance. */
+	void invalidate(const Path& instanceMetaPath);
+
+private:
+	struct Entry
+	{
+		Guid guid;
+		uint64_t lastWriteTime = 0;
+		uint64_t size = 0;
+		bool accessed = false;
+	};
+
+	SpinLock m_lock;
+	HashMap< std::wstring, Entry > m_entries;
+	bool m_dirty = false;
+};
+
+}
@@ -13,6 +13,7 @@
 #include "Database/ConnectionString.h"
 #include "Database/Local/Context.h"
 #include "Database/Local/DefaultFileStore.h"
+#include "Database/Local/InstanceIndex.h"
 #include "Database/Local/LocalBus.h"
 #include "Database/Local/LocalDatabase.h"
 #include "Database/Local/LocalGroup.h"
@@ -50,6 +51,7 @@ bool LocalDatabase::open(const ConnectionString& connectionString)
 	const Path groupPath = FileSystem::getInstance().getAbsolutePath(connectionString.get(L"groupPath"));
 	const bool journal = connectionString.have(L"journal") ? parseString< bool >(connectionString.get(L"journal")) : true;
 	const bool binary = connectionString.have(L"binary") ? parseString< bool >(connectionString.get(L"binary")) : false;
+	const bool index = connectionString.have(L"index") ? parseString< bool >(connectionString.get(L"index")) : true;
 
 	// Ensure group path exists.
 	if (!FileSystem::getInstance().makeAllDirectories(groupPath))
@@ -91,10 +93,20 @@ bool LocalDatabase::open(const ConnectionString& connectionString)
 		}
 	}
 
+	// Read instance index, used to resolve instance guids without reading each instance's meta file.
+	Ref< InstanceIndex > instanceIndex;
+	if (index)
+	{
+		m_indexPath = groupPath.getPathName() + L"/Index.bin";
+		instanceIndex = new InstanceIndex();
+		instanceIndex->read(m_indexPath);
+	}
+
 	// Create context.
 	m_context = Context(
 		binary,
-		fileStore
+		fileStore,
+		instanceIndex
 	);
 
 	// Create event journal file.
@@ -125,6 +137,12 @@ void LocalDatabase::close()
 		m_bus = nullptr;
 	}
 
+	if (m_context.getInstanceIndex())
+	{
+		if (!m_context.getInstanceIndex()->write(m_indexPath))
+			log::warning << L"Unable to write instance index \"" << m_indexPath.getPathName() << L"\"." << Endl;
+	}
+
 	if (m_context.getFileStore())
 	{
 		m_context.getFileStore()->destroy();
@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include "Core/Io/Path.h"
 #include "Database/Local/Context.h"
 #include "Database/Provider/IProviderDatabase.h"
 
@@ -53,6 +54,7 @@ public:
 
 private:
 	Context m_context;
+	Path m_indexPath;
 	Ref< LocalBus > m_bus;
 	Ref< LocalGroup > m_rootGroup;
 };
@@ -15,6 +15,7 @@
 #include "Database/Types.h"
 #include "Database/Local/Context.h"
 #include "Database/Local/IFileStore.h"
+#include "Database/Local/InstanceIndex.h"
 #include "Database/Local/LocalInstance.h"
 #include "Database/Local/LocalInstanceMeta.h"
 #include "Database/Local/Transaction.h"
@@ -86,7 +87,13 @@ bool LocalInstance::commitTransaction()
 		return false;
 	}
 
-	if (!m_transaction->commit(m_context))
+	const bool result = m_transaction->commit(m_context);
+
+	// Meta file might have been rewritten within same time stamp resolution; always invalidate indexed guid.
+	if (m_context.getInstanceIndex())
+		m_context.getInstanceIndex()->invalidate(getInstanceMetaPath(m_instancePath));
+
+	if (!result)
 	{
 		log::error << L"commitTransaction failed; commit failed." << Endl;
 		return false;
@@ -130,6 +137,9 @@ bool LocalInstance::setName(const std::wstring& name)
 Guid LocalInstance::getGuid() const
 {
 	const Path instanceMetaPath = getInstanceMetaPath(m_instancePath);
+	if (m_context.getInstanceIndex())
+		return m_context.getInstanceIndex()->get(instanceMetaPath);
+
 	Ref< LocalInstanceMeta > instanceMeta = readPhysicalObject< LocalInstanceMeta >(instanceMetaPath);
 	return instanceMeta ? instanceMeta->getGuid() : Guid();
 }
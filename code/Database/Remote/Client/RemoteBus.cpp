@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Database/Events/EvtInstanceGuidChanged.h"
 #include "Database/Remote/Client/RemoteBus.h"
 #include "Database/Remote/Client/RemoteConnection.h"
 #include "Database/Remote/Messages/CnmReleaseObject.h"
@@ -28,7 +29,7 @@ RemoteBus::RemoteBus(RemoteConnection* connection, uint32_t handle)
 RemoteBus::~RemoteBus()
 {
 	if (m_connection)
-		m_connection->sendMessage< MsgStatus >(CnmReleaseObject(m_handle));
+		m_connection->postMessage(CnmReleaseObject(m_handle));
 }
 
 bool RemoteBus::putEvent(const IEvent* event)
@@ -50,6 +51,12 @@ bool RemoteBus::getEvent(uint64_t& inoutSqnr, Ref< const IEvent >& outEvent, boo
 	outEvent = result->getEvent();
 	outRemote = result->getRemote();
 
+	// Cached metadata of changed instance is stale.
+	if (auto instanceEvent = dynamic_type_cast< const EvtInstance* >(outEvent))
+		m_connection->invalidateInstanceMetadata(instanceEvent->getInstanceGuid());
+	if (auto guidChangedEvent = dynamic_type_cast< const EvtInstanceGuidChanged* >(outEvent))
+		m_connection->invalidateInstanceMetadata(guidChangedEvent->getInstancePreviousGuid());
+
 	return true;
 }
 
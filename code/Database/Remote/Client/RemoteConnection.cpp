@@ -8,7 +8,11 @@
  */
 #include "Core/Misc/SafeDestroy.h"
 #include "Core/Thread/Acquire.h"
+#include "Core/Thread/Signal.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
 #include "Database/Remote/Client/RemoteConnection.h"
+#include "Database/Remote/Messages/MsgEnvelope.h"
 #include "Net/BidirectionalObjectTransport.h"
 #include "Net/Socket.h"
 
@@ -21,14 +25,38 @@ RemoteConnection::RemoteConnection(net::Socket* socket)
 :	m_socket(socket)
 {
 	m_transport = new net::BidirectionalObjectTransport(m_socket);
+
+	m_receiverThread = ThreadManager::getInstance().create(
+		[this](){ threadReceiver(); },
+		L"Remote database receiver"
+	);
+	if (m_receiverThread)
+		m_receiverThread->start();
+	else
+		m_disconnected = true;
+}
+
+RemoteConnection::~RemoteConnection()
+{
+	destroy();
 }
 
 void RemoteConnection::destroy()
 {
+	if (m_receiverThread)
+	{
+		m_receiverThread->stop();
+		ThreadManager::getInstance().destroy(m_receiverThread);
+		m_receiverThread = nullptr;
+	}
+
 	if (m_transport)
 		m_transport = nullptr;
 
 	safeClose(m_socket);
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_metadataLock);
+	m_metadata.clear();
 }
 
 void RemoteConnection::setStreamServerAddr(const net::SocketAddressIPv4& streamServerAddr)
@@ -41,23 +69,110 @@ const net::SocketAddressIPv4& RemoteConnection::getStreamServerAddr() const
 	return m_streamServerAddr;
 }
 
-Ref< IMessage > RemoteConnection::sendMessage(const IMessage& message)
+bool RemoteConnection::postMessage(const IMessage& message)
 {
-	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_transportLock);
-	Ref< IMessage > reply;
+	Ref< net::BidirectionalObjectTransport > transport = m_transport;
+	if (!transport || m_disconnected)
+		return false;
 
-	if (!m_transport || !m_transport->connected())
-		return nullptr;
+	// Reply is discarded by receiver thread since no one is waiting for it.
+	uint32_t requestId;
+	while ((requestId = m_nextRequestId++) == 0)
+		;
 
-	m_transport->flush< IMessage >();
+	const MsgEnvelope envelope(requestId, &message);
+	return transport->send(&envelope);
+}
 
-	if (!m_transport->send(&message))
-		return nullptr;
+void RemoteConnection::setInstanceMetadata(uint32_t handle, const InstanceMetadata& metadata)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_metadataLock);
+	m_metadata[handle] = metadata;
+}
+
+bool RemoteConnection::getInstanceMetadata(uint32_t handle, InstanceMetadata& outMetadata) const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_metadataLock);
+	const auto it = m_metadata.find(handle);
+	if (it == m_metadata.end())
+		return false;
+
+	outMetadata = it->second;
+	return true;
+}
+
+void RemoteConnection::invalidateInstanceMetadata(uint32_t handle)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_metadataLock);
+	m_metadata.remove(handle);
+}
+
+void RemoteConnection::invalidateInstanceMetadata(const Guid& instanceGuid)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_metadataLock);
+	for (auto it = m_metadata.begin(); it != m_metadata.end(); )
+	{
+		if (it->second.guid == instanceGuid)
+			it = m_metadata.erase(it);
+		else
+			++it;
+	}
+}
 
-	if (m_transport->recv(60000, reply) != net::BidirectionalObjectTransport::Result::Success)
+Ref< IMessage > RemoteConnection::sendMessage(const IMessage& message)
+{
+	Ref< net::BidirectionalObjectTransport > transport = m_transport;
+	if (!transport)
 		return nullptr;
 
-	return reply;
+	uint32_t requestId;
+	while ((requestId = m_nextRequestId++) == 0)
+		;
+
+	Signal signal;
+	PendingReply pending = { &signal, nullptr };
+
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_pendingLock);
+		if (m_disconnected)
+			return nullptr;
+		m_pending.insert(requestId, &pending);
+	}
+
+
+	const MsgEnvelope envelope(requestId, &message);
+	const bool result = transport->send(&envelope) && signal.wait(60000);
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_pendingLock);
+	m_pending.remove(requestId);
+	return result ? pending.reply : nullptr;
+}
+
+void RemoteConnection::threadReceiver()
+{
+	while (!m_receiverThread->stopped())
+	{
+		Ref< MsgEnvelope > envelope;
+		const auto result = m_transport->recv< MsgEnvelope >(100, envelope);
+		if (result == net::BidirectionalObjectTransport::Result::Disconnected)
+			break;
+		else if (result != net::BidirectionalObjectTransport::Result::Success || !envelope)
+			continue;
+
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_pendingLock);
+		const auto it = m_pending.find(envelope->getRequestId());
+		if (it != m_pending.end())
+		{
+			it->second->reply = envelope->getMessage();
+			it->second->signal->set();
+		}
+	}
+
+	// Wake up all pending requests; they will not get a reply.
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_pendingLock);
+	m_disconnected = true;
+	for (auto it : m_pending)
+		it.second->signal->set();
 }
 
 }
@@ -8,7 +8,11 @@
  */
 #pragma once
 
+#include <atomic>
+#include <string>
+#include "Core/Guid.h"
 #include "Core/Object.h"
+#include "Core/Containers/SmallMap.h"
 #include "Core/Thread/Semaphore.h"
 #include "Database/Remote/Messages/MsgStatus.h"
 #include "Net/SocketAddressIPv4.h"
@@ -21,19 +25,42 @@ class Socket;
 
 }
 
+namespace traktor
+{
+
+class Signal;
+class Thread;
+
+}
+
 namespace traktor::db
 {
 
 /*! Database connection.
  * \ingroup Database
+ *
+ * Requests are tagged with an id and replies are
+ * dispatched by a receiver thread, thus several threads
+ * can have requests in flight over the same connection.
  */
 class RemoteConnection : public Object
 {
 	T_RTTI_CLASS;
 
 public:
+	/*! Cached metadata of a remote instance. */
+	struct InstanceMetadata
+	{
+		std::wstring name;
+		Guid guid;
+		std::wstring primaryTypeName;
+		uint64_t lastModifyDate = 0;
+	};
+
 	explicit RemoteConnection(net::Socket* socket);
 
+	virtual ~RemoteConnection();
+
 	void destroy();
 
 	void setStreamServerAddr(const net::SocketAddressIPv4& streamServerAddr);
@@ -47,13 +74,42 @@ public:
 		return dynamic_type_cast< ReplyMessageType* >(reply);
 	}
 
+	/*! Send message without waiting for reply. */
+	bool postMessage(const IMessage& message);
+
+	/*! Cache metadata of instance. */
+	void setInstanceMetadata(uint32_t handle, const InstanceMetadata& metadata);
+
+	/*! Get cached metadata of instance, return false if not cached. */
+	bool getInstanceMetadata(uint32_t handle, InstanceMetadata& outMetadata) const;
+
+	/*! Discard cached metadata of instance by handle. */
+	void invalidateInstanceMetadata(uint32_t handle);
+
+	/*! Discard cached metadata of instance by guid. */
+	void invalidateInstanceMetadata(const Guid& instanceGuid);
+
 private:
+	struct PendingReply
+	{
+		Signal* signal;
+		Ref< IMessage > reply;
+	};
+
 	Ref< net::Socket > m_socket;
 	net::SocketAddressIPv4 m_streamServerAddr;
 	Ref< net::BidirectionalObjectTransport > m_transport;
-	Semaphore m_transportLock;
+	Thread* m_receiverThread = nullptr;
+	Semaphore m_pendingLock;
+	SmallMap< uint32_t, PendingReply* > m_pending;
+	std::atomic< uint32_t > m_nextRequestId = 1;
+	std::atomic< bool > m_disconnected = false;
+	mutable Semaphore m_metadataLock;
+	SmallMap< uint32_t, InstanceMetadata > m_metadata;
 
 	Ref< IMessage > sendMessage(const IMessage& message);
+
+	void threadReceiver();
 };
 
 }
@@ -63,6 +63,9 @@ bool RemoteDatabase::open(const ConnectionString& connectionString)
 		return false;
 	}
 
+	// Several requests can be in flight; do not delay small messages.
+	socket->setNoDelay(true);
+
 	m_connection = new RemoteConnection(socket);
 
 	Ref< MsgIntResult > result = m_connection->sendMessage< MsgIntResult >(DbmOpen(database));
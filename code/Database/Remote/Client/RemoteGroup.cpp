@@ -16,8 +16,8 @@
 #include "Database/Remote/Messages/DbmRemoveGroup.h"
 #include "Database/Remote/Messages/DbmCreateGroup.h"
 #include "Database/Remote/Messages/DbmCreateInstance.h"
-#include "Database/Remote/Messages/DbmGetChildren.h"
-#include "Database/Remote/Messages/MsgGetChildrenResult.h"
+#include "Database/Remote/Messages/DbmGetChildrenMetadata.h"
+#include "Database/Remote/Messages/MsgGetChildrenMetadataResult.h"
 #include "Database/Remote/Messages/MsgStringResult.h"
 #include "Database/Remote/Messages/MsgHandleResult.h"
 #include "Database/Remote/Messages/MsgHandleArrayResult.h"
@@ -27,22 +27,28 @@ namespace traktor::db
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.db.RemoteGroup", RemoteGroup, IProviderGroup)
 
-RemoteGroup::RemoteGroup(RemoteConnection* connection, uint32_t handle)
+RemoteGroup::RemoteGroup(RemoteConnection* connection, uint32_t handle, const std::wstring& name)
 :	m_connection(connection)
 ,	m_handle(handle)
+,	m_name(name)
 {
 }
 
 RemoteGroup::~RemoteGroup()
 {
 	if (m_connection)
-		m_connection->sendMessage< MsgStatus >(CnmReleaseObject(m_handle));
+		m_connection->postMessage(CnmReleaseObject(m_handle));
 }
 
 std::wstring RemoteGroup::getName() const
 {
-	Ref< const MsgStringResult > result = m_connection->sendMessage< MsgStringResult >(DbmGetGroupName(m_handle));
-	return result ? result->get() : L"";
+	if (m_name.empty())
+	{
+		Ref< const MsgStringResult > result = m_connection->sendMessage< MsgStringResult >(DbmGetGroupName(m_handle));
+		if (result)
+			m_name = result->get();
+	}
+	return m_name;
 }
 
 uint32_t RemoteGroup::getFlags() const
@@ -53,6 +59,7 @@ uint32_t RemoteGroup::getFlags() const
 bool RemoteGroup::rename(const std::wstring& name)
 {
 	Ref< const MsgStatus > result = m_connection->sendMessage< MsgStatus >(DbmRenameGroup(m_handle));
+	m_name.clear();
 	return result ? result->getStatus() == StSuccess : false;
 }
 
@@ -76,15 +83,26 @@ Ref< IProviderInstance > RemoteGroup::createInstance(const std::wstring& instanc
 
 bool RemoteGroup::getChildren(RefArray< IProviderGroup >& outChildGroups, RefArray< IProviderInstance >& outChildInstances)
 {
-	Ref< MsgGetChildrenResult > result = m_connection->sendMessage< MsgGetChildrenResult >(DbmGetChildren(m_handle));
+	// Metadata of all children are received in a single reply; instance
+	// metadata is cached in connection to avoid a round-trip per getter.
+	Ref< MsgGetChildrenMetadataResult > result = m_connection->sendMessage< MsgGetChildrenMetadataResult >(DbmGetChildrenMetadata(m_handle));
 	if (!result)
 		return false;
 
-	for (auto group : result->getGroups())
-		outChildGroups.push_back(new RemoteGroup(m_connection, group));
+	for (const auto& group : result->getGroups())
+		outChildGroups.push_back(new RemoteGroup(m_connection, group.handle, group.name));
 
-	for (auto instance : result->getInstances())
-		outChildInstances.push_back(new RemoteInstance(m_connection, instance));
+	for (const auto& instance : result->getInstances())
+	{
+		RemoteConnection::InstanceMetadata metadata;
+		metadata.name = instance.name;
+		metadata.guid = instance.guid;
+		metadata.primaryTypeName = instance.primaryTypeName;
+		metadata.lastModifyDate = instance.lastModifyDate;
+		m_connection->setInstanceMetadata(instance.handle, metadata);
+
+		outChildInstances.push_back(new RemoteInstance(m_connection, instance.handle));
+	}
 
 	return true;
 }
@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <string>
 #include "Database/Provider/IProviderGroup.h"
 
 namespace traktor::db
@@ -23,7 +24,7 @@ class RemoteGroup : public IProviderGroup
 	T_RTTI_CLASS;
 
 public:
-	explicit RemoteGroup(RemoteConnection* connection, uint32_t handle);
+	explicit RemoteGroup(RemoteConnection* connection, uint32_t handle, const std::wstring& name = L"");
 
 	virtual ~RemoteGroup();
 
@@ -44,6 +45,7 @@ public:
 private:
 	Ref< RemoteConnection > m_connection;
 	uint32_t m_handle;
+	mutable std::wstring m_name;
 };
 
 }
@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Core/Date/DateTime.h"
 #include "Core/Io/BufferedStream.h"
 #include "Database/Types.h"
 #include "Database/Remote/Client/RemoteInstance.h"
@@ -48,11 +49,18 @@ RemoteInstance::RemoteInstance(RemoteConnection* connection, uint32_t handle)
 RemoteInstance::~RemoteInstance()
 {
 	if (m_connection)
-		m_connection->sendMessage< MsgStatus >(CnmReleaseObject(m_handle));
+	{
+		m_connection->invalidateInstanceMetadata(m_handle);
+		m_connection->postMessage(CnmReleaseObject(m_handle));
+	}
 }
 
 std::wstring RemoteInstance::getPrimaryTypeName() const
 {
+	RemoteConnection::InstanceMetadata metadata;
+	if (m_connection->getInstanceMetadata(m_handle, metadata))
+		return metadata.primaryTypeName;
+
 	Ref< const MsgStringResult > result = m_connection->sendMessage< MsgStringResult >(DbmGetInstancePrimaryType(m_handle));
 	return result ? result->get() : L"";
 }
@@ -66,6 +74,7 @@ bool RemoteInstance::openTransaction()
 bool RemoteInstance::commitTransaction()
 {
 	Ref< const MsgStatus > result = m_connection->sendMessage< MsgStatus >(DbmCommitTransaction(m_handle));
+	m_connection->invalidateInstanceMetadata(m_handle);
 	return result ? result->getStatus() == StSuccess : false;
 }
 
@@ -77,6 +86,10 @@ bool RemoteInstance::closeTransaction()
 
 std::wstring RemoteInstance::getName() const
 {
+	RemoteConnection::InstanceMetadata metadata;
+	if (m_connection->getInstanceMetadata(m_handle, metadata))
+		return metadata.name;
+
 	Ref< const MsgStringResult > result = m_connection->sendMessage< MsgStringResult >(DbmGetInstanceName(m_handle));
 	return result ? result->get() : L"";
 }
@@ -84,11 +97,16 @@ std::wstring RemoteInstance::getName() const
 bool RemoteInstance::setName(const std::wstring& name)
 {
 	Ref< const MsgStatus > result = m_connection->sendMessage< MsgStatus >(DbmSetInstanceName(m_handle, name));
+	m_connection->invalidateInstanceMetadata(m_handle);
 	return result ? result->getStatus() == StSuccess : false;
 }
 
 Guid RemoteInstance::getGuid() const
 {
+	RemoteConnection::InstanceMetadata metadata;
+	if (m_connection->getInstanceMetadata(m_handle, metadata))
+		return metadata.guid;
+
 	Ref< const MsgGuidResult > result = m_connection->sendMessage< MsgGuidResult >(DbmGetInstanceGuid(m_handle));
 	return result ? result->get() : Guid();
 }
@@ -96,12 +114,19 @@ Guid RemoteInstance::getGuid() const
 bool RemoteInstance::setGuid(const Guid& guid)
 {
 	Ref< const MsgStatus > result = m_connection->sendMessage< MsgStatus >(DbmSetInstanceGuid(m_handle, guid));
+	m_connection->invalidateInstanceMetadata(m_handle);
 	return result ? result->getStatus() == StSuccess : false;
 }
 
 bool RemoteInstance::getLastModifyDate(DateTime& outModifyDate) const
 {
-	return false;
+	// Only known if instance has been enumerated with metadata.
+	RemoteConnection::InstanceMetadata metadata;
+	if (!m_connection->getInstanceMetadata(m_handle, metadata) || metadata.lastModifyDate == 0)
+		return false;
+
+	outModifyDate = DateTime(metadata.lastModifyDate);
+	return true;
 }
 
 uint32_t RemoteInstance::getFlags() const
@@ -112,6 +137,7 @@ uint32_t RemoteInstance::getFlags() const
 bool RemoteInstance::remove()
 {
 	Ref< const MsgStatus > result = m_connection->sendMessage< MsgStatus >(DbmRemoveInstance(m_handle));
+	m_connection->invalidateInstanceMetadata(m_handle);
 	return result ? result->getStatus() == StSuccess : false;
 }
 
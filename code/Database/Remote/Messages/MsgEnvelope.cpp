@@ -0,0 +1,31 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Serialization/ISerializer.h"
+#include "Core/Serialization/Member.h"
+#include "Core/Serialization/MemberRef.h"
+#include "Database/Remote/Messages/MsgEnvelope.h"
+
+namespace traktor::db
+{
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.db.MsgEnvelope", 0, MsgEnvelope, IMessage)
+
+MsgEnvelope::MsgEnvelope(uint32_t requestId, const IMessage* message)
+:	m_requestId(requestId)
+,	m_message(const_cast< IMessage* >(message))
+{
+}
+
+void MsgEnvelope::serialize(ISerializer& s)
+{
+	s >> Member< uint32_t >(L"requestId", m_requestId);
+	s >> MemberRef< IMessage >(L"message", m_message);
+}
+
+}
@@ -0,0 +1,52 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Ref.h"
+#include "Database/Remote/IMessage.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_DATABASE_REMOTE_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::db
+{
+
+/*! Request or reply tagged with a request id.
+ * \ingroup Database
+ *
+ * Replies carry the id of the request so a client
+ * can have several requests in flight and match
+ * replies in any order.
+ */
+class T_DLLCLASS MsgEnvelope : public IMessage
+{
+	T_RTTI_CLASS;
+
+public:
+	MsgEnvelope() = default;
+
+	explicit MsgEnvelope(uint32_t requestId, const IMessage* message);
+
+	uint32_t getRequestId() const { return m_requestId; }
+
+	IMessage* getMessage() const { return m_message; }
+
+	virtual void serialize(ISerializer& s) override final;
+
+private:
+	uint32_t m_requestId = 0;
+	Ref< IMessage > m_message;
+};
+
+}
@@ -0,0 +1,41 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Serialization/ISerializer.h"
+#include "Core/Serialization/Member.h"
+#include "Core/Serialization/MemberAlignedVector.h"
+#include "Core/Serialization/MemberComposite.h"
+#include "Database/Remote/Messages/MsgGetChildrenMetadataResult.h"
+
+namespace traktor::db
+{
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.db.MsgGetChildrenMetadataResult", 0, MsgGetChildrenMetadataResult, IMessage)
+
+void MsgGetChildrenMetadataResult::serialize(ISerializer& s)
+{
+	s >> MemberAlignedVector< Group, MemberComposite< Group > >(L"groups", m_groups);
+	s >> MemberAlignedVector< Instance, MemberComposite< Instance > >(L"instances", m_instances);
+}
+
+void MsgGetChildrenMetadataResult::Group::serialize(ISerializer& s)
+{
+	s >> Member< uint32_t >(L"handle", handle);
+	s >> Member< std::wstring >(L"name", name);
+}
+
+void MsgGetChildrenMetadataResult::Instance::serialize(ISerializer& s)
+{
+	s >> Member< uint32_t >(L"handle", handle);
+	s >> Member< std::wstring >(L"name", name);
+	s >> Member< Guid >(L"guid", guid);
+	s >> Member< std::wstring >(L"primaryTypeName", primaryTypeName);
+	s >> Member< uint64_t >(L"lastModifyDate", lastModifyDate);
+}
+
+}
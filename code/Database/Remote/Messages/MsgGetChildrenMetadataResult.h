@@ -0,0 +1,69 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <string>
+#include "Core/Guid.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Database/Remote/IMessage.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_DATABASE_REMOTE_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::db
+{
+
+/*! Get children with metadata result.
+ * \ingroup Database
+ */
+class T_DLLCLASS MsgGetChildrenMetadataResult : public IMessage
+{
+	T_RTTI_CLASS;
+
+public:
+	struct Group
+	{
+		uint32_t handle = 0;
+		std::wstring name;
+
+		void serialize(ISerializer& s);
+	};
+
+	struct Instance
+	{
+		uint32_t handle = 0;
+		std::wstring name;
+		Guid guid;
+		std::wstring primaryTypeName;
+		uint64_t lastModifyDate = 0;	//!< Seconds since epoch, 0 if unknown.
+
+		void serialize(ISerializer& s);
+	};
+
+	Group& addGroup() { return m_groups.push_back(); }
+
+	Instance& addInstance() { return m_instances.push_back(); }
+
+	const AlignedVector< Group >& getGroups() const { return m_groups; }
+
+	const AlignedVector< Instance >& getInstances() const { return m_instances; }
+
+	virtual void serialize(ISerializer& s) override final;
+
+private:
+	AlignedVector< Group > m_groups;
+	AlignedVector< Instance > m_instances;
+};
+
+}
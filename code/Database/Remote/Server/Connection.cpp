@@ -8,6 +8,7 @@
  */
 #include "Core/Log/Log.h"
 #include "Database/Remote/IMessage.h"
+#include "Database/Remote/Messages/MsgEnvelope.h"
 #include "Database/Remote/Server/BusMessageListener.h"
 #include "Database/Remote/Server/Connection.h"
 #include "Database/Remote/Server/ConnectionMessageListener.h"
@@ -35,6 +36,7 @@ Connection::Connection(
 :	m_streamServer(streamServer)
 ,	m_clientSocket(clientSocket)
 ,	m_nextHandle(1)
+,	m_replyId(0)
 {
 	m_transport = new net::BidirectionalObjectTransport(clientSocket);
 
@@ -71,6 +73,16 @@ bool Connection::process()
 	if (!message)
 		return false;
 
+	// Replies to enveloped requests are tagged with the same request id.
+	m_replyId = 0;
+	if (auto envelope = dynamic_type_cast< MsgEnvelope* >(message))
+	{
+		m_replyId = envelope->getRequestId();
+		message = envelope->getMessage();
+		if (!message)
+			return false;
+	}
+
 	for (auto listener : m_messageListeners)
 	{
 		if (listener->notify(message))
@@ -91,7 +103,16 @@ bool Connection::process()
 
 void Connection::sendReply(const IMessage& message)
 {
-	if (!m_transport->send(&message))
+	bool result;
+	if (m_replyId != 0)
+	{
+		const MsgEnvelope envelope(m_replyId, &message);
+		result = m_transport->send(&envelope);
+	}
+	else
+		result = m_transport->send(&message);
+
+	if (!result)
 	{
 		log::error << L"Unable to send reply (" << type_name(&message) << L"); connection terminated." << Endl;
 		destroy();
@@ -82,6 +82,7 @@ private:
 	RefArray< IMessageListener > m_messageListeners;
 	SmallMap< uint32_t, Ref< Object > > m_objectStore;
 	uint32_t m_nextHandle;
+	uint32_t m_replyId;
 	Ref< IProviderDatabase > m_database;
 
 	void messageThread();
@@ -28,6 +28,7 @@ ConnectionManager::ConnectionManager(net::StreamServer* streamServer)
 :	m_streamServer(streamServer)
 ,	m_listenPort(0)
 ,	m_serverThread(nullptr)
+,	m_messageCount(0)
 {
 }
 
@@ -120,6 +121,8 @@ void ConnectionManager::threadServer()
 			if (!clientSocket)
 				continue;
 
+			clientSocket->setNoDelay(true);
+
 			Ref< Connection > connection = new Connection(m_connectionStringsLock, m_connectionStrings, m_streamServer, clientSocket);
 			m_connections.push_back(connection);
 
@@ -150,6 +153,8 @@ void ConnectionManager::threadServer()
 				m_connections.erase(it);
 				closed++;
 			}
+			else
+				m_messageCount++;
 		}
 		if (closed)
 			log::info << closed << L" remote database connection(s) removed." << Endl;
@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <string>
 #include "Core/Object.h"
 #include "Core/RefArray.h"
@@ -60,6 +61,9 @@ public:
 
 	uint16_t getListenPort() const;
 
+	/*! Number of messages processed, for diagnostics. */
+	uint32_t getMessageCount() const { return m_messageCount; }
+
 private:
 	Ref< net::StreamServer > m_streamServer;
 	uint16_t m_listenPort;
@@ -68,6 +72,7 @@ private:
 	RefArray< Connection > m_connections;
 	Semaphore m_connectionStringsLock;
 	SmallMap< std::wstring, std::wstring > m_connectionStrings;
+	std::atomic< uint32_t > m_messageCount;
 
 	void threadServer();
 };
@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Core/Date/DateTime.h"
 #include "Database/Provider/IProviderGroup.h"
 #include "Database/Provider/IProviderInstance.h"
 #include "Database/Remote/Server/Connection.h"
@@ -16,7 +17,9 @@
 #include "Database/Remote/Messages/DbmCreateGroup.h"
 #include "Database/Remote/Messages/DbmCreateInstance.h"
 #include "Database/Remote/Messages/DbmGetChildren.h"
+#include "Database/Remote/Messages/DbmGetChildrenMetadata.h"
 #include "Database/Remote/Messages/MsgGetChildrenResult.h"
+#include "Database/Remote/Messages/MsgGetChildrenMetadataResult.h"
 #include "Database/Remote/Messages/MsgStatus.h"
 #include "Database/Remote/Messages/MsgStringResult.h"
 #include "Database/Remote/Messages/MsgHandleResult.h"
@@ -38,6 +41,7 @@ GroupMessageListener::GroupMessageListener(Connection* connection)
 	registerMessage< DbmCreateGroup >(&GroupMessageListener::messageCreateGroup);
 	registerMessage< DbmCreateInstance >(&GroupMessageListener::messageCreateInstance);
 	registerMessage< DbmGetChildren >(&GroupMessageListener::messageGetChildren);
+	registerMessage< DbmGetChildrenMetadata >(&GroupMessageListener::messageGetChildrenMetadata);
 }
 
 bool GroupMessageListener::messageGetGroupName(const DbmGetGroupName* message)
@@ -157,5 +161,48 @@ bool GroupMessageListener::messageGetChildren(const DbmGetChildren* message)
 	return true;
 }
 
+bool GroupMessageListener::messageGetChildrenMetadata(const DbmGetChildrenMetadata* message)
+{
+	const uint32_t groupHandle = message->getHandle();
+	Ref< IProviderGroup > group = m_connection->getObject< IProviderGroup >(groupHandle);
+	if (!group)
+	{
+		m_connection->sendReply(MsgStatus(StFailure));
+		return true;
+	}
+
+	RefArray< IProviderGroup > childGroups;
+	RefArray< IProviderInstance > childInstances;
+
+	if (!group->getChildren(childGroups, childInstances))
+	{
+		m_connection->sendReply(MsgStatus(StFailure));
+		return true;
+	}
+
+	MsgGetChildrenMetadataResult result;
+	for (auto childGroup : childGroups)
+	{
+		auto& g = result.addGroup();
+		g.handle = m_connection->putObject(childGroup);
+		g.name = childGroup->getName();
+	}
+	for (auto childInstance : childInstances)
+	{
+		auto& i = result.addInstance();
+		i.handle = m_connection->putObject(childInstance);
+		i.name = childInstance->getName();
+		i.guid = childInstance->getGuid();
+		i.primaryTypeName = childInstance->getPrimaryTypeName();
+
+		DateTime lastModifyDate;
+		if (childInstance->getLastModifyDate(lastModifyDate))
+			i.lastModifyDate = lastModifyDate.getSecondsSinceEpoch();
+	}
+
+	m_connection->sendReply(result);
+	return true;
+}
+
 	}
 }
@@ -41,6 +41,8 @@ private:
 	bool messageCreateInstance(const class DbmCreateInstance* message);
 
 	bool messageGetChildren(const class DbmGetChildren* message);
+
+	bool messageGetChildrenMetadata(const class DbmGetChildrenMetadata* message);
 };
 
 	}
@@ -0,0 +1,191 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <atomic>
+#include "Core/Log/Log.h"
+#include "Core/Misc/String.h"
+#include "Core/Settings/PropertyInteger.h"
+#include "Core/System/OS.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Core/Timer/Timer.h"
+#include "Database/ConnectionString.h"
+#include "Database/Database.h"
+#include "Database/Group.h"
+#include "Database/Instance.h"
+#include "Database/Remote/Server/ConnectionManager.h"
+#include "Database/Remote/Server/Test/CaseRemoteDatabase.h"
+#include "Net/Network.h"
+#include "Net/Stream/StreamServer.h"
+
+namespace traktor::db::test
+{
+	namespace
+	{
+
+const int32_t c_instanceCount = 2000;
+const int32_t c_readerCount = 4;
+
+std::wstring localConnectionString()
+{
+	return L"provider=traktor.db.LocalDatabase;groupPath=" + OS::getInstance().getWritableFolderPath() + L"/Test/RemoteDatabase";
+}
+
+Ref< Database > openRemote(uint16_t port)
+{
+	Ref< Database > database = new Database();
+	if (!database->open(ConnectionString(L"provider=traktor.db.RemoteDatabase;host=localhost:" + toString(port) + L";database=Test")))
+		return nullptr;
+	return database;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.db.test.CaseRemoteDatabase", 0, CaseRemoteDatabase, traktor::test::Case)
+
+void CaseRemoteDatabase::run()
+{
+	// Populate local database which is then served to remote clients.
+	{
+		Ref< Database > database = new Database();
+		CASE_ASSERT(database->create(ConnectionString(localConnectionString())));
+
+		int32_t created = 0;
+		for (int32_t i = 0; i < c_instanceCount; ++i)
+		{
+			Ref< Instance > instance = database->createInstance(str(L"Assets/Instance%d", i), CifReplaceExisting);
+			if (instance && instance->setObject(new PropertyInteger(i)) && instance->commit())
+				created++;
+		}
+		CASE_ASSERT_EQUAL(created, c_instanceCount);
+
+		database->close();
+	}
+
+	CASE_ASSERT(net::Network::initialize());
+
+	Ref< net::StreamServer > streamServer = new net::StreamServer();
+	CASE_ASSERT(streamServer->create());
+
+	Ref< ConnectionManager > connectionManager = new ConnectionManager(streamServer);
+	CASE_ASSERT(connectionManager->create());
+	connectionManager->setConnectionString(L"Test", localConnectionString());
+
+	// Open and enumerate all instances, names, guids and types are received in a single reply per group.
+	const uint32_t messageCount = connectionManager->getMessageCount();
+	Timer timer;
+
+	Ref< Database > database = openRemote(connectionManager->getListenPort());
+	CASE_ASSERT(database != nullptr);
+	if (database)
+	{
+		RefArray< Instance > instances;
+		Ref< Group > group = database->getGroup(L"Assets");
+		if (group)
+			group->getChildInstances(instances);
+
+		int32_t valid = 0;
+		for (auto instance : instances)
+		{
+			if (
+				startsWith(instance->getName(), L"Instance") &&
+				instance->getGuid().isNotNull() &&
+				instance->getPrimaryType() == &type_of< PropertyInteger >()
+			)
+				valid++;
+		}
+		CASE_ASSERT_EQUAL(valid, c_instanceCount);
+
+		const uint32_t messages = connectionManager->getMessageCount() - messageCount;
+		CASE_ASSERT(messages < 20);
+
+		log::info << L"Remote database, " << c_instanceCount << L" instance(s) enumerated in " << messages << L" message(s), " << int32_t(timer.getElapsedTime() * 1000.0) << L" ms" << Endl;
+	}
+
+	// Several threads with requests in flight on the same connection.
+	if (database)
+	{
+		std::atomic< int32_t > mismatches = 0;
+		Thread* readers[c_readerCount];
+
+		timer.reset();
+		for (int32_t i = 0; i < c_readerCount; ++i)
+		{
+			readers[i] = ThreadManager::getInstance().create([&, i](){
+				for (int32_t j = i; j < c_instanceCount; j += c_readerCount)
+				{
+					Ref< Instance > instance = database->getInstance(str(L"Assets/Instance%d", j));
+					Ref< PropertyInteger > object = instance ? instance->getObject< PropertyInteger >() : nullptr;
+					if (!object || PropertyInteger::get(object) != j)
+						mismatches++;
+				}
+			});
+			CASE_ASSERT(readers[i] != nullptr);
+			if (readers[i])
+				readers[i]->start();
+		}
+		for (int32_t i = 0; i < c_readerCount; ++i)
+		{
+			if (readers[i])
+			{
+				readers[i]->wait();
+				ThreadManager::getInstance().destroy(readers[i]);
+			}
+		}
+
+		CASE_ASSERT_EQUAL((int32_t)mismatches, 0);
+		log::info << L"Remote database, " << c_instanceCount << L" object(s) read from " << c_readerCount << L" thread(s) in " << int32_t(timer.getElapsedTime() * 1000.0) << L" ms" << Endl;
+	}
+
+	// Guid changed by another client; cached metadata must be invalidated through bus event.
+	if (database)
+	{
+		const Guid newGuid = Guid::create();
+
+		Ref< Database > other = openRemote(connectionManager->getListenPort());
+		CASE_ASSERT(other != nullptr);
+		if (other)
+		{
+			Ref< Instance > instance = other->getInstance(L"Assets/Instance0");
+			CASE_ASSERT(instance != nullptr);
+			if (instance)
+			{
+				CASE_ASSERT(instance->checkout());
+				CASE_ASSERT(instance->setGuid(newGuid));
+				CASE_ASSERT(instance->commit());
+			}
+			other->close();
+		}
+
+		Ref< Instance > changed;
+		for (timer.reset(); !changed && timer.getElapsedTime() < 5.0; )
+		{
+			Ref< const IEvent > event;
+			bool remote;
+			while (database->getEvent(event, remote))
+				;
+
+			if (!(changed = database->getInstance(newGuid)))
+				ThreadManager::getInstance().getCurrentThread()->sleep(10);
+		}
+
+		CASE_ASSERT(changed != nullptr);
+		if (changed)
+			CASE_ASSERT(changed->getGuid() == newGuid);
+	}
+
+	if (database)
+		database->close();
+
+	connectionManager->destroy();
+	streamServer->destroy();
+
+	net::Network::finalize();
+}
+
+}
@@ -1833,7 +1833,9 @@ void EditorForm::buildAssetsThread(AlignedVector< Guid > assetGuids, bool rebuil
 			m_pipelineDb,
 			&instanceCache,
 			this,
-			verbose);
+			verbose,
+			m_mergedSettings->getProperty< int32_t >(L"Pipeline.BuildThreads", 1),
+			(uint64_t)m_mergedSettings->getProperty< int32_t >(L"Pipeline.BuildMemoryCap", 0) * 1024 * 1024);
 
 		if (rebuild)
 			log::info << L"Rebuilding " << dependencySet.size() << L" asset(s)..." << Endl;
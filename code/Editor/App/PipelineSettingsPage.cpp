@@ -45,6 +45,13 @@ bool PipelineSettingsPage::create(ui::Container* parent, const PropertyGroup* or
 	m_checkDependsThreads->create(container, i18n::Text(L"EDITOR_SETTINGS_PIPELINE_DEPENDS_THREADS"));
 	m_checkDependsThreads->setChecked(dependsThreads);
 
+	// Build threads and memory cap (MiB) of parallel builds.
+	m_editBuildThreads = new ui::Edit();
+	m_editBuildThreads->create(container, toString(settings->getProperty< int32_t >(L"Pipeline.BuildThreads", 1)), ui::WsNone, new ui::NumericEditValidator(false, 1, 256));
+
+	m_editBuildMemoryCap = new ui::Edit();
+	m_editBuildMemoryCap->create(container, toString(settings->getProperty< int32_t >(L"Pipeline.BuildMemoryCap", 0)), ui::WsNone, new ui::NumericEditValidator(false, 0));
+
 	// Avalanche
 	bool avalancheEnable = settings->getProperty< bool >(L"Pipeline.AvalancheCache", false);
 
@@ -115,6 +122,8 @@ bool PipelineSettingsPage::apply(PropertyGroup* settings)
 	settings->setProperty< PropertyBoolean >(L"Pipeline.Verbose", m_checkVerbose->isChecked());
 
 	settings->setProperty< PropertyBoolean >(L"Pipeline.DependsThreads", m_checkDependsThreads->isChecked());
+	settings->setProperty< PropertyInteger >(L"Pipeline.BuildThreads", parseString< int32_t >(m_editBuildThreads->getText()));
+	settings->setProperty< PropertyInteger >(L"Pipeline.BuildMemoryCap", parseString< int32_t >(m_editBuildMemoryCap->getText()));
 
 	settings->setProperty< PropertyBoolean >(L"Pipeline.AvalancheCache", m_checkUseAvalanche->isChecked());
 	settings->setProperty< PropertyString >(L"Pipeline.AvalancheCache.Host", m_editAvalancheHost->getText());
@@ -148,7 +148,7 @@ void AvalanchePipelineCache::getInformation(OutputStream& os)
 		os << L"disabled";
 	os << L", " << m_stats.blobCount << L" blobs, " << formatByteSize(m_stats.memoryUsage);
 	if (m_accessRead)
-		os << L", " << m_hits << L" hits, " << m_misses << L" misses";
+		os << L", " << m_hits.load() << L" hits, " << m_misses.load() << L" misses";
 	os << L")";
 }
 
@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include "Avalanche/Dictionary.h"
 #include "Editor/IPipelineCache.h"
 
@@ -63,8 +64,8 @@ private:
 	Ref< avalanche::Client > m_client;
 	bool m_accessRead = true;
 	bool m_accessWrite = true;
-	uint32_t m_hits = 0;
-	uint32_t m_misses = 0;
+	std::atomic< uint32_t > m_hits = 0;
+	std::atomic< uint32_t > m_misses = 0;
 	Ref< Job > m_statsJob;
 	avalanche::Dictionary::Stats m_stats;
 };
@@ -146,7 +146,7 @@ void FilePipelineCache::getInformation(OutputStream& os)
 	else
 		os << L"disabled";
 	if (m_accessRead)
-		os << L", " << m_hits << L" hits, " << m_misses << L" misses";
+		os << L", " << m_hits.load() << L" hits, " << m_misses.load() << L" misses";
 	os << L")";
 }
 
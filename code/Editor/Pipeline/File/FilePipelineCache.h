@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include "Editor/IPipelineCache.h"
 
 // import/export mechanism.
@@ -46,8 +47,8 @@ private:
 	bool m_accessRead = true;
 	bool m_accessWrite = true;
 	std::wstring m_path;
-	uint32_t m_hits = 0;
-	uint32_t m_misses = 0;
+	std::atomic< uint32_t > m_hits = 0;
+	std::atomic< uint32_t > m_misses = 0;
 };
 
 }
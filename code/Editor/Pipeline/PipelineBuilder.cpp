@@ -9,6 +9,7 @@
 #include "Core/Io/Reader.h"
 #include "Core/Io/Writer.h"
 #include "Core/Log/Log.h"
+#include "Core/Memory/Alloc.h"
 #include "Core/Misc/EnterLeave.h"
 #include "Core/Misc/String.h"
 #include "Core/Serialization/DeepClone.h"
@@ -16,6 +17,8 @@
 #include "Core/Settings/PropertyGroup.h"
 #include "Core/Settings/PropertyInteger.h"
 #include "Core/System/OS.h"
+#include "Core/Thread/Acquire.h"
+#include "Core/Thread/Event.h"
 #include "Core/Thread/Thread.h"
 #include "Core/Thread/ThreadManager.h"
 #include "Core/Timer/Timer.h"
@@ -116,7 +119,9 @@ PipelineBuilder::PipelineBuilder(
 	IPipelineDb* pipelineDb,
 	IPipelineInstanceCache* instanceCache,
 	IListener* listener,
-	bool verbose
+	bool verbose,
+	int32_t buildThreads,
+	uint64_t buildMemoryCap
 )
 :	m_pipelineFactory(pipelineFactory)
 ,	m_sourceDatabase(sourceDatabase)
@@ -126,10 +131,11 @@ PipelineBuilder::PipelineBuilder(
 ,	m_instanceCache(instanceCache)
 ,	m_listener(listener)
 ,	m_verbose(verbose)
+,	m_buildThreads(buildThreads)
+,	m_buildMemoryCap(buildMemoryCap)
 ,	m_rebuild(false)
 ,	m_profiler(new PipelineProfiler())
 ,	m_dependencySet(nullptr)
-,	m_adHocDepth(0)
 ,	m_progressEnd(0)
 ,	m_progress(0)
 ,	m_succeeded(0)
@@ -159,6 +165,7 @@ bool PipelineBuilder::build(const PipelineDependencySet* dependencySet, bool reb
 		Ref< const PipelineDependency > dependency;
 		Ref< const Object > buildParams;
 		uint32_t reason;
+		uint32_t index;
 	};
 	AlignedVector< Work > workSet;
 	Timer timer;
@@ -304,7 +311,7 @@ bool PipelineBuilder::build(const PipelineDependencySet* dependencySet, bool reb
 		}
 
 		if (reasons[i] != 0)
-			workSet.push_back({ dependency, nullptr, reasons[i] });
+			workSet.push_back({ dependency, nullptr, reasons[i], i });
 	}
 
 	T_DEBUG(L"Pipeline build; analyzed build reasons in " << formatDuration(timer.getDeltaTime()) << L".");
@@ -323,17 +330,16 @@ bool PipelineBuilder::build(const PipelineDependencySet* dependencySet, bool reb
 	m_cacheVoid = 0;	// No hash on source asset will result in a void.
 	m_dependencySet = dependencySet;
 
-	for (const auto& w : workSet)
-	{
-		if (ThreadManager::getInstance().getCurrentThread()->stopped())
-			break;
-
+	auto performWork = [&](const Work& w) {
 		if (m_listener)
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_listenerLock);
 			m_listener->beginBuild(
 				m_progress,
 				m_progressEnd,
 				w.dependency
 			);
+		}
 
 		const BuildResult result = performBuild(dependencySet, w.dependency, w.buildParams, w.reason);
 		if (result == BuildResult::Succeeded || result == BuildResult::SucceededWithWarnings)
@@ -342,19 +348,165 @@ bool PipelineBuilder::build(const PipelineDependencySet* dependencySet, bool reb
 			m_failed++;
 
 		if (m_listener)
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_listenerLock);
 			m_listener->endBuild(
 				m_progress,
 				m_progressEnd,
 				w.dependency,
 				result
 			);
+		}
 
 		m_progress++;
+	};
+
+	Thread* currentThread = ThreadManager::getInstance().getCurrentThread();
+	const int32_t buildThreads = std::min< int32_t >(m_buildThreads, (int32_t)workSet.size());
+
+	if (buildThreads <= 1)
+	{
+		for (const auto& w : workSet)
+		{
+			if (currentThread->stopped())
+				break;
+
+			performWork(w);
+		}
+	}
+	else
+	{
+		if (m_verbose)
+			log::info << L"Building using " << buildThreads << L" thread(s)..." << Endl;
+
+		// Map dependency index into work set index.
+		AlignedVector< int32_t > workIndices(dependencyCount, -1);
+		for (uint32_t i = 0; i < (uint32_t)workSet.size(); ++i)
+			workIndices[workSet[i].index] = (int32_t)i;
+
+		// Count pending children of each work item; children which are not
+		// part of the work set are already up-to-date.
+		AlignedVector< AlignedVector< uint32_t > > dependents(workSet.size());
+		AlignedVector< int32_t > pending(workSet.size(), 0);
+		AlignedVector< bool > scheduled(workSet.size(), false);
+		for (uint32_t i = 0; i < (uint32_t)workSet.size(); ++i)
+		{
+			for (auto child : workSet[i].dependency->children)
+			{
+				const int32_t childWork = workIndices[child];
+				if (childWork < 0 || childWork == (int32_t)i)
+					continue;
+
+				dependents[childWork].push_back(i);
+				pending[i]++;
+			}
+		}
+
+		AlignedVector< uint32_t > ready;
+		for (uint32_t i = 0; i < (uint32_t)workSet.size(); ++i)
+		{
+			if (pending[i] == 0)
+				ready.push_back(i);
+		}
+
+		Semaphore scheduleLock;
+		Event scheduleEvent;
+		uint32_t readyHead = 0;
+		int32_t remaining = (int32_t)workSet.size();
+		int32_t running = 0;
+
+		auto buildThread = [&]() {
+			ThreadState threadState;
+			m_threadState.set(&threadState);
+
+			for (;;)
+			{
+				int32_t work = -1;
+				{
+					T_ANONYMOUS_VAR(Acquire< Semaphore >)(scheduleLock);
+					while (remaining > 0 && !currentThread->stopped())
+					{
+						// Hold back new builds while memory cap is exceeded, unless nothing else is running.
+						const bool memoryAvailable = (m_buildMemoryCap == 0 || running == 0 || Alloc::allocated() < m_buildMemoryCap);
+
+						while (readyHead < ready.size() && scheduled[ready[readyHead]])
+							++readyHead;
+
+						if (readyHead < ready.size() && memoryAvailable)
+						{
+							work = (int32_t)ready[readyHead++];
+							break;
+						}
+
+						// Nothing ready nor running; dependencies must be cyclic so
+						// break cycle by building first unscheduled item.
+						if (readyHead >= ready.size() && running == 0)
+						{
+							for (uint32_t i = 0; i < (uint32_t)workSet.size(); ++i)
+							{
+								if (!scheduled[i])
+								{
+									work = (int32_t)i;
+									break;
+								}
+							}
+							break;
+						}
+
+						scheduleLock.release();
+						scheduleEvent.wait(100);
+						scheduleLock.wait();
+					}
+
+					if (work < 0)
+						break;
+
+					scheduled[work] = true;
+					running++;
+				}
+
+				performWork(workSet[work]);
+
+				{
+					T_ANONYMOUS_VAR(Acquire< Semaphore >)(scheduleLock);
+					for (auto dependent : dependents[work])
+					{
+						if (--pending[dependent] == 0 && !scheduled[dependent])
+							ready.push_back(dependent);
+					}
+					running--;
+					remaining--;
+				}
+				scheduleEvent.broadcast();
+			}
+
+			m_threadState.set(nullptr);
+			scheduleEvent.broadcast();
+		};
+
+		AlignedVector< Thread* > threads;
+		for (int32_t i = 0; i < buildThreads - 1; ++i)
+		{
+			Thread* thread = ThreadManager::getInstance().create(buildThread, L"Pipeline build thread");
+			if (!thread)
+				break;
+			thread->start();
+			threads.push_back(thread);
+		}
+
+		// Calling thread participate in building as well.
+		buildThread();
+
+		for (auto thread : threads)
+		{
+			thread->wait();
+			ThreadManager::getInstance().destroy(thread);
+		}
 	}
 
 	// Log cache performance.
 	if (m_cache && m_verbose)
-		log::info << L"Pipeline cache; " << m_cacheHit << L" hit(s), " << m_cacheMiss << L" miss(es), " << m_cacheVoid << L" uncachable(s)." << Endl;
+		log::info << L"Pipeline cache; " << m_cacheHit.load() << L" hit(s), " << m_cacheMiss.load() << L" miss(es), " << m_cacheVoid.load() << L" uncachable(s)." << Endl;
 
 	// Log results.
 	if (!ThreadManager::getInstance().getCurrentThread()->stopped())
@@ -373,9 +525,9 @@ bool PipelineBuilder::build(const PipelineDependencySet* dependencySet, bool reb
 		}
 
 		if (m_failed == 0)
-			log::info << L"Build finished in " << formatDuration(timer.getElapsedTime()) << L"; " << m_succeeded << L" succeeded (" << m_succeededBuilt << L" built), " << m_failed << L" failed." << Endl;
+			log::info << L"Build finished in " << formatDuration(timer.getElapsedTime()) << L"; " << m_succeeded.load() << L" succeeded (" << m_succeededBuilt.load() << L" built), " << m_failed.load() << L" failed." << Endl;
 		else
-			log::error << L"Build failed in " << formatDuration(timer.getElapsedTime()) << L"; " << m_succeeded << L" succeeded (" << m_succeededBuilt << L" built), " << m_failed << L" failed." << Endl;
+			log::error << L"Build failed in " << formatDuration(timer.getElapsedTime()) << L"; " << m_succeeded.load() << L" succeeded (" << m_succeededBuilt.load() << L" built), " << m_failed.load() << L" failed." << Endl;
 	}
 	else
 		log::info << L"Build finished; aborted." << Endl;
@@ -401,17 +553,20 @@ Ref< ISerializable > PipelineBuilder::buildProduct(const db::Instance* sourceIns
 	if (const ISerializable* sbp = dynamic_type_cast< const ISerializable* >(buildParams))
 		sourceHash += DeepHash(sbp).get();
 
-	auto it = m_builtCache.find(sourceHash);
-	if (it != m_builtCache.end())
 	{
-		built_cache_list_t& bcl = it->second;
-		T_ASSERT(!bcl.empty());
-
-		// Return same instance as before if pointer and hash match.
-		for (built_cache_list_t::const_iterator j = bcl.begin(); j != bcl.end(); ++j)
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		auto it = m_builtCache.find(sourceHash);
+		if (it != m_builtCache.end())
 		{
-			if (j->sourceAsset == sourceAsset)
-				return j->product;
+			built_cache_list_t& bcl = it->second;
+			T_ASSERT(!bcl.empty());
+
+			// Return same instance as before if pointer and hash match.
+			for (built_cache_list_t::const_iterator j = bcl.begin(); j != bcl.end(); ++j)
+			{
+				if (j->sourceAsset == sourceAsset)
+					return j->product;
+			}
 		}
 	}
 
@@ -421,12 +576,14 @@ Ref< ISerializable > PipelineBuilder::buildProduct(const db::Instance* sourceIns
 	if (!product)
 		return nullptr;
 
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 	m_builtCache[sourceHash].push_back({ sourceAsset, product });
 	return product;
 }
 
 bool PipelineBuilder::buildAdHocOutput(const Guid& outputGuid)
 {
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 	m_adHocBuilds.insert(outputGuid);
 	return true;
 }
@@ -446,6 +603,7 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 		if (m_dependencySet->get(id) != PipelineDependencySet::DiInvalid)
 			return false;
 
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 		if (m_adHocBuilds.find(id) != m_adHocBuilds.end())
 			return false;
 
@@ -479,6 +637,8 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 
 	T_ANONYMOUS_VAR(ScopeIndent)(log::info);
 
+	ThreadState& ts = getThreadState();
+
 	// Build dependencies.
 	bool result = true;
 	for (uint32_t i = 0; i < dependencySet.size() && result; ++i)
@@ -487,8 +647,12 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 		if ((dependency->flags & PdfBuild) == 0)
 			continue;
 
-		if (m_adHocBuilds.find(dependency->outputGuid) != m_adHocBuilds.end())
-			continue;
+		// Claim ad-hoc build; other build threads might try to build same output.
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+			if (!m_adHocBuilds.insert(dependency->outputGuid).second)
+				continue;
+		}
 
 		// Calculate hash entry.
 		PipelineDependencyHash dependencyHash;
@@ -518,9 +682,9 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 		// Build output instances; keep an array of written instances as we
 		// need them to update the cache for this specific build.
 		RefArray< db::Instance > previousBuiltInstances;
-		m_builtInstances.swap(previousBuiltInstances);
+		ts.builtInstances.swap(previousBuiltInstances);
 		AlignedVector< CacheKey > previousBuiltAdHocKeys;
-		m_builtAdHocKeys.swap(previousBuiltAdHocKeys);
+		ts.builtAdHocKeys.swap(previousBuiltAdHocKeys);
 
 		// Get output instances from memory cache.
 		if (m_cache && pipeline->shouldCache() && cachePermitted)
@@ -528,11 +692,11 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 			if (getInstancesFromCache(
 				m_cache,
 				{ dependency->outputGuid, dependencyHash },
-				&m_builtInstances,
-				&m_builtAdHocKeys
+				&ts.builtInstances,
+				&ts.builtAdHocKeys
 			))
 			{
-				for (const auto& child : m_builtAdHocKeys)
+				for (const auto& child : ts.builtAdHocKeys)
 				{
 					if (!getInstancesFromCache(
 						m_cache,
@@ -546,12 +710,10 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 				m_pipelineDb->setDependency(dependency->outputGuid, dependencyHash);
 
 				previousBuiltAdHocKeys.push_back({ dependency->outputGuid, dependencyHash });
-				previousBuiltAdHocKeys.insert(previousBuiltAdHocKeys.end(), m_builtAdHocKeys.begin(), m_builtAdHocKeys.end());
-
-				m_builtInstances.swap(previousBuiltInstances);
-				m_builtAdHocKeys.swap(previousBuiltAdHocKeys);
+				previousBuiltAdHocKeys.insert(previousBuiltAdHocKeys.end(), ts.builtAdHocKeys.begin(), ts.builtAdHocKeys.end());
 
-				m_adHocBuilds.insert(dependency->outputGuid);
+				ts.builtInstances.swap(previousBuiltInstances);
+				ts.builtAdHocKeys.swap(previousBuiltAdHocKeys);
 
 				m_cacheHit++;
 				continue;
@@ -563,10 +725,10 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 			m_cacheVoid++;
 
 		if (m_verbose)
-			log::info << L"Building \"" << dependency->outputPath << L"\" (ad-hoc " << m_adHocDepth << L")..." << Endl;
+			log::info << L"Building \"" << dependency->outputPath << L"\" (ad-hoc " << ts.adHocDepth << L")..." << Endl;
 		log::info << IncreaseIndent;
 
-		m_adHocDepth++;
+		ts.adHocDepth++;
 		m_profiler->begin(*dependency->pipelineType);
 		result &= pipeline->buildOutput(
 			this,
@@ -580,19 +742,19 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 			PbrSourceModified
 		);
 		m_profiler->end();
-		m_adHocDepth--;
+		ts.adHocDepth--;
 
 		if (result && m_cache && pipeline->shouldCache() && cachePermitted)
 		{
 			putInstancesInCache(
 				m_cache,
 				{ dependency->outputGuid, dependencyHash },
-				m_builtInstances,
-				m_builtAdHocKeys
+				ts.builtInstances,
+				ts.builtAdHocKeys
 			);
 			
 			previousBuiltAdHocKeys.push_back({ dependency->outputGuid, dependencyHash });
-			previousBuiltAdHocKeys.insert(previousBuiltAdHocKeys.end(), m_builtAdHocKeys.begin(), m_builtAdHocKeys.end());
+			previousBuiltAdHocKeys.insert(previousBuiltAdHocKeys.end(), ts.builtAdHocKeys.begin(), ts.builtAdHocKeys.end());
 		}
 
 		// Store dependency hash in database so getInstancesFromCache only touches
@@ -602,10 +764,8 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 
 		// Restore previous set but also insert built instances from synthesized build;
 		// when caching is enabled then synthesized built instances should be included in parent build as well.
-		m_builtInstances.swap(previousBuiltInstances);
-		m_builtAdHocKeys.swap(previousBuiltAdHocKeys);
-
-		m_adHocBuilds.insert(dependency->outputGuid);
+		ts.builtInstances.swap(previousBuiltInstances);
+		ts.builtAdHocKeys.swap(previousBuiltAdHocKeys);
 
 		log::info << DecreaseIndent;
 		if (m_verbose)
@@ -651,6 +811,7 @@ Ref< ISerializable > PipelineBuilder::getBuildProduct(const ISerializable* sourc
 
 	const uint32_t sourceHash = DeepHash(sourceAsset).get();
 
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 	const auto it = m_builtCache.find(sourceHash);
 	if (it == m_builtCache.end())
 		return nullptr;
@@ -698,7 +859,7 @@ Ref< db::Instance > PipelineBuilder::createOutputInstance(const std::wstring& in
 	);
 	if (instance)
 	{
-		m_builtInstances.push_back(instance);
+		getThreadState().builtInstances.push_back(instance);
 		return instance;
 	}
 	else
@@ -740,6 +901,12 @@ PipelineProfiler* PipelineBuilder::getProfiler() const
 	return m_profiler;
 }
 
+PipelineBuilder::ThreadState& PipelineBuilder::getThreadState()
+{
+	ThreadState* ts = static_cast< ThreadState* >(m_threadState.get());
+	return ts ? *ts : m_defaultThreadState;
+}
+
 IPipelineBuilder::BuildResult PipelineBuilder::performBuild(
 	const PipelineDependencySet* dependencySet,
 	const PipelineDependency* dependency,
@@ -776,8 +943,9 @@ IPipelineBuilder::BuildResult PipelineBuilder::performBuild(
 	Ref< IPipeline > pipeline = m_pipelineFactory->findPipeline(*dependency->pipelineType);
 	T_ASSERT(pipeline);
 
-	m_builtInstances.resize(0);
-	m_builtAdHocKeys.resize(0);
+	ThreadState& ts = getThreadState();
+	ts.builtInstances.resize(0);
+	ts.builtAdHocKeys.resize(0);
 
 	// Get output instances from cache.
 	if (m_cache && pipeline->shouldCache())
@@ -785,11 +953,11 @@ IPipelineBuilder::BuildResult PipelineBuilder::performBuild(
 		if (getInstancesFromCache(
 			m_cache,
 			{ dependency->outputGuid, currentDependencyHash },
-			&m_builtInstances,
-			&m_builtAdHocKeys
+			&ts.builtInstances,
+			&ts.builtAdHocKeys
 		))
 		{
-			for (const auto& child : m_builtAdHocKeys)
+			for (const auto& child : ts.builtAdHocKeys)
 			{
 				if (!getInstancesFromCache(
 					m_cache,
@@ -854,8 +1022,8 @@ IPipelineBuilder::BuildResult PipelineBuilder::performBuild(
 		putInstancesInCache(
 			m_cache,
 			{ dependency->outputGuid, currentDependencyHash },
-			m_builtInstances,
-			m_builtAdHocKeys
+			ts.builtInstances,
+			ts.builtAdHocKeys
 		);
 	}
 
@@ -872,8 +1040,8 @@ IPipelineBuilder::BuildResult PipelineBuilder::performBuild(
 			log::info << L"Build \"" << dependency->outputPath << L"\" failed (" << type_name(pipeline) << L")." << Endl;
 	}
 
-	m_builtInstances.resize(0);
-	m_builtAdHocKeys.resize(0);
+	ts.builtInstances.resize(0);
+	ts.builtAdHocKeys.resize(0);
 
 	if (result)
 		return (warningTarget.getCount() + errorTarget.getCount()) > 0 ? BuildResult::SucceededWithWarnings : BuildResult::Succeeded;
@@ -8,10 +8,13 @@
  */
 #pragma once
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <set>
 #include "Core/Io/Path.h"
+#include "Core/Thread/Semaphore.h"
+#include "Core/Thread/ThreadLocal.h"
 #include "Editor/IPipelineBuilder.h"
 #include "Editor/PipelineTypes.h"
 
@@ -48,6 +51,10 @@ class PipelineProfiler;
 
 /*! Pipeline manager.
  * \ingroup Editor
+ *
+ * Independent dependencies are built concurrently when more than
+ * one build thread is specified; a dependency is always built
+ * after it's children.
  */
 class T_DLLCLASS PipelineBuilder : public IPipelineBuilder
 {
@@ -62,7 +69,9 @@ public:
 		IPipelineDb* db,
 		IPipelineInstanceCache* instanceCache,
 		IListener* listener,
-		bool verbose
+		bool verbose,
+		int32_t buildThreads,
+		uint64_t buildMemoryCap
 	);
 
 	virtual bool build(const PipelineDependencySet* dependencySet, bool rebuild) override final;
@@ -106,6 +115,14 @@ private:
 
 	typedef std::list< BuiltCacheEntry > built_cache_list_t;
 
+	/*! Per build thread state. */
+	struct ThreadState
+	{
+		RefArray< db::Instance > builtInstances;
+		AlignedVector< CacheKey > builtAdHocKeys;
+		int32_t adHocDepth = 0;
+	};
+
 	Ref< PipelineFactory > m_pipelineFactory;
 	Ref< db::Database > m_sourceDatabase;
 	Ref< db::Database > m_outputDatabase;
@@ -115,23 +132,28 @@ private:
 	Ref< DataAccessCache > m_dataAccessCache;
 	IListener* m_listener;
 	bool m_verbose;
+	int32_t m_buildThreads;
+	uint64_t m_buildMemoryCap;
 	bool m_rebuild;
 	Ref< PipelineProfiler > m_profiler;
 	const PipelineDependencySet* m_dependencySet;
-	std::map< Guid, Ref< ISerializable > > m_readCache;
+	Semaphore m_lock;
+	Semaphore m_listenerLock;
 	std::map< uint32_t, built_cache_list_t > m_builtCache;
 	std::set< Guid > m_adHocBuilds;
-	RefArray< db::Instance > m_builtInstances;
-	AlignedVector< CacheKey > m_builtAdHocKeys;
-	int32_t m_adHocDepth;
+	ThreadLocal m_threadState;
+	ThreadState m_defaultThreadState;
 	int32_t m_progressEnd;
-	int32_t m_progress;
-	int32_t m_succeeded;
-	int32_t m_succeededBuilt;
-	int32_t m_failed;
-	int32_t m_cacheHit;
-	int32_t m_cacheMiss;
-	int32_t m_cacheVoid;
+	std::atomic< int32_t > m_progress;
+	std::atomic< int32_t > m_succeeded;
+	std::atomic< int32_t > m_succeededBuilt;
+	std::atomic< int32_t > m_failed;
+	std::atomic< int32_t > m_cacheHit;
+	std::atomic< int32_t > m_cacheMiss;
+	std::atomic< int32_t > m_cacheVoid;
+
+	/*! Get build state of calling thread. */
+	ThreadState& getThreadState();
 
 	/*! Perform build. */
 	BuildResult performBuild(const PipelineDependencySet* dependencySet, const PipelineDependency* dependency, const Object* buildParams, uint32_t reason);
@@ -39,7 +39,8 @@ void HeightfieldEditorProfile::createResourceFactories(
 	RefArray< const resource::IResourceFactory >& outResourceFactories
 ) const
 {
-	outResourceFactories.push_back(new HeightfieldFactory());
+	// Heightfields are modified by editor thus must be entirely resident.
+	outResourceFactories.push_back(new HeightfieldFactory(false));
 }
 
 void HeightfieldEditorProfile::createEntityFactories(
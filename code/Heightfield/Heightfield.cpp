@@ -9,12 +9,23 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include "Core/Io/IStream.h"
+#include "Core/Io/Reader.h"
 #include "Core/Math/Aabb3.h"
 #include "Core/Math/Winding3.h"
 #include "Heightfield/Heightfield.h"
 
 namespace traktor::hf
 {
+	namespace
+	{
+
+int32_t clampGrid(int32_t grid, int32_t size)
+{
+	return grid < 0 ? 0 : (grid >= size ? size - 1 : grid);
+}
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.hf.Heightfield", Heightfield, Object)
 
@@ -31,13 +42,156 @@ Heightfield::Heightfield(
 	m_worldExtent.storeUnaligned(m_worldExtentFloats);
 }
 
+Heightfield::Heightfield(
+	int32_t size,
+	const Vector4& worldExtent,
+	int32_t tileSize,
+	int32_t maxResidentTiles,
+	bool haveCuts,
+	int32_t overviewSize,
+	AlignedVector< height_t >&& overview,
+	IStream* stream,
+	int64_t tileDataOffset
+)
+:	m_size(size)
+,	m_worldExtent(worldExtent)
+,	m_tileSize(tileSize)
+,	m_tileCount(size / tileSize)
+,	m_haveCuts(haveCuts)
+,	m_overviewSize(overviewSize)
+,	m_overview(std::move(overview))
+,	m_stream(stream)
+,	m_tileDataOffset(tileDataOffset)
+{
+	T_FATAL_ASSERT(m_tileSize > 0 && (m_size % m_tileSize) == 0);
+	T_FATAL_ASSERT(m_overview.size() == m_overviewSize * m_overviewSize);
+
+	const int32_t tileCellCount = m_tileSize * m_tileSize;
+	m_tileSlots.resize(m_tileCount * m_tileCount, -1);
+	m_slotTiles.resize(maxResidentTiles, -1);
+	m_slotHeights.reset(new height_t [maxResidentTiles * tileCellCount]);
+	m_slotCuts.reset(new uint8_t [(maxResidentTiles * tileCellCount) / 8]);
+	m_slotAttributes.reset(new uint8_t [maxResidentTiles * tileCellCount]);
+	m_worldExtent.storeUnaligned(m_worldExtentFloats);
+}
+
+Heightfield::~Heightfield()
+{
+	if (m_stream)
+	{
+		m_stream->close();
+		m_stream = nullptr;
+	}
+}
+
+int32_t Heightfield::updateResidency(const Vector4& worldPosition, int32_t maxPageIn)
+{
+	if (!isPaged())
+		return 0;
+
+	int32_t gridX, gridZ;
+	worldToGrid(worldPosition.x(), worldPosition.z(), gridX, gridZ);
+
+	const int32_t centerTileX = clampGrid(gridX / m_tileSize, m_tileCount);
+	const int32_t centerTileZ = clampGrid(gridZ / m_tileSize, m_tileCount);
+
+	// Wanted tiles are a square window around center tile which fit in available slots.
+	const int32_t maxResidentTiles = (int32_t)m_slotTiles.size();
+	const int32_t windowSize = std::min((int32_t)std::sqrt(float(maxResidentTiles)), m_tileCount);
+	const int32_t windowX = clamp(centerTileX - windowSize / 2, 0, m_tileCount - windowSize);
+	const int32_t windowZ = clamp(centerTileZ - windowSize / 2, 0, m_tileCount - windowSize);
+
+	const auto inWindow = [&](int32_t tile) {
+		const int32_t tx = tile % m_tileCount;
+		const int32_t tz = tile / m_tileCount;
+		return tx >= windowX && tx < windowX + windowSize && tz >= windowZ && tz < windowZ + windowSize;
+	};
+
+	// Gather missing tiles, page in those nearest center first.
+	AlignedVector< int32_t > missing;
+	for (int32_t tz = windowZ; tz < windowZ + windowSize; ++tz)
+	{
+		for (int32_t tx = windowX; tx < windowX + windowSize; ++tx)
+		{
+			const int32_t tile = tx + tz * m_tileCount;
+			if (m_tileSlots[tile] < 0)
+				missing.push_back(tile);
+		}
+	}
+
+	std::sort(missing.begin(), missing.end(), [&](int32_t lh, int32_t rh) {
+		const int32_t dlx = lh % m_tileCount - centerTileX, dlz = lh / m_tileCount - centerTileZ;
+		const int32_t drx = rh % m_tileCount - centerTileX, drz = rh / m_tileCount - centerTileZ;
+		return dlx * dlx + dlz * dlz < drx * drx + drz * drz;
+	});
+
+	int32_t pageInCount = 0;
+	int32_t slot = 0;
+	for (const int32_t tile : missing)
+	{
+		if (pageInCount >= maxPageIn)
+			break;
+
+		// Find free slot or a slot with a tile outside of window.
+		while (slot < maxResidentTiles && m_slotTiles[slot] >= 0 && inWindow(m_slotTiles[slot]))
+			++slot;
+		if (slot >= maxResidentTiles)
+			break;
+
+		if (m_slotTiles[slot] >= 0)
+			m_tileSlots[m_slotTiles[slot]] = -1;
+		m_slotTiles[slot] = -1;
+
+		if (!readTile(tile, slot))
+			break;
+
+		m_tileSlots[tile] = slot;
+		m_slotTiles[slot] = tile;
+		++pageInCount;
+	}
+
+	return pageInCount;
+}
+
+bool Heightfield::isGridResident(int32_t gridX, int32_t gridZ) const
+{
+	if (!isPaged())
+		return true;
+
+	int32_t slot;
+	return getResidentOffset(clampGrid(gridX, m_size), clampGrid(gridZ, m_size), slot) >= 0;
+}
+
+bool Heightfield::haveCuts() const
+{
+	if (isPaged())
+		return m_haveCuts;
+
+	for (int32_t i = 0; i < m_size * m_size / 8; ++i)
+	{
+		if (m_cuts[i] != 0xff)
+			return true;
+	}
+	return false;
+}
+
 void Heightfield::setGridHeight(int32_t gridX, int32_t gridZ, float unitY)
 {
 	if (gridX < 0 || gridX >= (int32_t)m_size)
 		return;
 	if (gridZ < 0 || gridZ >= (int32_t)m_size)
 		return;
-	m_heights[gridX + gridZ * m_size] = height_t(clamp(unitY, 0.0f, 1.0f) * 65535.0f);
+
+	const height_t height = height_t(clamp(unitY, 0.0f, 1.0f) * 65535.0f);
+	if (!isPaged())
+		m_heights[gridX + gridZ * m_size] = height;
+	else
+	{
+		int32_t slot;
+		const int32_t offset = getResidentOffset(gridX, gridZ, slot);
+		if (offset >= 0)
+			m_slotHeights[offset] = height;
+	}
 }
 
 void Heightfield::setGridCut(int32_t gridX, int32_t gridZ, bool cut)
@@ -47,11 +201,20 @@ void Heightfield::setGridCut(int32_t gridX, int32_t gridZ, bool cut)
 	if (gridZ < 0 || gridZ >= (int32_t)m_size)
 		return;
 
-	const int32_t offset = gridX + gridZ * m_size;
+	uint8_t* cuts = m_cuts.ptr();
+	int32_t offset = gridX + gridZ * m_size;
+	if (isPaged())
+	{
+		int32_t slot;
+		if ((offset = getResidentOffset(gridX, gridZ, slot)) < 0)
+			return;
+		cuts = m_slotCuts.ptr();
+	}
+
 	if (cut)
-		m_cuts[offset / 8] |= (1 << (offset & 7));
+		cuts[offset / 8] |= (1 << (offset & 7));
 	else
-		m_cuts[offset / 8] &= ~(1 << (offset & 7));
+		cuts[offset / 8] &= ~(1 << (offset & 7));
 }
 
 void Heightfield::setGridAttribute(int32_t gridX, int32_t gridZ, uint8_t attribute)
@@ -61,8 +224,15 @@ void Heightfield::setGridAttribute(int32_t gridX, int32_t gridZ, uint8_t attribu
 	if (gridZ < 0 || gridZ >= (int32_t)m_size)
 		return;
 
-	const int32_t offset = gridX + gridZ * m_size;
-	m_attributes[offset] = attribute;
+	if (!isPaged())
+		m_attributes[gridX + gridZ * m_size] = attribute;
+	else
+	{
+		int32_t slot;
+		const int32_t offset = getResidentOffset(gridX, gridZ, slot);
+		if (offset >= 0)
+			m_slotAttributes[offset] = attribute;
+	}
 }
 
 float Heightfield::getGridHeightNearest(int32_t gridX, int32_t gridZ) const
@@ -77,7 +247,7 @@ float Heightfield::getGridHeightNearest(int32_t gridX, int32_t gridZ) const
 	else if (gridZ >= (int32_t)m_size)
 		gridZ = (int32_t)m_size - 1;
 
-	return m_heights[gridX + gridZ * m_size] / 65535.0f;
+	return getHeight(gridX, gridZ) / 65535.0f;
 }
 
 float Heightfield::getGridHeightBilinear(float gridX, float gridZ) const
@@ -95,15 +265,22 @@ float Heightfield::getGridHeightBilinear(float gridX, float gridZ) const
 	else if (igridZ >= (int32_t)m_size - 1)
 		igridZ = (int32_t)m_size - 2;
 
-	const int32_t offset = igridX + igridZ * m_size;
-
-	height_t hts[] =
+	float hts[4];
+	if (!isPaged())
 	{
-		m_heights[offset],
-		m_heights[offset + 1],
-		m_heights[offset + m_size],
-		m_heights[offset + 1 + m_size]
-	};
+		const int32_t offset = igridX + igridZ * m_size;
+		hts[0] = m_heights[offset];
+		hts[1] = m_heights[offset + 1];
+		hts[2] = m_heights[offset + m_size];
+		hts[3] = m_heights[offset + 1 + m_size];
+	}
+	else
+	{
+		hts[0] = getHeight(igridX, igridZ);
+		hts[1] = getHeight(igridX + 1, igridZ);
+		hts[2] = getHeight(igridX, igridZ + 1);
+		hts[3] = getHeight(igridX + 1, igridZ + 1);
+	}
 
 	const float fgridX = gridX - igridX;
 	const float fgridZ = gridZ - igridZ;
@@ -180,8 +357,7 @@ bool Heightfield::getGridCut(int32_t gridX, int32_t gridZ) const
 	else if (gridZ >= (int32_t)m_size)
 		gridZ = (int32_t)m_size - 1;
 
-	const int32_t offset = gridX + gridZ * m_size;
-	return (m_cuts[offset / 8] & (1 << (offset & 7))) != 0;
+	return getCut(gridX, gridZ);
 }
 
 bool Heightfield::getWorldCut(float worldX, float worldZ) const
@@ -203,8 +379,7 @@ uint8_t Heightfield::getGridAttribute(int32_t gridX, int32_t gridZ) const
 	else if (gridZ >= (int32_t)m_size)
 		gridZ = (int32_t)m_size - 1;
 
-	const int32_t offset = gridX + gridZ * m_size;
-	return m_attributes[offset];
+	return getAttribute(gridX, gridZ);
 }
 
 uint8_t Heightfield::getWorldAttribute(float worldX, float worldZ) const
@@ -414,4 +589,77 @@ bool Heightfield::queryRay(const Vector4& worldRayOrigin, const Vector4& worldRa
 	return foundIntersection;
 }
 
+height_t Heightfield::getHeight(int32_t gridX, int32_t gridZ) const
+{
+	if (!isPaged())
+		return m_heights[gridX + gridZ * m_size];
+
+	int32_t slot;
+	const int32_t offset = getResidentOffset(gridX, gridZ, slot);
+	if (offset >= 0)
+		return m_slotHeights[offset];
+
+	// Tile not resident, sample overview.
+	const int32_t ox = (gridX * m_overviewSize) / m_size;
+	const int32_t oz = (gridZ * m_overviewSize) / m_size;
+	return m_overview[ox + oz * m_overviewSize];
+}
+
+bool Heightfield::getCut(int32_t gridX, int32_t gridZ) const
+{
+	if (!isPaged())
+	{
+		const int32_t offset = gridX + gridZ * m_size;
+		return (m_cuts[offset / 8] & (1 << (offset & 7))) != 0;
+	}
+
+	int32_t slot;
+	const int32_t offset = getResidentOffset(gridX, gridZ, slot);
+	if (offset >= 0)
+		return (m_slotCuts[offset / 8] & (1 << (offset & 7))) != 0;
+	else
+		return true;
+}
+
+uint8_t Heightfield::getAttribute(int32_t gridX, int32_t gridZ) const
+{
+	if (!isPaged())
+		return m_attributes[gridX + gridZ * m_size];
+
+	int32_t slot;
+	const int32_t offset = getResidentOffset(gridX, gridZ, slot);
+	return offset >= 0 ? m_slotAttributes[offset] : 0;
+}
+
+int32_t Heightfield::getResidentOffset(int32_t gridX, int32_t gridZ, int32_t& outSlot) const
+{
+	const int32_t tx = gridX / m_tileSize;
+	const int32_t tz = gridZ / m_tileSize;
+	if ((outSlot = m_tileSlots[tx + tz * m_tileCount]) < 0)
+		return -1;
+
+	const int32_t lx = gridX - tx * m_tileSize;
+	const int32_t lz = gridZ - tz * m_tileSize;
+	return outSlot * m_tileSize * m_tileSize + lx + lz * m_tileSize;
+}
+
+bool Heightfield::readTile(int32_t tile, int32_t slot)
+{
+	const int32_t tileCellCount = m_tileSize * m_tileSize;
+	const int64_t tileDataSize = tileCellCount * (sizeof(height_t) + sizeof(uint8_t)) + tileCellCount / 8;
+
+	if (m_stream->seek(IStream::SeekSet, m_tileDataOffset + tile * tileDataSize) < 0)
+		return false;
+
+	Reader reader(m_stream);
+	if (reader.read(m_slotHeights.ptr() + slot * tileCellCount, tileCellCount, sizeof(height_t)) != tileCellCount * sizeof(height_t))
+		return false;
+	if (reader.read(m_slotCuts.ptr() + (slot * tileCellCount) / 8, tileCellCount / 8, sizeof(uint8_t)) != tileCellCount / 8)
+		return false;
+	if (reader.read(m_slotAttributes.ptr() + slot * tileCellCount, tileCellCount, sizeof(uint8_t)) != tileCellCount)
+		return false;
+
+	return true;
+}
+
 }
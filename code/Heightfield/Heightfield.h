@@ -9,6 +9,8 @@
 #pragma once
 
 #include "Core/Object.h"
+#include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Math/Vector4.h"
 #include "Core/Misc/AutoPtr.h"
 #include "Heightfield/HeightfieldTypes.h"
@@ -21,11 +23,23 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
+namespace traktor
+{
+
+class IStream;
+
+}
+
 namespace traktor::hf
 {
 
 /*!
  * \ingroup Heightfield
+ *
+ * Heightfield is either fully resident or paged, a paged heightfield
+ * only keep a limited number of tiles resident and read tiles on demand
+ * from a tiled heightfield stream. Samples of non-resident tiles
+ * are taken from a low resolution overview which is always resident.
  */
 class T_DLLCLASS Heightfield : public Object
 {
@@ -37,6 +51,53 @@ public:
 		const Vector4& worldExtent
 	);
 
+	/*! Create paged heightfield.
+	 *
+	 * \param size Size of heightfield grid.
+	 * \param worldExtent Extent of heightfield in world space.
+	 * \param tileSize Size of each tile, grid size must be a multiple of tile size.
+	 * \param maxResidentTiles Maximum number of resident tiles.
+	 * \param haveCuts If heightfield contain any cuts.
+	 * \param overviewSize Size of overview grid.
+	 * \param overview Overview heights.
+	 * \param stream Stream from which tiles are read.
+	 * \param tileDataOffset Offset in stream to first tile.
+	 */
+	explicit Heightfield(
+		int32_t size,
+		const Vector4& worldExtent,
+		int32_t tileSize,
+		int32_t maxResidentTiles,
+		bool haveCuts,
+		int32_t overviewSize,
+		AlignedVector< height_t >&& overview,
+		IStream* stream,
+		int64_t tileDataOffset
+	);
+
+	virtual ~Heightfield();
+
+	/*! Update resident tiles.
+	 *
+	 * Tiles nearest to world position are paged in, tiles
+	 * far away are evicted when a slot is required.
+	 * Must not be called concurrently with sampling the heightfield.
+	 *
+	 * \param worldPosition Position around which tiles should be resident, typically camera position.
+	 * \param maxPageIn Maximum number of tiles read in this update.
+	 * \return Number of tiles read.
+	 */
+	int32_t updateResidency(const Vector4& worldPosition, int32_t maxPageIn = 4);
+
+	/*! Check if heightfield is paged. */
+	bool isPaged() const { return m_tileSize > 0; }
+
+	/*! Check if tile containing grid coordinate is resident. */
+	bool isGridResident(int32_t gridX, int32_t gridZ) const;
+
+	/*! Check if any grid cell is cut. */
+	bool haveCuts() const;
+
 	void setGridHeight(int32_t gridX, int32_t gridZ, float unitY);
 
 	void setGridCut(int32_t gridX, int32_t gridZ, bool cut);
@@ -79,14 +140,17 @@ public:
 
 	const Vector4& getWorldExtent() const { return m_worldExtent; }
 
+	/*! Get all heights, null if heightfield is paged. */
 	height_t* getHeights() { return m_heights.ptr(); }
 
 	const height_t* getHeights() const { return m_heights.c_ptr(); }
 
+	/*! Get all cuts, null if heightfield is paged. */
 	uint8_t* getCuts() { return m_cuts.ptr(); }
 
 	const uint8_t* getCuts() const { return m_cuts.c_ptr(); }
 
+	/*! Get all attributes, null if heightfield is paged. */
 	uint8_t* getAttributes() { return m_attributes.ptr(); }
 
 	const uint8_t* getAttributes() const { return m_attributes.c_ptr(); }
@@ -98,6 +162,30 @@ private:
 	AutoArrayPtr< height_t > m_heights;
 	AutoArrayPtr< uint8_t > m_cuts;
 	AutoArrayPtr< uint8_t > m_attributes;
+
+	// Paged heightfield.
+	int32_t m_tileSize = 0;
+	int32_t m_tileCount = 0;
+	bool m_haveCuts = false;
+	int32_t m_overviewSize = 0;
+	AlignedVector< height_t > m_overview;
+	Ref< IStream > m_stream;
+	int64_t m_tileDataOffset = 0;
+	AlignedVector< int32_t > m_tileSlots;	//!< Slot of each tile, -1 if not resident.
+	AlignedVector< int32_t > m_slotTiles;	//!< Tile in each slot, -1 if slot is free.
+	AutoArrayPtr< height_t > m_slotHeights;
+	AutoArrayPtr< uint8_t > m_slotCuts;
+	AutoArrayPtr< uint8_t > m_slotAttributes;
+
+	height_t getHeight(int32_t gridX, int32_t gridZ) const;
+
+	bool getCut(int32_t gridX, int32_t gridZ) const;
+
+	uint8_t getAttribute(int32_t gridX, int32_t gridZ) const;
+
+	int32_t getResidentOffset(int32_t gridX, int32_t gridZ, int32_t& outSlot) const;
+
+	bool readTile(int32_t tile, int32_t slot);
 };
 
 }
@@ -15,9 +15,20 @@
 
 namespace traktor::hf
 {
+	namespace
+	{
+
+const int32_t c_maxResidentTiles = 64;
+
+	}
 
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.hf.HeightfieldFactory", 0, HeightfieldFactory, resource::IResourceFactory)
 
+HeightfieldFactory::HeightfieldFactory(bool paged)
+:	m_paged(paged)
+{
+}
+
 bool HeightfieldFactory::initialize(const ObjectStore& objectStore)
 {
 	return true;
@@ -38,6 +49,11 @@ bool HeightfieldFactory::isCacheable(const TypeInfo& productType) const
 	return true;
 }
 
+bool HeightfieldFactory::isThreadSafe() const
+{
+	return true;
+}
+
 Ref< Object > HeightfieldFactory::create(resource::IResourceManager* resourceManager, const db::Database* database, const db::Instance* instance, const TypeInfo& productType, const Object* current) const
 {
 	Ref< const HeightfieldResource > resource = instance->getObject< HeightfieldResource >();
@@ -48,10 +64,11 @@ Ref< Object > HeightfieldFactory::create(resource::IResourceManager* resourceMan
 	if (!stream)
 		return nullptr;
 
-	Ref< Heightfield > heightfield = HeightfieldFormat().read(stream, resource->getWorldExtent());
-
-	stream->close();
-	return heightfield;
+	// Paged heightfield keep stream open to read tiles on demand.
+	if (m_paged)
+		return HeightfieldFormat().readPaged(stream, resource->getWorldExtent(), c_maxResidentTiles);
+	else
+		return HeightfieldFormat().read(stream, resource->getWorldExtent());
 }
 
 }
@@ -29,6 +29,12 @@ class T_DLLCLASS HeightfieldFactory : public resource::IResourceFactory
 	T_RTTI_CLASS;
 
 public:
+	/*! Constructor.
+	 *
+	 * \param paged Create paged heightfields, large heightfields only keep tiles near camera resident.
+	 */
+	explicit HeightfieldFactory(bool paged = true);
+
 	virtual bool initialize(const ObjectStore& objectStore) override final;
 
 	virtual const TypeInfoSet getResourceTypes() const override final;
@@ -37,7 +43,12 @@ public:
 
 	virtual bool isCacheable(const TypeInfo& productType) const override final;
 
+	virtual bool isThreadSafe() const override final;
+
 	virtual Ref< Object > create(resource::IResourceManager* resourceManager, const db::Database* database, const db::Instance* instance, const TypeInfo& productType, const Object* current) const override final;
+
+private:
+	bool m_paged;
 };
 
 }
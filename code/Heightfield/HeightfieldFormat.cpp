@@ -1,12 +1,13 @@
 /*
  * TRAKTOR
- * Copyright (c) 2022 Anders Pistol.
+ * Copyright (c) 2022-2024 Anders Pistol.
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include <cstring>
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Io/IStream.h"
 #include "Core/Io/Reader.h"
 #include "Core/Io/Writer.h"
@@ -18,69 +19,290 @@ namespace traktor::hf
 	namespace
 	{
 
-const int32_t c_version = 2;
+const int32_t c_version = 3;
+const int32_t c_tileSize = 256;
+const int32_t c_maxOverviewSize = 512;
 
+struct Header
+{
+	int32_t version;
+	int32_t size;
+	int32_t tileSize;
+	bool haveCuts;
+	int32_t overviewSize;
+};
+
+bool readHeader(IStream* stream, Header& outHeader)
+{
+	Reader r(stream);
+
+	r >> outHeader.version;
+	if (outHeader.version < 1 || outHeader.version > c_version)
+		return false;
+
+	r >> outHeader.size;
+	if (outHeader.size <= 0)
+		return false;
+
+	if (outHeader.version >= 3)
+	{
+		r >> outHeader.tileSize;
+		r >> outHeader.haveCuts;
+		r >> outHeader.overviewSize;
+		if (outHeader.tileSize <= 0 || (outHeader.size % outHeader.tileSize) != 0)
+			return false;
+	}
+	else
+	{
+		outHeader.tileSize = outHeader.size;
+		outHeader.haveCuts = true;
+		outHeader.overviewSize = 0;
 	}
 
-T_IMPLEMENT_RTTI_CLASS(L"traktor.hf.HeightfieldFormat", HeightfieldFormat, Object)
+	return true;
+}
 
-Ref< Heightfield > HeightfieldFormat::read(IStream* stream, const Vector4& worldExtent) const
+/*! Read finest overview level, skip coarser levels. */
+bool readOverview(IStream* stream, const Header& header, AlignedVector< height_t >& outOverview)
 {
-	int32_t version;
-	Reader(stream) >> version;
+	for (int32_t levelSize = header.overviewSize; levelSize > 0; levelSize >>= 1)
+	{
+		if (levelSize == header.overviewSize)
+		{
+			outOverview.resize(levelSize * levelSize);
+			if (Reader(stream).read(outOverview.ptr(), levelSize * levelSize, sizeof(height_t)) != levelSize * levelSize * sizeof(height_t))
+				return false;
+		}
+		else
+			stream->seek(IStream::SeekCurrent, levelSize * levelSize * sizeof(height_t));
+	}
+	return true;
+}
 
-	if (version != 1 && version != 2)
-		return 0;
+/*! Calculate overview by averaging all heights covered by each overview cell. */
+void calculateOverview(const Heightfield* heightfield, int32_t overviewSize, AlignedVector< height_t >& outOverview)
+{
+	const int32_t size = heightfield->getSize();
+	const height_t* heights = heightfield->getHeights();
 
-	int32_t size;
-	Reader(stream) >> size;
+	outOverview.resize(overviewSize * overviewSize);
+	for (int32_t oz = 0; oz < overviewSize; ++oz)
+	{
+		const int32_t z0 = (oz * size) / overviewSize;
+		const int32_t z1 = ((oz + 1) * size) / overviewSize;
+		for (int32_t ox = 0; ox < overviewSize; ++ox)
+		{
+			const int32_t x0 = (ox * size) / overviewSize;
+			const int32_t x1 = ((ox + 1) * size) / overviewSize;
+
+			uint64_t sum = 0;
+			for (int32_t z = z0; z < z1; ++z)
+			{
+				for (int32_t x = x0; x < x1; ++x)
+					sum += heights[x + z * size];
+			}
+
+			outOverview[ox + oz * overviewSize] = height_t(sum / uint64_t((x1 - x0) * (z1 - z0)));
+		}
+	}
+}
 
+Ref< Heightfield > readTiles(IStream* stream, const Header& header, const Vector4& worldExtent)
+{
 	Ref< Heightfield > heightfield = new Heightfield(
-		size,
+		header.size,
 		worldExtent
 	);
 
 	height_t* heights = heightfield->getHeights();
 	T_ASSERT_M (heights, L"No heights in heightfield");
-	Reader(stream).read(heights, size * size, sizeof(height_t));
 
 	uint8_t* cuts = heightfield->getCuts();
 	T_ASSERT_M (cuts, L"No cuts in heightfield");
-	Reader(stream).read(cuts, size * size / 8, sizeof(uint8_t));
 
 	uint8_t* attributes = heightfield->getAttributes();
 	T_ASSERT_M (attributes, L"No attributes in heightfield");
-	if (version == 2)
-		Reader(stream).read(attributes, size * size, sizeof(uint8_t));
-	else
-		std::memset(attributes, 0, size * size * sizeof(uint8_t));
+
+	const int32_t size = header.size;
+	if (header.version < 3)
+	{
+		Reader(stream).read(heights, size * size, sizeof(height_t));
+		Reader(stream).read(cuts, size * size / 8, sizeof(uint8_t));
+		if (header.version == 2)
+			Reader(stream).read(attributes, size * size, sizeof(uint8_t));
+		else
+			std::memset(attributes, 0, size * size * sizeof(uint8_t));
+		return heightfield;
+	}
+
+	// Skip overview, not used when entire heightfield is resident.
+	for (int32_t levelSize = header.overviewSize; levelSize > 0; levelSize >>= 1)
+		stream->seek(IStream::SeekCurrent, levelSize * levelSize * sizeof(height_t));
+
+	const int32_t tileSize = header.tileSize;
+	const int32_t tileCount = size / tileSize;
+	const int32_t tileCellCount = tileSize * tileSize;
+
+	AlignedVector< height_t > tileHeights(tileCellCount);
+	AlignedVector< uint8_t > tileCuts(tileCellCount / 8);
+	AlignedVector< uint8_t > tileAttributes(tileCellCount);
+
+	std::memset(cuts, 0, size * size / 8);
+
+	for (int32_t tz = 0; tz < tileCount; ++tz)
+	{
+		for (int32_t tx = 0; tx < tileCount; ++tx)
+		{
+			if (Reader(stream).read(tileHeights.ptr(), tileCellCount, sizeof(height_t)) != tileCellCount * sizeof(height_t))
+				return nullptr;
+			if (Reader(stream).read(tileCuts.ptr(), tileCellCount / 8, sizeof(uint8_t)) != tileCellCount / 8)
+				return nullptr;
+			if (Reader(stream).read(tileAttributes.ptr(), tileCellCount, sizeof(uint8_t)) != tileCellCount)
+				return nullptr;
+
+			for (int32_t lz = 0; lz < tileSize; ++lz)
+			{
+				const int32_t offset = tx * tileSize + (tz * tileSize + lz) * size;
+				std::memcpy(heights + offset, tileHeights.c_ptr() + lz * tileSize, tileSize * sizeof(height_t));
+				std::memcpy(attributes + offset, tileAttributes.c_ptr() + lz * tileSize, tileSize * sizeof(uint8_t));
+				for (int32_t lx = 0; lx < tileSize; ++lx)
+				{
+					const int32_t local = lx + lz * tileSize;
+					if ((tileCuts[local / 8] & (1 << (local & 7))) != 0)
+						cuts[(offset + lx) / 8] |= (1 << ((offset + lx) & 7));
+				}
+			}
+		}
+	}
+
+	return heightfield;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.hf.HeightfieldFormat", HeightfieldFormat, Object)
+
+Ref< Heightfield > HeightfieldFormat::read(IStream* stream, const Vector4& worldExtent) const
+{
+	Header header;
+	if (!readHeader(stream, header))
+		return nullptr;
+
+	Ref< Heightfield > heightfield = readTiles(stream, header, worldExtent);
 
 	stream->close();
 	return heightfield;
 }
 
+Ref< Heightfield > HeightfieldFormat::readPaged(IStream* stream, const Vector4& worldExtent, int32_t maxResidentTiles) const
+{
+	Header header;
+	if (!readHeader(stream, header))
+		return nullptr;
+
+	const int32_t tileCount = header.size / header.tileSize;
+	if (
+		header.version < 3 ||
+		tileCount * tileCount <= maxResidentTiles ||
+		!stream->canSeek()
+	)
+	{
+		Ref< Heightfield > heightfield = readTiles(stream, header, worldExtent);
+		stream->close();
+		return heightfield;
+	}
+
+	AlignedVector< height_t > overview;
+	if (!readOverview(stream, header, overview))
+		return nullptr;
+
+	return new Heightfield(
+		header.size,
+		worldExtent,
+		header.tileSize,
+		maxResidentTiles,
+		header.haveCuts,
+		header.overviewSize,
+		std::move(overview),
+		stream,
+		stream->tell()
+	);
+}
+
 bool HeightfieldFormat::write(IStream* stream, const Heightfield* heightfield) const
 {
+	const int32_t size = heightfield->getSize();
+	const int32_t tileSize = (size % c_tileSize) == 0 ? c_tileSize : size;
+	const int32_t tileCount = size / tileSize;
+	const int32_t tileCellCount = tileSize * tileSize;
+
+	int32_t overviewSize = size >> 1;
+	while (overviewSize > c_maxOverviewSize)
+		overviewSize >>= 1;
+
+	const height_t* heights = heightfield->getHeights();
+	const uint8_t* cuts = heightfield->getCuts();
+	const uint8_t* attributes = heightfield->getAttributes();
+	T_FATAL_ASSERT_M (heights != nullptr, L"Unable to write paged heightfield");
+
 	Writer(stream) << int32_t(c_version);
-	Writer(stream) << int32_t(heightfield->getSize());
+	Writer(stream) << int32_t(size);
+	Writer(stream) << int32_t(tileSize);
+	Writer(stream) << heightfield->haveCuts();
+	Writer(stream) << int32_t(overviewSize);
 
-	Writer(stream).write(
-		heightfield->getHeights(),
-		heightfield->getSize() * heightfield->getSize(),
-		sizeof(height_t)
-	);
+	// Write overview mip pyramid.
+	AlignedVector< height_t > overview;
+	calculateOverview(heightfield, overviewSize, overview);
+	for (int32_t levelSize = overviewSize; levelSize > 0; levelSize >>= 1)
+	{
+		if (levelSize != overviewSize)
+		{
+			for (int32_t oz = 0; oz < levelSize; ++oz)
+			{
+				for (int32_t ox = 0; ox < levelSize; ++ox)
+				{
+					const int32_t s = levelSize * 2;
+					const uint32_t sum =
+						overview[ox * 2 + oz * 2 * s] +
+						overview[ox * 2 + 1 + oz * 2 * s] +
+						overview[ox * 2 + (oz * 2 + 1) * s] +
+						overview[ox * 2 + 1 + (oz * 2 + 1) * s];
+					overview[ox + oz * levelSize] = height_t(sum / 4);
+				}
+			}
+		}
+		Writer(stream).write(overview.c_ptr(), levelSize * levelSize, sizeof(height_t));
+	}
 
-	Writer(stream).write(
-		heightfield->getCuts(),
-		heightfield->getSize() * heightfield->getSize() / 8,
-		sizeof(uint8_t)
-	);
+	// Write tiles.
+	AlignedVector< uint8_t > tileCuts(tileCellCount / 8);
+	for (int32_t tz = 0; tz < tileCount; ++tz)
+	{
+		for (int32_t tx = 0; tx < tileCount; ++tx)
+		{
+			const int32_t offset = tx * tileSize + tz * tileSize * size;
 
-	Writer(stream).write(
-		heightfield->getAttributes(),
-		heightfield->getSize() * heightfield->getSize(),
-		sizeof(uint8_t)
-	);
+			for (int32_t lz = 0; lz < tileSize; ++lz)
+				Writer(stream).write(heights + offset + lz * size, tileSize, sizeof(height_t));
+
+			std::memset(tileCuts.ptr(), 0, tileCellCount / 8);
+			for (int32_t lz = 0; lz < tileSize; ++lz)
+			{
+				for (int32_t lx = 0; lx < tileSize; ++lx)
+				{
+					const int32_t global = offset + lx + lz * size;
+					const int32_t local = lx + lz * tileSize;
+					if ((cuts[global / 8] & (1 << (global & 7))) != 0)
+						tileCuts[local / 8] |= (1 << (local & 7));
+				}
+			}
+			Writer(stream).write(tileCuts.c_ptr(), tileCellCount / 8, sizeof(uint8_t));
+
+			for (int32_t lz = 0; lz < tileSize; ++lz)
+				Writer(stream).write(attributes + offset + lz * size, tileSize, sizeof(uint8_t));
+		}
+	}
 
 	return true;
 }
@@ -20,6 +20,13 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
+namespace traktor
+{
+
+class IStream;
+
+}
+
 namespace traktor::hf
 {
 
@@ -28,13 +35,29 @@ class Heightfield;
 /*!
  * \ingroup Heightfield
  */
+/*! Heightfield serialization format.
+ * \ingroup Heightfield
+ *
+ * Heightfields are stored as an overview mip pyramid of heights followed
+ * by tiles, each tile contain heights, cuts and attributes.
+ * Tiles can be read on demand by a paged heightfield.
+ */
 class T_DLLCLASS HeightfieldFormat : public Object
 {
 	T_RTTI_CLASS;
 
 public:
+	/*! Read entire heightfield. */
 	Ref< Heightfield > read(IStream* stream, const Vector4& worldExtent) const;
 
+	/*! Read paged heightfield.
+	 *
+	 * Heightfields which doesn't fit in maximum number of resident tiles
+	 * are paged and stream is kept open by the heightfield, else entire
+	 * heightfield is read.
+	 */
+	Ref< Heightfield > readPaged(IStream* stream, const Vector4& worldExtent, int32_t maxResidentTiles) const;
+
 	bool write(IStream* stream, const Heightfield* heightfield) const;
 };
 
@@ -0,0 +1,116 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Heightfield/Heightfield.h"
+#include "Heightfield/HeightfieldFormat.h"
+#include "Heightfield/Test/CaseHeightfieldPaged.h"
+
+namespace traktor::hf::test
+{
+	namespace
+	{
+
+const int32_t c_size = 1024;
+const Vector4 c_worldExtent(1024.0f, 100.0f, 1024.0f, 0.0f);
+
+Ref< Heightfield > createHeightfield()
+{
+	Ref< Heightfield > heightfield = new Heightfield(c_size, c_worldExtent);
+	for (int32_t z = 0; z < c_size; ++z)
+	{
+		for (int32_t x = 0; x < c_size; ++x)
+		{
+			heightfield->setGridHeight(x, z, float((x * 7 + z * 13) % 1000) / 1000.0f);
+			heightfield->setGridCut(x, z, ((x + z) % 5) != 0);
+			heightfield->setGridAttribute(x, z, uint8_t((x ^ z) & 0xff));
+		}
+	}
+	return heightfield;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.hf.test.CaseHeightfieldPaged", 0, CaseHeightfieldPaged, traktor::test::Case)
+
+void CaseHeightfieldPaged::run()
+{
+	Ref< Heightfield > source = createHeightfield();
+
+	AlignedVector< uint8_t > buffer;
+	Ref< IStream > stream = new DynamicMemoryStream(buffer, false, true);
+	CASE_ASSERT(HeightfieldFormat().write(stream, source));
+	stream->close();
+
+	// Entire heightfield must be identical after reading.
+	stream = new DynamicMemoryStream(buffer, true, false);
+	Ref< Heightfield > resident = HeightfieldFormat().read(stream, c_worldExtent);
+	CASE_ASSERT(resident != nullptr);
+	if (!resident)
+		return;
+
+	CASE_ASSERT(!resident->isPaged());
+	CASE_ASSERT(resident->haveCuts());
+
+	bool identical = true;
+	for (int32_t z = 0; z < c_size; ++z)
+	{
+		for (int32_t x = 0; x < c_size; ++x)
+		{
+			identical &= (resident->getGridHeightNearest(x, z) == source->getGridHeightNearest(x, z));
+			identical &= (resident->getGridCut(x, z) == source->getGridCut(x, z));
+			identical &= (resident->getGridAttribute(x, z) == source->getGridAttribute(x, z));
+		}
+	}
+	CASE_ASSERT(identical);
+
+	// Paged heightfield with room for 4 of 16 tiles.
+	stream = new DynamicMemoryStream(buffer, true, false);
+	Ref< Heightfield > paged = HeightfieldFormat().readPaged(stream, c_worldExtent, 4);
+	CASE_ASSERT(paged != nullptr);
+	if (!paged)
+		return;
+
+	CASE_ASSERT(paged->isPaged());
+	CASE_ASSERT(paged->haveCuts());
+	CASE_ASSERT(paged->getHeights() == nullptr);
+	CASE_ASSERT(!paged->isGridResident(10, 10));
+
+	// Nothing resident, heights from overview must still be within range.
+	const float overviewHeight = paged->getWorldHeight(0.0f, 0.0f);
+	CASE_ASSERT(overviewHeight >= -50.0f && overviewHeight <= 50.0f);
+
+	// Page in tiles around corner; 2x2 window of 256x256 tiles.
+	CASE_ASSERT_EQUAL(paged->updateResidency(Vector4(-500.0f, 0.0f, -500.0f, 1.0f), 16), 4);
+	CASE_ASSERT_EQUAL(paged->updateResidency(Vector4(-500.0f, 0.0f, -500.0f, 1.0f), 16), 0);
+	CASE_ASSERT(paged->isGridResident(10, 10));
+	CASE_ASSERT(paged->isGridResident(511, 511));
+	CASE_ASSERT(!paged->isGridResident(512, 10));
+
+	identical = true;
+	for (int32_t z = 0; z < 512; ++z)
+	{
+		for (int32_t x = 0; x < 512; ++x)
+		{
+			identical &= (paged->getGridHeightNearest(x, z) == source->getGridHeightNearest(x, z));
+			identical &= (paged->getGridCut(x, z) == source->getGridCut(x, z));
+			identical &= (paged->getGridAttribute(x, z) == source->getGridAttribute(x, z));
+		}
+	}
+	CASE_ASSERT(identical);
+
+	// Move to opposite corner, limited number of tiles read each update.
+	CASE_ASSERT_EQUAL(paged->updateResidency(Vector4(500.0f, 0.0f, 500.0f, 1.0f), 1), 1);
+	CASE_ASSERT_EQUAL(paged->updateResidency(Vector4(500.0f, 0.0f, 500.0f, 1.0f), 16), 3);
+	CASE_ASSERT(!paged->isGridResident(10, 10));
+	CASE_ASSERT(paged->isGridResident(1000, 1000));
+	CASE_ASSERT(paged->getGridHeightNearest(1000, 1000) == source->getGridHeightNearest(1000, 1000));
+	CASE_ASSERT(paged->getGridAttribute(600, 700) == source->getGridAttribute(600, 700));
+}
+
+}
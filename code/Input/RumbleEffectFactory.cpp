@@ -35,6 +35,11 @@ bool RumbleEffectFactory::isCacheable(const TypeInfo& productType) const
 	return true;
 }
 
+bool RumbleEffectFactory::isThreadSafe() const
+{
+	return true;
+}
+
 Ref< Object > RumbleEffectFactory::create(resource::IResourceManager* resourceManager, const db::Database* database, const db::Instance* instance, const TypeInfo& productType, const Object* current) const
 {
 	return instance->getObject< RumbleEffect >();
@@ -98,8 +98,9 @@ InputDriverX11::UpdateResult InputDriverX11::update()
 			{
 				for (auto device : m_devices)
 				{
-					T_PROFILER_SCOPE(str(L"InputDriverX11 update - %s", type_name(device)));
+					T_PROFILER_BEGIN(str(L"InputDriverX11 update - %s", type_name(device)));
 					device->consumeEvent(evt);
+					T_PROFILER_END();
 				}
 				XFreeEventData(m_display, &evt.xcookie);
 			}
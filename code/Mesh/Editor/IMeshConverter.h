@@ -10,6 +10,7 @@
 
 #include <list>
 #include <map>
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Guid.h"
 #include "Core/RefArray.h"
 #include "Mesh/Editor/MeshPipelineTypes.h"
@@ -46,6 +47,7 @@ public:
 	virtual bool convert(
 		const MeshAsset* meshAsset,
 		const model::Model* model,
+		const AlignedVector< MeshLod >& lods,
 		const Guid& materialGuid,
 		const std::map< std::wstring, std::list< MeshMaterialTechnique > >& materialTechniqueMap,
 		const AlignedVector< render::VertexElement >& vertexElements,
@@ -55,6 +55,7 @@ bool InstanceMeshConverter::getOperations(const MeshAsset* meshAsset, bool edito
 bool InstanceMeshConverter::convert(
 	const MeshAsset* meshAsset,
 	const model::Model* model,
+	const AlignedVector< MeshLod >& lods,
 	const Guid& materialGuid,
 	const std::map< std::wstring, std::list< MeshMaterialTechnique > >& materialTechniqueMap,
 	const AlignedVector< render::VertexElement >& vertexElements,
@@ -62,6 +63,11 @@ bool InstanceMeshConverter::convert(
 	IStream* meshResourceStream
 ) const
 {
+	// Full detail level first, followed by reduced levels which share vertices.
+	AlignedVector< MeshLod > levels;
+	levels.push_back({ model, 0.0f });
+	levels.insert(levels.end(), lods.begin(), lods.end());
+
 	// Create render mesh.
 	const uint32_t vertexSize = render::getVertexSize(vertexElements);
 	T_ASSERT(vertexSize > 0);
@@ -69,9 +75,16 @@ bool InstanceMeshConverter::convert(
 	const bool useLargeIndices = (bool)(model->getVertexCount() >= 65536);
 	const uint32_t indexSize = useLargeIndices ? sizeof(uint32_t) : sizeof(uint16_t);
 
+	uint32_t indexCount = 0;
+	for (const auto& level : levels)
+	{
+		T_FATAL_ASSERT(level.model->getVertexCount() == model->getVertexCount());
+		indexCount += (uint32_t)level.model->getPolygons().size() * 3;
+	}
+
 	// Create render mesh.
 	const uint32_t vertexBufferSize = (uint32_t)(model->getVertices().size() * vertexSize);
-	const uint32_t indexBufferSize = (uint32_t)(model->getPolygons().size() * 3 * indexSize);
+	const uint32_t indexBufferSize = indexCount * indexSize;
 	const uint32_t rtVertexAttributesSize = (uint32_t)(model->getPolygons().size() * 3 * sizeof(world::RTVertexAttributes));
 
 	Ref< render::Mesh > renderMesh = render::SystemMeshFactory().createMesh(
@@ -109,44 +122,50 @@ bool InstanceMeshConverter::convert(
 
 	renderMesh->getVertexBuffer()->unlock();
 
-	// Create index buffer.
-	std::map< std::wstring, AlignedVector< IndexRange > > techniqueRanges;
+	// Create index buffer, ranges of each detail level are appended after each other.
+	AlignedVector< std::map< std::wstring, AlignedVector< IndexRange > > > levelTechniqueRanges(levels.size());
 
 	uint8_t* index = (uint8_t*)renderMesh->getIndexBuffer()->lock();
 	uint8_t* indexFirst = index;
 
-	for (const auto& mt : materialTechniqueMap)
+	for (uint32_t i = 0; i < (uint32_t)levels.size(); ++i)
 	{
-		IndexRange range;
-		range.offsetFirst = (uint32_t)(index - indexFirst) / indexSize;
-		range.offsetLast = 0;
+		const model::Model* levelModel = levels[i].model;
+		auto& techniqueRanges = levelTechniqueRanges[i];
 
-		for (const auto& polygon : model->getPolygons())
+		for (const auto& mt : materialTechniqueMap)
 		{
-			T_ASSERT(polygon.getVertices().size() == 3);
-
-			if (model->getMaterial(polygon.getMaterial()).getName() != mt.first)
-				continue;
+			IndexRange range;
+			range.offsetFirst = (uint32_t)(index - indexFirst) / indexSize;
+			range.offsetLast = 0;
 
-			for (int32_t k = 0; k < 3; ++k)
+			for (const auto& polygon : levelModel->getPolygons())
 			{
-				if (useLargeIndices)
-					*(uint32_t*)index = polygon.getVertex(k);
-				else
-					*(uint16_t*)index = polygon.getVertex(k);
+				T_ASSERT(polygon.getVertices().size() == 3);
 
-				index += indexSize;
+				if (levelModel->getMaterial(polygon.getMaterial()).getName() != mt.first)
+					continue;
+
+				for (int32_t k = 0; k < 3; ++k)
+				{
+					if (useLargeIndices)
+						*(uint32_t*)index = polygon.getVertex(k);
+					else
+						*(uint16_t*)index = polygon.getVertex(k);
+
+					index += indexSize;
+				}
 			}
-		}
 
-		range.offsetLast = (uint32_t)(index - indexFirst) / indexSize;
-		if (range.offsetLast <= range.offsetFirst)
-			continue;
+			range.offsetLast = (uint32_t)(index - indexFirst) / indexSize;
+			if (range.offsetLast <= range.offsetFirst)
+				continue;
 
-		for (const auto& mtt : mt.second)
-		{
-			const std::wstring technique = mtt.worldTechnique + L"/" + mtt.shaderTechnique;
-			range.mergeInto(techniqueRanges[technique]);
+			for (const auto& mtt : mt.second)
+			{
+				const std::wstring technique = mtt.worldTechnique + L"/" + mtt.shaderTechnique;
+				range.mergeInto(techniqueRanges[technique]);
+			}
 		}
 	}
 
@@ -154,44 +173,50 @@ bool InstanceMeshConverter::convert(
 
 	// Build parts.
 	AlignedVector< render::Mesh::Part > meshParts;
-	std::map< std::wstring, InstanceMeshResource::parts_t > parts;
+	std::list< InstanceMeshResource::Lod > resourceLods;
 
-	for (const auto& techniqueRange : techniqueRanges)
+	for (uint32_t i = 0; i < (uint32_t)levels.size(); ++i)
 	{
-		std::wstring worldTechnique, shaderTechnique;
-		split(techniqueRange.first, L'/', worldTechnique, shaderTechnique);
+		auto& resourceLod = resourceLods.emplace_back();
+		resourceLod.error = levels[i].error;
 
-		for (const auto& range : techniqueRange.second)
+		for (const auto& techniqueRange : levelTechniqueRanges[i])
 		{
-			InstanceMeshResource::Part part;
-			part.shaderTechnique = shaderTechnique;
-			part.meshPart = (uint32_t)meshParts.size();
+			std::wstring worldTechnique, shaderTechnique;
+			split(techniqueRange.first, L'/', worldTechnique, shaderTechnique);
 
-			for (uint32_t k = 0; k < (uint32_t)meshParts.size(); ++k)
+			for (const auto& range : techniqueRange.second)
 			{
-				if (
-					meshParts[k].primitives.offset == range.offsetFirst &&
-					meshParts[k].primitives.count == (range.offsetLast - range.offsetFirst) / 3
-				)
+				InstanceMeshResource::Part part;
+				part.shaderTechnique = shaderTechnique;
+				part.meshPart = (uint32_t)meshParts.size();
+
+				for (uint32_t k = 0; k < (uint32_t)meshParts.size(); ++k)
 				{
-					part.meshPart = k;
-					break;
+					if (
+						meshParts[k].primitives.offset == range.offsetFirst &&
+						meshParts[k].primitives.count == (range.offsetLast - range.offsetFirst) / 3
+					)
+					{
+						part.meshPart = k;
+						break;
+					}
 				}
-			}
 
-			if (part.meshPart >= meshParts.size())
-			{
-				render::Mesh::Part meshPart;
-				meshPart.name = techniqueRange.first;
-				meshPart.primitives = render::Primitives::setIndexed(
-					render::PrimitiveType::Triangles,
-					range.offsetFirst,
-					(range.offsetLast - range.offsetFirst) / 3
-				);
-				meshParts.push_back(meshPart);
-			}
+				if (part.meshPart >= meshParts.size())
+				{
+					render::Mesh::Part meshPart;
+					meshPart.name = techniqueRange.first;
+					meshPart.primitives = render::Primitives::setIndexed(
+						render::PrimitiveType::Triangles,
+						range.offsetFirst,
+						(range.offsetLast - range.offsetFirst) / 3
+					);
+					meshParts.push_back(meshPart);
+				}
 
-			parts[worldTechnique].push_back(part);
+				resourceLod.parts[worldTechnique].push_back(part);
+			}
 		}
 	}
 
@@ -259,7 +284,7 @@ bool InstanceMeshConverter::convert(
 
 	checked_type_cast< InstanceMeshResource* >(meshResource)->m_haveRenderMesh = true;
 	checked_type_cast< InstanceMeshResource* >(meshResource)->m_shader = resource::Id< render::Shader >(materialGuid);
-	checked_type_cast< InstanceMeshResource* >(meshResource)->m_parts = parts;
+	checked_type_cast< InstanceMeshResource* >(meshResource)->m_lods = resourceLods;
 
 	return true;
 }
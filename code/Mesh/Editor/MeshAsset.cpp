@@ -18,7 +18,7 @@
 namespace traktor::mesh
 {
 
-T_IMPLEMENT_RTTI_EDIT_CLASS(L"traktor.mesh.MeshAsset", 24, MeshAsset, editor::Asset)
+T_IMPLEMENT_RTTI_EDIT_CLASS(L"traktor.mesh.MeshAsset", 25, MeshAsset, editor::Asset)
 
 void MeshAsset::serialize(ISerializer& s)
 {
@@ -102,6 +102,12 @@ void MeshAsset::serialize(ISerializer& s)
 	if (s.getVersion() >= 24)
 		s >> Member< float >(L"reduce", m_reduce, AttributeRange(0.0f, 1.0f));
 
+	if (s.getVersion() >= 25)
+	{
+		s >> Member< int32_t >(L"lodSteps", m_lodSteps, AttributeRange(0, 8));
+		s >> Member< float >(L"lodReduce", m_lodReduce, AttributeRange(0.0f, 1.0f));
+	}
+
 	if (s.getVersion() >= 20)
 		s >> Member< float >(L"previewAngle", m_previewAngle, AttributeNoHash());
 }
@@ -107,6 +107,18 @@ public:
 	/*! */
 	float getReduce() const { return m_reduce; }
 
+	/*! Set number of generated detail levels, excluding the full detail level. */
+	void setLodSteps(int32_t lodSteps) { m_lodSteps = lodSteps; }
+
+	/*! Get number of generated detail levels, excluding the full detail level. */
+	int32_t getLodSteps() const { return m_lodSteps; }
+
+	/*! Set fraction of triangles kept in each detail level relative to the previous. */
+	void setLodReduce(float lodReduce) { m_lodReduce = lodReduce; }
+
+	/*! Get fraction of triangles kept in each detail level relative to the previous. */
+	float getLodReduce() const { return m_lodReduce; }
+
 	/*! */
 	void setPreviewAngle(float previewAngle) { m_previewAngle = previewAngle; }
 
@@ -125,6 +137,8 @@ private:
 	bool m_grounded = false;
 	bool m_decalResponse = true;
 	float m_reduce = 1.0f;
+	int32_t m_lodSteps = 0;
+	float m_lodReduce = 0.5f;
 	float m_previewAngle = 0.0f;
 };
 
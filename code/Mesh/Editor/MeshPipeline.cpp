@@ -148,7 +148,7 @@ bool buildEmbeddedTexture(editor::IPipelineBuilder* pipelineBuilder, model::Mate
 
 	}
 
-T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.mesh.MeshPipeline", 50, MeshPipeline, editor::IPipeline)
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.mesh.MeshPipeline", 51, MeshPipeline, editor::IPipeline)
 
 MeshPipeline::MeshPipeline()
 :	m_promoteHalf(false)
@@ -360,6 +360,44 @@ bool MeshPipeline::buildOutput(
 		model->apply(model::Transform(translate(Vector4(0.0f, -boundingBox.mn.y(), 0.0f))));
 	}
 
+	// Generate chain of reduced detail levels; each level reduce previous level
+	// while keeping full detail vertices so all levels can share vertex buffer.
+	AlignedVector< MeshLod > lods;
+	if (asset->getLodSteps() > 0 && asset->getMeshType() != MeshAsset::MtSkinned)
+	{
+		pipelineBuilder->getProfiler()->begin(L"MeshPipeline generate detail levels");
+
+		Ref< const model::Model > previous = model;
+		float error = 0.0f;
+
+		for (int32_t i = 0; i < asset->getLodSteps(); ++i)
+		{
+			Ref< model::Model > lodModel = DeepClone(previous).create< model::Model >();
+			if (!lodModel)
+				break;
+
+			const model::Reduce reduce(asset->getLodReduce(), false);
+			if (!lodModel->apply(reduce))
+				break;
+
+			if (lodModel->getPolygonCount() == 0 || lodModel->getPolygonCount() >= previous->getPolygonCount())
+				break;
+
+			// Each level's error is accumulated from previous levels since error
+			// of reduction is measured against previous level.
+			error += reduce.getMaxError();
+
+			auto& lod = lods.push_back();
+			lod.model = lodModel;
+			lod.error = error;
+
+			log::info << L"Detail level " << (i + 1) << L"; " << lodModel->getPolygonCount() << L" polygon(s), error " << error << Endl;
+			previous = lodModel;
+		}
+
+		pipelineBuilder->getProfiler()->end();
+	}
+
 	const AlignedVector< model::Material >& modelMaterials = model->getMaterials();
 	if (model->getMaterials().empty())
 	{
@@ -803,6 +841,7 @@ bool MeshPipeline::buildOutput(
 	if (!converter->convert(
 		asset,
 		model,
+		lods,
 		materialGuid,
 		materialTechniqueMap,
 		vertexElements,
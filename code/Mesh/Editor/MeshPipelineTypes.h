@@ -9,6 +9,14 @@
 #pragma once
 
 #include "Core/Config.h"
+#include "Core/Ref.h"
+
+namespace traktor::model
+{
+
+class Model;
+
+}
 
 namespace traktor::mesh
 {
@@ -20,4 +28,10 @@ struct MeshMaterialTechnique
 	uint32_t hash;					//< Shader technique hash.
 };
 
+struct MeshLod
+{
+	Ref< const model::Model > model;	//< Reduced model, share vertices with full detail model.
+	float error;						//< Max geometric error, in model space, compared to full detail model.
+};
+
 }
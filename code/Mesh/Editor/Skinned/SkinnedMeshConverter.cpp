@@ -56,6 +56,7 @@ bool SkinnedMeshConverter::getOperations(const MeshAsset* meshAsset, bool editor
 bool SkinnedMeshConverter::convert(
 	const MeshAsset* meshAsset,
 	const model::Model* model,
+	const AlignedVector< MeshLod >& /*lods*/,
 	const Guid& materialGuid,
 	const std::map< std::wstring, std::list< MeshMaterialTechnique > >& materialTechniqueMap,
 	const AlignedVector< render::VertexElement >& vertexElements,
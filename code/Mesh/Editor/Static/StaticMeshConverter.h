@@ -23,6 +23,7 @@ public:
 	virtual bool convert(
 		const MeshAsset* meshAsset,
 		const model::Model* model,
+		const AlignedVector< MeshLod >& lods,
 		const Guid& materialGuid,
 		const std::map< std::wstring, std::list< MeshMaterialTechnique > >& materialTechniqueMap,
 		const AlignedVector< render::VertexElement >& vertexElements,
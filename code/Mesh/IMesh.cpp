@@ -7,12 +7,35 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include "Mesh/IMesh.h"
+#include "World/WorldRenderView.h"
 
 namespace traktor::mesh
 {
+	namespace
+	{
+
+/*! Max allowed geometric error, in pixels, when selecting detail level. */
+const float c_maxPixelError = 1.0f;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.mesh.IMesh", IMesh, Object)
 
 const FourCC IMesh::c_fccRayTracingVertexAttributes("RTVA");
 
+bool IMesh::isLodAcceptable(const world::WorldRenderView& worldRenderView, float distance, float error)
+{
+	const Matrix44& projection = worldRenderView.getProjection();
+	const float pixelsPerUnit = projection.get(1, 1) * worldRenderView.getViewSize().y * 0.5f;
+
+	// Orthographic projection has no perspective division.
+	if (projection.get(3, 3) != 0.0f)
+		return error * pixelsPerUnit <= c_maxPixelError;
+
+	if (distance <= FUZZY_EPSILON)
+		return false;
+
+	return error * pixelsPerUnit <= c_maxPixelError * distance;
+}
+
 }
@@ -19,6 +19,13 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
+namespace traktor::world
+{
+
+class WorldRenderView;
+
+}
+
 namespace traktor::mesh
 {
 
@@ -31,6 +38,16 @@ class T_DLLCLASS IMesh : public Object
 
 public:
 	static const FourCC c_fccRayTracingVertexAttributes;
+
+protected:
+	/*! Check if a detail level's geometric error, projected onto screen, is small enough.
+	 *
+	 * \param worldRenderView Render view.
+	 * \param distance Nearest view distance to mesh.
+	 * \param error Max geometric error of detail level, in model space.
+	 * \return True if detail level can be used.
+	 */
+	static bool isLodAcceptable(const world::WorldRenderView& worldRenderView, float distance, float error);
 };
 
 }
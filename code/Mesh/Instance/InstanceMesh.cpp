@@ -54,13 +54,16 @@ const Aabb3& InstanceMesh::getBoundingBox() const
 
 bool InstanceMesh::supportTechnique(render::handle_t technique) const
 {
-	return m_parts.find(technique) != m_parts.end();
+	return !m_lods.empty() && m_lods.front().parts.find(technique) != m_lods.front().parts.end();
 }
 
 void InstanceMesh::getTechniques(SmallSet< render::handle_t >& outHandles) const
 {
-	for (const auto part : m_parts)
-		outHandles.insert(part.first);
+	for (const auto& lod : m_lods)
+	{
+		for (const auto& part : lod.parts)
+			outHandles.insert(part.first);
+	}
 }
 
 void InstanceMesh::build(
@@ -70,11 +73,20 @@ void InstanceMesh::build(
 	render::Buffer* instanceBuffer,
 	render::Buffer* visibilityBuffer,
 	uint32_t start,
-	uint32_t count
+	uint32_t count,
+	float distance
 )
 {
-	const auto it = m_parts.find(worldRenderPass.getTechnique());
-	if (it == m_parts.end())
+	// Select detail level; all instances use same level as the nearest instance.
+	uint32_t lod = 0;
+	while (lod + 1 < (uint32_t)m_lods.size() && isLodAcceptable(worldRenderView, distance, m_lods[lod + 1].error))
+		++lod;
+
+	if (lod >= (uint32_t)m_lods.size())
+		return;
+
+	const auto it = m_lods[lod].parts.find(worldRenderPass.getTechnique());
+	if (it == m_lods[lod].parts.end())
 		return;
 
 	render::RenderContext* renderContext = context.getRenderContext();
@@ -82,6 +94,16 @@ void InstanceMesh::build(
 	const AlignedVector< Part >& parts = it->second;
 	const auto& meshParts = m_renderMesh->getParts();
 
+	// Draw buffers are indexed with same stride for all detail levels
+	// since cascades might select different levels.
+	uint32_t partStride = 0;
+	for (const auto& l : m_lods)
+	{
+		const auto jt = l.parts.find(worldRenderPass.getTechnique());
+		if (jt != l.parts.end())
+			partStride = std::max(partStride, (uint32_t)jt->second.size());
+	}
+
 	// Lazy create the buffers.
 	const uint32_t bufferItemCount = (uint32_t)alignUp(count, 16);
 	if (count > m_allocatedCount)
@@ -92,7 +114,7 @@ void InstanceMesh::build(
 
 	const uint32_t peakCascade = worldRenderView.getCascade();
 	const uint32_t dbSize = (uint32_t)m_drawBuffers.size();
-	for (uint32_t i = dbSize; i < (peakCascade + 1) * parts.size(); ++i)
+	for (uint32_t i = dbSize; i < (peakCascade + 1) * partStride; ++i)
 		m_drawBuffers.push_back(m_renderSystem->createBuffer(
 			render::BufferUsage::BuStructured | render::BufferUsage::BuIndirect,
 			bufferItemCount * sizeof(render::IndexedIndirectDraw),
@@ -112,7 +134,7 @@ void InstanceMesh::build(
 		if (!sp)
 			continue;
 
-		render::Buffer* drawBuffer = m_drawBuffers[worldRenderView.getCascade() * parts.size() + i];
+		render::Buffer* drawBuffer = m_drawBuffers[worldRenderView.getCascade() * partStride + i];
 
 		const auto& primitives = meshParts[part.meshPart].primitives;
 
@@ -149,7 +171,7 @@ void InstanceMesh::build(
 		if (!sp)
 			continue;
 
-		render::Buffer* drawBuffer = m_drawBuffers[worldRenderView.getCascade() * parts.size() + i];
+		render::Buffer* drawBuffer = m_drawBuffers[worldRenderView.getCascade() * partStride + i];
 
 		auto renderBlock = renderContext->allocNamed< render::IndirectRenderBlock >(
 			str(L"InstanceMesh draw %d %d", worldRenderView.getCascade(), i)
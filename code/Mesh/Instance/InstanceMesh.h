@@ -79,6 +79,10 @@ public:
 
 	void getTechniques(SmallSet< render::handle_t >& outHandles) const;
 
+	/*! Build draw commands of instances.
+	 *
+	 * \param distance Nearest view distance of all instances, used to select detail level.
+	 */
 	void build(
 		const world::WorldBuildContext& context,
 		const world::WorldRenderView& worldRenderView,
@@ -86,7 +90,8 @@ public:
 		render::Buffer* instanceBuffer,
 		render::Buffer* visibilityBuffer,
 		uint32_t start,
-		uint32_t count
+		uint32_t count,
+		float distance
 	);
 
 	const render::IAccelerationStructure* getAccelerationStructure() const { return m_rtAccelerationStructure; }
@@ -96,7 +101,13 @@ public:
 private:
 	friend class InstanceMeshResource;
 
-	SmallMap< render::handle_t, AlignedVector< Part > > m_parts;
+	struct Lod
+	{
+		float error = 0.0f;
+		SmallMap< render::handle_t, AlignedVector< Part > > parts;
+	};
+
+	AlignedVector< Lod > m_lods;
 
 	// Rasterization
 	resource::Proxy< render::Shader > m_shader;
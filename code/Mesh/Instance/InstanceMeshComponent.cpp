@@ -124,7 +124,8 @@ void InstanceMeshComponent::cullableBuild(
 	render::Buffer* instanceBuffer,
 	render::Buffer* visibilityBuffer,
 	uint32_t start,
-	uint32_t count
+	uint32_t count,
+	float distance
 )
 {
 	// Draw mesh instances; this method is called for the "first" InstanceMeshComponent using the same ordinal number
@@ -137,7 +138,8 @@ void InstanceMeshComponent::cullableBuild(
 			instanceBuffer,
 			visibilityBuffer,
 			start,
-			count
+			count,
+			distance
 		);
 }
 
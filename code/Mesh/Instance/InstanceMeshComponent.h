@@ -69,7 +69,8 @@ public:
 		render::Buffer* instanceBuffer,
 		render::Buffer* visibilityBuffer,
 		uint32_t start,
-		uint32_t count
+		uint32_t count,
+		float distance
 	) override final;
 
 private:
@@ -30,7 +30,7 @@ const resource::Id< render::Shader > c_shaderInstanceMeshDraw(L"{A8FDE33C-D75B-4
 
 	}
 
-T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.mesh.InstanceMeshResource", 8, InstanceMeshResource, MeshResource)
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.mesh.InstanceMeshResource", 9, InstanceMeshResource, MeshResource)
 
 Ref< IMesh > InstanceMeshResource::createMesh(
 	const std::wstring& name,
@@ -63,17 +63,24 @@ Ref< IMesh > InstanceMeshResource::createMesh(
 
 	instanceMesh->m_renderMesh = renderMesh;
 
-	for (const auto& part : m_parts)
+	instanceMesh->m_lods.reserve(m_lods.size());
+	for (const auto& lod : m_lods)
 	{
-		render::handle_t worldTechnique = render::getParameterHandle(part.first);
+		auto& instanceLod = instanceMesh->m_lods.push_back();
+		instanceLod.error = lod.error;
 
-		instanceMesh->m_parts[worldTechnique].reserve(part.second.size());
-		for (parts_t::const_iterator j = part.second.begin(); j != part.second.end(); ++j)
+		for (const auto& part : lod.parts)
 		{
-			InstanceMesh::Part part;
-			part.shaderTechnique = render::getParameterHandle(j->shaderTechnique);
-			part.meshPart = j->meshPart;
-			instanceMesh->m_parts[worldTechnique].push_back(part);
+			render::handle_t worldTechnique = render::getParameterHandle(part.first);
+
+			instanceLod.parts[worldTechnique].reserve(part.second.size());
+			for (parts_t::const_iterator j = part.second.begin(); j != part.second.end(); ++j)
+			{
+				InstanceMesh::Part part;
+				part.shaderTechnique = render::getParameterHandle(j->shaderTechnique);
+				part.meshPart = j->meshPart;
+				instanceLod.parts[worldTechnique].push_back(part);
+			}
 		}
 	}
 
@@ -104,18 +111,24 @@ Ref< IMesh > InstanceMeshResource::createMesh(
 
 void InstanceMeshResource::serialize(ISerializer& s)
 {
-	T_ASSERT_M(s.getVersion() >= 8, L"Incorrect version");
+	T_ASSERT_M(s.getVersion() >= 9, L"Incorrect version");
 
 	MeshResource::serialize(s);
 
 	s >> Member< bool >(L"haveRenderMesh", m_haveRenderMesh);
 	s >> resource::Member< render::Shader >(L"shader", m_shader);
+	s >> MemberStlList< Lod, MemberComposite< Lod > >(L"lods", m_lods);
+}
+
+void InstanceMeshResource::Lod::serialize(ISerializer& s)
+{
+	s >> Member< float >(L"error", error);
 	s >> MemberStlMap<
 		std::wstring,
 		parts_t,
 		Member< std::wstring >,
 		MemberStlList< Part, MemberComposite< Part > >
-	>(L"parts", m_parts);
+	>(L"parts", parts);
 }
 
 void InstanceMeshResource::Part::serialize(ISerializer& s)
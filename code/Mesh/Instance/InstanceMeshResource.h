@@ -48,6 +48,16 @@ public:
 		void serialize(ISerializer& s);
 	};
 
+	typedef std::list< Part > parts_t;
+
+	struct T_DLLCLASS Lod
+	{
+		float error = 0.0f;
+		std::map< std::wstring, parts_t > parts;
+
+		void serialize(ISerializer& s);
+	};
+
 	virtual Ref< IMesh > createMesh(
 		const std::wstring& name,
 		IStream* dataStream,
@@ -60,11 +70,10 @@ public:
 
 private:
 	friend class InstanceMeshConverter;
-	typedef std::list< Part > parts_t;
 
 	bool m_haveRenderMesh = false;
 	resource::Id< render::Shader > m_shader;
-	std::map< std::wstring, parts_t > m_parts;
+	std::list< Lod > m_lods;
 };
 
 }
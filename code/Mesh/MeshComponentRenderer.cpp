@@ -57,4 +57,10 @@ void MeshComponentRenderer::build(
 {
 }
 
+bool MeshComponentRenderer::isBuildConcurrent() const
+{
+	// Mesh components only modify their own state when being built.
+	return true;
+}
+
 }
@@ -57,6 +57,8 @@ public:
 		const world::WorldRenderView& worldRenderView,
 		const world::IWorldRenderPass& worldRenderPass
 	) override final;
+
+	virtual bool isBuildConcurrent() const override;
 };
 
 }
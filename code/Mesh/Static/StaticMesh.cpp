@@ -23,10 +23,22 @@ const Aabb3& StaticMesh::getBoundingBox() const
 	return m_renderMesh->getBoundingBox();
 }
 
-const StaticMesh::techniqueParts_t* StaticMesh::findTechniqueParts(render::handle_t technique) const
+uint32_t StaticMesh::selectLod(const world::WorldRenderView& worldRenderView, float distance) const
 {
-	auto it = m_techniqueParts.find(technique);
-	return it != m_techniqueParts.end() ? &it->second : nullptr;
+	uint32_t lod = 0;
+	while (lod + 1 < (uint32_t)m_lods.size() && isLodAcceptable(worldRenderView, distance, m_lods[lod + 1].error))
+		++lod;
+	return lod;
+}
+
+const StaticMesh::techniqueParts_t* StaticMesh::findTechniqueParts(render::handle_t technique, uint32_t lod) const
+{
+	if (lod >= (uint32_t)m_lods.size())
+		return nullptr;
+
+	const auto& techniqueParts = m_lods[lod].techniqueParts;
+	auto it = techniqueParts.find(technique);
+	return it != techniqueParts.end() ? &it->second : nullptr;
 }
 
 void StaticMesh::build(
@@ -70,7 +70,10 @@ public:
 
 	const Aabb3& getBoundingBox() const;
 
-	const techniqueParts_t* findTechniqueParts(render::handle_t technique) const;
+	/*! Select detail level from view and distance to mesh. */
+	uint32_t selectLod(const world::WorldRenderView& worldRenderView, float distance) const;
+
+	const techniqueParts_t* findTechniqueParts(render::handle_t technique, uint32_t lod = 0) const;
 
 	void build(
 		render::RenderContext* renderContext,
@@ -89,8 +92,14 @@ public:
 private:
 	friend class StaticMeshResource;
 
+	struct Lod
+	{
+		float error = 0.0f;
+		SmallMap< render::handle_t, techniqueParts_t > techniqueParts;
+	};
+
 	AlignedVector< Part > m_parts;
-	SmallMap< render::handle_t, techniqueParts_t > m_techniqueParts;
+	AlignedVector< Lod > m_lods;
 
 	// Rasterization
 	resource::Proxy< render::Shader > m_shader;
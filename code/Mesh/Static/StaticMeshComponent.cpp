@@ -99,8 +99,7 @@ Aabb3 StaticMeshComponent::getBoundingBox() const
 
 void StaticMeshComponent::build(const world::WorldBuildContext& context, const world::WorldRenderView& worldRenderView, const world::IWorldRenderPass& worldRenderPass)
 {
-	const StaticMesh::techniqueParts_t* techniqueParts = m_mesh->findTechniqueParts(worldRenderPass.getTechnique());
-	if (!techniqueParts)
+	if (!m_mesh->findTechniqueParts(worldRenderPass.getTechnique()))
 		return;
 
 	const Transform worldTransform = m_transform.get(worldRenderView.getInterval());
@@ -120,6 +119,14 @@ void StaticMeshComponent::build(const world::WorldBuildContext& context, const w
 	))
 		return;
 
+	// Select detail level from nearest distance to bounding sphere.
+	const float lodDistance = distance - 2.0f * m_mesh->getBoundingBox().getExtent().length();
+	const uint32_t lod = m_mesh->selectLod(worldRenderView, lodDistance);
+
+	const StaticMesh::techniqueParts_t* techniqueParts = m_mesh->findTechniqueParts(worldRenderPass.getTechnique(), lod);
+	if (!techniqueParts)
+		return;
+
 	m_mesh->build(
 		context.getRenderContext(),
 		worldRenderPass,
@@ -25,7 +25,7 @@
 namespace traktor::mesh
 {
 
-T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.mesh.StaticMeshResource", 6, StaticMeshResource, MeshResource)
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.mesh.StaticMeshResource", 7, StaticMeshResource, MeshResource)
 
 StaticMeshResource::StaticMeshResource()
 :	m_haveRenderMesh(false)
@@ -59,23 +59,30 @@ Ref< IMesh > StaticMeshResource::createMesh(
 
 	staticMesh->m_renderMesh = renderMesh;
 
-	// Create rasterization parts.
-	for (const auto& tp : m_parts)
+	// Create rasterization parts, for each detail level.
+	staticMesh->m_lods.resize(m_lods.size());
+	for (uint32_t i = 0; i < (uint32_t)m_lods.size(); ++i)
 	{
-		const render::handle_t worldTechnique = render::getParameterHandle(tp.first);
+		auto& lod = staticMesh->m_lods[i];
+		lod.error = m_lods[i].error;
 
-		auto& r = staticMesh->m_techniqueParts[worldTechnique];
-		r.first = (uint32_t)staticMesh->m_parts.size();
-
-		staticMesh->m_parts.reserve(r.first + tp.second.size());
-		for (const auto& p : tp.second)
+		for (const auto& tp : m_lods[i].parts)
 		{
-			StaticMesh::Part& part = staticMesh->m_parts.push_back();
-			part.shaderTechnique = render::getParameterHandle(p.shaderTechnique);
-			part.meshPart = p.meshPart;
-		}
+			const render::handle_t worldTechnique = render::getParameterHandle(tp.first);
+
+			auto& r = lod.techniqueParts[worldTechnique];
+			r.first = (uint32_t)staticMesh->m_parts.size();
+
+			staticMesh->m_parts.reserve(r.first + tp.second.size());
+			for (const auto& p : tp.second)
+			{
+				StaticMesh::Part& part = staticMesh->m_parts.push_back();
+				part.shaderTechnique = render::getParameterHandle(p.shaderTechnique);
+				part.meshPart = p.meshPart;
+			}
 
-		r.second = (uint32_t)staticMesh->m_parts.size();
+			r.second = (uint32_t)staticMesh->m_parts.size();
+		}
 	}
 
 	// Create ray tracing structures.
@@ -109,18 +116,24 @@ Ref< IMesh > StaticMeshResource::createMesh(
 
 void StaticMeshResource::serialize(ISerializer& s)
 {
-	T_ASSERT_M(s.getVersion() >= 6, L"Incorrect version");
+	T_ASSERT_M(s.getVersion() >= 7, L"Incorrect version");
 
 	MeshResource::serialize(s);
 
 	s >> Member< bool >(L"haveRenderMesh", m_haveRenderMesh);
 	s >> resource::Member< render::Shader >(L"shader", m_shader);
+	s >> MemberAlignedVector< Lod, MemberComposite< Lod > >(L"lods", m_lods);
+}
+
+void StaticMeshResource::Lod::serialize(ISerializer& s)
+{
+	s >> Member< float >(L"error", error);
 	s >> MemberSmallMap<
 		std::wstring,
 		parts_t,
 		Member< std::wstring >,
 		MemberAlignedVector< Part, MemberComposite< Part > >
-	>(L"parts", m_parts);
+	>(L"parts", parts);
 }
 
 void StaticMeshResource::Part::serialize(ISerializer& s)
@@ -47,6 +47,16 @@ public:
 		void serialize(ISerializer& s);
 	};
 
+	typedef AlignedVector< Part > parts_t;
+
+	struct T_DLLCLASS Lod
+	{
+		float error = 0.0f;
+		SmallMap< std::wstring, parts_t > parts;
+
+		void serialize(ISerializer& s);
+	};
+
 	StaticMeshResource();
 
 	virtual Ref< IMesh > createMesh(
@@ -61,11 +71,10 @@ public:
 
 private:
 	friend class StaticMeshConverter;
-	typedef AlignedVector< Part > parts_t;
 
 	bool m_haveRenderMesh;
 	resource::Id< render::Shader > m_shader;
-	SmallMap< std::wstring, parts_t > m_parts;
+	AlignedVector< Lod > m_lods;
 };
 
 }
@@ -71,7 +71,7 @@ void ModelAdjacency::remove(uint32_t polygon, bool reindex)
 	const uint32_t firstEdge = m_polygonToFirstEdge[polygon];
 	T_FATAL_ASSERT(firstEdge != c_InvalidIndex);
 
-	for (uint32_t i = firstEdge; m_edges[i].polygon == polygon; ++i)
+	for (uint32_t i = firstEdge; i < (uint32_t)m_edges.size() && m_edges[i].polygon == polygon; ++i)
 	{
 		Edge& edge = m_edges[i];
 
@@ -119,7 +119,7 @@ void ModelAdjacency::update(uint32_t polygon)
 	T_FATAL_ASSERT(firstEdge != c_InvalidIndex);
 
 	// Remove references to this polygon's edges from sharing edges.
-	for (uint32_t i = firstEdge; m_edges[i].polygon == polygon; ++i)
+	for (uint32_t i = firstEdge; i < (uint32_t)m_edges.size() && m_edges[i].polygon == polygon; ++i)
 	{
 		Edge& edge = m_edges[i];
 		for (uint32_t j : edge.share)
@@ -166,7 +166,7 @@ uint32_t ModelAdjacency::getEdge(uint32_t polygon, uint32_t polygonEdge) const
 	const uint32_t firstEdge = m_polygonToFirstEdge[polygon];
 	T_FATAL_ASSERT(firstEdge != c_InvalidIndex);
 
-	for (uint32_t i = firstEdge; m_edges[i].polygon == polygon; ++i)
+	for (uint32_t i = firstEdge; i < (uint32_t)m_edges.size() && m_edges[i].polygon == polygon; ++i)
 	{
 		const Edge& edge = m_edges[i];
 		if (edge.polygon == polygon && edge.polygonEdge == polygonEdge)
@@ -260,7 +260,7 @@ ModelAdjacency::share_vector_t ModelAdjacency::getSharedEdges(uint32_t polygon,
 	const uint32_t firstEdge = m_polygonToFirstEdge[polygon];
 	T_FATAL_ASSERT(firstEdge != c_InvalidIndex);
 
-	for (uint32_t i = firstEdge; m_edges[i].polygon == polygon; ++i)
+	for (uint32_t i = firstEdge; i < (uint32_t)m_edges.size() && m_edges[i].polygon == polygon; ++i)
 	{
 		const Edge& edge = m_edges[i];
 		if (edge.polygon == polygon && edge.polygonEdge == polygonEdge)
@@ -280,7 +280,7 @@ uint32_t ModelAdjacency::getSharedEdgeCount(uint32_t polygon, uint32_t polygonEd
 	const uint32_t firstEdge = m_polygonToFirstEdge[polygon];
 	T_FATAL_ASSERT(firstEdge != c_InvalidIndex);
 
-	for (uint32_t i = firstEdge; m_edges[i].polygon == polygon; ++i)
+	for (uint32_t i = firstEdge; i < (uint32_t)m_edges.size() && m_edges[i].polygon == polygon; ++i)
 	{
 		const Edge& edge = m_edges[i];
 		if (edge.polygon == polygon && edge.polygonEdge == polygonEdge)
@@ -109,7 +109,7 @@ Ref< const Model > ModelCache::get(const Path& cachePath, const Path& fileName,
 
 		// Write cached copy of post-operation model.
 		const Path intermediateFileName = cachedFileName.getPathNameNoExtension() + L"~." + cachedFileName.getExtension();
-		JobManager::getInstance().add([=]() {
+		JobManager::getInstance().addDetached([=]() {
 			if (!FileSystem::getInstance().makeAllDirectories(cachedFileName.getPathOnly()))
 			{
 				log::error << L"Unable to create model cache directory." << Endl;
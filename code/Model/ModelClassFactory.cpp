@@ -420,6 +420,8 @@ void ModelClassFactory::createClasses(IRuntimeClassRegistrar* registrar) const
 
 	auto classReduce = new AutoRuntimeClass< Reduce >();
 	classReduce->addConstructor< float >();
+	classReduce->addConstructor< float, bool >();
+	classReduce->addMethod("getMaxError", &Reduce::getMaxError);
 	registrar->registerClass(classReduce);
 
 	auto classScaleAlongNormal = new AutoRuntimeClass< ScaleAlongNormal >();
@@ -6,289 +6,521 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
+#include <cmath>
 #include <limits>
-#include "Core/Containers/StaticSet.h"
+#include <queue>
+#include <unordered_map>
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Containers/StaticVector.h"
 #include "Core/Math/Const.h"
-#include "Core/Math/Plane.h"
 #include "Model/Model.h"
-#include "Model/ModelAdjacency.h"
-#include "Model/Operations/CleanDegenerate.h"
 #include "Model/Operations/CleanDuplicates.h"
 #include "Model/Operations/Reduce.h"
 #include "Model/Operations/Triangulate.h"
 
-// Loosely based on following paper
-// http://www.jofcis.com/publishedpapers/2013_9_11_4271_4279.pdf
+// Based on following paper
+// Garland, Heckbert; Surface Simplification Using Quadric Error Metrics, 1997
 
 namespace traktor::model
 {
 	namespace
 	{
 
-Scalar tetrahedronVolume(const Vector4& A, const Vector4& B, const Vector4& C, const Vector4& u)
-{
-	const Scalar area = cross(A - B, C - B).length() / 2.0_simd;
-	return abs((1.0_simd / 3.0_simd) * area * Plane(A, B, C).distance(u));
-}
+/*! Weight of planes constraining boundary and seam edges. */
+const double c_boundaryWeight = 1000.0;
+
+/*! Min cosine of angle between triangle normals before and after collapse. */
+const double c_maxFlipCosine = 0.1;
 
-bool isTriangleDegenerate(const Model& model, uint32_t triangleId)
+/*! Symmetric 4x4 error quadric. */
+struct Quadric
 {
-	const Polygon& polygon = model.getPolygon(triangleId);
-	if (polygon.getVertexCount() != 3)
-		return true;
+	double a[10] = { 0.0 };
 
-	auto& vertices = polygon.getVertices();
-	for (size_t j = 0; j < vertices.size(); ++j)
+	void addPlane(double nx, double ny, double nz, double d, double w)
 	{
-		const uint32_t p0 = model.getVertex(vertices[j]).getPosition();
-		const uint32_t p1 = model.getVertex(vertices[(j + 1) % vertices.size()]).getPosition();
-		if (p0 == p1)
-			return true;
+		a[0] += w * nx * nx; a[1] += w * nx * ny; a[2] += w * nx * nz; a[3] += w * nx * d;
+		a[4] += w * ny * ny; a[5] += w * ny * nz; a[6] += w * ny * d;
+		a[7] += w * nz * nz; a[8] += w * nz * d;
+		a[9] += w * d * d;
 	}
-		
-	return false;
-}
 
-Vector4 triangleNormal(const Model& model, uint32_t triangleId)
-{
-	const Polygon& polygon = model.getPolygon(triangleId);
-	if (polygon.getVertexCount() < 3)
-		return Vector4::zero();
+	void add(const Quadric& q)
+	{
+		for (int32_t i = 0; i < 10; ++i)
+			a[i] += q.a[i];
+	}
 
-	const auto& vertices = polygon.getVertices();
-	const Vertex* v[] =
+	double evaluate(const double* p) const
 	{
-		&model.getVertex(vertices[0]),
-		&model.getVertex(vertices[1]),
-		&model.getVertex(vertices[2])
-	};
+		const double x = p[0], y = p[1], z = p[2];
+		return
+			a[0] * x * x + 2.0 * a[1] * x * y + 2.0 * a[2] * x * z + 2.0 * a[3] * x +
+			a[4] * y * y + 2.0 * a[5] * y * z + 2.0 * a[6] * y +
+			a[7] * z * z + 2.0 * a[8] * z +
+			a[9];
+	}
+};
+
+struct Collapse
+{
+	double cost;
+	uint32_t from;
+	uint32_t to;
+	uint32_t stampFrom;
+	uint32_t stampTo;
 
-	Vector4 p[] =
+	bool operator < (const Collapse& rh) const
 	{
-		model.getPosition(v[0]->getPosition()),
-		model.getPosition(v[1]->getPosition()),
-		model.getPosition(v[2]->getPosition())
-	};
+		return cost > rh.cost;
+	}
+};
+
+struct Edge
+{
+	uint32_t count = 0;
+	uint32_t triangle = 0;
+	bool seam = false;
+};
 
-	Vector4 ep[] = { p[2] - p[0], p[1] - p[0] };
-	T_ASSERT(ep[0].length() > FUZZY_EPSILON);
-	T_ASSERT(ep[1].length() > FUZZY_EPSILON);
+inline uint64_t edgeKey(uint32_t p0, uint32_t p1)
+{
+	return p0 < p1 ? (uint64_t(p0) << 32) | p1 : (uint64_t(p1) << 32) | p0;
+}
 
-	return cross(ep[0], ep[1]).normalized();
+inline void sub(const double* a, const double* b, double* out)
+{
+	out[0] = a[0] - b[0]; out[1] = a[1] - b[1]; out[2] = a[2] - b[2];
 }
 
-Vector4 triangleMidPoint(const Model& model, uint32_t triangleId)
+inline void cross(const double* a, const double* b, double* out)
 {
-	const Polygon& polygon = model.getPolygon(triangleId);
-	if (polygon.getVertexCount() < 3)
-		return Vector4::zero();
+	out[0] = a[1] * b[2] - a[2] * b[1];
+	out[1] = a[2] * b[0] - a[0] * b[2];
+	out[2] = a[0] * b[1] - a[1] * b[0];
+}
 
-	Vector4 midPoint = Vector4::zero();
-	for (uint32_t j = 0; j < 3; ++j)
-		midPoint += model.getVertexPosition(polygon.getVertex(j));
+inline double dot(const double* a, const double* b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
 
-	return (midPoint / Scalar(3.0f)).xyz1();
+inline double normalize(double* v)
+{
+	const double ln = std::sqrt(dot(v, v));
+	if (ln > 0.0)
+	{
+		v[0] /= ln; v[1] /= ln; v[2] /= ln;
+	}
+	return ln;
 }
 
-Vector2 triangleMidTexCoord(const Model& model, uint32_t triangleId)
+class Reducer
 {
-	const Polygon& polygon = model.getPolygon(triangleId);
-	if (polygon.getVertexCount() < 3)
-		return Vector2::zero();
+public:
+	explicit Reducer(Model& model)
+	:	m_model(model)
+	{
+	}
 
-	Vector2 midPoint = Vector2::zero();
-	for (uint32_t j = 0; j < 3; ++j)
-		midPoint += model.getTexCoord(model.getVertex(polygon.getVertex(j)).getTexCoord(0));
+	void prepare();
 
-	return midPoint / 3.0f;
-}
+	double reduce(uint32_t targetTriangleCount);
+
+	void commit(Model& model) const;
+
+private:
+	Model& m_model;
+	AlignedVector< double > m_positions;			//!< Position coordinates, 3 per position.
+	AlignedVector< Quadric > m_quadrics;			//!< Error quadric per position.
+	AlignedVector< uint32_t > m_stamps;				//!< Incremented each time position is modified, used to invalidate queued collapses.
+	AlignedVector< bool > m_locked;					//!< Position is on an attribute seam or material border.
+	AlignedVector< bool > m_removed;				//!< Position has been collapsed.
+	AlignedVector< AlignedVector< uint32_t > > m_positionTriangles;
+	AlignedVector< uint32_t > m_triangleVertices;	//!< Vertex ids, 3 per triangle.
+	AlignedVector< uint32_t > m_trianglePositions;	//!< Position ids, 3 per triangle.
+	AlignedVector< bool > m_triangleAlive;
+	uint32_t m_aliveCount = 0;
+	std::priority_queue< Collapse > m_queue;
+
+	const double* position(uint32_t p) const { return &m_positions[p * 3]; }
+
+	bool triangleHas(uint32_t t, uint32_t p) const
+	{
+		const uint32_t* tp = &m_trianglePositions[t * 3];
+		return tp[0] == p || tp[1] == p || tp[2] == p;
+	}
+
+	void pushEdge(uint32_t p0, uint32_t p1);
+
+	bool canCollapse(uint32_t from, uint32_t to, uint32_t& outToVertex) const;
 
-Vector4 triangleTipPoint(const Model& model, const ModelAdjacency& adjacency, uint32_t triangleId)
+	void collapse(uint32_t from, uint32_t to, uint32_t toVertex);
+};
+
+void Reducer::prepare()
 {
-	const Polygon& polygon = model.getPolygon(triangleId);
-	if (polygon.getVertexCount() < 3)
-		return Vector4::zero();
+	const uint32_t positionCount = m_model.getPositionCount();
+	const auto& polygons = m_model.getPolygons();
+
+	m_positions.resize(positionCount * 3);
+	for (uint32_t i = 0; i < positionCount; ++i)
+	{
+		const Vector4& p = m_model.getPosition(i);
+		m_positions[i * 3 + 0] = p.x();
+		m_positions[i * 3 + 1] = p.y();
+		m_positions[i * 3 + 2] = p.z();
+	}
+
+	m_quadrics.resize(positionCount);
+	m_stamps.resize(positionCount, 0);
+	m_locked.resize(positionCount, false);
+	m_removed.resize(positionCount, false);
+	m_positionTriangles.resize(positionCount);
 
-	const Vector4 normal = triangleNormal(model, triangleId);
-	const Vector4 midPoint = triangleMidPoint(model, triangleId);
+	// Gather triangles, degenerated triangles are discarded.
+	const uint32_t triangleCount = (uint32_t)polygons.size();
+	m_triangleVertices.resize(triangleCount * 3);
+	m_trianglePositions.resize(triangleCount * 3);
+	m_triangleAlive.resize(triangleCount, false);
 
-	ModelAdjacency::share_vector_t sharedEdges;
-	Vector4 tipPoint = Vector4::zero();
-	int32_t count = 0;
+	AlignedVector< uint32_t > positionVertex;
+	AlignedVector< uint32_t > positionMaterial;
+	positionVertex.resize(positionCount, c_InvalidIndex);
+	positionMaterial.resize(positionCount, c_InvalidIndex);
 
-	for (uint32_t j = 0; j < 3; ++j)
+	for (uint32_t t = 0; t < triangleCount; ++t)
 	{
-		sharedEdges = adjacency.getSharedEdges(triangleId, j);
-		if (sharedEdges.size() > 0)
+		const Polygon& polygon = polygons[t];
+		T_FATAL_ASSERT(polygon.getVertexCount() == 3);
+
+		for (uint32_t j = 0; j < 3; ++j)
 		{
-			const uint32_t sharedTriangleId = adjacency.getPolygon(sharedEdges[0]);
+			const uint32_t v = polygon.getVertex(j);
+			m_triangleVertices[t * 3 + j] = v;
+			m_trianglePositions[t * 3 + j] = m_model.getVertex(v).getPosition();
+		}
 
-			const Vector4 sharedMidPoint = triangleMidPoint(model, sharedTriangleId);
-			const Vector4 diff = midPoint - sharedMidPoint;
+		const uint32_t* tp = &m_trianglePositions[t * 3];
+		if (tp[0] == tp[1] || tp[1] == tp[2] || tp[0] == tp[2])
+			continue;
 
-			const Vector4 position0 = model.getVertexPosition(polygon.getVertex(j));
-			const Vector4 position1 = model.getVertexPosition(polygon.getVertex((j + 1) % 3));
+		m_triangleAlive[t] = true;
+		m_aliveCount++;
 
-			const Vector4 edge = position1 - position0;
+		for (uint32_t j = 0; j < 3; ++j)
+		{
+			const uint32_t p = tp[j];
+			const uint32_t v = m_triangleVertices[t * 3 + j];
+			m_positionTriangles[p].push_back(t);
+
+			// Positions referenced by different vertices are on an attribute seam.
+			if (positionVertex[p] == c_InvalidIndex)
+				positionVertex[p] = v;
+			else if (positionVertex[p] != v)
+				m_locked[p] = true;
+
+			if (positionMaterial[p] == c_InvalidIndex)
+				positionMaterial[p] = polygon.getMaterial();
+			else if (positionMaterial[p] != polygon.getMaterial())
+				m_locked[p] = true;
+		}
+	}
 
-			Vector4 pivot;
-			Scalar k;
+	// Accumulate triangle planes into quadrics and find boundary and seam edges.
+	std::unordered_map< uint64_t, Edge > edges;
+	edges.reserve(m_aliveCount * 2);
 
-			if (!Plane(cross(normal, diff).normalized(), midPoint).intersectRay(position0, edge.normalized(), k, pivot))
-				continue;
+	for (uint32_t t = 0; t < triangleCount; ++t)
+	{
+		if (!m_triangleAlive[t])
+			continue;
 
-			const Vector4 V = (pivot - sharedMidPoint).normalized();
+		const uint32_t* tp = &m_trianglePositions[t * 3];
+		const uint32_t* tv = &m_triangleVertices[t * 3];
 
-			const Scalar kd = dot3((midPoint - pivot).normalized(), V);
-			if (kd <= FUZZY_EPSILON)
-				continue;
+		double e1[3], e2[3], n[3];
+		sub(position(tp[1]), position(tp[0]), e1);
+		sub(position(tp[2]), position(tp[0]), e2);
+		cross(e1, e2, n);
+		normalize(n);
 
-			tipPoint += pivot + V * (midPoint - pivot).length() / kd;
-			count++;
+		const double d = -dot(n, position(tp[0]));
+		for (uint32_t j = 0; j < 3; ++j)
+			m_quadrics[tp[j]].addPlane(n[0], n[1], n[2], d, 1.0);
+
+		for (uint32_t j = 0; j < 3; ++j)
+		{
+			Edge& edge = edges[edgeKey(tp[j], tp[(j + 1) % 3])];
+			if (edge.count++ == 0)
+				edge.triangle = t;
+			else
+			{
+				// Edge is a seam if triangles reference different vertices at either end.
+				const uint32_t* ov = &m_triangleVertices[edge.triangle * 3];
+				const uint32_t* op = &m_trianglePositions[edge.triangle * 3];
+				for (uint32_t k = 0; k < 3; ++k)
+				{
+					if ((op[k] == tp[j] && ov[k] != tv[j]) || (op[k] == tp[(j + 1) % 3] && ov[k] != tv[(j + 1) % 3]))
+						edge.seam = true;
+				}
+				if (m_model.getPolygon(edge.triangle).getMaterial() != m_model.getPolygon(t).getMaterial())
+					edge.seam = true;
+			}
 		}
 	}
 
-	if (count > 0)
-		tipPoint = (tipPoint / Scalar((float)count)).xyz1();
-	else
-		tipPoint = midPoint;
+	// Constrain boundary and seam edges by planes perpendicular to the triangle.
+	for (const auto& it : edges)
+	{
+		const Edge& edge = it.second;
+		if (edge.count == 2 && !edge.seam)
+			continue;
+
+		const uint32_t p0 = uint32_t(it.first >> 32);
+		const uint32_t p1 = uint32_t(it.first & 0xffffffff);
+		const uint32_t* tp = &m_trianglePositions[edge.triangle * 3];
+
+		double e1[3], e2[3], n[3], ed[3], bn[3];
+		sub(position(tp[1]), position(tp[0]), e1);
+		sub(position(tp[2]), position(tp[0]), e2);
+		cross(e1, e2, n);
+		sub(position(p1), position(p0), ed);
+		cross(ed, n, bn);
+		if (normalize(bn) <= 0.0)
+			continue;
+
+		const double d = -dot(bn, position(p0));
+		m_quadrics[p0].addPlane(bn[0], bn[1], bn[2], d, c_boundaryWeight);
+		m_quadrics[p1].addPlane(bn[0], bn[1], bn[2], d, c_boundaryWeight);
+	}
 
-	return tipPoint;
+	// Queue initial collapses.
+	for (const auto& it : edges)
+		pushEdge(uint32_t(it.first >> 32), uint32_t(it.first & 0xffffffff));
 }
 
-void triangleEdgeNeighbors(const Model& model, const ModelAdjacency& adjacency, uint32_t triangleId, AlignedVector< uint32_t >& outNeighborTriangleIds)
+double Reducer::reduce(uint32_t targetTriangleCount)
 {
-	const Polygon& polygon = model.getPolygon(triangleId);
-	if (polygon.getVertexCount() < 3)
-		return;
+	double maxError = 0.0;
+	while (m_aliveCount > targetTriangleCount && !m_queue.empty())
+	{
+		const Collapse c = m_queue.top();
+		m_queue.pop();
+
+		// Skip collapses which has been invalidated by earlier collapses.
+		if (m_removed[c.from] || m_removed[c.to])
+			continue;
+		if (m_stamps[c.from] != c.stampFrom || m_stamps[c.to] != c.stampTo)
+			continue;
+
+		uint32_t toVertex;
+		if (!canCollapse(c.from, c.to, toVertex))
+			continue;
+
+		collapse(c.from, c.to, toVertex);
+		maxError = std::max(maxError, c.cost);
+	}
+	return std::sqrt(maxError);
+}
 
-	// Get edge neighbors.
-	ModelAdjacency::share_vector_t sharedEdges;
-	for (uint32_t j = 0; j < 3; ++j)
+void Reducer::commit(Model& model) const
+{
+	AlignedVector< Polygon > polygons;
+	polygons.reserve(m_aliveCount);
+	for (uint32_t t = 0; t < (uint32_t)m_triangleAlive.size(); ++t)
 	{
-		sharedEdges = adjacency.getSharedEdges(triangleId, j);
-		if (sharedEdges.size() > 0)
-		{
-			const uint32_t sharedTriangleId = adjacency.getPolygon(sharedEdges[0]);
-			outNeighborTriangleIds.push_back(sharedTriangleId);
-		}
+		if (!m_triangleAlive[t])
+			continue;
+
+		Polygon& polygon = polygons.push_back();
+		polygon = model.getPolygon(t);
+		for (uint32_t j = 0; j < 3; ++j)
+			polygon.setVertex(j, m_triangleVertices[t * 3 + j]);
 	}
+	model.setPolygons(polygons);
 }
 
-void triangleSingleVertexNeighbors(const Model& model, uint32_t triangleId, AlignedVector< std::pair< uint32_t, uint32_t > >& outNeighborTriangleIds)
+void Reducer::pushEdge(uint32_t p0, uint32_t p1)
 {
-	const Polygon& polygon = model.getPolygon(triangleId);
-	if (polygon.getVertexCount() < 3)
+	Quadric q = m_quadrics[p0];
+	q.add(m_quadrics[p1]);
+
+	// Half-edge collapse; move unlocked position onto the other.
+	const double cost01 = m_locked[p0] ? std::numeric_limits< double >::max() : q.evaluate(position(p1));
+	const double cost10 = m_locked[p1] ? std::numeric_limits< double >::max() : q.evaluate(position(p0));
+	if (m_locked[p0] && m_locked[p1])
 		return;
 
-	// Get single vertex neighbors.
-	uint32_t positionIds[3];
-	for (uint32_t i = 0; i < 3; ++i)
-		positionIds[i] = model.getVertex(polygon.getVertex(i)).getPosition();
+	Collapse c;
+	if (cost01 <= cost10)
+	{
+		c.cost = std::max(cost01, 0.0);
+		c.from = p0;
+		c.to = p1;
+	}
+	else
+	{
+		c.cost = std::max(cost10, 0.0);
+		c.from = p1;
+		c.to = p0;
+	}
+	c.stampFrom = m_stamps[c.from];
+	c.stampTo = m_stamps[c.to];
+	m_queue.push(c);
+}
+
+bool Reducer::canCollapse(uint32_t from, uint32_t to, uint32_t& outToVertex) const
+{
+	outToVertex = c_InvalidIndex;
 
-	for (uint32_t i = 0; i < model.getPolygonCount(); ++i)
+	// Triangles sharing the edge must agree on which vertex to collapse onto.
+	uint32_t edgeTriangleCount = 0;
+	for (uint32_t t : m_positionTriangles[from])
 	{
-		if (i == triangleId)
+		if (!m_triangleAlive[t] || !triangleHas(t, to))
 			continue;
 
-		const auto& vertices = model.getPolygon(i).getVertices();
-		if (vertices.size() != 3)
-			continue;
+		for (uint32_t j = 0; j < 3; ++j)
+		{
+			if (m_trianglePositions[t * 3 + j] != to)
+				continue;
 
-		uint32_t numSharingVertices = 0;
-		uint32_t sharingVertexId = 0;
+			const uint32_t v = m_triangleVertices[t * 3 + j];
+			if (outToVertex == c_InvalidIndex)
+				outToVertex = v;
+			else if (outToVertex != v)
+				return false;
+		}
+		edgeTriangleCount++;
+	}
+	if (edgeTriangleCount == 0 || edgeTriangleCount > 2)
+		return false;
 
+	// Link condition; positions adjacent to both ends must only be those opposite of the edge.
+	StaticVector< uint32_t, 64 > fromNeighbors;
+	for (uint32_t t : m_positionTriangles[from])
+	{
+		if (!m_triangleAlive[t])
+			continue;
 		for (uint32_t j = 0; j < 3; ++j)
 		{
-			const uint32_t sharedPositionId = model.getVertex(vertices[j]).getPosition();
-			if (
-				sharedPositionId == positionIds[0] ||
-				sharedPositionId == positionIds[1] ||
-				sharedPositionId == positionIds[2]
-			)
+			const uint32_t n = m_trianglePositions[t * 3 + j];
+			if (n == from || n == to || std::find(fromNeighbors.begin(), fromNeighbors.end(), n) != fromNeighbors.end())
+				continue;
+			if (fromNeighbors.full())
+				return false;
+			fromNeighbors.push_back(n);
+		}
+	}
+
+	uint32_t sharedCount = 0;
+	for (uint32_t n : fromNeighbors)
+	{
+		for (uint32_t t : m_positionTriangles[to])
+		{
+			if (m_triangleAlive[t] && triangleHas(t, n))
 			{
-				numSharingVertices++;
-				sharingVertexId = vertices[j];
+				sharedCount++;
+				break;
 			}
 		}
+	}
+	if (sharedCount > edgeTriangleCount)
+		return false;
+
+	// Ensure no triangle is flipped or degenerated.
+	for (uint32_t t : m_positionTriangles[from])
+	{
+		if (!m_triangleAlive[t] || triangleHas(t, to))
+			continue;
+
+		const uint32_t* tp = &m_trianglePositions[t * 3];
+		const double* p[3];
+		const double* q[3];
+		for (uint32_t j = 0; j < 3; ++j)
+		{
+			p[j] = position(tp[j]);
+			q[j] = (tp[j] == from) ? position(to) : p[j];
+		}
 
-		if (numSharingVertices == 1)
-			outNeighborTriangleIds.push_back(std::make_pair(i, sharingVertexId));
+		double e1[3], e2[3], n0[3], n1[3];
+		sub(p[1], p[0], e1);
+		sub(p[2], p[0], e2);
+		cross(e1, e2, n0);
+		sub(q[1], q[0], e1);
+		sub(q[2], q[0], e2);
+		cross(e1, e2, n1);
+
+		if (normalize(n0) <= 0.0 || normalize(n1) <= 0.0)
+			return false;
+		if (dot(n0, n1) < c_maxFlipCosine)
+			return false;
 	}
+
+	return true;
 }
 
-float triangleVolumeError(const Model& model, const ModelAdjacency& adjacency, uint32_t triangleId)
+void Reducer::collapse(uint32_t from, uint32_t to, uint32_t toVertex)
 {
-	const Polygon& polygon = model.getPolygon(triangleId);
-	if (polygon.getVertexCount() < 3)
-		return 0.0f;
-
-	const Vector4 tipPoint = triangleTipPoint(model, adjacency, triangleId);
-
-	uint32_t positionIds[3];
-	for (uint32_t i = 0; i < 3; ++i)
-		positionIds[i] = model.getVertex(polygon.getVertex(i)).getPosition();
-
-	// Calculate volume error of triangle.
-	float error = tetrahedronVolume(
-		model.getPosition(positionIds[0]),
-		model.getPosition(positionIds[1]),
-		model.getPosition(positionIds[2]),
-		tipPoint
-	);
-
-	// Accumulate volume errors of edge sharing triangles.
-	ModelAdjacency::share_vector_t sharedEdges;
-	for (uint32_t j = 0; j < 3; ++j)
+	auto& toTriangles = m_positionTriangles[to];
+	for (uint32_t t : m_positionTriangles[from])
 	{
-		sharedEdges = adjacency.getSharedEdges(triangleId, j);
-		if (sharedEdges.size() > 0)
+		if (!m_triangleAlive[t])
+			continue;
+
+		if (triangleHas(t, to))
 		{
-			const uint32_t sharedTriangleId = adjacency.getPolygon(sharedEdges[0]);
-			const Polygon& sharedTriangle = model.getPolygon(sharedTriangleId);
-			error += tetrahedronVolume(
-				model.getVertexPosition(sharedTriangle.getVertex(0)),
-				model.getVertexPosition(sharedTriangle.getVertex(1)),
-				model.getVertexPosition(sharedTriangle.getVertex(2)),
-				tipPoint
-			);
+			m_triangleAlive[t] = false;
+			m_aliveCount--;
+			continue;
 		}
-		else
+
+		for (uint32_t j = 0; j < 3; ++j)
 		{
-			// Triangles with no neighbors shouldn't be discarded;
-			// thus return max error.
-			return std::numeric_limits< float >::max();
+			if (m_trianglePositions[t * 3 + j] == from)
+			{
+				m_trianglePositions[t * 3 + j] = to;
+				m_triangleVertices[t * 3 + j] = toVertex;
+			}
 		}
+		toTriangles.push_back(t);
 	}
 
-	// Accumulate volume errors of single vertex sharing triangles.
-	AlignedVector< std::pair< uint32_t, uint32_t > > neighborTriangleIds;
-	triangleSingleVertexNeighbors(model, triangleId, neighborTriangleIds);
+	// Discard dead triangles from "to" triangle list.
+	toTriangles.erase(std::remove_if(toTriangles.begin(), toTriangles.end(), [&](uint32_t t) {
+		return !m_triangleAlive[t];
+	}), toTriangles.end());
+
+	m_positionTriangles[from].clear();
+	m_removed[from] = true;
 
-	// Triangle with less than 3 single vertex sharing triangles shouldn't be discarded; thus return max error.
-	if (neighborTriangleIds.size() < 3)
-		return std::numeric_limits< float >::max();
+	m_quadrics[to].add(m_quadrics[from]);
+	m_stamps[to]++;
 
-	for (const auto& neighborTriangleId : neighborTriangleIds)
+	// Queue new collapses of all edges connected to "to".
+	for (uint32_t t : toTriangles)
 	{
-		const Polygon& sharedTriangle = model.getPolygon(neighborTriangleId.first);
-		error += tetrahedronVolume(
-			model.getVertexPosition(sharedTriangle.getVertex(0)),
-			model.getVertexPosition(sharedTriangle.getVertex(1)),
-			model.getVertexPosition(sharedTriangle.getVertex(2)),
-			tipPoint
-		);
+		for (uint32_t j = 0; j < 3; ++j)
+		{
+			const uint32_t n = m_trianglePositions[t * 3 + j];
+			if (n != to)
+			{
+				m_stamps[n]++;
+				pushEdge(n, to);
+			}
+		}
 	}
-
-	return error;
 }
 
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.model.Reduce", Reduce, IModelOperation)
 
-Reduce::Reduce(float target)
+Reduce::Reduce(float target, bool compact)
 :	m_target(target)
+,	m_compact(compact)
 {
 }
 
@@ -297,124 +529,17 @@ bool Reduce::apply(Model& model) const
 	// Model must be triangulated.
 	model.apply(Triangulate());
 
-	// Prepare initial adjacency.
-	Ref< ModelAdjacency > adjacency = new ModelAdjacency(&model, ModelAdjacency::Mode::ByPosition);
-
-	// Calculate initial set of errors.
-	AlignedVector< float > errors;
-	for (uint32_t i = 0; i < model.getPolygonCount(); ++i)
-	{
-		const float error = triangleVolumeError(model, *adjacency, i);
-		errors.push_back(error);
-	}
-
-	StaticVector< uint32_t, 4 > errorTrianglePositionIds;
-	StaticVector< uint32_t, 64 > modifiedPolygons;
-	StaticSet< uint32_t, 64 > modifiedPositions;
-
-	// Iterate and discard triangles until target is meet.
-	const uint32_t targetPolygonCount = (int32_t)(model.getPolygonCount() * m_target + 0.5f);
-	while (model.getPolygonCount() > targetPolygonCount)
-	{
-		// Find triangle with smallest error to collapse.
-		// One minus max so error function can force some triangles to not even
-		// being taken into account.
-		uint32_t minErrorTriangleId = c_InvalidIndex;
-		float minError = std::numeric_limits< float >::max() - 1.0f;
-		for (uint32_t i = 0; i < model.getPolygonCount(); ++i)
-		{
-			const float error = errors[i];
-			if (error < minError)
-			{
-				minErrorTriangleId = i;
-				minError = error;
-			}
-		}
-		if (minErrorTriangleId == c_InvalidIndex)
-			break;
-
-		errorTrianglePositionIds.resize(0);
-		modifiedPositions.reset();
-
-		// Get all position ids from collapsing triangle.
-		for (uint32_t vertex : model.getPolygon(minErrorTriangleId).getVertices())
-			errorTrianglePositionIds.push_back(model.getVertex(vertex).getPosition());
-
-		// Calculate new join position.
-		const Vector4 tipPoint = triangleTipPoint(model, *adjacency, minErrorTriangleId);
-		const Vector4 midPoint = triangleMidPoint(model, minErrorTriangleId);
-		const Vector2 midTexCoord = triangleMidTexCoord(model, minErrorTriangleId);
-		const Vector4 joinPoint = lerp(tipPoint, midPoint, 0.6_simd).xyz1();
-		const Vector2 joinTexCoord = midTexCoord;
-		const uint32_t joinPointId = model.addUniquePosition(joinPoint);
-		const uint32_t joinTexCoordId = model.addUniqueTexCoord(joinTexCoord);
-
-		// Replace all vertices which reference any of the collapsing triangle's positions.
-		auto& polygons = model.getPolygons();
-		for (uint32_t i = 0; i < (uint32_t)polygons.size(); )
-		{
-			Polygon& polygon = polygons[i];
-			bool polygonModified = false;
-
-			for (uint32_t j = 0; j < polygon.getVertexCount(); ++j)
-			{
-				Vertex vrtx = model.getVertex(polygon.getVertex(j));
-				const auto it = std::find(errorTrianglePositionIds.begin(), errorTrianglePositionIds.end(), vrtx.getPosition());
-				if (it != errorTrianglePositionIds.end())
-				{
-					vrtx.setPosition(joinPointId);
-					vrtx.setTexCoord(0, joinTexCoordId);
-					const uint32_t replaceVrtxId = model.addUniqueVertex(vrtx);
-					polygon.setVertex(j, replaceVrtxId);
-					polygonModified = true;
-				}
-			}
-
-			if (polygonModified && isTriangleDegenerate(model, i))
-			{
-				polygons.erase(polygons.begin() + i);
-				errors.erase(errors.begin() + i);
-				adjacency->remove(i, true);
-			}
-			else
-			{
-				if (polygonModified)
-				{
-					for (uint32_t vertexId : polygon.getVertices())
-					{
-						const Vertex& vrtx = model.getVertex(vertexId);
-						modifiedPositions.insert(vrtx.getPosition());
-					}
-				}
-				++i;
-			}
-		}
-
-		// Get array of all modified polygons, directly or indirectly.
-		modifiedPolygons.resize(0);
-		for (uint32_t i = 0; i < model.getPolygonCount(); ++i)
-		{
-			const Polygon& polygon = model.getPolygon(i);
-			const Polygon::vertices_t& vertices = polygon.getVertices();
-			const auto it = std::find_if(vertices.begin(), vertices.end(), [&](uint32_t vertexId) {
-				const uint32_t positionId = model.getVertex(vertexId).getPosition();
-				return modifiedPositions.find(positionId) != modifiedPositions.end();
-			});
-			if (it != vertices.end())
-				modifiedPolygons.push_back(i);
-		}
+	const uint32_t targetTriangleCount = (uint32_t)(model.getPolygonCount() * m_target + 0.5f);
 
-		// Update adjacency.
-		for (uint32_t modifiedPolygon : modifiedPolygons)
-			adjacency->update(modifiedPolygon);
-
-		// Update errors on polygons which has been modified.
-		for (uint32_t modifiedPolygon : modifiedPolygons)
-			errors[modifiedPolygon] = triangleVolumeError(model, *adjacency, modifiedPolygon);
-	}
+	Reducer reducer(model);
+	reducer.prepare();
+	m_maxError = (float)reducer.reduce(targetTriangleCount);
+	reducer.commit(model);
 
 	// Remove unused vertices etc which will be a left over from reducing.
-	model.apply(CleanDuplicates(FUZZY_EPSILON));
+	if (m_compact)
+		model.apply(CleanDuplicates(FUZZY_EPSILON));
+
 	return true;
 }
 
@@ -23,21 +23,39 @@ namespace traktor
 	namespace model
 	{
 
-/*!
+/*! Reduce number of triangles using quadric error edge collapses.
  * \ingroup Model
+ *
+ * Edges are collapsed in order of least quadric error using
+ * a priority queue. Collapses are half-edge collapses, i.e. one
+ * vertex is moved onto the other, thus no new vertices are
+ * created and vertex attributes are preserved. Vertices on
+ * attribute seams or material borders are never moved and
+ * open boundaries are constrained to their boundary planes.
  */
 class T_DLLCLASS Reduce : public IModelOperation
 {
 	T_RTTI_CLASS;
 
 public:
-	explicit Reduce(float target);
+	/*! Construct reduce operation.
+	 *
+	 * \param target Fraction of triangles to keep.
+	 * \param compact Remove unused vertices when done; if false vertex
+	 *                 indices of reduced model match source model.
+	 */
+	explicit Reduce(float target, bool compact = true);
+
+	/*! Get max geometric error of last reduction, in model units. */
+	float getMaxError() const { return m_maxError; }
 
 protected:
 	virtual bool apply(Model& model) const override final;
 
 private:
 	float m_target;
+	bool m_compact;
+	mutable float m_maxError = 0.0f;
 };
 
 	}
@@ -0,0 +1,142 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cmath>
+#include "Core/Log/Log.h"
+#include "Core/Math/Aabb3.h"
+#include "Core/Timer/Timer.h"
+#include "Model/Model.h"
+#include "Model/Operations/Reduce.h"
+#include "Model/Test/CaseModelReduce.h"
+
+namespace traktor::model::test
+{
+	namespace
+	{
+
+const int32_t c_gridSize = 256;
+
+/*! Create a wavy grid with a texture coordinate seam along the middle column. */
+Ref< Model > createGrid()
+{
+	Ref< Model > model = new Model();
+	model->addMaterial(Material(L"Default"));
+
+	const uint32_t channel = model->addUniqueTexCoordChannel(L"UV0");
+
+	for (int32_t iy = 0; iy <= c_gridSize; ++iy)
+	{
+		for (int32_t ix = 0; ix <= c_gridSize; ++ix)
+		{
+			const float fx = float(ix) / c_gridSize;
+			const float fy = float(iy) / c_gridSize;
+			model->addPosition(Vector4(fx * 10.0f, std::sin(fx * 6.0f) * std::cos(fy * 4.0f), fy * 10.0f, 1.0f));
+		}
+	}
+
+	// Two vertices per position, the right half use the second vertex to create a seam in the middle.
+	for (int32_t iy = 0; iy <= c_gridSize; ++iy)
+	{
+		for (int32_t ix = 0; ix <= c_gridSize; ++ix)
+		{
+			const uint32_t position = iy * (c_gridSize + 1) + ix;
+			const float fx = float(ix) / c_gridSize;
+			const float fy = float(iy) / c_gridSize;
+			for (int32_t side = 0; side < 2; ++side)
+			{
+				Vertex vertex;
+				vertex.setPosition(position);
+				vertex.setTexCoord(channel, model->addTexCoord(Vector2(fx + side, fy)));
+				model->addVertex(vertex);
+			}
+		}
+	}
+
+	for (int32_t iy = 0; iy < c_gridSize; ++iy)
+	{
+		for (int32_t ix = 0; ix < c_gridSize; ++ix)
+		{
+			const uint32_t side = (ix >= c_gridSize / 2) ? 1 : 0;
+			const uint32_t v00 = (iy * (c_gridSize + 1) + ix) * 2 + side;
+			const uint32_t v10 = v00 + 2;
+			const uint32_t v01 = v00 + (c_gridSize + 1) * 2;
+			const uint32_t v11 = v01 + 2;
+			model->addPolygon(Polygon(0, v00, v01, v11));
+			model->addPolygon(Polygon(0, v00, v11, v10));
+		}
+	}
+
+	return model;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.model.test.CaseModelReduce", 0, CaseModelReduce, traktor::test::Case)
+
+void CaseModelReduce::run()
+{
+	Ref< Model > model = createGrid();
+
+	const uint32_t sourcePolygonCount = model->getPolygonCount();
+	const uint32_t sourceVertexCount = model->getVertexCount();
+	CASE_ASSERT(sourcePolygonCount == c_gridSize * c_gridSize * 2);
+
+	Timer timer;
+
+	const Reduce reduce(0.1f, false);
+	CASE_ASSERT(model->apply(reduce));
+
+	const double duration = timer.getElapsedTime();
+
+	// Target must be reached.
+	CASE_ASSERT(model->getPolygonCount() > 0);
+	CASE_ASSERT(model->getPolygonCount() <= uint32_t(sourcePolygonCount * 0.1f + 0.5f));
+
+	// No vertices may be added when not compacting; reduced model must be able to share vertices.
+	CASE_ASSERT(model->getVertexCount() == sourceVertexCount);
+
+	Aabb3 bounds;
+	bool triangles = true;
+	for (const auto& polygon : model->getPolygons())
+	{
+		triangles &= (polygon.getVertexCount() == 3);
+		for (const auto vertex : polygon.getVertices())
+			bounds.contain(model->getVertexPosition(vertex));
+	}
+	CASE_ASSERT(triangles);
+
+	// All positions along the seam must be kept.
+	uint32_t seamPositionCount = 0;
+	for (int32_t iy = 0; iy <= c_gridSize; ++iy)
+	{
+		const uint32_t left = (iy * (c_gridSize + 1) + c_gridSize / 2) * 2;
+		for (const auto& polygon : model->getPolygons())
+		{
+			const auto& vertices = polygon.getVertices();
+			if (std::find(vertices.begin(), vertices.end(), left) != vertices.end())
+			{
+				seamPositionCount++;
+				break;
+			}
+		}
+	}
+	CASE_ASSERT(seamPositionCount == c_gridSize + 1);
+
+	// Boundary of grid must be kept.
+	CASE_ASSERT(std::abs(bounds.mn.x()) <= FUZZY_EPSILON);
+	CASE_ASSERT(std::abs(bounds.mn.z()) <= FUZZY_EPSILON);
+	CASE_ASSERT(std::abs(bounds.mx.x() - 10.0f) <= FUZZY_EPSILON);
+	CASE_ASSERT(std::abs(bounds.mx.z() - 10.0f) <= FUZZY_EPSILON);
+
+	CASE_ASSERT(reduce.getMaxError() > 0.0f);
+	CASE_ASSERT(reduce.getMaxError() < 0.1f);
+
+	log::info << L"Reduce, " << sourcePolygonCount << L" polygon(s) into " << model->getPolygonCount() << L" polygon(s) in " << int32_t(duration * 1000.0) << L" ms, max error " << reduce.getMaxError() << Endl;
+}
+
+}
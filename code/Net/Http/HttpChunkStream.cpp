@@ -15,30 +15,38 @@ namespace traktor::net
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.net.HttpChunkStream", HttpChunkStream, IStream)
 
-HttpChunkStream::HttpChunkStream(IStream* stream)
+HttpChunkStream::HttpChunkStream(IStream* stream, bool writeChunks)
 :	m_stream(stream)
 ,	m_available(-1)
+,	m_writeChunks(writeChunks)
 {
-	T_ASSERT(m_stream->canRead());
+	T_ASSERT(m_writeChunks ? m_stream->canWrite() : m_stream->canRead());
 }
 
 void HttpChunkStream::close()
 {
 	if (m_stream)
 	{
-		m_stream->close();
+		if (m_writeChunks)
+		{
+			// Last chunk; keep underlying stream open.
+			m_stream->write("0\r\n\r\n", 5);
+			m_stream->flush();
+		}
+		else
+			m_stream->close();
 		m_stream = nullptr;
 	}
 }
 
 bool HttpChunkStream::canRead() const
 {
-	return true;
+	return !m_writeChunks;
 }
 
 bool HttpChunkStream::canWrite() const
 {
-	return false;
+	return m_writeChunks;
 }
 
 bool HttpChunkStream::canSeek() const
@@ -66,6 +74,9 @@ int64_t HttpChunkStream::seek(SeekOriginType origin, int64_t offset)
 
 int64_t HttpChunkStream::read(void* block, int64_t nbytes)
 {
+	if (m_writeChunks)
+		return -1;
+
 	if (m_available == -1)
 	{
 		char buf[16];
@@ -115,11 +126,30 @@ int64_t HttpChunkStream::read(void* block, int64_t nbytes)
 
 int64_t HttpChunkStream::write(const void* block, int64_t nbytes)
 {
-	return 0;
+	if (!m_writeChunks || !m_stream)
+		return -1;
+
+	// Empty chunk would terminate body.
+	if (nbytes <= 0)
+		return 0;
+
+	char header[32];
+	const int32_t headerLength = std::snprintf(header, sizeof(header), "%llx\r\n", (unsigned long long)nbytes);
+
+	if (m_stream->write(header, headerLength) != headerLength)
+		return -1;
+	if (m_stream->write(block, nbytes) != nbytes)
+		return -1;
+	if (m_stream->write("\r\n", 2) != 2)
+		return -1;
+
+	return nbytes;
 }
 
 void HttpChunkStream::flush()
 {
+	if (m_writeChunks && m_stream)
+		m_stream->flush();
 }
 
 }
@@ -24,15 +24,19 @@ namespace traktor::net
 
 /*! HTTP chunk based stream.
  *
- * \note This stream is read-only and should not
- * be written to.
+ * Either decode a chunked body when reading or
+ * encode written data as chunks.
+ *
+ * \note When writing, close() terminates the body
+ * with the last chunk but leaves underlying stream
+ * open so a keep-alive connection can be reused.
  */
 class T_DLLCLASS HttpChunkStream : public IStream
 {
 	T_RTTI_CLASS;
 
 public:
-	explicit HttpChunkStream(IStream* stream);
+	explicit HttpChunkStream(IStream* stream, bool writeChunks = false);
 
 	virtual void close() override final;
 
@@ -57,6 +61,7 @@ public:
 private:
 	Ref< IStream > m_stream;
 	int64_t m_available;
+	bool m_writeChunks;
 };
 
 }
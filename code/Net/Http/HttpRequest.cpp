@@ -9,10 +9,48 @@
 #include "Core/Misc/Split.h"
 #include "Core/Misc/String.h"
 #include "Core/Misc/StringSplit.h"
+#include "Core/Misc/TString.h"
 #include "Net/Http/HttpRequest.h"
 
 namespace traktor::net
 {
+	namespace
+	{
+
+std::string_view trimView(std::string_view s)
+{
+	while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+		s.remove_prefix(1);
+	while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r'))
+		s.remove_suffix(1);
+	return s;
+}
+
+HttpRequest::Method parseMethod(const std::string_view& method)
+{
+	if (method == "GET")
+		return HttpRequest::MtGet;
+	else if (method == "HEAD")
+		return HttpRequest::MtHead;
+	else if (method == "POST")
+		return HttpRequest::MtPost;
+	else if (method == "PUT")
+		return HttpRequest::MtPut;
+	else if (method == "DELETE")
+		return HttpRequest::MtDelete;
+	else if (method == "TRACE")
+		return HttpRequest::MtTrace;
+	else if (method == "OPTIONS")
+		return HttpRequest::MtOptions;
+	else if (method == "CONNECT")
+		return HttpRequest::MtConnect;
+	else if (method == "PATCH")
+		return HttpRequest::MtPatch;
+	else
+		return HttpRequest::MtUnknown;
+}
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.net.HttpRequest", HttpRequest, Object)
 
@@ -103,4 +141,46 @@ Ref< HttpRequest > HttpRequest::parse(const std::wstring& request)
 	return haveMethod ? hr : nullptr;
 }
 
+Ref< HttpRequest > HttpRequest::parse(const char* request, size_t length)
+{
+	Ref< HttpRequest > hr = new HttpRequest();
+	bool haveMethod = false;
+
+	std::string_view remaining(request, length);
+	while (!remaining.empty())
+	{
+		const size_t eol = remaining.find('\n');
+		const std::string_view line = trimView(remaining.substr(0, eol));
+		remaining = (eol != remaining.npos) ? remaining.substr(eol + 1) : std::string_view();
+
+		if (line.empty())
+			continue;
+
+		if (!haveMethod)
+		{
+			const size_t s0 = line.find_first_of(" \t");
+			if (s0 == line.npos)
+				return nullptr;
+
+			const std::string_view resource = trimView(line.substr(s0 + 1));
+			const size_t s1 = resource.find_first_of(" \t");
+
+			hr->m_method = parseMethod(line.substr(0, s0));
+			if (hr->m_method == MtUnknown)
+				return nullptr;
+
+			hr->m_resource = mbstows(resource.substr(0, s1));
+			haveMethod = true;
+		}
+		else
+		{
+			const size_t p = line.find(": ");
+			if (p != line.npos)
+				hr->m_values[mbstows(line.substr(0, p))] = mbstows(line.substr(p + 2));
+		}
+	}
+
+	return haveMethod ? hr : nullptr;
+}
+
 }
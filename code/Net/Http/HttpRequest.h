@@ -57,6 +57,14 @@ public:
 
 	static Ref< HttpRequest > parse(const std::wstring& request);
 
+	/*! Parse request header directly from received bytes.
+	 *
+	 * \param request UTF-8 encoded request header.
+	 * \param length Length of header in bytes.
+	 * \return Parsed request, null if malformed.
+	 */
+	static Ref< HttpRequest > parse(const char* request, size_t length);
+
 private:
 	Method m_method = MtUnknown;
 	std::wstring m_resource;
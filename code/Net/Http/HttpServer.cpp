@@ -6,25 +6,224 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#if defined(__LINUX__) || defined(__ANDROID__)
+#	include <sys/epoll.h>
+#	include <unistd.h>
+#endif
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
 #include "Core/RefArray.h"
-#include "Core/Io/FileOutputStream.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Io/BufferedStream.h"
+#include "Core/Io/MemoryStream.h"
 #include "Core/Io/StreamCopy.h"
-#include "Core/Io/StreamStream.h"
-#include "Core/Io/StringReader.h"
 #include "Core/Io/StringOutputStream.h"
 #include "Core/Io/Utf8Encoding.h"
 #include "Core/Log/Log.h"
 #include "Core/Misc/SafeDestroy.h"
 #include "Core/Misc/String.h"
 #include "Core/Misc/StringSplit.h"
+#include "Core/Misc/TString.h"
+#include "Core/Thread/Acquire.h"
+#include "Core/Thread/Event.h"
+#include "Core/Thread/Semaphore.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Core/Timer/Timer.h"
 #include "Net/SocketAddressIPv4.h"
+#include "Net/SocketSet.h"
 #include "Net/SocketStream.h"
 #include "Net/TcpSocket.h"
+#include "Net/Http/HttpChunkStream.h"
 #include "Net/Http/HttpRequest.h"
 #include "Net/Http/HttpServer.h"
 
 namespace traktor::net
 {
+	namespace
+	{
+
+const int32_t c_maxEvents = 64;
+const int32_t c_maxAcceptCount = 64;
+const size_t c_receiveSize = 4096;
+const size_t c_maxHeaderSize = 64 * 1024;
+const size_t c_maxContentLength = 64 * 1024 * 1024;
+const size_t c_maxIdleBufferSize = 64 * 1024;
+const int32_t c_sendTimeout = 10000;
+const double c_keepAliveTimeout = 30.0;
+
+/*! Client connection; owned by server, processed by at most one thread at any time. */
+class Connection : public Object
+{
+public:
+	Ref< TcpSocket > socket;
+	AlignedVector< uint8_t > buffer;
+	double lastActivity = 0.0;
+	bool busy = false;
+	bool closed = false;
+};
+
+/*! Framing of a request, parsed in place from received bytes. */
+struct RequestFrame
+{
+	size_t headerLength = 0;
+	size_t contentLength = 0;
+	bool http11 = true;
+	bool keepAlive = true;
+	bool chunked = false;
+};
+
+enum class FrameResult
+{
+	Malformed,
+	Incomplete,
+	Complete
+};
+
+bool equalNoCase(const std::string_view& a, const std::string_view& b)
+{
+	if (a.size() != b.size())
+		return false;
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		if (std::tolower((unsigned char)a[i]) != std::tolower((unsigned char)b[i]))
+			return false;
+	}
+	return true;
+}
+
+bool containsNoCase(const std::string_view& s, const std::string_view& token)
+{
+	for (size_t i = 0; i + token.size() <= s.size(); ++i)
+	{
+		if (equalNoCase(s.substr(i, token.size()), token))
+			return true;
+	}
+	return false;
+}
+
+std::string_view trimView(std::string_view s)
+{
+	while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+		s.remove_prefix(1);
+	while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r'))
+		s.remove_suffix(1);
+	return s;
+}
+
+/*! Scan request header without copying; only the fields required to frame the request are extracted. */
+FrameResult parseFrame(const uint8_t* data, size_t size, RequestFrame& outFrame)
+{
+	const std::string_view header((const char*)data, size);
+	bool requestLine = true;
+
+	// Ignore empty lines preceding request line, RFC 7230 3.5.
+	size_t lineStart = 0;
+	while (lineStart < header.size() && (header[lineStart] == '\r' || header[lineStart] == '\n'))
+		++lineStart;
+
+	for (;;)
+	{
+		const size_t eol = header.find('\n', lineStart);
+		if (eol == header.npos)
+			return FrameResult::Incomplete;
+
+		std::string_view line = header.substr(lineStart, eol - lineStart);
+		if (!line.empty() && line.back() == '\r')
+			line.remove_suffix(1);
+
+		lineStart = eol + 1;
+
+		if (line.empty())
+			break;
+
+		if (requestLine)
+		{
+			line = trimView(line);
+			if (line.size() >= 8 && line.substr(line.size() - 8) == "HTTP/1.0")
+			{
+				outFrame.http11 = false;
+				outFrame.keepAlive = false;
+			}
+			else if (line.size() >= 8 && line.substr(line.size() - 8, 5) != "HTTP/")
+				return FrameResult::Malformed;
+			requestLine = false;
+			continue;
+		}
+
+		const size_t colon = line.find(':');
+		if (colon == line.npos)
+			continue;
+
+		const std::string_view key = trimView(line.substr(0, colon));
+		const std::string_view value = trimView(line.substr(colon + 1));
+
+		if (equalNoCase(key, "Content-Length"))
+		{
+			if (value.empty())
+				return FrameResult::Malformed;
+
+			size_t contentLength = 0;
+			for (const char ch : value)
+			{
+				if (ch < '0' || ch > '9' || contentLength > c_maxContentLength)
+					return FrameResult::Malformed;
+				contentLength = contentLength * 10 + (ch - '0');
+			}
+			if (contentLength > c_maxContentLength)
+				return FrameResult::Malformed;
+			outFrame.contentLength = contentLength;
+		}
+		else if (equalNoCase(key, "Connection"))
+		{
+			if (containsNoCase(value, "close"))
+				outFrame.keepAlive = false;
+			else if (containsNoCase(value, "keep-alive"))
+				outFrame.keepAlive = true;
+		}
+		else if (equalNoCase(key, "Transfer-Encoding"))
+		{
+			if (!equalNoCase(value, "identity"))
+				outFrame.chunked = true;
+		}
+	}
+
+	if (requestLine)
+		return FrameResult::Incomplete;
+
+	outFrame.headerLength = lineStart;
+	return FrameResult::Complete;
+}
+
+void appendStatus(std::string& response, int32_t result)
+{
+	char status[64];
+	if (result >= 200 && result < 300)
+		std::snprintf(status, sizeof(status), "HTTP/1.1 %d OK\r\n", result);
+	else
+		std::snprintf(status, sizeof(status), "HTTP/1.1 %d ERROR\r\n", result);
+	response += status;
+}
+
+bool sendAll(TcpSocket* socket, const std::string& data)
+{
+	SocketStream stream(socket, false, true, c_sendTimeout);
+	return stream.write(data.data(), (int64_t)data.size()) == (int64_t)data.size();
+}
+
+/*! Reply with an error and no content; connection is closed afterwards. */
+void sendError(TcpSocket* socket, int32_t result)
+{
+	std::string response;
+	appendStatus(response, result);
+	response += "Content-Length: 0\r\nConnection: close\r\n\r\n";
+	sendAll(socket, response);
+}
+
+	}
 
 class HttpServerImpl : public Object
 {
@@ -39,7 +238,7 @@ public:
 		destroy();
 	}
 
-	bool create(const SocketAddressIPv4& bind)
+	bool create(const SocketAddressIPv4& bind, int32_t workerCount)
 	{
 		if (!m_serverSocket.bind(bind, true))
 			return false;
@@ -47,11 +246,63 @@ public:
 		if (!m_serverSocket.listen())
 			return false;
 
+#if defined(__LINUX__) || defined(__ANDROID__)
+		m_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+		if (m_epoll < 0)
+		{
+			log::error << L"Unable to create epoll instance." << Endl;
+			return false;
+		}
+
+		epoll_event ev = {};
+		ev.events = EPOLLIN;
+		ev.data.ptr = nullptr;
+		if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, (int)m_serverSocket.handle(), &ev) != 0)
+		{
+			log::error << L"Unable to register server socket with epoll." << Endl;
+			return false;
+		}
+#endif
+
+		for (int32_t i = 0; i < workerCount; ++i)
+		{
+			Thread* worker = ThreadManager::getInstance().create(
+				[this]() { threadWorker(); },
+				L"HTTP server worker"
+			);
+			if (!worker)
+				return false;
+			worker->start();
+			m_workers.push_back(worker);
+		}
+
 		return true;
 	}
 
 	void destroy()
 	{
+		for (auto worker : m_workers)
+			worker->stop(0);
+		for (auto worker : m_workers)
+		{
+			worker->stop();
+			ThreadManager::getInstance().destroy(worker);
+		}
+		m_workers.clear();
+		m_ready.clear();
+
+#if defined(__LINUX__) || defined(__ANDROID__)
+		if (m_epoll >= 0)
+		{
+			::close(m_epoll);
+			m_epoll = -1;
+		}
+#endif
+
+		for (auto connection : m_connections)
+			safeClose(connection->socket);
+		m_connections.clear();
+
 		m_listener = nullptr;
 		m_serverSocket.close();
 	}
@@ -61,6 +312,14 @@ public:
 		return dynamic_type_cast< net::SocketAddressIPv4* >(m_serverSocket.getLocalAddress())->getPort();
 	}
 
+	int32_t getConnectionCount()
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		return (int32_t)std::count_if(m_connections.begin(), m_connections.end(), [](const Connection* connection) {
+			return !connection->closed;
+		});
+	}
+
 	void setRequestListener(HttpServer::IRequestListener* listener)
 	{
 		m_listener = listener;
@@ -68,145 +327,409 @@ public:
 
 	void update(int32_t duration)
 	{
-		for (; duration >= 0; duration -= 100)
+		const double until = m_timer.getElapsedTime() + std::max< int32_t >(duration, 0) / 1000.0;
+		for (;;)
+		{
+			const double now = m_timer.getElapsedTime();
+			multiplex((int32_t)(std::max(until - now, 0.0) * 1000.0));
+			if (m_timer.getElapsedTime() >= until)
+				break;
+		}
+		cleanup();
+	}
+
+private:
+	HttpServer* m_server;
+	TcpSocket m_serverSocket;
+	Ref< HttpServer::IRequestListener > m_listener;
+	int32_t m_epoll = -1;
+	AlignedVector< Thread* > m_workers;
+	RefArray< Connection > m_connections;
+	RefArray< Connection > m_ready;
+	Semaphore m_lock;
+	Event m_readyEvent;
+	Timer m_timer;
+
+	/*! Wait for activity; accept new connections and dispatch readable connections. */
+	void multiplex(int32_t timeout)
+	{
+#if defined(__LINUX__) || defined(__ANDROID__)
+		epoll_event events[c_maxEvents];
+		const int32_t nevents = ::epoll_wait(m_epoll, events, c_maxEvents, timeout);
+		for (int32_t i = 0; i < nevents; ++i)
+		{
+			if (events[i].data.ptr == nullptr)
+				accept();
+			else
+				dispatch(static_cast< Connection* >(events[i].data.ptr));
+		}
+#else
+		SocketSet socketSet;
+		socketSet.add(&m_serverSocket);
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+			for (auto connection : m_connections)
+			{
+				if (!connection->busy && !connection->closed)
+					socketSet.add(connection->socket);
+			}
+		}
+
+		SocketSet resultSet;
+		if (socketSet.select(true, false, false, timeout, resultSet) <= 0)
+			return;
+
+		for (int32_t i = 0; i < resultSet.count(); ++i)
 		{
-			if (!m_serverSocket.select(true, false, false, 100))
+			Ref< Socket > socket = resultSet.get(i);
+			if (socket == &m_serverSocket)
+			{
+				accept();
 				continue;
+			}
 
+			auto it = std::find_if(m_connections.begin(), m_connections.end(), [&](const Connection* connection) {
+				return connection->socket == socket;
+			});
+			if (it != m_connections.end())
+				dispatch(*it);
+		}
+#endif
+	}
+
+	void accept()
+	{
+		for (int32_t i = 0; i < c_maxAcceptCount; ++i)
+		{
 			Ref< TcpSocket > clientSocket = m_serverSocket.accept();
 			if (!clientSocket)
-				continue;
+				break;
+
+			clientSocket->setNoDelay(true);
 
-			if (!clientSocket->select(true, false, false, 10000))
+			Ref< Connection > connection = new Connection();
+			connection->socket = clientSocket;
+			connection->lastActivity = m_timer.getElapsedTime();
+
+#if defined(__LINUX__) || defined(__ANDROID__)
+			// One-shot so only a single thread process connection at any time;
+			// connection is re-armed when all received requests has been handled.
+			epoll_event ev = {};
+			ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+			ev.data.ptr = connection.ptr();
+			if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, (int)clientSocket->handle(), &ev) != 0)
 			{
-				clientSocket->close();
-				clientSocket = nullptr;
+				log::error << L"Unable to register HTTP connection with epoll." << Endl;
+				safeClose(clientSocket);
 				continue;
 			}
+#endif
 
-			SocketStream clientStream(clientSocket, true, true, 100);
-
-			// Read request until two blank lines.
-			StringReader clientReader(&clientStream, new Utf8Encoding());
-			StringOutputStream ss;
-			for (;;)
 			{
-				std::wstring tmp;
-				if (clientReader.readLine(tmp) < 0)
-					break;
+				T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+				m_connections.push_back(connection);
+			}
 
-				if (!tmp.empty())
-					ss << tmp << Endl;
-				else
+			// Accept as many pending connections as possible without blocking.
+			if (m_serverSocket.select(true, false, false, 0) <= 0)
+				break;
+		}
+	}
+
+	void dispatch(Connection* connection)
+	{
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+			if (connection->closed)
+				return;
+			connection->busy = true;
+			if (!m_workers.empty())
+				m_ready.push_back(connection);
+		}
+
+		if (!m_workers.empty())
+			m_readyEvent.pulse();
+		else
+			process(connection);
+	}
+
+	/*! Receive and handle requests, then either re-arm or close connection. */
+	void process(Connection* connection)
+	{
+		const bool keepAlive = receive(connection);
+
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		connection->busy = false;
+
+		if (!keepAlive)
+		{
+			safeClose(connection->socket);
+			connection->closed = true;
+			return;
+		}
+
+#if defined(__LINUX__) || defined(__ANDROID__)
+		// Re-arm connection so we get notified when next request arrives.
+		epoll_event ev = {};
+		ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+		ev.data.ptr = connection;
+		::epoll_ctl(m_epoll, EPOLL_CTL_MOD, (int)connection->socket->handle(), &ev);
+#endif
+	}
+
+	/*! Receive pending data and handle all complete requests, in order.
+	 *
+	 * \return True if connection should be kept alive.
+	 */
+	bool receive(Connection* connection)
+	{
+		AlignedVector< uint8_t >& buffer = connection->buffer;
+
+		const size_t offset = buffer.size();
+		buffer.resize(offset + c_receiveSize);
+
+		const int32_t nrecv = connection->socket->recv(buffer.ptr() + offset, (int)c_receiveSize);
+		if (nrecv <= 0)
+			return false;
+
+		buffer.resize(offset + nrecv);
+		connection->lastActivity = m_timer.getElapsedTime();
+
+		size_t consumed = 0;
+		while (consumed < buffer.size())
+		{
+			RequestFrame frame;
+			const FrameResult result = parseFrame(buffer.c_ptr() + consumed, buffer.size() - consumed, frame);
+			if (result == FrameResult::Malformed)
+			{
+				sendError(connection->socket, 400);
+				return false;
+			}
+			else if (result == FrameResult::Incomplete)
+			{
+				if (buffer.size() - consumed > c_maxHeaderSize)
 				{
-					if (clientReader.readLine(tmp) < 0)
-						break;
-					if (!tmp.empty())
-						ss << tmp << Endl;
-					else
-						break;
+					sendError(connection->socket, 431);
+					return false;
 				}
+				break;
+			}
+
+			if (frame.chunked)
+			{
+				log::warning << L"Got chunked HTTP request; not supported, closing connection." << Endl;
+				sendError(connection->socket, 411);
+				return false;
 			}
 
-			clientStream.setTimeout(10000);
+			// Wait until entire body has been received.
+			if (buffer.size() - consumed < frame.headerLength + frame.contentLength)
+				break;
+
+			if (!respond(connection, buffer.c_ptr() + consumed, frame))
+				return false;
+
+			consumed += frame.headerLength + frame.contentLength;
+		}
+
+		// Keep partially received request at beginning of buffer.
+		if (consumed > 0)
+		{
+			const size_t remaining = buffer.size() - consumed;
+			if (remaining > 0)
+				std::memmove(buffer.ptr(), buffer.c_ptr() + consumed, remaining);
+			buffer.resize(remaining);
+		}
+
+		// Release large buffers when connection idle.
+		if (buffer.empty() && buffer.capacity() > c_maxIdleBufferSize)
+			buffer.clear();
+
+		return true;
+	}
+
+	/*! Handle request and send response.
+	 *
+	 * \return True if connection should be kept alive.
+	 */
+	bool respond(Connection* connection, const uint8_t* data, const RequestFrame& frame)
+	{
+		Ref< HttpRequest > request = HttpRequest::parse((const char*)data, frame.headerLength);
+		if (!request)
+		{
+			sendError(connection->socket, 400);
+			return false;
+		}
+
+		StringOutputStream ssr;
+		Ref< IStream > ds;
+		int32_t result = 503;
+		bool cache = true;
+		std::wstring session;
 
-			Ref< HttpRequest > request = HttpRequest::parse(ss.str());
-			if (request)
+		// Extract session id from cookie.
+		if (request->hasValue(L"Cookie"))
+		{
+			const std::wstring cookie = request->getValue(L"Cookie");
+
+			StringSplit< std::wstring > ss(cookie, L";");
+			for (StringSplit< std::wstring >::const_iterator i = ss.begin(); i != ss.end(); ++i)
 			{
-				StringOutputStream ssr;
-				Ref< IStream > ds;
-				int32_t result = 503;
-				bool cache = true;
-				std::wstring session;
+				const std::wstring kv = trim(*i);
 
-				// Extract session id from cookie.
-				if (request->hasValue(L"Cookie"))
+				const size_t p = kv.find(L'=');
+				if (p != kv.npos)
 				{
-					const std::wstring cookie = request->getValue(L"Cookie");
-
-					StringSplit< std::wstring > ss(cookie, L";");
-					for (StringSplit< std::wstring >::const_iterator i = ss.begin(); i != ss.end(); ++i)
+					const std::wstring k = kv.substr(0, p);
+					if (k == L"SESSIONID")
 					{
-						const std::wstring& kv = *i;
-
-						const size_t p = kv.find(L'=');
-						if (p != kv.npos)
-						{
-							const std::wstring k = kv.substr(0, p);
-							if (k == L"SESSIONID")
-							{
-								session = kv.substr(p + 1);
-								break;
-							}
-						}
+						session = kv.substr(p + 1);
+						break;
 					}
 				}
+			}
+		}
 
-				if (m_listener)
+		if (m_listener)
+		{
+			if (request->getMethod() == HttpRequest::MtPost || request->getMethod() == HttpRequest::MtPut)
+			{
+				if (frame.contentLength > 0)
 				{
-					if (request->getMethod() == HttpRequest::MtPost || request->getMethod() == HttpRequest::MtPut)
-					{
-						const int32_t contentLength = parseString< int32_t >(request->getValue(L"Content-Length"));
-						if (contentLength > 0)
-						{
-							StreamStream payloadStream(&clientStream, clientStream.tell() + contentLength);
-							result = m_listener->httpClientRequest(m_server, request, &payloadStream, ssr, ds, cache, session);
-						}
-						else
-							log::warning << L"Got PUT/POST request but no \"Content-Length\"; ignoring request." << Endl;
-					}
-					else
-					{
-						result = m_listener->httpClientRequest(m_server, request, nullptr, ssr, ds, cache, session);
-					}
+					// Payload is read directly from receive buffer.
+					MemoryStream payloadStream(data + frame.headerLength, (int64_t)frame.contentLength);
+					result = m_listener->httpClientRequest(m_server, request, &payloadStream, ssr, ds, cache, session);
 				}
-
-				FileOutputStream os(&clientStream, new Utf8Encoding(), OutputStream::LineEnd::Win);
-				if (result >= 200 && result < 300)
-					os << L"HTTP/1.1 " << result << L" OK" << Endl;
 				else
-					os << L"HTTP/1.1 " << result << L" ERROR" << Endl;
+					log::warning << L"Got PUT/POST request but no \"Content-Length\"; ignoring request." << Endl;
+			}
+			else
+			{
+				result = m_listener->httpClientRequest(m_server, request, nullptr, ssr, ds, cache, session);
+			}
+		}
 
-				// Update cookie if necessary.
-				if (!session.empty())
-					os << L"Set-Cookie: SESSIONID=" << session << L";path=/" << Endl;
+		// Streams of unknown length are sent chunked; only possible with HTTP/1.1 clients.
+		const bool keepAlive = frame.keepAlive && (!ds || frame.http11);
+		const bool head = (request->getMethod() == HttpRequest::MtHead);
 
-				if (!cache)
-					os << L"Cache-Control: no-cache" << Endl;
+		std::string response;
+		appendStatus(response, result);
 
-				os << L"Connection: close" << Endl;
-				os << Endl;
+		// Update cookie if necessary.
+		if (!session.empty())
+			response += "Set-Cookie: SESSIONID=" + wstombs(Utf8Encoding(), session) + ";path=/\r\n";
 
-				if (ds)
+		if (!cache)
+			response += "Cache-Control: no-cache\r\n";
+
+		response += keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+
+		if (ds)
+		{
+			if (frame.http11)
+				response += "Transfer-Encoding: chunked\r\n";
+			response += "\r\n";
+
+			SocketStream clientStream(connection->socket, false, true, c_sendTimeout);
+			BufferedStream bufferedStream(&clientStream, 16 * 1024);
+
+			bool succeeded = (bufferedStream.write(response.data(), (int64_t)response.size()) == (int64_t)response.size());
+			if (succeeded && !head)
+			{
+				if (frame.http11)
 				{
-					if (!StreamCopy(&clientStream, ds).execute())
-						log::error << L"Unable to transfer entire stream to client; partially transmitted data." << Endl;
+					HttpChunkStream chunkStream(&bufferedStream, true);
+					succeeded = StreamCopy(&chunkStream, ds).execute();
+					chunkStream.close();
 				}
 				else
-					os << ssr.str();
+					succeeded = StreamCopy(&bufferedStream, ds).execute();
+			}
+			bufferedStream.flush();
+
+			ds->close();
+			ds = nullptr;
+
+			if (!succeeded)
+			{
+				log::error << L"Unable to transfer entire stream to client; partially transmitted data." << Endl;
+				return false;
 			}
+		}
+		else
+		{
+			const std::string content = wstombs(Utf8Encoding(), ssr.str());
+
+			char contentLength[64];
+			std::snprintf(contentLength, sizeof(contentLength), "Content-Length: %zu\r\n\r\n", content.size());
+			response += contentLength;
+
+			// Header and content are sent together.
+			if (!head)
+				response += content;
 
-			safeClose(clientSocket);
+			if (!sendAll(connection->socket, response))
+				return false;
 		}
+
+		return keepAlive;
 	}
 
-private:
-	HttpServer* m_server;
-	TcpSocket m_serverSocket;
-	Ref< HttpServer::IRequestListener > m_listener;
+	/*! Remove closed connections and close connections which has been idle too long. */
+	void cleanup()
+	{
+		const double now = m_timer.getElapsedTime();
+
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		auto it = std::remove_if(m_connections.begin(), m_connections.end(), [&](Connection* connection) {
+			if (connection->busy)
+				return false;
+			if (!connection->closed && now - connection->lastActivity > c_keepAliveTimeout)
+			{
+				safeClose(connection->socket);
+				connection->closed = true;
+			}
+			return connection->closed;
+		});
+		m_connections.erase(it, m_connections.end());
+	}
+
+	void threadWorker()
+	{
+		Thread* thread = ThreadManager::getInstance().getCurrentThread();
+		while (!thread->stopped())
+		{
+			Ref< Connection > connection;
+			{
+				T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+				if (!m_ready.empty())
+				{
+					connection = m_ready.front();
+					m_ready.pop_front();
+				}
+			}
+			if (!connection)
+			{
+				m_readyEvent.wait(100);
+				continue;
+			}
+			process(connection);
+		}
+	}
 };
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.net.HttpServer", HttpServer, Object)
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.net.HttpServer.IRequestListener", HttpServer::IRequestListener, Object)
 
-bool HttpServer::create(const SocketAddressIPv4& bind)
+bool HttpServer::create(const SocketAddressIPv4& bind, int32_t workerCount)
 {
 	if (m_impl)
 		return false;
 
 	Ref< HttpServerImpl > impl = new HttpServerImpl(this);
-	if (!impl->create(bind))
+	if (!impl->create(bind, workerCount))
 		return false;
 
 	m_impl = impl;
@@ -226,6 +749,14 @@ int32_t HttpServer::getListenPort()
 		return 0;
 }
 
+int32_t HttpServer::getConnectionCount()
+{
+	if (m_impl)
+		return m_impl->getConnectionCount();
+	else
+		return 0;
+}
+
 void HttpServer::setRequestListener(IRequestListener* listener)
 {
 	if (m_impl)
@@ -34,8 +34,17 @@ class HttpRequest;
 class HttpServerImpl;
 class SocketAddressIPv4;
 
-/*!
+/*! HTTP/1.1 server.
  * \ingroup Net
+ *
+ * Connections are kept alive and pipelined requests
+ * are answered in order. Sockets are polled (epoll on Linux)
+ * from update(); complete requests are either handled
+ * directly from update() or dispatched to a bounded pool
+ * of worker threads, thus a slow client never stalls
+ * other clients.
+ *
+ * Stream responses are sent chunked to HTTP/1.1 clients.
  */
 class T_DLLCLASS HttpServer : public Object
 {
@@ -58,14 +67,28 @@ public:
 		) = 0;
 	};
 
-	bool create(const SocketAddressIPv4& bind);
+	/*! Create server.
+	 *
+	 * \param bind Address to listen on.
+	 * \param workerCount Number of worker threads, 0 means requests are handled from update().
+	 * \return True if server created.
+	 *
+	 * \note Listener must be thread safe if workers are used.
+	 */
+	bool create(const SocketAddressIPv4& bind, int32_t workerCount = 0);
 
 	void destroy();
 
 	int32_t getListenPort();
 
+	int32_t getConnectionCount();
+
 	void setRequestListener(IRequestListener* listener);
 
+	/*! Accept connections and process requests.
+	 *
+	 * \param duration Time in milliseconds to wait for, and process, network activity.
+	 */
 	void update(int32_t duration);
 
 private:
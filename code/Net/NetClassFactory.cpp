@@ -70,6 +70,11 @@ int32_t net_HttpRequest_getMethod(HttpRequest* self)
 	return (int32_t)self->getMethod();
 }
 
+Ref< HttpRequest > net_HttpRequest_parse(const std::wstring& request)
+{
+	return HttpRequest::parse(request);
+}
+
 bool net_HttpServer_create(HttpServer* self, int32_t port)
 {
 	return self->create(SocketAddressIPv4(port));
@@ -270,7 +275,7 @@ void NetClassFactory::createClasses(IRuntimeClassRegistrar* registrar) const
 	classHttpRequest->addMethod("hasValue", &HttpRequest::hasValue);
 	classHttpRequest->addMethod("setValue", &HttpRequest::setValue);
 	classHttpRequest->addMethod("getValue", &HttpRequest::getValue);
-	classHttpRequest->addStaticMethod("parse", &HttpRequest::parse);
+	classHttpRequest->addStaticMethod("parse", &net_HttpRequest_parse);
 	registrar->registerClass(classHttpRequest);
 
 	Ref< AutoRuntimeClass< HttpServer::IRequestListener > > classHttpServer_IRequestListener = new AutoRuntimeClass< HttpServer::IRequestListener >();
@@ -7,6 +7,7 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #if defined(__LINUX__) || defined(__RPI__) || defined(__APPLE__) || defined(__ANDROID__)
+#	include <poll.h>
 #	include <sys/ioctl.h>
 #endif
 #include "Net/Platform.h"
@@ -52,6 +53,18 @@ void Socket::close()
 
 int Socket::select(bool read, bool write, bool except, int timeout)
 {
+#if defined(__LINUX__) || defined(__RPI__) || defined(__APPLE__) || defined(__ANDROID__)
+	// Use poll since select cannot handle descriptors beyond FD_SETSIZE.
+	pollfd pfd = {};
+	pfd.fd = (int)m_socket;
+	pfd.events = (read ? POLLIN : 0) | (write ? POLLOUT : 0) | (except ? POLLPRI : 0);
+	const int result = ::poll(&pfd, 1, timeout);
+	if (result <= 0)
+		return result;
+	if ((pfd.revents & POLLNVAL) != 0)
+		return -1;
+	return 1;
+#else
 	timeval to = { timeout / 1000, (timeout % 1000) * 1000 };
 	fd_set* fds[] = { 0, 0, 0 };
 	fd_set readfds, writefds, exceptfds;
@@ -78,11 +91,17 @@ int Socket::select(bool read, bool write, bool except, int timeout)
 	}
 
 	return ::select(m_socket + 1, fds[0], fds[1], fds[2], &to);
+#endif
 }
 
 int Socket::send(const void* data, int length)
 {
+#if defined(MSG_NOSIGNAL)
+	// Report broken connections as errors instead of raising SIGPIPE.
+	return int(::send(m_socket, static_cast<const char*>(data), length, MSG_NOSIGNAL));
+#else
 	return int(::send(m_socket, static_cast<const char*>(data), length, 0));
+#endif
 }
 
 int Socket::recv(void* data, int length)
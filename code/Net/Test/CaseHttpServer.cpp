@@ -0,0 +1,307 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "Core/Io/MemoryStream.h"
+#include "Core/Io/OutputStream.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Net/SocketAddressIPv4.h"
+#include "Net/TcpSocket.h"
+#include "Net/Http/HttpRequest.h"
+#include "Net/Http/HttpServer.h"
+#include "Net/Test/CaseHttpServer.h"
+
+namespace traktor::net::test
+{
+	namespace
+	{
+
+const uint16_t c_port = 20021;
+const size_t c_streamSize = 100000;
+
+class TestListener : public HttpServer::IRequestListener
+{
+public:
+	TestListener()
+	{
+		m_streamData.resize(c_streamSize);
+		for (size_t i = 0; i < c_streamSize; ++i)
+			m_streamData[i] = char('a' + (i / 3) % 26);
+	}
+
+	virtual int32_t httpClientRequest(
+		HttpServer* server,
+		const HttpRequest* request,
+		IStream* clientStream,
+		OutputStream& os,
+		Ref< IStream >& outStream,
+		bool& outCache,
+		std::wstring& inoutSession
+	) override final
+	{
+		const std::wstring& resource = request->getResource();
+		if (resource == L"/stream")
+		{
+			outStream = new MemoryStream(m_streamData.data(), (int64_t)m_streamData.size(), true, false);
+			return 200;
+		}
+		else if (resource == L"/echo")
+		{
+			int64_t received = 0;
+			uint8_t buffer[256];
+			for (int64_t nread; clientStream && (nread = clientStream->read(buffer, sizeof(buffer))) > 0; )
+				received += nread;
+			os << L"Received " << received;
+			return 200;
+		}
+		else if (resource == L"/session")
+		{
+			inoutSession = L"1234";
+			return 200;
+		}
+		else if (resource == L"/missing")
+			return 404;
+
+		os << L"Hello " << resource;
+		return 200;
+	}
+
+	const std::string& getStreamData() const { return m_streamData; }
+
+private:
+	std::string m_streamData;
+};
+
+struct Response
+{
+	int32_t status = 0;
+	std::string header;
+	std::string body;
+};
+
+bool receiveMore(TcpSocket* socket, std::string& buffer)
+{
+	if (socket->select(true, false, false, 5000) <= 0)
+		return false;
+
+	char tmp[4096];
+	const int32_t nrecv = socket->recv(tmp, sizeof(tmp));
+	if (nrecv <= 0)
+		return false;
+
+	buffer.append(tmp, nrecv);
+	return true;
+}
+
+/*! Read a single response; data beyond response is left in buffer. */
+bool readResponse(TcpSocket* socket, std::string& buffer, Response& outResponse)
+{
+	size_t headerEnd;
+	while ((headerEnd = buffer.find("\r\n\r\n")) == buffer.npos)
+	{
+		if (!receiveMore(socket, buffer))
+			return false;
+	}
+
+	outResponse.header = buffer.substr(0, headerEnd + 4);
+	outResponse.status = std::atoi(outResponse.header.c_str() + 9);
+	outResponse.body.clear();
+	buffer.erase(0, headerEnd + 4);
+
+	if (outResponse.header.find("Transfer-Encoding: chunked\r\n") != std::string::npos)
+	{
+		for (;;)
+		{
+			size_t eol;
+			while ((eol = buffer.find("\r\n")) == buffer.npos)
+			{
+				if (!receiveMore(socket, buffer))
+					return false;
+			}
+
+			const size_t chunkSize = std::strtoul(buffer.c_str(), nullptr, 16);
+			while (buffer.size() < eol + 2 + chunkSize + 2)
+			{
+				if (!receiveMore(socket, buffer))
+					return false;
+			}
+
+			outResponse.body += buffer.substr(eol + 2, chunkSize);
+			buffer.erase(0, eol + 2 + chunkSize + 2);
+
+			if (chunkSize == 0)
+				break;
+		}
+	}
+	else
+	{
+		const size_t p = outResponse.header.find("Content-Length: ");
+		if (p == outResponse.header.npos)
+			return false;
+
+		const size_t contentLength = std::strtoul(outResponse.header.c_str() + p + 16, nullptr, 10);
+		while (buffer.size() < contentLength)
+		{
+			if (!receiveMore(socket, buffer))
+				return false;
+		}
+
+		outResponse.body = buffer.substr(0, contentLength);
+		buffer.erase(0, contentLength);
+	}
+
+	return true;
+}
+
+bool sendText(TcpSocket* socket, const std::string& text)
+{
+	return socket->send(text.data(), (int)text.size()) == (int)text.size();
+}
+
+Ref< TcpSocket > connect()
+{
+	Ref< TcpSocket > socket = new TcpSocket();
+	if (!socket->connect(SocketAddressIPv4(L"localhost", c_port)))
+		return nullptr;
+	return socket;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.net.test.CaseHttpServer", 0, CaseHttpServer, traktor::test::Case)
+
+void CaseHttpServer::run()
+{
+	Ref< TestListener > listener = new TestListener();
+
+	Ref< HttpServer > server = new HttpServer();
+	if (!server->create(SocketAddressIPv4(c_port), 2))
+	{
+		CASE_ASSERT(false);
+		return;
+	}
+	server->setRequestListener(listener);
+
+	Thread* serverThread = ThreadManager::getInstance().create([&](){
+		while (!serverThread->stopped())
+			server->update(100);
+	});
+	CASE_ASSERT(serverThread != nullptr);
+	if (serverThread == nullptr)
+		return;
+
+	serverThread->start();
+
+	// Pipelined requests on a single keep-alive connection are answered in order.
+	{
+		Ref< TcpSocket > socket = connect();
+		CASE_ASSERT(socket != nullptr);
+		if (socket)
+		{
+			CASE_ASSERT(sendText(socket,
+				"GET /a HTTP/1.1\r\nHost: localhost\r\n\r\n"
+				"GET /b HTTP/1.1\r\nHost: localhost\r\n\r\n"
+				"POST /echo HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello"
+			));
+
+			std::string buffer;
+			Response response;
+
+			CASE_ASSERT(readResponse(socket, buffer, response));
+			CASE_ASSERT_EQUAL(response.status, 200);
+			CASE_ASSERT(response.body == "Hello /a");
+			CASE_ASSERT(response.header.find("Connection: keep-alive\r\n") != std::string::npos);
+
+			CASE_ASSERT(readResponse(socket, buffer, response));
+			CASE_ASSERT(response.body == "Hello /b");
+
+			CASE_ASSERT(readResponse(socket, buffer, response));
+			CASE_ASSERT(response.body == "Received 5");
+
+			// Stream response is sent chunked.
+			CASE_ASSERT(sendText(socket, "GET /stream HTTP/1.1\r\n\r\n"));
+			CASE_ASSERT(readResponse(socket, buffer, response));
+			CASE_ASSERT_EQUAL(response.status, 200);
+			CASE_ASSERT(response.header.find("Transfer-Encoding: chunked\r\n") != std::string::npos);
+			CASE_ASSERT(response.body == listener->getStreamData());
+
+			// Request split over multiple packets.
+			CASE_ASSERT(sendText(socket, "GET /spl"));
+			ThreadManager::getInstance().getCurrentThread()->sleep(50);
+			CASE_ASSERT(sendText(socket, "it HTTP/1.1\r\nCookie: a=b; SESSIONID=42\r\n"));
+			ThreadManager::getInstance().getCurrentThread()->sleep(50);
+			CASE_ASSERT(sendText(socket, "\r\n"));
+			CASE_ASSERT(readResponse(socket, buffer, response));
+			CASE_ASSERT(response.body == "Hello /split");
+			CASE_ASSERT(response.header.find("Set-Cookie: SESSIONID=42;path=/\r\n") != std::string::npos);
+
+			CASE_ASSERT(sendText(socket, "GET /missing HTTP/1.1\r\n\r\n"));
+			CASE_ASSERT(readResponse(socket, buffer, response));
+			CASE_ASSERT_EQUAL(response.status, 404);
+
+			// Server close connection when asked to.
+			CASE_ASSERT(sendText(socket, "GET /session HTTP/1.1\r\nConnection: close\r\n\r\n"));
+			CASE_ASSERT(readResponse(socket, buffer, response));
+			CASE_ASSERT(response.header.find("Connection: close\r\n") != std::string::npos);
+			CASE_ASSERT(response.header.find("Set-Cookie: SESSIONID=1234;path=/\r\n") != std::string::npos);
+			CASE_ASSERT(!receiveMore(socket, buffer));
+
+			socket->close();
+		}
+	}
+
+	// HTTP/1.0 clients are not kept alive.
+	{
+		Ref< TcpSocket > socket = connect();
+		CASE_ASSERT(socket != nullptr);
+		if (socket)
+		{
+			CASE_ASSERT(sendText(socket, "GET /old HTTP/1.0\r\n\r\n"));
+
+			std::string buffer;
+			Response response;
+			CASE_ASSERT(readResponse(socket, buffer, response));
+			CASE_ASSERT(response.body == "Hello /old");
+			CASE_ASSERT(!receiveMore(socket, buffer));
+
+			socket->close();
+		}
+	}
+
+	// Malformed request is rejected.
+	{
+		Ref< TcpSocket > socket = connect();
+		CASE_ASSERT(socket != nullptr);
+		if (socket)
+		{
+			CASE_ASSERT(sendText(socket, "GARBAGE\r\n\r\n"));
+
+			std::string buffer;
+			Response response;
+			CASE_ASSERT(readResponse(socket, buffer, response));
+			CASE_ASSERT_EQUAL(response.status, 400);
+			CASE_ASSERT(!receiveMore(socket, buffer));
+
+			socket->close();
+		}
+	}
+
+	ThreadManager::getInstance().getCurrentThread()->sleep(300);
+	CASE_ASSERT_EQUAL(server->getConnectionCount(), 0);
+
+	serverThread->stop();
+	ThreadManager::getInstance().destroy(serverThread);
+
+	server->destroy();
+	server = nullptr;
+}
+
+}
@@ -0,0 +1,237 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#if defined(__LINUX__) || defined(__ANDROID__)
+#	include <sys/epoll.h>
+#	include <unistd.h>
+#endif
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Io/OutputStream.h"
+#include "Core/Log/Log.h"
+#include "Core/System/OS.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Core/Timer/Timer.h"
+#include "Net/SocketAddressIPv4.h"
+#include "Net/TcpSocket.h"
+#include "Net/Http/HttpRequest.h"
+#include "Net/Http/HttpServer.h"
+#include "Net/Test/CaseHttpServerLoad.h"
+
+namespace traktor::net::test
+{
+	namespace
+	{
+
+const uint16_t c_port = 20031;
+const int32_t c_connectionCount = 1000;
+const int32_t c_requestCount = 20;
+const double c_maxDuration = 60.0;
+
+class LoadListener : public HttpServer::IRequestListener
+{
+public:
+	virtual int32_t httpClientRequest(
+		HttpServer* server,
+		const HttpRequest* request,
+		IStream* clientStream,
+		OutputStream& os,
+		Ref< IStream >& outStream,
+		bool& outCache,
+		std::wstring& inoutSession
+	) override final
+	{
+		os << L"{ \"resource\": \"" << request->getResource() << L"\" }";
+		outCache = false;
+		return 200;
+	}
+};
+
+struct Result
+{
+	double throughput = 0.0;
+	double p99 = 0.0;
+	int32_t completed = 0;
+	int32_t failed = 0;
+};
+
+#if defined(__LINUX__) || defined(__ANDROID__)
+
+struct ClientConnection
+{
+	Ref< TcpSocket > socket;
+	std::string buffer;
+	double sent = 0.0;
+	int32_t completed = 0;
+};
+
+/*! Size of first complete response in buffer, 0 if incomplete. */
+size_t responseSize(const std::string& buffer)
+{
+	const size_t headerEnd = buffer.find("\r\n\r\n");
+	if (headerEnd == buffer.npos)
+		return 0;
+
+	const size_t p = buffer.find("Content-Length: ");
+	if (p == buffer.npos || p > headerEnd)
+		return 0;
+
+	const size_t size = headerEnd + 4 + std::strtoul(buffer.c_str() + p + 16, nullptr, 10);
+	return buffer.size() >= size ? size : 0;
+}
+
+/*! Keep all connections open concurrently, each issuing requests back to back on keep-alive. */
+Result generateLoad()
+{
+	static const char c_request[] = "GET /telemetry HTTP/1.1\r\nHost: localhost\r\n\r\n";
+
+	Result result;
+	AlignedVector< ClientConnection > connections((size_t)c_connectionCount);
+	AlignedVector< double > latencies;
+	latencies.reserve(c_connectionCount * c_requestCount);
+
+	const int32_t epoll = ::epoll_create1(EPOLL_CLOEXEC);
+	if (epoll < 0)
+		return result;
+
+	for (int32_t i = 0; i < c_connectionCount; ++i)
+	{
+		ClientConnection& connection = connections[i];
+		connection.socket = new TcpSocket();
+		if (!connection.socket->connect(SocketAddressIPv4(L"localhost", c_port)))
+		{
+			connection.socket = nullptr;
+			result.failed++;
+			continue;
+		}
+		connection.socket->setNoDelay(true);
+
+		epoll_event ev = {};
+		ev.events = EPOLLIN;
+		ev.data.u32 = (uint32_t)i;
+		::epoll_ctl(epoll, EPOLL_CTL_ADD, (int)connection.socket->handle(), &ev);
+	}
+
+	Timer timer;
+
+	int32_t active = 0;
+	for (auto& connection : connections)
+	{
+		if (!connection.socket)
+			continue;
+		connection.sent = timer.getElapsedTime();
+		if (connection.socket->send(c_request, sizeof(c_request) - 1) != sizeof(c_request) - 1)
+		{
+			result.failed++;
+			continue;
+		}
+		active++;
+	}
+
+	while (active > 0 && timer.getElapsedTime() < c_maxDuration)
+	{
+		epoll_event events[256];
+		const int32_t nevents = ::epoll_wait(epoll, events, sizeof_array(events), 1000);
+		for (int32_t i = 0; i < nevents; ++i)
+		{
+			ClientConnection& connection = connections[events[i].data.u32];
+
+			char tmp[4096];
+			const int32_t nrecv = connection.socket->recv(tmp, sizeof(tmp));
+			if (nrecv <= 0)
+			{
+				::epoll_ctl(epoll, EPOLL_CTL_DEL, (int)connection.socket->handle(), nullptr);
+				result.failed++;
+				active--;
+				continue;
+			}
+			connection.buffer.append(tmp, nrecv);
+
+			for (size_t size; (size = responseSize(connection.buffer)) > 0; )
+			{
+				const double now = timer.getElapsedTime();
+				latencies.push_back(now - connection.sent);
+				connection.buffer.erase(0, size);
+				result.completed++;
+
+				if (++connection.completed >= c_requestCount)
+				{
+					active--;
+					break;
+				}
+
+				connection.sent = now;
+				connection.socket->send(c_request, sizeof(c_request) - 1);
+			}
+		}
+	}
+
+	const double elapsed = timer.getElapsedTime();
+
+	::close(epoll);
+	for (auto& connection : connections)
+	{
+		if (connection.socket)
+			connection.socket->close();
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+
+	result.throughput = elapsed > 0.0 ? result.completed / elapsed : 0.0;
+	result.p99 = !latencies.empty() ? latencies[(latencies.size() * 99) / 100] : 0.0;
+	return result;
+}
+
+#endif
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.net.test.CaseHttpServerLoad", 0, CaseHttpServerLoad, traktor::test::Case)
+
+void CaseHttpServerLoad::run()
+{
+#if defined(__LINUX__) || defined(__ANDROID__)
+	const int32_t workerCounts[] = { 0, std::max< int32_t >(OS::getInstance().getCPUCoreCount(), 2) };
+	for (int32_t workerCount : workerCounts)
+	{
+		Ref< HttpServer > server = new HttpServer();
+		if (!server->create(SocketAddressIPv4(c_port), workerCount))
+		{
+			CASE_ASSERT(false);
+			return;
+		}
+		server->setRequestListener(new LoadListener());
+
+		Thread* serverThread = ThreadManager::getInstance().create([&](){
+			while (!serverThread->stopped())
+				server->update(100);
+		});
+		CASE_ASSERT(serverThread != nullptr);
+		if (serverThread == nullptr)
+			return;
+
+		serverThread->start();
+
+		const Result result = generateLoad();
+		CASE_ASSERT_EQUAL(result.completed, c_connectionCount * c_requestCount);
+
+		log::info << L"HTTP load, " << c_connectionCount << L" connection(s), " << workerCount << L" worker(s); " << int32_t(result.throughput) << L" requests/s, p99 " << int32_t(result.p99 * 1000000.0) << L" us" << Endl;
+
+		serverThread->stop();
+		ThreadManager::getInstance().destroy(serverThread);
+
+		server->destroy();
+		server = nullptr;
+	}
+#endif
+}
+
+}
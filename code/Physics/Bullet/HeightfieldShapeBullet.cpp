@@ -42,15 +42,7 @@ HeightfieldShapeBullet::HeightfieldShapeBullet(const resource::Proxy< hf::Height
 
 	// Check if we need to account for cuts in the heightfield;
 	// heightfields with no cuts are slightly faster to check.
-	const uint8_t* cuts = m_heightfield->getCuts();
-	for (int32_t i = 0; i < m_heightfield->getSize() * m_heightfield->getSize() / 8; ++i)
-	{
-		if (cuts[i] != 0xff)
-		{
-			m_haveCuts = true;
-			break;
-		}
-	}
+	m_haveCuts = m_heightfield->haveCuts();
 }
 
 HeightfieldShapeBullet::~HeightfieldShapeBullet()
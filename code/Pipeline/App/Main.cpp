@@ -15,6 +15,7 @@
 #include "Core/Io/Writer.h"
 #include "Core/Library/Library.h"
 #include "Core/Log/Log.h"
+#include "Core/Log/LogAsyncTarget.h"
 #include "Core/Log/LogRedirectTarget.h"
 #include "Core/Log/LogStreamTarget.h"
 #include "Core/Misc/AutoPtr.h"
@@ -161,6 +162,8 @@ LONG WINAPI exceptionVectoredHandler(struct _EXCEPTION_POINTERS* ep)
 		sw.ShowCallstack(GetCurrentThread(), ep->ContextRecord);
 	}
 
+	LogAsyncTarget::flushAll();
+
 	return EXCEPTION_CONTINUE_SEARCH;
 }
 
@@ -174,6 +177,7 @@ void signalExceptionHandler(int sig)
 	size_t size = backtrace(array, 10);
 	fprintf(stderr, "Error: signal %d:\n", sig);
 	backtrace_symbols_fd(array, size, STDERR_FILENO);
+	LogAsyncTarget::flushAll();
 	exit(1);	
 }
 
@@ -481,7 +485,9 @@ bool perform(const PipelineParameters& params)
 		pipelineDb,
 		sourceDatabaseAndCache.cache,
 		statusListener.ptr(),
-		params.getVerbose()
+		params.getVerbose(),
+		settings->getProperty< int32_t >(L"Pipeline.BuildThreads", 1),
+		(uint64_t)settings->getProperty< int32_t >(L"Pipeline.BuildMemoryCap", 0) * 1024 * 1024
 	);
 
 	if (params.getRebuild())
@@ -524,6 +530,10 @@ int standalone(const CommandLine& cmdLine)
 #endif
 
 	Ref< traktor::IStream > logFile;
+	std::wstring logFileName;
+
+	// Asynchronous logging replace console and file targets, threads are not blocked writing log.
+	const bool asyncLog = cmdLine.hasOption(L"async-log");
 
 	if (cmdLine.hasOption('l', L"log"))
 	{
@@ -563,7 +573,9 @@ int standalone(const CommandLine& cmdLine)
 		// Create new log file.
 		StringOutputStream ss;
 		ss << L"Pipeline_" << nextLogId << L".log";
-		if ((logFile = FileSystem::getInstance().open(ss.str(), File::FmWrite)) != nullptr)
+		logFileName = ss.str();
+		logFile = FileSystem::getInstance().open(logFileName, File::FmWrite);
+		if (logFile && !asyncLog)
 		{
 			Ref< FileOutputStream > logStream = new FileOutputStream(logFile, new Utf8Encoding());
 			Ref< LogStreamTarget > logStreamTarget = new LogStreamTarget(logStream);
@@ -572,12 +584,29 @@ int standalone(const CommandLine& cmdLine)
 			traktor::log::warning.setGlobalTarget(new LogRedirectTarget(logStreamTarget, traktor::log::warning.getGlobalTarget()));
 			traktor::log::error  .setGlobalTarget(new LogRedirectTarget(logStreamTarget, traktor::log::error  .getGlobalTarget()));
 
-			traktor::log::info << L"Log file \"" << ss.str() << L"\" created." << Endl;
+			traktor::log::info << L"Log file \"" << logFileName << L"\" created." << Endl;
 		}
-		else
+		else if (!logFile)
 			traktor::log::error << L"Unable to create log file; logging only to std pipes." << Endl;
 	}
 
+	Ref< ILogTarget > syncTargets[3];
+	Ref< LogAsyncTarget > asyncTarget;
+	if (asyncLog)
+	{
+		syncTargets[0] = traktor::log::info.getGlobalTarget();
+		syncTargets[1] = traktor::log::warning.getGlobalTarget();
+		syncTargets[2] = traktor::log::error.getGlobalTarget();
+
+		asyncTarget = new LogAsyncTarget(true, logFile);
+		traktor::log::info   .setGlobalTarget(asyncTarget);
+		traktor::log::warning.setGlobalTarget(asyncTarget);
+		traktor::log::error  .setGlobalTarget(asyncTarget);
+
+		if (logFile)
+			traktor::log::info << L"Log file \"" << logFileName << L"\" created." << Endl;
+	}
+
 	std::vector< Guid > roots;
 	if (cmdLine.getCount() > 0)
 	{
@@ -611,6 +640,16 @@ int standalone(const CommandLine& cmdLine)
 	bool success = perform(params);
 
 	traktor::log::info << L"Bye" << Endl;
+
+	// Restore synchronous targets, pending lines are written when asynchronous target is destroyed.
+	if (asyncTarget)
+	{
+		traktor::log::info   .setGlobalTarget(syncTargets[0]);
+		traktor::log::warning.setGlobalTarget(syncTargets[1]);
+		traktor::log::error  .setGlobalTarget(syncTargets[2]);
+		asyncTarget = nullptr;
+	}
+
 	return success ? 0 : 1;
 }
 
@@ -635,6 +674,7 @@ int main(int argc, const char** argv)
 
 		CommandLine cmdLine(argc, argv);
 		result = standalone(cmdLine);
+		LogAsyncTarget::flushAll();
 
 #if defined(_WIN32) && !defined(_DEBUG)
 		RemoveVectoredExceptionHandler(eh);
@@ -656,6 +696,7 @@ int main(int argc, const char** argv)
 #	else
 		log::error << L"Unhandled exception occurred." << Endl;
 #	endif
+		LogAsyncTarget::flushAll();
 	}
 #endif
 
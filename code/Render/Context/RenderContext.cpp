@@ -7,7 +7,10 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include "Core/Memory/Alloc.h"
+#include "Core/Thread/Acquire.h"
 #include "Render/Context/RenderContext.h"
 
 #if defined(_DEBUG)
@@ -21,26 +24,94 @@ namespace traktor::render
 	{
 
 const float c_distanceQuantizeRangeInv = 1.0f / 10.0f;
+const uint32_t c_childPageSize = 64 * 1024;
 
-T_FORCE_INLINE bool SortOpaquePredicate(const DrawableRenderBlock* renderBlock1, const DrawableRenderBlock* renderBlock2)
+/*! Map float onto unsigned integer with same ordering. */
+T_FORCE_INLINE uint32_t sortableFloat(float value)
+{
+	uint32_t u;
+	std::memcpy(&u, &value, sizeof(u));
+	return (u & 0x80000000) ? ~u : (u | 0x80000000);
+}
+
+/*! Hash program pointer into 32 bits; only used to group blocks with same program. */
+T_FORCE_INLINE uint32_t programKey(const IProgram* program)
+{
+	uint64_t p = (uint64_t)(uintptr_t)program;
+	p ^= p >> 33;
+	p *= 0xff51afd7ed558ccdULL;
+	p ^= p >> 33;
+	return (uint32_t)p;
+}
+
+/*! Opaque blocks are sorted front-to-back by distance bucket, then grouped by program. */
+T_FORCE_INLINE uint64_t opaqueKey(const DrawableRenderBlock* renderBlock)
 {
 // Don't sort front-to-back on iOS as it's a TDBR architecture thus
 // we focus on minimizing state changes on the CPU instead.
 #if !defined(__IOS__)
-	const float d1 = std::floor(renderBlock1->distance * c_distanceQuantizeRangeInv);
-	const float d2 = std::floor(renderBlock2->distance * c_distanceQuantizeRangeInv);
-	if (d1 < d2)
-		return true;
-	else if (d1 > d2)
-		return false;
+	const uint64_t bucket = sortableFloat(std::floor(renderBlock->distance * c_distanceQuantizeRangeInv));
+	return (bucket << 32) | programKey(renderBlock->program);
+#else
+	return programKey(renderBlock->program);
 #endif
+}
 
-	return renderBlock1->program < renderBlock2->program;
+/*! Alpha blend blocks are sorted back-to-front. */
+T_FORCE_INLINE uint64_t alphaBlendKey(const DrawableRenderBlock* renderBlock)
+{
+	return ~sortableFloat(renderBlock->distance);
 }
 
-T_FORCE_INLINE bool SortAlphaBlendPredicate(const DrawableRenderBlock* renderBlock1, const DrawableRenderBlock* renderBlock2)
+/*! Stable LSD radix sort on 64-bit keys, 8 bits per pass.
+ *
+ * Passes where all keys share the same digit are skipped,
+ * thus typically only a few passes are performed.
+ */
+template < typename ItemType >
+void radixSort(AlignedVector< ItemType >& items, AlignedVector< ItemType >& temp)
 {
-	return renderBlock1->distance > renderBlock2->distance;
+	const uint32_t count = (uint32_t)items.size();
+	if (count <= 1)
+		return;
+
+	uint32_t histograms[8][256];
+	std::memset(histograms, 0, sizeof(histograms));
+	for (const auto& item : items)
+	{
+		for (uint32_t pass = 0; pass < 8; ++pass)
+			histograms[pass][(item.key >> (pass * 8)) & 0xff]++;
+	}
+
+	temp.resize(count);
+
+	ItemType* src = items.ptr();
+	ItemType* dst = temp.ptr();
+
+	for (uint32_t pass = 0; pass < 8; ++pass)
+	{
+		const uint32_t shift = pass * 8;
+		uint32_t* histogram = histograms[pass];
+
+		if (histogram[(src[0].key >> shift) & 0xff] == count)
+			continue;
+
+		uint32_t offset = 0;
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			const uint32_t n = histogram[i];
+			histogram[i] = offset;
+			offset += n;
+		}
+
+		for (uint32_t i = 0; i < count; ++i)
+			dst[histogram[(src[i].key >> shift) & 0xff]++] = src[i];
+
+		std::swap(src, dst);
+	}
+
+	if (src != items.ptr())
+		items.swap(temp);
 }
 
 	}
@@ -50,6 +121,8 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.render.RenderContext", RenderContext, Object)
 RenderContext::RenderContext(uint32_t heapSize)
 :	m_heapEnd(nullptr)
 ,	m_heapPtr(nullptr)
+,	m_parent(nullptr)
+,	m_childCount(0)
 {
 	m_heap.reset(static_cast< uint8_t* >(Alloc::acquireAlign(heapSize, 16, T_FILE_LINE)));
 	T_FATAL_ASSERT_M(m_heap.ptr(), L"Out of memory (Render context)");
@@ -57,16 +130,29 @@ RenderContext::RenderContext(uint32_t heapSize)
 	m_heapPtr = m_heap.ptr();
 }
 
+RenderContext::RenderContext(RenderContext* parent)
+:	m_heapEnd(nullptr)
+,	m_heapPtr(nullptr)
+,	m_parent(parent)
+,	m_childCount(0)
+{
+}
+
 RenderContext::~RenderContext()
 {
 	flush();
+	m_children.clear();
 	m_heap.release();
 }
 
 void* RenderContext::alloc(uint32_t blockSize)
 {
 	if (m_heapPtr + blockSize >= m_heapEnd)
-		T_FATAL_ERROR;
+	{
+		if (!m_parent)
+			T_FATAL_ERROR;
+		acquirePage(blockSize);
+	}
 
 	void* ptr = m_heapPtr;
 	m_heapPtr += blockSize;
@@ -77,6 +163,8 @@ void* RenderContext::alloc(uint32_t blockSize)
 void* RenderContext::alloc(uint32_t blockSize, uint32_t align)
 {
 	T_ASSERT(align > 0);
+	if (m_parent && alignUp(m_heapPtr, align) + blockSize >= m_heapEnd)
+		acquirePage(blockSize + align);
 	m_heapPtr = alignUp(m_heapPtr, align);
 	return alloc(blockSize);
 }
@@ -107,8 +195,46 @@ void RenderContext::draw(uint32_t type, DrawableRenderBlock* renderBlock)
 		m_priorityQueue[5].push_back(renderBlock);
 }
 
+RenderContext* RenderContext::acquireChild()
+{
+	T_FATAL_ASSERT_M(m_parent == nullptr, L"Cannot acquire child of child context");
+	if (m_childCount >= m_children.size())
+		m_children.push_back(new RenderContext(this));
+	return m_children[m_childCount++];
+}
+
+void RenderContext::mergeChildren()
+{
+	for (uint32_t i = 0; i < m_childCount; ++i)
+	{
+		RenderContext* child = m_children[i];
+
+		// Blocks are allocated from our heap so we take ownership of blocks as well.
+		m_computeQueue.insert(m_computeQueue.end(), child->m_computeQueue.begin(), child->m_computeQueue.end());
+		child->m_computeQueue.resize(0);
+
+		for (int32_t j = 0; j < sizeof_array(m_priorityQueue); ++j)
+		{
+			m_priorityQueue[j].insert(m_priorityQueue[j].end(), child->m_priorityQueue[j].begin(), child->m_priorityQueue[j].end());
+			child->m_priorityQueue[j].resize(0);
+		}
+
+		m_drawQueue.insert(m_drawQueue.end(), child->m_drawQueue.begin(), child->m_drawQueue.end());
+		child->m_drawQueue.resize(0);
+
+		// Remaining space of child's page is lost until we're flushed.
+		child->m_heapPtr = nullptr;
+		child->m_heapEnd = nullptr;
+	}
+	m_childCount = 0;
+}
+
 void RenderContext::mergePriorityIntoDraw(uint32_t priorities)
 {
+	// Ensure any pending children are merged first.
+	if (m_childCount > 0)
+		mergeChildren();
+
 	// Merge setup blocks unsorted.
 	if (priorities & RenderPriority::Setup)
 	{
@@ -119,33 +245,25 @@ void RenderContext::mergePriorityIntoDraw(uint32_t priorities)
 	// Merge opaque blocks, sorted by shader.
 	if (priorities & RenderPriority::Opaque)
 	{
-		std::sort(m_priorityQueue[1].begin(), m_priorityQueue[1].end(), SortOpaquePredicate);
-		m_drawQueue.insert(m_drawQueue.end(), m_priorityQueue[1].begin(), m_priorityQueue[1].end());
-		m_priorityQueue[1].resize(0);
+		mergeSorted(m_priorityQueue[1], false);
 	}
 
 	// Merge post opaque blocks, sorted by shader.
 	if (priorities & RenderPriority::PostOpaque)
 	{
-		std::sort(m_priorityQueue[2].begin(), m_priorityQueue[2].end(), SortOpaquePredicate);
-		m_drawQueue.insert(m_drawQueue.end(), m_priorityQueue[2].begin(), m_priorityQueue[2].end());
-		m_priorityQueue[2].resize(0);
+		mergeSorted(m_priorityQueue[2], false);
 	}
 
 	// Merge alpha blend blocks back to front.
 	if (priorities & RenderPriority::AlphaBlend)
 	{
-		std::sort(m_priorityQueue[3].begin(), m_priorityQueue[3].end(), SortAlphaBlendPredicate);
-		m_drawQueue.insert(m_drawQueue.end(), m_priorityQueue[3].begin(), m_priorityQueue[3].end());
-		m_priorityQueue[3].resize(0);
+		mergeSorted(m_priorityQueue[3], true);
 	}
 
 	// Merge post alpha blend blocks back to front.
 	if (priorities & RenderPriority::PostAlphaBlend)
 	{
-		std::sort(m_priorityQueue[4].begin(), m_priorityQueue[4].end(), SortAlphaBlendPredicate);
-		m_drawQueue.insert(m_drawQueue.end(), m_priorityQueue[4].begin(), m_priorityQueue[4].end());
-		m_priorityQueue[4].resize(0);
+		mergeSorted(m_priorityQueue[4], true);
 	}
 
 	// Merge overlay blocks unsorted.
@@ -183,6 +301,10 @@ void RenderContext::render(IRenderView* renderView) const
 
 void RenderContext::flush()
 {
+	// Take ownership of blocks recorded by children.
+	if (m_childCount > 0)
+		mergeChildren();
+
 	// Reset queues and heap.
 	for (int32_t i = 0; i < sizeof_array(m_priorityQueue); ++i)
 	{
@@ -207,9 +329,43 @@ void RenderContext::flush()
 	m_drawQueue.resize(0);
 	m_renderQueue.resize(0);
 
+	// Children need to acquire a new page from parent.
+	if (m_parent)
+		m_heapEnd = nullptr;
+
 	m_heapPtr = m_heap.ptr();
 }
 
+void* RenderContext::allocPage(uint32_t pageSize)
+{
+	T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_heapLock);
+	return alloc(pageSize, 16);
+}
+
+void RenderContext::acquirePage(uint32_t minimumSize)
+{
+	const uint32_t pageSize = std::max(alignUp(minimumSize + 1, 16), c_childPageSize);
+	m_heapPtr = static_cast< uint8_t* >(m_parent->allocPage(pageSize));
+	m_heapEnd = m_heapPtr + pageSize;
+}
+
+void RenderContext::mergeSorted(AlignedVector< DrawableRenderBlock* >& queue, bool alphaBlend)
+{
+	m_sortItems.resize(queue.size());
+	for (uint32_t i = 0; i < (uint32_t)queue.size(); ++i)
+	{
+		m_sortItems[i].key = alphaBlend ? alphaBlendKey(queue[i]) : opaqueKey(queue[i]);
+		m_sortItems[i].renderBlock = queue[i];
+	}
+
+	radixSort(m_sortItems, m_sortTemp);
+
+	for (const auto& item : m_sortItems)
+		m_drawQueue.push_back(item.renderBlock);
+
+	queue.resize(0);
+}
+
 bool RenderContext::havePendingComputes() const
 {
 	return !m_computeQueue.empty();
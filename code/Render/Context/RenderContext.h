@@ -9,10 +9,12 @@
 #pragma once
 
 #include "Core/Object.h"
+#include "Core/RefArray.h"
 #include "Core/Containers/AlignedVector.h"
 #include "Core/Math/Matrix44.h"
 #include "Core/Math/Vector4.h"
 #include "Core/Misc/AutoPtr.h"
+#include "Core/Thread/SpinLock.h"
 #include "Render/Context/ProgramParameters.h"
 #include "Render/Context/RenderBlock.h"
 
@@ -34,6 +36,11 @@ class IRenderView;
  *
  * A render context is used to defer rendering in a
  * multi-threaded renderer.
+ *
+ * Child contexts can be acquired in order to record
+ * blocks from multiple threads concurrently, each child
+ * allocate pages from the parent's heap and must be
+ * merged back into the parent before queues are merged.
  */
 class T_DLLCLASS RenderContext : public Object
 {
@@ -92,6 +99,21 @@ public:
 	/*! Add render block to sorting queue. */
 	void draw(uint32_t type, DrawableRenderBlock* renderBlock);
 
+	/*! Acquire child context.
+	 *
+	 * Children are intended to be recorded in parallel,
+	 * one child per thread. Children must be acquired from the
+	 * thread owning this context and before any child is recorded.
+	 */
+	RenderContext* acquireChild();
+
+	/*! Merge queues of all acquired children into this context.
+	 *
+	 * Children are merged in the order they was acquired
+	 * and are released back to this context.
+	 */
+	void mergeChildren();
+
 	/*! Merge sorting queues into draw queue. */
 	void mergePriorityIntoDraw(uint32_t priorities);
 
@@ -117,13 +139,33 @@ public:
 	uint32_t getAllocatedSize() const { return uint32_t(m_heapPtr - m_heap.c_ptr()); }
 
 private:
+	struct SortItem
+	{
+		uint64_t key;
+		DrawableRenderBlock* renderBlock;
+	};
+
 	AutoPtr< uint8_t, AllocFreeAlign > m_heap;
 	uint8_t* m_heapEnd;
 	uint8_t* m_heapPtr;
+	SpinLock m_heapLock;
+	RenderContext* m_parent;
+	RefArray< RenderContext > m_children;
+	uint32_t m_childCount;
 	AlignedVector< RenderBlock* > m_computeQueue;
 	AlignedVector< DrawableRenderBlock* > m_priorityQueue[6];
 	AlignedVector< RenderBlock* > m_drawQueue;
 	AlignedVector< RenderBlock* > m_renderQueue;
+	AlignedVector< SortItem > m_sortItems;
+	AlignedVector< SortItem > m_sortTemp;
+
+	explicit RenderContext(RenderContext* parent);
+
+	void* allocPage(uint32_t pageSize);
+
+	void acquirePage(uint32_t minimumSize);
+
+	void mergeSorted(AlignedVector< DrawableRenderBlock* >& queue, bool alphaBlend);
 };
 
 }
@@ -10,6 +10,7 @@
 
 #include "Core/Log/Log.h"
 #include "Core/Misc/ObjectStore.h"
+#include "Core/Thread/Acquire.h"
 #include "Core/Thread/JobManager.h"
 #include "Database/Instance.h"
 #include "Render/IProgram.h"
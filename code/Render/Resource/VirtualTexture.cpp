@@ -82,7 +82,7 @@ ITexture* VirtualTexture::resolve()
 	if (!m_highQualityLoadedOrPending)
 	{
 		m_highQualityLoadedOrPending = true;
-		JobManager::getInstance().add([this]() {
+		JobManager::getInstance().addDetached([this]() {
 			loadHighQuality();
 		});
 	}
@@ -0,0 +1,135 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cmath>
+#include "Core/Log/Log.h"
+#include "Core/System/OS.h"
+#include "Core/Thread/JobQueue.h"
+#include "Core/Timer/Timer.h"
+#include "Render/Context/RenderContext.h"
+#include "Render/Test/CaseRenderContext.h"
+
+namespace traktor::render::test
+{
+	namespace
+	{
+
+const uint32_t c_blockCount = 200000;
+const uint32_t c_programCount = 64;
+
+class TestRenderBlock : public DrawableRenderBlock
+{
+public:
+	AlignedVector< const TestRenderBlock* >* rendered = nullptr;
+	bool alphaBlend = false;
+
+	virtual void render(IRenderView* renderView) const override final
+	{
+		rendered->push_back(this);
+	}
+};
+
+void record(RenderContext* renderContext, uint32_t from, uint32_t to, AlignedVector< const TestRenderBlock* >* rendered)
+{
+	for (uint32_t i = from; i < to; ++i)
+	{
+		const uint32_t hash = i * 2654435761U;
+		auto renderBlock = renderContext->alloc< TestRenderBlock >();
+		renderBlock->rendered = rendered;
+		renderBlock->alphaBlend = (hash % 10) == 0;
+		renderBlock->distance = float(hash % 100000) / 100.0f;
+		renderBlock->program = (IProgram*)(uintptr_t)(0x10000 + (hash % c_programCount) * 64);
+		renderContext->draw(renderBlock->alphaBlend ? RenderPriority::AlphaBlend : RenderPriority::Opaque, renderBlock);
+	}
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.render.test.CaseRenderContext", 0, CaseRenderContext, traktor::test::Case)
+
+void CaseRenderContext::run()
+{
+	const uint32_t coreCount = std::max< uint32_t >(OS::getInstance().getCPUCoreCount(), 4);
+
+	Ref< RenderContext > renderContext = new RenderContext(64 * 1024 * 1024);
+	AlignedVector< const TestRenderBlock* > rendered;
+	rendered.reserve(c_blockCount);
+
+	for (uint32_t threadCount = 1; threadCount <= coreCount; threadCount *= 2)
+	{
+		JobQueue queue;
+		if (!queue.create(threadCount - 1, Thread::Normal))
+		{
+			CASE_ASSERT(false);
+			return;
+		}
+
+		Timer timer;
+
+		// Record blocks into one child per thread.
+		const double recordStart = timer.getElapsedTime();
+		{
+			AlignedVector< Job::task_t > tasks;
+			for (uint32_t i = 0; i < threadCount; ++i)
+			{
+				RenderContext* child = renderContext->acquireChild();
+				const uint32_t from = (c_blockCount * i) / threadCount;
+				const uint32_t to = (c_blockCount * (i + 1)) / threadCount;
+				tasks.push_back([=, &rendered](){ record(child, from, to, &rendered); });
+			}
+			queue.fork(tasks.c_ptr(), tasks.size());
+			renderContext->mergeChildren();
+		}
+		const double recordTime = timer.getElapsedTime() - recordStart;
+
+		// Sort and merge into draw queue.
+		const double mergeStart = timer.getElapsedTime();
+		renderContext->mergePriorityIntoDraw(RenderPriority::All);
+		const double mergeTime = timer.getElapsedTime() - mergeStart;
+
+		renderContext->mergeDrawIntoRender();
+
+		rendered.resize(0);
+		renderContext->render(nullptr);
+		CASE_ASSERT_EQUAL((uint32_t)rendered.size(), c_blockCount);
+
+		// Opaque blocks are rendered front-to-back, alpha blended back-to-front.
+		uint32_t errors = 0;
+		for (uint32_t i = 1; i < (uint32_t)rendered.size(); ++i)
+		{
+			const TestRenderBlock* a = rendered[i - 1];
+			const TestRenderBlock* b = rendered[i];
+			if (a->alphaBlend != b->alphaBlend)
+			{
+				if (a->alphaBlend)
+					errors++;
+			}
+			else if (!a->alphaBlend)
+			{
+				const float da = std::floor(a->distance / 10.0f);
+				const float db = std::floor(b->distance / 10.0f);
+				if (da > db)
+					errors++;
+			}
+			else if (a->distance < b->distance)
+				errors++;
+		}
+		CASE_ASSERT_EQUAL(errors, 0);
+
+		renderContext->flush();
+
+		log::info << L"Render context, " << threadCount << L" thread(s); record " << int32_t(recordTime * 1000.0) << L" ms, merge " << int32_t(mergeTime * 1000.0) << L" ms" << Endl;
+
+		queue.destroy();
+	}
+
+	renderContext = nullptr;
+}
+
+}
@@ -71,7 +71,10 @@ void* BufferVrfy::lock()
 	if (m_device)
 	{
 		m_locked = true;
+
+		// Preserve buffer content as callers might only update parts of the buffer.
 		std::memset(m_shadow, 0, getBufferSize() + 2 * c_guardBytes);
+		std::memcpy(m_shadow + c_guardBytes, m_device, getBufferSize());
 		return m_shadow + c_guardBytes;
 	}
 	else
@@ -87,6 +87,17 @@ public:
 	 */
 	virtual bool isCacheable(const TypeInfo& productType) const = 0;
 
+	/*! Check if factory is thread safe.
+	 *
+	 * A thread safe factory can create multiple products
+	 * concurrently, thus resources streamed asynchronously
+	 * are created in parallel. Non thread safe factories
+	 * are serialized by the resource manager.
+	 *
+	 * \return True if factory is thread safe.
+	 */
+	virtual bool isThreadSafe() const { return false; }
+
 	/*! Create resource from guid.
 	 *
 	 * Create a specified resource from a guid.
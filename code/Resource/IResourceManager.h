@@ -34,8 +34,16 @@ class ResourceHandle;
  */
 struct ResourceManagerStatistics
 {
+	enum { LatencyBuckets = 8 };
+
 	uint32_t residentCount = 0;		//!< Number of resident resources.
 	uint32_t exclusiveCount = 0;	//!< Number of exclusive (non-shareable) resources.
+	uint32_t queuedCount = 0;		//!< Number of streaming requests waiting in queue.
+	uint32_t streamingCount = 0;	//!< Number of streaming requests being created.
+	uint32_t streamedCount = 0;		//!< Total number of streamed resources.
+	uint32_t cancelledCount = 0;	//!< Total number of cancelled streaming requests.
+	float streamedPerSecond = 0.0f;	//!< Streaming throughput, in resources per second, since last statistics query.
+	uint32_t latencyHistogram[LatencyBuckets] = { 0 };	//!< Streaming latency; bucket N count requests completed within 2^N ms, last bucket count all slower.
 };
 
 /*! Resource manager interface.
@@ -78,6 +86,29 @@ public:
 	 */
 	virtual Ref< ResourceHandle > bind(const TypeInfo& productType, const Guid& guid) = 0;
 
+	/*! Bind handle to resource identifier asynchronously.
+	 *
+	 * Handle is returned immediately in a pending state and the
+	 * resource is created by the job system; requests with higher
+	 * priority are created first. Binding an already pending
+	 * resource raise the priority of the queued request.
+	 *
+	 * \param productType Type of product.
+	 * \param guid Resource identifier.
+	 * \param priority Request priority, higher is more urgent.
+	 * \return Resource handle.
+	 */
+	virtual Ref< ResourceHandle > bindAsync(const TypeInfo& productType, const Guid& guid, int32_t priority) = 0;
+
+	/*! Cancel pending asynchronous bind.
+	 *
+	 * Requests which are already being created cannot be cancelled.
+	 *
+	 * \param handle Resource handle returned from bindAsync.
+	 * \return True if request was cancelled.
+	 */
+	virtual bool cancel(ResourceHandle* handle) = 0;
+
 	/*! Reload resource.
 	 *
 	 * \param guid Resource identifier.
@@ -128,6 +159,26 @@ public:
 		return bool(handle->get() != nullptr);
 	}
 
+	/*! Bind handle to resource identifier asynchronously.
+	 *
+	 * \param id Resource identifier.
+	 * \param priority Request priority, higher is more urgent.
+	 * \return True if proxy bound, resource might still be pending.
+	 */
+	template <
+		typename ResourceType,
+		typename ProductType
+	>
+	bool bindAsync(const Id< ResourceType >& id, Proxy< ProductType >& outProxy, int32_t priority = 0)
+	{
+		Ref< ResourceHandle > handle = bindAsync(type_of< ProductType >(), id, priority);
+		if (!handle)
+			return false;
+
+		outProxy = Proxy< ProductType >(handle);
+		return true;
+	}
+
 	/*! Bind handle to resource identifier.
 	 *
 	 * \param proxy Resource identifier proxy.
@@ -31,6 +31,16 @@ Ref< ResourceHandle > IResourceManager_bind(IResourceManager* self, const TypeIn
 		return nullptr;
 }
 
+Ref< ResourceHandle > IResourceManager_bindAsync(IResourceManager* self, const TypeInfo& type, const Any& id, int32_t priority)
+{
+	if (CastAny< Guid >::accept(id))
+		return self->bindAsync(type, CastAny< Guid >::get(id), priority);
+	else if (id.isString())
+		return self->bindAsync(type, Guid(id.getWideString()), priority);
+	else
+		return nullptr;
+}
+
 void IResourceManager_reload(IResourceManager* self, const Any& guidOrType, bool flushedOnly)
 {
 	if (CastAny< Guid >::accept(guidOrType))
@@ -62,6 +72,7 @@ void ResourceClassFactory::createClasses(IRuntimeClassRegistrar* registrar) cons
 	classIResourceHandle->addMethod("replace", &ResourceHandle::replace);
 	classIResourceHandle->addMethod("get", &ResourceHandle::get);
 	classIResourceHandle->addMethod("flush", &ResourceHandle::flush);
+	classIResourceHandle->addMethod("pending", &ResourceHandle::pending);
 	registrar->registerClass(classIResourceHandle);
 
 	auto classIResourceManager = new AutoRuntimeClass< IResourceManager >();
@@ -70,6 +81,8 @@ void ResourceClassFactory::createClasses(IRuntimeClassRegistrar* registrar) cons
 	classIResourceManager->addMethod("removeAllFactories", &IResourceManager::removeAllFactories);
 	classIResourceManager->addMethod("load", &IResourceManager::load);
 	classIResourceManager->addMethod("bind", &IResourceManager_bind);
+	classIResourceManager->addMethod("bindAsync", &IResourceManager_bindAsync);
+	classIResourceManager->addMethod("cancel", &IResourceManager::cancel);
 	classIResourceManager->addMethod("reload", &IResourceManager_reload);
 	classIResourceManager->addMethod("unload", &IResourceManager::unload);
 	classIResourceManager->addMethod("unloadUnusedResident", &IResourceManager::unloadUnusedResident);
@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include "Core/Object.h"
 #include "Core/Ref.h"
 
@@ -46,8 +47,24 @@ public:
 	 */
 	void flush() { m_object = nullptr; }
 
+	/*! Set if resource is pending, ie being streamed.
+	 *
+	 * \param pending True if resource is pending.
+	 */
+	void setPending(bool pending) { m_pending = pending; }
+
+	/*! Check if resource is pending.
+	 *
+	 * A pending handle has been bound asynchronously and
+	 * the resource object has not yet been created.
+	 *
+	 * \return True if resource is pending.
+	 */
+	bool pending() const { return m_pending; }
+
 protected:
 	mutable Ref< Object > m_object;
+	std::atomic< bool > m_pending = false;
 };
 
 }
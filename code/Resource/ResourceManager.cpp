@@ -9,6 +9,7 @@
 #include <algorithm>
 #include "Core/Log/Log.h"
 #include "Core/Thread/Acquire.h"
+#include "Core/Thread/JobManager.h"
 #include "Core/Thread/Thread.h"
 #include "Core/Thread/ThreadManager.h"
 #include "Database/Database.h"
@@ -22,12 +23,38 @@
 namespace traktor::resource
 {
 
+/*! Queued asynchronous bind request. */
+struct ResourceManager::Request
+{
+	Ref< db::Instance > instance;
+	Ref< const IResourceFactory > factory;
+	const TypeInfo* productType = nullptr;
+	Ref< ResourceHandle > handle;
+	int32_t priority = 0;
+	uint32_t sequence = 0;
+	double queued = 0.0;
+
+	/*! Heap order; highest priority first, then in order of request. */
+	bool operator < (const Request& rh) const
+	{
+		if (priority != rh.priority)
+			return priority < rh.priority;
+		return sequence > rh.sequence;
+	}
+};
+
 T_IMPLEMENT_RTTI_CLASS(L"traktor.resource.ResourceManager", ResourceManager, IResourceManager)
 
 ResourceManager::ResourceManager(db::Database* database, bool verbose)
 :	m_database(database)
 ,	m_verbose(verbose)
+,	m_streaming(0)
+,	m_streamedCount(0)
+,	m_cancelledCount(0)
 {
+	for (auto& bucket : m_latencyHistogram)
+		bucket = 0;
+	m_timer.reset();
 }
 
 ResourceManager::~ResourceManager()
@@ -37,6 +64,16 @@ ResourceManager::~ResourceManager()
 
 void ResourceManager::destroy()
 {
+	// Discard queued requests and wait until those in flight has finished.
+	{
+		T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_requestsLock);
+		for (auto& request : m_requests)
+			request.handle->setPending(false);
+		m_requests.clear();
+	}
+	while (m_streaming > 0)
+		ThreadManager::getInstance().getCurrentThread()->yield();
+
 	for (auto& residentHandle : m_residentHandles)
 		residentHandle.second->replace(nullptr);
 
@@ -74,76 +111,80 @@ void ResourceManager::removeAllFactories()
 
 bool ResourceManager::load(const ResourceBundle* bundle)
 {
-	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
-	for (const auto& resource : bundle->get())
+	const auto& resources = bundle->get();
+	const bool persistent = bundle->persistent();
+	std::atomic< bool > result = true;
+
+	// Preload all resources in parallel; non thread safe factories
+	// are still serialized when creating the products.
+	AlignedVector< Job::task_t > tasks;
+	tasks.reserve(resources.size());
+	for (const auto& resource : resources)
 	{
-		// Get resource instance from database.
-		Ref< db::Instance > instance = m_database->getInstance(resource.second);
-		if (!instance)
-		{
-			log::error << L"Unable to preload resource " << resource.second.format() << L"; no such instance." << Endl;
-			return false;
-		}
+		tasks.push_back([&, this]() {
+			if (!preload(*resource.first, resource.second, persistent))
+				result = false;
+		});
+	}
+	JobManager::getInstance().fork(tasks.c_ptr(), tasks.size());
 
-		// Get type of resource.
-		const TypeInfo* resourceType = instance->getPrimaryType();
-		if (!resourceType)
-		{
-			log::error << L"Unable to preload resource " << resource.second.format() << L"; unable to read resource type." << Endl;
-			return false;
-		}
+	return result;
+}
 
-		// Find factory which can create products from resource.
-		const IResourceFactory* factory = findFactory(*resourceType);
-		if (!factory)
-		{
-			log::error << L"Unable to preload resource " << resource.second.format() << L"; no factory for specified resource type \"" << resourceType->getName() << L"\"." << Endl;
-			return false;
-		}
+Ref< ResourceHandle > ResourceManager::bind(const TypeInfo& productType, const Guid& guid)
+{
+	Ref< ResourceHandle > handle;
 
-		// Determine product type; must be explicitly determined if we can safely preload the resource.
-		const TypeInfoSet productTypes = factory->getProductTypes(*resourceType);
-		if (productTypes.size() != 1)
-		{
-			log::warning << L"Unable to preload resource " << resource.second.format() << L"; unable to determine product type, skipped." << Endl;
-			continue;
-		}
+	if (guid.isNull() || !guid.isValid())
+	{
+		if (!guid.isNull())
+			log::error << L"Unable to bind a " << productType.getName() << L" resource; invalid id." << Endl;
+		return nullptr;
+	}
 
-		const bool cacheable = factory->isCacheable(*resource.first);
-		if (!cacheable)
-		{
-			log::warning << L"Unable to preload resource " << resource.second.format() << L"; resource non cacheable, skipped." << Endl;
-			continue;
-		}
+	// Get resource instance from database.
+	Ref< db::Instance > instance = m_database->getInstance(guid);
+	if (!instance)
+	{
+		log::error << L"Unable to bind a " << productType.getName() << L" resource; no such instance (" << guid.format() << L")." << Endl;
+		return nullptr;
+	}
 
-		Ref< ResidentResourceHandle > residentHandle = m_residentHandles[resource.second];
-		if (residentHandle == nullptr || residentHandle->get() == nullptr)
-		{
-			const TypeInfo& productType = *(*productTypes.begin());
+	// Get type of resource.
+	const TypeInfo* resourceType = instance->getPrimaryType();
+	if (!resourceType)
+	{
+		log::error << L"Unable to bind a " << productType.getName() << L" resource; unable to read resource type (" << guid.format() << L")." << Endl;
+		return nullptr;
+	}
 
-			if (!residentHandle)
-			{
-				residentHandle = new ResidentResourceHandle(productType, bundle->persistent());
-				m_residentHandles[resource.second] = residentHandle;
-			}
+	// Find factory which can create products from resource.
+	const IResourceFactory* factory = findFactory(*resourceType);
+	if (!factory)
+	{
+		log::error << L"Unable to bind a " << productType.getName() << L" resource; no factory for instance type \"" << resourceType->getName() << L"\" (" << guid.format() << L")." << Endl;
+		return nullptr;
+	}
 
-			load(instance, factory, productType, residentHandle);
+	// Create resource handle.
+	handle = acquireHandle(productType, guid, factory);
+	T_ASSERT(handle);
 
-			if (!residentHandle->get())
-			{
-				log::error << L"Unable to preload resource " << resource.second.format() << L"; skipped." << Endl;
-				continue;
-			}
-		}
+	// If no resource loaded into handle then load resource through factory; if
+	// resource is queued for streaming then we load it immediately instead.
+	if (!handle->get())
+	{
+		const bool claimed = claim(handle);
+		load(instance, factory, productType, handle);
+		if (claimed)
+			unclaim(handle);
 	}
 
-	return true;
+	return handle;
 }
 
-Ref< ResourceHandle > ResourceManager::bind(const TypeInfo& productType, const Guid& guid)
+Ref< ResourceHandle > ResourceManager::bindAsync(const TypeInfo& productType, const Guid& guid, int32_t priority)
 {
-	Ref< ResourceHandle > handle;
-
 	if (guid.isNull() || !guid.isValid())
 	{
 		if (!guid.isNull())
@@ -151,7 +192,8 @@ Ref< ResourceHandle > ResourceManager::bind(const TypeInfo& productType, const G
 		return nullptr;
 	}
 
-	// Get resource instance from database.
+	// Get resource instance from database; only meta data is read here, the
+	// resource object and it's data is read by the factory on the job system.
 	Ref< db::Instance > instance = m_database->getInstance(guid);
 	if (!instance)
 	{
@@ -175,52 +217,74 @@ Ref< ResourceHandle > ResourceManager::bind(const TypeInfo& productType, const G
 		return nullptr;
 	}
 
-	// Create resource handle.
-	const bool cacheable = factory->isCacheable(productType);
-	if (cacheable)
-	{
-		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
-		auto it = m_residentHandles.find(guid);
-		if (it != m_residentHandles.end())
-			handle = it->second;
-		else
-		{
-			Ref< ResidentResourceHandle > residentHandle = new ResidentResourceHandle(productType, false);
-			m_residentHandles[guid] = residentHandle;
-			handle = residentHandle;
-		}
-	}
-	else
+	Ref< ResourceHandle > handle = acquireHandle(productType, guid, factory);
+	T_ASSERT(handle);
+
+	if (handle->get())
+		return handle;
+
 	{
-		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
-		RefArray< ExclusiveResourceHandle >& handles = m_exclusiveHandles[guid];
+		T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_requestsLock);
 
-		// First try to reuse handles which are no longer in use.
-		for (auto h : handles)
+		// Already pending; raise priority of queued request if necessary.
+		if (handle->pending())
 		{
-			if (!h->get())
+			for (auto& request : m_requests)
 			{
-				handle = h;
-				break;
+				if (request.handle == handle)
+				{
+					if (priority > request.priority)
+					{
+						request.priority = priority;
+						std::make_heap(m_requests.begin(), m_requests.end());
+					}
+					break;
+				}
 			}
+			return handle;
 		}
 
-		if (!handle)
-		{
-			Ref< ExclusiveResourceHandle > exclusiveHandle = new ExclusiveResourceHandle(productType);
-			handles.push_back(exclusiveHandle);
-			handle = exclusiveHandle;
-		}
+		Request& request = m_requests.push_back();
+		request.instance = instance;
+		request.factory = factory;
+		request.productType = &productType;
+		request.handle = handle;
+		request.priority = priority;
+		request.sequence = m_sequence++;
+		request.queued = m_timer.getElapsedTime();
+		std::push_heap(m_requests.begin(), m_requests.end());
+
+		handle->setPending(true);
 	}
-	T_ASSERT(handle);
 
-	// If no resource loaded into handle then load resource through factory.
-	if (!handle->get())
-		load(instance, factory, productType, handle);
+	// Each job pick the most urgent request when executed, not necessarily
+	// the request which was added; keep manager alive until job has finished.
+	Ref< ResourceManager > self = this;
+	m_streaming++;
+	JobManager::getInstance().addDetached([=]() {
+		self->stream();
+	});
 
 	return handle;
 }
 
+bool ResourceManager::cancel(ResourceHandle* handle)
+{
+	T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_requestsLock);
+	for (auto it = m_requests.begin(); it != m_requests.end(); ++it)
+	{
+		if (it->handle == handle)
+		{
+			m_requests.erase(it);
+			std::make_heap(m_requests.begin(), m_requests.end());
+			handle->setPending(false);
+			m_cancelledCount++;
+			return true;
+		}
+	}
+	return false;
+}
+
 bool ResourceManager::reload(const Guid& guid, bool flushedOnly)
 {
 	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
@@ -395,6 +459,26 @@ void ResourceManager::getStatistics(ResourceManagerStatistics& outStatistics) co
 	}
 
 	m_lock.release();
+
+	{
+		T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_requestsLock);
+		outStatistics.queuedCount = (uint32_t)m_requests.size();
+	}
+
+	outStatistics.streamingCount = (uint32_t)std::max< int32_t >(m_streaming - (int32_t)outStatistics.queuedCount, 0);
+	outStatistics.streamedCount = m_streamedCount;
+	outStatistics.cancelledCount = m_cancelledCount;
+
+	const double time = m_timer.getElapsedTime();
+	if (time > m_lastStatisticsTime)
+	{
+		outStatistics.streamedPerSecond = (float)((outStatistics.streamedCount - m_lastStreamedCount) / (time - m_lastStatisticsTime));
+		m_lastStreamedCount = outStatistics.streamedCount;
+		m_lastStatisticsTime = time;
+	}
+
+	for (int32_t i = 0; i < ResourceManagerStatistics::LatencyBuckets; ++i)
+		outStatistics.latencyHistogram[i] = m_latencyHistogram[i];
 }
 
 const IResourceFactory* ResourceManager::findFactory(const TypeInfo& resourceType) const
@@ -407,6 +491,172 @@ const IResourceFactory* ResourceManager::findFactory(const TypeInfo& resourceTyp
 	return nullptr;
 }
 
+Ref< ResourceHandle > ResourceManager::acquireHandle(const TypeInfo& productType, const Guid& guid, const IResourceFactory* factory)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	if (factory->isCacheable(productType))
+	{
+		auto it = m_residentHandles.find(guid);
+		if (it != m_residentHandles.end())
+			return it->second;
+
+		Ref< ResidentResourceHandle > residentHandle = new ResidentResourceHandle(productType, false);
+		m_residentHandles[guid] = residentHandle;
+		return residentHandle;
+	}
+	else
+	{
+		RefArray< ExclusiveResourceHandle >& handles = m_exclusiveHandles[guid];
+
+		// First try to reuse handles which are no longer in use.
+		for (auto h : handles)
+		{
+			if (!h->get() && !h->pending())
+				return h;
+		}
+
+		Ref< ExclusiveResourceHandle > exclusiveHandle = new ExclusiveResourceHandle(productType);
+		handles.push_back(exclusiveHandle);
+		return exclusiveHandle;
+	}
+}
+
+bool ResourceManager::preload(const TypeInfo& productType, const Guid& guid, bool persistent)
+{
+	// Get resource instance from database.
+	Ref< db::Instance > instance = m_database->getInstance(guid);
+	if (!instance)
+	{
+		log::error << L"Unable to preload resource " << guid.format() << L"; no such instance." << Endl;
+		return false;
+	}
+
+	// Get type of resource.
+	const TypeInfo* resourceType = instance->getPrimaryType();
+	if (!resourceType)
+	{
+		log::error << L"Unable to preload resource " << guid.format() << L"; unable to read resource type." << Endl;
+		return false;
+	}
+
+	// Find factory which can create products from resource.
+	const IResourceFactory* factory = findFactory(*resourceType);
+	if (!factory)
+	{
+		log::error << L"Unable to preload resource " << guid.format() << L"; no factory for specified resource type \"" << resourceType->getName() << L"\"." << Endl;
+		return false;
+	}
+
+	// Determine product type; must be explicitly determined if we can safely preload the resource.
+	const TypeInfoSet productTypes = factory->getProductTypes(*resourceType);
+	if (productTypes.size() != 1)
+	{
+		log::warning << L"Unable to preload resource " << guid.format() << L"; unable to determine product type, skipped." << Endl;
+		return true;
+	}
+
+	const bool cacheable = factory->isCacheable(productType);
+	if (!cacheable)
+	{
+		log::warning << L"Unable to preload resource " << guid.format() << L"; resource non cacheable, skipped." << Endl;
+		return true;
+	}
+
+	Ref< ResidentResourceHandle > residentHandle;
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		residentHandle = m_residentHandles[guid];
+		if (!residentHandle)
+		{
+			residentHandle = new ResidentResourceHandle(*(*productTypes.begin()), persistent);
+			m_residentHandles[guid] = residentHandle;
+		}
+	}
+
+	if (residentHandle->get() == nullptr)
+	{
+		const bool claimed = claim(residentHandle);
+		create(instance, factory, residentHandle->getProductType(), residentHandle);
+		if (claimed)
+			unclaim(residentHandle);
+
+		if (!residentHandle->get())
+			log::error << L"Unable to preload resource " << guid.format() << L"; skipped." << Endl;
+	}
+
+	return true;
+}
+
+bool ResourceManager::claim(ResourceHandle* handle)
+{
+	T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_requestsLock);
+
+	// Remove queued request, if any, since caller is about to load resource.
+	if (handle->pending())
+	{
+		auto it = std::find_if(m_requests.begin(), m_requests.end(), [&](const Request& request) {
+			return request.handle == handle;
+		});
+		if (it == m_requests.end())
+			return false;
+
+		m_requests.erase(it);
+		std::make_heap(m_requests.begin(), m_requests.end());
+	}
+
+	handle->setPending(true);
+	return true;
+}
+
+void ResourceManager::unclaim(ResourceHandle* handle)
+{
+	T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_requestsLock);
+	handle->setPending(false);
+}
+
+void ResourceManager::stream()
+{
+	Request request;
+	{
+		T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_requestsLock);
+		if (!m_requests.empty())
+		{
+			std::pop_heap(m_requests.begin(), m_requests.end());
+			request = std::move(m_requests.back());
+			m_requests.pop_back();
+		}
+	}
+
+	// Request might have been cancelled or claimed by a synchronous bind.
+	if (request.handle)
+	{
+		create(request.instance, request.factory, *request.productType, request.handle);
+		unclaim(request.handle);
+
+		const double latency = m_timer.getElapsedTime() - request.queued;
+		int32_t bucket = 0;
+		while (bucket < ResourceManagerStatistics::LatencyBuckets - 1 && latency > (double)(1 << bucket) / 1000.0)
+			++bucket;
+
+		m_latencyHistogram[bucket]++;
+		m_streamedCount++;
+	}
+
+	m_streaming--;
+}
+
+void ResourceManager::create(const db::Instance* instance, const IResourceFactory* factory, const TypeInfo& productType, ResourceHandle* handle)
+{
+	if (factory->isThreadSafe())
+		load(instance, factory, productType, handle);
+	else
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_createLock);
+		load(instance, factory, productType, handle);
+	}
+}
+
 void ResourceManager::load(const db::Instance* instance, const IResourceFactory* factory, const TypeInfo& productType, ResourceHandle* handle)
 {
 	Thread* currentThread = ThreadManager::getInstance().getCurrentThread();
@@ -8,10 +8,13 @@
  */
 #pragma once
 
+#include <atomic>
 #include <utility>
 #include "Core/RefArray.h"
 #include "Core/Containers/SmallMap.h"
 #include "Core/Thread/Semaphore.h"
+#include "Core/Thread/SpinLock.h"
+#include "Core/Timer/Timer.h"
 #include "Resource/IResourceManager.h"
 
 // import/export mechanism.
@@ -61,6 +64,10 @@ public:
 
 	virtual Ref< ResourceHandle > bind(const TypeInfo& productType, const Guid& guid) override final;
 
+	virtual Ref< ResourceHandle > bindAsync(const TypeInfo& productType, const Guid& guid, int32_t priority) override final;
+
+	virtual bool cancel(ResourceHandle* handle) override final;
+
 	virtual bool reload(const Guid& guid, bool flushedOnly) override final;
 
 	virtual void reload(const TypeInfo& productType, bool flushedOnly) override final;
@@ -72,6 +79,8 @@ public:
 	virtual void getStatistics(ResourceManagerStatistics& outStatistics) const override final;
 
 private:
+	struct Request;
+
 	Ref< db::Database > m_database;
 	AlignedVector< std::pair< const TypeInfo*, Ref< const IResourceFactory > > > m_resourceFactories;
 	SmallMap< Guid, Ref< ResidentResourceHandle > > m_residentHandles;
@@ -79,8 +88,32 @@ private:
 	mutable Semaphore m_lock;
 	bool m_verbose;
 
+	AlignedVector< Request > m_requests;
+	mutable SpinLock m_requestsLock;
+	Semaphore m_createLock;
+	Timer m_timer;
+	uint32_t m_sequence = 0;
+	std::atomic< int32_t > m_streaming;
+	std::atomic< uint32_t > m_streamedCount;
+	std::atomic< uint32_t > m_cancelledCount;
+	std::atomic< uint32_t > m_latencyHistogram[ResourceManagerStatistics::LatencyBuckets];
+	mutable uint32_t m_lastStreamedCount = 0;
+	mutable double m_lastStatisticsTime = 0.0;
+
 	const IResourceFactory* findFactory(const TypeInfo& resourceType) const;
 
+	Ref< ResourceHandle > acquireHandle(const TypeInfo& productType, const Guid& guid, const IResourceFactory* factory);
+
+	bool preload(const TypeInfo& productType, const Guid& guid, bool persistent);
+
+	bool claim(ResourceHandle* handle);
+
+	void unclaim(ResourceHandle* handle);
+
+	void stream();
+
+	void create(const db::Instance* instance, const IResourceFactory* factory, const TypeInfo& productType, ResourceHandle* handle);
+
 	void load(const db::Instance* instance, const IResourceFactory* factory, const TypeInfo& productType, ResourceHandle* handle);
 };
 
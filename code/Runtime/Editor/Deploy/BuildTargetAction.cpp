@@ -191,6 +191,8 @@ bool BuildTargetAction::execute(IProgressListener* progressListener)
 	// Merge threaded build configuration from global configuration.
 	const bool dependsThreads = m_globalSettings->getProperty< bool >(L"Pipeline.DependsThreads", true);
 	pipelineConfiguration->setProperty< PropertyBoolean >(L"Pipeline.DependsThreads", dependsThreads);
+	pipelineConfiguration->setProperty< PropertyInteger >(L"Pipeline.BuildThreads", m_globalSettings->getProperty< int32_t >(L"Pipeline.BuildThreads", 1));
+	pipelineConfiguration->setProperty< PropertyInteger >(L"Pipeline.BuildMemoryCap", m_globalSettings->getProperty< int32_t >(L"Pipeline.BuildMemoryCap", 0));
 
 	// Set database connection strings.
 	db::ConnectionString sourceDatabaseCs = m_globalSettings->getProperty< std::wstring >(L"Editor.SourceDatabase");
@@ -206,6 +206,8 @@ void ProfilerDialog::receivedPerfSets()
 	const TpsResource& resource = m_connection->getPerformance< TpsResource >();
 	m_performanceGrid->addRow(createPerformanceRow(L"Resident Resources", str(L"%d", resource.residentResourcesCount)));
 	m_performanceGrid->addRow(createPerformanceRow(L"Exclusive Resources", str(L"%d", resource.exclusiveResourcesCount)));
+	m_performanceGrid->addRow(createPerformanceRow(L"Queued Resources", str(L"%d", resource.queuedResourcesCount)));
+	m_performanceGrid->addRow(createPerformanceRow(L"Streamed Resources", str(L"%.1f / s", resource.streamedResourcesPerSecond)));
 
 	const TpsPhysics& physics = m_connection->getPerformance< TpsPhysics >();
 	m_performanceGrid->addRow(createPerformanceRow(L"Bodies", str(L"%d", physics.bodyCount)));
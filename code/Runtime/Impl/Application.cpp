@@ -28,6 +28,8 @@
 #include "Runtime/Target/TargetProfilerDictionary.h"
 #include "Runtime/Target/TargetProfilerEvents.h"
 #include "Core/Platform.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Io/IStream.h"
 #include "Core/Library/Library.h"
 #include "Core/Log/Log.h"
 #include "Core/Math/Float.h"
@@ -123,6 +125,17 @@ bool Application::create(
 			Profiler::getInstance().setListener(new TargetPerformanceListener(m_targetManagerConnection));
 	}
 
+	// Capture profiler events into Chrome trace file, useful for headless captures.
+	const std::wstring profilerCapture = settings->getProperty< std::wstring >(L"Runtime.ProfilerCapture");
+	if (!profilerCapture.empty())
+	{
+		Ref< IStream > captureStream = FileSystem::getInstance().open(profilerCapture, File::FmWrite);
+		if (captureStream)
+			Profiler::getInstance().beginCapture(captureStream);
+		else
+			log::warning << L"Unable to create profiler capture \"" << profilerCapture << L"\"" << Endl;
+	}
+
 	// Load dependent modules.
 #if !defined(T_STATIC)
 	const auto modules = defaultSettings->getProperty< SmallSet< std::wstring > >(L"Runtime.Modules");
@@ -390,6 +403,7 @@ bool Application::create(
 void Application::destroy()
 {
 	Profiler::getInstance().setListener(nullptr);
+	Profiler::getInstance().endCapture();
 
 	if (m_threadRender)
 	{
@@ -967,6 +981,8 @@ bool Application::update()
 				m_resourceServer->getResourceManager()->getStatistics(rms);
 				tp.residentResourcesCount = rms.residentCount;
 				tp.exclusiveResourcesCount = rms.exclusiveCount;
+				tp.queuedResourcesCount = rms.queuedCount;
+				tp.streamedResourcesPerSecond = rms.streamedPerSecond;
 				m_targetPerformance.publish(m_targetManagerConnection->getTransport(), tp);
 			}
 
@@ -60,6 +60,9 @@ bool AudioServer::create(const PropertyGroup* settings, const SystemApplication&
 #	else
 	ascd.driverDesc.frameSamples = 512;
 #	endif
+	ascd.parallelMixing = settings->getProperty< bool >(L"Audio.ParallelMixing", false);
+	ascd.virtualThreshold = settings->getProperty< float >(L"Audio.VirtualThreshold", 0.0f);
+	ascd.maxAudibleChannels = settings->getProperty< int32_t >(L"Audio.MaxAudibleChannels", 0);
 
 	if (!m_audioSystem->create(ascd))
 	{
@@ -141,13 +141,17 @@ bool TpsResource::check(const TargetPerfSet& old) const
 	const TpsResource& o = (const TpsResource&)old;
 	return
 		residentResourcesCount != o.residentResourcesCount ||
-		exclusiveResourcesCount != o.exclusiveResourcesCount;
+		exclusiveResourcesCount != o.exclusiveResourcesCount ||
+		queuedResourcesCount != o.queuedResourcesCount ||
+		streamedResourcesPerSecond != o.streamedResourcesPerSecond;
 }
 
 void TpsResource::serialize(ISerializer& s)
 {
 	s >> Member< uint32_t >(L"residentResourcesCount", residentResourcesCount);
 	s >> Member< uint32_t >(L"exclusiveResourcesCount", exclusiveResourcesCount);
+	s >> Member< uint32_t >(L"queuedResourcesCount", queuedResourcesCount);
+	s >> Member< float >(L"streamedResourcesPerSecond", streamedResourcesPerSecond);
 }
 
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.runtime.TpsPhysics", 0, TpsPhysics, TargetPerfSet)
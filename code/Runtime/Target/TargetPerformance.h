@@ -95,6 +95,8 @@ class T_DLLCLASS TpsResource : public TargetPerfSet
 public:
 	uint32_t residentResourcesCount = 0;
 	uint32_t exclusiveResourcesCount = 0;
+	uint32_t queuedResourcesCount = 0;
+	float streamedResourcesPerSecond = 0.0f;
 
 	virtual bool check(const TargetPerfSet& old) const override final;
 
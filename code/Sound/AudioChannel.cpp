@@ -59,8 +59,12 @@ AudioChannel::AudioChannel(uint32_t id, uint32_t hwSampleRate, uint32_t hwFrameS
 ,	m_hwFrameSamples(hwFrameSamples)
 ,	m_volume(1.0f)
 ,	m_pitch(1.0f)
+,	m_audibility(1.0f)
+,	m_priority(0)
 ,	m_playing(false)
 ,	m_allowRepeat(false)
+,	m_virtual(false)
+,	m_virtualTime(0.0)
 ,	m_outputSamplesIn(0)
 {
 	const uint32_t outputSamplesCount = hwFrameSamples * c_outputSamplesBlockCount;
@@ -98,6 +102,26 @@ float AudioChannel::getPitch() const
 	return m_pitch;
 }
 
+void AudioChannel::setAudibility(float audibility)
+{
+	m_audibility = clamp(audibility, 0.0f, 1.0f);
+}
+
+float AudioChannel::getAudibility() const
+{
+	return m_audibility;
+}
+
+void AudioChannel::setPriority(uint32_t priority)
+{
+	m_priority = priority;
+}
+
+uint32_t AudioChannel::getPriority() const
+{
+	return m_priority;
+}
+
 void AudioChannel::setFilter(const IAudioFilter* filter)
 {
 	StateFilter& sf = m_stateFilter.beginWrite();
@@ -126,6 +150,11 @@ void AudioChannel::stop()
 	m_allowRepeat = false;
 }
 
+bool AudioChannel::isVirtual() const
+{
+	return m_virtual;
+}
+
 IAudioBufferCursor* AudioChannel::getCursor()
 {
 	return m_stateSound.cursor;
@@ -174,6 +203,12 @@ bool AudioChannel::play(
 }
 
 bool AudioChannel::getBlock(const IAudioMixer* mixer, AudioBlock& outBlock)
+{
+	m_virtual = false;
+	return prepare() && renderBlock(mixer, outBlock);
+}
+
+bool AudioChannel::prepare()
 {
 	StateSound& ss = m_stateSound;
 
@@ -181,7 +216,10 @@ bool AudioChannel::getBlock(const IAudioMixer* mixer, AudioBlock& outBlock)
 	{
 		StateSound next;
 		if (m_stateSoundFifo.get(next))
+		{
 			ss = next;
+			m_virtualTime = 0.0;
+		}
 	}
 
 	if (!ss.buffer || !ss.cursor)
@@ -196,6 +234,18 @@ bool AudioChannel::getBlock(const IAudioMixer* mixer, AudioBlock& outBlock)
 		ss.cursor->setParameter(sp.set[i].first, sp.set[i].second);
 	sp.set.clear();
 
+	return true;
+}
+
+float AudioChannel::getGain() const
+{
+	return m_volume * m_stateSound.volume * m_audibility;
+}
+
+bool AudioChannel::renderBlock(const IAudioMixer* mixer, AudioBlock& outBlock)
+{
+	StateSound& ss = m_stateSound;
+
 	const IAudioBuffer* soundBuffer = ss.buffer;
 	T_ASSERT(soundBuffer);
 
@@ -221,39 +271,9 @@ bool AudioChannel::getBlock(const IAudioMixer* mixer, AudioBlock& outBlock)
 		if (!soundBuffer->getBlock(ss.cursor, mixer, block))
 		{
 			// No more blocks from sound buffer.
-			if (m_allowRepeat && ss.repeat)
-			{
-				ss.cursor->reset();
-
-				// Skip samples when repeating.
-				uint32_t skip = ss.repeatFrom;
-				while (skip > 0)
-				{
-					AudioBlock skipBlock = { { 0 }, m_hwFrameSamples, 0, 0 };
-					if (soundBuffer->getBlock(ss.cursor, mixer, skipBlock))
-						skip -= min(skip, skipBlock.samplesCount);
-					else
-					{
-						ss.buffer = nullptr;
-						ss.cursor = nullptr;
-						m_playing = false;
-						return false;
-					}
-				}
-
-				if (!soundBuffer->getBlock(ss.cursor, mixer, block))
-				{
-					ss.buffer = nullptr;
-					ss.cursor = nullptr;
-					m_playing = false;
-					return false;
-				}
-			}
-			else
+			if (!rewind(mixer) || !soundBuffer->getBlock(ss.cursor, mixer, block))
 			{
-				ss.buffer = nullptr;
-				ss.cursor = nullptr;
-				m_playing = false;
+				release();
 				return false;
 			}
 		}
@@ -338,4 +358,86 @@ bool AudioChannel::getBlock(const IAudioMixer* mixer, AudioBlock& outBlock)
 	return true;
 }
 
+bool AudioChannel::skipBlock(const IAudioMixer* mixer)
+{
+	StateSound& ss = m_stateSound;
+
+	const IAudioBuffer* soundBuffer = ss.buffer;
+	T_ASSERT(soundBuffer);
+
+	// Consume already rendered output samples first.
+	if (m_outputSamplesIn >= m_hwFrameSamples)
+	{
+		m_outputSamplesIn -= m_hwFrameSamples;
+		if (m_outputSamplesIn > 0)
+		{
+			for (uint32_t i = 0; i < SbcMaxChannelCount; ++i)
+				moveSamples(
+					m_outputSamples[i],
+					m_outputSamples[i] + m_hwFrameSamples,
+					alignUp(m_outputSamplesIn, 4)
+				);
+		}
+		return true;
+	}
+
+	// Skip remaining time of frame in sound buffer; filters are not applied.
+	m_virtualTime += (double(m_hwFrameSamples - m_outputSamplesIn) / m_hwSampleRate) * m_pitch;
+	m_outputSamplesIn = 0;
+
+	for (;;)
+	{
+		double skipped = 0.0;
+		const bool more = soundBuffer->skip(ss.cursor, mixer, m_virtualTime, skipped);
+		m_virtualTime -= skipped;
+
+		if (more)
+			break;
+
+		// End of sound buffer reached.
+		if (!rewind(mixer))
+		{
+			release();
+			return false;
+		}
+
+		// Nothing more to skip, or cannot make progress.
+		if (m_virtualTime <= 0.0 || skipped <= 0.0)
+			break;
+	}
+
+	return true;
+}
+
+bool AudioChannel::rewind(const IAudioMixer* mixer)
+{
+	StateSound& ss = m_stateSound;
+
+	if (!m_allowRepeat || !ss.repeat)
+		return false;
+
+	ss.cursor->reset();
+
+	// Skip samples when repeating.
+	uint32_t skip = ss.repeatFrom;
+	while (skip > 0)
+	{
+		AudioBlock skipBlock = { { 0 }, m_hwFrameSamples, 0, 0 };
+		if (ss.buffer->getBlock(ss.cursor, mixer, skipBlock))
+			skip -= min(skip, skipBlock.samplesCount);
+		else
+			return false;
+	}
+
+	return true;
+}
+
+void AudioChannel::release()
+{
+	m_stateSound.buffer = nullptr;
+	m_stateSound.cursor = nullptr;
+	m_playing = false;
+	m_virtualTime = 0.0;
+}
+
 }
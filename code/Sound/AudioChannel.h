@@ -61,6 +61,18 @@ public:
 	/*! Get current pitch. */
 	float getPitch() const;
 
+	/*! Set estimated audibility, used together with volume to determine if channel should be virtualized. */
+	void setAudibility(float audibility);
+
+	/*! Get estimated audibility. */
+	float getAudibility() const;
+
+	/*! Set priority, lower priority channels are virtualized first. */
+	void setPriority(uint32_t priority);
+
+	/*! Get priority. */
+	uint32_t getPriority() const;
+
 	/*! Associate filter in channel. */
 	void setFilter(const IAudioFilter* filter);
 
@@ -93,6 +105,9 @@ public:
 	/*! Stop playing sound. */
 	void stop();
 
+	/*! Check if channel was virtualized in last mixed frame. */
+	bool isVirtual() const;
+
 	/*! Return current playing sound's cursor. */
 	IAudioBufferCursor* getCursor();
 
@@ -128,8 +143,12 @@ private:
 	uint32_t m_hwFrameSamples;	//< Hardware frame size in samples.
 	float m_volume;
 	float m_pitch;
+	float m_audibility;
+	uint32_t m_priority;
 	bool m_playing;
 	bool m_allowRepeat;
+	bool m_virtual;
+	double m_virtualTime;		//< Time yet to be skipped while virtual.
 	
 	DoubleBuffer< StateFilter > m_stateFilter;
 	DoubleBuffer< StateParameter > m_stateParameters;
@@ -138,6 +157,23 @@ private:
 
 	float* m_outputSamples[SbcMaxChannelCount];
 	uint32_t m_outputSamplesIn;
+
+	/*! Read pending state, return true if a sound is active. */
+	bool prepare();
+
+	/*! Estimated gain of active sound. */
+	float getGain() const;
+
+	/*! Render next block of prepared sound. */
+	bool renderBlock(const IAudioMixer* mixer, AudioBlock& outBlock);
+
+	/*! Advance prepared sound one frame without rendering. */
+	bool skipBlock(const IAudioMixer* mixer);
+
+	/*! Rewind sound when repeating, return false if sound cannot be repeated. */
+	bool rewind(const IAudioMixer* mixer);
+
+	void release();
 };
 
 }
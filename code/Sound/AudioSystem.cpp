@@ -6,8 +6,10 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include <cstring>
 #include <limits>
+#include "Core/Containers/StaticVector.h"
 #include "Core/Log/Log.h"
 #include "Core/Math/Const.h"
 #include "Core/Math/MathUtils.h"
@@ -15,6 +17,7 @@
 #include "Core/Memory/Alloc.h"
 #include "Core/Misc/SafeDestroy.h"
 #include "Core/Thread/Acquire.h"
+#include "Core/Thread/JobManager.h"
 #include "Core/Thread/ThreadManager.h"
 #include "Core/Timer/Timer.h"
 #include "Sound/AudioChannel.h"
@@ -23,6 +26,7 @@
 #include "Sound/IAudioDriver.h"
 #include "Sound/IAudioMixer.h"
 #include "Sound/Sound.h"
+#include "Sound/StreamAudioBuffer.h"
 
 #if defined(T_SOUND_USE_AVX_MIXER)
 #	include "Sound/Avx/AudioMixerAvx.h"
@@ -30,6 +34,13 @@
 
 namespace traktor::sound
 {
+	namespace
+	{
+
+const uint32_t c_maxMixerTasks = 8;
+const uint32_t c_minChannelsPerTask = 8;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.AudioSystem", AudioSystem, Object)
 
@@ -41,6 +52,7 @@ AudioSystem::AudioSystem(IAudioDriver* driver)
 ,	m_samplesData(0)
 ,	m_time(0.0)
 ,	m_mixerThreadTime(0.0)
+,	m_streamUnderrunsAtCreate(0)
 {
 }
 
@@ -104,7 +116,10 @@ bool AudioSystem::create(const AudioSystemCreateDesc& desc)
 
 	// Set play parameters.
 	m_requestBlocks.resize(desc.channels);
+	m_activeChannels.reserve(desc.channels);
+	m_audibleChannels.reserve(desc.channels);
 	m_time = 0.0;
+	m_streamUnderrunsAtCreate = StreamAudioBuffer::getTotalUnderruns();
 
 	// Start thread.
 	m_threadMixer->start(Thread::Above);
@@ -113,14 +128,7 @@ bool AudioSystem::create(const AudioSystemCreateDesc& desc)
 
 void AudioSystem::destroy()
 {
-	// Release all channels to ensure submission thread no longer tries to request blocks from channels.
-	{
-		m_channelsLock.wait();
-		m_channels.clear();
-		m_channelsLock.release();
-	}
-
-	// Terminate mixer thread.
+	// Terminate mixer thread first since mixer reference channels' blocks outside of lock.
 	if (m_threadMixer)
 	{
 		m_threadMixer->stop();
@@ -128,6 +136,13 @@ void AudioSystem::destroy()
 		m_threadMixer = nullptr;
 	}
 
+	// Release all channels.
+	{
+		m_channelsLock.wait();
+		m_channels.clear();
+		m_channelsLock.release();
+	}
+
 	// Free mixer and memory resources.
 	m_mixer = nullptr;
 	safeDestroy(m_driver);
@@ -263,12 +278,57 @@ void AudioSystem::getThreadPerformances(double& outMixerTime) const
 	outMixerTime = m_mixerThreadTime;
 }
 
+uint32_t AudioSystem::getStreamUnderruns() const
+{
+	return StreamAudioBuffer::getTotalUnderruns() - m_streamUnderrunsAtCreate;
+}
+
 void AudioSystem::threadMixer()
 {
 	AudioBlock frameBlock;
 	Timer timerMixer;
 	uint32_t channelsCount;
 
+	// Render channel, virtual channels are only advanced in time.
+	const auto renderChannel = [&](const ActiveChannel& ac) {
+		AudioChannel* channel = m_channels[ac.index];
+		if (channel->m_virtual)
+			channel->skipBlock(m_mixer);
+		else
+			channel->renderBlock(m_mixer, m_requestBlocks[ac.index]);
+	};
+
+	// Final combine channels into hardware channel using "combine matrix".
+	const auto combineChannels = [&](uint32_t j) {
+		for (const auto& ac : m_activeChannels)
+		{
+			const AudioBlock& requestBlock = m_requestBlocks[ac.index];
+			if (!requestBlock.maxChannel)
+				continue;
+
+			T_ASSERT(requestBlock.sampleRate == m_desc.driverDesc.sampleRate);
+			T_ASSERT(requestBlock.samplesCount == m_desc.driverDesc.frameSamples);
+
+			for (uint32_t k = 0; k < requestBlock.maxChannel; ++k)
+			{
+				if (!requestBlock.samples[k])
+					continue;
+
+				const float strength = m_desc.cm[j][k] * ac.volume;
+				if (abs(strength) >= FUZZY_EPSILON)
+				{
+					m_mixer->addMulConst(
+						frameBlock.samples[j],
+						requestBlock.samples[k],
+						requestBlock.samplesCount,
+						strength
+					);
+				}
+			}
+		}
+		m_mixer->synchronize();
+	};
+
 	timerMixer.reset();
 	while (!m_threadMixer->stopped())
 	{
@@ -278,12 +338,78 @@ void AudioSystem::threadMixer()
 		m_channelsLock.wait();
 		{
 			channelsCount = (uint32_t)m_channels.size();
+
+			// Prepare channels and estimate final gain of each active channel.
+			m_activeChannels.resize(0);
 			for (uint32_t i = 0; i < channelsCount; ++i)
 			{
+				AudioChannel* channel = m_channels[i];
+
 				m_requestBlocks[i].samplesCount = m_desc.driverDesc.frameSamples;
 				m_requestBlocks[i].maxChannel = 0;
 				m_requestBlocks[i].category = 0;
-				m_channels[i]->getBlock(m_mixer, m_requestBlocks[i]);
+
+				channel->m_virtual = false;
+				if (!channel->prepare())
+					continue;
+
+				auto& ac = m_activeChannels.push_back();
+				ac.index = i;
+				ac.priority = channel->getPriority();
+				ac.volume = m_volume * getVolume(channel->m_stateSound.category);
+				ac.gain = channel->getGain() * ac.volume;
+
+				channel->m_virtual = (ac.gain < m_desc.virtualThreshold);
+			}
+
+			// Virtualize least important channels if there are too many audible.
+			if (m_desc.maxAudibleChannels > 0)
+			{
+				m_audibleChannels.resize(0);
+				for (const auto& ac : m_activeChannels)
+				{
+					if (!m_channels[ac.index]->m_virtual)
+						m_audibleChannels.push_back(ac);
+				}
+				if (m_audibleChannels.size() > m_desc.maxAudibleChannels)
+				{
+					ActiveChannel* audible = m_audibleChannels.ptr();
+					std::nth_element(
+						audible,
+						audible + m_desc.maxAudibleChannels,
+						audible + m_audibleChannels.size(),
+						[](const ActiveChannel& lh, const ActiveChannel& rh) {
+							if (lh.priority != rh.priority)
+								return lh.priority > rh.priority;
+							if (lh.gain != rh.gain)
+								return lh.gain > rh.gain;
+							return lh.index < rh.index;
+						}
+					);
+					for (uint32_t i = m_desc.maxAudibleChannels; i < m_audibleChannels.size(); ++i)
+						m_channels[audible[i].index]->m_virtual = true;
+				}
+			}
+
+			// Render channels, interleave channels over tasks to balance load.
+			const uint32_t activeCount = (uint32_t)m_activeChannels.size();
+			const uint32_t ntasks = m_desc.parallelMixing ? std::min(activeCount / c_minChannelsPerTask, c_maxMixerTasks) : 0;
+			if (ntasks > 1)
+			{
+				StaticVector< Job::task_t, c_maxMixerTasks > tasks;
+				for (uint32_t t = 0; t < ntasks; ++t)
+				{
+					tasks.push_back([&, t]() {
+						for (uint32_t i = t; i < activeCount; i += ntasks)
+							renderChannel(m_activeChannels[i]);
+					});
+				}
+				JobManager::getInstance().fork(tasks.c_ptr(), tasks.size());
+			}
+			else
+			{
+				for (const auto& ac : m_activeChannels)
+					renderChannel(ac);
 			}
 		}
 		m_channelsLock.release();
@@ -302,43 +428,26 @@ void AudioSystem::threadMixer()
 
 		m_mixer->synchronize();
 
-		// Final combine channels into hardware channels using "combine matrix".
-		for (uint32_t i = 0; i < channelsCount; ++i)
+		// Reduce channels into frame block, each hardware channel is independent.
+		const uint32_t hwChannels = m_desc.driverDesc.hwChannels;
+		if (m_desc.parallelMixing && hwChannels > 1 && m_activeChannels.size() >= c_minChannelsPerTask)
 		{
-			if (!m_requestBlocks[i].maxChannel)
-				continue;
-
-			T_ASSERT(m_requestBlocks[i].sampleRate == m_desc.driverDesc.sampleRate);
-			T_ASSERT(m_requestBlocks[i].samplesCount == m_desc.driverDesc.frameSamples);
-
-			const float categoryVolume = getVolume(m_requestBlocks[i].category);
-			const float finalVolume = m_volume * categoryVolume;
-
-			for (uint32_t k = 0; k < m_requestBlocks[i].maxChannel; ++k)
-			{
-				if (!m_requestBlocks[i].samples[k])
-					continue;
-
-				for (uint32_t j = 0; j < m_desc.driverDesc.hwChannels; ++j)
-				{
-					const float strength = m_desc.cm[j][k] * finalVolume;
-					if (abs(strength) >= FUZZY_EPSILON)
-					{
-						m_mixer->addMulConst(
-							frameBlock.samples[j],
-							m_requestBlocks[i].samples[k],
-							m_requestBlocks[i].samplesCount,
-							strength
-						);
-					}
-				}
-
-				m_mixer->synchronize();
-			}
+			StaticVector< Job::task_t, SbcMaxChannelCount > tasks;
+			for (uint32_t j = 0; j < hwChannels; ++j)
+				tasks.push_back([&, j]() { combineChannels(j); });
+			JobManager::getInstance().fork(tasks.c_ptr(), tasks.size());
+		}
+		else
+		{
+			for (uint32_t j = 0; j < hwChannels; ++j)
+				combineChannels(j);
 		}
 
 		m_time += double(m_desc.driverDesc.frameSamples) / m_desc.driverDesc.sampleRate;
 
+		const double endTime = timerMixer.getElapsedTime();
+		m_mixerThreadTime = (endTime - startTime) * 0.1 + m_mixerThreadTime * 0.9;
+
 		if (m_threadMixer->stopped())
 			break;
 
@@ -348,9 +457,6 @@ void AudioSystem::threadMixer()
 
 		// Move block back into heap.
 		m_samplesBlocks.push_back(frameBlock.samples[0]);
-
-		const double endTime = timerMixer.getElapsedTime();
-		m_mixerThreadTime = (endTime - startTime) * 0.1 + m_mixerThreadTime * 0.9;
 	}
 }
 
@@ -40,6 +40,13 @@ class Sound;
  * The AudioSystem class manages mixing sounds
  * from virtual channels and feeding them through the
  * submission thread into the audio driver for playback.
+ *
+ * Channels which are estimated to be inaudible, or
+ * exceed the audible budget, are virtualized; they
+ * are only advanced in time without being rendered.
+ * Optionally channels are rendered in parallel using
+ * the job manager, note that mixing thus depend
+ * on job workers being available in time.
  */
 class T_DLLCLASS AudioSystem : public Object
 {
@@ -121,11 +128,25 @@ public:
 
 	/*! Query performance of each thread.
 	 *
-	 * \param outMixerTime Last mixer thread duration in seconds.
+	 * \param outMixerTime Last mixer thread duration in seconds, excluding time waiting for driver.
 	 */
 	void getThreadPerformances(double& outMixerTime) const;
 
+	/*! Get number of blocks streams failed to decode in time.
+	 *
+	 * \return Number of stream underruns since start.
+	 */
+	uint32_t getStreamUnderruns() const;
+
 private:
+	struct ActiveChannel
+	{
+		uint32_t index;
+		uint32_t priority;
+		float gain;		//!< Estimated final gain.
+		float volume;	//!< Global and category volume.
+	};
+
 	Ref< IAudioDriver > m_driver;
 	Ref< IAudioMixer > m_mixer;
 	AudioSystemCreateDesc m_desc;
@@ -135,6 +156,8 @@ private:
 	Thread* m_threadMixer;
 	RefArray< AudioChannel > m_channels;
 	AlignedVector< AudioBlock > m_requestBlocks;
+	AlignedVector< ActiveChannel > m_activeChannels;
+	AlignedVector< ActiveChannel > m_audibleChannels;
 
 	// \name Submission queue
 	// \{
@@ -153,6 +176,7 @@ private:
 
 	double m_time;
 	double m_mixerThreadTime;
+	uint32_t m_streamUnderrunsAtCreate;
 
 	void threadMixer();
 };
@@ -10,7 +10,31 @@
 
 namespace traktor::sound
 {
+	namespace
+	{
+
+const uint32_t c_skipBlockSamples = 1024;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.IAudioBuffer", IAudioBuffer, Object)
 
+bool IAudioBuffer::skip(IAudioBufferCursor* cursor, const IAudioMixer* mixer, double duration, double& outSkipped) const
+{
+	outSkipped = 0.0;
+	while (outSkipped < duration)
+	{
+		AudioBlock block = { { 0 }, c_skipBlockSamples, 0, 0 };
+		if (!getBlock(cursor, mixer, block))
+			return false;
+
+		// Null block doesn't indicate end of buffer.
+		if (!block.samplesCount || !block.sampleRate)
+			break;
+
+		outSkipped += double(block.samplesCount) / block.sampleRate;
+	}
+	return true;
+}
+
 }
@@ -49,6 +49,19 @@ public:
 	virtual Ref< IAudioBufferCursor > createCursor() const = 0;
 
 	virtual bool getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const = 0;
+
+	/*! Skip ahead in buffer without producing any samples.
+	 *
+	 * Default implementation decode and discard blocks,
+	 * buffers which are able to seek should override.
+	 *
+	 * \param cursor Buffer cursor.
+	 * \param mixer Audio mixer.
+	 * \param duration Time to skip, in seconds.
+	 * \param outSkipped Time actually skipped, might differ by a fraction of a block.
+	 * \return False if end of buffer reached.
+	 */
+	virtual bool skip(IAudioBufferCursor* cursor, const IAudioMixer* mixer, double duration, double& outSkipped) const;
 };
 
 }
@@ -115,6 +115,8 @@ Ref< SoundHandle > SoundPlayer::play(const Sound* sound, uint32_t priority)
 				);
 				channel.audioChannel->setFilter(nullptr);
 				channel.audioChannel->setVolume(1.0f);
+				channel.audioChannel->setAudibility(1.0f);
+				channel.audioChannel->setPriority(priority);
 				channel.priority = priority;
 				channel.fadeOff = -1.0f;
 				channel.time = time;
@@ -146,6 +148,8 @@ Ref< SoundHandle > SoundPlayer::play(const Sound* sound, uint32_t priority)
 				);
 				channel.audioChannel->setFilter(nullptr);
 				channel.audioChannel->setVolume(1.0f);
+				channel.audioChannel->setAudibility(1.0f);
+				channel.audioChannel->setPriority(priority);
 				channel.priority = priority;
 				channel.fadeOff = -1.0f;
 				channel.time = time;
@@ -186,6 +190,7 @@ Ref< SoundHandle > SoundPlayer::play(const Sound* sound, const Vector4& position
 
 	const float k0 = distance / maxDistance;
 	const float k1 = (distance - m_surroundEnvironment->getInnerRadius()) / (maxDistance - m_surroundEnvironment->getInnerRadius());
+	const float audibility = clamp(1.0f - k1, 0.0f, 1.0f);
 
 	// Surround filter.
 	Ref< SurroundFilter > surroundFilter = new SurroundFilter(m_surroundEnvironment, position.xyz1(), maxDistance);
@@ -227,6 +232,8 @@ Ref< SoundHandle > SoundPlayer::play(const Sound* sound, const Vector4& position
 				);
 				channel.audioChannel->setFilter(groupFilter);
 				channel.audioChannel->setVolume(1.0f);
+				channel.audioChannel->setAudibility(audibility);
+				channel.audioChannel->setPriority(priority);
 				channel.priority = priority;
 				channel.fadeOff = -1.0f;
 				channel.time = time;
@@ -258,6 +265,8 @@ Ref< SoundHandle > SoundPlayer::play(const Sound* sound, const Vector4& position
 				);
 				channel.audioChannel->setFilter(groupFilter);
 				channel.audioChannel->setVolume(1.0f);
+				channel.audioChannel->setAudibility(audibility);
+				channel.audioChannel->setPriority(priority);
 				channel.priority = priority;
 				channel.fadeOff = -1.0f;
 				channel.time = time;
@@ -294,6 +303,8 @@ Ref< SoundHandle > SoundPlayer::play(const Sound* sound, const Vector4& position
 				);
 				channel.audioChannel->setFilter(groupFilter);
 				channel.audioChannel->setVolume(1.0f);
+				channel.audioChannel->setAudibility(audibility);
+				channel.audioChannel->setPriority(priority);
 				channel.priority = priority;
 				channel.fadeOff = -1.0f;
 				channel.time = time;
@@ -365,6 +376,7 @@ void SoundPlayer::update(float dT)
 
 			// Calculate cut-off frequency.
 			const float k0 = clamp< float >(distance / maxDistance, 0.0f, 1.0f);
+			const float k1 = (distance - m_surroundEnvironment->getInnerRadius()) / (maxDistance - m_surroundEnvironment->getInnerRadius());
 
 			// Set filter parameters.
 			if (channel.surroundFilter)
@@ -375,6 +387,9 @@ void SoundPlayer::update(float dT)
 				channel.lowPassFilter->setCutOff(cutOff);
 			}
 
+			// Audibility is used by mixer to determine if channel can be virtualized.
+			channel.audioChannel->setAudibility(clamp(1.0f - k1, 0.0f, 1.0f));
+
 			// Set automatic sound parameters.
 			channel.audioChannel->setParameter(s_handleDistance, k0);
 			channel.audioChannel->setParameter(s_handleVelocity, 0.0f);
@@ -225,4 +225,24 @@ bool StaticAudioBuffer::getBlock(IAudioBufferCursor* cursor, const IAudioMixer*
 	return true;
 }
 
+bool StaticAudioBuffer::skip(IAudioBufferCursor* cursor, const IAudioMixer* mixer, double duration, double& outSkipped) const
+{
+	StaticAudioBufferCursor* ssbc = static_cast< StaticAudioBufferCursor* >(cursor);
+
+	// Keep position aligned as samples are loaded using aligned loads.
+	const int32_t samplesCount = alignDown((int32_t)(duration * m_sampleRate), 8);
+	const int32_t remaining = m_samplesCount - (int32_t)ssbc->m_position;
+
+	if (samplesCount >= alignDown(remaining, 4))
+	{
+		ssbc->m_position = m_samplesCount;
+		outSkipped = double(std::max(remaining, 0)) / m_sampleRate;
+		return false;
+	}
+
+	ssbc->m_position += samplesCount;
+	outSkipped = double(samplesCount) / m_sampleRate;
+	return true;
+}
+
 }
@@ -6,8 +6,14 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
+#include <cstring>
 #include "Core/Log/Log.h"
+#include "Core/Memory/Alloc.h"
+#include "Core/Misc/Align.h"
 #include "Core/Misc/SafeDestroy.h"
+#include "Core/Thread/Acquire.h"
+#include "Core/Thread/JobManager.h"
 #include "Sound/IStreamDecoder.h"
 #include "Sound/StreamAudioBuffer.h"
 
@@ -16,9 +22,15 @@ namespace traktor::sound
 	namespace
 	{
 
+const uint32_t c_decodeBlockSamples = 4096;
+
+std::atomic< uint32_t > s_underruns = 0;
+
 struct StreamAudioBufferCursor : public RefCountImpl< IAudioBufferCursor >
 {
 	uint64_t m_position = 0;
+	AutoArrayPtr< float, AllocFreeAlign > m_samples[SbcMaxChannelCount];
+	uint32_t m_samplesCapacity = 0;
 
 	virtual void setParameter(handle_t id, float parameter)
 	{
@@ -43,17 +55,28 @@ StreamAudioBuffer::~StreamAudioBuffer()
 	destroy();
 }
 
-bool StreamAudioBuffer::create(IStreamDecoder* streamDecoder)
+bool StreamAudioBuffer::create(IStreamDecoder* streamDecoder, float latency)
 {
-	if ((m_streamDecoder = streamDecoder) != nullptr)
-		return true;
-	else
+	if ((m_streamDecoder = streamDecoder) == nullptr)
 		return false;
+
+	m_latency = latency;
+	return true;
 }
 
 void StreamAudioBuffer::destroy()
 {
+	stopDecoding();
 	safeDestroy(m_streamDecoder);
+
+	for (uint32_t i = 0; i < SbcMaxChannelCount; ++i)
+		m_ring[i].release();
+	m_ringCapacity = 0;
+}
+
+uint32_t StreamAudioBuffer::getTotalUnderruns()
+{
+	return s_underruns;
 }
 
 Ref< IAudioBufferCursor > StreamAudioBuffer::createCursor() const
@@ -63,28 +86,215 @@ Ref< IAudioBufferCursor > StreamAudioBuffer::createCursor() const
 
 bool StreamAudioBuffer::getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const
 {
+	T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_readLock);
 	StreamAudioBufferCursor* ssbc = static_cast< StreamAudioBufferCursor* >(cursor);
-	const uint64_t position = ssbc->m_position;
 
-	if (m_position > position)
+	if (!m_streamDecoder)
+		return false;
+
+	// Cursor not at ring read head, need to seek.
+	if (ssbc->m_position != m_position)
+		seek(ssbc->m_position);
+
+	// Ring has been discarded; decode first block synchronously.
+	const uint64_t read = m_ringRead.load(std::memory_order_relaxed);
+	if (m_ringWrite.load(std::memory_order_acquire) == read && !m_job && !m_endOfStream)
+		fill(outBlock.samplesCount);
+
+	// End of stream is set after last samples are written thus must be read first.
+	const bool endOfStream = m_endOfStream.load(std::memory_order_acquire);
+	const uint64_t write = m_ringWrite.load(std::memory_order_acquire);
+	const uint32_t available = uint32_t(write - read);
+
+	if (!available && endOfStream)
+		return false;
+
+	// Ensure cursor has room for requested samples.
+	const uint32_t requested = alignUp(outBlock.samplesCount, 4);
+	if (ssbc->m_samplesCapacity < requested)
 	{
-		T_DEBUG(L"Rewind stream sound decoder");
-		m_streamDecoder->rewind();
-		m_position = 0;
+		for (uint32_t i = 0; i < SbcMaxChannelCount; ++i)
+			ssbc->m_samples[i].reset((float*)Alloc::acquireAlign(requested * sizeof(float), 16, T_FILE_LINE));
+		ssbc->m_samplesCapacity = requested;
 	}
 
-	const uint32_t samplesCount = outBlock.samplesCount;
-	while (m_position <= position)
+	// Only last samples of stream are allowed to be padded into multiple-of-4.
+	uint32_t samplesCount = std::min(alignDown(outBlock.samplesCount, 4), available);
+	if (!endOfStream || samplesCount < available)
+		samplesCount = alignDown(samplesCount, 4);
+
+	if (samplesCount > 0)
 	{
-		outBlock.samplesCount = samplesCount;
-		if (!m_streamDecoder->getBlock(outBlock))
-			return false;
+		// Copy samples from ring, ring might wrap around.
+		const uint32_t offset = uint32_t(read % m_ringCapacity);
+		const uint32_t count0 = std::min(samplesCount, m_ringCapacity - offset);
+		const uint32_t count1 = samplesCount - count0;
+		const uint32_t padded = alignUp(samplesCount, 4);
 
-		m_position += outBlock.samplesCount;
+		for (uint32_t i = 0; i < m_channelsCount; ++i)
+		{
+			float* samples = ssbc->m_samples[i].ptr();
+			std::memcpy(samples, m_ring[i].c_ptr() + offset, count0 * sizeof(float));
+			if (count1 > 0)
+				std::memcpy(samples + count0, m_ring[i].c_ptr(), count1 * sizeof(float));
+			for (uint32_t j = samplesCount; j < padded; ++j)
+				samples[j] = 0.0f;
+			outBlock.samples[i] = samples;
+		}
+
+		m_ringRead.store(read + samplesCount, std::memory_order_release);
+		m_position += samplesCount;
+		ssbc->m_position = m_position;
+
+		outBlock.samplesCount = padded;
+	}
+	else
+	{
+		// Decoder hasn't been able to keep up; output silence but keep position.
+		++m_underruns;
+		++s_underruns;
+
+		for (uint32_t i = 0; i < m_channelsCount; ++i)
+		{
+			float* samples = ssbc->m_samples[i].ptr();
+			std::memset(samples, 0, requested * sizeof(float));
+			outBlock.samples[i] = samples;
+		}
+
+		outBlock.samplesCount = requested;
+	}
+
+	outBlock.sampleRate = m_sampleRate;
+	outBlock.maxChannel = m_channelsCount;
+
+	// Issue decode job if ring is at least half empty.
+	if (!endOfStream && (m_ringCapacity - uint32_t(m_ringWrite.load(std::memory_order_acquire) - m_ringRead.load(std::memory_order_relaxed))) >= m_ringCapacity / 2)
+	{
+		if (m_job && m_job->wait(0))
+			m_job = nullptr;
+		if (!m_job)
+			m_job = JobManager::getInstance().add([this]() { fill(m_ringCapacity); });
 	}
 
-	ssbc->m_position += outBlock.samplesCount;
 	return true;
 }
 
+void StreamAudioBuffer::fill(uint32_t maxSamples) const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_decoderLock);
+	uint32_t filled = 0;
+
+	while (filled < maxSamples && !m_cancel.load(std::memory_order_relaxed))
+	{
+		const uint32_t remaining = m_pending.samplesCount - m_pendingOffset;
+		if (remaining > 0)
+		{
+			// Discard samples until seek position is reached.
+			if (m_skip > 0)
+			{
+				const uint32_t skip = (uint32_t)std::min< uint64_t >(m_skip, remaining);
+				m_pendingOffset += skip;
+				m_skip -= skip;
+				continue;
+			}
+
+			const uint64_t write = m_ringWrite.load(std::memory_order_relaxed);
+			const uint32_t free = m_ringCapacity - uint32_t(write - m_ringRead.load(std::memory_order_acquire));
+			const uint32_t count = std::min({ remaining, free, maxSamples - filled });
+			if (!count)
+				break;
+
+			const uint32_t offset = uint32_t(write % m_ringCapacity);
+			const uint32_t count0 = std::min(count, m_ringCapacity - offset);
+			const uint32_t count1 = count - count0;
+
+			for (uint32_t i = 0; i < m_channelsCount; ++i)
+			{
+				const float* samples = m_pending.samples[i] + m_pendingOffset;
+				if (m_pending.samples[i])
+				{
+					std::memcpy(m_ring[i].ptr() + offset, samples, count0 * sizeof(float));
+					std::memcpy(m_ring[i].ptr(), samples + count0, count1 * sizeof(float));
+				}
+				else
+				{
+					std::memset(m_ring[i].ptr() + offset, 0, count0 * sizeof(float));
+					std::memset(m_ring[i].ptr(), 0, count1 * sizeof(float));
+				}
+			}
+
+			m_ringWrite.store(write + count, std::memory_order_release);
+			m_pendingOffset += count;
+			filled += count;
+			continue;
+		}
+
+		if (m_endOfStream)
+			break;
+
+		// Decode next block from stream.
+		m_pending = { { 0 }, c_decodeBlockSamples, 0, 0, 0 };
+		m_pendingOffset = 0;
+		if (!m_streamDecoder->getBlock(m_pending) || !m_pending.samplesCount)
+		{
+			m_pending.samplesCount = 0;
+			m_endOfStream.store(true, std::memory_order_release);
+			break;
+		}
+
+		// Allocate ring when we first know format of stream.
+		if (!m_ringCapacity)
+		{
+			m_sampleRate = m_pending.sampleRate;
+			m_channelsCount = std::min< uint32_t >(m_pending.maxChannel, SbcMaxChannelCount);
+			m_ringCapacity = alignUp(std::max(uint32_t(m_latency * m_sampleRate), 2 * c_decodeBlockSamples), 4);
+			for (uint32_t i = 0; i < m_channelsCount; ++i)
+				m_ring[i].reset((float*)Alloc::acquireAlign(m_ringCapacity * sizeof(float), 16, T_FILE_LINE));
+		}
+	}
+}
+
+void StreamAudioBuffer::seek(uint64_t position) const
+{
+	stopDecoding();
+
+	// Seek forward within ring; just skip samples.
+	const uint64_t read = m_ringRead.load(std::memory_order_relaxed);
+	const uint64_t write = m_ringWrite.load(std::memory_order_relaxed);
+	if (position >= m_position && position <= m_position + (write - read))
+	{
+		m_ringRead.store(read + (position - m_position), std::memory_order_relaxed);
+		m_position = position;
+		return;
+	}
+
+	// Discard ring; continue from end of ring if seeking forward else rewind stream.
+	if (position > m_position)
+		m_skip = position - (m_position + (write - read));
+	else
+	{
+		T_DEBUG(L"Rewind stream sound decoder");
+		m_streamDecoder->rewind();
+		m_pending.samplesCount = 0;
+		m_pendingOffset = 0;
+		m_endOfStream = false;
+		m_skip = position;
+	}
+
+	m_ringRead = 0;
+	m_ringWrite = 0;
+	m_position = position;
+}
+
+void StreamAudioBuffer::stopDecoding() const
+{
+	if (m_job)
+	{
+		m_cancel = true;
+		m_job->wait();
+		m_job = nullptr;
+		m_cancel = false;
+	}
+}
+
 }
@@ -8,6 +8,10 @@
  */
 #pragma once
 
+#include <atomic>
+#include "Core/Misc/AutoPtr.h"
+#include "Core/Thread/Semaphore.h"
+#include "Core/Thread/SpinLock.h"
 #include "Sound/IAudioBuffer.h"
 
 // import/export mechanism.
@@ -18,6 +22,13 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
+namespace traktor
+{
+
+class Job;
+
+}
+
 namespace traktor::sound
 {
 
@@ -25,6 +36,12 @@ class IStreamDecoder;
 
 /*! Stream audio buffer.
  * \ingroup Sound
+ *
+ * Stream is decoded ahead into a ring buffer by a background
+ * job so the mixer thread only need to copy decoded samples.
+ * If the decoder cannot keep up the mixer is fed silence,
+ * and the stream resumes where it stalled, which is recorded
+ * as an underrun.
  */
 class T_DLLCLASS StreamAudioBuffer : public IAudioBuffer
 {
@@ -33,17 +50,58 @@ class T_DLLCLASS StreamAudioBuffer : public IAudioBuffer
 public:
 	virtual ~StreamAudioBuffer();
 
-	bool create(IStreamDecoder* streamDecoder);
+	/*! Create stream buffer.
+	 *
+	 * \param streamDecoder Stream decoder.
+	 * \param latency Amount of audio, in seconds, to decode ahead.
+	 * \return True if created successfully.
+	 */
+	bool create(IStreamDecoder* streamDecoder, float latency = 0.25f);
 
 	void destroy();
 
+	/*! Get number of underruns in this stream. */
+	uint32_t getUnderruns() const { return m_underruns; }
+
+	/*! Get number of underruns in all streams. */
+	static uint32_t getTotalUnderruns();
+
 	virtual Ref< IAudioBufferCursor > createCursor() const override final;
 
 	virtual bool getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const override final;
 
 private:
 	Ref< IStreamDecoder > m_streamDecoder;
-	mutable uint64_t m_position = 0;
+	float m_latency = 0.0f;
+
+	// Decoder state, owned by decode job while running.
+	mutable Semaphore m_decoderLock;
+	mutable Ref< Job > m_job;
+	mutable std::atomic< bool > m_cancel = false;
+	mutable std::atomic< bool > m_endOfStream = false;
+	mutable AudioBlock m_pending = { { 0 }, 0, 0, 0, 0 };
+	mutable uint32_t m_pendingOffset = 0;
+	mutable uint64_t m_skip = 0;
+
+	// Ring of decoded samples, single producer and single consumer.
+	mutable SpinLock m_readLock;
+	mutable AutoArrayPtr< float, AllocFreeAlign > m_ring[SbcMaxChannelCount];
+	mutable uint32_t m_ringCapacity = 0;
+	mutable std::atomic< uint64_t > m_ringWrite = 0;
+	mutable std::atomic< uint64_t > m_ringRead = 0;
+	mutable uint64_t m_position = 0;	//!< Stream position of ring read head.
+	mutable uint32_t m_sampleRate = 0;
+	mutable uint32_t m_channelsCount = 0;
+	mutable std::atomic< uint32_t > m_underruns = 0;
+
+	/*! Decode stream into ring until ring is full, max samples has been written or end of stream. */
+	void fill(uint32_t maxSamples) const;
+
+	/*! Move ring read head to stream position; ring is discarded unless position is within ring. */
+	void seek(uint64_t position) const;
+
+	/*! Stop running decode job. */
+	void stopDecoding() const;
 };
 
 }
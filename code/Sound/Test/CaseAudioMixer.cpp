@@ -0,0 +1,233 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cmath>
+#include "Core/Log/Log.h"
+#include "Core/Math/Const.h"
+#include "Core/Math/Random.h"
+#include "Core/Thread/Signal.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Sound/AudioChannel.h"
+#include "Sound/AudioDriverNull.h"
+#include "Sound/AudioSystem.h"
+#include "Sound/IAudioDriver.h"
+#include "Sound/StaticAudioBuffer.h"
+#include "Sound/Filters/LowPassFilter.h"
+#include "Sound/Test/CaseAudioMixer.h"
+
+namespace traktor::sound::test
+{
+	namespace
+	{
+
+const uint32_t c_voiceCount = 256;
+const uint32_t c_maxAudibleChannels = 32;
+const uint32_t c_sampleRate = 44100;
+const uint32_t c_frameSamples = 512;
+const uint32_t c_captureFrame = 20;
+const int32_t c_benchmarkDuration = 1000;
+
+/*! Driver which hold mixer until all voices are started, then capture a single frame. */
+class CaptureAudioDriver : public RefCountImpl< IAudioDriver >
+{
+public:
+	Signal m_waiting;
+	Signal m_start;
+	Signal m_captured;
+	AlignedVector< float > m_samples;
+
+	virtual bool create(const SystemApplication& sysapp, const AudioDriverCreateDesc& desc, Ref< IAudioMixer >& outMixer) override final
+	{
+		m_desc = desc;
+		return true;
+	}
+
+	virtual void destroy() override final
+	{
+	}
+
+	virtual void wait() override final
+	{
+		m_waiting.set();
+		m_start.wait();
+	}
+
+	virtual void submit(const AudioBlock& block) override final
+	{
+		if (++m_frames != c_captureFrame)
+			return;
+
+		for (uint32_t i = 0; i < m_desc.hwChannels; ++i)
+			m_samples.insert(m_samples.end(), block.samples[i], block.samples[i] + block.samplesCount);
+
+		m_captured.set();
+	}
+
+private:
+	AudioDriverCreateDesc m_desc;
+	uint32_t m_frames = 0;
+};
+
+/*! Create stereo buffer with a tone in each channel. */
+Ref< StaticAudioBuffer > createBuffer(float duration, float frequency)
+{
+	const uint32_t samplesCount = uint32_t(duration * c_sampleRate);
+
+	Ref< StaticAudioBuffer > buffer = new StaticAudioBuffer();
+	if (!buffer->create(c_sampleRate, samplesCount, 2))
+		return nullptr;
+
+	for (uint32_t i = 0; i < 2; ++i)
+	{
+		int16_t* samples = buffer->getSamplesData(i);
+		for (uint32_t j = 0; j < samplesCount; ++j)
+			samples[j] = int16_t(std::sin(TWO_PI * frequency * (i + 1) * j / c_sampleRate) * 8000.0f);
+	}
+
+	return buffer;
+}
+
+AudioSystemCreateDesc createDesc(bool parallelMixing, float virtualThreshold, uint32_t maxAudibleChannels)
+{
+	AudioSystemCreateDesc desc;
+	desc.channels = c_voiceCount;
+	desc.driverDesc.sampleRate = c_sampleRate;
+	desc.driverDesc.bitsPerSample = 16;
+	desc.driverDesc.hwChannels = 2;
+	desc.driverDesc.frameSamples = c_frameSamples;
+	desc.parallelMixing = parallelMixing;
+	desc.virtualThreshold = virtualThreshold;
+	desc.maxAudibleChannels = maxAudibleChannels;
+	return desc;
+}
+
+/*! Start filtered, repeating voices with varying pitch, audibility and priority on all channels. */
+void playVoices(AudioSystem* audioSystem, const IAudioBuffer* buffer)
+{
+	Random rnd(1234);
+	for (uint32_t i = 0; i < c_voiceCount; ++i)
+	{
+		AudioChannel* channel = audioSystem->getChannel(i);
+		channel->play(buffer, 0, 0.0f, true, 0);
+		channel->setFilter(new LowPassFilter(500.0f + rnd.nextFloat() * 10000.0f));
+		channel->setPitch(0.5f + rnd.nextFloat() * 1.5f);
+		channel->setVolume(1.0f / c_voiceCount);
+		channel->setAudibility(rnd.nextFloat());
+		channel->setPriority(i % 4);
+	}
+}
+
+/*! Mix a number of frames, blocking output by the capture driver, and return captured frame. */
+bool captureFrame(bool parallelMixing, const IAudioBuffer* buffer, AlignedVector< float >& outSamples)
+{
+	Ref< CaptureAudioDriver > audioDriver = new CaptureAudioDriver();
+	Ref< AudioSystem > audioSystem = new AudioSystem(audioDriver);
+	if (!audioSystem->create(createDesc(parallelMixing, 0.0f, 0)))
+		return false;
+
+	// Ensure mixer is idle while voices are being setup.
+	audioDriver->m_waiting.wait();
+	playVoices(audioSystem, buffer);
+	audioDriver->m_start.set();
+
+	const bool captured = audioDriver->m_captured.wait(10000);
+	audioSystem->destroy();
+
+	outSamples = audioDriver->m_samples;
+	return captured;
+}
+
+/*! Mix voices in real time for a while and measure average time spent by mixer thread per frame. */
+double benchmark(bool parallelMixing, float virtualThreshold, uint32_t maxAudibleChannels, const IAudioBuffer* buffer, uint32_t& outVirtualCount)
+{
+	Ref< AudioSystem > audioSystem = new AudioSystem(new AudioDriverNull());
+	if (!audioSystem->create(createDesc(parallelMixing, virtualThreshold, maxAudibleChannels)))
+		return -1.0;
+
+	playVoices(audioSystem, buffer);
+	ThreadManager::getInstance().getCurrentThread()->sleep(c_benchmarkDuration);
+
+	double mixerTime = 0.0;
+	audioSystem->getThreadPerformances(mixerTime);
+
+	outVirtualCount = 0;
+	for (uint32_t i = 0; i < c_voiceCount; ++i)
+	{
+		if (audioSystem->getChannel(i)->isVirtual())
+			++outVirtualCount;
+	}
+
+	audioSystem->destroy();
+	return mixerTime;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.sound.test.CaseAudioMixer", 0, CaseAudioMixer, traktor::test::Case)
+
+void CaseAudioMixer::run()
+{
+	Ref< StaticAudioBuffer > buffer = createBuffer(2.0f, 220.0f);
+	CASE_ASSERT(buffer != nullptr);
+	if (!buffer)
+		return;
+
+	// Parallel mixing must produce identical output as serial mixing.
+	AlignedVector< float > serialSamples, parallelSamples;
+	CASE_ASSERT(captureFrame(false, buffer, serialSamples));
+	CASE_ASSERT(captureFrame(true, buffer, parallelSamples));
+	CASE_ASSERT_EQUAL(serialSamples.size(), size_t(c_frameSamples * 2));
+	CASE_ASSERT(serialSamples == parallelSamples);
+
+	bool audible = false;
+	for (auto sample : serialSamples)
+		audible |= (sample != 0.0f);
+	CASE_ASSERT(audible);
+
+	// Benchmark mixer using null driver.
+	uint32_t virtualCount[3];
+	const double serialTime = benchmark(false, 0.0f, 0, buffer, virtualCount[0]);
+	const double parallelTime = benchmark(true, 0.0f, 0, buffer, virtualCount[1]);
+	const double virtualTime = benchmark(true, 0.1f / c_voiceCount, c_maxAudibleChannels, buffer, virtualCount[2]);
+	CASE_ASSERT(serialTime >= 0.0);
+	CASE_ASSERT(parallelTime >= 0.0);
+	CASE_ASSERT(virtualTime >= 0.0);
+	CASE_ASSERT_EQUAL(virtualCount[0], 0);
+	CASE_ASSERT_EQUAL(virtualCount[1], 0);
+	CASE_ASSERT_EQUAL(virtualCount[2], c_voiceCount - c_maxAudibleChannels);
+
+	log::info << L"Audio mixer, " << c_voiceCount << L" voices; serial " << int32_t(serialTime * 1000000.0) << L" us, parallel " << int32_t(parallelTime * 1000000.0) << L" us, parallel with " << c_maxAudibleChannels << L" audible " << int32_t(virtualTime * 1000000.0) << L" us per frame" << Endl;
+
+	// Virtual voices should still advance in time; short sound should end while long continue.
+	{
+		Ref< StaticAudioBuffer > shortBuffer = createBuffer(0.1f, 440.0f);
+		CASE_ASSERT(shortBuffer != nullptr);
+
+		Ref< AudioSystem > audioSystem = new AudioSystem(new AudioDriverNull());
+		CASE_ASSERT(audioSystem->create(createDesc(false, 0.5f, 0)));
+
+		AudioChannel* shortChannel = audioSystem->getChannel(0);
+		shortChannel->setAudibility(0.0f);
+		shortChannel->play(shortBuffer, 0, 0.0f, false, 0);
+
+		AudioChannel* longChannel = audioSystem->getChannel(1);
+		longChannel->setAudibility(0.0f);
+		longChannel->play(buffer, 0, 0.0f, false, 0);
+
+		ThreadManager::getInstance().getCurrentThread()->sleep(500);
+
+		CASE_ASSERT(!shortChannel->isPlaying());
+		CASE_ASSERT(longChannel->isPlaying());
+		CASE_ASSERT(longChannel->isVirtual());
+
+		audioSystem->destroy();
+	}
+}
+
+}
@@ -0,0 +1,234 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include "Core/Log/Log.h"
+#include "Core/Misc/Align.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Core/Timer/Timer.h"
+#include "Sound/AudioChannel.h"
+#include "Sound/AudioDriverNull.h"
+#include "Sound/AudioSystem.h"
+#include "Sound/IStreamDecoder.h"
+#include "Sound/StreamAudioBuffer.h"
+#include "Sound/Test/CaseStreamAudio.h"
+
+namespace traktor::sound::test
+{
+	namespace
+	{
+
+const uint32_t c_sampleRate = 44100;
+const uint32_t c_streamCount = 64;
+const int32_t c_startDuration = 500;
+const int32_t c_benchmarkDuration = 2000;
+
+float expectedSample(uint32_t channel, uint64_t position)
+{
+	return float((position * (channel + 1)) % 977) / 977.0f;
+}
+
+/*! Decoder producing known samples in varying block sizes, simulating decoding cost. */
+class TestStreamDecoder : public IStreamDecoder
+{
+public:
+	explicit TestStreamDecoder(uint32_t samplesCount, double blockCost)
+	:	m_samplesCount(samplesCount)
+	,	m_blockCost(blockCost)
+	{
+	}
+
+	virtual bool create(IStream* stream) override final
+	{
+		return true;
+	}
+
+	virtual void destroy() override final
+	{
+	}
+
+	virtual double getDuration() const override final
+	{
+		return double(m_samplesCount) / c_sampleRate;
+	}
+
+	virtual bool getBlock(AudioBlock& outBlock) override final
+	{
+		const uint32_t blockSizes[] = { 333, 1000, 4096, 17 };
+		const uint32_t count = std::min({ outBlock.samplesCount, blockSizes[m_block++ % sizeof_array(blockSizes)], m_samplesCount - m_position });
+		if (!count)
+			return false;
+
+		for (uint32_t i = 0; i < 2; ++i)
+		{
+			for (uint32_t j = 0; j < count; ++j)
+				m_samples[i][j] = expectedSample(i, m_position + j);
+			outBlock.samples[i] = m_samples[i];
+		}
+
+		outBlock.samplesCount = count;
+		outBlock.sampleRate = c_sampleRate;
+		outBlock.maxChannel = 2;
+
+		m_position += count;
+
+		// Spin to simulate decoding cost.
+		Timer timer;
+		while (timer.getElapsedTime() < m_blockCost * count / 4096.0)
+			;
+
+		return true;
+	}
+
+	virtual void rewind() override final
+	{
+		m_position = 0;
+		m_block = 0;
+	}
+
+private:
+	uint32_t m_samplesCount;
+	double m_blockCost;
+	uint32_t m_position = 0;
+	uint32_t m_block = 0;
+	float T_ALIGN16 m_samples[2][4096];
+};
+
+/*! Read next block from stream, retry if decoder hasn't been able to keep up. */
+bool readBlock(const StreamAudioBuffer* buffer, IAudioBufferCursor* cursor, AudioBlock& outBlock)
+{
+	for (;;)
+	{
+		const uint32_t underruns = buffer->getUnderruns();
+
+		outBlock = { { 0 }, 512, 0, 0, 0 };
+		if (!buffer->getBlock(cursor, nullptr, outBlock))
+			return false;
+
+		if (buffer->getUnderruns() == underruns)
+			return true;
+
+		ThreadManager::getInstance().getCurrentThread()->sleep(1);
+	}
+}
+
+/*! Verify block contain expected samples; tail of stream is padded with zeros. */
+bool verifyBlock(const AudioBlock& block, uint64_t position, uint32_t samplesCount)
+{
+	bool same = (block.maxChannel == 2 && block.sampleRate == c_sampleRate);
+	for (uint32_t i = 0; same && i < 2; ++i)
+	{
+		for (uint32_t j = 0; same && j < block.samplesCount; ++j)
+		{
+			const float expected = (position + j < samplesCount) ? expectedSample(i, position + j) : 0.0f;
+			same &= (block.samples[i][j] == expected);
+		}
+	}
+	return same;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.sound.test.CaseStreamAudio", 0, CaseStreamAudio, traktor::test::Case)
+
+void CaseStreamAudio::run()
+{
+	// Read entire stream through two cursors, interleaved, to exercise seeking.
+	{
+		const uint32_t samplesCount = c_sampleRate * 2 + 123;
+
+		Ref< StreamAudioBuffer > buffer = new StreamAudioBuffer();
+		CASE_ASSERT(buffer->create(new TestStreamDecoder(samplesCount, 0.0), 0.1f));
+
+		Ref< IAudioBufferCursor > cursors[] = { buffer->createCursor(), buffer->createCursor() };
+		uint64_t positions[] = { 0, 0 };
+		bool ended[] = { false, false };
+		bool same = true;
+
+		for (uint32_t i = 0; !ended[0] || !ended[1]; ++i)
+		{
+			// Mostly read from first cursor, sometimes let the second cursor catch up.
+			const uint32_t c = (!ended[1] && ((i % 7) == 6 || ended[0])) ? 1 : 0;
+
+			AudioBlock block;
+			if (!readBlock(buffer, cursors[c], block))
+			{
+				ended[c] = true;
+				continue;
+			}
+
+			same &= verifyBlock(block, positions[c], samplesCount);
+			positions[c] += block.samplesCount;
+		}
+
+		CASE_ASSERT(same);
+		CASE_ASSERT_EQUAL(positions[0], alignUp(samplesCount, 4));
+		CASE_ASSERT_EQUAL(positions[1], alignUp(samplesCount, 4));
+
+		// Reset cursor should rewind stream.
+		cursors[0]->reset();
+
+		AudioBlock block;
+		CASE_ASSERT(readBlock(buffer, cursors[0], block));
+		CASE_ASSERT(verifyBlock(block, 0, samplesCount));
+
+		buffer->destroy();
+	}
+
+	// Play many concurrent, repeating, streams through null driver.
+	{
+		Ref< AudioSystem > audioSystem = new AudioSystem(new AudioDriverNull());
+
+		AudioSystemCreateDesc desc;
+		desc.channels = c_streamCount;
+		desc.driverDesc.sampleRate = c_sampleRate;
+		desc.driverDesc.bitsPerSample = 16;
+		desc.driverDesc.hwChannels = 2;
+		desc.driverDesc.frameSamples = 512;
+		CASE_ASSERT(audioSystem->create(desc));
+
+		// Streams are of different lengths so they loop at different times.
+		RefArray< StreamAudioBuffer > buffers;
+		bool created = true;
+		for (uint32_t i = 0; i < c_streamCount; ++i)
+		{
+			Ref< StreamAudioBuffer > buffer = new StreamAudioBuffer();
+			created &= buffer->create(new TestStreamDecoder(c_sampleRate / 2 + i * 100, 0.0002));
+			audioSystem->getChannel(i)->play(buffer, 0, 0.0f, true, 0);
+			buffers.push_back(buffer);
+		}
+		CASE_ASSERT(created);
+
+		// Underruns are expected when all streams start at once.
+		ThreadManager::getInstance().getCurrentThread()->sleep(c_startDuration);
+		const uint32_t startUnderruns = audioSystem->getStreamUnderruns();
+
+		ThreadManager::getInstance().getCurrentThread()->sleep(c_benchmarkDuration);
+		const uint32_t underruns = audioSystem->getStreamUnderruns() - startUnderruns;
+
+		double mixerTime = 0.0;
+		audioSystem->getThreadPerformances(mixerTime);
+
+		uint32_t playing = 0;
+		for (uint32_t i = 0; i < c_streamCount; ++i)
+		{
+			if (audioSystem->getChannel(i)->isPlaying())
+				++playing;
+		}
+		CASE_ASSERT_EQUAL(playing, c_streamCount);
+
+		log::info << L"Stream audio, " << c_streamCount << L" streams; mixer " << int32_t(mixerTime * 1000000.0) << L" us per frame; " << startUnderruns << L" underruns during start, " << underruns << L" after" << Endl;
+
+		audioSystem->destroy();
+		for (auto buffer : buffers)
+			buffer->destroy();
+	}
+}
+
+}
@@ -84,9 +84,15 @@ struct AudioSystemCreateDesc
 	uint32_t channels;									//!< Number of virtual channels.
 	AudioDriverCreateDesc driverDesc;					//!< Driver create description.
 	float cm[SbcMaxChannelCount][SbcMaxChannelCount];	//!< Final combine matrix.
+	bool parallelMixing;								//!< Render channels in parallel using job manager.
+	float virtualThreshold;								//!< Channels with lower estimated gain are virtualized, i.e. only tracked in time.
+	uint32_t maxAudibleChannels;						//!< Max number of rendered channels, lowest priority are virtualized; 0 means unlimited.
 
 	AudioSystemCreateDesc()
 	:	channels(0)
+	,	parallelMixing(false)
+	,	virtualThreshold(0.0f)
+	,	maxAudibleChannels(0)
 	{
 		for (int32_t i = 0; i < SbcMaxChannelCount; ++i)
 			for (int32_t j = 0; j < SbcMaxChannelCount; ++j)
@@ -50,7 +50,7 @@ void MovieLoader::setTriangulate(bool triangulate)
 Ref< MovieResult > MovieLoader::loadAsync(const std::wstring& url) const
 {
 	Ref< MovieResult > result = new MovieResult();
-	JobManager::getInstance().add([=](){
+	JobManager::getInstance().addDetached([=](){
 		T_ANONYMOUS_VAR(Ref< const MovieLoader >)(this);
 		Ref< Movie > movie;
 
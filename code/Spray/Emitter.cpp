@@ -40,7 +40,7 @@ Ref< IEmitterInstance > Emitter::createInstance(resource::IResourceManager* reso
 	if (m_data->m_gpu && m_data->m_capacity > 0)
 		return EmitterInstanceGPU::createInstance(resourceManager, gpuBufferPool, this, m_data->m_capacity, duration);
 	else
-		return EmitterInstanceCPU::createInstance(this, duration);
+		return EmitterInstanceCPU::createInstance(this, m_data->m_capacity, duration);
 }
 
 }
@@ -7,6 +7,8 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include <stdlib.h>
+#include "Core/Containers/StaticVector.h"
+#include "Core/Misc/Align.h"
 #include "Core/Misc/SafeDestroy.h"
 #include "Core/Thread/JobManager.h"
 #include "Mesh/Instance/InstanceMesh.h"
@@ -35,21 +37,22 @@ namespace traktor::spray
 const float c_warmUpDeltaTime = 1.0f / 5.0f;
 #if defined(__IOS__) || defined(__ANDROID__)
 const uint32_t c_maxEmitPerUpdate = 4;
-const uint32_t c_maxEmitSingleShot = 10;
+const uint32_t c_maxAlive = 10;
 #else
 const uint32_t c_maxEmitPerUpdate = 64;
-const uint32_t c_maxEmitSingleShot = 400;
+const uint32_t c_maxAlive = 1024 * 1024;
 #endif
 
-const uint32_t c_maxAlive = c_maxEmitSingleShot;
+const uint32_t c_minPointsPerTask = 4096;
+const uint32_t c_maxTasks = 16;
 
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.spray.EmitterInstanceCPU", EmitterInstanceCPU, IEmitterInstance)
 
-Ref< EmitterInstanceCPU > EmitterInstanceCPU::createInstance(const Emitter* emitter, float duration)
+Ref< EmitterInstanceCPU > EmitterInstanceCPU::createInstance(const Emitter* emitter, uint32_t capacity, float duration)
 {
-	return new EmitterInstanceCPU(emitter, duration);
+	return new EmitterInstanceCPU(emitter, capacity, duration);
 }
 
 EmitterInstanceCPU::~EmitterInstanceCPU()
@@ -87,15 +90,16 @@ void EmitterInstanceCPU::update(Context& context, const Transform& transform, bo
 
 	// Erase dead particles.
 	size_t size = m_points.size();
+	float* age = m_points.stream(PointStreams::Age);
+	const float* maxAge = m_points.stream(PointStreams::MaxAge);
 	if (!m_emitter->getEffect() || m_effectInstances.size() != m_points.size())
 	{
 		for (size_t i = 0; i < size; )
 		{
-			Point& point = m_points[i];
-			if ((point.age += context.deltaTime) < point.maxAge)
+			if ((age[i] += context.deltaTime) < maxAge[i])
 				++i;
 			else if (i < --size)
-				point = m_points[size];
+				m_points.copy(i, size);
 		}
 		m_points.resize(size);
 	}
@@ -103,12 +107,11 @@ void EmitterInstanceCPU::update(Context& context, const Transform& transform, bo
 	{
 		for (size_t i = 0; i < size; )
 		{
-			Point& point = m_points[i];
-			if ((point.age += context.deltaTime) < point.maxAge)
+			if ((age[i] += context.deltaTime) < maxAge[i])
 				++i;
 			else if (i < --size)
 			{
-				point = m_points[size];
+				m_points.copy(i, size);
 				m_effectInstances[i] = m_effectInstances[size];
 			}
 		}
@@ -122,7 +125,7 @@ void EmitterInstanceCPU::update(Context& context, const Transform& transform, bo
 		const Source* source = m_emitter->getSource();
 		if (source)
 		{
-			const uint32_t avail = (uint32_t)(m_points.capacity() - size);
+			const uint32_t avail = (size < m_maxAlive) ? (uint32_t)(m_maxAlive - size) : 0;
 			const Vector4 dm = (lastPosition - m_transform.translation()).xyz0();
 
 			if (!singleShot)
@@ -135,17 +138,9 @@ void EmitterInstanceCPU::update(Context& context, const Transform& transform, bo
 				// Emit in multiple frames; estimate number of particles to emit.
 				if (emitCountFrame > 0)
 				{
-					emitCountFrame = min< uint32_t >(emitCountFrame, avail, c_maxEmitPerUpdate);
+					emitCountFrame = min< uint32_t >(emitCountFrame, avail, max< uint32_t >(c_maxEmitPerUpdate, m_maxAlive / 16));
 					if (emitCountFrame > 0)
-					{
-						source->emit(
-							context,
-							m_emitter->worldSpace() ? m_transform : Transform::identity(),
-							dm,
-							emitCountFrame,
-							*this
-						);
-					}
+						emitPoints(context, source, dm, emitCountFrame);
 				}
 
 				// Preserve fraction of non-emitted particles.
@@ -154,17 +149,9 @@ void EmitterInstanceCPU::update(Context& context, const Transform& transform, bo
 			else
 			{
 				// Single shot emit; emit all particles in one frame and then no more.
-				const uint32_t emitCount = min< uint32_t >(uint32_t(source->getConstantRate()), avail, c_maxEmitSingleShot);
+				const uint32_t emitCount = min< uint32_t >(uint32_t(source->getConstantRate()), avail);
 				if (emitCount > 0)
-				{
-					source->emit(
-						context,
-						m_emitter->worldSpace() ? m_transform : Transform::identity(),
-						dm,
-						emitCount,
-						*this
-					);
-				}
+					emitPoints(context, source, dm, emitCount);
 			}
 		}
 	}
@@ -175,13 +162,46 @@ void EmitterInstanceCPU::update(Context& context, const Transform& transform, bo
 	// asynchronously.
 	if ((m_count & 15) == 0)
 	{
+		const float* px = m_points.stream(PointStreams::PositionX);
+		const float* py = m_points.stream(PointStreams::PositionY);
+		const float* pz = m_points.stream(PointStreams::PositionZ);
+		const float* vx = m_points.stream(PointStreams::VelocityX);
+		const float* vy = m_points.stream(PointStreams::VelocityY);
+		const float* vz = m_points.stream(PointStreams::VelocityZ);
+		const Vector4 deltaTime16(Scalar(context.deltaTime * 16.0f));
+
 		m_boundingBox = Aabb3();
-		const Scalar deltaTime16 = Scalar(context.deltaTime * 16.0f);
-		for (const auto& point : m_points)
+
+		// Accumulate four points at a time, remaining points are added individually.
+		size = m_points.size();
+		if (size >= 4)
+		{
+			Vector4 mnx = Vector4::loadAligned(px), mxx = mnx;
+			Vector4 mny = Vector4::loadAligned(py), mxy = mny;
+			Vector4 mnz = Vector4::loadAligned(pz), mxz = mnz;
+			for (size_t i = 0; i < (size & ~3); i += 4)
+			{
+				const Vector4 x = Vector4::loadAligned(&px[i]);
+				const Vector4 y = Vector4::loadAligned(&py[i]);
+				const Vector4 z = Vector4::loadAligned(&pz[i]);
+				const Vector4 ex = x + Vector4::loadAligned(&vx[i]) * deltaTime16;
+				const Vector4 ey = y + Vector4::loadAligned(&vy[i]) * deltaTime16;
+				const Vector4 ez = z + Vector4::loadAligned(&vz[i]) * deltaTime16;
+				mnx = min(mnx, min(x, ex)); mxx = max(mxx, max(x, ex));
+				mny = min(mny, min(y, ey)); mxy = max(mxy, max(y, ey));
+				mnz = min(mnz, min(z, ez)); mxz = max(mxz, max(z, ez));
+			}
+			m_boundingBox.contain(Vector4(mnx.min(), mny.min(), mnz.min(), 1.0f));
+			m_boundingBox.contain(Vector4(mxx.max(), mxy.max(), mxz.max(), 1.0f));
+		}
+		for (size_t i = (size & ~3); i < size; ++i)
 		{
-			m_boundingBox.contain(point.position);
-			m_boundingBox.contain(point.position + point.velocity * deltaTime16);
+			const Vector4 position(px[i], py[i], pz[i], 1.0f);
+			const Vector4 velocity(vx[i], vy[i], vz[i], 0.0f);
+			m_boundingBox.contain(position);
+			m_boundingBox.contain(position + velocity * deltaTime16);
 		}
+
 		m_boundingBox = m_boundingBox.expand(1.0_simd);
 		if (!m_emitter->worldSpace())
 			m_boundingBox = m_boundingBox.transform(transform);
@@ -300,49 +320,61 @@ void EmitterInstanceCPU::synchronize() const
 #endif
 }
 
-EmitterInstanceCPU::EmitterInstanceCPU(const Emitter* emitter, float duration)
+EmitterInstanceCPU::EmitterInstanceCPU(const Emitter* emitter, uint32_t capacity, float duration)
 :	m_emitter(emitter)
 ,	m_transform(Transform::identity())
 ,	m_sortPlane(Vector4(0.0f, 0.0f, -1.0f), 0.0_simd)
 ,	m_totalTime(0.0f)
 ,	m_emitFraction(0.0f)
 ,	m_warm(false)
+,	m_maxAlive(min< uint32_t >(capacity, c_maxAlive))
 ,	m_count(0)
 ,	m_skip(1)
 {
-	m_points.reserve(c_maxAlive);
-	m_renderPoints.reserve(c_maxAlive);
+	m_points.reserve(m_maxAlive);
+	m_renderPoints.reserve(m_maxAlive);
+}
+
+void EmitterInstanceCPU::emitPoints(Context& context, const Source* source, const Vector4& deltaMotion, uint32_t emitCount)
+{
+	m_emitPoints.resize(0);
+	source->emit(
+		context,
+		m_emitter->worldSpace() ? m_transform : Transform::identity(),
+		deltaMotion,
+		emitCount,
+		*this
+	);
+	m_points.append(m_emitPoints.c_ptr(), m_emitPoints.size());
 }
 
 void EmitterInstanceCPU::updateTask(float deltaTime)
 {
 	const Transform updateTransform = m_emitter->worldSpace() ? m_transform : Transform::identity();
 	const Scalar deltaTimeScalar(deltaTime);
+	const size_t size = m_points.size();
 
-	for (auto modifier : m_emitter->getModifiers())
-	{
-		modifier->update(
-			deltaTimeScalar,
-			updateTransform,
-			m_points,
-			0,
-			m_points.size()
-		);
-	}
-
-	m_renderPoints.resize(0);
+	m_renderPoints.resize((size + m_skip - 1) / m_skip);
 
-	for (uint32_t i = 0; i < m_points.size(); i += m_skip)
-		m_renderPoints.push_back(m_points[i]);
-
-	if (!m_emitter->worldSpace())
+	// Split points into chunks, each chunk is modified and
+	// gathered into render points independently.
+	const size_t ntasks = clamp< size_t >(size / c_minPointsPerTask, 1, c_maxTasks);
+	if (ntasks > 1)
 	{
-		for (uint32_t i = 0; i < m_renderPoints.size(); ++i)
+		const size_t chunk = alignUp((size + ntasks - 1) / ntasks, 4);
+
+		StaticVector< Job::task_t, c_maxTasks > tasks;
+		for (size_t first = 0; first < size; first += chunk)
 		{
-			m_renderPoints[i].position = m_transform * m_renderPoints[i].position;
-			m_renderPoints[i].velocity = m_transform * m_renderPoints[i].velocity;
+			const size_t last = std::min(first + chunk, size);
+			tasks.push_back([=, this]() {
+				updateRange(deltaTimeScalar, updateTransform, first, last);
+			});
 		}
+		JobManager::getInstance().fork(tasks.c_ptr(), tasks.size());
 	}
+	else
+		updateRange(deltaTimeScalar, updateTransform, 0, size);
 
 	// \note Do not sort furthest lod.
 	if (
@@ -390,4 +422,26 @@ void EmitterInstanceCPU::updateTask(float deltaTime)
 	m_count++;
 }
 
+void EmitterInstanceCPU::updateRange(const Scalar& deltaTime, const Transform& updateTransform, size_t first, size_t last)
+{
+	// Modifiers always process whole lanes of four points.
+	for (auto modifier : m_emitter->getModifiers())
+		modifier->update(deltaTime, updateTransform, m_points, first, alignUp(last, 4));
+
+	// Gather every m_skip point; first is always a multiple of
+	// four thus also aligned with skip.
+	const size_t from = first / m_skip;
+	const size_t to = (last + m_skip - 1) / m_skip;
+	m_points.gather(first, last, m_skip, m_renderPoints.ptr() + from);
+
+	if (!m_emitter->worldSpace())
+	{
+		for (size_t i = from; i < to; ++i)
+		{
+			m_renderPoints[i].position = m_transform * m_renderPoints[i].position;
+			m_renderPoints[i].velocity = m_transform * m_renderPoints[i].velocity;
+		}
+	}
+}
+
 }
@@ -14,6 +14,7 @@
 #include "Spray/IEmitterInstance.h"
 #include "Spray/Modifier.h"
 #include "Spray/Point.h"
+#include "Spray/PointStreams.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -35,6 +36,7 @@ namespace traktor::spray
 
 class EffectInstance;
 class Emitter;
+class Source;
 
 /*! Emitter instance.
  * \ingroup Spray
@@ -44,7 +46,7 @@ class T_DLLCLASS EmitterInstanceCPU : public IEmitterInstance
 	T_RTTI_CLASS;
 
 public:
-	static Ref< EmitterInstanceCPU > createInstance(const Emitter* emitter, float duration);
+	static Ref< EmitterInstanceCPU > createInstance(const Emitter* emitter, uint32_t capacity, float duration);
 
 	virtual ~EmitterInstanceCPU();
 
@@ -68,35 +70,46 @@ public:
 
 	float getTotalTime() const { return m_totalTime; }
 
-	void reservePoints(uint32_t npoints) { m_points.reserve(m_points.size() + npoints); }
+	void reservePoints(uint32_t npoints) { m_emitPoints.reserve(m_emitPoints.size() + npoints); }
 
-	const pointVector_t& getPoints() const { return m_points; }
+	const PointStreams& getPoints() const { return m_points; }
 
+	/*! Add points, called by sources when emitting.
+	 *
+	 * Emitted points are staged and appended
+	 * to the point streams once source is done.
+	 */
 	Point* addPoints(uint32_t points)
 	{
-		const uint32_t offset = uint32_t(m_points.size());
-		m_points.resize(offset + points);
-		return &m_points[offset];
+		const uint32_t offset = uint32_t(m_emitPoints.size());
+		m_emitPoints.resize(offset + points);
+		return &m_emitPoints[offset];
 	}
 
 private:
 	Ref< const Emitter > m_emitter;
 	Transform m_transform;
 	Plane m_sortPlane;
-	pointVector_t m_points;
+	PointStreams m_points;
+	pointVector_t m_emitPoints;
 	pointVector_t m_renderPoints;
 	RefArray< EffectInstance > m_effectInstances;
 	float m_totalTime;
 	float m_emitFraction;
 	bool m_warm;
 	Aabb3 m_boundingBox;
+	uint32_t m_maxAlive;
 	uint32_t m_count;
 	uint32_t m_skip;
 	mutable Ref< Job > m_job;
 
-	explicit EmitterInstanceCPU(const Emitter* emitter, float duration);
+	explicit EmitterInstanceCPU(const Emitter* emitter, uint32_t capacity, float duration);
+
+	void emitPoints(Context& context, const Source* source, const Vector4& deltaMotion, uint32_t emitCount);
 
 	void updateTask(float deltaTime);
+
+	void updateRange(const Scalar& deltaTime, const Transform& updateTransform, size_t first, size_t last);
 };
 
 }
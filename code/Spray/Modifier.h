@@ -10,7 +10,7 @@
 
 #include "Core/Math/Transform.h"
 #include "Core/Object.h"
-#include "Spray/Point.h"
+#include "Spray/PointStreams.h"
 
 namespace traktor::spray
 {
@@ -25,7 +25,14 @@ class Modifier : public Object
 public:
 	virtual void writeSequence(Vector4*& inoutSequence) const {};
 
-	virtual void update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const = 0;
+	/*! Update points.
+	 *
+	 * Range is always a multiple of four points and might
+	 * extend into the padding of the point streams, thus
+	 * modifiers are free to process four points at a time.
+	 * Disjoint ranges might be updated concurrently.
+	 */
+	virtual void update(const Scalar& deltaTime, const Transform& transform, PointStreams& points, size_t first, size_t last) const = 0;
 };
 
 }
@@ -6,6 +6,8 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
+#include "Core/Math/Random.h"
 #include "Spray/Modifiers/BrownianModifier.h"
 
 namespace traktor::spray
@@ -15,6 +17,7 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.spray.BrownianModifier", BrownianModifier, Modi
 
 BrownianModifier::BrownianModifier(float factor)
 :	m_factor(factor)
+,	m_seed(5489UL)
 {
 }
 
@@ -28,16 +31,24 @@ void BrownianModifier::writeSequence(Vector4*& inoutSequence) const
 	);
 }
 
-void BrownianModifier::update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const
+void BrownianModifier::update(const Scalar& deltaTime, const Transform& transform, PointStreams& points, size_t first, size_t last) const
 {
+	// Ranges might be updated concurrently thus each update use its own generator.
+	Random random(m_seed++);
+
+	float* vx = points.stream(PointStreams::VelocityX);
+	float* vy = points.stream(PointStreams::VelocityY);
+	float* vz = points.stream(PointStreams::VelocityZ);
+	const float* inverseMass = points.stream(PointStreams::InverseMass);
+
+	const float f = m_factor * deltaTime;
+	last = std::min(last, points.size());
 	for (size_t i = first; i < last; ++i)
 	{
-		const Vector4 r(
-			m_random.nextFloat() * 2.0f - 1.0f,
-			m_random.nextFloat() * 2.0f - 1.0f,
-			m_random.nextFloat() * 2.0f - 1.0f
-		);
-		points[i].velocity += (r * m_factor * deltaTime) * Scalar(points[i].inverseMass);
+		const float s = f * inverseMass[i];
+		vx[i] += (random.nextFloat() * 2.0f - 1.0f) * s;
+		vy[i] += (random.nextFloat() * 2.0f - 1.0f) * s;
+		vz[i] += (random.nextFloat() * 2.0f - 1.0f) * s;
 	}
 }
 
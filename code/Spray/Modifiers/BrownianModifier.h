@@ -8,7 +8,7 @@
  */
 #pragma once
 
-#include "Core/Math/Random.h"
+#include <atomic>
 #include "Spray/Modifier.h"
 
 namespace traktor::spray
@@ -28,11 +28,11 @@ public:
 
 	virtual void writeSequence(Vector4*& inoutSequence) const override final;
 
-	virtual void update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const override final;
+	virtual void update(const Scalar& deltaTime, const Transform& transform, PointStreams& points, size_t first, size_t last) const override final;
 
 private:
 	Scalar m_factor;
-	mutable Random m_random;
+	mutable std::atomic< uint32_t > m_seed;
 };
 
 }
@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include "Spray/Modifiers/CurlNoiseModifier.h"
 
 namespace traktor::spray
@@ -58,12 +59,24 @@ CurlNoiseModifier::CurlNoiseModifier(float factor)
 {
 }
 
-void CurlNoiseModifier::update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const
+void CurlNoiseModifier::update(const Scalar& deltaTime, const Transform& transform, PointStreams& points, size_t first, size_t last) const
 {
+	float* vx = points.stream(PointStreams::VelocityX);
+	float* vy = points.stream(PointStreams::VelocityY);
+	float* vz = points.stream(PointStreams::VelocityZ);
+	const float* px = points.stream(PointStreams::PositionX);
+	const float* py = points.stream(PointStreams::PositionY);
+	const float* pz = points.stream(PointStreams::PositionZ);
+	const float* inverseMass = points.stream(PointStreams::InverseMass);
+
+	last = std::min(last, points.size());
 	for (size_t i = first; i < last; ++i)
 	{
-		const Vector4 r = curlNoise(points[i].position);
-		points[i].velocity += (r * m_factor * deltaTime) * Scalar(points[i].inverseMass);
+		const Vector4 r = curlNoise(Vector4(px[i], py[i], pz[i], 1.0f));
+		const Vector4 dv = (r * m_factor * deltaTime) * Scalar(inverseMass[i]);
+		vx[i] += dv.x();
+		vy[i] += dv.y();
+		vz[i] += dv.z();
 	}
 }
 
@@ -24,7 +24,7 @@ class CurlNoiseModifier : public Modifier
 public:
 	explicit CurlNoiseModifier(float factor);
 
-	virtual void update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const override final;
+	virtual void update(const Scalar& deltaTime, const Transform& transform, PointStreams& points, size_t first, size_t last) const override final;
 
 private:
 	Scalar m_factor;
@@ -29,15 +29,22 @@ void DragModifier::writeSequence(Vector4*& inoutSequence) const
 	);
 }
 
-void DragModifier::update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const
+void DragModifier::update(const Scalar& deltaTime, const Transform& transform, PointStreams& points, size_t first, size_t last) const
 {
-	const Scalar dv = 1.0_simd - m_linearDrag * deltaTime;
-	const float da = 1.0f - m_angularDrag * deltaTime;
+	const Vector4 dv(1.0_simd - m_linearDrag * deltaTime);
+	const Vector4 da(1.0_simd - Scalar(m_angularDrag) * deltaTime);
 
-	for (size_t i = first; i < last; ++i)
+	float* vx = points.stream(PointStreams::VelocityX);
+	float* vy = points.stream(PointStreams::VelocityY);
+	float* vz = points.stream(PointStreams::VelocityZ);
+	float* angularVelocity = points.stream(PointStreams::AngularVelocity);
+
+	for (size_t i = first; i < last; i += 4)
 	{
-		points[i].velocity *= dv;
-		points[i].angularVelocity *= da;
+		(Vector4::loadAligned(&vx[i]) * dv).storeAligned(&vx[i]);
+		(Vector4::loadAligned(&vy[i]) * dv).storeAligned(&vy[i]);
+		(Vector4::loadAligned(&vz[i]) * dv).storeAligned(&vz[i]);
+		(Vector4::loadAligned(&angularVelocity[i]) * da).storeAligned(&angularVelocity[i]);
 	}
 }
 
@@ -29,11 +29,25 @@ void GravityModifier::writeSequence(Vector4*& inoutSequence) const
 	);
 }
 
-void GravityModifier::update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const
+void GravityModifier::update(const Scalar& deltaTime, const Transform& transform, PointStreams& points, size_t first, size_t last) const
 {
 	const Vector4 gravity = (m_world ? m_gravity : transform * m_gravity) * deltaTime;
-	for (size_t i = first; i < last; ++i)
-		points[i].velocity += gravity * Scalar(points[i].inverseMass);
+	const Vector4 gx(gravity.x());
+	const Vector4 gy(gravity.y());
+	const Vector4 gz(gravity.z());
+
+	float* vx = points.stream(PointStreams::VelocityX);
+	float* vy = points.stream(PointStreams::VelocityY);
+	float* vz = points.stream(PointStreams::VelocityZ);
+	const float* inverseMass = points.stream(PointStreams::InverseMass);
+
+	for (size_t i = first; i < last; i += 4)
+	{
+		const Vector4 im = Vector4::loadAligned(&inverseMass[i]);
+		(Vector4::loadAligned(&vx[i]) + gx * im).storeAligned(&vx[i]);
+		(Vector4::loadAligned(&vy[i]) + gy * im).storeAligned(&vy[i]);
+		(Vector4::loadAligned(&vz[i]) + gz * im).storeAligned(&vz[i]);
+	}
 }
 
 }
@@ -27,7 +27,7 @@ public:
 
 	virtual void writeSequence(Vector4*& inoutSequence) const override final;
 
-	virtual void update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const override final;
+	virtual void update(const Scalar& deltaTime, const Transform& transform, PointStreams& points, size_t first, size_t last) const override final;
 
 private:
 	Vector4 m_gravity;
@@ -30,26 +30,36 @@ void IntegrateModifier::writeSequence(Vector4*& inoutSequence) const
 	);
 }
 
-void IntegrateModifier::update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const
+void IntegrateModifier::update(const Scalar& deltaTime, const Transform& transform, PointStreams& points, size_t first, size_t last) const
 {
-	const Scalar scaledDeltaTime = deltaTime * m_timeScale;
-	if (m_linear && m_angular)
+	const Vector4 scaledDeltaTime(deltaTime * m_timeScale);
+
+	if (m_linear)
 	{
-		for (size_t i = first; i < last; ++i)
+		float* px = points.stream(PointStreams::PositionX);
+		float* py = points.stream(PointStreams::PositionY);
+		float* pz = points.stream(PointStreams::PositionZ);
+		const float* vx = points.stream(PointStreams::VelocityX);
+		const float* vy = points.stream(PointStreams::VelocityY);
+		const float* vz = points.stream(PointStreams::VelocityZ);
+		const float* inverseMass = points.stream(PointStreams::InverseMass);
+
+		for (size_t i = first; i < last; i += 4)
 		{
-			points[i].position += points[i].velocity * Scalar(points[i].inverseMass) * scaledDeltaTime;
-			points[i].orientation += points[i].angularVelocity * scaledDeltaTime;
+			const Vector4 s = Vector4::loadAligned(&inverseMass[i]) * scaledDeltaTime;
+			(Vector4::loadAligned(&px[i]) + Vector4::loadAligned(&vx[i]) * s).storeAligned(&px[i]);
+			(Vector4::loadAligned(&py[i]) + Vector4::loadAligned(&vy[i]) * s).storeAligned(&py[i]);
+			(Vector4::loadAligned(&pz[i]) + Vector4::loadAligned(&vz[i]) * s).storeAligned(&pz[i]);
 		}
 	}
-	else if (m_linear)
-	{
-		for (size_t i = first; i < last; ++i)
-			points[i].position += points[i].velocity * Scalar(points[i].inverseMass) * scaledDeltaTime;
-	}
-	else if (m_angular)
+
+	if (m_angular)
 	{
-		for (size_t i = first; i < last; ++i)
-			points[i].orientation += points[i].angularVelocity * scaledDeltaTime;
+		float* orientation = points.stream(PointStreams::Orientation);
+		const float* angularVelocity = points.stream(PointStreams::AngularVelocity);
+
+		for (size_t i = first; i < last; i += 4)
+			(Vector4::loadAligned(&orientation[i]) + Vector4::loadAligned(&angularVelocity[i]) * scaledDeltaTime).storeAligned(&orientation[i]);
 	}
 }
 
@@ -20,25 +20,47 @@ PlaneCollisionModifier::PlaneCollisionModifier(const Plane& plane, float radius,
 {
 }
 
-void PlaneCollisionModifier::update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const
+void PlaneCollisionModifier::update(const Scalar& deltaTime, const Transform& transform, PointStreams& points, size_t first, size_t last) const
 {
 	const Plane planeW = transform.toMatrix44() * m_plane;
 	const Vector4 center = transform.translation();
+	const Vector4 normal = m_plane.normal().normalized();
 
-	for (size_t i = first; i < last; ++i)
-	{
-		const Scalar rv = dot3(planeW.normal(), points[i].velocity);
-		if (rv >= 0.0_simd)
-			continue;
+	const Vector4 wx(planeW.normal().x()), wy(planeW.normal().y()), wz(planeW.normal().z()), wd(planeW.distance());
+	const Vector4 cx(center.x()), cy(center.y()), cz(center.z());
+	const Vector4 nx(normal.x()), ny(normal.y()), nz(normal.z());
+	const Vector4 radius(m_radius);
+	const Vector4 restitution(m_restitution);
+
+	const float* px = points.stream(PointStreams::PositionX);
+	const float* py = points.stream(PointStreams::PositionY);
+	const float* pz = points.stream(PointStreams::PositionZ);
+	float* vx = points.stream(PointStreams::VelocityX);
+	float* vy = points.stream(PointStreams::VelocityY);
+	float* vz = points.stream(PointStreams::VelocityZ);
+	const float* size = points.stream(PointStreams::Size);
 
-		const Scalar rd = planeW.distance(points[i].position);
-		if (rd >= points[i].size)
-			continue;
+	for (size_t i = first; i < last; i += 4)
+	{
+		const Vector4 x = Vector4::loadAligned(&px[i]);
+		const Vector4 y = Vector4::loadAligned(&py[i]);
+		const Vector4 z = Vector4::loadAligned(&pz[i]);
+		const Vector4 u = Vector4::loadAligned(&vx[i]);
+		const Vector4 v = Vector4::loadAligned(&vy[i]);
+		const Vector4 w = Vector4::loadAligned(&vz[i]);
 
-		if ((points[i].position - center).length2() >= m_radius)
-			continue;
+		// Collide only if moving towards plane, within size of plane and inside radius; ie all negative.
+		const Vector4 rv = wx * u + wy * v + wz * w;
+		const Vector4 rd = wx * x + wy * y + wz * z - wd - Vector4::loadAligned(&size[i]);
+		const Vector4 dx = x - cx, dy = y - cy, dz = z - cz;
+		const Vector4 rr = dx * dx + dy * dy + dz * dz - radius;
+		const Vector4 collide = max(max(rv, rd), rr);
 
-		points[i].velocity = -reflect(points[i].velocity, m_plane.normal()) * m_restitution;
+		// Reflect velocity around plane normal.
+		const Vector4 d = (nx * u + ny * v + nz * w) * Vector4(2.0_simd);
+		select(collide, (u - nx * d) * restitution, u).storeAligned(&vx[i]);
+		select(collide, (v - ny * d) * restitution, v).storeAligned(&vy[i]);
+		select(collide, (w - nz * d) * restitution, w).storeAligned(&vz[i]);
 	}
 }
 
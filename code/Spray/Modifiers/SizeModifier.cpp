@@ -28,11 +28,13 @@ void SizeModifier::writeSequence(Vector4*& inoutSequence) const
 	);
 }
 
-void SizeModifier::update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const
+void SizeModifier::update(const Scalar& deltaTime, const Transform& transform, PointStreams& points, size_t first, size_t last) const
 {
-	const float deltaSize = m_adjustRate * deltaTime;
-	for (size_t i = first; i < last; ++i)
-		points[i].size += deltaSize;
+	const Vector4 deltaSize(Scalar(m_adjustRate) * deltaTime);
+
+	float* size = points.stream(PointStreams::Size);
+	for (size_t i = first; i < last; i += 4)
+		(Vector4::loadAligned(&size[i]) + deltaSize).storeAligned(&size[i]);
 }
 
 }
@@ -0,0 +1,151 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cstring>
+#include "Core/Misc/Align.h"
+#include "Spray/PointStreams.h"
+
+namespace traktor::spray
+{
+
+void PointStreams::reserve(size_t capacity)
+{
+	capacity = alignUp(capacity, 4);
+	if (capacity <= m_capacity)
+		return;
+
+	AlignedVector< float > data(capacity * StreamCount);
+	if (m_size > 0)
+	{
+		const size_t copySize = alignUp(m_size, 4) * sizeof(float);
+		for (int32_t i = 0; i < StreamCount; ++i)
+			std::memcpy(data.ptr() + i * capacity, m_data.c_ptr() + i * m_capacity, copySize);
+	}
+
+	m_data.swap(data);
+	m_capacity = capacity;
+}
+
+void PointStreams::resize(size_t size)
+{
+	if (size > m_capacity)
+		reserve(std::max(size, m_capacity * 2));
+	m_size = size;
+}
+
+void PointStreams::append(const Point* points, size_t count)
+{
+	const size_t offset = m_size;
+	resize(m_size + count);
+
+	float* px = stream(PositionX) + offset;
+	float* py = stream(PositionY) + offset;
+	float* pz = stream(PositionZ) + offset;
+	float* vx = stream(VelocityX) + offset;
+	float* vy = stream(VelocityY) + offset;
+	float* vz = stream(VelocityZ) + offset;
+	float* orientation = stream(Orientation) + offset;
+	float* angularVelocity = stream(AngularVelocity) + offset;
+	float* inverseMass = stream(InverseMass) + offset;
+	float* age = stream(Age) + offset;
+	float* maxAge = stream(MaxAge) + offset;
+	float* size = stream(Size) + offset;
+	float* random = stream(Random) + offset;
+	float* alpha = stream(Alpha) + offset;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const Point& point = points[i];
+
+		float T_MATH_ALIGN16 e[8];
+		point.position.storeAligned(&e[0]);
+		point.velocity.storeAligned(&e[4]);
+
+		px[i] = e[0];
+		py[i] = e[1];
+		pz[i] = e[2];
+		vx[i] = e[4];
+		vy[i] = e[5];
+		vz[i] = e[6];
+		orientation[i] = point.orientation;
+		angularVelocity[i] = point.angularVelocity;
+		inverseMass[i] = point.inverseMass;
+		age[i] = point.age;
+		maxAge[i] = point.maxAge;
+		size[i] = point.size;
+		random[i] = point.random;
+		alpha[i] = point.alpha;
+	}
+}
+
+void PointStreams::copy(size_t to, size_t from)
+{
+	float* data = m_data.ptr();
+	for (int32_t i = 0; i < StreamCount; ++i, data += m_capacity)
+		data[to] = data[from];
+}
+
+void PointStreams::get(size_t index, Point& outPoint) const
+{
+	outPoint.position = Vector4(
+		stream(PositionX)[index],
+		stream(PositionY)[index],
+		stream(PositionZ)[index],
+		1.0f
+	);
+	outPoint.velocity = Vector4(
+		stream(VelocityX)[index],
+		stream(VelocityY)[index],
+		stream(VelocityZ)[index],
+		0.0f
+	);
+	outPoint.orientation = stream(Orientation)[index];
+	outPoint.angularVelocity = stream(AngularVelocity)[index];
+	outPoint.inverseMass = stream(InverseMass)[index];
+	outPoint.age = stream(Age)[index];
+	outPoint.maxAge = stream(MaxAge)[index];
+	outPoint.size = stream(Size)[index];
+	outPoint.random = stream(Random)[index];
+	outPoint.alpha = stream(Alpha)[index];
+}
+
+void PointStreams::gather(size_t first, size_t last, size_t step, Point* outPoints) const
+{
+	const float* px = stream(PositionX);
+	const float* py = stream(PositionY);
+	const float* pz = stream(PositionZ);
+	const float* vx = stream(VelocityX);
+	const float* vy = stream(VelocityY);
+	const float* vz = stream(VelocityZ);
+	const float* orientation = stream(Orientation);
+	const float* angularVelocity = stream(AngularVelocity);
+	const float* inverseMass = stream(InverseMass);
+	const float* age = stream(Age);
+	const float* maxAge = stream(MaxAge);
+	const float* size = stream(Size);
+	const float* random = stream(Random);
+	const float* alpha = stream(Alpha);
+
+	for (size_t i = first; i < last; i += step)
+	{
+		Point& point = *outPoints++;
+		point.position = Vector4(px[i], py[i], pz[i], 1.0f);
+		point.velocity = Vector4(vx[i], vy[i], vz[i], 0.0f);
+		point.oaia[0] = orientation[i];
+		point.oaia[1] = angularVelocity[i];
+		point.oaia[2] = inverseMass[i];
+		point.oaia[3] = age[i];
+		point.msra[0] = maxAge[i];
+		point.msra[1] = size[i];
+		point.msra[2] = random[i];
+		point.msra[3] = alpha[i];
+	}
+}
+
+}
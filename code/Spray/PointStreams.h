@@ -0,0 +1,89 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Containers/AlignedVector.h"
+#include "Spray/Point.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_SPRAY_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::spray
+{
+
+/*! Particle points stored as structure of arrays.
+ * \ingroup Spray
+ *
+ * Each point attribute is kept in a separate stream so
+ * modifiers can process four points at a time.
+ * Streams are 16 byte aligned and padded to a multiple
+ * of four points; padding lanes contain undefined values.
+ */
+class T_DLLCLASS PointStreams
+{
+public:
+	enum Stream
+	{
+		PositionX,
+		PositionY,
+		PositionZ,
+		VelocityX,
+		VelocityY,
+		VelocityZ,
+		Orientation,
+		AngularVelocity,
+		InverseMass,
+		Age,
+		MaxAge,
+		Size,
+		Random,
+		Alpha,
+		StreamCount
+	};
+
+	void reserve(size_t capacity);
+
+	void resize(size_t size);
+
+	void clear() { m_size = 0; }
+
+	size_t size() const { return m_size; }
+
+	size_t capacity() const { return m_capacity; }
+
+	bool empty() const { return m_size == 0; }
+
+	float* stream(Stream stream) { return m_data.ptr() + stream * m_capacity; }
+
+	const float* stream(Stream stream) const { return m_data.c_ptr() + stream * m_capacity; }
+
+	/*! Append points. */
+	void append(const Point* points, size_t count);
+
+	/*! Copy point from one index to another. */
+	void copy(size_t to, size_t from);
+
+	/*! Get point at index as a packed point. */
+	void get(size_t index, Point& outPoint) const;
+
+	/*! Get every step:th point in range as packed points. */
+	void gather(size_t first, size_t last, size_t step, Point* outPoints) const;
+
+private:
+	AlignedVector< float > m_data;
+	size_t m_size = 0;
+	size_t m_capacity = 0;
+};
+
+}
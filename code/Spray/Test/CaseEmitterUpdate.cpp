@@ -0,0 +1,217 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cmath>
+#include "Core/Log/Log.h"
+#include "Core/Math/Plane.h"
+#include "Core/Math/Random.h"
+#include "Core/Misc/Align.h"
+#include "Core/Timer/Timer.h"
+#include "Mesh/Instance/InstanceMesh.h"
+#include "Render/Shader.h"
+#include "Spray/Emitter.h"
+#include "Spray/EmitterData.h"
+#include "Spray/EmitterInstanceCPU.h"
+#include "Spray/PointStreams.h"
+#include "Spray/Types.h"
+#include "Spray/Modifiers/DragModifier.h"
+#include "Spray/Modifiers/GravityModifier.h"
+#include "Spray/Modifiers/IntegrateModifier.h"
+#include "Spray/Modifiers/PlaneCollisionModifier.h"
+#include "Spray/Modifiers/SizeModifier.h"
+#include "Spray/Modifiers/VortexModifier.h"
+#include "Spray/Sources/PointSource.h"
+#include "Spray/Test/CaseEmitterUpdate.h"
+
+namespace traktor::spray::test
+{
+	namespace
+	{
+
+const uint32_t c_verifyCount = 1003;
+const uint32_t c_benchmarkCount = 100000;
+const int32_t c_benchmarkFrames = 100;
+const float c_deltaTime = 1.0f / 60.0f;
+
+const Vector4 c_gravity(0.0f, -9.81f, 0.0f, 0.0f);
+const Vector4 c_vortexAxis(0.0f, 1.0f, 0.0f, 0.0f);
+const Plane c_collisionPlane(Vector4(0.0f, 1.0f, 0.0f, 0.0f), 0.0_simd);
+
+RefArray< const Modifier > createModifiers()
+{
+	RefArray< const Modifier > modifiers;
+	modifiers.push_back(new GravityModifier(c_gravity, true));
+	modifiers.push_back(new VortexModifier(c_vortexAxis, 1.0f, 0.5f, 2.0f, 0.25f, true));
+	modifiers.push_back(new DragModifier(0.1f, 0.2f));
+	modifiers.push_back(new PlaneCollisionModifier(c_collisionPlane, 100.0f, 0.5f));
+	modifiers.push_back(new IntegrateModifier(1.0f, true, true));
+	modifiers.push_back(new SizeModifier(0.5f));
+	return modifiers;
+}
+
+/*! Same modifiers as above, implemented point by point. */
+void referenceUpdate(const Scalar& deltaTime, pointVector_t& points)
+{
+	for (auto& point : points)
+	{
+		// Gravity
+		point.velocity += c_gravity * deltaTime * Scalar(point.inverseMass);
+
+		// Vortex
+		{
+			Vector4 pc = point.position - Vector4::origo();
+			pc -= c_vortexAxis * dot3(pc, c_vortexAxis);
+			const Scalar distance = pc.length();
+			const Vector4 n = pc / distance;
+			const Vector4 t = cross(c_vortexAxis, n).normalized();
+			point.velocity += (
+				t * 1.0_simd +
+				n * (0.5_simd + (distance - 2.0_simd) * 0.25_simd)
+			) * Scalar(point.inverseMass) * deltaTime;
+		}
+
+		// Drag
+		point.velocity *= 1.0_simd - 0.1_simd * deltaTime;
+		point.angularVelocity *= 1.0f - 0.2f * deltaTime;
+
+		// Plane collision
+		if (
+			dot3(c_collisionPlane.normal(), point.velocity) < 0.0_simd &&
+			c_collisionPlane.distance(point.position) < Scalar(point.size) &&
+			point.position.xyz0().length2() < 100.0_simd
+		)
+			point.velocity = -reflect(point.velocity, c_collisionPlane.normal()) * 0.5_simd;
+
+		// Integrate
+		point.position += point.velocity * Scalar(point.inverseMass) * deltaTime;
+		point.orientation += point.angularVelocity * deltaTime;
+
+		// Size
+		point.size += 0.5f * deltaTime;
+	}
+}
+
+bool compareEqual(float a, float b)
+{
+	return std::abs(a - b) <= 1e-4f * std::max(1.0f, std::abs(a));
+}
+
+bool compareEqual(const Vector4& a, const Vector4& b)
+{
+	for (int32_t i = 0; i < 3; ++i)
+	{
+		if (!compareEqual(a[i], b[i]))
+			return false;
+	}
+	return true;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.spray.test.CaseEmitterUpdate", 0, CaseEmitterUpdate, traktor::test::Case)
+
+void CaseEmitterUpdate::run()
+{
+	const RefArray< const Modifier > modifiers = createModifiers();
+	const Scalar deltaTime(c_deltaTime);
+
+	// Verify modifiers against reference implementation.
+	{
+		Random random;
+		pointVector_t reference(c_verifyCount);
+		for (auto& point : reference)
+		{
+			point.position = Vector4(random.nextFloat() * 20.0f - 10.0f, random.nextFloat() * 2.0f - 1.0f, random.nextFloat() * 20.0f - 10.0f, 1.0f);
+			point.velocity = Vector4(random.nextFloat() * 2.0f - 1.0f, random.nextFloat() * 2.0f - 1.0f, random.nextFloat() * 2.0f - 1.0f, 0.0f);
+			point.orientation = random.nextFloat();
+			point.angularVelocity = random.nextFloat();
+			point.inverseMass = 1.0f / (1.0f + random.nextFloat());
+			point.age = 0.0f;
+			point.maxAge = 10.0f;
+			point.size = random.nextFloat();
+			point.random = random.nextFloat();
+			point.alpha = 1.0f;
+		}
+
+		PointStreams points;
+		points.append(reference.c_ptr(), reference.size());
+
+		for (int32_t frame = 0; frame < 10; ++frame)
+		{
+			referenceUpdate(deltaTime, reference);
+			for (auto modifier : modifiers)
+				modifier->update(deltaTime, Transform::identity(), points, 0, alignUp(points.size(), 4));
+		}
+
+		uint32_t errors = 0;
+		for (uint32_t i = 0; i < c_verifyCount; ++i)
+		{
+			Point point;
+			points.get(i, point);
+			if (
+				!compareEqual(point.position, reference[i].position) ||
+				!compareEqual(point.velocity, reference[i].velocity) ||
+				!compareEqual(point.orientation, reference[i].orientation) ||
+				!compareEqual(point.angularVelocity, reference[i].angularVelocity) ||
+				!compareEqual(point.size, reference[i].size)
+			)
+				errors++;
+		}
+		CASE_ASSERT_EQUAL(errors, 0);
+	}
+
+	// Measure update of a large emitter; no render system involved.
+	{
+		Ref< const Source > source = new PointSource(
+			float(c_benchmarkCount),
+			0.0f,
+			Vector4(0.0f, 1.0f, 0.0f, 1.0f),
+			Range< float >(1.0f, 5.0f),
+			Range< float >(0.0f, 0.0f),
+			Range< float >(-1.0f, 1.0f),
+			Range< float >(1000.0f, 1000.0f),
+			Range< float >(1.0f, 2.0f),
+			Range< float >(0.1f, 0.2f)
+		);
+
+		Ref< EmitterData > emitterData = new EmitterData();
+		Ref< Emitter > emitter = new Emitter(
+			emitterData,
+			source,
+			modifiers,
+			resource::Proxy< render::Shader >(),
+			resource::Proxy< mesh::InstanceMesh >(),
+			nullptr
+		);
+
+		Ref< EmitterInstanceCPU > emitterInstance = EmitterInstanceCPU::createInstance(emitter, c_benchmarkCount, 0.0f);
+
+		Context context;
+		context.deltaTime = c_deltaTime;
+
+		emitterInstance->update(context, Transform::identity(), true, true);
+		emitterInstance->synchronize();
+		CASE_ASSERT_EQUAL((uint32_t)emitterInstance->getPoints().size(), c_benchmarkCount);
+
+		Timer timer;
+		const double updateStart = timer.getElapsedTime();
+		for (int32_t frame = 0; frame < c_benchmarkFrames; ++frame)
+		{
+			emitterInstance->update(context, Transform::identity(), false, false);
+			emitterInstance->synchronize();
+		}
+		const double updateTime = (timer.getElapsedTime() - updateStart) / c_benchmarkFrames;
+
+		CASE_ASSERT_EQUAL((uint32_t)emitterInstance->getPoints().size(), c_benchmarkCount);
+
+		log::info << L"Emitter update, " << c_benchmarkCount << L" point(s); " << updateTime * 1000.0 << L" ms" << Endl;
+	}
+}
+
+}
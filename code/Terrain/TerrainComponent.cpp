@@ -60,17 +60,6 @@ const render::Handle c_handleTerrain_CulledDrawBuffer(L"Terrain_CulledDrawBuffer
 const int32_t c_patchLodSteps = 3;
 const int32_t c_surfaceLodSteps = 3;
 
-struct CullPatch
-{
-	float error[4];
-	float distance;
-	float area;
-	uint32_t patchId;
-	Vector4 patchOrigin;
-};
-
-typedef std::pair< float, const TerrainComponent::Patch* > cull_patch_t;
-
 struct DrawData
 {
 	float patchOrigin[4];
@@ -144,18 +133,18 @@ void TerrainComponent::setup(
 	if (!validate(viewIndex, cacheSize))
 		return;
 
+	// Keep heightfield tiles around primary view resident.
+	if (viewIndex == 0 && !snapshot)
+		m_heightfield->updateResidency(worldRenderView.getEyePosition());
+
 	const Vector4& worldExtent = m_heightfield->getWorldExtent();
 
 	const Matrix44 viewInv = worldRenderView.getView().inverse();
-	const Matrix44 viewProj = worldRenderView.getProjection() * worldRenderView.getView();
+	const Matrix44& projection = worldRenderView.getProjection();
 	const Vector4 eyePosition = worldRenderView.getEyePosition();
-	const Vector4 eyeDirection = worldRenderView.getEyeDirection();
 
 	const Vector4 patchExtent(worldExtent.x() / float(m_patchCount), worldExtent.y(), worldExtent.z() / float(m_patchCount), 0.0f);
-	const Vector4 patchDeltaHalf = patchExtent * Vector4(0.5f, 0.5f, 0.5f, 0.0f);
-	const Vector4 patchDeltaX = patchExtent * Vector4(1.0f, 0.0f, 0.0f, 0.0f);
-	const Vector4 patchDeltaZ = patchExtent * Vector4(0.0f, 0.0f, 1.0f, 0.0f);
-	Vector4 patchTopLeft = (-worldExtent * Scalar(0.5f)).xyz1();
+	const Vector4 patchTopLeft = (-worldExtent * Scalar(0.5f)).xyz1();
 
 	// Calculate world frustum.
 	const Frustum viewCullFrustum = worldRenderView.getCullFrustum();
@@ -163,131 +152,51 @@ void TerrainComponent::setup(
 	for (uint32_t i = 0; i < worldCullFrustum.planes.size(); ++i)
 		worldCullFrustum.planes[i] = viewInv * worldCullFrustum.planes[i];
 
-	// Cull patches to world frustum.
-	AlignedVector< CullPatch >& visiblePatches = m_view[viewIndex].visiblePatches;
-	visiblePatches.resize(0);
-	for (uint32_t pz = 0; pz < m_patchCount; ++pz)
-	{
-		Vector4 patchOrigin = patchTopLeft;
-		for (uint32_t px = 0; px < m_patchCount; ++px)
-		{
-			const uint32_t patchId = px + pz * m_patchCount;
-
-			const Patch& patch = m_patches[patchId];
-			const Vector4 patchCenterWorld = (patchOrigin + patchDeltaHalf) * Vector4(1.0f, 0.0f, 1.0f, 0.0f) + Vector4(0.0f, (patch.minHeight + patch.maxHeight) * 0.5f, 0.0f, 1.0f);
-
-			const Aabb3 patchAabb(
-				patchCenterWorld * Vector4(1.0f, 0.0f, 1.0f, 1.0f) + Vector4(-patchDeltaHalf.x(), patch.minHeight, -patchDeltaHalf.z(), 0.0f),
-				patchCenterWorld * Vector4(1.0f, 0.0f, 1.0f, 1.0f) + Vector4( patchDeltaHalf.x(), patch.maxHeight,  patchDeltaHalf.z(), 0.0f)
-			);
-
-			if (worldCullFrustum.inside(patchAabb) != Frustum::Result::Outside)
-			{
-				const Scalar lodDistance = (patchCenterWorld - eyePosition).xyz0().length();
-				const Vector4 patchCenterWorld_x0zw = patchCenterWorld * Vector4(1.0f, 0.0f, 1.0f, 1.0f);
-				const Vector4 eyePosition_0y00 = Vector4(0.0f, eyePosition.y(), 0.0f, 0.0f);
-
-				CullPatch cp;
-
-				// Calculate screen error for each lod.
-				for (int i = 0; i < LodCount; ++i)
-				{
-					const Vector4 Pworld[2] =
-					{
-						patchCenterWorld_x0zw + eyePosition_0y00,
-						patchCenterWorld_x0zw + eyePosition_0y00 + Vector4(0.0f, patch.error[i], 0.0f, 0.0f)
-					};
-
-					Vector4 Pview[2] =
-					{
-						worldRenderView.getView() * Pworld[0],
-						worldRenderView.getView() * Pworld[1]
-					};
-
-					if (Pview[0].z() < viewCullFrustum.getNearZ())
-						Pview[0].set(2, viewCullFrustum.getNearZ());
-					if (Pview[1].z() < viewCullFrustum.getNearZ())
-						Pview[1].set(2, viewCullFrustum.getNearZ());
-
-					Vector4 Pclip[] =
-					{
-						worldRenderView.getProjection() * Pview[0].xyz1(),
-						worldRenderView.getProjection() * Pview[1].xyz1()
-					};
-
-					T_ASSERT(Pclip[0].w() > 0.0f);
-					T_ASSERT(Pclip[1].w() > 0.0f);
-
-					Pclip[0] /= Pclip[0].w();
-					Pclip[1] /= Pclip[1].w();
-
-					const Vector4 d = Pclip[1] - Pclip[0];
-
-					const float dx = d.x();
-					const float dy = d.y();
-
-					cp.error[i] = std::sqrt(dx * dx + dy * dy) * 100.0f;
-				}
-
-				// Project patch bounding box extents onto view plane and calculate screen area.
-				Vector4 extents[8];
-				patchAabb.getExtents(extents);
-
-				Vector4 mn(
-					std::numeric_limits< float >::max(),
-					std::numeric_limits< float >::max(),
-					std::numeric_limits< float >::max(),
-					std::numeric_limits< float >::max()
-				);
-				Vector4 mx(
-					-std::numeric_limits< float >::max(),
-					-std::numeric_limits< float >::max(),
-					-std::numeric_limits< float >::max(),
-					-std::numeric_limits< float >::max()
-				);
-
-				bool clipped = false;
-				for (int32_t i = 0; i < sizeof_array(extents); ++i)
-				{
-					Vector4 p = viewProj * extents[i];
-					if (p.w() <= 0.0f)
-					{
-						clipped = true;
-						break;
-					}
-
-					// Homogeneous divide.
-					p /= p.w();
-
-					// Track screen space extents.
-					mn = min(mn, p);
-					mx = max(mx, p);
-				}
-
-				const Vector4 e = mx - mn;
+	// Cull patches to world frustum and select patch lod based on screen space error,
+	// error is scaled so one unit is roughly 1% of the view height.
+	View& view = m_view[viewIndex];
+	m_quadtree->select(
+		worldCullFrustum,
+		eyePosition,
+		projection(1, 1) * 100.0f,
+		viewCullFrustum.getNearZ(),
+		projection(3, 3) != 0.0f,
+		view.selectedPatches
+	);
 
-				cp.distance = lodDistance;
-				cp.area = !clipped ? e.x() * e.y() : 1000.0_simd;
-				cp.patchId = patchId;
-				cp.patchOrigin = patchOrigin;
-				cp.patchAabb = patchAabb;
+	// Mark patches visible this frame.
+	const uint32_t frame = ++view.frame;
+	for (const auto& selectedPatch : view.selectedPatches)
+		view.viewPatches[selectedPatch.patchId].visibleFrame = frame;
 
-				visiblePatches.push_back(cp);
-			}
-			else
-			{
-				ViewPatch& viewPatch = m_view[viewIndex].viewPatches[patchId];
+	// Reset patches which are no longer visible, only patches visible
+	// last frame can have any cached state.
+	for (const auto& visiblePatch : view.visiblePatches)
+	{
+		ViewPatch& viewPatch = view.viewPatches[visiblePatch.patchId];
+		if (viewPatch.visibleFrame == frame)
+			continue;
 
-				viewPatch.lastPatchLod = c_patchLodSteps;
-				viewPatch.lastSurfaceLod = c_surfaceLodSteps;
+		viewPatch.lastPatchLod = c_patchLodSteps;
+		viewPatch.lastSurfaceLod = c_surfaceLodSteps;
 
-				if (!snapshot)
-					m_view[viewIndex].surfaceCache->flush(patchId);
-			}
+		if (!snapshot)
+			view.surfaceCache->flush(visiblePatch.patchId);
+	}
 
-			patchOrigin += patchDeltaX;
-		}
-		patchTopLeft += patchDeltaZ;
+	AlignedVector< CullPatch >& visiblePatches = view.visiblePatches;
+	visiblePatches.resize(0);
+	for (const auto& selectedPatch : view.selectedPatches)
+	{
+		const uint32_t px = selectedPatch.patchId % m_patchCount;
+		const uint32_t pz = selectedPatch.patchId / m_patchCount;
+
+		CullPatch& cp = visiblePatches.push_back();
+		cp.patchLod = selectedPatch.patchLod;
+		cp.distance = selectedPatch.distance;
+		cp.patchId = selectedPatch.patchId;
+		cp.patchOrigin = patchTopLeft + patchExtent * Vector4(float(px), 0.0f, float(pz), 0.0f);
+		cp.patchAabb = selectedPatch.patchAabb;
 	}
 
 	// Sort patches front to back to maximize best use of surface cache and rendering.
@@ -319,16 +228,7 @@ void TerrainComponent::setup(
 				surfaceLod = viewPatch.lastSurfaceLod;
 		}
 
-		// Find patch lod based on screen space error.
-		int32_t patchLod = 0;
-		for (int32_t j = 3; j > 0; --j)
-		{
-			if (visiblePatch.error[j] <= 1.0f)
-			{
-				patchLod = j;
-				break;
-			}
-		}
+		const int32_t patchLod = visiblePatch.patchLod;
 
 		viewPatch.lastPatchLod = patchLod;
 		viewPatch.lastSurfaceLod = surfaceLod;
@@ -547,6 +447,7 @@ void TerrainComponent::destroy()
 	safeDestroy(m_vertexBuffer);
 	safeDestroy(m_drawBuffer);
 	safeDestroy(m_dataBuffer);
+	m_quadtree = nullptr;
 
 	//for (auto vb : m_rtVertexBuffers)
 	//	vb->destroy();
@@ -660,6 +561,7 @@ void TerrainComponent::updatePatches(const uint32_t* region, bool updateErrors,
 				patch.error[1] = patchData.error[0];
 				patch.error[2] = patchData.error[1];
 				patch.error[3] = patchData.error[2];
+				m_quadtree->setPatch(patchId, patch.minHeight, patch.maxHeight, patch.error);
 			}
 
 			if (flushPatchCache)
@@ -672,6 +574,9 @@ void TerrainComponent::updatePatches(const uint32_t* region, bool updateErrors,
 			}
 		}
 	}
+
+	if (updateErrors)
+		m_quadtree->refit();
 }
 
 void TerrainComponent::updateRayTracingPatches()
@@ -685,6 +590,12 @@ bool TerrainComponent::createPatches()
 	m_patches.clear();
 	m_patchCount = 0;
 
+	for (uint32_t i = 0; i < sizeof_array(m_view); ++i)
+	{
+		m_view[i].viewPatches.clear();
+		m_view[i].visiblePatches.clear();
+	}
+
 	safeDestroy(m_indexBuffer);
 	safeDestroy(m_vertexBuffer);
 	safeDestroy(m_drawBuffer);
@@ -728,6 +639,9 @@ bool TerrainComponent::createPatches()
 
 	m_vertexLayout = m_renderSystem->createVertexLayout(vertexElements);
 
+	m_quadtree = new TerrainQuadtree();
+	m_quadtree->create(m_heightfield->getWorldExtent(), m_patchCount);
+
 	m_patches.reserve(m_patchCount * m_patchCount);
 	for (uint32_t pz = 0; pz < m_patchCount; ++pz)
 	{
@@ -12,6 +12,7 @@
 #include "Core/Containers/AlignedVector.h"
 #include "Render/Shader.h"
 #include "Resource/Proxy.h"
+#include "Terrain/TerrainQuadtree.h"
 #include "Terrain/TerrainComponentData.h"
 #include "World/IEntityComponent.h"
 #include "World/Entity/RTWorldComponent.h"
@@ -72,7 +73,7 @@ class T_DLLCLASS TerrainComponent : public world::IEntityComponent
 	T_RTTI_CLASS;
 
 public:
-	static constexpr int32_t LodCount = 4;
+	static constexpr int32_t LodCount = TerrainQuadtree::LodCount;
 
 	enum VisualizeMode
 	{
@@ -140,9 +141,8 @@ private:
 
 	struct CullPatch
 	{
-		float error[4];
+		int32_t patchLod;
 		float distance;
-		float area;
 		uint32_t patchId;
 		Vector4 patchOrigin;
 		Aabb3 patchAabb;
@@ -153,13 +153,16 @@ private:
 		int32_t lastPatchLod = 0;
 		int32_t lastSurfaceLod = 0;
 		Vector4 surfaceOffset = Vector4::zero();
+		uint32_t visibleFrame = 0;
 	};
 
 	struct View
 	{
 		Ref< TerrainSurfaceCache > surfaceCache;
 		AlignedVector< ViewPatch > viewPatches;
+		AlignedVector< TerrainQuadtree::Selected > selectedPatches;
 		AlignedVector< CullPatch > visiblePatches;
+		uint32_t frame = 0;
 		AlignedVector< const CullPatch* > patchLodInstances[LodCount];
 	};
 
@@ -171,6 +174,7 @@ private:
 	resource::Proxy< hf::Heightfield > m_heightfield;
 	resource::Proxy< render::Shader > m_shaderCull;
 	AlignedVector< Patch > m_patches;
+	Ref< TerrainQuadtree > m_quadtree;
 	uint32_t m_patchCount = 0;
 	uint32_t m_cacheSize = 0;
 	Ref< const render::IVertexLayout > m_vertexLayout;
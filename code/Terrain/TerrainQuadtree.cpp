@@ -0,0 +1,215 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <limits>
+#include "Terrain/TerrainQuadtree.h"
+
+namespace traktor::terrain
+{
+	namespace
+	{
+
+/*! Distance from point to box. */
+float distanceToAabb(const Aabb3& aabb, const Vector4& point)
+{
+	const Vector4 d = max(max(aabb.mn - point, point - aabb.mx), Vector4::zero());
+	return d.xyz0().length();
+}
+
+/*! Find coarsest detail level which screen error is less than one. */
+int32_t selectLod(const float* error, float distance, float lodScale, int32_t minPatchLod)
+{
+	for (int32_t i = TerrainQuadtree::LodCount - 1; i > minPatchLod; --i)
+	{
+		if (error[i] * lodScale <= distance)
+			return i;
+	}
+	return minPatchLod;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.terrain.TerrainQuadtree", TerrainQuadtree, Object)
+
+void TerrainQuadtree::create(const Vector4& worldExtent, uint32_t patchCount)
+{
+	m_worldOrigin = (-worldExtent * 0.5_simd).xyz1();
+	m_patchExtent = Vector4(worldExtent.x() / float(patchCount), worldExtent.y(), worldExtent.z() / float(patchCount), 0.0f);
+	m_patchCount = patchCount;
+
+	m_nodes.resize(0);
+	m_nodes.reserve(patchCount * patchCount * 2);
+	m_patchNodes.resize(patchCount * patchCount, 0);
+	if (patchCount > 0)
+		build(allocateNode(0, 0, patchCount, patchCount));
+}
+
+void TerrainQuadtree::setPatch(uint32_t patchId, float minHeight, float maxHeight, const float* error)
+{
+	Node& node = m_nodes[m_patchNodes[patchId]];
+	node.minHeight = minHeight;
+	node.maxHeight = maxHeight;
+	for (int32_t i = 0; i < LodCount; ++i)
+		node.error[i] = error[i];
+}
+
+void TerrainQuadtree::refit()
+{
+	// Children are always allocated after their parent thus
+	// iterating backwards ensure children are refitted first.
+	for (auto it = m_nodes.rbegin(); it != m_nodes.rend(); ++it)
+	{
+		Node& node = *it;
+		if (node.childCount == 0)
+			continue;
+
+		node.minHeight = std::numeric_limits< float >::max();
+		node.maxHeight = -std::numeric_limits< float >::max();
+		for (int32_t i = 0; i < LodCount; ++i)
+			node.error[i] = 0.0f;
+
+		for (uint32_t i = 0; i < node.childCount; ++i)
+		{
+			const Node& child = m_nodes[node.firstChild + i];
+			node.minHeight = std::min(node.minHeight, child.minHeight);
+			node.maxHeight = std::max(node.maxHeight, child.maxHeight);
+			for (int32_t j = 0; j < LodCount; ++j)
+				node.error[j] = std::max(node.error[j], child.error[j]);
+		}
+	}
+}
+
+void TerrainQuadtree::select(
+	const Frustum& worldCullFrustum,
+	const Vector4& eyePosition,
+	float lodScale,
+	float nearZ,
+	bool orthographic,
+	AlignedVector< Selected >& outSelected
+) const
+{
+	outSelected.resize(0);
+	if (!m_nodes.empty())
+		select(0, true, 0, worldCullFrustum, eyePosition, lodScale, nearZ, orthographic, outSelected);
+}
+
+void TerrainQuadtree::build(uint32_t nodeIndex)
+{
+	const uint32_t x0 = m_nodes[nodeIndex].x0;
+	const uint32_t z0 = m_nodes[nodeIndex].z0;
+	const uint32_t x1 = m_nodes[nodeIndex].x1;
+	const uint32_t z1 = m_nodes[nodeIndex].z1;
+
+	if (x1 - x0 <= 1 && z1 - z0 <= 1)
+	{
+		m_patchNodes[x0 + z0 * m_patchCount] = nodeIndex;
+		return;
+	}
+
+	// Split into quadrants, skip empty quadrants of non-square ranges.
+	const uint32_t mx = (x1 - x0 > 1) ? (x0 + x1) / 2 : x1;
+	const uint32_t mz = (z1 - z0 > 1) ? (z0 + z1) / 2 : z1;
+	const uint32_t ranges[4][4] =
+	{
+		{ x0, z0, mx, mz },
+		{ mx, z0, x1, mz },
+		{ x0, mz, mx, z1 },
+		{ mx, mz, x1, z1 }
+	};
+
+	// Allocate children consecutively before recursing.
+	const uint32_t firstChild = (uint32_t)m_nodes.size();
+	uint32_t childCount = 0;
+	for (const auto& r : ranges)
+	{
+		if (r[2] > r[0] && r[3] > r[1])
+		{
+			allocateNode(r[0], r[1], r[2], r[3]);
+			++childCount;
+		}
+	}
+
+	m_nodes[nodeIndex].firstChild = firstChild;
+	m_nodes[nodeIndex].childCount = childCount;
+
+	for (uint32_t i = 0; i < childCount; ++i)
+		build(firstChild + i);
+}
+
+uint32_t TerrainQuadtree::allocateNode(uint32_t x0, uint32_t z0, uint32_t x1, uint32_t z1)
+{
+	const uint32_t nodeIndex = (uint32_t)m_nodes.size();
+
+	Node& node = m_nodes.push_back();
+	node.x0 = x0;
+	node.z0 = z0;
+	node.x1 = x1;
+	node.z1 = z1;
+	node.firstChild = 0;
+	node.childCount = 0;
+	node.minHeight = 0.0f;
+	node.maxHeight = 0.0f;
+	for (int32_t i = 0; i < LodCount; ++i)
+		node.error[i] = 0.0f;
+
+	return nodeIndex;
+}
+
+Aabb3 TerrainQuadtree::getNodeAabb(const Node& node) const
+{
+	return Aabb3(
+		m_worldOrigin + m_patchExtent * Vector4(float(node.x0), 0.0f, float(node.z0), 0.0f) + Vector4(0.0f, node.minHeight, 0.0f, 0.0f),
+		m_worldOrigin + m_patchExtent * Vector4(float(node.x1), 0.0f, float(node.z1), 0.0f) + Vector4(0.0f, node.maxHeight, 0.0f, 0.0f)
+	);
+}
+
+void TerrainQuadtree::select(
+	uint32_t nodeIndex,
+	bool cull,
+	int32_t minPatchLod,
+	const Frustum& worldCullFrustum,
+	const Vector4& eyePosition,
+	float lodScale,
+	float nearZ,
+	bool orthographic,
+	AlignedVector< Selected >& outSelected
+) const
+{
+	const Node& node = m_nodes[nodeIndex];
+	const Aabb3 nodeAabb = getNodeAabb(node);
+
+	// Reject entire subtree if outside, skip culling children if entirely inside.
+	if (cull)
+	{
+		const Frustum::Result result = worldCullFrustum.inside(nodeAabb);
+		if (result == Frustum::Result::Outside)
+			return;
+		cull = (result == Frustum::Result::Partial);
+	}
+
+	if (node.childCount == 0)
+	{
+		auto& selected = outSelected.push_back();
+		selected.patchId = node.x0 + node.z0 * m_patchCount;
+		selected.distance = (nodeAabb.getCenter() - eyePosition).xyz0().length();
+		selected.patchLod = selectLod(node.error, orthographic ? 1.0f : std::max(selected.distance, nearZ), lodScale, minPatchLod);
+		selected.patchAabb = nodeAabb;
+		return;
+	}
+
+	// Nearest distance to node is a lower bound of all contained patches' distances thus
+	// all patches within will be at least this coarse.
+	if (minPatchLod < LodCount - 1)
+		minPatchLod = selectLod(node.error, orthographic ? 1.0f : std::max(distanceToAabb(nodeAabb, eyePosition), nearZ), lodScale, minPatchLod);
+
+	for (uint32_t i = 0; i < node.childCount; ++i)
+		select(node.firstChild + i, cull, minPatchLod, worldCullFrustum, eyePosition, lodScale, nearZ, orthographic, outSelected);
+}
+
+}
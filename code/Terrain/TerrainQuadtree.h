@@ -0,0 +1,122 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Object.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Math/Aabb3.h"
+#include "Core/Math/Frustum.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_TERRAIN_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::terrain
+{
+
+/*! Min/max quadtree over terrain patches.
+ * \ingroup Terrain
+ *
+ * Each node keep height bounds and max error of each
+ * detail level of all patches it contains so visibility
+ * and detail level selection can reject, or accept, entire
+ * subtrees at once.
+ */
+class T_DLLCLASS TerrainQuadtree : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	static constexpr int32_t LodCount = 4;
+
+	struct Selected
+	{
+		uint32_t patchId;
+		int32_t patchLod;
+		float distance;
+		Aabb3 patchAabb;
+	};
+
+	/*! Create quadtree structure.
+	 *
+	 * \param worldExtent Extent of terrain in world space, terrain is centered around origin.
+	 * \param patchCount Number of patches along each side.
+	 */
+	void create(const Vector4& worldExtent, uint32_t patchCount);
+
+	/*! Set bounds and errors of a single patch.
+	 *
+	 * Parent nodes are not updated until refit is called.
+	 */
+	void setPatch(uint32_t patchId, float minHeight, float maxHeight, const float* error);
+
+	/*! Update parent nodes bounds and errors from patches. */
+	void refit();
+
+	/*! Select visible patches and their detail level.
+	 *
+	 * \param worldCullFrustum Cull frustum in world space.
+	 * \param eyePosition Eye position in world space.
+	 * \param lodScale Scale of error over distance into screen error, detail level is selected when screen error is less than one.
+	 * \param nearZ Minimum distance used for detail level selection.
+	 * \param orthographic Orthographic projection, screen error is independent of distance.
+	 * \param outSelected Selected patches.
+	 */
+	void select(
+		const Frustum& worldCullFrustum,
+		const Vector4& eyePosition,
+		float lodScale,
+		float nearZ,
+		bool orthographic,
+		AlignedVector< Selected >& outSelected
+	) const;
+
+	uint32_t getNodeCount() const { return (uint32_t)m_nodes.size(); }
+
+private:
+	struct Node
+	{
+		uint32_t x0, z0, x1, z1;	//!< Patch range, exclusive end.
+		uint32_t firstChild;		//!< Index of first child, children are consecutive.
+		uint32_t childCount;		//!< Number of children, zero if node is a single patch.
+		float minHeight;
+		float maxHeight;
+		float error[LodCount];
+	};
+
+	AlignedVector< Node > m_nodes;
+	AlignedVector< uint32_t > m_patchNodes;
+	Vector4 m_worldOrigin;
+	Vector4 m_patchExtent;
+	uint32_t m_patchCount = 0;
+
+	void build(uint32_t nodeIndex);
+
+	uint32_t allocateNode(uint32_t x0, uint32_t z0, uint32_t x1, uint32_t z1);
+
+	Aabb3 getNodeAabb(const Node& node) const;
+
+	void select(
+		uint32_t nodeIndex,
+		bool cull,
+		int32_t minPatchLod,
+		const Frustum& worldCullFrustum,
+		const Vector4& eyePosition,
+		float lodScale,
+		float nearZ,
+		bool orthographic,
+		AlignedVector< Selected >& outSelected
+	) const;
+};
+
+}
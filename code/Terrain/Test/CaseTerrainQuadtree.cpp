@@ -0,0 +1,165 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cmath>
+#include "Core/Log/Log.h"
+#include "Core/Math/Matrix44.h"
+#include "Core/Timer/Timer.h"
+#include "Terrain/TerrainQuadtree.h"
+#include "Terrain/Test/CaseTerrainQuadtree.h"
+
+namespace traktor::terrain::test
+{
+	namespace
+	{
+
+const Vector4 c_worldExtent(4096.0f, 512.0f, 4096.0f, 0.0f);
+const float c_nearZ = 0.1f;
+const float c_lodScale = 100.0f;
+const int32_t c_iterations = 20;
+
+struct Patch
+{
+	float minHeight;
+	float maxHeight;
+	float error[TerrainQuadtree::LodCount];
+};
+
+/*! Create patches with rolling hills, errors grow with detail level and slope. */
+AlignedVector< Patch > createPatches(uint32_t patchCount)
+{
+	AlignedVector< Patch > patches;
+	patches.resize(patchCount * patchCount);
+	for (uint32_t pz = 0; pz < patchCount; ++pz)
+	{
+		for (uint32_t px = 0; px < patchCount; ++px)
+		{
+			const float fx = float(px) / patchCount;
+			const float fz = float(pz) / patchCount;
+			const float h = std::sin(fx * 17.0f) * std::cos(fz * 11.0f) * 200.0f;
+			const float slope = std::abs(std::cos(fx * 17.0f)) + 0.1f;
+
+			Patch& patch = patches[px + pz * patchCount];
+			patch.minHeight = h - slope * 10.0f;
+			patch.maxHeight = h + slope * 10.0f;
+			for (int32_t i = 0; i < TerrainQuadtree::LodCount; ++i)
+				patch.error[i] = float(i * i) * slope;
+		}
+	}
+	return patches;
+}
+
+/*! Reference culling and detail level selection of each patch. */
+void selectBruteForce(
+	const AlignedVector< Patch >& patches,
+	uint32_t patchCount,
+	const Frustum& worldCullFrustum,
+	const Vector4& eyePosition,
+	AlignedVector< TerrainQuadtree::Selected >& outSelected
+)
+{
+	const Vector4 patchExtent(c_worldExtent.x() / float(patchCount), c_worldExtent.y(), c_worldExtent.z() / float(patchCount), 0.0f);
+	const Vector4 patchTopLeft = (-c_worldExtent * 0.5_simd).xyz1();
+
+	outSelected.resize(0);
+	for (uint32_t pz = 0; pz < patchCount; ++pz)
+	{
+		for (uint32_t px = 0; px < patchCount; ++px)
+		{
+			const Patch& patch = patches[px + pz * patchCount];
+			const Vector4 patchOrigin = patchTopLeft + patchExtent * Vector4(float(px), 0.0f, float(pz), 0.0f);
+			const Aabb3 patchAabb(
+				patchOrigin + Vector4(0.0f, patch.minHeight, 0.0f, 0.0f),
+				patchOrigin + patchExtent * Vector4(1.0f, 0.0f, 1.0f, 0.0f) + Vector4(0.0f, patch.maxHeight, 0.0f, 0.0f)
+			);
+			if (worldCullFrustum.inside(patchAabb) == Frustum::Result::Outside)
+				continue;
+
+			auto& selected = outSelected.push_back();
+			selected.patchId = px + pz * patchCount;
+			selected.distance = (patchAabb.getCenter() - eyePosition).xyz0().length();
+			selected.patchLod = 0;
+			selected.patchAabb = patchAabb;
+
+			for (int32_t i = TerrainQuadtree::LodCount - 1; i > 0; --i)
+			{
+				if (patch.error[i] * c_lodScale <= std::max(selected.distance, c_nearZ))
+				{
+					selected.patchLod = i;
+					break;
+				}
+			}
+		}
+	}
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.terrain.test.CaseTerrainQuadtree", 0, CaseTerrainQuadtree, traktor::test::Case)
+
+void CaseTerrainQuadtree::run()
+{
+	const uint32_t patchCounts[] = { 64, 128, 256 };
+	for (const uint32_t patchCount : patchCounts)
+	{
+		const AlignedVector< Patch > patches = createPatches(patchCount);
+
+		Ref< TerrainQuadtree > quadtree = new TerrainQuadtree();
+		quadtree->create(c_worldExtent, patchCount);
+		for (uint32_t i = 0; i < patchCount * patchCount; ++i)
+			quadtree->setPatch(i, patches[i].minHeight, patches[i].maxHeight, patches[i].error);
+		quadtree->refit();
+
+		// View from above terrain looking across it.
+		const Vector4 eyePosition(-1500.0f, 300.0f, -1200.0f, 1.0f);
+		const Matrix44 view = lookAt(eyePosition, Vector4(500.0f, 0.0f, 300.0f, 1.0f));
+		const Matrix44 viewInv = view.inverse();
+
+		Frustum worldCullFrustum;
+		worldCullFrustum.buildPerspective(deg2rad(70.0f), 16.0f / 9.0f, c_nearZ, 3000.0f);
+		for (uint32_t i = 0; i < worldCullFrustum.planes.size(); ++i)
+			worldCullFrustum.planes[i] = viewInv * worldCullFrustum.planes[i];
+
+		AlignedVector< TerrainQuadtree::Selected > selected;
+		AlignedVector< TerrainQuadtree::Selected > reference;
+
+		Timer timer;
+		for (int32_t i = 0; i < c_iterations; ++i)
+			quadtree->select(worldCullFrustum, eyePosition, c_lodScale, c_nearZ, false, selected);
+		const double quadtreeDuration = timer.getElapsedTime() / c_iterations;
+
+		timer.reset();
+		for (int32_t i = 0; i < c_iterations; ++i)
+			selectBruteForce(patches, patchCount, worldCullFrustum, eyePosition, reference);
+		const double bruteForceDuration = timer.getElapsedTime() / c_iterations;
+
+		// Hierarchical culling and detail level bounds must produce exactly the same result.
+		const auto byPatchId = [](const TerrainQuadtree::Selected& lh, const TerrainQuadtree::Selected& rh) { return lh.patchId < rh.patchId; };
+		std::sort(selected.begin(), selected.end(), byPatchId);
+		std::sort(reference.begin(), reference.end(), byPatchId);
+
+		CASE_ASSERT(!reference.empty());
+		CASE_ASSERT(reference.size() < patchCount * patchCount);
+		CASE_ASSERT_EQUAL(selected.size(), reference.size());
+		if (selected.size() != reference.size())
+			continue;
+
+		bool sameSelection = true;
+		for (uint32_t i = 0; i < selected.size(); ++i)
+		{
+			sameSelection &= (selected[i].patchId == reference[i].patchId);
+			sameSelection &= (selected[i].patchLod == reference[i].patchLod);
+		}
+		CASE_ASSERT(sameSelection);
+
+		log::info << L"Terrain quadtree, " << patchCount << L"x" << patchCount << L" patches, " << selected.size() << L" visible; quadtree " << int32_t(quadtreeDuration * 1000000.0) << L" us, brute force " << int32_t(bruteForceDuration * 1000000.0) << L" us" << Endl;
+	}
+}
+
+}
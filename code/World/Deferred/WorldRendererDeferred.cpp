@@ -581,8 +581,7 @@ void WorldRendererDeferred::setupVisualPass(
 					{ s_handleIrradianceSingle, irradianceSingle },
 					{ s_handleVolumetricFogEnable, (bool)(fog != nullptr && fog->m_volumetricFogEnable) } });
 
-			for (const auto& r : m_gatheredView.renderables)
-				r.renderer->build(wc, worldRenderView, deferredColorPass, r.renderable);
+			wc.build(worldRenderView, deferredColorPass, m_gatheredView.renderables);
 
 			for (auto entityRenderer : m_entityRenderers->get())
 				entityRenderer->build(wc, worldRenderView, deferredColorPass);
@@ -8,6 +8,7 @@
  */
 #include "World/Entity.h"
 #include "World/IEntityComponent.h"
+#include "World/World.h"
 
 namespace traktor::world
 {
@@ -79,6 +80,7 @@ void Entity::setTransform(const Transform& transform)
 		if (component != m_updating)
 			component->setTransform(transform);
 	}
+	invalidateSpatial();
 }
 
 Transform Entity::getTransform() const
@@ -112,6 +114,8 @@ void Entity::setComponent(IEntityComponent* component)
 	component->setOwner(this);
 	component->setTransform(m_transform);
 
+	invalidateSpatial();
+
 	// Replace existing component of same type.
 	for (auto comp : m_components)
 	{
@@ -136,4 +140,13 @@ IEntityComponent* Entity::getComponent(const TypeInfo& componentType) const
 	return nullptr;
 }
 
+void Entity::invalidateSpatial()
+{
+	if (m_world != nullptr && m_spatialProxy >= 0 && !m_spatialDirty)
+	{
+		m_spatialDirty = true;
+		m_world->m_dirtyEntities.push_back(this);
+	}
+}
+
 }
@@ -157,6 +157,8 @@ public:
 	}
 
 private:
+	friend class World;
+
 	World* m_world = nullptr;
 	Guid m_id;
 	std::wstring m_name;
@@ -164,6 +166,10 @@ private:
 	EntityState m_state;
 	RefArray< IEntityComponent > m_components;
 	const IEntityComponent* m_updating = nullptr;
+	int32_t m_spatialProxy = -1;
+	bool m_spatialDirty = false;
+
+	void invalidateSpatial();
 };
 
 }
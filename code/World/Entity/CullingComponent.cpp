@@ -6,8 +6,12 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
+#include <limits>
+#include "Core/Containers/StaticVector.h"
 #include "Core/Misc/SafeDestroy.h"
 #include "Core/Misc/String.h"
+#include "Core/Thread/JobManager.h"
 #include "Render/Buffer.h"
 #include "Render/IRenderSystem.h"
 #include "Render/Shader.h"
@@ -26,8 +30,31 @@ namespace traktor::world
 
 const resource::Id< render::Shader > c_shaderInstanceMeshCull(L"{37998131-BDA1-DE45-B175-35B088FEE61C}");
 
+const uint32_t c_runMinCapacity = 16;
+const uint32_t c_cullChunkSize = 4096;
+const uint32_t c_maxCullTasks = 16;
+
+const Vector4 c_emptyBounds(0.0f, 0.0f, 0.0f, -1.0f);
+
 render::Handle s_handleInstanceWorld(L"InstanceWorld");
 
+/*! Bounding sphere of instance, packed as center in xyz and radius in w. */
+Vector4 boundingSphere(const Aabb3& boundingBox)
+{
+	return boundingBox.getCenter().xyz0() + Vector4(0.0f, 0.0f, 0.0f, boundingBox.getExtent().length());
+}
+
+void writeInstance(CullingComponent::InstanceRenderData& ird, const CullingComponent::Instance* instance)
+{
+	if (!instance)
+		return;
+
+	instance->transform.rotation().e.storeAligned(ird.rotation);
+	instance->transform.translation().storeAligned(ird.translation);
+	instance->boundingBox.mn.storeAligned(ird.boundingBoxMin);
+	instance->boundingBox.mx.storeAligned(ird.boundingBoxMax);
+}
+
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.world.CullingComponent", CullingComponent, IWorldComponent)
@@ -40,7 +67,7 @@ CullingComponent::CullingComponent(resource::IResourceManager* resourceManager,
 
 void CullingComponent::destroy()
 {
-	T_FATAL_ASSERT_M(m_instances.empty(), L"Culling instances not empty.");
+	T_FATAL_ASSERT_M(m_instanceCount == 0, L"Culling instances not empty.");
 	safeDestroy(m_instanceBuffer);
 	for (auto visibilityBuffer : m_visibilityBuffers)
 	{
@@ -48,6 +75,12 @@ void CullingComponent::destroy()
 			visibilityBuffer->destroy();
 	}
 	m_visibilityBuffers.resize(0);
+	for (auto visibilityBuffer : m_cpuVisibilityBuffers)
+	{
+		if (visibilityBuffer)
+			visibilityBuffer->destroy();
+	}
+	m_cpuVisibilityBuffers.resize(0);
 	m_renderSystem = nullptr;
 }
 
@@ -61,49 +94,66 @@ void CullingComponent::build(
 	const IWorldRenderPass& worldRenderPass
 )
 {
-	if (m_instances.empty())
+	if (m_instanceCount == 0)
 		return;
 
 	render::RenderContext* renderContext = context.getRenderContext();
-	const uint32_t bufferItemCount = (uint32_t)alignUp(m_instances.size(), 16);
 
-	// Lazy create the buffers if necessary.
-	if (!m_instanceBuffer || bufferItemCount > m_instanceAllocatedCount)
+	// Compact slots if relocated runs have left too many holes.
+	if (m_slots.size() > 2 * (m_instanceCount + c_runMinCapacity * m_runs.size()))
+		compactSlots();
+
+	const uint32_t slotCount = (uint32_t)m_slots.size();
+
+	// Lazy create the buffers if necessary, reserve some space for growth.
+	if (!m_instanceBuffer || slotCount > m_instanceAllocatedCount)
 	{
+		const uint32_t bufferItemCount = (uint32_t)alignUp(slotCount + slotCount / 4, 16);
 		m_instanceBuffer = m_renderSystem->createBuffer(render::BufferUsage::BuStructured, bufferItemCount * sizeof(InstanceRenderData), true);
 		m_visibilityBuffers.resize(0);
+		m_cpuVisibilityBuffers.resize(0);
 		m_instanceAllocatedCount = bufferItemCount;
 		m_instanceBufferDirty = true;
+		m_fullUploads = c_uploadHistory;
 	}
 
-	// Ensure we have visibility buffers for all cascades.
-	const uint32_t peakCascade = worldRenderView.getCascade();
-	const uint32_t vbSize = (uint32_t)m_visibilityBuffers.size();
-	for (uint32_t i = vbSize; i < peakCascade + 1; ++i)
-		m_visibilityBuffers.push_back(m_renderSystem->createBuffer(render::BufferUsage::BuStructured, bufferItemCount * sizeof(float), false));
+	// Update buffer if any instance has changed.
+	if (m_instanceBufferDirty || !m_dirtySlots.empty())
+		uploadInstances();
+
+	render::Buffer* visibilityBuffer = nullptr;
 
-	// Update buffer is any instance has moved.
-	if (m_instanceBufferDirty)
+	if (worldRenderPass.getTechnique() == s_techniqueSimpleColor)
 	{
-		auto ptr = (InstanceRenderData*)m_instanceBuffer->lock();
-		for (const auto& instance : m_instances)
-		{
-			InstanceRenderData& ird = *ptr++;
-			instance->transform.rotation().e.storeAligned(ird.rotation);
-			instance->transform.translation().storeAligned(ird.translation);
-			instance->boundingBox.mn.storeAligned(ird.boundingBoxMin);
-			instance->boundingBox.mx.storeAligned(ird.boundingBoxMax);
-		}
-		m_instanceBuffer->unlock();
-		m_instanceBufferDirty = false;
-	}
+		// Simple renderer doesn't have HiZ thus cull instances on CPU
+		// directly into a dynamic visibility buffer.
+		const uint32_t peakCascade = worldRenderView.getCascade();
+		const uint32_t vbSize = (uint32_t)m_cpuVisibilityBuffers.size();
+		for (uint32_t i = vbSize; i < peakCascade + 1; ++i)
+			m_cpuVisibilityBuffers.push_back(m_renderSystem->createBuffer(render::BufferUsage::BuStructured, m_instanceAllocatedCount * sizeof(float), true));
 
-	render::Buffer* visibilityBuffer = m_visibilityBuffers[worldRenderView.getCascade()];
+		visibilityBuffer = m_cpuVisibilityBuffers[worldRenderView.getCascade()];
 
-	// Cull instances, output are visibility buffer.
-	// Compute blocks are executed before render pass, so for shadow map rendering all cascades
-	// are culled before being rendered.
+		float* visibility = (float*)visibilityBuffer->lock();
+		if (!visibility)
+			return;
+
+		cullInstances(worldRenderView, visibility);
+		visibilityBuffer->unlock();
+	}
+	else
 	{
+		// Ensure we have visibility buffers for all cascades.
+		const uint32_t peakCascade = worldRenderView.getCascade();
+		const uint32_t vbSize = (uint32_t)m_visibilityBuffers.size();
+		for (uint32_t i = vbSize; i < peakCascade + 1; ++i)
+			m_visibilityBuffers.push_back(m_renderSystem->createBuffer(render::BufferUsage::BuStructured, m_instanceAllocatedCount * sizeof(float), false));
+
+		visibilityBuffer = m_visibilityBuffers[worldRenderView.getCascade()];
+
+		// Cull instances, output are visibility buffer.
+		// Compute blocks are executed before render pass, so for shadow map rendering all cascades
+		// are culled before being rendered.
 		Vector4 cullFrustum[12];
 
 		const Frustum& cf = worldRenderView.getCullFrustum();
@@ -145,33 +195,26 @@ void CullingComponent::build(
 		renderBlock->programParams->setBufferViewParameter(s_handleVisibility, visibilityBuffer->getBufferView());
 		renderBlock->programParams->endParameters(renderContext);
 
-		renderBlock->workSize[0] = (int32_t)m_instances.size();
+		renderBlock->workSize[0] = (int32_t)slotCount;
 
 		renderContext->compute(renderBlock);
 		renderContext->compute< render::BarrierRenderBlock >(render::Stage::Compute, render::Stage::Indirect, nullptr, 0);
 	}
 
-	// Batch draw instances; assumes m_instances are sorted by "ordinal" so we can scan for run length.
-	for (uint32_t i = 0; i < (uint32_t)m_instances.size(); )
+	// Batch draw instances; each run is a contiguous range of slots with same ordinal.
+	for (const auto& it : m_runs)
 	{
-		uint32_t j = i + 1;
-		for (; j < (uint32_t)m_instances.size(); ++j)
-		{
-			if (m_instances[i]->ordinal != m_instances[j]->ordinal)
-				break;
-		}
-
-		m_instances[i]->cullable->cullableBuild(
+		const Run& run = it.second;
+		m_slots[run.offset]->cullable->cullableBuild(
 			context,
 			worldRenderView,
 			worldRenderPass,
 			m_instanceBuffer,
 			visibilityBuffer,
-			i,
-			(j - i)
+			run.offset,
+			run.count,
+			nearestDistance(worldRenderView, run)
 		);
-
-		i = j;
 	}
 }
 
@@ -181,38 +224,255 @@ CullingComponent::Instance* CullingComponent::createInstance(ICullable* cullable
 	instance->owner = this;
 	instance->cullable = cullable;
 	instance->ordinal = ordinal;
+	instance->slot = allocateSlot(ordinal);
 	instance->transform = Transform::identity();
 	instance->boundingBox = cullable->cullableGetBoundingBox();
-	
-	// Insert instance sorted by ordinal so we can calculate run length when building.
-	auto it = std::upper_bound(m_instances.begin(), m_instances.end(), instance, [=](Instance* lh, Instance* rh) {
-		return lh->ordinal < rh->ordinal;
-	});
-	m_instances.insert(it, instance);
+
+	setSlot(instance->slot, instance);
+	m_instanceCount++;
+
+	markDirty(instance->slot);
 	return instance;
 }
 
 void CullingComponent::destroyInstance(Instance* instance)
 {
 	T_FATAL_ASSERT(instance->owner == this);
-	auto it = std::find(m_instances.begin(), m_instances.end(), instance);
-	T_FATAL_ASSERT(it != m_instances.end());
-	m_instances.erase(it);
-	m_instanceBufferDirty = true;
+	T_FATAL_ASSERT(m_slots[instance->slot] == instance);
+
+	auto it = m_runs.find(instance->ordinal);
+	T_FATAL_ASSERT(it != m_runs.end());
+
+	// Move last instance of run into released slot so run is kept contiguous.
+	Run& run = it->second;
+	const uint32_t last = run.offset + run.count - 1;
+	if (instance->slot != last)
+	{
+		Instance* moved = m_slots[last];
+		moved->slot = instance->slot;
+		setSlot(moved->slot, moved);
+		markDirty(moved->slot);
+	}
+	setSlot(last, nullptr);
+
+	if (--run.count == 0)
+		m_runs.erase(it);
+
+	if (m_runs.empty())
+	{
+		m_slots.resize(0);
+		m_bounds.resize(0);
+	}
+
+	m_instanceCount--;
 	delete instance;
 }
 
+void CullingComponent::setSlot(uint32_t slot, Instance* instance)
+{
+	m_slots[slot] = instance;
+	m_bounds[slot] = instance ? boundingSphere(instance->boundingBox) : c_emptyBounds;
+}
+
+void CullingComponent::markDirty(uint32_t slot)
+{
+	// Cheaper to write entire buffer if most slots are dirty.
+	if (m_dirtySlots.size() >= m_slots.size())
+	{
+		m_dirtySlots.resize(0);
+		m_fullUploads = c_uploadHistory;
+		m_instanceBufferDirty = true;
+		return;
+	}
+	m_dirtySlots.push_back(slot);
+}
+
+uint32_t CullingComponent::allocateSlot(intptr_t ordinal)
+{
+	Run& run = m_runs[ordinal];
+	if (run.count >= run.capacity)
+	{
+		const uint32_t capacity = std::max(run.capacity * 2, c_runMinCapacity);
+		if (run.capacity > 0 && run.offset + run.capacity == (uint32_t)m_slots.size())
+		{
+			// Run is last in slot space; grow in place.
+			m_slots.resize(run.offset + capacity, nullptr);
+			m_bounds.resize(run.offset + capacity, c_emptyBounds);
+		}
+		else
+		{
+			// Relocate run to end of slot space, previous range is left as a hole.
+			const uint32_t offset = (uint32_t)m_slots.size();
+			m_slots.resize(offset + capacity, nullptr);
+			m_bounds.resize(offset + capacity, c_emptyBounds);
+			for (uint32_t i = 0; i < run.count; ++i)
+			{
+				Instance* instance = m_slots[run.offset + i];
+				setSlot(run.offset + i, nullptr);
+				setSlot(offset + i, instance);
+				instance->slot = offset + i;
+				markDirty(instance->slot);
+			}
+			run.offset = offset;
+		}
+		run.capacity = capacity;
+	}
+	return run.offset + run.count++;
+}
+
+void CullingComponent::compactSlots()
+{
+	AlignedVector< Instance* > slots;
+	AlignedVector< Vector4 > bounds;
+	slots.reserve(m_slots.size() / 2);
+	bounds.reserve(m_slots.size() / 2);
+
+	for (auto& it : m_runs)
+	{
+		Run& run = it.second;
+		const uint32_t offset = (uint32_t)slots.size();
+		const uint32_t capacity = (uint32_t)alignUp(run.count + run.count / 2, c_runMinCapacity);
+		slots.resize(offset + capacity, nullptr);
+		bounds.resize(offset + capacity, c_emptyBounds);
+		for (uint32_t i = 0; i < run.count; ++i)
+		{
+			Instance* instance = m_slots[run.offset + i];
+			slots[offset + i] = instance;
+			bounds[offset + i] = m_bounds[run.offset + i];
+			instance->slot = offset + i;
+		}
+		run.offset = offset;
+		run.capacity = capacity;
+	}
+
+	m_slots.swap(slots);
+	m_bounds.swap(bounds);
+
+	// All instances might have moved.
+	m_dirtySlots.resize(0);
+	m_fullUploads = c_uploadHistory;
+	m_instanceBufferDirty = true;
+}
+
+void CullingComponent::uploadInstances()
+{
+	// Keep dirty slots of this upload since they also must be
+	// written to the other copies of the buffer when those are locked.
+	auto& history = m_uploadHistory[m_uploadCount++ % c_uploadHistory];
+	history.swap(m_dirtySlots);
+	m_dirtySlots.resize(0);
+
+	auto ptr = (InstanceRenderData*)m_instanceBuffer->lock();
+	if (!ptr)
+		return;
+
+	if (m_fullUploads > 0)
+	{
+		for (uint32_t slot = 0; slot < (uint32_t)m_slots.size(); ++slot)
+			writeInstance(ptr[slot], m_slots[slot]);
+		m_fullUploads--;
+	}
+	else
+	{
+		m_uploadSlots.resize(0);
+		for (const auto& slots : m_uploadHistory)
+			m_uploadSlots.insert(m_uploadSlots.end(), slots.begin(), slots.end());
+
+		std::sort(m_uploadSlots.begin(), m_uploadSlots.end());
+		m_uploadSlots.erase(std::unique(m_uploadSlots.begin(), m_uploadSlots.end()), m_uploadSlots.end());
+
+		for (auto slot : m_uploadSlots)
+		{
+			if (slot < (uint32_t)m_slots.size())
+				writeInstance(ptr[slot], m_slots[slot]);
+		}
+	}
+
+	m_instanceBuffer->unlock();
+	m_instanceBufferDirty = false;
+}
+
+void CullingComponent::cullInstances(const WorldRenderView& worldRenderView, float* outVisibility) const
+{
+	const Frustum& cf = worldRenderView.getCullFrustum();
+	const Matrix44& view = worldRenderView.getView();
+
+	Vector4 cullFrustum[12];
+	const uint32_t planeCount = (uint32_t)cf.planes.size();
+	for (uint32_t i = 0; i < planeCount; ++i)
+		cullFrustum[i] = cf.planes[i].normal().xyz0() + Vector4(0.0f, 0.0f, 0.0f, cf.planes[i].distance());
+
+	// Same test as cull shader; bounding sphere of instance in view space.
+	// Spheres are stored linearly per slot so we don't need to touch the instances.
+	const auto cull = [&](uint32_t from, uint32_t to)
+	{
+		for (uint32_t i = from; i < to; ++i)
+		{
+			const Vector4& bounds = m_bounds[i];
+			const Scalar nradius = -bounds.w();
+
+			bool visible = (nradius <= 0.0_simd);
+			if (visible)
+			{
+				const Vector4 center = view * bounds.xyz1();
+				for (uint32_t j = 0; visible && j < planeCount; ++j)
+					visible = (dot3(cullFrustum[j], center) - cullFrustum[j].w() >= nradius);
+			}
+
+			outVisibility[i] = visible ? 1.0f : 0.0f;
+		}
+	};
+
+	const uint32_t slotCount = (uint32_t)m_slots.size();
+	const uint32_t ntasks = std::min((slotCount + c_cullChunkSize - 1) / c_cullChunkSize, c_maxCullTasks);
+	if (ntasks > 1)
+	{
+		const uint32_t chunkSize = (slotCount + ntasks - 1) / ntasks;
+		StaticVector< Job::task_t, c_maxCullTasks > tasks;
+		for (uint32_t i = 0; i < ntasks; ++i)
+		{
+			tasks.push_back([&, i]() {
+				const uint32_t from = i * chunkSize;
+				const uint32_t to = std::min(from + chunkSize, slotCount);
+				cull(from, to);
+			});
+		}
+		JobManager::getInstance().fork(tasks.c_ptr(), tasks.size());
+	}
+	else
+		cull(0, slotCount);
+}
+
 void CullingComponent::Instance::destroy()
 {
 	T_FATAL_ASSERT(this->owner);
 	this->owner->destroyInstance(this);
 }
 
+float CullingComponent::nearestDistance(const WorldRenderView& worldRenderView, const Run& run) const
+{
+	// Nearest view depth of all instance spheres in run; used by cullables to
+	// select detail level conservatively for the whole run.
+	const Matrix44& view = worldRenderView.getView();
+	Scalar nearest(std::numeric_limits< float >::max());
+	for (uint32_t i = run.offset; i < run.offset + run.count; ++i)
+	{
+		const Vector4& bounds = m_bounds[i];
+		if (bounds.w() < 0.0_simd)
+			continue;
+
+		const Vector4 center = view * bounds.xyz1();
+		nearest = min(nearest, center.z() - bounds.w());
+	}
+	return (float)nearest;
+}
+
 void CullingComponent::Instance::setTransform(const Transform& transform)
 {
 	this->transform = transform;
 	this->boundingBox = this->cullable->cullableGetBoundingBox().transform(transform);
-	this->owner->m_instanceBufferDirty = true;
+	this->owner->setSlot(this->slot, this);
+	this->owner->markDirty(this->slot);
 }
 
 }
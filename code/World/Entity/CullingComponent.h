@@ -10,6 +10,7 @@
 
 #include "Core/RefArray.h"
 #include "Core/Containers/AlignedVector.h"
+#include "Core/Containers/SmallMap.h"
 #include "Core/Math/Aabb3.h"
 #include "Resource/Proxy.h"
 #include "World/IWorldComponent.h"
@@ -45,8 +46,13 @@ class IWorldRenderPass;
 class WorldBuildContext;
 class WorldRenderView;
 
-/*!
+/*! Culling and instanced drawing of cullables.
  * \ingroup World
+ *
+ * Instances are allocated in stable slots, instances of same
+ * ordinal are kept in a contiguous run of slots so they can
+ * be drawn in a single batch. Only slots which have changed
+ * are written to the instance buffer.
  */
 class T_DLLCLASS CullingComponent : public IWorldComponent
 {
@@ -67,6 +73,10 @@ public:
 	{
 		virtual Aabb3 cullableGetBoundingBox() const = 0;
 
+		/*! Build run of instances.
+		 *
+		 * \param distance Nearest view distance of any instance in run.
+		 */
 		virtual void cullableBuild(
 			const WorldBuildContext& context,
 			const world::WorldRenderView& worldRenderView,
@@ -74,7 +84,8 @@ public:
 			render::Buffer* instanceBuffer,
 			render::Buffer* visibilityBuffer,
 			uint32_t start,
-			uint32_t count
+			uint32_t count,
+			float distance
 		) = 0;
 	};
 
@@ -83,6 +94,7 @@ public:
 		CullingComponent* owner = nullptr;
 		ICullable* cullable = nullptr;
 		intptr_t ordinal = 0;
+		uint32_t slot = 0;
 		Transform transform;
 		Aabb3 boundingBox;
 
@@ -106,15 +118,53 @@ public:
 	Instance* createInstance(ICullable* cullable, intptr_t ordinal);
 
 private:
+	/*! Number of buffer locks dirty slots must be written to.
+	 *
+	 * Dynamic buffers are multi-buffered by the render system
+	 * thus each lock might return a different copy of the data.
+	 */
+	constexpr static uint32_t c_uploadHistory = 12;
+
+	/*! Contiguous range of slots with instances of same ordinal. */
+	struct Run
+	{
+		uint32_t offset = 0;
+		uint32_t capacity = 0;
+		uint32_t count = 0;
+	};
+
 	Ref< render::IRenderSystem > m_renderSystem;
 	resource::Proxy< render::Shader > m_shaderCull;
-	AlignedVector< Instance* > m_instances;
+	SmallMap< intptr_t, Run > m_runs;
+	AlignedVector< Instance* > m_slots;
+	AlignedVector< Vector4 > m_bounds;
+	AlignedVector< uint32_t > m_dirtySlots;
+	AlignedVector< uint32_t > m_uploadHistory[c_uploadHistory];
+	AlignedVector< uint32_t > m_uploadSlots;
 	Ref< render::Buffer > m_instanceBuffer;
 	RefArray< render::Buffer > m_visibilityBuffers;
+	RefArray< render::Buffer > m_cpuVisibilityBuffers;
+	uint32_t m_instanceCount = 0;
 	uint32_t m_instanceAllocatedCount = 0;
+	uint32_t m_uploadCount = 0;
+	uint32_t m_fullUploads = 0;
 	bool m_instanceBufferDirty = false;
 
 	void destroyInstance(Instance* instance);
+
+	void setSlot(uint32_t slot, Instance* instance);
+
+	void markDirty(uint32_t slot);
+
+	uint32_t allocateSlot(intptr_t ordinal);
+
+	void compactSlots();
+
+	void uploadInstances();
+
+	void cullInstances(const WorldRenderView& worldRenderView, float* outVisibility) const;
+
+	float nearestDistance(const WorldRenderView& worldRenderView, const Run& run) const;
 };
 
 }
@@ -343,8 +343,7 @@ void WorldRendererForward::setupVisualPass(
 
 		T_ASSERT(!wc.getRenderContext()->havePendingDraws());
 
-		for (const auto& r : m_gatheredView.renderables)
-			r.renderer->build(wc, worldRenderView, defaultPass, r.renderable);
+		wc.build(worldRenderView, defaultPass, m_gatheredView.renderables);
 
 		for (auto entityRenderer : m_entityRenderers->get())
 			entityRenderer->build(wc, worldRenderView, defaultPass);
@@ -84,6 +84,15 @@ public:
 		const WorldRenderView& worldRenderView,
 		const IWorldRenderPass& worldRenderPass
 	) = 0;
+
+	/*! Check if renderables can be built concurrently.
+	 *
+	 * If true then build of renderables might be called from
+	 * multiple threads at once, each thread with it's own
+	 * child render context. Build without renderable is
+	 * always called from a single thread.
+	 */
+	virtual bool isBuildConcurrent() const { return false; }
 };
 
 }
@@ -105,8 +105,7 @@ render::handle_t DBufferPass::setup(
 
 			T_ASSERT(!renderContext->havePendingDraws());
 
-			for (auto r : gatheredView.renderables)
-				r.renderer->build(wc, worldRenderView, dbufferPass, r.renderable);
+			wc.build(worldRenderView, dbufferPass, gatheredView.renderables);
 	
 			for (auto entityRenderer : m_entityRenderers->get())
 				entityRenderer->build(wc, worldRenderView, dbufferPass);
@@ -106,8 +106,7 @@ render::handle_t GBufferPass::setup(
 
 			T_ASSERT(!renderContext->havePendingDraws());
 
-			for (const auto& r : gatheredView.renderables)
-				r.renderer->build(wc, worldRenderView, gbufferPass, r.renderable);
+			wc.build(worldRenderView, gbufferPass, gatheredView.renderables);
 	
 			for (auto entityRenderer : m_entityRenderers->get())
 				entityRenderer->build(wc, worldRenderView, gbufferPass);
@@ -6,8 +6,13 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
-#include "Core/Math/Range.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "Core/Containers/StaticVector.h"
+#include "Core/Math/Const.h"
 #include "Core/Misc/SafeDestroy.h"
+#include "Core/Thread/JobManager.h"
 #include "Core/Timer/Profiler.h"
 #include "Render/Buffer.h"
 #include "Render/IRenderSystem.h"
@@ -17,6 +22,142 @@
 
 namespace traktor::world
 {
+	namespace
+	{
+
+const int32_t c_maxTasks = 16;
+const int32_t c_lightChunkSize = 256;
+const int32_t c_minParallelSliceWork = 256;
+const float c_maxConeAngle = deg2rad(85.0f);
+
+/*! Column or row boundary planes, four planes per group in SoA layout. */
+struct BoundaryPlanes
+{
+	constexpr static int32_t GroupCount = (ClusterDimXY + 1 + 3) / 4;
+
+	Vector4 nx[GroupCount];
+	Vector4 ny[GroupCount];
+	Vector4 nz[GroupCount];
+
+	void set(int32_t index, const Plane& plane)
+	{
+		float T_MATH_ALIGN16 e[4];
+
+		nx[index / 4].storeAligned(e);
+		e[index & 3] = plane.normal().x();
+		nx[index / 4] = Vector4::loadAligned(e);
+
+		ny[index / 4].storeAligned(e);
+		e[index & 3] = plane.normal().y();
+		ny[index / 4] = Vector4::loadAligned(e);
+
+		nz[index / 4].storeAligned(e);
+		e[index & 3] = plane.normal().z();
+		nz[index / 4] = Vector4::loadAligned(e);
+	}
+};
+
+/*! Get bit mask of non-negative elements. */
+T_MATH_INLINE uint32_t nonNegativeMask(const Vector4& v)
+{
+#if defined(T_MATH_USE_SSE2)
+	return (uint32_t)_mm_movemask_ps(_mm_cmpge_ps(v.m_data, _mm_setzero_ps()));
+#elif defined(T_MATH_USE_NEON)
+	const uint32_t T_MATH_ALIGN16 c_bits[] = { 1, 2, 4, 8 };
+	const uint32x4_t bits = vandq_u32(vcgeq_f32(v.m_data, vdupq_n_f32(0.0f)), vld1q_u32(c_bits));
+	const uint32x2_t sum = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+	return vget_lane_u32(vpadd_u32(sum, sum), 0);
+#else
+	float T_MATH_ALIGN16 e[4];
+	v.storeAligned(e);
+	return (e[0] >= 0.0f ? 1 : 0) | (e[1] >= 0.0f ? 2 : 0) | (e[2] >= 0.0f ? 4 : 0) | (e[3] >= 0.0f ? 8 : 0);
+#endif
+}
+
+/*! Calculate which tiles, in a single dimension, a light overlap.
+ *
+ * Boundary plane i is the left, or top, plane of tile i and
+ * the right, or bottom, plane of tile i - 1; a light is
+ * inside tile i if not completely outside either of those.
+ *
+ * Sphere is always tested, cone is only tested
+ * if base radius is positive.
+ */
+uint32_t overlapTiles(
+	const BoundaryPlanes& planes,
+	const Vector4& position,
+	const Scalar& range,
+	const Vector4& baseCenter,
+	const Vector4& direction,
+	const Scalar& baseRadius
+)
+{
+	const Vector4 ax(position.x()), ay(position.y()), az(position.z());
+	const Vector4 r(range);
+
+	uint32_t inside0 = 0;	//!< Inside of boundary as left/top plane.
+	uint32_t inside1 = 0;	//!< Inside of boundary as right/bottom plane.
+
+	if (baseRadius > 0.0_simd)
+	{
+		const Vector4 cx(baseCenter.x()), cy(baseCenter.y()), cz(baseCenter.z());
+		const Vector4 dx(direction.x()), dy(direction.y()), dz(direction.z());
+		const Vector4 br2(baseRadius * baseRadius);
+
+		for (int32_t i = 0; i < BoundaryPlanes::GroupCount; ++i)
+		{
+			const Vector4 pa = planes.nx[i] * ax + planes.ny[i] * ay + planes.nz[i] * az;
+			const Vector4 pc = planes.nx[i] * cx + planes.ny[i] * cy + planes.nz[i] * cz;
+			const Vector4 nd = planes.nx[i] * dx + planes.ny[i] * dy + planes.nz[i] * dz;
+
+			// Squared extent of cone's base disc along plane normal.
+			const Vector4 e2 = br2 * (Vector4::one() - nd * nd) - pc * pc;
+
+			const uint32_t sphere0 = nonNegativeMask(pa + r);
+			const uint32_t sphere1 = nonNegativeMask(r - pa);
+			const uint32_t cone0 = nonNegativeMask(pa) | nonNegativeMask(pc) | nonNegativeMask(e2);
+			const uint32_t cone1 = nonNegativeMask(-pa) | nonNegativeMask(-pc) | nonNegativeMask(e2);
+
+			inside0 |= (sphere0 & cone0) << (i * 4);
+			inside1 |= (sphere1 & cone1) << (i * 4);
+		}
+	}
+	else
+	{
+		for (int32_t i = 0; i < BoundaryPlanes::GroupCount; ++i)
+		{
+			const Vector4 pa = planes.nx[i] * ax + planes.ny[i] * ay + planes.nz[i] * az;
+			inside0 |= nonNegativeMask(pa + r) << (i * 4);
+			inside1 |= nonNegativeMask(r - pa) << (i * 4);
+		}
+	}
+
+	return inside0 & (inside1 >> 1) & ((1U << ClusterDimXY) - 1);
+}
+
+template < typename FunctionType >
+void parallelFor(int32_t count, int32_t chunkSize, const FunctionType& fn)
+{
+	const int32_t ntasks = std::min((count + chunkSize - 1) / chunkSize, c_maxTasks);
+	if (ntasks > 1)
+	{
+		const int32_t taskSize = (count + ntasks - 1) / ntasks;
+		StaticVector< Job::task_t, c_maxTasks > tasks;
+		for (int32_t i = 0; i < ntasks; ++i)
+		{
+			tasks.push_back([&, i]() {
+				const int32_t from = i * taskSize;
+				const int32_t to = std::min(from + taskSize, count);
+				fn(from, to);
+			});
+		}
+		JobManager::getInstance().fork(tasks.c_ptr(), tasks.size());
+	}
+	else if (count > 0)
+		fn(0, count);
+}
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.world.LightClusterPass", LightClusterPass, Object)
 
@@ -32,7 +173,7 @@ bool LightClusterPass::create(render::IRenderSystem* renderSystem)
 	// Tile light index array buffer.
 	m_lightIndexSBuffer = renderSystem->createBuffer(
 		render::BuStructured,
-		ClusterDimXY * ClusterDimXY * ClusterDimZ * MaxLightsPerCluster * sizeof(LightIndexShaderData),
+		c_maxLightIndexCount * sizeof(LightIndexShaderData),
 		true
 	);
 	if (!m_lightIndexSBuffer)
@@ -63,30 +204,40 @@ void LightClusterPass::setup(
 {
 	T_PROFILER_SCOPE(L"LightClusterPass::setup");
 
-	const auto& viewFrustum = worldRenderView.getViewFrustum();
-
 	TileShaderData* tileShaderData = (TileShaderData*)m_tileSBuffer->lock();
 	LightIndexShaderData* lightIndexShaderData = (LightIndexShaderData*)m_lightIndexSBuffer->lock();
 
-	StaticVector< Vector4, c_maxLightCount > lightPositions;
-	StaticVector< int32_t, c_maxLightCount > sliceLights;
-
-	// Calculate positions of lights in view space.
-	for (const auto& light : gatheredView.lights)
+	if (tileShaderData && lightIndexShaderData)
 	{
-		if (light)
-		{
-			const Vector4 lightPosition = light->getTransform().translation().xyz1();
-			lightPositions.push_back(worldRenderView.getView() * lightPosition);
-		}
-		else
-			lightPositions.push_back(Vector4::zero());
+		bin(
+			worldRenderView.getView(),
+			worldRenderView.getViewFrustum(),
+			gatheredView.lights,
+			tileShaderData,
+			lightIndexShaderData,
+			c_maxLightIndexCount
+		);
 	}
 
-	// Update tile data.
+	m_lightIndexSBuffer->unlock();
+	m_tileSBuffer->unlock();
+}
+
+uint32_t LightClusterPass::bin(
+	const Matrix44& view,
+	const Frustum& viewFrustum,
+	const AlignedVector< const LightComponent* >& lights,
+	TileShaderData* outTiles,
+	LightIndexShaderData* outLightIndices,
+	uint32_t maxLightIndexCount
+) const
+{
+	const int32_t lightCount = (int32_t)lights.size();
+
+	// Calculate column and row boundary planes, planes are
+	// shared by all tiles in the same column or row.
 	const Scalar dx(1.0f / ClusterDimXY);
 	const Scalar dy(1.0f / ClusterDimXY);
-	const Scalar dz(1.0f / ClusterDimZ);
 
 	const Vector4& tl = viewFrustum.corners[0];
 	const Vector4& tr = viewFrustum.corners[1];
@@ -95,148 +246,192 @@ void LightClusterPass::setup(
 	const Vector4 vx = tr - tl;
 	const Vector4 vy = bl - tl;
 
-	const Scalar vnz = viewFrustum.getNearZ();
-	const Scalar vfz = viewFrustum.getFarZ();
-
-	// Calculate XY tile frustums.
-	Frustum tileFrustums[ClusterDimXY * ClusterDimXY];
-	for (int32_t y = 0; y < ClusterDimXY; ++y)
+	BoundaryPlanes columns, rows;
+	for (int32_t i = 0; i < BoundaryPlanes::GroupCount; ++i)
 	{
-		const Scalar fy = Scalar((float)y) * dy;
-		for (int32_t x = 0; x < ClusterDimXY; ++x)
-		{
-			const Scalar fx = Scalar((float)x) * dx;
-
-			const Vector4 a = tl + vx * fx + vy * fy;
-			const Vector4 b = tl + vx * (fx + dx) + vy * fy;
-			const Vector4 c = tl + vx * (fx + dx) + vy * (fy + dy);
-			const Vector4 d = tl + vx * fx + vy * (fy + dy);
-
-			auto& tileFrustum = tileFrustums[x + y * ClusterDimXY];
-			tileFrustum.planes[Frustum::Left] = Plane(Vector4::zero(), d, a);
-			tileFrustum.planes[Frustum::Right] = Plane(Vector4::zero(), b, c);
-			tileFrustum.planes[Frustum::Bottom] = Plane(Vector4::zero(), c, d);
-			tileFrustum.planes[Frustum::Top] = Plane(Vector4::zero(), a, b);
-		}
+		columns.nx[i] = columns.ny[i] = columns.nz[i] = Vector4::zero();
+		rows.nx[i] = rows.ny[i] = rows.nz[i] = Vector4::zero();
 	}
-
-	// Group lights per cluster.
-	uint32_t lightOffset = 0;
-	for (int32_t z = 0; z < ClusterDimZ; ++z)
+	for (int32_t i = 0; i <= ClusterDimXY; ++i)
 	{
-		const float fz = (float)z;
-		const Scalar snz = vnz * power(vfz / vnz, Scalar(fz) / Scalar(ClusterDimZ));
-		const Scalar sfz = vnz * power(vfz / vnz, Scalar(fz + 1.0f) / Scalar(ClusterDimZ));
+		const Scalar fx = Scalar((float)i) * dx;
+		const Scalar fy = Scalar((float)i) * dy;
+		columns.set(i, Plane(Vector4::zero(), tl + vx * fx + vy, tl + vx * fx));
+		rows.set(i, Plane(Vector4::zero(), tl + vy * fy, tl + vx + vy * fy));
+	}
+
+	// Calculate depth of each slice boundary.
+	const float vnz = viewFrustum.getNearZ();
+	const float vfz = viewFrustum.getFarZ();
 
-		// Gather all lights intersecting slice.
-		sliceLights.clear();
-		for (uint32_t i = 0; i < gatheredView.lights.size(); ++i)
+	float sliceZ[ClusterDimZ + 1];
+	for (int32_t i = 0; i <= ClusterDimZ; ++i)
+		sliceZ[i] = vnz * std::pow(vfz / vnz, (float)i / ClusterDimZ);
+
+	// Calculate which clusters each light overlap, columns and rows
+	// are determined by sphere and cone versus boundary planes, and
+	// slices by light's depth range.
+	m_lightBounds.resize(lightCount);
+	parallelFor(lightCount, c_lightChunkSize, [&](int32_t from, int32_t to) {
+		for (int32_t i = from; i < to; ++i)
 		{
-			const auto light = gatheredView.lights[i];
+			const LightComponent* light = lights[i];
+			LightBounds& lb = m_lightBounds[i];
+
 			if (light->getLightType() == LightType::Directional)
 			{
-				sliceLights.push_back(i);
+				lb.columns = lb.rows = (1U << ClusterDimXY) - 1;
+				lb.slices[0] = 0;
+				lb.slices[1] = ClusterDimZ - 1;
+				continue;
 			}
-			else if (light->getLightType() == LightType::Point)
+			else if (light->getLightType() != LightType::Point && light->getLightType() != LightType::Spot)
 			{
-				const Scalar lr = light->getFarRange();
-				const Scalar lz = lightPositions[i].z();
-				if (lz + lr >= snz && lz - lr <= sfz)
-					sliceLights.push_back(i);
+				lb.columns = lb.rows = 0;
+				lb.slices[0] = 1;
+				lb.slices[1] = 0;
+				continue;
 			}
-			else if (light->getLightType() == LightType::Spot)
+
+			const Transform transform = light->getTransform();
+			const Vector4 position = view * transform.translation().xyz1();
+			const Scalar range = light->getFarRange();
+
+			float zmin = position.z() - range;
+			float zmax = position.z() + range;
+
+			Vector4 direction = Vector4::zero();
+			Vector4 baseCenter = Vector4::zero();
+			Scalar baseRadius = 0.0_simd;
+
+			const float halfAngle = light->getRadius() / 2.0f;
+			if (light->getLightType() == LightType::Spot && halfAngle < c_maxConeAngle)
 			{
-				const Scalar lr = light->getFarRange();
-				const Scalar lz = lightPositions[i].z();
-				if (lz + lr >= snz && lz - lr <= sfz)
-				{
-					Frustum spotFrustum;
-					spotFrustum.buildPerspective(light->getRadius(), 1.0f, 0.0f, lr);
+				// Bound spot by cone with flat base at range distance.
+				direction = view * transform.axisY().xyz0();
+				baseCenter = position + direction * range;
+				baseRadius = range * Scalar(std::tan(halfAngle));
+
+				const float ez = baseRadius * std::sqrt(std::max(1.0f - direction.z() * direction.z(), 0.0f));
+				zmin = std::max< float >(std::min< float >(position.z(), baseCenter.z() - ez), zmin);
+				zmax = std::min< float >(std::max< float >(position.z(), baseCenter.z() + ez), zmax);
+			}
 
-					const Matrix44 lmt = light->getTransform().toMatrix44() * rotateX(deg2rad(90.0f));
+			// First slice which far depth is beyond light and last slice which near depth is before light.
+			lb.slices[0] = (int32_t)(std::lower_bound(sliceZ + 1, sliceZ + ClusterDimZ + 1, zmin) - (sliceZ + 1));
+			lb.slices[1] = (int32_t)(std::upper_bound(sliceZ, sliceZ + ClusterDimZ, zmax) - sliceZ) - 1;
+			if (lb.slices[0] > lb.slices[1])
+			{
+				lb.columns = lb.rows = 0;
+				continue;
+			}
 
-					const Vector4 fr[4] =
-					{
-						lmt * spotFrustum.corners[4],
-						lmt * spotFrustum.corners[5],
-						lmt * spotFrustum.corners[6],
-						lmt * spotFrustum.corners[7]
-					};
-
-					Vector4 p[5];
-					p[0] = lightPositions[i];
-					p[1] = worldRenderView.getView() * fr[0].xyz1();
-					p[2] = worldRenderView.getView() * fr[1].xyz1();
-					p[3] = worldRenderView.getView() * fr[2].xyz1();
-					p[4] = worldRenderView.getView() * fr[3].xyz1();
-
-					Range< Scalar > bb;
-					bb.min = lz;
-					bb.max = lz;
-					for (int i = 0; i < 5; ++i)
-					{
-						bb.min = min(bb.min, p[i].z());
-						bb.max = max(bb.max, p[i].z());
-					}
-					if (Range< Scalar >::intersection(bb, Range< Scalar >(snz, sfz)).delta() >= 0.0_simd)
-						sliceLights.push_back(i);
-				}
+			lb.columns = overlapTiles(columns, position, range, baseCenter, direction, baseRadius);
+			lb.rows = overlapTiles(rows, position, range, baseCenter, direction, baseRadius);
+			if (!lb.columns || !lb.rows)
+			{
+				lb.slices[0] = 1;
+				lb.slices[1] = 0;
 			}
 		}
+	});
 
-		if (sliceLights.empty())
-			continue;
+	// Distribute lights to each overlapping slice, keep light order.
+	int32_t sliceWork = 0;
+	for (int32_t z = 0; z < ClusterDimZ; ++z)
+		m_slices[z].lights.resize(0);
+	for (int32_t i = 0; i < lightCount; ++i)
+	{
+		const LightBounds& lb = m_lightBounds[i];
+		for (int32_t z = lb.slices[0]; z <= lb.slices[1]; ++z)
+			m_slices[z].lights.push_back(i);
+		sliceWork += std::max(lb.slices[1] - lb.slices[0] + 1, 0);
+	}
 
-		for (int32_t y = 0; y < ClusterDimXY; ++y)
+	// Build compact light index list of each cluster in slice.
+	const int32_t sliceChunkSize = (sliceWork >= c_minParallelSliceWork) ? 1 : ClusterDimZ;
+	parallelFor(ClusterDimZ, sliceChunkSize, [&](int32_t from, int32_t to) {
+		for (int32_t z = from; z < to; ++z)
 		{
-			for (int32_t x = 0; x < ClusterDimXY; ++x)
-			{
-				auto& tileFrustum = tileFrustums[x + y * ClusterDimXY];
-				tileFrustum.planes[Frustum::Near] = Plane(Vector4(0.0f, 0.0f, 1.0f), snz);
-				tileFrustum.planes[Frustum::Far] = Plane(Vector4(0.0f, 0.0f, -1.0f), -sfz);
+			Slice& slice = m_slices[z];
+			std::memset(slice.counts, 0, sizeof(slice.counts));
 
-				int32_t count = 0;
-				for (uint32_t i = 0; i < sliceLights.size(); ++i)
+			for (int32_t lightIndex : slice.lights)
+			{
+				const LightBounds& lb = m_lightBounds[lightIndex];
+				for (int32_t y = 0; y < ClusterDimXY; ++y)
 				{
-					const int32_t lightIndex = sliceLights[i];
-					const auto light = gatheredView.lights[lightIndex];
-					if (light->getLightType() == LightType::Directional)
-					{
-						lightIndexShaderData[lightOffset + count].lightIndex[0] = lightIndex;
-						++count;
-					}
-					else if (light->getLightType() == LightType::Point)
+					if ((lb.rows & (1U << y)) == 0)
+						continue;
+					for (int32_t x = 0; x < ClusterDimXY; ++x)
 					{
-						if (tileFrustum.inside(lightPositions[lightIndex], light->getFarRange()) != Frustum::Result::Outside)
-						{
-							lightIndexShaderData[lightOffset + count].lightIndex[0] = lightIndex;
-							++count;
-						}
+						if ((lb.columns & (1U << x)) != 0)
+							slice.counts[x + y * ClusterDimXY]++;
 					}
-					else if (light->getLightType() == LightType::Spot)
+				}
+			}
+
+			uint32_t offsets[ClusterDimXY * ClusterDimXY];
+			uint32_t count = 0;
+			for (int32_t i = 0; i < ClusterDimXY * ClusterDimXY; ++i)
+			{
+				offsets[i] = count;
+				count += slice.counts[i];
+			}
+
+			slice.lightIndices.resize(count);
+			for (int32_t lightIndex : slice.lights)
+			{
+				const LightBounds& lb = m_lightBounds[lightIndex];
+				for (int32_t y = 0; y < ClusterDimXY; ++y)
+				{
+					if ((lb.rows & (1U << y)) == 0)
+						continue;
+					for (int32_t x = 0; x < ClusterDimXY; ++x)
 					{
-						// \fixme Implement frustum to frustum culling.
-						if (tileFrustum.inside(lightPositions[lightIndex], light->getFarRange()) != Frustum::Result::Outside)
-						{
-							lightIndexShaderData[lightOffset + count].lightIndex[0] = lightIndex;
-							++count;
-						}
+						if ((lb.columns & (1U << x)) != 0)
+							slice.lightIndices[offsets[x + y * ClusterDimXY]++] = lightIndex;
 					}
-					if (count >= MaxLightsPerCluster)
-						break;
 				}
+			}
+		}
+	});
 
-				const uint32_t tileOffset = x + y * ClusterDimXY + z * ClusterDimXY * ClusterDimXY;
-				tileShaderData[tileOffset].lightOffsetAndCount[0] = (int32_t)lightOffset;
-				tileShaderData[tileOffset].lightOffsetAndCount[1] = count;
+	// Assign each slice a range in output.
+	uint32_t lightOffset = 0;
+	for (int32_t z = 0; z < ClusterDimZ; ++z)
+	{
+		m_slices[z].offset = lightOffset;
+		lightOffset += (uint32_t)m_slices[z].lightIndices.size();
+	}
 
-				lightOffset += count;
+	// Write clusters and light indices, indices beyond capacity are dropped.
+	parallelFor(ClusterDimZ, sliceChunkSize, [&](int32_t from, int32_t to) {
+		for (int32_t z = from; z < to; ++z)
+		{
+			const Slice& slice = m_slices[z];
+
+			uint32_t offset = slice.offset;
+			uint32_t localOffset = 0;
+			for (int32_t i = 0; i < ClusterDimXY * ClusterDimXY; ++i)
+			{
+				const uint32_t clampedOffset = std::min(offset, maxLightIndexCount);
+				const uint32_t clampedCount = std::min(slice.counts[i], maxLightIndexCount - clampedOffset);
+
+				TileShaderData& tile = outTiles[i + z * ClusterDimXY * ClusterDimXY];
+				tile.lightOffsetAndCount[0] = (int32_t)clampedOffset;
+				tile.lightOffsetAndCount[1] = (int32_t)clampedCount;
+
+				for (uint32_t j = 0; j < clampedCount; ++j)
+					outLightIndices[clampedOffset + j].lightIndex[0] = slice.lightIndices[localOffset + j];
+
+				offset += slice.counts[i];
+				localOffset += slice.counts[i];
 			}
 		}
-	}
+	});
 
-	m_lightIndexSBuffer->unlock();
-	m_tileSBuffer->unlock();
+	return std::min(lightOffset, maxLightIndexCount);
 }
 
 }
@@ -9,6 +9,9 @@
 #pragma once
 
 #include "Core/Object.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Math/Frustum.h"
+#include "Core/Math/Matrix44.h"
 #include "Render/Types.h"
 #include "World/WorldRenderSettings.h"
 
@@ -26,17 +29,23 @@ namespace traktor::world
 {
 
 class Entity;
+class LightComponent;
 class WorldEntityRenderers;
 class WorldRenderView;
 
-/*!
+/*! Bin lights into view space clusters.
+ *
+ * Each cluster reference a variable length range of
+ * light indices; lights are binned in parallel, one
+ * job per group of depth slices.
  */
 class LightClusterPass : public Object
 {
     T_RTTI_CLASS;
 
 public:
-	const static int32_t c_maxLightCount = 16;
+	const static int32_t c_maxLightCount = 4096;
+	const static int32_t c_maxLightIndexCount = ClusterDimXY * ClusterDimXY * ClusterDimZ * AverageLightsPerCluster;
 
 #pragma pack(1)
 	struct LightIndexShaderData
@@ -63,14 +72,54 @@ public:
 		const GatherView& gatheredView
 	) const;
 
+	/*! Bin lights into clusters.
+	 *
+	 * Light indices which doesn't fit in output
+	 * are dropped, clusters are always fully written.
+	 *
+	 * \param view View transform.
+	 * \param viewFrustum View frustum in view space.
+	 * \param lights Lights to bin.
+	 * \param outTiles Cluster data, ClusterDimXY * ClusterDimXY * ClusterDimZ entries.
+	 * \param outLightIndices Light index data.
+	 * \param maxLightIndexCount Number of entries in light index data.
+	 * \return Number of light indices written.
+	 */
+	uint32_t bin(
+		const Matrix44& view,
+		const Frustum& viewFrustum,
+		const AlignedVector< const LightComponent* >& lights,
+		TileShaderData* outTiles,
+		LightIndexShaderData* outLightIndices,
+		uint32_t maxLightIndexCount
+	) const;
+
 	render::Buffer* getLightIndexSBuffer() const { return m_lightIndexSBuffer; }
 
 	render::Buffer* getTileSBuffer() const { return m_tileSBuffer; }
 
 private:
+	/*! Clusters overlapped by a light; columns and rows as bit masks, slices as inclusive range. */
+	struct LightBounds
+	{
+		uint32_t columns;
+		uint32_t rows;
+		int32_t slices[2];
+	};
+
+	struct Slice
+	{
+		AlignedVector< int32_t > lights;
+		AlignedVector< int32_t > lightIndices;
+		uint32_t counts[ClusterDimXY * ClusterDimXY];
+		uint32_t offset;
+	};
+
     WorldRenderSettings m_settings;
 	Ref< render::Buffer > m_lightIndexSBuffer;
 	Ref< render::Buffer > m_tileSBuffer;
+	mutable AlignedVector< LightBounds > m_lightBounds;
+	mutable Slice m_slices[ClusterDimZ];
 };
 
 }
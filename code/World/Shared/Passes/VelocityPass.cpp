@@ -130,9 +130,9 @@ render::handle_t VelocityPass::setup(
 			worldRenderView,
 			IWorldRenderPass::None);
 
-		for (auto r : gatheredView.renderables)
-			if (r.state.dynamic)
-				r.renderer->build(wc, worldRenderView, velocityPass, r.renderable);
+		wc.build(worldRenderView, velocityPass, gatheredView.renderables, [](const GatherView::Renderable& r) {
+			return r.state.dynamic;
+		});
 
 		for (auto entityRenderer : m_entityRenderers->get())
 			entityRenderer->build(wc, worldRenderView, velocityPass);
@@ -211,7 +211,6 @@ void WorldRendererShared::destroy()
 void WorldRendererShared::gather(const World* world, const std::function< bool(const EntityState& state) >& filter)
 {
 	T_PROFILER_SCOPE(L"WorldRendererShared::gather");
-	StaticVector< const LightComponent*, LightClusterPass::c_maxLightCount > lights;
 
 	m_gatheredView.renderables.resize(0);
 	m_gatheredView.lights.resize(0);
@@ -244,57 +243,84 @@ void WorldRendererShared::gather(const World* world, const std::function< bool(c
 
 		for (auto component : entity->getComponents())
 		{
-			IEntityRenderer* entityRenderer = m_entityRenderers->find(type_of(component));
-			if (entityRenderer)
-				m_gatheredView.renderables.push_back({ entityRenderer, component, state });
+			const ComponentBinding& binding = bindComponent(type_of(component));
+			if (binding.renderer)
+				m_gatheredView.renderables.push_back({ binding.renderer, component, state });
 
 			// Filter out components used to setup frame's lighting etc.
-			if (auto lightComponent = dynamic_type_cast< const LightComponent* >(component))
+			switch (binding.category)
 			{
-				if (lightComponent->getLightType() != LightType::Disabled && !lights.full())
-					lights.push_back(lightComponent);
+			case ComponentBinding::Category::Light:
+				{
+					auto lightComponent = static_cast< const LightComponent* >(component);
+					if (lightComponent->getLightType() != LightType::Disabled && m_gatheredView.lights.size() < LightClusterPass::c_maxLightCount)
+						m_gatheredView.lights.push_back(lightComponent);
+				}
+				break;
+
+			case ComponentBinding::Category::Probe:
+				m_gatheredView.probes.push_back(static_cast< const ProbeComponent* >(component));
+				break;
+
+			case ComponentBinding::Category::Fog:
+				m_gatheredView.fog = static_cast< const FogComponent* >(component);
+				break;
+
+			default:
+				break;
 			}
-			else if (auto probeComponent = dynamic_type_cast< const ProbeComponent* >(component))
-				m_gatheredView.probes.push_back(probeComponent);
-			else if (auto fogComponent = dynamic_type_cast< const FogComponent* >(component))
-				m_gatheredView.fog = fogComponent;
 		}
 	}
 
 	// Arrange lights.
 	{
-		m_gatheredView.lights.resize(0);
 		m_gatheredView.cascadingDirectionalLight = nullptr;
 
-		// Find cascade shadow directional light.
+		// Find cascade shadow directional light and move it last.
 		const bool shadowsEnable = (bool)(m_shadowsQuality != Quality::Disabled);
 		if (shadowsEnable)
 		{
-			for (int32_t i = 0; i < (int32_t)lights.size(); ++i)
+			auto& lights = m_gatheredView.lights;
+			for (auto it = lights.begin(); it != lights.end(); ++it)
 			{
-				auto& light = lights[i];
+				const LightComponent* light = *it;
 				if (
 					light->getCastShadow() &&
 					light->getLightType() == LightType::Directional)
 				{
 					m_gatheredView.cascadingDirectionalLight = light;
+					lights.erase(it);
+					lights.push_back(light);
 					break;
 				}
 			}
 		}
+	}
+}
 
-		// Add all lights, skip cascade shadow directional light.
-		for (int32_t i = 0; i < (int32_t)lights.size(); ++i)
-		{
-			auto& light = lights[i];
-			if (light != m_gatheredView.cascadingDirectionalLight)
-				m_gatheredView.lights.push_back(light);
-		}
-
-		// Append cascade shadow directional light last.
-		if (m_gatheredView.cascadingDirectionalLight != nullptr)
-			m_gatheredView.lights.push_back(m_gatheredView.cascadingDirectionalLight);
+const WorldRendererShared::ComponentBinding& WorldRendererShared::bindComponent(const TypeInfo& componentType)
+{
+	// Flush bindings if set of entity renderers has been modified.
+	if (m_componentBindingsGeneration != m_entityRenderers->getGeneration())
+	{
+		m_componentBindings.clear();
+		m_componentBindingsGeneration = m_entityRenderers->getGeneration();
 	}
+
+	if (const ComponentBinding* binding = m_componentBindings.find(&componentType))
+		return *binding;
+
+	ComponentBinding binding;
+	binding.renderer = m_entityRenderers->find(componentType);
+	if (is_type_of< LightComponent >(componentType))
+		binding.category = ComponentBinding::Category::Light;
+	else if (is_type_of< ProbeComponent >(componentType))
+		binding.category = ComponentBinding::Category::Probe;
+	else if (is_type_of< FogComponent >(componentType))
+		binding.category = ComponentBinding::Category::Fog;
+
+	m_componentBindings.insert(&componentType, binding);
+	return *m_componentBindings.find(&componentType);
 }
 
 void WorldRendererShared::setupLightPass(
@@ -332,7 +358,7 @@ void WorldRendererShared::setupLightPass(
 		for (int32_t i = 0; i < (int32_t)m_gatheredView.lights.size(); ++i)
 		{
 			const auto& light = m_gatheredView.lights[i];
-			if (light->getCastShadow() && light->getLightType() == LightType::Spot)
+			if (light->getCastShadow() && light->getLightType() == LightType::Spot && !lightAtlasIndices.full())
 				lightAtlasIndices.push_back(i);
 		}
 	}
@@ -519,9 +545,9 @@ void WorldRendererShared::setupLightPass(
 						m_screenRenderer->draw(renderContext, m_clearDepthShader, perm, nullptr);
 					}
 
-					for (const auto& r : m_gatheredView.renderables)
-						if (includeDynamic || !r.state.dynamic)
-							r.renderer->build(wc, shadowRenderView, shadowPass, r.renderable);
+					wc.build(shadowRenderView, shadowPass, m_gatheredView.renderables, [=](const GatherView::Renderable& r) {
+						return includeDynamic || !r.state.dynamic;
+					});
 
 					for (auto entityRenderer : m_entityRenderers->get())
 						entityRenderer->build(wc, shadowRenderView, shadowPass);
@@ -655,8 +681,7 @@ void WorldRendererShared::setupLightPass(
 					m_screenRenderer->draw(renderContext, m_clearDepthShader, perm, nullptr);
 				}
 
-				for (const auto& r : m_gatheredView.renderables)
-					r.renderer->build(wc, shadowRenderView, shadowPass, r.renderable);
+				wc.build(shadowRenderView, shadowPass, m_gatheredView.renderables);
 
 				for (auto entityRenderer : m_entityRenderers->get())
 					entityRenderer->build(wc, shadowRenderView, shadowPass);
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "Core/Containers/AlignedVector.h"
+#include "Core/Containers/HashMap.h"
 #include "Core/Math/Frustum.h"
 #include "Resource/Proxy.h"
 #include "World/IWorldRenderer.h"
@@ -82,6 +83,21 @@ protected:
 
 #pragma pack()
 
+	/*! Cached binding of component type to renderer and gather category. */
+	struct ComponentBinding
+	{
+		enum class Category : uint8_t
+		{
+			None,
+			Light,
+			Probe,
+			Fog
+		};
+
+		IEntityRenderer* renderer = nullptr;
+		Category category = Category::None;
+	};
+
 	struct State
 	{
 		Ref< render::Buffer > lightSBuffer;
@@ -116,12 +132,16 @@ protected:
 	resource::Proxy< render::Shader > m_clearDepthShader;
 
 	GatherView m_gatheredView;
+	HashMap< const TypeInfo*, ComponentBinding > m_componentBindings;
+	uint32_t m_componentBindingsGeneration = ~0U;
 	Ref< Packer > m_shadowAtlasPacker;
 	AlignedVector< render::handle_t > m_visualAttachments;
 	State m_state[4];
 
 	void gather(const World* world, const std::function< bool(const EntityState& state) >& filter);
 
+	const ComponentBinding& bindComponent(const TypeInfo& componentType);
+
 	void setupLightPass(
 		const WorldRenderView& worldRenderView,
 		render::RenderGraph& renderGraph,
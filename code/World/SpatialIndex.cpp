@@ -0,0 +1,358 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Math/MathUtils.h"
+#include "World/SpatialIndex.h"
+
+namespace traktor::world
+{
+	namespace
+	{
+
+const float c_margin = 0.25f;
+const float c_marginScale = 0.1f;
+
+Aabb3 enlarge(const Aabb3& bounds)
+{
+	const Vector4 extent = bounds.getExtent();
+	const float largest = max(max(extent.x(), extent.y()), extent.z());
+	return bounds.expand(Scalar(c_margin + largest * c_marginScale));
+}
+
+Aabb3 combine(const Aabb3& a, const Aabb3& b)
+{
+	return Aabb3(min(a.mn, b.mn), max(a.mx, b.mx));
+}
+
+float surfaceArea(const Aabb3& bounds)
+{
+	const Vector4 d = bounds.mx - bounds.mn;
+	return 2.0f * (d.x() * d.y() + d.y() * d.z() + d.z() * d.x());
+}
+
+bool contains(const Aabb3& outer, const Aabb3& inner)
+{
+	return
+		compareAllLessEqual(outer.mn.xyz0(), inner.mn.xyz0()) &&
+		compareAllLessEqual(inner.mx.xyz0(), outer.mx.xyz0());
+}
+
+	}
+
+int32_t SpatialIndex::insert(const Aabb3& bounds, Entity* entity)
+{
+	const int32_t proxy = allocateNode();
+	Node& node = m_nodes[proxy];
+	node.bounds = enlarge(bounds);
+	node.entity = entity;
+	node.height = 0;
+	insertLeaf(proxy);
+	return proxy;
+}
+
+void SpatialIndex::remove(int32_t proxy)
+{
+	T_ASSERT(m_nodes[proxy].isLeaf());
+	removeLeaf(proxy);
+	freeNode(proxy);
+}
+
+bool SpatialIndex::update(int32_t proxy, const Aabb3& bounds)
+{
+	T_ASSERT(m_nodes[proxy].isLeaf());
+
+	// Still inside enlarged bounds; no need to modify tree.
+	if (contains(m_nodes[proxy].bounds, bounds))
+		return false;
+
+	removeLeaf(proxy);
+	m_nodes[proxy].bounds = enlarge(bounds);
+	insertLeaf(proxy);
+	return true;
+}
+
+void SpatialIndex::clear()
+{
+	m_nodes.resize(0);
+	m_root = -1;
+	m_free = -1;
+}
+
+int32_t SpatialIndex::allocateNode()
+{
+	if (m_free < 0)
+	{
+		m_nodes.push_back();
+		m_free = (int32_t)m_nodes.size() - 1;
+		m_nodes[m_free].parent = -1;
+	}
+
+	const int32_t index = m_free;
+	m_free = m_nodes[index].parent;
+
+	Node& node = m_nodes[index];
+	node.entity = nullptr;
+	node.parent = -1;
+	node.child[0] = node.child[1] = -1;
+	node.height = 0;
+	return index;
+}
+
+void SpatialIndex::freeNode(int32_t index)
+{
+	Node& node = m_nodes[index];
+	node.entity = nullptr;
+	node.parent = m_free;
+	node.height = -1;
+	m_free = index;
+}
+
+void SpatialIndex::insertLeaf(int32_t leaf)
+{
+	if (m_root < 0)
+	{
+		m_root = leaf;
+		m_nodes[leaf].parent = -1;
+		return;
+	}
+
+	// Find best sibling using surface area heuristic.
+	const Aabb3 leafBounds = m_nodes[leaf].bounds;
+
+	int32_t index = m_root;
+	while (!m_nodes[index].isLeaf())
+	{
+		const Node& node = m_nodes[index];
+
+		const float area = surfaceArea(node.bounds);
+		const float combinedArea = surfaceArea(combine(node.bounds, leafBounds));
+
+		// Cost of creating a new parent for this node and the new leaf.
+		const float cost = 2.0f * combinedArea;
+
+		// Minimum cost of pushing the leaf further down the tree.
+		const float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float childCost[2];
+		for (int32_t i = 0; i < 2; ++i)
+		{
+			const Node& child = m_nodes[node.child[i]];
+			if (child.isLeaf())
+				childCost[i] = surfaceArea(combine(leafBounds, child.bounds)) + inheritanceCost;
+			else
+				childCost[i] = (surfaceArea(combine(leafBounds, child.bounds)) - surfaceArea(child.bounds)) + inheritanceCost;
+		}
+
+		if (cost < childCost[0] && cost < childCost[1])
+			break;
+
+		index = (childCost[0] < childCost[1]) ? node.child[0] : node.child[1];
+	}
+
+	const int32_t sibling = index;
+
+	// Create new parent.
+	const int32_t oldParent = m_nodes[sibling].parent;
+	const int32_t newParent = allocateNode();
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].bounds = combine(leafBounds, m_nodes[sibling].bounds);
+	m_nodes[newParent].height = m_nodes[sibling].height + 1;
+	m_nodes[newParent].child[0] = sibling;
+	m_nodes[newParent].child[1] = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	if (oldParent >= 0)
+	{
+		if (m_nodes[oldParent].child[0] == sibling)
+			m_nodes[oldParent].child[0] = newParent;
+		else
+			m_nodes[oldParent].child[1] = newParent;
+	}
+	else
+		m_root = newParent;
+
+	// Walk back up the tree fixing heights and bounds.
+	index = m_nodes[leaf].parent;
+	while (index >= 0)
+	{
+		index = balance(index);
+
+		Node& node = m_nodes[index];
+		const Node& child0 = m_nodes[node.child[0]];
+		const Node& child1 = m_nodes[node.child[1]];
+		node.height = 1 + max(child0.height, child1.height);
+		node.bounds = combine(child0.bounds, child1.bounds);
+
+		index = node.parent;
+	}
+}
+
+void SpatialIndex::removeLeaf(int32_t leaf)
+{
+	if (leaf == m_root)
+	{
+		m_root = -1;
+		return;
+	}
+
+	const int32_t parent = m_nodes[leaf].parent;
+	const int32_t grandParent = m_nodes[parent].parent;
+	const int32_t sibling = (m_nodes[parent].child[0] == leaf) ? m_nodes[parent].child[1] : m_nodes[parent].child[0];
+
+	if (grandParent >= 0)
+	{
+		// Destroy parent and connect sibling to grand parent.
+		if (m_nodes[grandParent].child[0] == parent)
+			m_nodes[grandParent].child[0] = sibling;
+		else
+			m_nodes[grandParent].child[1] = sibling;
+		m_nodes[sibling].parent = grandParent;
+		freeNode(parent);
+
+		// Adjust ancestor bounds.
+		int32_t index = grandParent;
+		while (index >= 0)
+		{
+			index = balance(index);
+
+			Node& node = m_nodes[index];
+			const Node& child0 = m_nodes[node.child[0]];
+			const Node& child1 = m_nodes[node.child[1]];
+			node.bounds = combine(child0.bounds, child1.bounds);
+			node.height = 1 + max(child0.height, child1.height);
+
+			index = node.parent;
+		}
+	}
+	else
+	{
+		m_root = sibling;
+		m_nodes[sibling].parent = -1;
+		freeNode(parent);
+	}
+
+	m_nodes[leaf].parent = -1;
+}
+
+int32_t SpatialIndex::balance(int32_t iA)
+{
+	// Perform a left or right rotation if node A is imbalanced.
+	Node& A = m_nodes[iA];
+	if (A.isLeaf() || A.height < 2)
+		return iA;
+
+	const int32_t iB = A.child[0];
+	const int32_t iC = A.child[1];
+	Node& B = m_nodes[iB];
+	Node& C = m_nodes[iC];
+
+	const int32_t balance = C.height - B.height;
+
+	// Rotate C up.
+	if (balance > 1)
+	{
+		const int32_t iF = C.child[0];
+		const int32_t iG = C.child[1];
+		Node& F = m_nodes[iF];
+		Node& G = m_nodes[iG];
+
+		// Swap A and C.
+		C.child[0] = iA;
+		C.parent = A.parent;
+		A.parent = iC;
+
+		// A's old parent should point to C.
+		if (C.parent >= 0)
+		{
+			if (m_nodes[C.parent].child[0] == iA)
+				m_nodes[C.parent].child[0] = iC;
+			else
+				m_nodes[C.parent].child[1] = iC;
+		}
+		else
+			m_root = iC;
+
+		// Rotate.
+		if (F.height > G.height)
+		{
+			C.child[1] = iF;
+			A.child[1] = iG;
+			G.parent = iA;
+			A.bounds = combine(B.bounds, G.bounds);
+			C.bounds = combine(A.bounds, F.bounds);
+			A.height = 1 + max(B.height, G.height);
+			C.height = 1 + max(A.height, F.height);
+		}
+		else
+		{
+			C.child[1] = iG;
+			A.child[1] = iF;
+			F.parent = iA;
+			A.bounds = combine(B.bounds, F.bounds);
+			C.bounds = combine(A.bounds, G.bounds);
+			A.height = 1 + max(B.height, F.height);
+			C.height = 1 + max(A.height, G.height);
+		}
+
+		return iC;
+	}
+
+	// Rotate B up.
+	if (balance < -1)
+	{
+		const int32_t iD = B.child[0];
+		const int32_t iE = B.child[1];
+		Node& D = m_nodes[iD];
+		Node& E = m_nodes[iE];
+
+		// Swap A and B.
+		B.child[0] = iA;
+		B.parent = A.parent;
+		A.parent = iB;
+
+		// A's old parent should point to B.
+		if (B.parent >= 0)
+		{
+			if (m_nodes[B.parent].child[0] == iA)
+				m_nodes[B.parent].child[0] = iB;
+			else
+				m_nodes[B.parent].child[1] = iB;
+		}
+		else
+			m_root = iB;
+
+		// Rotate.
+		if (D.height > E.height)
+		{
+			B.child[1] = iD;
+			A.child[0] = iE;
+			E.parent = iA;
+			A.bounds = combine(C.bounds, E.bounds);
+			B.bounds = combine(A.bounds, D.bounds);
+			A.height = 1 + max(C.height, E.height);
+			B.height = 1 + max(A.height, D.height);
+		}
+		else
+		{
+			B.child[1] = iE;
+			A.child[0] = iD;
+			D.parent = iA;
+			A.bounds = combine(C.bounds, D.bounds);
+			B.bounds = combine(A.bounds, E.bounds);
+			A.height = 1 + max(C.height, D.height);
+			B.height = 1 + max(A.height, E.height);
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
+
+}
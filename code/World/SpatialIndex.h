@@ -0,0 +1,220 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Math/Aabb3.h"
+#include "Core/Math/Frustum.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_WORLD_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::world
+{
+
+class Entity;
+
+/*! Spatial index of entities.
+ * \ingroup World
+ *
+ * Dynamic AABB tree, leaves are stored with
+ * enlarged bounds so small movements doesn't
+ * require the tree to be restructured.
+ */
+class T_DLLCLASS SpatialIndex
+{
+public:
+	/*! Insert entity.
+	 *
+	 * \param bounds World space bounds of entity.
+	 * \param entity Entity.
+	 * \return Proxy handle.
+	 */
+	int32_t insert(const Aabb3& bounds, Entity* entity);
+
+	/*! Remove entity.
+	 *
+	 * \param proxy Proxy handle.
+	 */
+	void remove(int32_t proxy);
+
+	/*! Update entity bounds.
+	 *
+	 * \param proxy Proxy handle.
+	 * \param bounds New world space bounds of entity.
+	 * \return True if leaf was re-inserted into tree.
+	 */
+	bool update(int32_t proxy, const Aabb3& bounds);
+
+	/*! Remove all entities. */
+	void clear();
+
+	/*! Get enlarged bounds of proxy. */
+	const Aabb3& getBounds(int32_t proxy) const { return m_nodes[proxy].bounds; }
+
+	/*! Get tree height, used for diagnostics. */
+	int32_t getHeight() const { return m_root >= 0 ? m_nodes[m_root].height : 0; }
+
+	/*! Visit all entities which bounds overlap query bounds.
+	 *
+	 * \param bounds Query bounds.
+	 * \param visitor Called with each entity.
+	 */
+	template < typename VisitorType >
+	void query(const Aabb3& bounds, VisitorType&& visitor) const
+	{
+		if (m_root < 0)
+			return;
+
+		int32_t stack[c_maxStackDepth];
+		int32_t depth = 0;
+		stack[depth++] = m_root;
+
+		while (depth > 0)
+		{
+			const Node& node = m_nodes[stack[--depth]];
+			if (!overlap(node.bounds, bounds))
+				continue;
+
+			if (node.isLeaf())
+				visitor(node.entity);
+			else
+			{
+				stack[depth++] = node.child[0];
+				stack[depth++] = node.child[1];
+			}
+		}
+	}
+
+	/*! Visit all entities which bounds intersect frustum.
+	 *
+	 * \param frustum Query frustum.
+	 * \param visitor Called with each entity.
+	 */
+	template < typename VisitorType >
+	void query(const Frustum& frustum, VisitorType&& visitor) const
+	{
+		if (m_root < 0)
+			return;
+
+		// Keep track of which planes each node's parent is intersecting,
+		// planes the parent is completely inside of need not be tested.
+		struct Entry
+		{
+			int32_t index;
+			uint32_t planeMask;
+		};
+
+		Entry stack[c_maxStackDepth];
+		int32_t depth = 0;
+		stack[depth++] = { m_root, (1U << frustum.planes.size()) - 1 };
+
+		while (depth > 0)
+		{
+			const Entry entry = stack[--depth];
+			const Node& node = m_nodes[entry.index];
+
+			uint32_t planeMask = entry.planeMask;
+			if (!inside(frustum, node.bounds, planeMask))
+				continue;
+
+			if (node.isLeaf())
+				visitor(node.entity);
+			else if (planeMask == 0)
+				visitAll(entry.index, visitor);
+			else
+			{
+				stack[depth++] = { node.child[0], planeMask };
+				stack[depth++] = { node.child[1], planeMask };
+			}
+		}
+	}
+
+private:
+	constexpr static int32_t c_maxStackDepth = 256;
+
+	struct Node
+	{
+		Aabb3 bounds;
+		Entity* entity = nullptr;
+		int32_t parent = -1;	//!< Parent node, or next free node when node is in free list.
+		int32_t child[2] = { -1, -1 };
+		int32_t height = -1;	//!< Leaf nodes are 0, free nodes are -1.
+
+		bool isLeaf() const { return child[0] < 0; }
+	};
+
+	AlignedVector< Node > m_nodes;
+	int32_t m_root = -1;
+	int32_t m_free = -1;
+
+	static bool overlap(const Aabb3& a, const Aabb3& b)
+	{
+		return
+			compareAllLessEqual(a.mn.xyz0(), b.mx.xyz0()) &&
+			compareAllLessEqual(b.mn.xyz0(), a.mx.xyz0());
+	}
+
+	static bool inside(const Frustum& frustum, const Aabb3& bounds, uint32_t& inOutPlaneMask)
+	{
+		for (uint32_t i = 0; i < frustum.planes.size(); ++i)
+		{
+			if ((inOutPlaneMask & (1U << i)) == 0)
+				continue;
+
+			const Plane& plane = frustum.planes[i];
+
+			const Vector4 n = select(plane.normal(), bounds.mn, bounds.mx);
+			if (plane.distance(n) < 0.0_simd)
+				return false;
+
+			const Vector4 p = select(plane.normal(), bounds.mx, bounds.mn);
+			if (plane.distance(p) >= 0.0_simd)
+				inOutPlaneMask &= ~(1U << i);
+		}
+		return true;
+	}
+
+	template < typename VisitorType >
+	void visitAll(int32_t index, VisitorType& visitor) const
+	{
+		int32_t stack[c_maxStackDepth];
+		int32_t depth = 0;
+		stack[depth++] = index;
+
+		while (depth > 0)
+		{
+			const Node& node = m_nodes[stack[--depth]];
+			if (node.isLeaf())
+				visitor(node.entity);
+			else
+			{
+				stack[depth++] = node.child[0];
+				stack[depth++] = node.child[1];
+			}
+		}
+	}
+
+	int32_t allocateNode();
+
+	void freeNode(int32_t index);
+
+	void insertLeaf(int32_t leaf);
+
+	void removeLeaf(int32_t leaf);
+
+	int32_t balance(int32_t index);
+};
+
+}
@@ -0,0 +1,273 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cmath>
+#include "Core/Log/Log.h"
+#include "Core/Math/Const.h"
+#include "Core/Math/Quaternion.h"
+#include "Core/Math/Random.h"
+#include "Core/Timer/Timer.h"
+#include "World/Entity.h"
+#include "World/Entity/LightComponent.h"
+#include "World/Shared/Passes/LightClusterPass.h"
+#include "World/Test/CaseLightCluster.h"
+
+namespace traktor::world::test
+{
+	namespace
+	{
+
+const int32_t c_clusterCount = ClusterDimXY * ClusterDimXY * ClusterDimZ;
+const int32_t c_benchmarkIterations = 20;
+
+struct ReferenceLight
+{
+	bool directional = false;
+	Vector4 position;
+	Scalar range;
+	Vector4 direction;
+	Vector4 baseCenter;
+	Scalar baseRadius;
+	float zmin;
+	float zmax;
+};
+
+/*! Light is not completely outside of plane through origin. */
+bool insidePlane(const Vector4& n, const ReferenceLight& light)
+{
+	const Scalar pa = n.x() * light.position.x() + n.y() * light.position.y() + n.z() * light.position.z();
+	if (!(pa + light.range >= 0.0_simd))
+		return false;
+
+	if (light.baseRadius > 0.0_simd)
+	{
+		const Scalar pc = n.x() * light.baseCenter.x() + n.y() * light.baseCenter.y() + n.z() * light.baseCenter.z();
+		const Scalar nd = n.x() * light.direction.x() + n.y() * light.direction.y() + n.z() * light.direction.z();
+		const Scalar e2 = (light.baseRadius * light.baseRadius) * (1.0_simd - nd * nd) - pc * pc;
+		if (pa < 0.0_simd && pc < 0.0_simd && e2 < 0.0_simd)
+			return false;
+	}
+
+	return true;
+}
+
+/*! Brute force binning, each light tested against each cluster. */
+void referenceBin(
+	const Matrix44& view,
+	const Frustum& viewFrustum,
+	const AlignedVector< const LightComponent* >& lights,
+	AlignedVector< AlignedVector< int32_t > >& outClusters
+)
+{
+	const Scalar dx(1.0f / ClusterDimXY);
+	const Scalar dy(1.0f / ClusterDimXY);
+
+	const Vector4& tl = viewFrustum.corners[0];
+	const Vector4 vx = viewFrustum.corners[1] - tl;
+	const Vector4 vy = viewFrustum.corners[3] - tl;
+
+	Vector4 columns[ClusterDimXY + 1];
+	Vector4 rows[ClusterDimXY + 1];
+	for (int32_t i = 0; i <= ClusterDimXY; ++i)
+	{
+		const Scalar fx = Scalar((float)i) * dx;
+		const Scalar fy = Scalar((float)i) * dy;
+		columns[i] = Plane(Vector4::zero(), tl + vx * fx + vy, tl + vx * fx).normal();
+		rows[i] = Plane(Vector4::zero(), tl + vy * fy, tl + vx + vy * fy).normal();
+	}
+
+	const float vnz = viewFrustum.getNearZ();
+	const float vfz = viewFrustum.getFarZ();
+
+	float sliceZ[ClusterDimZ + 1];
+	for (int32_t i = 0; i <= ClusterDimZ; ++i)
+		sliceZ[i] = vnz * std::pow(vfz / vnz, (float)i / ClusterDimZ);
+
+	AlignedVector< ReferenceLight > referenceLights(lights.size());
+	for (uint32_t i = 0; i < lights.size(); ++i)
+	{
+		const LightComponent* light = lights[i];
+		ReferenceLight& rl = referenceLights[i];
+
+		rl.directional = (light->getLightType() == LightType::Directional);
+		if (rl.directional)
+			continue;
+
+		const Transform transform = light->getTransform();
+		rl.position = view * transform.translation().xyz1();
+		rl.range = light->getFarRange();
+		rl.direction = Vector4::zero();
+		rl.baseCenter = Vector4::zero();
+		rl.baseRadius = 0.0_simd;
+		rl.zmin = rl.position.z() - rl.range;
+		rl.zmax = rl.position.z() + rl.range;
+
+		const float halfAngle = light->getRadius() / 2.0f;
+		if (light->getLightType() == LightType::Spot && halfAngle < deg2rad(85.0f))
+		{
+			rl.direction = view * transform.axisY().xyz0();
+			rl.baseCenter = rl.position + rl.direction * rl.range;
+			rl.baseRadius = rl.range * Scalar(std::tan(halfAngle));
+
+			const float ez = rl.baseRadius * std::sqrt(std::max(1.0f - rl.direction.z() * rl.direction.z(), 0.0f));
+			rl.zmin = std::max< float >(std::min< float >(rl.position.z(), rl.baseCenter.z() - ez), rl.zmin);
+			rl.zmax = std::min< float >(std::max< float >(rl.position.z(), rl.baseCenter.z() + ez), rl.zmax);
+		}
+	}
+
+	outClusters.resize(c_clusterCount);
+	for (int32_t z = 0; z < ClusterDimZ; ++z)
+	{
+		for (int32_t y = 0; y < ClusterDimXY; ++y)
+		{
+			for (int32_t x = 0; x < ClusterDimXY; ++x)
+			{
+				auto& cluster = outClusters[x + y * ClusterDimXY + z * ClusterDimXY * ClusterDimXY];
+				cluster.resize(0);
+
+				for (uint32_t i = 0; i < referenceLights.size(); ++i)
+				{
+					const ReferenceLight& rl = referenceLights[i];
+					if (!rl.directional)
+					{
+						if (rl.zmax < sliceZ[z] || rl.zmin > sliceZ[z + 1])
+							continue;
+						if (!insidePlane(columns[x], rl) || !insidePlane(-columns[x + 1], rl))
+							continue;
+						if (!insidePlane(rows[y], rl) || !insidePlane(-rows[y + 1], rl))
+							continue;
+					}
+					cluster.push_back((int32_t)i);
+				}
+			}
+		}
+	}
+}
+
+/*! Create random lights in front of camera, one directional and a quarter spots. */
+void createLights(int32_t lightCount, Random& rnd, RefArray< Entity >& outEntities, AlignedVector< const LightComponent* >& outLights)
+{
+	outEntities.resize(0);
+	outLights.resize(0);
+
+	for (int32_t i = 0; i < lightCount; ++i)
+	{
+		LightType lightType = LightType::Point;
+		if (i == 0)
+			lightType = LightType::Directional;
+		else if ((i % 4) == 0)
+			lightType = LightType::Spot;
+
+		const Vector4 position(
+			(rnd.nextFloat() - 0.5f) * 300.0f,
+			rnd.nextFloat() * 20.0f,
+			rnd.nextFloat() * 300.0f - 10.0f,
+			1.0f
+		);
+		const Quaternion rotation = Quaternion::fromEulerAngles(
+			rnd.nextFloat() * TWO_PI,
+			(rnd.nextFloat() - 0.5f) * TWO_PI,
+			0.0f
+		);
+
+		Ref< LightComponent > light = new LightComponent(
+			lightType,
+			Vector4(1.0f, 1.0f, 1.0f, 0.0f),
+			false,
+			0.0f,
+			2.0f + rnd.nextFloat() * 13.0f,
+			deg2rad(20.0f + rnd.nextFloat() * 100.0f),
+			0.0f,
+			0.0f
+		);
+
+		Ref< Entity > entity = new Entity(Guid(), L"", Transform(position, rotation));
+		entity->setComponent(light);
+
+		outEntities.push_back(entity);
+		outLights.push_back(light);
+	}
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.world.test.CaseLightCluster", 0, CaseLightCluster, traktor::test::Case)
+
+void CaseLightCluster::run()
+{
+	const Matrix44 view = lookAt(Vector4(0.0f, 5.0f, -10.0f, 1.0f), Vector4(0.0f, 2.0f, 100.0f, 1.0f));
+
+	Frustum viewFrustum;
+	viewFrustum.buildPerspective(deg2rad(70.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+
+	AlignedVector< LightClusterPass::TileShaderData > tiles(c_clusterCount);
+	AlignedVector< LightClusterPass::LightIndexShaderData > lightIndices(LightClusterPass::c_maxLightIndexCount);
+	AlignedVector< AlignedVector< int32_t > > referenceClusters;
+
+	Ref< LightClusterPass > lightClusterPass = new LightClusterPass(WorldRenderSettings());
+	Random rnd(1234);
+
+	const int32_t lightCounts[] = { 16, 256, 4096 };
+	for (const int32_t lightCount : lightCounts)
+	{
+		RefArray< Entity > entities;
+		AlignedVector< const LightComponent* > lights;
+		createLights(lightCount, rnd, entities, lights);
+
+		// Compare result against brute force reference.
+		Timer timer;
+		referenceBin(view, viewFrustum, lights, referenceClusters);
+		const double referenceDuration = timer.getElapsedTime();
+
+		const uint32_t written = lightClusterPass->bin(view, viewFrustum, lights, tiles.ptr(), lightIndices.ptr(), LightClusterPass::c_maxLightIndexCount);
+
+		bool same = true;
+		uint32_t expected = 0;
+		for (int32_t i = 0; i < c_clusterCount; ++i)
+		{
+			const auto& cluster = referenceClusters[i];
+			const int32_t offset = tiles[i].lightOffsetAndCount[0];
+			const int32_t count = tiles[i].lightOffsetAndCount[1];
+
+			same &= (count == (int32_t)cluster.size());
+			for (int32_t j = 0; same && j < count; ++j)
+				same &= (lightIndices[offset + j].lightIndex[0] == cluster[j]);
+
+			expected += (uint32_t)cluster.size();
+		}
+		CASE_ASSERT(same);
+		CASE_ASSERT_EQUAL(written, expected);
+
+		// Benchmark binning.
+		timer.reset();
+		for (int32_t i = 0; i < c_benchmarkIterations; ++i)
+			lightClusterPass->bin(view, viewFrustum, lights, tiles.ptr(), lightIndices.ptr(), LightClusterPass::c_maxLightIndexCount);
+		const double binDuration = timer.getElapsedTime() / c_benchmarkIterations;
+
+		log::info << L"Light cluster, " << lightCount << L" lights, " << written << L" indices; bin " << int32_t(binDuration * 1000000.0) << L" us, brute force " << int32_t(referenceDuration * 1000000.0) << L" us" << Endl;
+
+		// Light indices beyond capacity should be dropped but clusters still be valid.
+		const uint32_t capacity = expected / 2;
+		const uint32_t truncated = lightClusterPass->bin(view, viewFrustum, lights, tiles.ptr(), lightIndices.ptr(), capacity);
+		CASE_ASSERT_EQUAL(truncated, capacity);
+
+		bool valid = true;
+		for (int32_t i = 0; i < c_clusterCount; ++i)
+		{
+			const uint32_t offset = (uint32_t)tiles[i].lightOffsetAndCount[0];
+			const uint32_t count = (uint32_t)tiles[i].lightOffsetAndCount[1];
+			valid &= (offset + count <= capacity);
+			for (uint32_t j = 0; valid && j < count; ++j)
+				valid &= (lightIndices[offset + j].lightIndex[0] == referenceClusters[i][j]);
+		}
+		CASE_ASSERT(valid);
+	}
+}
+
+}
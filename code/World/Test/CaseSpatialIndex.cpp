@@ -0,0 +1,254 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include "Core/Containers/HashMap.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/Const.h"
+#include "Core/Math/Matrix44.h"
+#include "Core/Math/Random.h"
+#include "Core/Timer/Timer.h"
+#include "World/Entity.h"
+#include "World/SpatialIndex.h"
+#include "World/Test/CaseSpatialIndex.h"
+
+namespace traktor::world::test
+{
+	namespace
+	{
+
+const float c_worldExtent = 4000.0f;
+const int32_t c_queryCount = 200;
+const int32_t c_frameCount = 10;
+
+struct SyntheticEntity
+{
+	Ref< Entity > entity;
+	Aabb3 bounds;
+	int32_t proxy = -1;
+	bool removed = false;
+};
+
+Aabb3 randomBounds(Random& rnd)
+{
+	const Vector4 center(
+		(rnd.nextFloat() - 0.5f) * c_worldExtent,
+		rnd.nextFloat() * 50.0f,
+		(rnd.nextFloat() - 0.5f) * c_worldExtent,
+		1.0f
+	);
+	const Vector4 extent(
+		0.5f + rnd.nextFloat() * 4.0f,
+		0.5f + rnd.nextFloat() * 4.0f,
+		0.5f + rnd.nextFloat() * 4.0f,
+		0.0f
+	);
+	return Aabb3(center - extent, center + extent);
+}
+
+bool overlapExact(const Aabb3& a, const Aabb3& b)
+{
+	return
+		a.mn.x() <= b.mx.x() && b.mn.x() <= a.mx.x() &&
+		a.mn.y() <= b.mx.y() && b.mn.y() <= a.mx.y() &&
+		a.mn.z() <= b.mx.z() && b.mn.z() <= a.mx.z();
+}
+
+Frustum createFrustum(const Vector4& eyePosition, const Vector4& target)
+{
+	const Matrix44 viewInv = lookAt(eyePosition, target).inverse();
+
+	Frustum frustum;
+	frustum.buildPerspective(deg2rad(70.0f), 16.0f / 9.0f, 0.1f, 800.0f);
+	for (uint32_t i = 0; i < frustum.planes.size(); ++i)
+		frustum.planes[i] = viewInv * frustum.planes[i];
+	return frustum;
+}
+
+/*! Compare result of all queries using spatial index against linear scans. */
+bool verifyQueries(
+	const SpatialIndex& index,
+	const AlignedVector< SyntheticEntity >& entities,
+	const HashMap< const Entity*, int32_t >& entityIndices,
+	const AlignedVector< Aabb3 >& queryBounds,
+	const AlignedVector< Frustum >& queryFrustums,
+	double outIndexDuration[2],
+	double outLinearDuration[2],
+	int32_t& outFrustumHits
+)
+{
+	AlignedVector< Entity* > indexResult;
+	AlignedVector< Entity* > linearResult;
+	bool same = true;
+
+	outIndexDuration[0] = outIndexDuration[1] = 0.0;
+	outLinearDuration[0] = outLinearDuration[1] = 0.0;
+	outFrustumHits = 0;
+
+	const auto boundsOf = [&](const Entity* entity) -> const Aabb3& {
+		return entities[*entityIndices.find(entity)].bounds;
+	};
+
+	Timer timer;
+	for (const auto& bounds : queryBounds)
+	{
+		indexResult.resize(0);
+		linearResult.resize(0);
+
+		timer.reset();
+		index.query(bounds, [&](Entity* entity) {
+			indexResult.push_back(entity);
+		});
+		outIndexDuration[0] += timer.getElapsedTime();
+
+		// Index is conservative; remove entities which only overlap enlarged bounds.
+		indexResult.erase(std::remove_if(indexResult.begin(), indexResult.end(), [&](const Entity* entity) {
+			return !overlapExact(boundsOf(entity), bounds);
+		}), indexResult.end());
+
+		timer.reset();
+		for (const auto& entity : entities)
+		{
+			if (!entity.removed && overlapExact(entity.bounds, bounds))
+				linearResult.push_back(entity.entity);
+		}
+		outLinearDuration[0] += timer.getElapsedTime();
+
+		std::sort(indexResult.begin(), indexResult.end());
+		std::sort(linearResult.begin(), linearResult.end());
+		same &= (indexResult == linearResult);
+	}
+
+	for (const auto& frustum : queryFrustums)
+	{
+		indexResult.resize(0);
+		linearResult.resize(0);
+
+		timer.reset();
+		index.query(frustum, [&](Entity* entity) {
+			indexResult.push_back(entity);
+		});
+		outIndexDuration[1] += timer.getElapsedTime();
+
+		indexResult.erase(std::remove_if(indexResult.begin(), indexResult.end(), [&](const Entity* entity) {
+			return frustum.inside(boundsOf(entity)) == Frustum::Result::Outside;
+		}), indexResult.end());
+		outFrustumHits += (int32_t)indexResult.size();
+
+		timer.reset();
+		for (const auto& entity : entities)
+		{
+			if (!entity.removed && frustum.inside(entity.bounds) != Frustum::Result::Outside)
+				linearResult.push_back(entity.entity);
+		}
+		outLinearDuration[1] += timer.getElapsedTime();
+
+		std::sort(indexResult.begin(), indexResult.end());
+		std::sort(linearResult.begin(), linearResult.end());
+		same &= (indexResult == linearResult);
+	}
+
+	return same;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.world.test.CaseSpatialIndex", 0, CaseSpatialIndex, traktor::test::Case)
+
+void CaseSpatialIndex::run()
+{
+	const int32_t entityCounts[] = { 10000, 100000 };
+	for (const int32_t entityCount : entityCounts)
+	{
+		Random rnd(entityCount);
+
+		// Create synthetic world.
+		AlignedVector< SyntheticEntity > entities;
+		HashMap< const Entity*, int32_t > entityIndices;
+		entities.resize(entityCount);
+		for (int32_t i = 0; i < entityCount; ++i)
+		{
+			entities[i].entity = new Entity(Guid(), L"", Transform::identity());
+			entities[i].bounds = randomBounds(rnd);
+			entityIndices.insert(entities[i].entity, i);
+		}
+
+		SpatialIndex index;
+
+		Timer timer;
+		for (auto& entity : entities)
+			entity.proxy = index.insert(entity.bounds, entity.entity);
+		const double insertDuration = timer.getElapsedTime();
+
+		// Random range and frustum queries.
+		AlignedVector< Aabb3 > queryBounds;
+		AlignedVector< Frustum > queryFrustums;
+		for (int32_t i = 0; i < c_queryCount; ++i)
+		{
+			const Aabb3 b = randomBounds(rnd);
+			queryBounds.push_back(b.expand(50.0_simd));
+
+			const Vector4 eyePosition = b.getCenter() + Vector4(0.0f, 20.0f, 0.0f, 0.0f);
+			const Vector4 target = eyePosition + Vector4(rnd.nextFloat() - 0.5f, -0.1f, rnd.nextFloat() - 0.5f, 0.0f);
+			queryFrustums.push_back(createFrustum(eyePosition, target));
+		}
+
+		double indexDuration[2], linearDuration[2];
+		int32_t frustumHits;
+		CASE_ASSERT(verifyQueries(index, entities, entityIndices, queryBounds, queryFrustums, indexDuration, linearDuration, frustumHits));
+
+		log::info << L"Spatial index, " << entityCount << L" entities, height " << index.getHeight() << L"; insert " << int32_t(insertDuration * 1000.0) << L" ms" << Endl;
+		log::info << L"\t" << c_queryCount << L" range queries; index " << int32_t(indexDuration[0] * 1000.0) << L" ms, linear " << int32_t(linearDuration[0] * 1000.0) << L" ms" << Endl;
+		log::info << L"\t" << c_queryCount << L" frustum queries, " << frustumHits / c_queryCount << L" visible on average; index " << int32_t(indexDuration[1] * 1000.0) << L" ms, linear " << int32_t(linearDuration[1] * 1000.0) << L" ms" << Endl;
+
+		// Simulate frames where some entities move slightly and a few teleport.
+		int32_t reinserted = 0;
+		timer.reset();
+		for (int32_t frame = 0; frame < c_frameCount; ++frame)
+		{
+			for (int32_t i = 0; i < entityCount / 10; ++i)
+			{
+				SyntheticEntity& entity = entities[rnd.next() % entityCount];
+				if ((i % 100) == 0)
+					entity.bounds = randomBounds(rnd);
+				else
+				{
+					const Vector4 offset((rnd.nextFloat() - 0.5f) * 0.5f, 0.0f, (rnd.nextFloat() - 0.5f) * 0.5f, 0.0f);
+					entity.bounds = Aabb3(entity.bounds.mn + offset, entity.bounds.mx + offset);
+				}
+				if (index.update(entity.proxy, entity.bounds))
+					++reinserted;
+			}
+		}
+		const double updateDuration = timer.getElapsedTime() / c_frameCount;
+
+		CASE_ASSERT(verifyQueries(index, entities, entityIndices, queryBounds, queryFrustums, indexDuration, linearDuration, frustumHits));
+
+		log::info << L"Spatial index, " << entityCount / 10 << L" moves per frame; update " << int32_t(updateDuration * 1000000.0) << L" us, " << reinserted << L" of " << c_frameCount * (entityCount / 10) << L" re-inserted" << Endl;
+
+		// Remove every other entity.
+		for (int32_t i = 0; i < entityCount; i += 2)
+		{
+			index.remove(entities[i].proxy);
+			entities[i].removed = true;
+		}
+
+		CASE_ASSERT(verifyQueries(index, entities, entityIndices, queryBounds, queryFrustums, indexDuration, linearDuration, frustumHits));
+
+		// Re-insert removed entities; free nodes should be reused.
+		for (int32_t i = 0; i < entityCount; i += 2)
+		{
+			entities[i].proxy = index.insert(entities[i].bounds, entities[i].entity);
+			entities[i].removed = false;
+		}
+
+		CASE_ASSERT(verifyQueries(index, entities, entityIndices, queryBounds, queryFrustums, indexDuration, linearDuration, frustumHits));
+	}
+}
+
+}
@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include "Render/IRenderSystem.h"
 #include "World/Entity.h"
 #include "World/IWorldComponent.h"
@@ -17,6 +18,21 @@
 
 namespace traktor::world
 {
+	namespace
+	{
+
+/*! Calculate world space bounds of entity, always include entity's origin. */
+Aabb3 calculateWorldBounds(const Entity* entity)
+{
+	const Transform transform = entity->getTransform();
+	Aabb3 bounds = entity->getBoundingBox();
+	if (!bounds.empty())
+		bounds = bounds.transform(transform);
+	bounds.contain(transform.translation().xyz1());
+	return bounds;
+}
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.world.World", World, Object)
 
@@ -36,10 +52,16 @@ void World::destroy()
 
 	for (auto entity : m_entities)
 	{
+		entity->m_spatialProxy = -1;
+		entity->m_spatialDirty = false;
 		entity->setWorld(nullptr);
 		entity->destroy();
 	}
 	m_entities.clear();
+	m_entitiesById.clear();
+	m_entitiesByName.clear();
+	m_spatialIndex.clear();
+	m_dirtyEntities.clear();
 
 	for (auto component : m_components)
 		component->destroy();
@@ -80,7 +102,10 @@ void World::addEntity(Entity* entity)
 	if (m_update)
 		m_deferredAdd.push_back(entity);
 	else
+	{
 		m_entities.push_back(entity);
+		indexEntity(entity);
+	}
 	entity->setWorld(this);
 }
 
@@ -96,20 +121,24 @@ void World::removeEntity(Entity* entity)
 	{
 		const bool removed = m_entities.remove(entity);
 		T_FATAL_ASSERT(removed);
+		unindexEntity(entity);
 	}
 	entity->setWorld(nullptr);
 }
 
 bool World::haveEntity(const Entity* entity) const
 {
-	if (entity->getWorld() == this)
-		return std::find(m_entities.begin(), m_entities.end(), entity) != m_entities.end();
-	else
-		return false;
+	return entity->getWorld() == this && entity->m_spatialProxy >= 0;
 }
 
 Entity* World::getEntity(const Guid& id) const
 {
+	if (id.isNotNull())
+	{
+		const auto entities = m_entitiesById.find(id);
+		return entities != nullptr ? entities->front() : nullptr;
+	}
+
 	for (auto entity : m_entities)
 	{
 		if (entity->getId() == id)
@@ -120,6 +149,17 @@ Entity* World::getEntity(const Guid& id) const
 
 Entity* World::getEntity(const std::wstring& name, int32_t index) const
 {
+	if (!name.empty())
+	{
+		const auto entities = m_entitiesByName.find(name);
+		if (entities != nullptr && index >= 0 && index < (int32_t)entities->size())
+			return (*entities)[index];
+		else if (entities != nullptr && index < 0)
+			return entities->front();
+		else
+			return nullptr;
+	}
+
 	for (auto entity : m_entities)
 	{
 		if (entity->getName() == name)
@@ -134,6 +174,17 @@ Entity* World::getEntity(const std::wstring& name, int32_t index) const
 RefArray< Entity > World::getEntities(const std::wstring& name) const
 {
 	RefArray< Entity > entities;
+	if (!name.empty())
+	{
+		const auto namedEntities = m_entitiesByName.find(name);
+		if (namedEntities != nullptr)
+		{
+			for (auto entity : *namedEntities)
+				entities.push_back(entity);
+		}
+		return entities;
+	}
+
 	for (auto entity : m_entities)
 	{
 		if (entity->getName() == name)
@@ -145,12 +196,30 @@ RefArray< Entity > World::getEntities(const std::wstring& name) const
 RefArray< Entity > World::getEntitiesWithinRange(const Vector4& position, float range) const
 {
 	RefArray< Entity > entities;
-	for (auto entity : m_entities)
-	{
+	const Aabb3 bounds(position.xyz1() - Vector4(range, range, range, 0.0f), position.xyz1() + Vector4(range, range, range, 0.0f));
+	queryEntities(bounds, [&](Entity* entity) {
 		const Scalar distance = (entity->getTransform().translation() - position).xyz0().length();
 		if (distance <= range)
 			entities.push_back(entity);
-	}
+	});
+	return entities;
+}
+
+RefArray< Entity > World::getEntitiesWithinBounds(const Aabb3& bounds) const
+{
+	RefArray< Entity > entities;
+	queryEntities(bounds, [&](Entity* entity) {
+		entities.push_back(entity);
+	});
+	return entities;
+}
+
+RefArray< Entity > World::getEntitiesWithinFrustum(const Frustum& frustum) const
+{
+	RefArray< Entity > entities;
+	queryEntities(frustum, [&](Entity* entity) {
+		entities.push_back(entity);
+	});
 	return entities;
 }
 
@@ -173,6 +242,8 @@ void World::update(const UpdateParams& update)
 	if (!m_deferredAdd.empty())
 	{
 		m_entities.insert(m_entities.end(), m_deferredAdd.begin(), m_deferredAdd.end());
+		for (auto entity : m_deferredAdd)
+			indexEntity(entity);
 		m_deferredAdd.resize(0);
 	}
 
@@ -183,9 +254,69 @@ void World::update(const UpdateParams& update)
 		{
 			const bool removed = m_entities.remove(entity);
 			T_FATAL_ASSERT(removed);
+
+			// Entity might have been added again during update.
+			if (entity->getWorld() != this)
+				unindexEntity(entity);
 		}
 		m_deferredRemove.resize(0);
 	}
 }
 
+void World::indexEntity(Entity* entity)
+{
+	if (entity->m_spatialProxy >= 0)
+		return;
+
+	entity->m_spatialProxy = m_spatialIndex.insert(calculateWorldBounds(entity), entity);
+	entity->m_spatialDirty = false;
+
+	if (entity->getId().isNotNull())
+		m_entitiesById[entity->getId()].push_back(entity);
+	if (!entity->getName().empty())
+		m_entitiesByName[entity->getName()].push_back(entity);
+}
+
+void World::unindexEntity(Entity* entity)
+{
+	if (entity->m_spatialProxy < 0)
+		return;
+
+	m_spatialIndex.remove(entity->m_spatialProxy);
+	entity->m_spatialProxy = -1;
+	entity->m_spatialDirty = false;
+
+	if (entity->getId().isNotNull())
+	{
+		auto entities = m_entitiesById.find(entity->getId());
+		T_FATAL_ASSERT(entities != nullptr);
+		entities->erase(std::find(entities->begin(), entities->end(), entity));
+		if (entities->empty())
+			m_entitiesById.remove(entity->getId());
+	}
+
+	if (!entity->getName().empty())
+	{
+		auto entities = m_entitiesByName.find(entity->getName());
+		T_FATAL_ASSERT(entities != nullptr);
+		entities->erase(std::find(entities->begin(), entities->end(), entity));
+		if (entities->empty())
+			m_entitiesByName.remove(entity->getName());
+	}
+}
+
+void World::flushSpatialIndex() const
+{
+	for (auto entity : m_dirtyEntities)
+	{
+		if (!entity->m_spatialDirty)
+			continue;
+
+		entity->m_spatialDirty = false;
+		if (entity->m_spatialProxy >= 0)
+			m_spatialIndex.update(entity->m_spatialProxy, calculateWorldBounds(entity));
+	}
+	m_dirtyEntities.resize(0);
+}
+
 }
@@ -8,10 +8,16 @@
  */
 #pragma once
 
+#include <string>
 #include "Core/Guid.h"
 #include "Core/Object.h"
 #include "Core/RefArray.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Math/Aabb3.h"
+#include "Core/Math/Frustum.h"
 #include "Core/Math/Vector4.h"
+#include "World/SpatialIndex.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -46,6 +52,11 @@ struct UpdateParams;
  * 
  * The world is a container of all entities representing a world.
  * 
+ * Entities are kept in a spatial index, bounds of an entity
+ * is refreshed when it's transform or components are modified.
+ * Bounds which change by other means, such as animation, are
+ * only tracked within the enlarged bounds of the index.
+ * 
  * \ingroup World
  */
 class T_DLLCLASS World : public Object
@@ -111,6 +122,28 @@ public:
 	/*! Get all entities within distance. */
 	RefArray< Entity > getEntitiesWithinRange(const Vector4& position, float range) const;
 
+	/*! Get all entities which bounds overlap given bounds. */
+	RefArray< Entity > getEntitiesWithinBounds(const Aabb3& bounds) const;
+
+	/*! Get all entities which bounds intersect given frustum. */
+	RefArray< Entity > getEntitiesWithinFrustum(const Frustum& frustum) const;
+
+	/*! Visit all entities which bounds overlap given bounds. */
+	template < typename VisitorType >
+	void queryEntities(const Aabb3& bounds, VisitorType&& visitor) const
+	{
+		flushSpatialIndex();
+		m_spatialIndex.query(bounds, visitor);
+	}
+
+	/*! Visit all entities which bounds intersect given frustum. */
+	template < typename VisitorType >
+	void queryEntities(const Frustum& frustum, VisitorType&& visitor) const
+	{
+		flushSpatialIndex();
+		m_spatialIndex.query(frustum, visitor);
+	}
+
 	/*! Update all entities in this world. */
 	void update(const UpdateParams& update);
 
@@ -118,11 +151,23 @@ public:
 	const RefArray< Entity >& getEntities() const { return m_entities; }
 
 private:
+	friend class Entity;
+
 	RefArray< IWorldComponent > m_components;
 	RefArray< Entity > m_entities;
 	RefArray< Entity > m_deferredAdd;
 	RefArray< Entity > m_deferredRemove;
+	HashMap< Guid, AlignedVector< Entity* > > m_entitiesById;
+	HashMap< std::wstring, AlignedVector< Entity* > > m_entitiesByName;
+	mutable SpatialIndex m_spatialIndex;
+	mutable RefArray< Entity > m_dirtyEntities;
 	bool m_update = false;
+
+	void indexEntity(Entity* entity);
+
+	void unindexEntity(Entity* entity);
+
+	void flushSpatialIndex() const;
 };
 
 }
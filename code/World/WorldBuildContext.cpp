@@ -6,12 +6,23 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
+#include "Core/Containers/StaticVector.h"
+#include "Core/Thread/JobManager.h"
+#include "Render/Context/RenderContext.h"
 #include "World/IEntityRenderer.h"
 #include "World/WorldBuildContext.h"
 #include "World/WorldEntityRenderers.h"
 
 namespace traktor::world
 {
+	namespace
+	{
+
+const uint32_t c_buildChunkSize = 256;
+const uint32_t c_maxBuildTasks = 16;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.world.WorldBuildContext", WorldBuildContext, Object)
 
@@ -21,4 +32,62 @@ WorldBuildContext::WorldBuildContext(const WorldEntityRenderers* entityRenderers
 {
 }
 
+void WorldBuildContext::build(
+	const WorldRenderView& worldRenderView,
+	const IWorldRenderPass& worldRenderPass,
+	const AlignedVector< GatherView::Renderable >& renderables,
+	const std::function< bool (const GatherView::Renderable&) >& filter
+) const
+{
+	uint32_t concurrentCount = 0;
+	for (const auto& r : renderables)
+	{
+		if (r.renderer->isBuildConcurrent())
+			concurrentCount++;
+	}
+
+	// Not worth the overhead if only a few renderables can be built concurrently.
+	const uint32_t ntasks = std::min(concurrentCount / c_buildChunkSize, c_maxBuildTasks);
+	if (ntasks <= 1)
+	{
+		for (const auto& r : renderables)
+		{
+			if (!filter || filter(r))
+				r.renderer->build(*this, worldRenderView, worldRenderPass, r.renderable);
+		}
+		return;
+	}
+
+	// Build renderables which cannot be built concurrently first.
+	for (const auto& r : renderables)
+	{
+		if (!r.renderer->isBuildConcurrent() && (!filter || filter(r)))
+			r.renderer->build(*this, worldRenderView, worldRenderPass, r.renderable);
+	}
+
+	// Build remaining renderables in parallel, each task into it's own child context.
+	const uint32_t count = (uint32_t)renderables.size();
+	const uint32_t chunkSize = (count + ntasks - 1) / ntasks;
+
+	StaticVector< Job::task_t, c_maxBuildTasks > tasks;
+	for (uint32_t i = 0; i < ntasks; ++i)
+	{
+		render::RenderContext* childRenderContext = m_renderContext->acquireChild();
+		tasks.push_back([&, i, childRenderContext]() {
+			const WorldBuildContext childContext(m_entityRenderers, childRenderContext);
+			const uint32_t from = i * chunkSize;
+			const uint32_t to = std::min(from + chunkSize, count);
+			for (uint32_t j = from; j < to; ++j)
+			{
+				const auto& r = renderables[j];
+				if (r.renderer->isBuildConcurrent() && (!filter || filter(r)))
+					r.renderer->build(childContext, worldRenderView, worldRenderPass, r.renderable);
+			}
+		});
+	}
+	JobManager::getInstance().fork(tasks.c_ptr(), tasks.size());
+
+	m_renderContext->mergeChildren();
+}
+
 }
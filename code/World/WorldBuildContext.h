@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <functional>
 #include "Core/Object.h"
 #include "World/WorldTypes.h"
 
@@ -29,7 +30,9 @@ class RenderContext;
 namespace traktor::world
 {
 
+class IWorldRenderPass;
 class WorldEntityRenderers;
+class WorldRenderView;
 
 /*! World build context.
  * \ingroup World
@@ -45,6 +48,24 @@ public:
 
 	render::RenderContext* getRenderContext() const { return m_renderContext; }
 
+	/*! Build gathered renderables.
+	 *
+	 * Renderables of entity renderers which support concurrent
+	 * build are built in parallel into child render contexts,
+	 * which are merged back into our render context when done.
+	 *
+	 * \param worldRenderView World render view.
+	 * \param worldRenderPass World render pass.
+	 * \param renderables Gathered renderables.
+	 * \param filter Optional filter, return false to skip renderable.
+	 */
+	void build(
+		const WorldRenderView& worldRenderView,
+		const IWorldRenderPass& worldRenderPass,
+		const AlignedVector< GatherView::Renderable >& renderables,
+		const std::function< bool (const GatherView::Renderable&) >& filter = nullptr
+	) const;
+
 private:
 	const WorldEntityRenderers* m_entityRenderers;
 	render::RenderContext* m_renderContext;
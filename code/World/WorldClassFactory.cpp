@@ -9,6 +9,7 @@
 #include "Core/Class/AutoRuntimeClass.h"
 #include "Core/Class/Boxes/BoxedAabb3.h"
 #include "Core/Class/Boxes/BoxedColor4f.h"
+#include "Core/Class/Boxes/BoxedFrustum.h"
 #include "Core/Class/Boxes/BoxedGuid.h"
 #include "Core/Class/Boxes/BoxedRefArray.h"
 #include "Core/Class/Boxes/BoxedTypeInfo.h"
@@ -193,6 +194,8 @@ void WorldClassFactory::createClasses(IRuntimeClassRegistrar* registrar) const
 	classWorld->addMethod("getEntities", &World_getEntities_1);
 	classWorld->addMethod("getEntities", &World_getEntities_2);
 	classWorld->addMethod("getEntitiesWithinRange", &World::getEntitiesWithinRange);
+	classWorld->addMethod("getEntitiesWithinBounds", &World::getEntitiesWithinBounds);
+	classWorld->addMethod("getEntitiesWithinFrustum", &World::getEntitiesWithinFrustum);
 	registrar->registerClass(classWorld);
 
 	auto classIEntityEventInstance = new AutoRuntimeClass< IEntityEventInstance >();
@@ -77,6 +77,7 @@ void WorldEntityRenderers::add(IEntityRenderer* entityRenderer)
 {
 	m_entityRenderers.push_back(entityRenderer);
 	updateEntityRendererMap(m_entityRenderers, m_entityRendererMap);
+	++m_generation;
 }
 
 void WorldEntityRenderers::remove(IEntityRenderer* entityRenderer)
@@ -85,6 +86,7 @@ void WorldEntityRenderers::remove(IEntityRenderer* entityRenderer)
 	T_ASSERT_M(i != m_entityRenderers.end(), L"No such entity renderer");
 	m_entityRenderers.erase(i);
 	updateEntityRendererMap(m_entityRenderers, m_entityRendererMap);
+	++m_generation;
 }
 
 }
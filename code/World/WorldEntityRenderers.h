@@ -46,9 +46,13 @@ public:
 
 	const RefArray< IEntityRenderer >& get() const { return m_entityRenderers; }
 
+	/*! Get generation, incremented each time set of renderers is modified. */
+	uint32_t getGeneration() const { return m_generation; }
+
 private:
 	RefArray< IEntityRenderer > m_entityRenderers;
 	entity_renderer_map_t m_entityRendererMap;
+	uint32_t m_generation = 0;
 };
 
 }
@@ -24,7 +24,7 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.xml.Document", Document, Object)
 
 bool Document::loadFromFile(const Path& fileName)
 {
-	Ref< IStream > file = FileSystem::getInstance().open(fileName, File::FmRead);
+	Ref< IStream > file = FileSystem::getInstance().open(fileName, File::FmRead | File::FmMapped);
 	bool result = false;
 
 	if (file != nullptr)
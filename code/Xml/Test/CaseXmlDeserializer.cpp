@@ -0,0 +1,165 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2025 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/RefArray.h"
+#include "Core/Guid.h"
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Io/MemoryStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/Vector4.h"
+#include "Core/Misc/String.h"
+#include "Core/Serialization/ISerializable.h"
+#include "Core/Serialization/ISerializer.h"
+#include "Core/Serialization/Member.h"
+#include "Core/Serialization/MemberAlignedVector.h"
+#include "Core/Serialization/MemberRef.h"
+#include "Core/Serialization/MemberRefArray.h"
+#include "Core/Timer/Timer.h"
+#include "Xml/XmlDeserializer.h"
+#include "Xml/XmlSerializer.h"
+#include "Xml/Test/CaseXmlDeserializer.h"
+
+namespace traktor::xml::test
+{
+
+class XmlDeserializer_Instance : public ISerializable
+{
+	T_RTTI_CLASS;
+
+public:
+	Guid id;
+	std::wstring name;
+	Vector4 translation = Vector4::zero();
+	float weight = 0.0f;
+	AlignedVector< int32_t > values;
+	Ref< XmlDeserializer_Instance > shared;
+	RefArray< XmlDeserializer_Instance > children;
+
+	virtual void serialize(ISerializer& s) override
+	{
+		s >> Member< Guid >(L"id", id);
+		s >> Member< std::wstring >(L"name", name);
+		s >> Member< Vector4 >(L"translation", translation);
+		s >> Member< float >(L"weight", weight);
+		s >> MemberAlignedVector< int32_t >(L"values", values);
+		s >> MemberRef< XmlDeserializer_Instance >(L"shared", shared);
+		s >> MemberRefArray< XmlDeserializer_Instance >(L"children", children);
+	}
+};
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.xml.test.CaseXmlDeserializer.XmlDeserializer_Instance", 0, XmlDeserializer_Instance, ISerializable)
+
+	namespace
+	{
+
+const int32_t c_instanceCount = 75000;
+
+/*! Create a tree of instances, each level referencing a shared instance. */
+Ref< XmlDeserializer_Instance > createTree(int32_t instanceCount)
+{
+	Ref< XmlDeserializer_Instance > shared = new XmlDeserializer_Instance();
+	shared->name = L"Shared åäö €";
+
+	Ref< XmlDeserializer_Instance > root = new XmlDeserializer_Instance();
+	root->id = Guid::create();
+	root->name = L"Root";
+	root->children.push_back(shared);
+
+	XmlDeserializer_Instance* parent = root;
+	for (int32_t i = 0; i < instanceCount; ++i)
+	{
+		Ref< XmlDeserializer_Instance > instance = new XmlDeserializer_Instance();
+		instance->id = Guid::create();
+		instance->name = L"Instance_" + toString(i);
+		instance->translation = Vector4(float(i), 1.0f, 2.0f, 1.0f);
+		instance->weight = float(i) * 0.5f;
+		for (int32_t j = 0; j < 4; ++j)
+			instance->values.push_back(i + j);
+		instance->shared = shared;
+		parent->children.push_back(instance);
+
+		// Nest a few levels to exercise recursion.
+		if ((i % 1000) == 999)
+			parent = instance;
+	}
+	return root;
+}
+
+int32_t countInstances(const XmlDeserializer_Instance* instance)
+{
+	int32_t count = 1;
+	for (auto child : instance->children)
+		count += countInstances(child);
+	return count;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.xml.test.CaseXmlDeserializer", 0, CaseXmlDeserializer, traktor::test::Case)
+
+void CaseXmlDeserializer::run()
+{
+	// Round trip, verify values and references.
+	{
+		Ref< XmlDeserializer_Instance > tree = createTree(10);
+
+		DynamicMemoryStream wms(false, true);
+		CASE_ASSERT(XmlSerializer(&wms).writeObject(tree));
+
+		const AlignedVector< uint8_t >& buffer = wms.getBuffer();
+		MemoryStream rms(buffer.c_ptr(), buffer.size());
+		Ref< XmlDeserializer_Instance > readTree = XmlDeserializer(&rms).readObject< XmlDeserializer_Instance >();
+
+		CASE_ASSERT_NOT_EQUAL(readTree, nullptr);
+		if (!readTree)
+			return;
+
+		CASE_ASSERT_EQUAL(readTree->name, tree->name);
+		CASE_ASSERT_EQUAL(readTree->children.size(), tree->children.size());
+		if (readTree->children.size() != tree->children.size())
+			return;
+
+		const XmlDeserializer_Instance* readShared = readTree->children[0];
+		CASE_ASSERT_EQUAL(readShared->name, tree->children[0]->name);
+
+		for (size_t i = 1; i < tree->children.size(); ++i)
+		{
+			const XmlDeserializer_Instance* instance = tree->children[i];
+			const XmlDeserializer_Instance* readInstance = readTree->children[i];
+			CASE_ASSERT(readInstance->id == instance->id);
+			CASE_ASSERT_EQUAL(readInstance->name, instance->name);
+			CASE_ASSERT(readInstance->translation == instance->translation);
+			CASE_ASSERT_EQUAL(readInstance->weight, instance->weight);
+			CASE_ASSERT_EQUAL(readInstance->values.size(), instance->values.size());
+			CASE_ASSERT(readInstance->shared == readShared);
+		}
+	}
+
+	// Measure read of large instance tree.
+	{
+		Ref< XmlDeserializer_Instance > tree = createTree(c_instanceCount);
+
+		DynamicMemoryStream wms(false, true);
+		CASE_ASSERT(XmlSerializer(&wms).writeObject(tree));
+
+		const AlignedVector< uint8_t >& buffer = wms.getBuffer();
+		const int32_t instanceCount = countInstances(tree);
+
+		Timer timer;
+		const double start = timer.getElapsedTime();
+		MemoryStream rms(buffer.c_ptr(), buffer.size());
+		Ref< XmlDeserializer_Instance > readTree = XmlDeserializer(&rms).readObject< XmlDeserializer_Instance >();
+		const double readTime = timer.getElapsedTime() - start;
+
+		CASE_ASSERT(readTree && countInstances(readTree) == instanceCount);
+
+		log::info << L"Xml read, " << instanceCount << L" object(s), " << (int32_t)(buffer.size() / (1024 * 1024)) << L" MiB; " << readTime * 1000.0 << L" ms, " << (int32_t)(buffer.size() / (readTime * 1024 * 1024)) << L" MiB/s" << Endl;
+	}
+}
+
+}
@@ -11,7 +11,7 @@
 #include "Core/Guid.h"
 #include "Core/Io/IStream.h"
 #include "Core/Io/Path.h"
-#include "Core/Io/StringOutputStream.h"
+#include "Core/Io/Utf8Encoding.h"
 #include "Core/Log/Log.h"
 #include "Core/Math/Color4ub.h"
 #include "Core/Math/Color4f.h"
@@ -23,6 +23,7 @@
 #include "Core/Misc/Split.h"
 #include "Core/Misc/String.h"
 #include "Core/Misc/StringSplit.h"
+#include "Core/Misc/TString.h"
 #include "Core/Serialization/ISerializable.h"
 #include "Core/Serialization/MemberArray.h"
 #include "Core/Serialization/MemberComplex.h"
@@ -34,9 +35,9 @@ namespace traktor::xml
 	{
 
 inline
-XmlPullParser::Attributes::const_iterator findAttribute(const XmlPullParser::Attributes& attr, const std::wstring& name)
+XmlPullParser::AttributeViews::const_iterator findAttribute(const XmlPullParser::AttributeViews& attr, const std::string_view& name)
 {
-	for (XmlPullParser::Attributes::const_iterator i = attr.begin(); i != attr.end(); ++i)
+	for (XmlPullParser::AttributeViews::const_iterator i = attr.begin(); i != attr.end(); ++i)
 	{
 		if (i->first == name)
 			return i;
@@ -44,6 +45,35 @@ XmlPullParser::Attributes::const_iterator findAttribute(const XmlPullParser::Att
 	return attr.end();
 }
 
+/*! Decode UTF-8 into wide string, reusing string's storage. */
+void decodeUtf8(const std::string_view& utf8, std::wstring& outString)
+{
+	outString.resize(utf8.size());
+
+	const uint8_t* u8str = (const uint8_t*)utf8.data();
+	const uint32_t u8len = (uint32_t)utf8.size();
+	uint32_t length = 0;
+
+	const Utf8Encoding utf8enc;
+	for (uint32_t i = 0; i < u8len; )
+	{
+		if (u8str[i] < 0x80)
+		{
+			outString[length++] = (wchar_t)u8str[i++];
+			continue;
+		}
+
+		wchar_t ch;
+		const int n = utf8enc.translate(u8str + i, u8len - i, ch);
+		if (n <= 0)
+			break;
+		outString[length++] = ch;
+		i += n;
+	}
+
+	outString.resize(length);
+}
+
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.xml.XmlDeserializer", XmlDeserializer, Serializer)
@@ -287,20 +317,20 @@ void XmlDeserializer::operator >> (const Member< ISerializable* >& m)
 	if (!ensure(enterElement(m.getName())))
 		return;
 
-	const XmlPullParser::Attributes& attr = m_xpp.getEvent().attr;
-	XmlPullParser::Attributes::const_iterator a;
+	const XmlPullParser::AttributeViews& attr = m_xpp.getEventView().attr;
+	XmlPullParser::AttributeViews::const_iterator a;
 
-	if ((a = findAttribute(attr, L"ref")) != attr.end())
+	if ((a = findAttribute(attr, "ref")) != attr.end())
 	{
-		SmallMap< std::wstring, Ref< ISerializable > >::const_iterator i = m_refs.find(a->second);
-		if (!ensure(i != m_refs.end()))
+		const Ref< ISerializable >* ref = m_refs.find(mbstows(a->second));
+		if (!ensure(ref != nullptr))
 			return;
 
-		m = m_refs[a->second];
+		m = *ref;
 	}
-	else if ((a = findAttribute(attr, L"type")) != attr.end())
+	else if ((a = findAttribute(attr, "type")) != attr.end())
 	{
-		const std::wstring typeName = a->second;
+		const std::wstring typeName = mbstows(a->second);
 
 		const TypeInfo* type = TypeInfo::find(typeName.c_str());
 		if (!ensure(type != nullptr))
@@ -312,9 +342,9 @@ void XmlDeserializer::operator >> (const Member< ISerializable* >& m)
 
 		Serializer::dataVersionMap_t dataVersions;
 
-		if ((a = findAttribute(attr, L"version")) != attr.end())
+		if ((a = findAttribute(attr, "version")) != attr.end())
 		{
-			StringSplit< std::wstring > ss(a->second, L",");
+			StringSplit< std::wstring > ss(mbstows(a->second), L",");
 			for (StringSplit< std::wstring >::const_iterator i = ss.begin(); i != ss.end(); ++i)
 			{
 				const std::wstring& s = *i;
@@ -404,18 +434,19 @@ void XmlDeserializer::operator >> (const MemberArray& m)
 	{
 		T_CHECK_STATUS;
 
+		const std::string& name = m_names[m_stack[m_stackPointer - 1].name].utf8;
 		while (m_xpp.next() != XmlPullParser::EventType::EndDocument)
 		{
-			if (m_xpp.getEvent().type == XmlPullParser::EventType::StartElement)
+			if (m_xpp.getEventView().type == XmlPullParser::EventType::StartElement)
 				break;
 			if (
-				m_xpp.getEvent().type == XmlPullParser::EventType::EndElement &&
-				m_xpp.getEvent().value == m.getName()
+				m_xpp.getEventView().type == XmlPullParser::EventType::EndElement &&
+				m_xpp.getEventView().value == name
 			)
 				break;
 		}
 
-		if (m_xpp.getEvent().type != XmlPullParser::EventType::StartElement)
+		if (m_xpp.getEventView().type != XmlPullParser::EventType::StartElement)
 			break;
 
 		m_xpp.push();
@@ -451,36 +482,72 @@ void XmlDeserializer::operator >> (const MemberEnumBase& m)
 	this->operator >> (*(MemberComplex*)(&m));
 }
 
+uint32_t XmlDeserializer::internName(const wchar_t* name)
+{
+	// Member names are usually literals thus first lookup by pointer.
+	const uint32_t* id = m_namePointers.find(name);
+	if (id && m_names[*id].wide == name)
+		return *id;
+
+	const std::wstring wide(name);
+
+	uint32_t nameId;
+	const uint32_t* existingId = m_nameIds.find(wide);
+	if (existingId)
+		nameId = *existingId;
+	else
+	{
+		nameId = (uint32_t)m_names.size();
+
+		Name& n = m_names.push_back();
+		n.wide = wide;
+		n.utf8 = wstombs(Utf8Encoding(), wide);
+
+		m_nameIds.insert(wide, nameId);
+	}
+
+	m_namePointers[name] = nameId;
+	return nameId;
+}
+
 std::wstring XmlDeserializer::stackPath()
 {
-	StringOutputStream ss;
+	std::wstring path;
 	for (uint32_t i = 0; i < m_stackPointer; ++i)
 	{
 		const Entry& e = m_stack[i];
-		ss << L'/' << e.name;
+		path += L'/';
+		path += m_names[e.name].wide;
 		if (e.index > 0)
-			ss << L'[' << e.index << L']';
+		{
+			path += L'[';
+			path += toString(e.index);
+			path += L']';
+		}
 	}
-	return ss.str();
+	return path;
 }
 
-bool XmlDeserializer::enterElement(const std::wstring& name)
+bool XmlDeserializer::enterElement(const wchar_t* name)
 {
-	int32_t index = (m_stackPointer > 0) ? m_stack[m_stackPointer - 1].dups[name]++ : 0;
+	const uint32_t nameId = internName(name);
+	const int32_t index = (m_stackPointer > 0) ? m_stack[m_stackPointer - 1].dups[nameId]++ : 0;
 
 	if (m_stackPointer >= m_stack.size())
 		m_stack.resize(m_stackPointer + 16);
 
 	Entry& e = m_stack[m_stackPointer++];
-	e.name = name;
+	e.name = nameId;
 	e.index = index;
 
+	const std::string& utf8 = m_names[nameId].utf8;
+
 	XmlPullParser::EventType eventType;
 	while ((eventType = m_xpp.next()) != XmlPullParser::EventType::EndDocument)
 	{
 		if (
 			eventType == XmlPullParser::EventType::StartElement &&
-			m_xpp.getEvent().value == name
+			m_xpp.getEventView().value == utf8
 		)
 			return true;
 		else if (eventType == XmlPullParser::EventType::Invalid)
@@ -496,17 +563,19 @@ bool XmlDeserializer::enterElement(const std::wstring& name)
 	return false;
 }
 
-bool XmlDeserializer::leaveElement(const std::wstring& name)
+bool XmlDeserializer::leaveElement(const wchar_t* name)
 {
 	T_ASSERT(m_stackPointer > 0);
-	T_ASSERT(m_stack[m_stackPointer - 1].name == name);
+	T_ASSERT(m_names[m_stack[m_stackPointer - 1].name].wide == name);
+
+	const std::string& utf8 = m_names[m_stack[m_stackPointer - 1].name].utf8;
 	m_stack[--m_stackPointer].dups.reset();
 
 	while (m_xpp.next() != XmlPullParser::EventType::EndDocument)
 	{
 		if (
-			m_xpp.getEvent().type == XmlPullParser::EventType::EndElement &&
-			m_xpp.getEvent().value == name
+			m_xpp.getEventView().type == XmlPullParser::EventType::EndElement &&
+			m_xpp.getEventView().value == utf8
 		)
 			return true;
 	}
@@ -519,18 +588,18 @@ void XmlDeserializer::rememberObject(ISerializable* object)
 	m_refs[stackPath()] = object;
 }
 
-bool XmlDeserializer::nextElementValue(const std::wstring& name, std::wstring& value)
+bool XmlDeserializer::nextElementValue(const wchar_t* name, std::wstring& value)
 {
 	if (!enterElement(name))
 		return false;
 
 	m_xpp.next();
-	if (m_xpp.getEvent().type == XmlPullParser::EventType::Text)
-		value = m_xpp.getEvent().value;
+	if (m_xpp.getEventView().type == XmlPullParser::EventType::Text)
+		decodeUtf8(m_xpp.getEventView().value, value);
 	else
 	{
 		m_xpp.push();
-		value = L"";
+		value.clear();
 	}
 
 	if (!leaveElement(name))
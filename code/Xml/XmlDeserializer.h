@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include "Core/Containers/HashMap.h"
 #include "Core/Containers/SmallMap.h"
 #include "Core/Containers/StaticVector.h"
 #include "Core/Serialization/Serializer.h"
@@ -97,26 +98,38 @@ private:
 
 	struct Entry
 	{
-		std::wstring name;
+		uint32_t name = 0;
 		int32_t index = 0;
-		SmallMap< std::wstring, int32_t > dups;
+		SmallMap< uint32_t, int32_t > dups;
+	};
+
+	/*! Interned member name, UTF-8 encoded name is matched directly with parser's events. */
+	struct Name
+	{
+		std::wstring wide;
+		std::string utf8;
 	};
 
 	AlignedVector< Entry > m_stack;
 	uint32_t m_stackPointer;
-	SmallMap< std::wstring, Ref< ISerializable > > m_refs;
+	AlignedVector< Name > m_names;
+	HashMap< const wchar_t*, uint32_t > m_namePointers;
+	HashMap< std::wstring, uint32_t > m_nameIds;
+	HashMap< std::wstring, Ref< ISerializable > > m_refs;
 	std::wstring m_value;
 	StaticVector< float, 16 > m_values;
 
+	uint32_t internName(const wchar_t* name);
+
 	std::wstring stackPath();
 
-	bool enterElement(const std::wstring& name);
+	bool enterElement(const wchar_t* name);
 
-	bool leaveElement(const std::wstring& name);
+	bool leaveElement(const wchar_t* name);
 
 	void rememberObject(ISerializable* object);
 
-	bool nextElementValue(const std::wstring& name, std::wstring& value);
+	bool nextElementValue(const wchar_t* name, std::wstring& value);
 };
 
 }
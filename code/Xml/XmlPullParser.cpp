@@ -6,8 +6,9 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
-#include <sstream>
+#include <cstring>
 #include "Core/Io/IStream.h"
+#include "Core/Io/MemoryStream.h"
 #include "Core/Io/Utf8Encoding.h"
 #include "Core/Log/Log.h"
 #include "Core/Misc/String.h"
@@ -23,16 +24,22 @@ namespace traktor::xml
 	{
 
 const Utf8Encoding c_utf8enc;
+const int32_t c_streamChunkSize = 64 * 1024;
+const int64_t c_memoryChunkSize = 1024 * 1024;
 
-std::wstring xmltows(const XML_Char* xmlstr, const XML_Char* term)
+std::wstring xmltows(const XML_Char* xmlstr)
 {
-	const size_t len = (size_t)(term - xmlstr);
-	return mbstows(c_utf8enc, std::string_view(xmlstr, len));
+	return mbstows((const char*)xmlstr);
 }
 
-std::wstring xmltows(const XML_Char* xmlstr)
+std::wstring viewtows(const std::string_view& view)
 {
-	return mbstows((const char*)xmlstr);
+	return mbstows(c_utf8enc, view);
+}
+
+bool isWhiteSpace(char ch)
+{
+	return ch == ' ' || ch == '\t' || ch == 9 || ch == 10;
 }
 
 	}
@@ -44,24 +51,43 @@ public:
 
 	~XmlPullParserImpl();
 
-	bool get(XmlPullParser::Event& outEvent);
+	bool get(XmlPullParser::EventView& outEvent);
 
 private:
+	struct QueuedEvent
+	{
+		XmlPullParser::EventType type;
+		uint32_t value;			//!< Offset of value in text.
+		uint32_t valueLength;
+		uint32_t attr;			//!< Index of first attribute.
+		uint32_t attrCount;
+	};
+
+	struct QueuedAttribute
+	{
+		uint32_t name;
+		uint32_t nameLength;
+		uint32_t value;
+		uint32_t valueLength;
+	};
+
 	Ref< IStream > m_stream;
+	const uint8_t* m_memory;		//!< Next unparsed byte if stream is memory backed.
+	const uint8_t* m_memoryEnd;
 	std::wstring m_name;
 	XML_Parser m_parser;
-	uint8_t m_buf[4096];
 	bool m_done;
-	AlignedVector< wchar_t > m_cdata;
-	XmlPullParser::Event m_eventQueue[1024];
-	uint32_t m_eventQueueHead;
-	uint32_t m_eventQueueTail;
+	AlignedVector< char > m_text;	//!< UTF-8 text of all queued events.
+	uint32_t m_cdata;				//!< Offset of pending character data in text.
+	AlignedVector< QueuedEvent > m_events;
+	AlignedVector< QueuedAttribute > m_attributes;
+	uint32_t m_eventsHead;
 
 	bool parse();
 
-	XmlPullParser::Event* allocEvent();
+	QueuedEvent& allocEvent(XmlPullParser::EventType type);
 
-	void pushEvent();
+	uint32_t appendText(const char* text, size_t length);
 
 	void pushCharacterData();
 
@@ -76,11 +102,13 @@ private:
 
 XmlPullParserImpl::XmlPullParserImpl(IStream* stream, const std::wstring& name)
 :	m_stream(stream)
+,	m_memory(nullptr)
+,	m_memoryEnd(nullptr)
 ,	m_name(name)
 ,	m_parser(0)
 ,	m_done(false)
-,	m_eventQueueHead(0)
-,	m_eventQueueTail(0)
+,	m_cdata(0)
+,	m_eventsHead(0)
 {
 	m_parser = XML_ParserCreate(nullptr);
 	T_ASSERT_M (m_parser, L"Unable to create XML parser");
@@ -90,8 +118,19 @@ XmlPullParserImpl::XmlPullParserImpl(IStream* stream, const std::wstring& name)
 	XML_SetCharacterDataHandler(m_parser, characterData);
 	XML_SetUnknownEncodingHandler(m_parser, unknownEncoding, nullptr);
 
-	m_eventQueue[0].type = XmlPullParser::EventType::StartDocument;
-	m_eventQueueTail++;
+	// Parse memory backed streams, such as mapped files, directly without copying.
+	if (auto memoryStream = dynamic_type_cast< MemoryStream* >(m_stream))
+	{
+		const int64_t position = memoryStream->tell();
+		if (memoryStream->getBuffer() && position >= 0 && position <= memoryStream->getBufferSize())
+		{
+			m_memory = memoryStream->getBuffer() + position;
+			m_memoryEnd = memoryStream->getBuffer() + memoryStream->getBufferSize();
+		}
+	}
+
+	m_text.reserve(c_streamChunkSize);
+	allocEvent(XmlPullParser::EventType::StartDocument);
 }
 
 XmlPullParserImpl::~XmlPullParserImpl()
@@ -100,15 +139,39 @@ XmlPullParserImpl::~XmlPullParserImpl()
 		XML_ParserFree(m_parser);
 }
 
-bool XmlPullParserImpl::get(XmlPullParser::Event& outEvent)
+bool XmlPullParserImpl::get(XmlPullParser::EventView& outEvent)
 {
-	while (m_eventQueueHead == m_eventQueueTail)
+	while (m_eventsHead >= m_events.size())
 	{
+		// All queued events consumed; reuse storage but keep pending character data.
+		const uint32_t pending = (uint32_t)m_text.size() - m_cdata;
+		if (m_cdata > 0)
+		{
+			if (pending > 0)
+				std::memmove(m_text.ptr(), m_text.ptr() + m_cdata, pending);
+			m_text.resize(pending);
+			m_cdata = 0;
+		}
+		m_events.resize(0);
+		m_attributes.resize(0);
+		m_eventsHead = 0;
+
 		if (!parse())
 			return false;
 	}
-	outEvent = m_eventQueue[m_eventQueueHead];
-	m_eventQueueHead = (m_eventQueueHead + 1) % sizeof_array(m_eventQueue);
+
+	const QueuedEvent& evt = m_events[m_eventsHead++];
+	const char* text = m_text.c_ptr();
+
+	outEvent.type = evt.type;
+	outEvent.value = std::string_view(text + evt.value, evt.valueLength);
+	outEvent.attr.resize(evt.attrCount);
+	for (uint32_t i = 0; i < evt.attrCount; ++i)
+	{
+		const QueuedAttribute& attr = m_attributes[evt.attr + i];
+		outEvent.attr[i].first = std::string_view(text + attr.name, attr.nameLength);
+		outEvent.attr[i].second = std::string_view(text + attr.value, attr.valueLength);
+	}
 	return true;
 }
 
@@ -116,25 +179,37 @@ bool XmlPullParserImpl::parse()
 {
 	if (!m_done)
 	{
-		const int64_t nread = m_stream->read(m_buf, sizeof(m_buf));
-		if (nread < 0)
+		XML_Status status;
+		if (m_memory)
 		{
-			log::error << L"Unexpected out-of-data in XML parser (" << m_name << L")." << Endl;
-			return false;
+			const int64_t nparse = std::min< int64_t >(m_memoryEnd - m_memory, c_memoryChunkSize);
+			m_done = (m_memory + nparse >= m_memoryEnd);
+			status = XML_Parse(m_parser, (const char*)m_memory, (int)nparse, m_done);
+			m_memory += nparse;
+			m_stream->seek(IStream::SeekCurrent, nparse);
 		}
-
-		m_done = nread < sizeof(m_buf);
-		if (XML_Parse(m_parser, (const char*)m_buf, (int)nread, m_done) == XML_STATUS_ERROR)
+		else
 		{
-			XML_Size line = XML_GetCurrentLineNumber(m_parser);
-			log::error << L"XML parse error at line " << (int32_t)line << L" (" << m_name << L")." << Endl;
+			void* buf = XML_GetBuffer(m_parser, c_streamChunkSize);
+			if (!buf)
+				return false;
 
-			XmlPullParser::Event* evt = allocEvent();
-			if (!evt)
+			const int64_t nread = m_stream->read(buf, c_streamChunkSize);
+			if (nread < 0)
+			{
+				log::error << L"Unexpected out-of-data in XML parser (" << m_name << L")." << Endl;
 				return false;
+			}
+
+			m_done = nread < c_streamChunkSize;
+			status = XML_ParseBuffer(m_parser, (int)nread, m_done);
+		}
 
-			evt->type = XmlPullParser::EventType::Invalid;
-			pushEvent();
+		if (status == XML_STATUS_ERROR)
+		{
+			XML_Size line = XML_GetCurrentLineNumber(m_parser);
+			log::error << L"XML parse error at line " << (int32_t)line << L" (" << m_name << L")." << Endl;
+			allocEvent(XmlPullParser::EventType::Invalid);
 			return true;
 		}
 	}
@@ -143,12 +218,7 @@ bool XmlPullParserImpl::parse()
 		if (!m_parser)
 			return false;
 
-		XmlPullParser::Event* evt = allocEvent();
-		if (!evt)
-			return false;
-
-		evt->type = XmlPullParser::EventType::EndDocument;
-		pushEvent();
+		allocEvent(XmlPullParser::EventType::EndDocument);
 
 		XML_ParserFree(m_parser);
 		m_parser = nullptr;
@@ -156,48 +226,48 @@ bool XmlPullParserImpl::parse()
 	return true;
 }
 
-XmlPullParser::Event* XmlPullParserImpl::allocEvent()
+XmlPullParserImpl::QueuedEvent& XmlPullParserImpl::allocEvent(XmlPullParser::EventType type)
 {
-	auto& evt = m_eventQueue[m_eventQueueTail];
-	evt.type = XmlPullParser::EventType::Invalid;
-	evt.value.clear();
-	evt.attr.clear();
-	return &evt;
+	QueuedEvent& evt = m_events.push_back();
+	evt.type = type;
+	evt.value = 0;
+	evt.valueLength = 0;
+	evt.attr = (uint32_t)m_attributes.size();
+	evt.attrCount = 0;
+	return evt;
 }
 
-void XmlPullParserImpl::pushEvent()
+uint32_t XmlPullParserImpl::appendText(const char* text, size_t length)
 {
-	m_eventQueueTail = (m_eventQueueTail + 1) % sizeof_array(m_eventQueue);
-	T_ASSERT(m_eventQueueTail != m_eventQueueHead);
+	const uint32_t offset = (uint32_t)m_text.size();
+	m_text.resize(offset + length);
+	std::memcpy(m_text.ptr() + offset, text, length);
+	m_cdata = (uint32_t)m_text.size();
+	return offset;
 }
 
 void XmlPullParserImpl::pushCharacterData()
 {
-	const size_t len = m_cdata.size();
+	const uint32_t len = (uint32_t)m_text.size() - m_cdata;
 	if (!len)
 		return;
 
-	const wchar_t* ss = &m_cdata[0];
-	const wchar_t* es = &m_cdata[len - 1];
+	const char* cdata = m_text.c_ptr();
+	uint32_t ss = m_cdata;
+	uint32_t es = m_cdata + len - 1;
 
-	while ((*ss == ' ' || *ss == '\t' || *ss == 9 || *ss == 10) && ss < es)
+	while (isWhiteSpace(cdata[ss]) && ss < es)
 		++ss;
 
-	while ((*es == ' ' || *es == '\t' || *es == 9 || *es == 10) && ss < es)
+	while (isWhiteSpace(cdata[es]) && ss < es)
 		--es;
 
-	if (ss <= es)
-	{
-		XmlPullParser::Event* evt = allocEvent();
-		if (evt)
-		{
-			evt->type = XmlPullParser::EventType::Text;
-			evt->value = std::wstring(ss, es + 1);
-			pushEvent();
-		}
-	}
+	// Character data is already in place; event only reference trimmed range.
+	QueuedEvent& evt = allocEvent(XmlPullParser::EventType::Text);
+	evt.value = ss;
+	evt.valueLength = es - ss + 1;
 
-	m_cdata.resize(0);
+	m_cdata = (uint32_t)m_text.size();
 }
 
 void XMLCALL XmlPullParserImpl::startElement(void* userData, const XML_Char* name, const XML_Char** atts)
@@ -207,16 +277,19 @@ void XMLCALL XmlPullParserImpl::startElement(void* userData, const XML_Char* nam
 
 	pp->pushCharacterData();
 
-	XmlPullParser::Event* evt = pp->allocEvent();
-	if (evt)
-	{
-		evt->type = XmlPullParser::EventType::StartElement;
-		evt->value = xmltows(name);
-
-		for (int32_t i = 0; atts[i]; i += 2)
-			evt->attr.push_back(std::make_pair(xmltows(atts[i]), xmltows(atts[i + 1])));
+	const size_t nameLength = std::strlen(name);
+	QueuedEvent& evt = pp->allocEvent(XmlPullParser::EventType::StartElement);
+	evt.value = pp->appendText(name, nameLength);
+	evt.valueLength = (uint32_t)nameLength;
 
-		pp->pushEvent();
+	for (int32_t i = 0; atts[i]; i += 2)
+	{
+		QueuedAttribute& attr = pp->m_attributes.push_back();
+		attr.nameLength = (uint32_t)std::strlen(atts[i]);
+		attr.name = pp->appendText(atts[i], attr.nameLength);
+		attr.valueLength = (uint32_t)std::strlen(atts[i + 1]);
+		attr.value = pp->appendText(atts[i + 1], attr.valueLength);
+		pp->m_events.back().attrCount++;
 	}
 }
 
@@ -227,13 +300,10 @@ void XMLCALL XmlPullParserImpl::endElement(void* userData, const XML_Char* name)
 
 	pp->pushCharacterData();
 
-	XmlPullParser::Event* evt = pp->allocEvent();
-	if (evt)
-	{
-		evt->type = XmlPullParser::EventType::EndElement;
-		evt->value = xmltows(name);
-		pp->pushEvent();
-	}
+	const size_t nameLength = std::strlen(name);
+	QueuedEvent& evt = pp->allocEvent(XmlPullParser::EventType::EndElement);
+	evt.value = pp->appendText(name, nameLength);
+	evt.valueLength = (uint32_t)nameLength;
 }
 
 void XMLCALL XmlPullParserImpl::characterData(void* userData, const XML_Char* s, int len)
@@ -242,8 +312,10 @@ void XMLCALL XmlPullParserImpl::characterData(void* userData, const XML_Char* s,
 	T_ASSERT(pp);
 	T_ASSERT(len > 0);
 
-	std::wstring ws = xmltows(s, &s[len]);
-	pp->m_cdata.insert(pp->m_cdata.end(), ws.c_str(), ws.c_str() + len);
+	// Accumulate after all queued text, pushed as a single event when next element begins or ends.
+	const size_t offset = pp->m_text.size();
+	pp->m_text.resize(offset + len);
+	std::memcpy(pp->m_text.ptr() + offset, s, len);
 }
 
 int XMLCALL XmlPullParserImpl::unknownEncoding(void* userData, const XML_Char* name, XML_Encoding* info)
@@ -268,6 +340,7 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.xml.XmlPullParser", XmlPullParser, Object)
 
 XmlPullParser::XmlPullParser(IStream* stream, const std::wstring& name)
 :	m_impl(new XmlPullParserImpl(stream, name))
+,	m_eventValid(true)
 ,	m_pushed(0)
 {
 }
@@ -282,22 +355,25 @@ XmlPullParser::EventType XmlPullParser::next()
 	if (m_pushed > 0)
 	{
 		m_pushed--;
-		return m_event.type;
+		return m_eventView.type;
 	}
 
-	if (m_event.type == EventType::EndDocument)
-		return m_event.type;
+	if (m_eventView.type == EventType::EndDocument)
+		return m_eventView.type;
 
 	if (!m_impl)
 		return EventType::Invalid;
 
-	if (!m_impl->get(m_event))
+	m_eventValid = false;
+
+	if (!m_impl->get(m_eventView))
 	{
 		delete m_impl; m_impl = nullptr;
+		m_eventView = EventView();
 		return EventType::Invalid;
 	}
 
-	return m_event.type;
+	return m_eventView.type;
 }
 
 void XmlPullParser::push()
@@ -307,7 +383,21 @@ void XmlPullParser::push()
 
 const XmlPullParser::Event& XmlPullParser::getEvent() const
 {
+	if (!m_eventValid)
+	{
+		m_event.type = m_eventView.type;
+		m_event.value = viewtows(m_eventView.value);
+		m_event.attr.resize(0);
+		for (const auto& attr : m_eventView.attr)
+			m_event.attr.push_back(std::make_pair(viewtows(attr.first), viewtows(attr.second)));
+		m_eventValid = true;
+	}
 	return m_event;
 }
 
+const XmlPullParser::EventView& XmlPullParser::getEventView() const
+{
+	return m_eventView;
+}
+
 }
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include "Core/Object.h"
 #include "Core/Containers/AlignedVector.h"
 
@@ -34,6 +35,11 @@ class XmlPullParserImpl;
 
 /*! XML Pull parser.
  * \ingroup XML
+ *
+ * Events are kept UTF-8 encoded as read from the
+ * document; getEventView() provide direct access without
+ * any conversion while getEvent() convert event
+ * into wide strings on demand.
  */
 class T_DLLCLASS XmlPullParser : public Object
 {
@@ -60,6 +66,17 @@ public:
 		Attributes attr;
 	};
 
+	typedef std::pair< std::string_view, std::string_view > AttributeView;
+	typedef AlignedVector< AttributeView > AttributeViews;
+
+	/*! UTF-8 encoded event, views are only valid until next event. */
+	struct EventView
+	{
+		EventType type = EventType::Invalid;
+		std::string_view value;
+		AttributeViews attr;
+	};
+
 	explicit XmlPullParser(IStream* stream, const std::wstring& name = L"");
 
 	virtual ~XmlPullParser();
@@ -70,9 +87,13 @@ public:
 
 	const Event& getEvent() const;
 
+	const EventView& getEventView() const;
+
 private:
 	XmlPullParserImpl* m_impl;	/**< Parser implementation. */
-	Event m_event;				/**< Current event. */
+	EventView m_eventView;		/**< Current event. */
+	mutable Event m_event;		/**< Current event as wide strings, converted on demand. */
+	mutable bool m_eventValid;	/**< If wide event has been converted from current event. */
 	int32_t m_pushed;			/**< If current event is being pushed. */
 };
 